@@ -45,6 +45,50 @@
 
 hiptensorStatus_t hiptensorCreate(hiptensorHandle_t** handle);
 
+/**
+ * \brief Allocates a hipTensor handle spanning several devices
+ *
+ * \details The first device is the handle's home device: it must be current when
+ * the handle is used, and operands of \ref hiptensorContractionMultiDevice live in
+ * its memory. Each device keeps its own plan cache, workspace pool and stream.
+ * Operations other than \ref hiptensorContractionMultiDevice run on the home device
+ * only.
+ *
+ * \param[out] handle Pointer to hiptensorHandle_t pointer
+ * \param[in] numDevices Number of devices.
+ * \param[in] deviceIds Distinct HIP device ids, home device first.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if a device id is invalid or repeated.
+ * \retval HIPTENSOR_STATUS_HIP_ERROR if HIP cannot be initialized.
+ */
+hiptensorStatus_t hiptensorCreateMultiDevice(hiptensorHandle_t** handle,
+                                             uint32_t            numDevices,
+                                             const int32_t       deviceIds[]);
+
+/**
+ * \brief Returns the number of devices a handle spans
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] numDevices Number of devices, 1 for handles from \ref hiptensorCreate.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or numDevices is nullptr.
+ */
+hiptensorStatus_t hiptensorGetDeviceCount(const hiptensorHandle_t* handle, uint32_t* numDevices);
+
+/**
+ * \brief Returns an identifier of a handle
+ *
+ * \details Ids are unique among the handles created by the process and are not reused
+ * once a handle is destroyed, unlike handle addresses. State kept per handle outside
+ * the library can be keyed by it.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] id Identifier of the handle.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or id is nullptr.
+ */
+hiptensorStatus_t hiptensorGetHandleId(const hiptensorHandle_t* handle, uint64_t* id);
+
 /**
  * \brief De-allocates the instance of hiptensorHandle_t
  *
@@ -55,6 +99,41 @@ hiptensorStatus_t hiptensorCreate(hiptensorHandle_t** handle);
 
 hiptensorStatus_t hiptensorDestroy(hiptensorHandle_t* handle);
 
+/**
+ * \brief Sets where operations issued on the handle read their scalars
+ *
+ * \details In HIPTENSOR_POINTER_MODE_DEVICE, alpha and beta of contractions and
+ * permutations point to device memory and are read on the operation's stream, after
+ * the work issued before it. The contraction kernels take their scalars by value, so
+ * \ref hiptensorContraction then runs the kernel with unit scalars into the workspace
+ * and forms alpha * A * B + beta * C from that product in a separate element-wise
+ * pass. The pass reads the product and C and writes D once more, and the workspace
+ * grows by the size of D, rounded up to the workspace granularity (see
+ * \ref hiptensorContractionGetWorkspaceSize). Outputs must be f16, f32 or f64.
+ * Multi-output, chained, streamed, multi-device, distributed, block-sparse, symmetric
+ * and multi-TTM contractions require HIPTENSOR_POINTER_MODE_HOST and return
+ * HIPTENSOR_STATUS_NOT_SUPPORTED otherwise.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] mode Pointer mode of subsequent operations.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle is nullptr.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if the mode is unknown.
+ */
+hiptensorStatus_t hiptensorSetPointerMode(const hiptensorHandle_t* handle,
+                                          hiptensorPointerMode_t   mode);
+
+/**
+ * \brief Returns the pointer mode of the handle
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] mode Pointer mode of the handle.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or mode is nullptr.
+ */
+hiptensorStatus_t hiptensorGetPointerMode(const hiptensorHandle_t* handle,
+                                          hiptensorPointerMode_t*  mode);
+
 /**
  * \brief Initializes a tensor descriptor
  *
@@ -63,8 +142,10 @@ hiptensorStatus_t hiptensorDestroy(hiptensorHandle_t* handle);
  * \param[in] numModes Number of modes.
  * \param[in] lens Extent of each mode(lengths) (must be larger than zero).
  * \param[in] strides stride[i] denotes the displacement (stride) between two consecutive
- * elements in the ith-mode. If stride is NULL, generalized packed column-major memory
- * layout is assumed (i.e., the strides increase monotonically from left to right).
+ * elements in the ith-mode. If stride is NULL, packed strides with the last mode fastest are
+ * assumed and the descriptor keeps HIPTENSOR_LAYOUT_DEFAULT; only permutations then address
+ * its elements in the default layout of the library build. Strides packed in row- or
+ * column-major order set the descriptor's layout accordingly.
  * \param[in] dataType Data type of the stored entries.
  * \param[in] unaryOp Unary operator that will be applied to the tensor
  * \retval HIPTENSOR_STATUS_SUCCESS The operation completed successfully.
@@ -79,6 +160,27 @@ hiptensorStatus_t hiptensorInitTensorDescriptor(const hiptensorHandle_t*     han
                                                 hipDataType                  dataType,
                                                 hiptensorOperator_t          unaryOp);
 
+/**
+ * \brief Sets the memory layout of a tensor descriptor
+ *
+ * \details Permutations address each operand's elements through the strides of its
+ * descriptor, so row- and column-major operands can be mixed in one call. A descriptor
+ * with packed strides is re-strided to the packed strides of the new layout, which
+ * contractions then read as well; other strides are kept.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in,out] desc Tensor descriptor initialized by hiptensorInitTensorDescriptor.
+ * \param[in] layout Layout of the tensor; HIPTENSOR_LAYOUT_DEFAULT selects the default of
+ * the library build.
+ * \retval HIPTENSOR_STATUS_SUCCESS The operation completed successfully.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or descriptor is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if the layout is unknown.
+ */
+
+hiptensorStatus_t hiptensorSetTensorLayout(const hiptensorHandle_t*     handle,
+                                           hiptensorTensorDescriptor_t* desc,
+                                           hiptensorDataLayout_t        layout);
+
 /**
  * \brief Returns the description string for an error code
  * \param[in] error Error code to convert to string.
@@ -132,6 +234,24 @@ hiptensorStatus_t hiptensorGetAlignmentRequirement(const hiptensorHandle_t*
                                                    const hiptensorTensorDescriptor_t* desc,
                                                    uint32_t* alignmentRequirement);
 
+/**
+ * \brief Writes a tensor and its descriptor to a file that streamed contractions
+ * can map in place.
+ *
+ * \details The file holds a header with the data type, lengths and strides of desc,
+ * followed by the element space of the tensor starting on a page boundary.
+ *
+ * \param[in] path Path of the file to create or overwrite.
+ * \param[in] desc Tensor descriptor of the data.
+ * \param[in] data Pointer to the element space in host memory; nullptr writes zeros.
+ * \retval HIPTENSOR_STATUS_SUCCESS The operation completed successfully.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if path or desc is nullptr.
+ * \retval HIPTENSOR_STATUS_IO_ERROR if the file cannot be written.
+ */
+hiptensorStatus_t hiptensorWriteTensorFile(const char*                        path,
+                                           const hiptensorTensorDescriptor_t* desc,
+                                           const void*                        data);
+
 /**
  * \brief Initializes a contraction descriptor for the tensor contraction problem.
  *
@@ -140,17 +260,25 @@ hiptensorStatus_t hiptensorGetAlignmentRequirement(const hiptensorHandle_t*
  * \param[in] descA A descriptor that holds information about tensor A.
  * \param[in] modeA Array with 'nmodeA' entries that represent the modes of A.
  * \param[in] alignmentRequirementA Alignment reqirement for A's pointer (in bytes);
+ * 0 defers to the pointer passed at execution; pointers offset from the access width of the
+ * selected kernel are read by a narrower kernel, down to scalar access.
  * \param[in] descB A descriptor that holds information about tensor B.
  * \param[in] modeB Array with 'nmodeB' entries that represent the modes of B.
  * \param[in] alignmentRequirementB Alignment reqirement for B's pointer (in bytes);
+ * 0 defers to the pointer passed at execution; pointers offset from the access width of the
+ * selected kernel are read by a narrower kernel, down to scalar access.
  * \param[in] modeC Array with 'nmodeC' entries that represent the modes of C.
  * \param[in] descC A descriptor that holds information about tensor C.
  * \param[in] alignmentRequirementC Alignment requirement for C's pointer (in bytes);
+ * 0 defers to the pointer passed at execution; pointers offset from the access width of the
+ * selected kernel are read by a narrower kernel, down to scalar access.
  * \param[in] modeD Array with 'nmodeD' entries that represent the modes of D
  * (must be identical to modeC).
  * \param[in] descD A descriptor that holds information about tensor D
  * (must be identical to descC).
  * \param[in] alignmentRequirementD Alignment requirement for D's pointer (in bytes);
+ * 0 defers to the pointer passed at execution; pointers offset from the access width of the
+ * selected kernel are read by a narrower kernel, down to scalar access.
  * \param[in] typeCompute Datatype for the intermediate computation  T = A * B.
  * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
  * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or tensor descriptors are not initialized.
@@ -172,6 +300,40 @@ hiptensorStatus_t hiptensorInitContractionDescriptor(const hiptensorHandle_t*
                                                      const uint32_t         alignmentRequirementD,
                                                      hiptensorComputeType_t typeCompute);
 
+/**
+ * \brief Initializes a contraction descriptor for several outputs sharing one A
+ *
+ * \details Describes numOutputs contractions \f[ D_g = alpha * A * B_g + beta * C_g \f]
+ * whose B, C and D operands all have the given layouts. The outputs are computed
+ * together by \ref hiptensorContractionMultiOutput, which reads A once for all
+ * of them. Kernels see the outputs concatenated along the outermost N mode, so the
+ * plan's workspace holds packed copies of every B, C and D.
+ *
+ * \param[in] numOutputs Number of B, C and D operands.
+ * \remarks All other parameters are as for \ref hiptensorInitContractionDescriptor.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or tensor descriptors are not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if numOutputs is 0.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED if B has no free modes to concatenate the outputs along.
+ */
+hiptensorStatus_t
+    hiptensorInitMultiOutputContractionDescriptor(const hiptensorHandle_t*           handle,
+                                                  hiptensorContractionDescriptor_t*  desc,
+                                                  const hiptensorTensorDescriptor_t* descA,
+                                                  const int32_t                      modeA[],
+                                                  const uint32_t alignmentRequirementA,
+                                                  const hiptensorTensorDescriptor_t* descB,
+                                                  const int32_t                      modeB[],
+                                                  const uint32_t alignmentRequirementB,
+                                                  const hiptensorTensorDescriptor_t* descC,
+                                                  const int32_t                      modeC[],
+                                                  const uint32_t alignmentRequirementC,
+                                                  const hiptensorTensorDescriptor_t* descD,
+                                                  const int32_t                      modeD[],
+                                                  const uint32_t         alignmentRequirementD,
+                                                  hiptensorComputeType_t typeCompute,
+                                                  uint32_t               numOutputs);
+
 /**
  * \brief Narrows down the candidates for the contraction problem.
  *
@@ -191,9 +353,39 @@ hiptensorStatus_t hiptensorInitContractionFind(const hiptensorHandle_t*    handl
                                                hiptensorContractionFind_t* find,
                                                const hiptensorAlgo_t       algo);
 
+/**
+ * \brief Sets how plans initialized from a find choose between candidates
+ *
+ * \details Finds start with HIPTENSOR_SELECTION_FASTEST, no workspace cap and no
+ * tolerance. Candidates needing more kernel workspace than workspaceCap are never
+ * selected, and \ref hiptensorContractionGetWorkspaceSize no longer accounts for
+ * them. With HIPTENSOR_SELECTION_SMALLEST_WORKSPACE, a candidate up to
+ * (1 + tolerance) times slower than the fastest is preferred when it needs less
+ * workspace. Policies other than the fastest rank measured kernels, so plans of
+ * HIPTENSOR_ALGO_ACTOR_CRITIC finds apply them by brute force.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in,out] find Candidates initialized by \ref hiptensorInitContractionFind.
+ * \param[in] policy Ranking of the measured candidates.
+ * \param[in] workspaceCap Largest kernel workspace (in bytes) a selection may use.
+ * \param[in] tolerance Accepted relative slowdown from the fastest candidate.
+ * \retval HIPTENSOR_STATUS_SUCCESS The operation completed successfully.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or find is nullptr.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if the policy is unknown or the tolerance is
+ * negative.
+ */
+hiptensorStatus_t hiptensorContractionFindSetPolicy(const hiptensorHandle_t*    handle,
+                                                    hiptensorContractionFind_t* find,
+                                                    hiptensorSelectionPolicy_t  policy,
+                                                    uint64_t                    workspaceCap,
+                                                    float                       tolerance);
+
 /**
  * \brief Computes the size of workspace for a given tensor contraction
  *
+ * \details In HIPTENSOR_POINTER_MODE_DEVICE the size includes room for the kernel's
+ * unscaled product, which takes as many bytes as D (see \ref hiptensorSetPointerMode).
+ *
  * \param[in] handle Opaque handle holding hipTensor's library context.
  * \param[in] desc Tensor contraction descriptor.
  * \param[in] find Narrowed set of candidates for the contraction problem.
@@ -209,6 +401,23 @@ hiptensorStatus_t hiptensorContractionGetWorkspaceSize(const hiptensorHandle_t*
                                                        const hiptensorWorksizePreference_t     pref,
                                                        uint64_t* workspaceSize);
 
+/**
+ * \brief Reports the problem sizes of a tensor contraction
+ *
+ * \details The FLOP and byte counts are those that performance logging and kernel
+ * selection use to rate kernels, so that measured times can be turned into
+ * throughput without recomputing them.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] desc Tensor contraction descriptor.
+ * \param[out] metrics Sizes, FLOP and byte counts of the contraction.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle, desc or metrics is nullptr.
+ */
+hiptensorStatus_t hiptensorContractionGetMetrics(const hiptensorHandle_t*                handle,
+                                                 const hiptensorContractionDescriptor_t* desc,
+                                                 hiptensorContractionMetrics_t*          metrics);
+
 /**
  * \brief Initializes the contraction plan for a given tensor contraction problem
  *
@@ -244,14 +453,18 @@ hiptensorStatus_t hiptensorInitContractionPlan(const hiptensorHandle_t*
  * \param[in] plan Opaque handle holding the contraction plan (i.e.,
  * the algorithm that will be executed, its runtime parameters for the given
  * tensor contraction problem).
- * \param[in] alpha Scaling parameter for A*B of data type 'typeCompute'.
+ * \param[in] alpha Scaling parameter for A*B of data type 'typeCompute', in host or
+ * device memory as set by \ref hiptensorSetPointerMode. Device scalars cost an extra
+ * element-wise pass over D.
  * \param[in] A Pointer to A's data in device memory.
  * \param[in] B Pointer to B's data in device memory.
- * \param[in] beta Scaling parameter for C of data type 'typeCompute'.
+ * \param[in] beta Scaling parameter for C of data type 'typeCompute', in the same
+ * memory as alpha.
  * \param[in] C Pointer to C's data in device memory.
  * \param[out] D Pointer to D's data in device memory.
- * \param[out] workspace Workspace pointer in device memory
- * \param[in] workspaceSize Available workspace size.
+ * \param[out] workspace Workspace pointer in device memory, or nullptr to draw the
+ * workspace from the handle's workspace pool.
+ * \param[in] workspaceSize Available workspace size; ignored when workspace is nullptr.
  * \param[in] stream HIP stream to perform all operations.
  *
  * Supported data-type combinations are:
@@ -285,6 +498,979 @@ hiptensorStatus_t hiptensorContraction(const hiptensorHandle_t*          handle,
                                        uint64_t                          workspaceSize,
                                        hipStream_t                       stream);
 
+/**
+ * \brief Computes the outputs of a multi-output contraction in one pass over A
+ *
+ * \details Computes \f[ D_g = alpha * A * B_g + beta * C_g \f] for every output g
+ * of a plan initialized from \ref hiptensorInitMultiOutputContractionDescriptor.
+ *
+ * The kernel sees the outputs concatenated along the outermost N mode. Operands
+ * are copied into that view in the workspace, and D scattered back from it, unless
+ * their pointers already lie side by side in it: packed B operands stored back to
+ * back, such as one concatenated B reused across calls, are read in place, and C
+ * and D operands that are strided views into one concatenated tensor are read and
+ * written in place.
+ *
+ * \param[in] B Array of numOutputs pointers to B operands in device memory.
+ * \param[in] C Array of numOutputs pointers to C operands in device memory, or
+ * nullptr for contractions without C.
+ * \param[out] D Array of numOutputs pointers to D operands in device memory.
+ * \remarks All other parameters are as for \ref hiptensorContraction.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if an operand pointer is nullptr.
+ * \retval HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE if the workspace cannot hold the packed outputs.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED in HIPTENSOR_POINTER_MODE_DEVICE; alpha and beta
+ * must point to host memory.
+ */
+hiptensorStatus_t hiptensorContractionMultiOutput(const hiptensorHandle_t*          handle,
+                                                  const hiptensorContractionPlan_t* plan,
+                                                  const void*                       alpha,
+                                                  const void*                       A,
+                                                  const void* const                 B[],
+                                                  const void*                       beta,
+                                                  const void* const                 C[],
+                                                  void* const                       D[],
+                                                  void*                             workspace,
+                                                  uint64_t                          workspaceSize,
+                                                  hipStream_t                       stream);
+
+/**
+ * \brief Reports the workspace held by the handle's workspace pool
+ *
+ * \details Contractions given no workspace are served from a pool owned by the
+ * handle. Its blocks are reused across plans and streams and are only freed by
+ * \ref hiptensorTrimWorkspacePool or hiptensorDestroy.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] reservedBytes Bytes currently allocated by the pool.
+ * \param[out] highWaterMark Most bytes the pool has held at once.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or an output is nullptr.
+ */
+hiptensorStatus_t hiptensorGetWorkspacePoolUsage(const hiptensorHandle_t* handle,
+                                                 uint64_t*                reservedBytes,
+                                                 uint64_t*                highWaterMark);
+
+/**
+ * \brief Frees the blocks of the handle's workspace pool that are not in use
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle is nullptr.
+ */
+hiptensorStatus_t hiptensorTrimWorkspacePool(const hiptensorHandle_t* handle);
+
+/**
+ * \brief Initializes a back-to-back contraction chain \f[ D = alpha * (A * B) * C \f]
+ *
+ * \details Modes are ordered A = [M, K], B = [N, K], C = [O, N] and D = [M, O]:
+ * the modes shared by A and B are contracted first, then the modes shared by
+ * the intermediate and C. The chain is run in blocks of A's outermost mode, each
+ * with an intermediate small enough to stay in cache between the two stages.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] desc This opaque struct gets filled with the information that
+ * describes the chain.
+ * \remarks The tensor, mode and alignment parameters are as for
+ * \ref hiptensorInitContractionDescriptor, with C the second stage's operand.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or tensor descriptors are not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if the operand types differ.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED if the modes do not follow the chain's ordering.
+ */
+hiptensorStatus_t
+    hiptensorInitContractionChainDescriptor(const hiptensorHandle_t*               handle,
+                                            hiptensorContractionChainDescriptor_t* desc,
+                                            const hiptensorTensorDescriptor_t*     descA,
+                                            const int32_t                          modeA[],
+                                            const uint32_t alignmentRequirementA,
+                                            const hiptensorTensorDescriptor_t*     descB,
+                                            const int32_t                          modeB[],
+                                            const uint32_t alignmentRequirementB,
+                                            const hiptensorTensorDescriptor_t*     descC,
+                                            const int32_t                          modeC[],
+                                            const uint32_t alignmentRequirementC,
+                                            const hiptensorTensorDescriptor_t*     descD,
+                                            const int32_t                          modeD[],
+                                            const uint32_t alignmentRequirementD,
+                                            hiptensorComputeType_t                 typeCompute);
+
+/**
+ * \brief Computes the size of workspace for a back-to-back contraction chain
+ *
+ * \details The workspace holds the intermediate of one block followed by the
+ * larger of the two stages' workspaces.
+ * \remarks The parameters are as for \ref hiptensorContractionGetWorkspaceSize.
+ */
+hiptensorStatus_t
+    hiptensorContractionChainGetWorkspaceSize(const hiptensorHandle_t*                     handle,
+                                              const hiptensorContractionChainDescriptor_t* desc,
+                                              const hiptensorContractionFind_t*            find,
+                                              const hiptensorWorksizePreference_t          pref,
+                                              uint64_t* workspaceSize);
+
+/**
+ * \brief Initializes the plan of a back-to-back contraction chain
+ *
+ * \remarks The parameters are as for \ref hiptensorInitContractionPlan.
+ * \retval HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE if workspaceSize cannot hold the intermediate.
+ */
+hiptensorStatus_t
+    hiptensorInitContractionChainPlan(const hiptensorHandle_t*                     handle,
+                                      hiptensorContractionChainPlan_t*             plan,
+                                      const hiptensorContractionChainDescriptor_t* desc,
+                                      const hiptensorContractionFind_t*            find,
+                                      const uint64_t                               workspaceSize);
+
+/**
+ * \brief Computes the back-to-back contraction chain \f[ D = alpha * (A * B) * C \f]
+ *
+ * \param[in] alpha Scaling parameter for the chain of data type 'typeCompute'.
+ * \param[in] A, B, C Pointers to the operands in device memory.
+ * \param[out] D Pointer to D's data in device memory.
+ * \remarks All other parameters are as for \ref hiptensorContraction.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if an operand pointer is nullptr.
+ * \retval HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE if the workspace is too small.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED in HIPTENSOR_POINTER_MODE_DEVICE; alpha and beta
+ * must point to host memory.
+ */
+hiptensorStatus_t hiptensorContractionChain(const hiptensorHandle_t*               handle,
+                                            const hiptensorContractionChainPlan_t* plan,
+                                            const void*                            alpha,
+                                            const void*                            A,
+                                            const void*                            B,
+                                            const void*                            C,
+                                            void*                                  D,
+                                            void*                                  workspace,
+                                            uint64_t                               workspaceSize,
+                                            hipStream_t                            stream);
+
+/**
+ * \brief Computes the size of a pre-packed B operand for a contraction plan
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Opaque handle holding the contraction plan.
+ * \param[out] size Device memory taken by the packed operand (in bytes).
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if size is nullptr.
+ */
+hiptensorStatus_t hiptensorContractionGetPackedOperandSize(const hiptensorHandle_t*          handle,
+                                                           const hiptensorContractionPlan_t* plan,
+                                                           uint64_t*                         size);
+
+/**
+ * \brief Packs a B operand that stays constant across many contractions
+ *
+ * \details B is copied once into the layout that contraction kernels load best:
+ * packed with K innermost, each row padded to whole vectors and aligned for the
+ * widest vector access. A plan is then selected for the packed layout, which
+ * allows kernels with wider vector access than the original layout of B.
+ * Contractions that pass packed->mPlan and packed->mData to
+ * \ref hiptensorContraction in place of the original plan and B skip the layout
+ * penalty of B entirely. The buffer must stay valid while the packed operand is used.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] packed Packed operand and the plan selected for it.
+ * \param[in] plan Contraction plan for the original layout of B.
+ * \param[in] find Candidates for the selection of the packed plan.
+ * \param[in] workspaceSize Workspace that contractions with the packed operand provide.
+ * \param[in] B Pointer to B's data in device memory.
+ * \param[out] buffer Device memory receiving the packed operand, aligned to 16 bytes.
+ * \param[in] bufferSize Size of buffer, at least as given by
+ * \ref hiptensorContractionGetPackedOperandSize.
+ * \param[in] stream HIP stream to perform the copy.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle, plan or find is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if B or buffer is invalid or buffer is too small.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED if B cannot be packed.
+ */
+hiptensorStatus_t hiptensorContractionPackOperand(const hiptensorHandle_t*          handle,
+                                                  hiptensorPackedOperand_t*         packed,
+                                                  const hiptensorContractionPlan_t* plan,
+                                                  const hiptensorContractionFind_t* find,
+                                                  uint64_t                          workspaceSize,
+                                                  const void*                       B,
+                                                  void*                             buffer,
+                                                  uint64_t                          bufferSize,
+                                                  hipStream_t                       stream);
+
+/**
+ * \brief Computes the tensor contraction \f[ D = alpha * A * B + beta * C \f] for
+ * operands that live in host memory and may exceed device memory.
+ *
+ * \details The problem is tiled along the outermost M, N and K modes (K only when
+ * C is present, since partial products are accumulated through it). Tiles are
+ * copied through numBuffers device buffers, each with its own HIP stream, so that
+ * transfers overlap with the contraction of other tiles. Host memory should be
+ * pinned or memory-mapped for copies to run asynchronously. The call returns once
+ * D has been written.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Opaque handle holding the contraction plan.
+ * \param[in] alpha Scaling parameter for A*B of data type 'typeCompute'.
+ * \param[in] A Pointer to A's data in host memory.
+ * \param[in] B Pointer to B's data in host memory.
+ * \param[in] beta Scaling parameter for C of data type 'typeCompute'.
+ * \param[in] C Pointer to C's data in host memory.
+ * \param[out] D Pointer to D's data in host memory.
+ * \param[in] deviceBytes Device memory the buffers may take (in bytes); 0 uses
+ * the free device memory.
+ * \param[in] numBuffers Number of device buffers, e.g. 2 for double buffering.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if some input data is invalid.
+ * \retval HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE if a single tile does not fit
+ * the device memory.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED in HIPTENSOR_POINTER_MODE_DEVICE; alpha and beta
+ * must point to host memory.
+ */
+hiptensorStatus_t hiptensorContractionStreamed(const hiptensorHandle_t*          handle,
+                                               const hiptensorContractionPlan_t* plan,
+                                               const void*                       alpha,
+                                               const void*                       A,
+                                               const void*                       B,
+                                               const void*                       beta,
+                                               const void*                       C,
+                                               void*                             D,
+                                               uint64_t                          deviceBytes,
+                                               uint32_t                          numBuffers);
+
+/**
+ * \brief Computes hiptensorContractionStreamed on operands stored in tensor files.
+ *
+ * \details The files are written by hiptensorWriteTensorFile and must hold the
+ * tensors of the plan. They are memory-mapped rather than read, and their pages are
+ * requested ahead of each tile and released once no later tile reads them, so host
+ * memory use stays bounded by the tiles in flight. D's file is updated in place.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Opaque handle holding the contraction plan.
+ * \param[in] alpha Scaling parameter for A*B of data type 'typeCompute'.
+ * \param[in] pathA Path of A's tensor file.
+ * \param[in] pathB Path of B's tensor file.
+ * \param[in] beta Scaling parameter for C of data type 'typeCompute'.
+ * \param[in] pathC Path of C's tensor file; may be nullptr when the plan has no C.
+ * \param[in] pathD Path of D's tensor file.
+ * \param[in] deviceBytes Device memory the buffers may take (in bytes); 0 uses
+ * the free device memory.
+ * \param[in] numBuffers Number of device buffers, e.g. 2 for double buffering.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if a file is not a valid tensor file or does
+ * not hold the plan's tensor.
+ * \retval HIPTENSOR_STATUS_IO_ERROR if a file cannot be opened or mapped.
+ * \retval HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE if a single tile does not fit
+ * the device memory.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED in HIPTENSOR_POINTER_MODE_DEVICE; alpha and beta
+ * must point to host memory.
+ */
+hiptensorStatus_t hiptensorContractionStreamedFromFiles(const hiptensorHandle_t*          handle,
+                                                        const hiptensorContractionPlan_t* plan,
+                                                        const void*                       alpha,
+                                                        const char*                       pathA,
+                                                        const char*                       pathB,
+                                                        const void*                       beta,
+                                                        const char*                       pathC,
+                                                        const char*                       pathD,
+                                                        uint64_t deviceBytes,
+                                                        uint32_t numBuffers);
+
+/**
+ * \brief Computes the tensor contraction \f[ D = alpha * A * B + beta * C \f] across
+ * the devices of a handle.
+ *
+ * \details The outermost M or N mode is split between the handle's devices in
+ * proportion to their peak throughput, replicating the smaller of A and B. All
+ * operands live on the handle's home device, which contracts its share in place.
+ * Every other device receives copies of its blocks of the operands, contracts them
+ * with a kernel selected and cached for that device, and its block of D is copied
+ * back into place. Work is ordered after earlier work on stream, and later work on
+ * stream waits for every device. Staged, partitioned and multi-output plans are not
+ * supported.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Opaque handle holding the contraction plan.
+ * \param[in] alpha Scaling parameter for A*B of data type 'typeCompute'.
+ * \param[in] A Pointer to A's data in memory of the home device.
+ * \param[in] B Pointer to B's data in memory of the home device.
+ * \param[in] beta Scaling parameter for C of data type 'typeCompute'.
+ * \param[in] C Pointer to C's data in memory of the home device.
+ * \param[out] D Pointer to D's data in memory of the home device.
+ * \param[in] stream The HIP stream of the home device.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if some input data is invalid.
+ * \retval HIPTENSOR_STATUS_ARCH_MISMATCH if the home device is not current.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED if the plan stages, partitions or has
+ * several outputs.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED in HIPTENSOR_POINTER_MODE_DEVICE; alpha and beta
+ * must point to host memory.
+ */
+hiptensorStatus_t hiptensorContractionMultiDevice(const hiptensorHandle_t*          handle,
+                                                  const hiptensorContractionPlan_t* plan,
+                                                  const void*                       alpha,
+                                                  const void*                       A,
+                                                  const void*                       B,
+                                                  const void*                       beta,
+                                                  const void*                       C,
+                                                  void*                             D,
+                                                  hipStream_t                       stream);
+
+/**
+ * \brief Creates the transports of ranks that run in one process
+ *
+ * \details Ranks exchange messages through shared memory, e.g. with one rank per
+ * thread, so that distributed contractions can be run on a single machine. Sends are
+ * buffered and complete at once. Payloads may be in host or device memory.
+ *
+ * \param[in] numRanks Number of ranks.
+ * \param[out] transports Transport of each rank, to be released with
+ * \ref hiptensorDestroyInProcessTransports.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if numRanks is 0 or transports is nullptr.
+ */
+hiptensorStatus_t hiptensorCreateInProcessTransports(uint32_t             numRanks,
+                                                     hiptensorTransport_t transports[]);
+
+/**
+ * \brief Releases the transports created by \ref hiptensorCreateInProcessTransports
+ *
+ * \param[in] numRanks Number of ranks.
+ * \param[in,out] transports Transport of each rank.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if transports is nullptr.
+ */
+hiptensorStatus_t hiptensorDestroyInProcessTransports(uint32_t             numRanks,
+                                                      hiptensorTransport_t transports[]);
+
+/**
+ * \brief Returns a block of an operand held by a rank of a distributed contraction
+ *
+ * \details The ranks form a grid of rows and columns. The outermost M mode is split
+ * over its rows, the outermost N mode over its columns and, when C is present, the
+ * outermost K mode into panels. A rank's blocks of an operand are packed one after
+ * another in its local buffer, each with the operand's modes in descriptor order.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Opaque handle holding the contraction plan.
+ * \param[in] transport Transport of the rank.
+ * \param[in] operand 0, 1, 2 or 3 for A, B, C or D.
+ * \param[in] block Index of the block.
+ * \param[out] numBlocks Number of blocks of the operand held by the rank.
+ * \param[out] start Start of the block along the outermost M, N and K modes.
+ * \param[out] extent Extent of the block along the outermost M, N and K modes.
+ * \param[out] offset Element offset of the block in the rank's local buffer.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle, plan or transport is nullptr.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if the rank holds fewer blocks or an argument
+ * is invalid.
+ */
+hiptensorStatus_t hiptensorDistributedGetLocalBlock(const hiptensorHandle_t*          handle,
+                                                    const hiptensorContractionPlan_t* plan,
+                                                    const hiptensorTransport_t*       transport,
+                                                    uint32_t                          operand,
+                                                    uint32_t                          block,
+                                                    uint32_t*                         numBlocks,
+                                                    uint64_t                          start[],
+                                                    uint64_t                          extent[],
+                                                    uint64_t*                         offset);
+
+/**
+ * \brief Computes this rank's part of a distributed tensor contraction
+ * \f[ D = alpha * A * B + beta * C \f]
+ *
+ * \details Every rank calls this with the same plan and its local blocks, laid out
+ * as described by \ref hiptensorDistributedGetLocalBlock. At each K panel the ranks
+ * holding the panel's A blocks send them along their grid row and those holding its
+ * B blocks along their grid column. Every rank adds the panel's product into its D
+ * block with the plan's kernel. The transfers of the next panel are started before
+ * the current one is contracted. The call returns once the local D block is written.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Opaque handle holding the contraction plan of the whole problem.
+ * \param[in] transport Transport of the rank.
+ * \param[in] alpha Scaling parameter for A*B of data type 'typeCompute'.
+ * \param[in] A Pointer to the rank's A blocks in device memory.
+ * \param[in] B Pointer to the rank's B blocks in device memory.
+ * \param[in] beta Scaling parameter for C of data type 'typeCompute'.
+ * \param[in] C Pointer to the rank's C block in device memory.
+ * \param[out] D Pointer to the rank's D block in device memory.
+ * \param[in] stream The HIP stream that last wrote the local blocks.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle, plan or transport is not
+ * initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if some input data is invalid.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED if the plan has several outputs.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED in HIPTENSOR_POINTER_MODE_DEVICE; alpha and beta
+ * must point to host memory.
+ */
+hiptensorStatus_t hiptensorContractionDistributed(const hiptensorHandle_t*          handle,
+                                                  const hiptensorContractionPlan_t* plan,
+                                                  const hiptensorTransport_t*       transport,
+                                                  const void*                       alpha,
+                                                  const void*                       A,
+                                                  const void*                       B,
+                                                  const void*                       beta,
+                                                  const void*                       C,
+                                                  void*                             D,
+                                                  hipStream_t                       stream);
+
+/**
+ * \brief Initializes a block-sparse tensor descriptor
+ *
+ * \details Each mode is split into blocks of the given lengths, and only the listed
+ * blocks are stored. Every stored block is packed with its last mode fastest, starting
+ * at its element offset; all blocks that are not listed are zero.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] desc Block-sparse tensor descriptor.
+ * \param[in] numModes Number of modes.
+ * \param[in] blockCounts Number of blocks each mode is split into.
+ * \param[in] blockLengths Lengths of the blocks of each mode, one mode after another.
+ * \param[in] numBlocks Number of stored blocks.
+ * \param[in] blockCoordinates Block coordinates of each stored block, numModes each.
+ * \param[in] blockOffsets Element offset of each stored block.
+ * \param[in] dataType Data type of the stored elements.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or desc is nullptr.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if a block is out of range or listed twice.
+ */
+hiptensorStatus_t
+    hiptensorInitBlockSparseTensorDescriptor(const hiptensorHandle_t*                handle,
+                                             hiptensorBlockSparseTensorDescriptor_t* desc,
+                                             const uint32_t                          numModes,
+                                             const uint32_t                          blockCounts[],
+                                             const int64_t                           blockLengths[],
+                                             const uint32_t                          numBlocks,
+                                             const uint32_t blockCoordinates[],
+                                             const int64_t  blockOffsets[],
+                                             hipDataType    dataType);
+
+/**
+ * \brief Plans a contraction of block-sparse tensors
+ * \f[ D = alpha * A * B + beta * C \f]
+ *
+ * \details Stored A and B blocks whose contracted block coordinates agree are paired,
+ * and each pair is a dense contraction into the D block it lands in. Pairs of the same
+ * block shapes are grouped and share one dense plan. Modes shared by two operands must
+ * be split into the same blocks, every product must land in a stored D block, and C,
+ * when present, must be stored like D.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] plan Block-sparse plan, to be released with
+ * \ref hiptensorDestroyBlockSparsePlan.
+ * \param[in] descA Block-sparse descriptor of A.
+ * \param[in] modeA Modes of A.
+ * \param[in] descB Block-sparse descriptor of B.
+ * \param[in] modeB Modes of B.
+ * \param[in] descC Block-sparse descriptor of C, or nullptr without C.
+ * \param[in] modeC Modes of C.
+ * \param[in] descD Block-sparse descriptor of D.
+ * \param[in] modeD Modes of D.
+ * \param[in] typeCompute Datatype of for the intermediate computation.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is nullptr.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if the operands do not pair into stored D
+ * blocks.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED if no kernel supports a group of blocks.
+ */
+hiptensorStatus_t
+    hiptensorInitBlockSparseContractionPlan(const hiptensorHandle_t*                      handle,
+                                            hiptensorBlockSparsePlan_t*                   plan,
+                                            const hiptensorBlockSparseTensorDescriptor_t* descA,
+                                            const int32_t                                 modeA[],
+                                            const hiptensorBlockSparseTensorDescriptor_t* descB,
+                                            const int32_t                                 modeB[],
+                                            const hiptensorBlockSparseTensorDescriptor_t* descC,
+                                            const int32_t                                 modeC[],
+                                            const hiptensorBlockSparseTensorDescriptor_t* descD,
+                                            const int32_t                                 modeD[],
+                                            hiptensorComputeType_t typeCompute);
+
+/**
+ * \brief Computes a block-sparse tensor contraction
+ * \f[ D = alpha * A * B + beta * C \f]
+ *
+ * \details The block products are launched group by group on stream, the first into
+ * each D block scaling C by beta and the others adding into D. Stored D blocks that
+ * no product reaches are set to beta * C, or to zero without C.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Block-sparse plan.
+ * \param[in] alpha Scaling parameter for A*B of data type 'typeCompute'.
+ * \param[in] A Pointer to A's stored blocks in device memory.
+ * \param[in] B Pointer to B's stored blocks in device memory.
+ * \param[in] beta Scaling parameter for C of data type 'typeCompute'.
+ * \param[in] C Pointer to C's stored blocks in device memory.
+ * \param[out] D Pointer to D's stored blocks in device memory.
+ * \param[in] stream The HIP stream in which all the computation is performed.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if some input data is invalid.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED if D is not f16, f32 or f64.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED in HIPTENSOR_POINTER_MODE_DEVICE; alpha and beta
+ * must point to host memory.
+ */
+hiptensorStatus_t hiptensorBlockSparseContraction(const hiptensorHandle_t*          handle,
+                                                  const hiptensorBlockSparsePlan_t* plan,
+                                                  const void*                       alpha,
+                                                  const void*                       A,
+                                                  const void*                       B,
+                                                  const void*                       beta,
+                                                  const void*                       C,
+                                                  void*                             D,
+                                                  hipStream_t                       stream);
+
+/**
+ * \brief Computes a block-sparse tensor contraction of host operands on host threads
+ *
+ * \details The stored D blocks are shared out between the threads, each contracting
+ * every product into its blocks, so that no two threads write the same block.
+ *
+ * \param[in] plan Block-sparse plan.
+ * \param[in] alpha Scaling parameter for A*B in the operands' type.
+ * \param[in] A Pointer to A's stored blocks in host memory.
+ * \param[in] B Pointer to B's stored blocks in host memory.
+ * \param[in] beta Scaling parameter for C in the operands' type.
+ * \param[in] C Pointer to C's stored blocks in host memory.
+ * \param[out] D Pointer to D's stored blocks in host memory.
+ * \param[in] numThreads Number of threads, or 0 for one per hardware thread.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if some input data is invalid.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED unless A, B and D are all f32 or all f64.
+ */
+hiptensorStatus_t hiptensorBlockSparseContractionHost(const hiptensorBlockSparsePlan_t* plan,
+                                                      const void*                       alpha,
+                                                      const void*                       A,
+                                                      const void*                       B,
+                                                      const void*                       beta,
+                                                      const void*                       C,
+                                                      void*                             D,
+                                                      uint32_t numThreads);
+
+/**
+ * \brief Releases a plan created by \ref hiptensorInitBlockSparseContractionPlan
+ *
+ * \param[in,out] plan Block-sparse plan.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ */
+hiptensorStatus_t hiptensorDestroyBlockSparsePlan(hiptensorBlockSparsePlan_t* plan);
+
+/**
+ * \brief Initializes a descriptor of a tensor stored in packed-triangle form
+ *
+ * \details Each symmetry group names modes of one length that may be permuted among
+ * each other, leaving the tensor unchanged or, for antisymmetric groups, negating it
+ * under odd permutations. A group stores only the elements whose indices do not
+ * increase along its modes, strictly decreasing for antisymmetric groups, numbered in
+ * colexicographic order at the group's first mode; two modes (i, j) are stored as the
+ * row-major lower triangle at i * (i + 1) / 2 + j. Packed indices are laid out with
+ * the last one fastest.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] desc Symmetric tensor descriptor.
+ * \param[in] numModes Number of modes.
+ * \param[in] lens Extent of each mode of the full tensor.
+ * \param[in] numGroups Number of symmetry groups.
+ * \param[in] groupSizes Number of modes in each group.
+ * \param[in] groupModes Positions of the modes of each group, one group after another.
+ * \param[in] groupSymmetry Symmetry of each group.
+ * \param[in] dataType Data type of the stored elements.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or desc is nullptr.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if groups overlap, have fewer than two modes or
+ * modes of different lengths.
+ */
+hiptensorStatus_t
+    hiptensorInitSymmetricTensorDescriptor(const hiptensorHandle_t*              handle,
+                                           hiptensorSymmetricTensorDescriptor_t* desc,
+                                           const uint32_t                        numModes,
+                                           const int64_t                         lens[],
+                                           const uint32_t                        numGroups,
+                                           const uint32_t                        groupSizes[],
+                                           const uint32_t                        groupModes[],
+                                           const hiptensorSymmetry_t             groupSymmetry[],
+                                           hipDataType                           dataType);
+
+/**
+ * \brief Computes the bytes of a tensor in packed-triangle form
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] desc Symmetric tensor descriptor.
+ * \param[out] size Bytes of the stored elements.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if an argument is nullptr or desc is invalid.
+ */
+hiptensorStatus_t
+    hiptensorSymmetricTensorGetPackedSize(const hiptensorHandle_t*                    handle,
+                                          const hiptensorSymmetricTensorDescriptor_t* desc,
+                                          uint64_t*                                   size);
+
+/**
+ * \brief Plans a contraction of tensors in packed-triangle form
+ * \f[ D = alpha * A * B + beta * C \f]
+ *
+ * \details Only D's stored elements are written, so D's symmetry groups must hold for
+ * the product. Every mode appears in exactly two operands with one length, and C,
+ * when present, must be packed like D.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] plan Symmetric plan, to be released with \ref hiptensorDestroySymmetricPlan.
+ * \param[in] descA Symmetric descriptor of A.
+ * \param[in] modeA Modes of A.
+ * \param[in] descB Symmetric descriptor of B.
+ * \param[in] modeB Modes of B.
+ * \param[in] descC Symmetric descriptor of C, or nullptr without C.
+ * \param[in] modeC Modes of C.
+ * \param[in] descD Symmetric descriptor of D.
+ * \param[in] modeD Modes of D.
+ * \param[in] typeCompute Datatype of for the intermediate computation.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is nullptr.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if the operands do not form a contraction.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED if no kernel supports the full contraction.
+ */
+hiptensorStatus_t
+    hiptensorInitSymmetricContractionPlan(const hiptensorHandle_t*                    handle,
+                                          hiptensorSymmetricPlan_t*                   plan,
+                                          const hiptensorSymmetricTensorDescriptor_t* descA,
+                                          const int32_t                               modeA[],
+                                          const hiptensorSymmetricTensorDescriptor_t* descB,
+                                          const int32_t                               modeB[],
+                                          const hiptensorSymmetricTensorDescriptor_t* descC,
+                                          const int32_t                               modeC[],
+                                          const hiptensorSymmetricTensorDescriptor_t* descD,
+                                          const int32_t                               modeD[],
+                                          hiptensorComputeType_t typeCompute);
+
+/**
+ * \brief Computes the workspace of \ref hiptensorSymmetricContraction
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Symmetric plan.
+ * \param[out] workspaceSize Bytes of the full operands and of the dense kernel's
+ * workspace.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if an argument is nullptr.
+ */
+hiptensorStatus_t
+    hiptensorSymmetricContractionGetWorkspaceSize(const hiptensorHandle_t*        handle,
+                                                  const hiptensorSymmetricPlan_t* plan,
+                                                  uint64_t*                       workspaceSize);
+
+/**
+ * \brief Computes a contraction of tensors in packed-triangle form
+ * \f[ D = alpha * A * B + beta * C \f]
+ *
+ * \details The packed operands are expanded into the workspace, contracted in full by
+ * a dense kernel and D's stored elements are packed, all on stream. A null workspace
+ * draws on the handle's workspace pool.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Symmetric plan.
+ * \param[in] alpha Scaling parameter for A*B of data type 'typeCompute'.
+ * \param[in] A Pointer to packed A in device memory.
+ * \param[in] B Pointer to packed B in device memory.
+ * \param[in] beta Scaling parameter for C of data type 'typeCompute'.
+ * \param[in] C Pointer to packed C in device memory.
+ * \param[out] D Pointer to packed D in device memory.
+ * \param[out] workspace Workspace in device memory, or nullptr.
+ * \param[in] workspaceSize Bytes of workspace.
+ * \param[in] stream The HIP stream in which all the computation is performed.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if some input data is invalid.
+ * \retval HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE if the workspace is too small.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED in HIPTENSOR_POINTER_MODE_DEVICE; alpha and beta
+ * must point to host memory.
+ */
+hiptensorStatus_t hiptensorSymmetricContraction(const hiptensorHandle_t*        handle,
+                                                const hiptensorSymmetricPlan_t* plan,
+                                                const void*                     alpha,
+                                                const void*                     A,
+                                                const void*                     B,
+                                                const void*                     beta,
+                                                const void*                     C,
+                                                void*                           D,
+                                                void*                           workspace,
+                                                uint64_t                        workspaceSize,
+                                                hipStream_t                     stream);
+
+/**
+ * \brief Computes a contraction of host tensors in packed-triangle form on host threads
+ *
+ * \details Only D's stored elements are computed, and contracted modes over which A
+ * and B share a symmetry group are summed over sorted indices only, each weighted by
+ * its number of permutations. Serves as the reference for the device path.
+ *
+ * \param[in] plan Symmetric plan.
+ * \param[in] alpha Scaling parameter for A*B in the operands' type.
+ * \param[in] A Pointer to packed A in host memory.
+ * \param[in] B Pointer to packed B in host memory.
+ * \param[in] beta Scaling parameter for C in the operands' type.
+ * \param[in] C Pointer to packed C in host memory.
+ * \param[out] D Pointer to packed D in host memory.
+ * \param[in] numThreads Number of threads, or 0 for one per hardware thread.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if some input data is invalid.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED unless A, B and D are all f32 or all f64.
+ */
+hiptensorStatus_t hiptensorSymmetricContractionHost(const hiptensorSymmetricPlan_t* plan,
+                                                    const void*                     alpha,
+                                                    const void*                     A,
+                                                    const void*                     B,
+                                                    const void*                     beta,
+                                                    const void*                     C,
+                                                    void*                           D,
+                                                    uint32_t                        numThreads);
+
+/**
+ * \brief Releases a plan created by \ref hiptensorInitSymmetricContractionPlan
+ *
+ * \param[in,out] plan Symmetric plan.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ */
+hiptensorStatus_t hiptensorDestroySymmetricPlan(hiptensorSymmetricPlan_t* plan);
+
+/**
+ * \brief Plans the product of a tensor with a matrix along each of several modes
+ * \f[ Y = alpha * X \times_{m_1} U_1 \cdots \times_{m_n} U_n + beta * C \f]
+ *
+ * \details Each matrix U_j = [R_j, K_j] has modes {modeU[2j], modeU[2j+1]}; its second
+ * mode names a mode of X, which Y holds in the same position under its first mode. The
+ * products are applied in the order of fewest multiply-adds, preferring the smaller
+ * largest intermediate among equal orders, and each runs as a planned contraction.
+ * All operands are packed with the last mode fastest and share one data type.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] plan Multi-TTM plan, to be released with \ref hiptensorDestroyMultiTtmPlan.
+ * \param[in] descX Descriptor of X.
+ * \param[in] modeX Modes of X.
+ * \param[in] numMatrices Number of matrices, at least one.
+ * \param[in] descU Descriptors of the matrices.
+ * \param[in] modeU Two modes per matrix: its output mode, then the mode of X it contracts.
+ * \param[in] descC Descriptor of C, or nullptr when C is not read.
+ * \param[in] modeC Modes of C, which must equal modeY.
+ * \param[in] descY Descriptor of Y.
+ * \param[in] modeY Modes of Y.
+ * \param[in] typeCompute Datatype of the intermediate computation.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if the operands or modes are inconsistent.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED if a product has no supporting kernel.
+ */
+hiptensorStatus_t hiptensorInitMultiTtmPlan(const hiptensorHandle_t*           handle,
+                                            hiptensorMultiTtmPlan_t*           plan,
+                                            const hiptensorTensorDescriptor_t* descX,
+                                            const int32_t                      modeX[],
+                                            const uint32_t                     numMatrices,
+                                            const hiptensorTensorDescriptor_t  descU[],
+                                            const int32_t                      modeU[],
+                                            const hiptensorTensorDescriptor_t* descC,
+                                            const int32_t                      modeC[],
+                                            const hiptensorTensorDescriptor_t* descY,
+                                            const int32_t                      modeY[],
+                                            hiptensorComputeType_t             typeCompute);
+
+/**
+ * \brief Computes the workspace a multi-TTM needs for its intermediates and kernels
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Multi-TTM plan.
+ * \param[out] workspaceSize Bytes of workspace required by \ref hiptensorMultiTtm.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if an argument is nullptr.
+ */
+hiptensorStatus_t hiptensorMultiTtmGetWorkspaceSize(const hiptensorHandle_t*       handle,
+                                                    const hiptensorMultiTtmPlan_t* plan,
+                                                    uint64_t*                      workspaceSize);
+
+/**
+ * \brief Applies the matrices of a multi-TTM plan to X
+ *
+ * \details Intermediates alternate between two regions of the workspace; only the last
+ * product applies alpha, beta and C. Scalars are read from host memory.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] plan Multi-TTM plan.
+ * \param[in] alpha Scaling parameter in the operands' type.
+ * \param[in] X Pointer to X in device memory.
+ * \param[in] U Pointers to the matrices in device memory, in the order of descU.
+ * \param[in] beta Scaling parameter for C in the operands' type.
+ * \param[in] C Pointer to C in device memory, or nullptr when the plan has no C.
+ * \param[out] Y Pointer to Y in device memory.
+ * \param[out] workspace Device workspace, or nullptr to draw from the handle's pool.
+ * \param[in] workspaceSize Bytes of workspace.
+ * \param[in] stream Stream to execute on.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if some input data is invalid.
+ * \retval HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE if workspaceSize is too small.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED unless the operands are f16, f32 or f64.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED in HIPTENSOR_POINTER_MODE_DEVICE; alpha and beta
+ * must point to host memory.
+ */
+hiptensorStatus_t hiptensorMultiTtm(const hiptensorHandle_t*       handle,
+                                    const hiptensorMultiTtmPlan_t* plan,
+                                    const void*                    alpha,
+                                    const void*                    X,
+                                    const void* const              U[],
+                                    const void*                    beta,
+                                    const void*                    C,
+                                    void*                          Y,
+                                    void*                          workspace,
+                                    uint64_t                       workspaceSize,
+                                    hipStream_t                    stream);
+
+/**
+ * \brief Applies the matrices of a multi-TTM plan to X on the host
+ *
+ * \details Follows the plan's order of products. Serves as the reference for the
+ * device path.
+ *
+ * \param[in] plan Multi-TTM plan.
+ * \param[in] alpha Scaling parameter in the operands' type.
+ * \param[in] X Pointer to X in host memory.
+ * \param[in] U Pointers to the matrices in host memory, in the order of descU.
+ * \param[in] beta Scaling parameter for C in the operands' type.
+ * \param[in] C Pointer to C in host memory, or nullptr when the plan has no C.
+ * \param[out] Y Pointer to Y in host memory.
+ * \param[in] numThreads Number of threads, or 0 for one per hardware thread.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the plan is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if some input data is invalid.
+ * \retval HIPTENSOR_STATUS_NOT_SUPPORTED unless the operands are f32 or f64.
+ */
+hiptensorStatus_t hiptensorMultiTtmHost(const hiptensorMultiTtmPlan_t* plan,
+                                        const void*                    alpha,
+                                        const void*                    X,
+                                        const void* const              U[],
+                                        const void*                    beta,
+                                        const void*                    C,
+                                        void*                          Y,
+                                        uint32_t                       numThreads);
+
+/**
+ * \brief Releases a plan created by \ref hiptensorInitMultiTtmPlan
+ *
+ * \param[in,out] plan Multi-TTM plan.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ */
+hiptensorStatus_t hiptensorDestroyMultiTtmPlan(hiptensorMultiTtmPlan_t* plan);
+
+/**
+ * \brief Starts recording the operations issued on a handle into a graph.
+ *
+ * \details Until \ref hiptensorEndCapture, calls to \ref hiptensorContraction and
+ * \ref hiptensorPermutation are validated as usual and recorded together with
+ * their plans, scalars and buffers instead of being launched. Every distinct
+ * buffer becomes a binding, numbered in order of first use. A contraction given
+ * no workspace takes a block of the handle's workspace pool for the graph alone,
+ * held until the graph is destroyed; trimming the pool leaves it in place. The
+ * graph must be destroyed before the handle.
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle is not initialized.
+ */
+hiptensorStatus_t hiptensorBeginCapture(const hiptensorHandle_t* handle);
+
+/**
+ * \brief Stops recording and returns the recorded graph.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[out] graph Recorded graph, to be released with \ref hiptensorDestroyGraph.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if graph is nullptr or the handle is not capturing.
+ */
+hiptensorStatus_t hiptensorEndCapture(const hiptensorHandle_t* handle, hiptensorGraph_t* graph);
+
+/**
+ * \brief Queries the number of buffer bindings of a graph.
+ *
+ * \param[in] graph Recorded graph.
+ * \param[out] numBindings Number of distinct buffers the graph operates on.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the graph is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if numBindings is nullptr.
+ */
+hiptensorStatus_t hiptensorGraphGetBindingCount(const hiptensorGraph_t* graph,
+                                                uint32_t*               numBindings);
+
+/**
+ * \brief Replays the operations of a graph against new buffers.
+ *
+ * \details Replay skips the validation, logging and plan lookup of the recorded
+ * calls. On a non-null stream the operations are captured into a HIP graph that
+ * is relaunched as a single hipGraphLaunch for as long as the bindings stay the
+ * same.
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \param[in] graph Recorded graph.
+ * \param[in] bindings New base pointers of the bindings; nullptr entries, and any
+ * beyond numBindings, keep the recorded pointer.
+ * \param[in] numBindings Number of entries in bindings.
+ * \param[in] stream The HIP stream in which all the computation is performed.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle or graph is not initialized.
+ * \retval HIPTENSOR_STATUS_HIP_ERROR if the HIP graph cannot be captured or launched.
+ */
+hiptensorStatus_t hiptensorGraphReplay(const hiptensorHandle_t* handle,
+                                       hiptensorGraph_t*        graph,
+                                       const void* const        bindings[],
+                                       uint32_t                 numBindings,
+                                       hipStream_t              stream);
+
+/**
+ * \brief Releases a graph returned by \ref hiptensorEndCapture.
+ *
+ * \param[in] graph Recorded graph.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ */
+hiptensorStatus_t hiptensorDestroyGraph(hiptensorGraph_t* graph);
+
+/**
+ * \brief Switches a handle to deferred execution.
+ *
+ * \details Until \ref hiptensorEndDeferred, calls to \ref hiptensorContraction and
+ * \ref hiptensorPermutation are validated as usual and queued on the handle
+ * instead of being launched. Their buffers must stay valid until the queue is
+ * flushed. A flush drops permutations that leave their buffers unchanged, such
+ * as a permutation followed by its inverse, and runs the rest in the order they
+ * were queued. Buffers are compared by the bytes their tensors span, so views
+ * into one allocation are ordered as they overlap.
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle is not initialized.
+ */
+hiptensorStatus_t hiptensorBeginDeferred(const hiptensorHandle_t* handle);
+
+/**
+ * \brief Runs the operations queued on a handle in deferred mode.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if the handle is not in deferred mode.
+ * \remarks On failure the remaining queued operations are discarded.
+ */
+hiptensorStatus_t hiptensorFlush(const hiptensorHandle_t* handle);
+
+/**
+ * \brief Flushes the queue and switches a handle back to immediate execution.
+ *
+ * \param[in] handle Opaque handle holding hipTensor's library context.
+ * \retval HIPTENSOR_STATUS_SUCCESS Successful completion of the operation.
+ * \retval HIPTENSOR_STATUS_NOT_INITIALIZED if the handle is not initialized.
+ * \retval HIPTENSOR_STATUS_INVALID_VALUE if the handle is not in deferred mode.
+ */
+hiptensorStatus_t hiptensorEndDeferred(const hiptensorHandle_t* handle);
+
 /**
  * \brief Registers a callback function that will be invoked by logger calls.
  * Note: Functionally additive to existing logging functionality.
@@ -0,0 +1,450 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_PLANNED_CONTRACTION_HPP
+#define HIPTENSOR_PLANNED_CONTRACTION_HPP
+
+#include <array>
+#include <type_traits>
+
+#include "hiptensor.hpp"
+
+/**
+ * \brief Header-only planned contraction interface.
+ *
+ * \details Element type, operator and the mode layout of every operand are
+ * template parameters, so layouts are checked and put in kernel order by the
+ * compiler:
+ *
+ * \code
+ * using Contraction = hiptensor::PlannedContraction<float,
+ *                                                   hiptensor::Modes<'m', 'n', 'k', 'l'>,
+ *                                                   hiptensor::Modes<'u', 'v', 'k', 'l'>,
+ *                                                   hiptensor::Modes<'m', 'n', 'u', 'v'>>;
+ * Contraction contraction(handle, lengthsA, lengthsB);
+ * contraction(alpha, A, B, beta, C, D, workspace, stream);
+ * \endcode
+ *
+ * This is a typed wrapper over the C API, not a separate kernel path. Lengths and
+ * strides are held in fixed-size arrays in kernel order, and the plan, with its
+ * kernel instance, is selected at run time once on construction. Each call is an
+ * ordinary hiptensorContraction on that plan, with the validation and dispatch of
+ * any other call. Layouts the library has no kernels for are rejected at compile
+ * time.
+ */
+namespace hiptensor
+{
+    /// Compile-time mode labels of an operand, outermost first
+    template <char... Ls>
+    struct Modes
+    {
+        static constexpr std::size_t            Rank   = sizeof...(Ls);
+        static constexpr std::array<char, Rank> Labels = {Ls...};
+    };
+
+    namespace planned
+    {
+        template <std::size_t N>
+        constexpr std::size_t indexOf(std::array<char, N> const& labels, char label)
+        {
+            for(std::size_t i = 0; i < N; i++)
+            {
+                if(labels[i] == label)
+                {
+                    return i;
+                }
+            }
+            return N;
+        }
+
+        template <std::size_t N>
+        constexpr bool contains(std::array<char, N> const& labels, char label)
+        {
+            return indexOf(labels, label) < N;
+        }
+
+        template <std::size_t N>
+        constexpr bool unique(std::array<char, N> const& labels)
+        {
+            for(std::size_t i = 0; i < N; i++)
+            {
+                if(indexOf(labels, labels[i]) != i)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Selects values in the given order
+        template <typename T, std::size_t N>
+        constexpr std::array<T, N> permute(std::array<T, N> const&           values,
+                                           std::array<std::size_t, N> const& order)
+        {
+            std::array<T, N> result = {};
+            for(std::size_t i = 0; i < N; i++)
+            {
+                result[i] = values[order[i]];
+            }
+            return result;
+        }
+
+        // Packed strides, last mode fastest, as for descriptors initialized without strides
+        template <std::size_t N>
+        constexpr std::array<int64_t, N> packedStrides(std::array<int64_t, N> const& lengths)
+        {
+            std::array<int64_t, N> strides = {};
+            int64_t                stride  = 1;
+            for(std::size_t i = N; i > 0; i--)
+            {
+                strides[i - 1] = stride;
+                stride *= lengths[i - 1];
+            }
+            return strides;
+        }
+
+        /// Compile-time analysis of D = A * B. Kernels take A as [M..., K...], B as
+        /// [N..., K...] and C and D as [M..., N...], with M and N in the order of D
+        /// and K in the order of A; the orders map kernel positions to operand modes.
+        template <typename ModesA, typename ModesB, typename ModesD>
+        struct ContractionLayout
+        {
+            static constexpr auto& LabelsA = ModesA::Labels;
+            static constexpr auto& LabelsB = ModesB::Labels;
+            static constexpr auto& LabelsD = ModesD::Labels;
+
+            static constexpr std::size_t countM()
+            {
+                std::size_t count = 0;
+                for(auto label : LabelsD)
+                {
+                    count += contains(LabelsA, label) ? 1 : 0;
+                }
+                return count;
+            }
+
+            static constexpr std::size_t RankM = countM();
+            static constexpr std::size_t RankN = ModesD::Rank - RankM;
+            static constexpr std::size_t RankK = ModesA::Rank - RankM;
+
+            // Every mode of D comes from exactly one of A and B, and all others are
+            // contracted between A and B
+            static constexpr bool valid()
+            {
+                if(!unique(LabelsA) || !unique(LabelsB) || !unique(LabelsD)
+                   || RankM > ModesA::Rank || RankN + RankK != ModesB::Rank)
+                {
+                    return false;
+                }
+                for(auto label : LabelsD)
+                {
+                    if(contains(LabelsA, label) == contains(LabelsB, label))
+                    {
+                        return false;
+                    }
+                }
+                for(auto label : LabelsA)
+                {
+                    if(!contains(LabelsD, label) && !contains(LabelsB, label))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            static constexpr bool Valid = valid();
+
+            // Positions in an operand of the D modes found in Source, then, if
+            // contracted, of the K modes in the order of A
+            template <typename Source, typename Operand>
+            static constexpr std::array<std::size_t, Operand::Rank> order(bool contracted)
+            {
+                std::array<std::size_t, Operand::Rank> result = {};
+                std::size_t                            count  = 0;
+                for(auto label : LabelsD)
+                {
+                    if(contains(Source::Labels, label) && count < Operand::Rank)
+                    {
+                        result[count++] = indexOf(Operand::Labels, label);
+                    }
+                }
+                for(auto label : LabelsA)
+                {
+                    if(contracted && !contains(LabelsD, label) && count < Operand::Rank)
+                    {
+                        result[count++] = indexOf(Operand::Labels, label);
+                    }
+                }
+                return result;
+            }
+
+            static constexpr std::array<std::size_t, ModesD::Rank> orderD()
+            {
+                std::array<std::size_t, ModesD::Rank> result = {};
+
+                auto m = order<ModesA, ModesD>(false);
+                auto n = order<ModesB, ModesD>(false);
+                for(std::size_t i = 0; i < ModesD::Rank; i++)
+                {
+                    result[i] = i < RankM ? m[i] : n[i - RankM];
+                }
+                return result;
+            }
+
+            static constexpr auto OrderA = order<ModesA, ModesA>(true);
+            static constexpr auto OrderB = order<ModesB, ModesB>(true);
+            static constexpr auto OrderD = orderD();
+        };
+
+        template <typename DataT>
+        constexpr hipDataType dataType()
+        {
+            return std::is_same_v<DataT, double> ? HIP_R_64F : HIP_R_32F;
+        }
+
+    } // namespace planned
+
+    /// Contraction D = alpha * A * B + beta * C, or D = alpha * A * B without
+    /// Bilinear, of a fixed mode layout. C has the modes and lengths of D and
+    /// strides of its own.
+    template <typename DataT,
+              typename ModesA,
+              typename ModesB,
+              typename ModesD,
+              bool Bilinear = true>
+    class PlannedContraction
+    {
+    public:
+        using Layout = planned::ContractionLayout<ModesA, ModesB, ModesD>;
+
+        static_assert(std::is_same_v<DataT, float> || std::is_same_v<DataT, double>,
+                      "Contractions are provided for float and double");
+        static_assert(Layout::Valid,
+                      "Every mode of D must come from one of A and B, and all other modes must "
+                      "be shared by A and B");
+        static_assert(Layout::RankM == 2 && Layout::RankN == 2 && Layout::RankK == 2,
+                      "Contraction kernels are provided for two M, N and K modes");
+
+        using LengthsA = std::array<int64_t, ModesA::Rank>;
+        using LengthsB = std::array<int64_t, ModesB::Rank>;
+        using LengthsD = std::array<int64_t, ModesD::Rank>;
+
+        // Packed operands, last mode fastest, aligned to alignment bytes
+        PlannedContraction(hiptensorHandle_t const* handle,
+                           LengthsA const&          lengthsA,
+                           LengthsB const&          lengthsB,
+                           uint32_t                 alignment = 16u)
+            : PlannedContraction(handle,
+                                 lengthsA,
+                                 planned::packedStrides(lengthsA),
+                                 lengthsB,
+                                 planned::packedStrides(lengthsB),
+                                 planned::packedStrides(lengthsD(lengthsA, lengthsB)),
+                                 planned::packedStrides(lengthsD(lengthsA, lengthsB)),
+                                 alignment)
+        {
+        }
+
+        PlannedContraction(hiptensorHandle_t const* handle,
+                           LengthsA const&          lengthsA,
+                           LengthsA const&          stridesA,
+                           LengthsB const&          lengthsB,
+                           LengthsB const&          stridesB,
+                           LengthsD const&          stridesC,
+                           LengthsD const&          stridesD,
+                           uint32_t                 alignment = 16u)
+            : mHandle(handle)
+            , mPlan{}
+            , mWorkspaceSize(0u)
+        {
+            auto d  = lengthsD(lengthsA, lengthsB);
+            mStatus = initPlan(view(lengthsA, stridesA, Layout::OrderA, ModesA::Labels),
+                               view(lengthsB, stridesB, Layout::OrderB, ModesB::Labels),
+                               view(d, stridesC, Layout::OrderD, ModesD::Labels),
+                               view(d, stridesD, Layout::OrderD, ModesD::Labels),
+                               alignment);
+        }
+
+        // Lengths of D, taken from the operands its modes come from
+        static constexpr LengthsD lengthsD(LengthsA const& lengthsA, LengthsB const& lengthsB)
+        {
+            LengthsD lengths = {};
+            for(std::size_t i = 0; i < ModesD::Rank; i++)
+            {
+                auto label = ModesD::Labels[i];
+                auto a     = planned::indexOf(ModesA::Labels, label);
+                lengths[i] = a < ModesA::Rank ? lengthsA[a]
+                                              : lengthsB[planned::indexOf(ModesB::Labels, label)];
+            }
+            return lengths;
+        }
+
+        // Status of the plan selection on construction
+        hiptensorStatus_t status() const
+        {
+            return mStatus;
+        }
+
+        // Workspace each call needs (in bytes)
+        uint64_t workspaceSize() const
+        {
+            return mWorkspaceSize;
+        }
+
+        // Runs the contraction; beta and C are unused without Bilinear
+        hiptensorStatus_t operator()(DataT        alpha,
+                                     DataT const* A,
+                                     DataT const* B,
+                                     DataT        beta,
+                                     DataT const* C,
+                                     DataT*       D,
+                                     void*        workspace,
+                                     hipStream_t  stream = nullptr) const
+        {
+            if(mStatus != HIPTENSOR_STATUS_SUCCESS)
+            {
+                return mStatus;
+            }
+            return hiptensorContraction(mHandle,
+                                        &mPlan,
+                                        &alpha,
+                                        A,
+                                        B,
+                                        Bilinear ? &beta : nullptr,
+                                        Bilinear ? C : nullptr,
+                                        D,
+                                        workspace,
+                                        mWorkspaceSize,
+                                        stream);
+        }
+
+    private:
+        /// Operand in kernel order
+        template <std::size_t Rank>
+        struct View
+        {
+            std::array<int64_t, Rank> mLengths;
+            std::array<int64_t, Rank> mStrides;
+            std::array<int32_t, Rank> mModes;
+        };
+
+        template <std::size_t Rank>
+        static constexpr View<Rank> view(std::array<int64_t, Rank> const&     lengths,
+                                         std::array<int64_t, Rank> const&     strides,
+                                         std::array<std::size_t, Rank> const& order,
+                                         std::array<char, Rank> const&        labels)
+        {
+            View<Rank> result = {};
+            for(std::size_t i = 0; i < Rank; i++)
+            {
+                result.mLengths[i] = lengths[order[i]];
+                result.mStrides[i] = strides[order[i]];
+                result.mModes[i]   = int32_t(labels[order[i]]);
+            }
+            return result;
+        }
+
+        template <std::size_t Rank>
+        hiptensorStatus_t describe(View<Rank> const& view, hiptensorTensorDescriptor_t* desc) const
+        {
+            return hiptensorInitTensorDescriptor(mHandle,
+                                                 desc,
+                                                 uint32_t(Rank),
+                                                 view.mLengths.data(),
+                                                 view.mStrides.data(),
+                                                 planned::dataType<DataT>(),
+                                                 HIPTENSOR_OP_IDENTITY);
+        }
+
+        hiptensorStatus_t initPlan(View<ModesA::Rank> const& a,
+                                   View<ModesB::Rank> const& b,
+                                   View<ModesD::Rank> const& c,
+                                   View<ModesD::Rank> const& d,
+                                   uint32_t                  alignment)
+        {
+            hiptensorTensorDescriptor_t descA, descB, descC, descD;
+            for(auto status : {describe(a, &descA),
+                               describe(b, &descB),
+                               describe(c, &descC),
+                               describe(d, &descD)})
+            {
+                if(status != HIPTENSOR_STATUS_SUCCESS)
+                {
+                    return status;
+                }
+            }
+
+            auto compute = std::is_same_v<DataT, double> ? HIPTENSOR_COMPUTE_64F
+                                                         : HIPTENSOR_COMPUTE_32F;
+
+            hiptensorContractionDescriptor_t desc;
+            auto status = hiptensorInitContractionDescriptor(mHandle,
+                                                             &desc,
+                                                             &descA,
+                                                             a.mModes.data(),
+                                                             alignment,
+                                                             &descB,
+                                                             b.mModes.data(),
+                                                             alignment,
+                                                             Bilinear ? &descC : nullptr,
+                                                             Bilinear ? c.mModes.data() : nullptr,
+                                                             Bilinear ? alignment : 0u,
+                                                             &descD,
+                                                             d.mModes.data(),
+                                                             alignment,
+                                                             compute);
+            if(status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                return status;
+            }
+
+            hiptensorContractionFind_t find;
+            status = hiptensorInitContractionFind(mHandle, &find, HIPTENSOR_ALGO_DEFAULT);
+            if(status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                return status;
+            }
+
+            status = hiptensorContractionGetWorkspaceSize(
+                mHandle, &desc, &find, HIPTENSOR_WORKSPACE_RECOMMENDED, &mWorkspaceSize);
+            if(status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                return status;
+            }
+
+            return hiptensorInitContractionPlan(mHandle, &mPlan, &desc, &find, mWorkspaceSize);
+        }
+
+        hiptensorHandle_t const*   mHandle;
+        hiptensorStatus_t          mStatus;
+        hiptensorContractionPlan_t mPlan;
+        uint64_t                   mWorkspaceSize;
+    };
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_PLANNED_CONTRACTION_HPP
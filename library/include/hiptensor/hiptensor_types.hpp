@@ -27,6 +27,7 @@
 #define HIPTENSOR_TYPES_HPP
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <iostream>
 #include <memory>
@@ -37,6 +38,21 @@
 #include <hip/hip_common.h>
 #include <hip/library_types.h>
 
+#include "internal/hiptensor_small_vector.hpp"
+
+/**
+ * \brief Maximum tensor rank held inline by a tensor descriptor.
+ * \details Descriptors of this rank or less never allocate heap memory; higher
+ * ranks spill their lengths and strides to the heap.
+ */
+#define HIPTENSOR_MAX_INLINE_RANK 12
+
+/**
+ * \brief Container for tensor lengths and strides with inline storage up to
+ * HIPTENSOR_MAX_INLINE_RANK modes.
+ */
+typedef hiptensor::SmallVector<std::size_t, HIPTENSOR_MAX_INLINE_RANK> hiptensorDimVector_t;
+
 /**
  * \brief hipTensor status type
  * \details The type is used to indicate the status of hipTensor library functions.
@@ -102,6 +118,40 @@ typedef enum
     HIPTENSOR_OP_UNKNOWN  = 126, /*!< reserved */
 } hiptensorOperator_t;
 
+/**
+ * \brief This enum selects the memory layout of a tensor's elements.
+ * \details Operations that assume packed storage, such as permutation, lay out the
+ * elements of each operand in the layout of its descriptor.
+ */
+typedef enum
+{
+    HIPTENSOR_LAYOUT_DEFAULT   = 0, /*!< Layout selected by the library build */
+    HIPTENSOR_LAYOUT_ROW_MAJOR = 1, /*!< The last mode is the fastest varying */
+    HIPTENSOR_LAYOUT_COL_MAJOR = 2, /*!< The first mode is the fastest varying */
+} hiptensorDataLayout_t;
+
+/**
+ * \brief This enum selects where the scalars of an operation are read from.
+ * \details In device mode alpha and beta point to device memory and are read on the
+ * operation's stream when it runs, so they may be produced by earlier device work
+ * without a copy back to the host.
+ */
+typedef enum
+{
+    HIPTENSOR_POINTER_MODE_HOST   = 0, /*!< Scalars are read on the host at call time */
+    HIPTENSOR_POINTER_MODE_DEVICE = 1, /*!< Scalars are read on the device in stream order */
+} hiptensorPointerMode_t;
+
+/**
+ * \brief This enum selects how a tensor changes when the modes of a symmetry group are
+ * permuted.
+ */
+typedef enum
+{
+    HIPTENSOR_SYMMETRY_SYMMETRIC     = 0, /*!< Unchanged by every permutation */
+    HIPTENSOR_SYMMETRY_ANTISYMMETRIC = 1, /*!< Negated by odd permutations */
+} hiptensorSymmetry_t;
+
 /**
  * \brief This captures the algorithm to be used to perform the tensor contraction.
  */
@@ -122,6 +172,18 @@ typedef enum
     HIPTENSOR_WORKSPACE_MAX         = 3, /*!< All algorithms will be available */
 } hiptensorWorksizePreference_t;
 
+/**
+ * \brief This enum decides how contraction plans rank the candidates they measure
+ * \details Every policy only considers candidates whose workspace fits the cap set
+ * with \ref hiptensorContractionFindSetPolicy.
+ */
+typedef enum
+{
+    HIPTENSOR_SELECTION_FASTEST             = 0, /*!< Shortest kernel time */
+    HIPTENSOR_SELECTION_SMALLEST_WORKSPACE  = 1, /*!< Least workspace within the tolerance */
+    HIPTENSOR_SELECTION_BANDWIDTH_EFFICIENT = 2, /*!< Best bandwidth net of workspace traffic */
+} hiptensorSelectionPolicy_t;
+
 /**
  * \brief This enum decides the logging context.
  * \details The logger output of certain contexts maybe constrained to these levels.
@@ -153,9 +215,12 @@ struct hiptensorHandle_t
  */
 struct hiptensorTensorDescriptor_t
 {
-    hipDataType              mType; /*!< Data type of the tensors enum selection */
-    std::vector<std::size_t> mLengths; /*!< Lengths of the tensor */
-    std::vector<std::size_t> mStrides; /*!< Strides of the tensor */
+    hipDataType           mType; /*!< Data type of the tensors enum selection */
+    hiptensorDimVector_t  mLengths; /*!< Lengths of the tensor */
+    hiptensorDimVector_t  mStrides; /*!< Strides of the tensor */
+    const void*           mSignature; /*!< Interned analysis owned by the handle (internal) */
+    hiptensorDataLayout_t mLayout; /*!< Memory layout of packed elements */
+    uint64_t              mGeneration; /*!< Generation of mSignature (internal) */
 };
 
 /**
@@ -169,9 +234,12 @@ struct hiptensorTensorDescriptor_t
 struct hiptensorContractionDescriptor_t
 {
     int32_t mContractionOpId; /*!< Enum that differentiates the internal contraction operation */
-    hiptensorComputeType_t                   mComputeType; /*!<Compute type for the contraction */
-    std::vector<hiptensorTensorDescriptor_t> mTensorDesc; /*!<Cache of tensor descriptors */
-    std::vector<uint32_t>                    mAlignmentReq; /*!<Cache of alignment requirements */
+    hiptensorComputeType_t                     mComputeType; /*!<Compute type for the contraction */
+    std::array<hiptensorTensorDescriptor_t, 4> mTensorDesc; /*!<Cache of tensor descriptors */
+    std::array<uint32_t, 4>                    mAlignmentReq; /*!<Cache of alignment requirements */
+    const void*                                mSignature; /*!<Interned analysis (internal) */
+    uint32_t                                   mOutputs; /*!<B, C and D operands sharing A */
+    uint64_t                                   mGeneration; /*!<Generation of mSignature */
 };
 
 /**
@@ -180,8 +248,11 @@ struct hiptensorContractionDescriptor_t
  */
 struct hiptensorContractionFind_t
 {
-    hiptensorAlgo_t    mSelectionAlgorithm;
-    std::vector<void*> mCandidates;
+    hiptensorAlgo_t            mSelectionAlgorithm;
+    std::vector<void*>         mCandidates;
+    hiptensorSelectionPolicy_t mSelectionPolicy; /*!< Ranking of measured candidates */
+    uint64_t                   mWorkspaceCap; /*!< Largest kernel workspace to consider */
+    float                      mTolerance; /*!< Slowdown from the fastest that is accepted */
 };
 
 /**
@@ -197,6 +268,163 @@ struct hiptensorContractionPlan_t
     hiptensorContractionDescriptor_t mContractionDesc; /*!< Represent the contraction descriptor */
 };
 
+/**
+ * \brief Problem sizes of a contraction descriptor
+ *
+ * Counts are 64-bit. A count that does not fit saturates at UINT64_MAX and sets
+ * mSaturated instead of wrapping. Operand bytes cover the memory spanned by each
+ * operand's strides, which exceeds its element count when strides are not packed.
+ */
+struct hiptensorContractionMetrics_t
+{
+    uint64_t mM; /*!< Product of the M mode lengths */
+    uint64_t mN; /*!< Product of the N mode lengths */
+    uint64_t mK; /*!< Product of the K mode lengths */
+    uint64_t mFlops; /*!< Floating-point operations, 2 * M * N * K */
+    uint64_t mBytes[4]; /*!< Bytes spanned by A, B, C and D, 0 for an absent C */
+    uint64_t mTotalBytes; /*!< Bytes spanned by all operands */
+    int32_t  mSaturated; /*!< Non-zero if some count exceeded 64 bits */
+};
+
+/**
+ * \brief Structure representing a B operand pre-packed for a contraction plan
+ *
+ * Holds a copy of B in the kernels' preferred layout together with the plan
+ * selected for that layout, as set up by hiptensorContractionPackOperand.
+ * Passing mPlan and mData to hiptensorContraction in place of the original
+ * plan and B reuses the packed copy for any number of contractions.
+ */
+struct hiptensorPackedOperand_t
+{
+    hiptensorContractionPlan_t mPlan; /*!< Plan selected for the packed layout */
+    void*                      mData; /*!< Packed operand in device memory */
+    uint64_t                   mBytes; /*!< Bytes taken by the packed operand */
+};
+
+/**
+ * \brief Structure representing a back-to-back contraction chain
+ *
+ * Describes D = alpha * (A * B) * C as two contraction stages, as set up by
+ * hiptensorInitContractionChainDescriptor. The intermediate X = A * B is formed
+ * one block of A's outermost mode at a time in the workspace, small enough to
+ * stay in cache for the second stage, and is never written out whole. When the
+ * blocks do not divide that mode, the shorter last block has stages of its own.
+ */
+struct hiptensorContractionChainDescriptor_t
+{
+    std::array<hiptensorContractionDescriptor_t, 2> mStages; /*!< X = A * B and D = X * C */
+    std::array<hiptensorContractionDescriptor_t, 2>
+                            mLastStages; /*!< Stages of a shorter last block, if mRaggedLast */
+    std::array<uint64_t, 2> mBlockOffsets; /*!< Element offsets between blocks of A and D */
+    uint64_t                mBlocks; /*!< Number of blocks */
+    uint64_t                mIntermediateBytes; /*!< Workspace taken by X of one block */
+    bool                    mRaggedLast; /*!< Whether the last block is shorter */
+};
+
+/**
+ * \brief Structure representing a plan for a back-to-back contraction chain
+ */
+struct hiptensorContractionChainPlan_t
+{
+    std::array<hiptensorContractionPlan_t, 2> mStages; /*!< Plans of the two stages */
+    std::array<hiptensorContractionPlan_t, 2> mLastStages; /*!< Plans of a shorter last block */
+    hiptensorContractionChainDescriptor_t     mChainDesc; /*!< Represent the chain descriptor */
+};
+
+/**
+ * \brief Structure representing a block-sparse tensor
+ *
+ * Every mode is split into blocks. Only the listed blocks are stored, each packed with
+ * its last mode fastest at its element offset; all other blocks are zero.
+ */
+struct hiptensorBlockSparseTensorDescriptor_t
+{
+    hipDataType                       mType; /*!< Data type of the tensor */
+    std::vector<hiptensorDimVector_t> mBlockLengths; /*!< Lengths of the blocks of each mode */
+    std::vector<hiptensorDimVector_t> mBlocks; /*!< Block coordinates of each stored block */
+    std::vector<uint64_t>             mOffsets; /*!< Element offset of each stored block */
+};
+
+/**
+ * \brief Structure representing a block-sparse contraction plan
+ */
+struct hiptensorBlockSparsePlan_t
+{
+    void* mPlan; /*!< Non-zero block pairs grouped by shape, with their dense plans */
+};
+
+/**
+ * \brief Structure representing modes of a tensor that can be permuted among each other
+ */
+struct hiptensorSymmetryGroup_t
+{
+    hiptensorSymmetry_t   mSymmetry; /*!< Symmetric or antisymmetric */
+    std::vector<uint32_t> mModes; /*!< Positions of the modes, all of the same length */
+};
+
+/**
+ * \brief Structure representing a tensor stored in packed-triangle form
+ *
+ * Each symmetry group stores only the elements whose indices do not increase along
+ * its modes, or strictly decrease for antisymmetric groups, packed into one index
+ * at the group's first mode. The others follow from the symmetry.
+ */
+struct hiptensorSymmetricTensorDescriptor_t
+{
+    hipDataType                           mType; /*!< Data type of the tensor */
+    hiptensorDimVector_t                  mLengths; /*!< Lengths of the full tensor */
+    std::vector<hiptensorSymmetryGroup_t> mGroups; /*!< Disjoint symmetry groups */
+};
+
+/**
+ * \brief Structure representing a contraction plan of packed symmetric tensors
+ */
+struct hiptensorSymmetricPlan_t
+{
+    void* mPlan; /*!< Packed layouts of the operands, with the dense plan */
+};
+
+/**
+ * \brief Structure representing a plan of products of a tensor with several matrices
+ */
+struct hiptensorMultiTtmPlan_t
+{
+    void* mPlan; /*!< Order of the products, with a contraction plan per product */
+};
+
+/**
+ * \brief Opaque sequence of operations recorded by a capturing handle
+ */
+struct hiptensorGraph_t
+{
+    void* mGraph; /*!< Recorded operations and their buffer bindings */
+};
+
+/**
+ * \brief Point-to-point transport between the ranks of a distributed contraction
+ *
+ * \details Transfers are started by send and receive without blocking, and complete
+ * when wait is called on the request they returned. Messages between two ranks with
+ * the same tag must arrive in send order. Buffers are device memory, so transports
+ * must be able to move it, e.g. a device-aware MPI.
+ */
+struct hiptensorTransport_t
+{
+    uint32_t mRank; /*!< Rank of the calling process */
+    uint32_t mSize; /*!< Number of ranks */
+    void*    mContext; /*!< Passed to every callback */
+
+    hiptensorStatus_t (*send)(void*       context,
+                              uint32_t    peer,
+                              uint32_t    tag,
+                              const void* buffer,
+                              uint64_t    bytes,
+                              void**      request);
+    hiptensorStatus_t (*receive)(
+        void* context, uint32_t peer, uint32_t tag, void* buffer, uint64_t bytes, void** request);
+    hiptensorStatus_t (*wait)(void* context, void* request);
+};
+
 /**
  * \brief Logging callback
  *
@@ -0,0 +1,352 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_SMALL_VECTOR_HPP
+#define HIPTENSOR_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace hiptensor
+{
+    /**
+     * \brief Contiguous container with inline storage for up to N elements.
+     * \details Elements live in a fixed-size inline buffer while size() <= N, so
+     * construction, copy and assignment of small containers never touch the heap.
+     * Growing beyond N spills all elements into a std::vector. The interface is a
+     * subset of std::vector, and the container converts to and from std::vector
+     * to keep existing call sites source-compatible.
+     */
+    template <typename T, std::size_t N>
+    class SmallVector
+    {
+        static_assert(N > 0, "SmallVector requires a non-zero inline capacity");
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "SmallVector is restricted to trivially copyable types");
+
+    public:
+        using value_type             = T;
+        using size_type              = std::size_t;
+        using difference_type        = std::ptrdiff_t;
+        using reference              = T&;
+        using const_reference        = T const&;
+        using pointer                = T*;
+        using const_pointer          = T const*;
+        using iterator               = T*;
+        using const_iterator         = T const*;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type InlineCapacity = N;
+
+        SmallVector() noexcept
+            : mSize(0)
+        {
+        }
+
+        explicit SmallVector(size_type count, T const& value = T{})
+            : mSize(0)
+        {
+            resize(count, value);
+        }
+
+        template <typename InputIt,
+                  typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        SmallVector(InputIt first, InputIt last)
+            : mSize(0)
+        {
+            assign(first, last);
+        }
+
+        SmallVector(std::initializer_list<T> init)
+            : mSize(0)
+        {
+            assign(init.begin(), init.end());
+        }
+
+        // Implicit to keep aggregate initialization from std::vector working
+        SmallVector(std::vector<T> const& other)
+            : mSize(0)
+        {
+            assign(other.begin(), other.end());
+        }
+
+        SmallVector(SmallVector const& other)
+            : mSize(0)
+        {
+            assign(other.begin(), other.end());
+        }
+
+        SmallVector(SmallVector&& other) noexcept
+            : mSize(other.mSize)
+            , mSpill(std::move(other.mSpill))
+        {
+            if(isInline())
+            {
+                std::copy(other.mInline, other.mInline + mSize, mInline);
+            }
+            other.mSize = 0;
+        }
+
+        SmallVector& operator=(SmallVector const& other)
+        {
+            if(this != &other)
+            {
+                assign(other.begin(), other.end());
+            }
+            return *this;
+        }
+
+        SmallVector& operator=(SmallVector&& other) noexcept
+        {
+            if(this != &other)
+            {
+                mSize  = other.mSize;
+                mSpill = std::move(other.mSpill);
+                if(isInline())
+                {
+                    mSpill.clear();
+                    std::copy(other.mInline, other.mInline + mSize, mInline);
+                }
+                other.mSize = 0;
+            }
+            return *this;
+        }
+
+        SmallVector& operator=(std::initializer_list<T> init)
+        {
+            assign(init.begin(), init.end());
+            return *this;
+        }
+
+        operator std::vector<T>() const
+        {
+            return std::vector<T>(begin(), end());
+        }
+
+        template <typename InputIt>
+        void assign(InputIt first, InputIt last)
+        {
+            auto count = static_cast<size_type>(std::distance(first, last));
+            if(count <= N)
+            {
+                mSpill.clear();
+                std::transform(
+                    first, last, mInline, [](auto const& v) { return static_cast<T>(v); });
+            }
+            else
+            {
+                mSpill.resize(count);
+                std::transform(
+                    first, last, mSpill.begin(), [](auto const& v) { return static_cast<T>(v); });
+            }
+            mSize = count;
+        }
+
+        void resize(size_type count, T const& value = T{})
+        {
+            if(count <= N)
+            {
+                if(!isInline())
+                {
+                    std::copy(mSpill.begin(), mSpill.begin() + count, mInline);
+                    mSpill.clear();
+                }
+                else if(count > mSize)
+                {
+                    std::fill(mInline + mSize, mInline + count, value);
+                }
+            }
+            else
+            {
+                if(isInline())
+                {
+                    mSpill.reserve(count);
+                    mSpill.assign(mInline, mInline + mSize);
+                }
+                mSpill.resize(count, value);
+            }
+            mSize = count;
+        }
+
+        void push_back(T const& value)
+        {
+            if(mSize < N)
+            {
+                mInline[mSize] = value;
+            }
+            else
+            {
+                if(mSize == N)
+                {
+                    mSpill.reserve(2 * N);
+                    mSpill.assign(mInline, mInline + N);
+                }
+                mSpill.push_back(value);
+            }
+            mSize++;
+        }
+
+        void pop_back()
+        {
+            resize(mSize - 1);
+        }
+
+        void clear() noexcept
+        {
+            mSpill.clear();
+            mSize = 0;
+        }
+
+        size_type size() const noexcept
+        {
+            return mSize;
+        }
+
+        bool empty() const noexcept
+        {
+            return mSize == 0;
+        }
+
+        // True while the elements are held in the inline buffer.
+        bool isInline() const noexcept
+        {
+            return mSize <= N;
+        }
+
+        T* data() noexcept
+        {
+            return isInline() ? mInline : mSpill.data();
+        }
+
+        T const* data() const noexcept
+        {
+            return isInline() ? mInline : mSpill.data();
+        }
+
+        T& operator[](size_type i) noexcept
+        {
+            return data()[i];
+        }
+
+        T const& operator[](size_type i) const noexcept
+        {
+            return data()[i];
+        }
+
+        T& front() noexcept
+        {
+            return data()[0];
+        }
+
+        T const& front() const noexcept
+        {
+            return data()[0];
+        }
+
+        T& back() noexcept
+        {
+            return data()[mSize - 1];
+        }
+
+        T const& back() const noexcept
+        {
+            return data()[mSize - 1];
+        }
+
+        iterator begin() noexcept
+        {
+            return data();
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return data();
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return data();
+        }
+
+        iterator end() noexcept
+        {
+            return data() + mSize;
+        }
+
+        const_iterator end() const noexcept
+        {
+            return data() + mSize;
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return data() + mSize;
+        }
+
+        reverse_iterator rbegin() noexcept
+        {
+            return reverse_iterator(end());
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator(end());
+        }
+
+        reverse_iterator rend() noexcept
+        {
+            return reverse_iterator(begin());
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        friend bool operator==(SmallVector const& lhs, SmallVector const& rhs)
+        {
+            return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator!=(SmallVector const& lhs, SmallVector const& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        size_type      mSize;
+        T              mInline[N];
+        std::vector<T> mSpill;
+    };
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_SMALL_VECTOR_HPP
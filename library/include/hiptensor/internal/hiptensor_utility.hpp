@@ -79,8 +79,8 @@ void hiptensorPrintArrayElements(std::ostream& stream, T* vec, size_t size)
     }
 }
 
-template <typename S>
-void hiptensorPrintVectorElements(const std::vector<S>& vec, std::string sep = " ")
+template <typename VecT>
+void hiptensorPrintVectorElements(const VecT& vec, std::string sep = " ")
 {
     for(auto& elem : vec)
     {
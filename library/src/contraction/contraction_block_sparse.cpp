@@ -0,0 +1,474 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+
+#include "contraction_block_sparse.hpp"
+#include "data_types.hpp"
+#include "util.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        using Key = std::vector<std::size_t>;
+
+        Key toKey(hiptensorDimVector_t const& v)
+        {
+            return Key(v.begin(), v.end());
+        }
+
+        // Position of a mode in an operand's modes, or -1
+        int modeIndex(std::vector<int32_t> const& modes, int32_t mode)
+        {
+            auto it = std::find(modes.begin(), modes.end(), mode);
+            return it == modes.end() ? -1 : int(it - modes.begin());
+        }
+
+        // D block = alpha * A block * B block + (first ? beta * C block : D block), on
+        // packed blocks whose modes are labelled by the plan
+        template <typename T>
+        void contractBlock(BlockSparsePlan const&  plan,
+                           BlockSparseGroup const& group,
+                           T                       alpha,
+                           T const*                A,
+                           T const*                B,
+                           T                       beta,
+                           T const*                C,
+                           T*                      D,
+                           bool                    first)
+        {
+            auto const& modesA = plan.mModes[0];
+            auto const& modesB = plan.mModes[1];
+            auto const& modesD = plan.mModes[2];
+            auto        strideA = stridesFromLengths(group.mLengths[0]);
+            auto        strideB = stridesFromLengths(group.mLengths[1]);
+            auto        strideD = stridesFromLengths(group.mLengths[2]);
+
+            // Free modes walk D, with A and B following where they have them; contracted
+            // modes are those of A that D does not have
+            struct Walk
+            {
+                std::size_t mExtent, mStrideA, mStrideB, mStrideD;
+            };
+            std::vector<Walk> free, contracted;
+            for(int i = 0; i < modesD.size(); i++)
+            {
+                auto a = modeIndex(modesA, modesD[i]);
+                auto b = modeIndex(modesB, modesD[i]);
+                free.push_back({group.mLengths[2][i],
+                                a >= 0 ? strideA[a] : 0,
+                                b >= 0 ? strideB[b] : 0,
+                                strideD[i]});
+            }
+            for(int i = 0; i < modesA.size(); i++)
+            {
+                if(modeIndex(modesD, modesA[i]) < 0)
+                {
+                    auto b = modeIndex(modesB, modesA[i]);
+                    contracted.push_back({group.mLengths[0][i], strideA[i], strideB[b], 0});
+                }
+            }
+
+            // Visits every index of the walked modes with the offsets it reaches
+            auto forEach = [](std::vector<Walk> const& walks, auto&& visit) {
+                std::vector<std::size_t> index(walks.size(), 0);
+                for(auto const& walk : walks)
+                {
+                    if(walk.mExtent == 0)
+                    {
+                        return;
+                    }
+                }
+                while(true)
+                {
+                    std::size_t a = 0, b = 0, d = 0;
+                    for(int i = 0; i < walks.size(); i++)
+                    {
+                        a += index[i] * walks[i].mStrideA;
+                        b += index[i] * walks[i].mStrideB;
+                        d += index[i] * walks[i].mStrideD;
+                    }
+                    visit(a, b, d);
+
+                    int i = int(walks.size()) - 1;
+                    for(; i >= 0; i--)
+                    {
+                        if(++index[i] < walks[i].mExtent)
+                        {
+                            break;
+                        }
+                        index[i] = 0;
+                    }
+                    if(i < 0)
+                    {
+                        return;
+                    }
+                }
+            };
+
+            forEach(free, [&](std::size_t a, std::size_t b, std::size_t d) {
+                T accum = 0;
+                forEach(contracted, [&](std::size_t ka, std::size_t kb, std::size_t) {
+                    accum += A[a + ka] * B[b + kb];
+                });
+                auto bias = first ? (C != nullptr ? beta * C[d] : T(0)) : D[d];
+                D[d]      = alpha * accum + bias;
+            });
+        }
+
+        template <typename T>
+        hiptensorStatus_t contractHost(BlockSparsePlan const& plan,
+                                       void const*            alpha,
+                                       void const*            A,
+                                       void const*            B,
+                                       void const*            beta,
+                                       void const*            C,
+                                       void*                  D,
+                                       uint32_t               threads)
+        {
+            auto const& descD   = plan.mDescs[2];
+            auto        alphaT  = *static_cast<T const*>(alpha);
+            auto        betaT   = beta != nullptr ? *static_cast<T const*>(beta) : T(0);
+            auto        offsetA = [&](std::size_t block) {
+                return static_cast<T const*>(A) + plan.mDescs[0].mOffsets[block];
+            };
+            auto offsetB = [&](std::size_t block) {
+                return static_cast<T const*>(B) + plan.mDescs[1].mOffsets[block];
+            };
+
+            // Pairs of each D block in plan order, so that every D block has one writer
+            std::vector<std::vector<std::pair<std::size_t, std::size_t>>> work(
+                descD.mBlocks.size());
+            for(std::size_t g = 0; g < plan.mGroups.size(); g++)
+            {
+                for(std::size_t t = 0; t < plan.mGroups[g].mTasks.size(); t++)
+                {
+                    work[plan.mGroups[g].mTasks[t].mBlockD].emplace_back(g, t);
+                }
+            }
+
+            std::atomic<std::size_t> next{0};
+            auto                     worker = [&]() {
+                for(auto block = next++; block < work.size(); block = next++)
+                {
+                    auto* blockD = static_cast<T*>(D) + descD.mOffsets[block];
+                    auto* blockC = plan.mHasC && C != nullptr
+                                       ? static_cast<T const*>(C) + descD.mOffsets[block]
+                                       : nullptr;
+                    if(work[block].empty())
+                    {
+                        // Blocks without products take beta * C
+                        auto elements = elementsFromLengths(blockLengths(descD, block));
+                        for(std::size_t e = 0; e < elements; e++)
+                        {
+                            blockD[e] = blockC != nullptr ? betaT * blockC[e] : T(0);
+                        }
+                        continue;
+                    }
+
+                    for(auto const& item : work[block])
+                    {
+                        auto const& group = plan.mGroups[item.first];
+                        auto const& task  = group.mTasks[item.second];
+                        contractBlock<T>(plan,
+                                         group,
+                                         alphaT,
+                                         offsetA(task.mBlockA),
+                                         offsetB(task.mBlockB),
+                                         betaT,
+                                         blockC,
+                                         blockD,
+                                         task.mFirst);
+                    }
+                }
+            };
+
+            if(threads == 0)
+            {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            threads = uint32_t(
+                std::min<std::size_t>(threads, std::max<std::size_t>(work.size(), 1)));
+
+            std::vector<std::thread> pool;
+            for(uint32_t i = 1; i < threads; i++)
+            {
+                pool.emplace_back(worker);
+            }
+            worker();
+            for(auto& thread : pool)
+            {
+                thread.join();
+            }
+            return HIPTENSOR_STATUS_SUCCESS;
+        }
+    }
+
+    std::size_t BlockSparsePlan::taskCount() const
+    {
+        std::size_t count = 0;
+        for(auto const& group : mGroups)
+        {
+            count += group.mTasks.size();
+        }
+        return count;
+    }
+
+    hiptensorDimVector_t blockLengths(hiptensorBlockSparseTensorDescriptor_t const& desc,
+                                      std::size_t                                   block)
+    {
+        auto const&          coords = desc.mBlocks[block];
+        hiptensorDimVector_t lengths(coords.size());
+        for(int i = 0; i < coords.size(); i++)
+        {
+            lengths[i] = desc.mBlockLengths[i][coords[i]];
+        }
+        return lengths;
+    }
+
+    hiptensorStatus_t validateBlockSparse(hiptensorBlockSparseTensorDescriptor_t const& desc)
+    {
+        if(desc.mOffsets.size() != desc.mBlocks.size())
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        std::map<Key, std::size_t> seen;
+        for(std::size_t block = 0; block < desc.mBlocks.size(); block++)
+        {
+            auto const& coords = desc.mBlocks[block];
+            if(coords.size() != desc.mBlockLengths.size())
+            {
+                return HIPTENSOR_STATUS_INVALID_VALUE;
+            }
+            for(int i = 0; i < coords.size(); i++)
+            {
+                if(coords[i] >= desc.mBlockLengths[i].size())
+                {
+                    return HIPTENSOR_STATUS_INVALID_VALUE;
+                }
+            }
+            if(!seen.emplace(toKey(coords), block).second)
+            {
+                return HIPTENSOR_STATUS_INVALID_VALUE;
+            }
+        }
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t planBlockSparse(BlockSparsePlan*                              plan,
+                                      hiptensorBlockSparseTensorDescriptor_t const& descA,
+                                      int32_t const                                 modeA[],
+                                      hiptensorBlockSparseTensorDescriptor_t const& descB,
+                                      int32_t const                                 modeB[],
+                                      hiptensorBlockSparseTensorDescriptor_t const& descD,
+                                      int32_t const                                 modeD[],
+                                      hiptensorComputeType_t                        typeCompute,
+                                      bool                                          hasC)
+    {
+        if(plan == nullptr)
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        plan->mDescs       = {descA, descB, descD};
+        plan->mComputeType = typeCompute;
+        plan->mHasC        = hasC;
+        plan->mGroups.clear();
+        plan->mUntouched.clear();
+        plan->mDensePlans.clear();
+
+        std::array<int32_t const*, 3> modes = {modeA, modeB, modeD};
+        for(int i = 0; i < 3; i++)
+        {
+            auto rank = plan->mDescs[i].mBlockLengths.size();
+            if(validateBlockSparse(plan->mDescs[i]) != HIPTENSOR_STATUS_SUCCESS
+               || (rank > 0 && modes[i] == nullptr))
+            {
+                return HIPTENSOR_STATUS_INVALID_VALUE;
+            }
+            plan->mModes[i].assign(modes[i], modes[i] + rank);
+        }
+
+        // Every mode appears in exactly two operands, split into the same blocks in both
+        for(int i = 0; i < 3; i++)
+        {
+            for(int m = 0; m < plan->mModes[i].size(); m++)
+            {
+                auto mode  = plan->mModes[i][m];
+                auto count = 0;
+                for(int j = 0; j < 3; j++)
+                {
+                    auto at = modeIndex(plan->mModes[j], mode);
+                    if(at < 0)
+                    {
+                        continue;
+                    }
+                    count++;
+                    if(toKey(plan->mDescs[j].mBlockLengths[at])
+                       != toKey(plan->mDescs[i].mBlockLengths[m]))
+                    {
+                        return HIPTENSOR_STATUS_INVALID_VALUE;
+                    }
+                }
+                if(count != 2)
+                {
+                    return HIPTENSOR_STATUS_INVALID_VALUE;
+                }
+            }
+        }
+
+        // Block coordinates of the contracted modes, and where D's modes come from
+        std::vector<int> contractedA, contractedB;
+        for(int m = 0; m < plan->mModes[0].size(); m++)
+        {
+            auto b = modeIndex(plan->mModes[1], plan->mModes[0][m]);
+            if(b >= 0)
+            {
+                contractedA.push_back(m);
+                contractedB.push_back(b);
+            }
+        }
+
+        std::map<Key, std::vector<std::size_t>> blocksB;
+        for(std::size_t block = 0; block < descB.mBlocks.size(); block++)
+        {
+            Key key;
+            for(auto m : contractedB)
+            {
+                key.push_back(descB.mBlocks[block][m]);
+            }
+            blocksB[key].push_back(block);
+        }
+
+        std::map<Key, std::size_t> blocksD;
+        for(std::size_t block = 0; block < descD.mBlocks.size(); block++)
+        {
+            blocksD.emplace(toKey(descD.mBlocks[block]), block);
+        }
+
+        std::map<std::array<Key, 2>, std::size_t> groups;
+        for(std::size_t blockA = 0; blockA < descA.mBlocks.size(); blockA++)
+        {
+            Key key;
+            for(auto m : contractedA)
+            {
+                key.push_back(descA.mBlocks[blockA][m]);
+            }
+
+            auto match = blocksB.find(key);
+            if(match == blocksB.end())
+            {
+                continue;
+            }
+
+            for(auto blockB : match->second)
+            {
+                Key coordsD;
+                for(auto mode : plan->mModes[2])
+                {
+                    auto a = modeIndex(plan->mModes[0], mode);
+                    coordsD.push_back(a >= 0 ? descA.mBlocks[blockA][a]
+                                             : descB.mBlocks[blockB][modeIndex(plan->mModes[1],
+                                                                                mode)]);
+                }
+
+                // Products into blocks that D does not store would be lost
+                auto target = blocksD.find(coordsD);
+                if(target == blocksD.end())
+                {
+                    return HIPTENSOR_STATUS_INVALID_VALUE;
+                }
+
+                auto lengthsA = blockLengths(descA, blockA);
+                auto lengthsB = blockLengths(descB, blockB);
+                auto shape    = std::array<Key, 2>{toKey(lengthsA), toKey(lengthsB)};
+                auto group    = groups.find(shape);
+                if(group == groups.end())
+                {
+                    group = groups.emplace(shape, plan->mGroups.size()).first;
+                    plan->mGroups.push_back(
+                        {{lengthsA, lengthsB, blockLengths(descD, target->second)}, {}});
+                }
+
+                plan->mGroups[group->second].mTasks.push_back(
+                    {blockA, blockB, target->second, false});
+            }
+        }
+
+        // Groups run one after another, so the first product into a D block is the
+        // first one in group order rather than in pairing order
+        std::vector<bool> touched(descD.mBlocks.size(), false);
+        for(auto& group : plan->mGroups)
+        {
+            for(auto& task : group.mTasks)
+            {
+                task.mFirst           = !touched[task.mBlockD];
+                touched[task.mBlockD] = true;
+            }
+        }
+
+        for(std::size_t block = 0; block < touched.size(); block++)
+        {
+            if(!touched[block])
+            {
+                plan->mUntouched.push_back(block);
+            }
+        }
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t blockSparseContractionHost(BlockSparsePlan const& plan,
+                                                 void const*            alpha,
+                                                 void const*            A,
+                                                 void const*            B,
+                                                 void const*            beta,
+                                                 void const*            C,
+                                                 void*                  D,
+                                                 uint32_t               threads)
+    {
+        auto type = plan.mDescs[2].mType;
+        if(plan.mDescs[0].mType != type || plan.mDescs[1].mType != type)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        if(type == HIP_R_32F)
+        {
+            return contractHost<float>(plan, alpha, A, B, beta, C, D, threads);
+        }
+        else if(type == HIP_R_64F)
+        {
+            return contractHost<double>(plan, alpha, A, B, beta, C, D, threads);
+        }
+        return HIPTENSOR_STATUS_NOT_SUPPORTED;
+    }
+
+} // namespace hiptensor
@@ -0,0 +1,357 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "contraction_chain.hpp"
+#include "contraction_streaming.hpp"
+#include "data_types.hpp"
+#include "util.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        int findMode(int32_t const* modes, std::size_t rank, int32_t mode)
+        {
+            auto it = std::find(modes, modes + rank, mode);
+            return it != modes + rank ? int(it - modes) : -1;
+        }
+
+        // Copies a strided tensor block into packed row-major memory, or back
+        void gather(void*                       dst,
+                    void const*                 src,
+                    hiptensorDimVector_t const& lengths,
+                    hiptensorDimVector_t const& strides,
+                    std::size_t                 elementBytes)
+        {
+            forEachCopyRun(lengths,
+                           strides,
+                           stridesFromLengths(lengths),
+                           [&](std::size_t srcOffset, std::size_t dstOffset, std::size_t count) {
+                               std::memcpy((char*)dst + dstOffset * elementBytes,
+                                           (char const*)src + srcOffset * elementBytes,
+                                           count * elementBytes);
+                           });
+        }
+
+        void scatter(void*                       dst,
+                     void const*                 src,
+                     hiptensorDimVector_t const& lengths,
+                     hiptensorDimVector_t const& strides,
+                     std::size_t                 elementBytes)
+        {
+            forEachCopyRun(lengths,
+                           stridesFromLengths(lengths),
+                           strides,
+                           [&](std::size_t srcOffset, std::size_t dstOffset, std::size_t count) {
+                               std::memcpy((char*)dst + dstOffset * elementBytes,
+                                           (char const*)src + srcOffset * elementBytes,
+                                           count * elementBytes);
+                           });
+        }
+
+        // D = alpha * (A * B) * C on packed row-major A = [M, K], B = [N, K], C = [O, N]
+        // and D = [M, O], through the intermediate X = [M, N]
+        template <typename T>
+        void contractChainBlock(void const* alpha,
+                                T const*    A,
+                                T const*    B,
+                                T const*    C,
+                                T*          X,
+                                T*          D,
+                                std::size_t m,
+                                std::size_t n,
+                                std::size_t k,
+                                std::size_t o)
+        {
+            auto alphaT = alpha != nullptr ? *static_cast<T const*>(alpha) : T{0};
+            for(std::size_t i = 0; i < m; i++)
+            {
+                for(std::size_t j = 0; j < n; j++)
+                {
+                    T accum = 0;
+                    for(std::size_t l = 0; l < k; l++)
+                    {
+                        accum += A[i * k + l] * B[j * k + l];
+                    }
+                    X[i * n + j] = accum;
+                }
+            }
+
+            for(std::size_t i = 0; i < m; i++)
+            {
+                for(std::size_t p = 0; p < o; p++)
+                {
+                    T accum = 0;
+                    for(std::size_t j = 0; j < n; j++)
+                    {
+                        accum += X[i * n + j] * C[p * n + j];
+                    }
+                    D[i * o + p] = alphaT * accum;
+                }
+            }
+        }
+    }
+
+    std::array<std::size_t, 2> ContractionChain::blockOffsets(std::size_t block) const
+    {
+        if(mRankM == 0)
+        {
+            return {0, 0};
+        }
+        return {block * mBlockM * mTensors[0].mStrides[0],
+                block * mBlockM * mTensors[3].mStrides[0]};
+    }
+
+    bool ContractionChain::raggedLast() const
+    {
+        return mBlocks > 1 && mLastBlockM != mBlockM;
+    }
+
+    std::array<hiptensorTensorDescriptor_t, 2> ContractionChain::blockTensors(bool last) const
+    {
+        std::array<hiptensorTensorDescriptor_t, 2> tensors = {mTensors[0], mTensors[3]};
+        for(auto& tensor : tensors)
+        {
+            tensor.mSignature = nullptr;
+            if(mRankM > 0)
+            {
+                tensor.mLengths[0] = last ? mLastBlockM : mBlockM;
+            }
+        }
+        return tensors;
+    }
+
+    hiptensorTensorDescriptor_t ContractionChain::blockIntermediate(bool last) const
+    {
+        auto intermediate = mBlock;
+        if(last && mRankM > 0)
+        {
+            intermediate.mLengths[0] = mLastBlockM;
+            intermediate.mStrides    = stridesFromLengths(intermediate.mLengths);
+        }
+        return intermediate;
+    }
+
+    hiptensorStatus_t analyzeChain(ContractionChain*                                 chain,
+                                   std::array<hiptensorTensorDescriptor_t, 4> const& tensors,
+                                   std::array<int32_t const*, 4> const&              modes,
+                                   std::size_t                                       blockBytes)
+    {
+        if(chain == nullptr || std::find(modes.begin(), modes.end(), nullptr) != modes.end())
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        auto type = tensors[0].mType;
+        for(auto const& tensor : tensors)
+        {
+            if(tensor.mType != type || tensor.mLengths.size() != tensor.mStrides.size())
+            {
+                return HIPTENSOR_STATUS_INVALID_VALUE;
+            }
+        }
+
+        auto const& a     = tensors[0];
+        auto const& b     = tensors[1];
+        auto        rankA = a.mLengths.size();
+        auto        rankB = b.mLengths.size();
+        auto        rankC = tensors[2].mLengths.size();
+        auto        rankD = tensors[3].mLengths.size();
+
+        // A = [M, K]: the modes of A that B shares are K and must trail
+        std::size_t rankM = 0;
+        while(rankM < rankA && findMode(modes[1], rankB, modes[0][rankM]) < 0)
+        {
+            rankM++;
+        }
+        auto rankK = rankA - rankM;
+        auto rankN = rankB - std::min(rankK, rankB);
+        auto rankO = rankC - std::min(rankN, rankC);
+        if(rankN == 0 || rankC < rankN || rankD != rankM + rankO)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        // Every mode must appear where the ordering expects it, with matching lengths
+        auto same = [&](int i, std::size_t modeI, int j, std::size_t modeJ) {
+            return modes[i][modeI] == modes[j][modeJ]
+                   && tensors[i].mLengths[modeI] == tensors[j].mLengths[modeJ];
+        };
+        auto valid = true;
+        for(std::size_t i = 0; i < rankK; i++)
+        {
+            valid &= same(0, rankM + i, 1, rankN + i);
+        }
+        for(std::size_t i = 0; i < rankN; i++)
+        {
+            valid &= same(1, i, 2, rankO + i) && findMode(modes[0], rankA, modes[1][i]) < 0;
+        }
+        for(std::size_t i = 0; i < rankM; i++)
+        {
+            valid &= same(0, i, 3, i);
+        }
+        for(std::size_t i = 0; i < rankO; i++)
+        {
+            valid &= same(2, i, 3, rankM + i) && findMode(modes[1], rankB, modes[2][i]) < 0;
+        }
+        if(!valid)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        chain->mTensors = tensors;
+        chain->mRankM   = rankM;
+        chain->mRankN   = rankN;
+        chain->mRankK   = rankK;
+        chain->mRankO   = rankO;
+        chain->mOuterM  = rankM > 0 ? a.mLengths[0] : 1;
+
+        // X = [M, N], taken from the modes of A and B
+        hiptensorDimVector_t lengthsX(a.mLengths.begin(), a.mLengths.begin() + rankM);
+        for(std::size_t i = 0; i < rankN; i++)
+        {
+            lengthsX.push_back(b.mLengths[i]);
+        }
+
+        // The fewest blocks that fit the budget, balanced so that only the last block
+        // may be shorter, and by less than one row per block
+        auto elementBytes = std::max<std::size_t>(hipDataTypeSize(type), 1u);
+        auto rows         = std::max(chain->mOuterM, std::size_t{1});
+        auto rowBytes     = std::max(elementsFromLengths(lengthsX) / rows * elementBytes,
+                                 std::size_t{1});
+        auto fit          = std::min(std::max(blockBytes / rowBytes, std::size_t{1}), rows);
+        chain->mBlocks     = ceilDiv(chain->mOuterM, fit);
+        chain->mBlockM     = chain->mBlocks > 0 ? ceilDiv(chain->mOuterM, chain->mBlocks) : 1;
+        chain->mLastBlockM = chain->mBlocks > 0
+                                 ? chain->mOuterM - (chain->mBlocks - 1) * chain->mBlockM
+                                 : 0;
+
+        if(rankM > 0)
+        {
+            lengthsX[0] = chain->mBlockM;
+        }
+        chain->mBlock = {type, lengthsX, stridesFromLengths(lengthsX), nullptr};
+
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t contractChainHost(ContractionChain const& chain,
+                                        void const*             alpha,
+                                        void const*             A,
+                                        void const*             B,
+                                        void const*             C,
+                                        void*                   D)
+    {
+        if(A == nullptr || B == nullptr || C == nullptr || D == nullptr)
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        auto type = chain.mBlock.mType;
+        if(type != HIP_R_32F && type != HIP_R_64F)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        auto const& b            = chain.mTensors[1];
+        auto const& c            = chain.mTensors[2];
+        auto        elementBytes = hipDataTypeSize(type);
+
+        std::size_t n = 1, k = 1, o = 1;
+        for(std::size_t i = 0; i < b.mLengths.size(); i++)
+        {
+            (i < chain.mRankN ? n : k) *= b.mLengths[i];
+        }
+        for(std::size_t i = 0; i < chain.mRankO; i++)
+        {
+            o *= c.mLengths[i];
+        }
+
+        // B and C are read by every block, so they are packed once
+        std::vector<char> packedB(elementsFromLengths(b.mLengths) * elementBytes);
+        std::vector<char> packedC(elementsFromLengths(c.mLengths) * elementBytes);
+        gather(packedB.data(), B, b.mLengths, b.mStrides, elementBytes);
+        gather(packedC.data(), C, c.mLengths, c.mStrides, elementBytes);
+
+        // Sized by the full blocks; the last block may use a prefix of them
+        auto              full = chain.blockTensors();
+        std::vector<char> blockA(elementsFromLengths(full[0].mLengths) * elementBytes);
+        std::vector<char> blockX(elementsFromLengths(chain.mBlock.mLengths) * elementBytes);
+        std::vector<char> blockD(elementsFromLengths(full[1].mLengths) * elementBytes);
+        for(std::size_t block = 0; block < chain.mBlocks; block++)
+        {
+            auto last    = block + 1 == chain.mBlocks;
+            auto blocks  = chain.blockTensors(last);
+            auto m       = n > 0 ? elementsFromLengths(chain.blockIntermediate(last).mLengths) / n
+                                 : 0;
+            auto offsets = chain.blockOffsets(block);
+            gather(blockA.data(),
+                   (char const*)A + offsets[0] * elementBytes,
+                   blocks[0].mLengths,
+                   blocks[0].mStrides,
+                   elementBytes);
+
+            if(type == HIP_R_32F)
+            {
+                contractChainBlock<float>(alpha,
+                                          (float const*)blockA.data(),
+                                          (float const*)packedB.data(),
+                                          (float const*)packedC.data(),
+                                          (float*)blockX.data(),
+                                          (float*)blockD.data(),
+                                          m,
+                                          n,
+                                          k,
+                                          o);
+            }
+            else
+            {
+                contractChainBlock<double>(alpha,
+                                           (double const*)blockA.data(),
+                                           (double const*)packedB.data(),
+                                           (double const*)packedC.data(),
+                                           (double*)blockX.data(),
+                                           (double*)blockD.data(),
+                                           m,
+                                           n,
+                                           k,
+                                           o);
+            }
+
+            scatter((char*)D + offsets[1] * elementBytes,
+                    blockD.data(),
+                    blocks[1].mLengths,
+                    blocks[1].mStrides,
+                    elementBytes);
+        }
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+} // namespace hiptensor
@@ -28,25 +28,25 @@
 #include "contraction_cpu_reference_impl.hpp"
 #include "contraction_cpu_reference_instances.hpp"
 
-hiptensorStatus_t hiptensorContractionReference(void const*                alpha,
-                                                void const*                A,
-                                                void const*                B,
-                                                void const*                beta,
-                                                void const*                C,
-                                                void*                      D,
-                                                std::vector<size_t> const& a_ms_ks_lengths,
-                                                std::vector<size_t> const& a_ms_ks_strides,
-                                                std::vector<size_t> const& b_ns_ks_lengths,
-                                                std::vector<size_t> const& b_ns_ks_strides,
-                                                std::vector<size_t> const& c_ms_ns_lengths,
-                                                std::vector<size_t> const& c_ms_ns_strides,
-                                                std::vector<size_t> const& d_ms_ns_lengths,
-                                                std::vector<size_t> const& d_ms_ns_strides,
-                                                hipDataType                typeA,
-                                                hipDataType                typeB,
-                                                hipDataType                typeC,
-                                                hipDataType                typeD,
-                                                void*                      workspace)
+hiptensorStatus_t hiptensorContractionReference(void const*                 alpha,
+                                                void const*                 A,
+                                                void const*                 B,
+                                                void const*                 beta,
+                                                void const*                 C,
+                                                void*                       D,
+                                                hiptensorDimVector_t const& a_ms_ks_lengths,
+                                                hiptensorDimVector_t const& a_ms_ks_strides,
+                                                hiptensorDimVector_t const& b_ns_ks_lengths,
+                                                hiptensorDimVector_t const& b_ns_ks_strides,
+                                                hiptensorDimVector_t const& c_ms_ns_lengths,
+                                                hiptensorDimVector_t const& c_ms_ns_strides,
+                                                hiptensorDimVector_t const& d_ms_ns_lengths,
+                                                hiptensorDimVector_t const& d_ms_ns_strides,
+                                                hipDataType                 typeA,
+                                                hipDataType                 typeB,
+                                                hipDataType                 typeC,
+                                                hipDataType                 typeD,
+                                                void*                       workspace)
 {
     auto& instances = hiptensor::ContractionCpuReferenceInstances::instance();
     auto  candidates
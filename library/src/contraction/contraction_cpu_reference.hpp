@@ -32,24 +32,24 @@
 
 #include <hiptensor/hiptensor.hpp>
 
-hiptensorStatus_t hiptensorContractionReference(void const*                alpha,
-                                                void const*                A,
-                                                void const*                B,
-                                                void const*                beta,
-                                                void const*                C,
-                                                void*                      D,
-                                                std::vector<size_t> const& a_ms_ks_lengths,
-                                                std::vector<size_t> const& a_ms_ks_strides,
-                                                std::vector<size_t> const& b_ks_ns_lengths,
-                                                std::vector<size_t> const& b_ks_ns_strides,
-                                                std::vector<size_t> const& c_ms_ns_lengths,
-                                                std::vector<size_t> const& c_ms_ns_strides,
-                                                std::vector<size_t> const& d_ms_ns_lengths,
-                                                std::vector<size_t> const& d_ms_ns_strides,
-                                                hipDataType                typeA,
-                                                hipDataType                typeB,
-                                                hipDataType                typeC,
-                                                hipDataType                typeD,
-                                                void*                      workspace);
+hiptensorStatus_t hiptensorContractionReference(void const*                 alpha,
+                                                void const*                 A,
+                                                void const*                 B,
+                                                void const*                 beta,
+                                                void const*                 C,
+                                                void*                       D,
+                                                hiptensorDimVector_t const& a_ms_ks_lengths,
+                                                hiptensorDimVector_t const& a_ms_ks_strides,
+                                                hiptensorDimVector_t const& b_ks_ns_lengths,
+                                                hiptensorDimVector_t const& b_ks_ns_strides,
+                                                hiptensorDimVector_t const& c_ms_ns_lengths,
+                                                hiptensorDimVector_t const& c_ms_ns_strides,
+                                                hiptensorDimVector_t const& d_ms_ns_lengths,
+                                                hiptensorDimVector_t const& d_ms_ns_strides,
+                                                hipDataType                 typeA,
+                                                hipDataType                 typeB,
+                                                hipDataType                 typeC,
+                                                hipDataType                 typeD,
+                                                void*                       workspace);
 
 #endif // HIPTENSOR_CONTRACTION_CPU_REFERENCE_HPP
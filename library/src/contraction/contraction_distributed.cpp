@@ -0,0 +1,388 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <numeric>
+
+#include "contraction_distributed.hpp"
+#include "data_types.hpp"
+#include "descriptor_cache.hpp"
+#include "util.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        // Received panels are placed at the alignment of device allocations
+        constexpr std::size_t PanelAlignment = 256u;
+
+        std::size_t alignPanel(std::size_t bytes)
+        {
+            return ceilDiv(bytes, PanelAlignment) * PanelAlignment;
+        }
+
+        // Boundaries of `parts` blocks of nearly equal extent over [0, extent)
+        std::vector<std::size_t> evenSplit(std::size_t extent, uint32_t parts)
+        {
+            std::vector<std::size_t> bounds(parts + 1);
+            for(uint32_t i = 0; i <= parts; i++)
+            {
+                bounds[i] = extent * i / parts;
+            }
+            return bounds;
+        }
+
+        // Tags of the A and B blocks of a panel
+        uint32_t panelTag(uint32_t panel, int i)
+        {
+            return panel * 2u + uint32_t(i);
+        }
+    }
+
+    uint32_t DistributedPlan::ownerA(uint32_t row, uint32_t panel) const
+    {
+        return row * mGrid.mCols + panel % mGrid.mCols;
+    }
+
+    uint32_t DistributedPlan::ownerB(uint32_t panel, uint32_t col) const
+    {
+        return (panel % mGrid.mRows) * mGrid.mCols + col;
+    }
+
+    StreamingTile DistributedPlan::block(uint32_t row, uint32_t col, uint32_t panel) const
+    {
+        return {mSplitM[row],
+                mSplitM[row + 1] - mSplitM[row],
+                mSplitN[col],
+                mSplitN[col + 1] - mSplitN[col],
+                mSplitK[panel],
+                mSplitK[panel + 1] - mSplitK[panel]};
+    }
+
+    std::vector<StreamingTile> DistributedPlan::localBlocks(uint32_t rank, int i) const
+    {
+        auto row = rank / mGrid.mCols;
+        auto col = rank % mGrid.mCols;
+        if(i >= 2)
+        {
+            return {block(row, col, 0)};
+        }
+
+        std::vector<StreamingTile> blocks;
+        for(uint32_t panel = 0; panel < mPanels; panel++)
+        {
+            auto owner = i == 0 ? ownerA(row, panel) : ownerB(panel, col);
+            if(owner == rank)
+            {
+                blocks.push_back(block(row, col, panel));
+            }
+        }
+        return blocks;
+    }
+
+    std::size_t DistributedPlan::blockElements(StreamingTile const& block, int i) const
+    {
+        if(mGeometry.mTypes[i] == NONE_TYPE)
+        {
+            return 0;
+        }
+        return elementsFromLengths(mGeometry.tileLengths(block)[i]);
+    }
+
+    std::array<std::size_t, 2> DistributedPlan::panelBytes() const
+    {
+        std::array<std::size_t, 2> bytes = {0, 0};
+        for(uint32_t panel = 0; panel < mPanels; panel++)
+        {
+            for(uint32_t row = 0; row < mGrid.mRows; row++)
+            {
+                bytes[0] = std::max(bytes[0], blockElements(block(row, 0, panel), 0));
+            }
+            for(uint32_t col = 0; col < mGrid.mCols; col++)
+            {
+                bytes[1] = std::max(bytes[1], blockElements(block(0, col, panel), 1));
+            }
+        }
+        for(int i = 0; i < bytes.size(); i++)
+        {
+            bytes[i] *= hipDataTypeSize(mGeometry.mTypes[i]);
+        }
+        return bytes;
+    }
+
+    hiptensorStatus_t planDistributed(DistributedPlan*            plan,
+                                      ContractionSignature const& signature,
+                                      uint32_t                    ranks)
+    {
+        if(plan == nullptr || ranks == 0)
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+        if(signature.mOutputs > 1)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        auto& geometry = plan->mGeometry;
+        for(int i = 0; i < signature.mTensors.size(); i++)
+        {
+            geometry.mTypes[i]   = signature.mTensors[i]->mType;
+            geometry.mLengths[i] = signature.mTensors[i]->mLengths;
+            geometry.mStrides[i] = stridesFromLengths(signature.mTensors[i]->mLengths);
+        }
+
+        auto const& lengthsA = geometry.mLengths[0];
+        geometry.mRankM      = signature.mRankM;
+        geometry.mRankN      = signature.mRankN;
+        geometry.mRankK      = lengthsA.size() - std::min(signature.mRankM, lengthsA.size());
+        geometry.mOuterM     = signature.mOuterM;
+        geometry.mOuterN     = signature.mOuterN;
+        geometry.mOuterK     = geometry.mRankK > 0 ? lengthsA[geometry.mRankM] : 1;
+        geometry.mOutputs    = 1;
+        geometry.mOutputN    = signature.mOuterN;
+
+        // Most square grid, its longer side along the longer of M and N
+        uint32_t rows = 1;
+        for(uint32_t d = 1; d * d <= ranks; d++)
+        {
+            if(ranks % d == 0)
+            {
+                rows = d;
+            }
+        }
+        auto cols = ranks / rows;
+        if(geometry.mOuterM > geometry.mOuterN)
+        {
+            std::swap(rows, cols);
+        }
+        plan->mGrid = {rows, cols};
+
+        // Every rank owns panels when there are enough of them. Partial products are
+        // accumulated through C, so contractions without one take K whole.
+        auto hasC     = geometry.mTypes[2] != NONE_TYPE;
+        auto panels   = std::lcm(rows, cols);
+        plan->mPanels = hasC ? uint32_t(std::max<std::size_t>(
+                            1u, std::min<std::size_t>(panels, geometry.mOuterK)))
+                             : 1u;
+
+        plan->mSplitM = evenSplit(geometry.mOuterM, rows);
+        plan->mSplitN = evenSplit(geometry.mOuterN, cols);
+        plan->mSplitK = evenSplit(geometry.mOuterK, plan->mPanels);
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t distributedContraction(DistributedPlan const& plan,
+                                             Transport&             transport,
+                                             StreamingBackend&      backend,
+                                             void const*            alpha,
+                                             void const*            A,
+                                             void const*            B,
+                                             void const*            beta,
+                                             void const*            C,
+                                             void*                  D,
+                                             std::size_t            workspaceBytes)
+    {
+        auto const& grid = plan.mGrid;
+        if(transport.size() != grid.mRows * grid.mCols || transport.rank() >= transport.size())
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        auto rank = transport.rank();
+        auto row  = rank / grid.mCols;
+        auto col  = rank % grid.mCols;
+
+        // Ranks with an empty D block neither receive nor contract
+        auto active = [&](uint32_t r, uint32_t c) {
+            auto block = plan.block(r, c, 0);
+            return block.mExtentM > 0 && block.mExtentN > 0;
+        };
+
+        std::array<std::size_t, 4> elementBytes;
+        for(int i = 0; i < elementBytes.size(); i++)
+        {
+            elementBytes[i] = hipDataTypeSize(plan.mGeometry.mTypes[i]);
+        }
+
+        // Where each panel's local A and B blocks start in the local buffers
+        std::array<std::vector<std::size_t>, 2> localOffsets;
+        for(int i = 0; i < 2; i++)
+        {
+            localOffsets[i].assign(plan.mPanels, 0);
+            std::size_t offset = 0;
+            for(uint32_t panel = 0; panel < plan.mPanels; panel++)
+            {
+                auto owner = i == 0 ? plan.ownerA(row, panel) : plan.ownerB(panel, col);
+                if(owner == rank)
+                {
+                    localOffsets[i][panel] = offset;
+                    offset += plan.blockElements(plan.block(row, col, panel), i);
+                }
+            }
+        }
+
+        // Two panels are in flight: one being contracted and the next being received
+        auto  panelBytes = plan.panelBytes();
+        auto  slotBytes  = alignPanel(panelBytes[0]) + alignPanel(panelBytes[1]);
+        void* buffers    = nullptr;
+        auto  status     = backend.allocate(&buffers, 2 * slotBytes + workspaceBytes);
+        if(status != HIPTENSOR_STATUS_SUCCESS)
+        {
+            return status;
+        }
+        auto* workspace = workspaceBytes > 0 ? (char*)buffers + 2 * slotBytes : nullptr;
+
+        std::array<std::vector<Transport::Request>, 2> requests;
+        std::array<std::array<void const*, 2>, 2>      inputs;
+
+        // Starts the sends of the panel's blocks owned here and the receives of the
+        // blocks needed here into the panel's slot
+        auto post = [&](uint32_t panel) {
+            auto  slot    = panel % 2u;
+            auto* base    = (char*)buffers + slot * slotBytes;
+            auto  receive = std::array<void*, 2>{base, base + alignPanel(panelBytes[0])};
+            auto  local   = std::array<void const*, 2>{A, B};
+            auto  owners  = std::array<uint32_t, 2>{plan.ownerA(row, panel),
+                                                   plan.ownerB(panel, col)};
+
+            for(int i = 0; i < 2; i++)
+            {
+                auto bytes = plan.blockElements(plan.block(row, col, panel), i) * elementBytes[i];
+                auto tag   = panelTag(panel, i);
+                if(owners[i] == rank)
+                {
+                    inputs[slot][i]
+                        = (char const*)local[i] + localOffsets[i][panel] * elementBytes[i];
+
+                    // A is shared along the grid row and B along the grid column
+                    auto peers = i == 0 ? grid.mCols : grid.mRows;
+                    for(uint32_t p = 0; p < peers && bytes > 0; p++)
+                    {
+                        auto peerRow = i == 0 ? row : p;
+                        auto peerCol = i == 0 ? p : col;
+                        auto peer    = peerRow * grid.mCols + peerCol;
+                        if(peer == rank || !active(peerRow, peerCol))
+                        {
+                            continue;
+                        }
+
+                        Transport::Request request = nullptr;
+                        auto               result
+                            = transport.send(peer, tag, inputs[slot][i], bytes, &request);
+                        if(result != HIPTENSOR_STATUS_SUCCESS)
+                        {
+                            return result;
+                        }
+                        requests[slot].push_back(request);
+                    }
+                }
+                else if(active(row, col) && bytes > 0)
+                {
+                    Transport::Request request = nullptr;
+                    auto result = transport.receive(owners[i], tag, receive[i], bytes, &request);
+                    if(result != HIPTENSOR_STATUS_SUCCESS)
+                    {
+                        return result;
+                    }
+                    requests[slot].push_back(request);
+                    inputs[slot][i] = receive[i];
+                }
+            }
+            return HIPTENSOR_STATUS_SUCCESS;
+        };
+
+        auto drain = [&](uint32_t slot) {
+            auto result = HIPTENSOR_STATUS_SUCCESS;
+            for(auto request : requests[slot])
+            {
+                auto waited = transport.wait(request);
+                if(result == HIPTENSOR_STATUS_SUCCESS)
+                {
+                    result = waited;
+                }
+            }
+            requests[slot].clear();
+            return result;
+        };
+
+        // Later panels add onto the partial result held in D
+        auto        oneF32 = 1.0f;
+        auto        oneF64 = 1.0;
+        void const* one = plan.mGeometry.mTypes[3] == HIP_R_64F ? (void const*)&oneF64 : &oneF32;
+        auto        hasC = plan.mGeometry.mTypes[2] != NONE_TYPE && C != nullptr;
+
+        status = post(0);
+        for(uint32_t panel = 0; panel < plan.mPanels && status == HIPTENSOR_STATUS_SUCCESS;
+            panel++)
+        {
+            // The next panel's slot was last read by the contraction before this one
+            if(panel + 1 < plan.mPanels)
+            {
+                status = backend.synchronize();
+                if(status == HIPTENSOR_STATUS_SUCCESS)
+                {
+                    status = post(panel + 1);
+                }
+            }
+
+            auto waited = drain(panel % 2u);
+            if(status == HIPTENSOR_STATUS_SUCCESS)
+            {
+                status = waited;
+            }
+
+            auto block = plan.block(row, col, panel);
+            if(status == HIPTENSOR_STATUS_SUCCESS && active(row, col) && block.mExtentK > 0)
+            {
+                auto first = panel == 0;
+                status     = backend.contract(alpha,
+                                          inputs[panel % 2u][0],
+                                          inputs[panel % 2u][1],
+                                          first ? beta : one,
+                                          first ? (hasC ? C : nullptr) : D,
+                                          D,
+                                          plan.mGeometry.tileLengths(block),
+                                          workspace,
+                                          0);
+            }
+        }
+
+        // Transfers still in flight after a failure are completed before their buffers go
+        for(uint32_t slot = 0; slot < 2u; slot++)
+        {
+            drain(slot);
+        }
+
+        auto synchronized = backend.synchronize();
+        if(status == HIPTENSOR_STATUS_SUCCESS)
+        {
+            status = synchronized;
+        }
+        backend.release(buffers);
+        return status;
+    }
+
+} // namespace hiptensor
@@ -0,0 +1,673 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include "contraction_launch.hpp"
+#include "contraction_selection.hpp"
+#include "contraction_solution_instances.hpp"
+#include "contraction_staging.hpp"
+#include "degenerate_contraction.hpp"
+#include "logger.hpp"
+#include "performance.hpp"
+#include "scalar_epilogue.hpp"
+#include "util.hpp"
+
+// Runs the plan's kernel on the operands of every output of a contraction. B, C and D
+// hold one pointer per output; C may be nullptr for scale contractions.
+hiptensorStatus_t runContraction(char const*                             api,
+                                 hiptensor::ContractionSignature const* signature,
+                                 hiptensor::ContractionSolution*        cSolution,
+                                 const void*                            alpha,
+                                 const void*                            A,
+                                 const void* const                      B[],
+                                 const void*                            beta,
+                                 const void* const                      C[],
+                                 void* const                            D[],
+                                 void*                                  workspace,
+                                 uint64_t                               workspaceSize,
+                                 hipStream_t                            stream,
+                                 bool                                   timing)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    char msg[512];
+
+    if(signature->mComputeType != signature->mTensors[3]->mType)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Internal Error : compute type != D type (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError(api, msg);
+        return errorCode;
+    }
+
+    // Operand i of output g
+    auto pointer = [&](int i, uint32_t g) -> void const* {
+        switch(i)
+        {
+        case 0:
+            return A;
+        case 1:
+            return B[g];
+        case 2:
+            return C != nullptr ? C[g] : nullptr;
+        default:
+            return D[g];
+        }
+    };
+
+    // Contractions without M, N or K modes run on bandwidth-bound kernels that read the
+    // strided operands in place, so they are neither staged nor partitioned
+    auto shape = signature->mSqueezed.mShape;
+    if(shape != hiptensor::ContractionShape::GENERAL)
+    {
+        auto status = hiptensor::degenerateContraction(signature->mSqueezed,
+                                                       alpha,
+                                                       A,
+                                                       B[0],
+                                                       beta,
+                                                       pointer(2, 0),
+                                                       D[0],
+                                                       workspace,
+                                                       workspaceSize,
+                                                       stream);
+        if(status != HIPTENSOR_STATUS_SUCCESS)
+        {
+            snprintf(msg,
+                     sizeof(msg),
+                     "Unable to run the %s kernel (%s)",
+                     hiptensor::contractionShapeName(shape),
+                     hiptensorGetErrorString(status));
+            logger->logError(api, msg);
+        }
+        return status;
+    }
+
+    // Outputs whose operands already lie side by side in the concatenated view, such as a B
+    // packed once and reused across calls, are read and written in place instead of staged
+    std::array<bool, 4> inPlace = {false,
+                                   signature->concatenatedInPlace(1, B),
+                                   signature->concatenatedInPlace(2, C),
+                                   signature->concatenatedInPlace(3, D)};
+    std::array<bool, 4> staged;
+    for(int i = 0; i < staged.size(); i++)
+    {
+        staged[i] = signature->mStaged[i] && !inPlace[i];
+    }
+
+    // The plan's kernel was selected for the alignments promised in the descriptor. Operands
+    // without one, and outputs read in place of their staged copies, are read at the widest
+    // access width their addresses allow.
+    auto vectorWidth = cSolution->vectorWidth();
+    for(int i = 0; i < 4; i++)
+    {
+        auto alignment    = signature->mAlignmentReq[i];
+        auto elementBytes = hiptensor::hipDataTypeSize(signature->mTensors[i]->mType);
+        for(uint32_t g = 0; g < (i == 0 ? 1u : signature->mOutputs); g++)
+        {
+            auto* ptr = pointer(i, g);
+            if(ptr == nullptr)
+            {
+                continue;
+            }
+            else if((alignment == 0 && !staged[i]) || inPlace[i])
+            {
+                while(vectorWidth > 1u && (std::size_t)ptr % (vectorWidth * elementBytes) != 0)
+                {
+                    vectorWidth /= 2u;
+                }
+            }
+            else if(alignment != 0 && (std::size_t)ptr % alignment != 0)
+            {
+                auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+                snprintf(msg,
+                         sizeof(msg),
+                         "Input Parameter Error : %c is not aligned to %u bytes (%s)",
+                         "ABCD"[i],
+                         alignment,
+                         hiptensorGetErrorString(errorCode));
+                logger->logError(api, msg);
+                return errorCode;
+            }
+        }
+    }
+
+    if(signature->mStagingBytes > 0
+       && (workspace == nullptr || workspaceSize < signature->mStagingBytes))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Insufficient workspace for staged operands: req: %lu alloc: %lu (%s)",
+                 signature->mStagingBytes,
+                 workspaceSize,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError(api, msg);
+        return errorCode;
+    }
+
+    // Operands that kernels cannot load directly are packed at the front of the workspace.
+    // The outputs of a multi-output contraction are packed side by side.
+    std::array<void*, 4> kernelOperands
+        = {(void*)A, (void*)B[0], (void*)pointer(2, 0), (void*)D[0]};
+    for(int i = 0; i < kernelOperands.size(); i++)
+    {
+        if(!staged[i] || pointer(i, 0) == nullptr)
+        {
+            continue;
+        }
+
+        auto* tensor      = signature->mOutputTensors[i];
+        kernelOperands[i] = (char*)workspace + signature->mStagingOffsets[i];
+
+        // The output is only written back after the kernel has run
+        if(i == 3)
+        {
+            continue;
+        }
+
+        auto elementBytes = hiptensor::hipDataTypeSize(tensor->mType);
+        for(uint32_t g = 0; g < (i == 0 ? 1u : signature->mOutputs); g++)
+        {
+            auto  offset = g * signature->mOutputOffsets[i] * elementBytes;
+            auto* slice  = (char*)kernelOperands[i] + offset;
+            auto  status = hiptensor::stridedCopy(pointer(i, g),
+                                                  tensor->mStrides,
+                                                  slice,
+                                                  signature->mKernelStrides[i],
+                                                  tensor->mLengths,
+                                                  tensor->mType,
+                                                  stream);
+            if(status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                snprintf(msg,
+                         sizeof(msg),
+                         "Unable to stage %c into the workspace (%s)",
+                         "ABCD"[i],
+                         hiptensorGetErrorString(status));
+                logger->logError(api, msg);
+                return status;
+            }
+        }
+    }
+
+    auto* kernelWorkspace     = signature->mStagingBytes > 0
+                                    ? (void*)((char*)workspace + signature->mStagingBytes)
+                                    : workspace;
+    auto  kernelWorkspaceSize = workspaceSize - std::min(workspaceSize, signature->mStagingBytes);
+
+    if(signature->mPartitions == 0)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Operands exceed 32-bit kernel indexing and cannot be partitioned (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError(api, msg);
+        return errorCode;
+    }
+
+    // Sets up the kernel arguments of partition p
+    auto initPartition = [&](hiptensor::ContractionSolution* solution, std::size_t p) {
+        auto bounds  = signature->partitionBounds(p);
+        auto lengths = signature->partitionLengths(bounds[1], bounds[3]);
+        auto offsets = signature->partitionOffsets(bounds[0], bounds[2]);
+
+        std::array<void*, 4> operands;
+        for(int i = 0; i < operands.size(); i++)
+        {
+            auto elementBytes = hiptensor::hipDataTypeSize(signature->mTensors[i]->mType);
+            operands[i]       = kernelOperands[i] != nullptr
+                                    ? (void*)((char*)kernelOperands[i] + offsets[i] * elementBytes)
+                                    : nullptr;
+        }
+
+        return solution->initArgs(alpha,
+                                  operands[0],
+                                  operands[1],
+                                  beta,
+                                  operands[2],
+                                  operands[3],
+                                  lengths[0],
+                                  signature->mKernelStrides[0],
+                                  lengths[1],
+                                  signature->mKernelStrides[1],
+                                  lengths[2],
+                                  signature->mKernelStrides[2],
+                                  lengths[3],
+                                  signature->mKernelStrides[3],
+                                  kernelWorkspace);
+    };
+
+    // Operands offset from the plan kernel's access width are read by the widest instance
+    // of the same kind whose access they allow, down to scalar access
+    auto* kernel = cSolution;
+    if(vectorWidth < cSolution->vectorWidth())
+    {
+        auto const& params     = cSolution->params();
+        auto        candidates = toContractionSolutionVec(
+            hiptensor::ContractionSolutionInstances::instance()
+                ->allSolutions()
+                .query(params->dimsM(),
+                       params->dimsN(),
+                       params->dimsK(),
+                       params->typeA(),
+                       params->typeB(),
+                       params->typeC(),
+                       params->typeD(),
+                       params->opA(),
+                       params->opB(),
+                       params->opCDE())
+                .solutions());
+
+        kernel = nullptr;
+        for(auto width = vectorWidth; width > 0u && kernel == nullptr; width /= 2u)
+        {
+            for(auto* candidate : hiptensor::filterByVectorWidth(candidates, width))
+            {
+                if(initPartition(candidate, 0)
+                   && candidate->workspaceSize() <= kernelWorkspaceSize)
+                {
+                    kernel = candidate;
+                    break;
+                }
+            }
+        }
+
+        if(kernel == nullptr)
+        {
+            auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+            snprintf(msg,
+                     sizeof(msg),
+                     "No kernel reads the operands at their alignment (%s)",
+                     hiptensorGetErrorString(errorCode));
+            logger->logError(api, msg);
+            return errorCode;
+        }
+
+        snprintf(msg,
+                 sizeof(msg),
+                 "Operands allow %u-wide access, running %s in place of %s",
+                 vectorWidth,
+                 kernel->kernelName().c_str(),
+                 cSolution->kernelName().c_str());
+        logger->logHeuristics(api, msg);
+    }
+
+    // Perform contraction with timing if LOG_LEVEL_PERF_TRACE
+    auto timed = timing && (logger->getLogMask() & HIPTENSOR_LOG_LEVEL_PERF_TRACE) != 0;
+    auto time  = 0.0f;
+
+    // Operands beyond 32-bit kernel indexing are contracted one partition at a time
+    for(std::size_t p = 0; p < signature->mPartitions; p++)
+    {
+        if(!initPartition(kernel, p))
+        {
+            auto errorCode = HIPTENSOR_STATUS_INTERNAL_ERROR;
+            snprintf(msg,
+                     sizeof(msg),
+                     "Selected kernel is unable to solve the problem (%s)",
+                     hiptensorGetErrorString(errorCode));
+            logger->logError(api, msg);
+            return errorCode;
+        }
+
+        if(kernel->workspaceSize() > kernelWorkspaceSize)
+        {
+            auto errorCode = HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+            snprintf(msg,
+                     sizeof(msg),
+                     "Insufficient workspace: req: %lu alloc: %lu (%s)",
+                     kernel->workspaceSize() + signature->mStagingBytes,
+                     workspaceSize,
+                     hiptensorGetErrorString(errorCode));
+            logger->logError(api, msg);
+            return errorCode;
+        }
+
+        time += (*kernel)(StreamConfig{stream, timed});
+    }
+
+    if(timed)
+    {
+        auto metrics = hiptensor::perfMetrics(
+            kernel->uid(), kernel->kernelName(), time, signature->mMetrics);
+
+        // log perf metrics (not name/id)
+        snprintf(msg,
+                 sizeof(msg),
+                 "KernelId: %lu KernelName: %s, %0.3f ms, %0.3f TFlops, %0.3f GB/s",
+                 metrics.mKernelUid,
+                 metrics.mKernelName.c_str(),
+                 metrics.mAvgTimeMs,
+                 metrics.mTflops,
+                 metrics.mBandwidth);
+        logger->logPerformanceTrace(api, msg);
+    }
+
+    // Scatter a staged result into the strided outputs
+    if(staged[3])
+    {
+        auto* tensor       = signature->mOutputTensors[3];
+        auto  elementBytes = hiptensor::hipDataTypeSize(tensor->mType);
+        for(uint32_t g = 0; g < signature->mOutputs; g++)
+        {
+            auto  offset = g * signature->mOutputOffsets[3] * elementBytes;
+            auto* slice  = (char*)kernelOperands[3] + offset;
+            auto  status = hiptensor::stridedCopy(slice,
+                                                  signature->mKernelStrides[3],
+                                                  D[g],
+                                                  tensor->mStrides,
+                                                  tensor->mLengths,
+                                                  tensor->mType,
+                                                  stream);
+            if(status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                snprintf(msg,
+                         sizeof(msg),
+                         "Unable to write the staged result back to D (%s)",
+                         hiptensorGetErrorString(status));
+                logger->logError(api, msg);
+                return status;
+            }
+        }
+    }
+
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+// Workspace that holds the unscaled product of a contraction whose scalars live on the
+// device. It has the layout of D and comes ahead of the kernel's own workspace.
+uint64_t scalarProductBytes(hiptensor::ContractionSignature const* signature)
+{
+    return hiptensor::ceilDiv(signature->mOutputTensors[3]->mBytes,
+                              uint64_t(hiptensor::WorkspaceGranularity))
+           * hiptensor::WorkspaceGranularity;
+}
+
+// Workspace the plan's kernel needs for the largest partition, after the staged operands
+// and, for device scalars, the unscaled product. Degenerate shapes only need room for
+// the partial sums of their reductions.
+uint64_t planWorkspaceSize(hiptensor::ContractionSignature const* signature,
+                           hiptensor::ContractionSolution*        cSolution,
+                           hiptensorPointerMode_t                 pointerMode)
+{
+    auto productBytes = pointerMode == HIPTENSOR_POINTER_MODE_DEVICE
+                            ? scalarProductBytes(signature)
+                            : uint64_t{0};
+    if(signature->mSqueezed.mShape != hiptensor::ContractionShape::GENERAL)
+    {
+        return hiptensor::degenerateWorkspaceSize(signature->mSqueezed) + productBytes;
+    }
+
+    auto lengths = signature->partitionLengths(signature->mPartitionM, signature->mPartitionN);
+    auto kernelBytes = cSolution->initArgs(nullptr,
+                                           nullptr,
+                                           nullptr,
+                                           nullptr,
+                                           nullptr,
+                                           nullptr,
+                                           lengths[0],
+                                           signature->mKernelStrides[0],
+                                           lengths[1],
+                                           signature->mKernelStrides[1],
+                                           lengths[2],
+                                           signature->mKernelStrides[2],
+                                           lengths[3],
+                                           signature->mKernelStrides[3],
+                                           nullptr)
+                           ? cSolution->workspaceSize()
+                           : std::size_t{0};
+    return kernelBytes + signature->mStagingBytes + productBytes;
+}
+
+
+// Runs a single-output contraction with scalars in the given pointer mode. Host scalars go
+// to the kernel directly. Device scalars cannot be kernel arguments, so the kernel forms
+// the unscaled product in the front of the workspace and an epilogue on the stream reads
+// the scalars and writes D = alpha * product + beta * C.
+hiptensorStatus_t runScaledContraction(char const*                             api,
+                                       hiptensorPointerMode_t                  pointerMode,
+                                       hiptensor::ContractionSignature const* signature,
+                                       hiptensor::ContractionSolution*        cSolution,
+                                       const void*                            alpha,
+                                       const void*                            A,
+                                       const void*                            B,
+                                       const void*                            beta,
+                                       const void*                            C,
+                                       void*                                  D,
+                                       void*                                  workspace,
+                                       uint64_t                               workspaceSize,
+                                       hipStream_t                            stream,
+                                       bool                                   timing)
+{
+    if(pointerMode == HIPTENSOR_POINTER_MODE_HOST)
+    {
+        return runContraction(api,
+                              signature,
+                              cSolution,
+                              alpha,
+                              A,
+                              &B,
+                              beta,
+                              &C,
+                              &D,
+                              workspace,
+                              workspaceSize,
+                              stream,
+                              timing);
+    }
+
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    char msg[256];
+
+    auto  productBytes = scalarProductBytes(signature);
+    auto* output       = signature->mOutputTensors[3];
+    auto  scalarType   = output->mType;
+    auto  unit         = std::array<std::array<char, 16>, 2>{};
+    if(scalarType == HIP_R_16F)
+    {
+        writeUnitScalars<_Float16>(unit);
+    }
+    else if(scalarType == HIP_R_32F)
+    {
+        writeUnitScalars<float>(unit);
+    }
+    else if(scalarType == HIP_R_64F)
+    {
+        writeUnitScalars<double>(unit);
+    }
+    else
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Device pointer mode supports f16, f32 and f64 outputs (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError(api, msg);
+        return errorCode;
+    }
+
+    if(workspace == nullptr || workspaceSize < productBytes)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Device pointer mode needs %lu bytes of workspace for the product (%s)",
+                 productBytes,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError(api, msg);
+        return errorCode;
+    }
+
+    void* product        = workspace;
+    auto* kernelSpace    = productBytes < workspaceSize ? (char*)workspace + productBytes : nullptr;
+    auto  kernelSpaceLen = workspaceSize - productBytes;
+    auto  status         = runContraction(api,
+                                 signature,
+                                 cSolution,
+                                 unit[0].data(),
+                                 A,
+                                 &B,
+                                 beta != nullptr ? unit[1].data() : nullptr,
+                                 &C,
+                                 &product,
+                                 kernelSpace,
+                                 kernelSpaceLen,
+                                 stream,
+                                 timing);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    status = hiptensor::applyScalars(alpha,
+                                     beta,
+                                     scalarType,
+                                     product,
+                                     C,
+                                     signature->mOutputTensors[2]->mStrides,
+                                     D,
+                                     output->mStrides,
+                                     output->mLengths,
+                                     output->mType,
+                                     stream);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to apply device scalars to D (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError(api, msg);
+    }
+    return status;
+}
+
+// Runs a contraction that was given no workspace out of the handle's workspace pool.
+// The block goes back to the pool once the contraction is issued to the stream.
+hiptensorStatus_t runPooledContraction(char const*                             api,
+                                       hiptensor::WorkspacePool&               pool,
+                                       hiptensorPointerMode_t                  pointerMode,
+                                       hiptensor::ContractionSignature const* signature,
+                                       hiptensor::ContractionSolution*        cSolution,
+                                       const void*                            alpha,
+                                       const void*                            A,
+                                       const void* const                      B[],
+                                       const void*                            beta,
+                                       const void* const                      C[],
+                                       void* const                            D[],
+                                       hipStream_t                            stream,
+                                       bool                                   timing)
+{
+    auto bytes = planWorkspaceSize(signature, cSolution, pointerMode);
+    if(bytes == 0)
+    {
+        return runContraction(
+            api, signature, cSolution, alpha, A, B, beta, C, D, nullptr, 0u, stream, timing);
+    }
+
+    auto* workspace = pool.acquire(bytes, stream);
+    if(workspace == nullptr)
+    {
+        using hiptensor::Logger;
+        auto& logger = Logger::instance();
+
+        char msg[256];
+        auto errorCode = HIPTENSOR_STATUS_ALLOC_FAILED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to allocate %lu bytes of pooled workspace (%s)",
+                 bytes,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError(api, msg);
+        return errorCode;
+    }
+
+    auto status = pointerMode == HIPTENSOR_POINTER_MODE_HOST
+                      ? runContraction(api,
+                                       signature,
+                                       cSolution,
+                                       alpha,
+                                       A,
+                                       B,
+                                       beta,
+                                       C,
+                                       D,
+                                       workspace,
+                                       bytes,
+                                       stream,
+                                       timing)
+                      : runScaledContraction(api,
+                                             pointerMode,
+                                             signature,
+                                             cSolution,
+                                             alpha,
+                                             A,
+                                             B[0],
+                                             beta,
+                                             C != nullptr ? C[0] : nullptr,
+                                             D[0],
+                                             workspace,
+                                             bytes,
+                                             stream,
+                                             timing);
+    pool.release(workspace, stream);
+    return status;
+}
+
+// Contractions that forward their scalars to the kernel take them from host memory
+hiptensorStatus_t requireHostScalars(char const* api, hiptensor::Handle const* handle)
+{
+    if(handle->getPointerMode() == HIPTENSOR_POINTER_MODE_HOST)
+    {
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    char msg[256];
+    auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+    snprintf(msg,
+             sizeof(msg),
+             "Device pointer mode is not supported, set HIPTENSOR_POINTER_MODE_HOST (%s)",
+             hiptensorGetErrorString(errorCode));
+    logger->logError(api, msg);
+    return errorCode;
+}
+
+// Largest alignment up to `alignment` kept by a byte offset
+uint32_t alignmentAtOffset(uint32_t alignment, std::size_t offsetBytes)
+{
+    while(alignment > 1 && offsetBytes % alignment != 0)
+    {
+        alignment /= 2;
+    }
+    return alignment;
+}
@@ -0,0 +1,302 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_CONTRACTION_LAUNCH_HPP
+#define HIPTENSOR_CONTRACTION_LAUNCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include <hiptensor/hiptensor.hpp>
+
+#include "contraction_solution.hpp"
+#include "contraction_streaming.hpp"
+#include "handle.hpp"
+#include "workspace_pool.hpp"
+
+// Convert between vectors of void ptrs stored in opaque API objects
+// to vectors of ContractionSolution ptrs with simple cast.
+inline auto toContractionSolutionVec(std::vector<void*> const& v)
+{
+    auto result = std::vector<hiptensor::ContractionSolution*>(v.size());
+    std::transform(v.begin(), v.end(), result.begin(), [](auto* p) {
+        return (hiptensor::ContractionSolution*)p;
+    });
+    return result;
+}
+
+inline auto toContractionSolutionVec(
+    std::unordered_map<std::size_t, hiptensor::ContractionSolution*> const& map)
+{
+    auto result = std::vector<hiptensor::ContractionSolution*>(map.size());
+    transform(map.begin(), map.end(), result.begin(), [](auto p) { return p.second; });
+    return result;
+}
+
+inline auto toVoidVec(std::vector<hiptensor::ContractionSolution*> const& v)
+{
+    auto result = std::vector<void*>(v.size());
+    transform(v.begin(), v.end(), result.begin(), [](auto* p) { return (void*)p; });
+    return result;
+}
+
+inline auto toVoidVec(std::unordered_map<std::size_t, hiptensor::ContractionSolution*> const& map)
+{
+    auto result = std::vector<void*>(map.size());
+    transform(map.begin(), map.end(), result.begin(), [](auto p) { return (void*)p.second; });
+    return result;
+}
+
+// Streams tiles through the plan's kernel with one HIP stream per slot
+class HipStreamingBackend : public hiptensor::StreamingBackend
+{
+public:
+    HipStreamingBackend(hiptensor::ContractionSolution* solution, uint32_t slots)
+        : mSolution(solution)
+        , mStreams(slots, nullptr)
+    {
+        for(auto& stream : mStreams)
+        {
+            CHECK_HIP_ERROR(hipStreamCreate(&stream));
+        }
+    }
+
+    ~HipStreamingBackend() override
+    {
+        for(auto stream : mStreams)
+        {
+            CHECK_HIP_ERROR(hipStreamDestroy(stream));
+        }
+    }
+
+    hiptensorStatus_t allocate(void** ptr, std::size_t bytes) override
+    {
+        return hipMalloc(ptr, bytes) == hipSuccess ? HIPTENSOR_STATUS_SUCCESS
+                                                   : HIPTENSOR_STATUS_ALLOC_FAILED;
+    }
+
+    hiptensorStatus_t release(void* ptr) override
+    {
+        return hipFree(ptr) == hipSuccess ? HIPTENSOR_STATUS_SUCCESS : HIPTENSOR_STATUS_HIP_ERROR;
+    }
+
+    hiptensorStatus_t upload(void*                       dst,
+                             hiptensorDimVector_t const& dstStrides,
+                             void const*                 src,
+                             hiptensorDimVector_t const& srcStrides,
+                             hiptensorDimVector_t const& lengths,
+                             std::size_t                 elementBytes,
+                             uint32_t                    slot) override
+    {
+        return copy(dst,
+                    dstStrides,
+                    src,
+                    srcStrides,
+                    lengths,
+                    elementBytes,
+                    hipMemcpyHostToDevice,
+                    mStreams[slot]);
+    }
+
+    hiptensorStatus_t download(void*                       dst,
+                               hiptensorDimVector_t const& dstStrides,
+                               void const*                 src,
+                               hiptensorDimVector_t const& srcStrides,
+                               hiptensorDimVector_t const& lengths,
+                               std::size_t                 elementBytes,
+                               uint32_t                    slot) override
+    {
+        return copy(dst,
+                    dstStrides,
+                    src,
+                    srcStrides,
+                    lengths,
+                    elementBytes,
+                    hipMemcpyDeviceToHost,
+                    mStreams[slot]);
+    }
+
+    hiptensorStatus_t contract(void const*                                alpha,
+                               void const*                                A,
+                               void const*                                B,
+                               void const*                                beta,
+                               void const*                                C,
+                               void*                                      D,
+                               std::array<hiptensorDimVector_t, 4> const& lengths,
+                               void*                                      workspace,
+                               uint32_t                                   slot) override
+    {
+        if(!mSolution->initArgs(alpha,
+                                A,
+                                B,
+                                beta,
+                                C,
+                                D,
+                                lengths[0],
+                                hiptensor::stridesFromLengths(lengths[0]),
+                                lengths[1],
+                                hiptensor::stridesFromLengths(lengths[1]),
+                                lengths[2],
+                                hiptensor::stridesFromLengths(lengths[2]),
+                                lengths[3],
+                                hiptensor::stridesFromLengths(lengths[3]),
+                                workspace))
+        {
+            return HIPTENSOR_STATUS_INTERNAL_ERROR;
+        }
+
+        // Kernel arguments are copied at launch, so the next tile may re-initialize them
+        (*mSolution)(StreamConfig{mStreams[slot], false});
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t synchronize() override
+    {
+        auto status = HIPTENSOR_STATUS_SUCCESS;
+        for(auto stream : mStreams)
+        {
+            if(hipStreamSynchronize(stream) != hipSuccess)
+            {
+                status = HIPTENSOR_STATUS_HIP_ERROR;
+            }
+        }
+        return status;
+    }
+
+private:
+    static hiptensorStatus_t copy(void*                       dst,
+                                  hiptensorDimVector_t const& dstStrides,
+                                  void const*                 src,
+                                  hiptensorDimVector_t const& srcStrides,
+                                  hiptensorDimVector_t const& lengths,
+                                  std::size_t                 elementBytes,
+                                  hipMemcpyKind               kind,
+                                  hipStream_t                 stream)
+    {
+        auto result = hipSuccess;
+        hiptensor::forEachCopyRun(
+            lengths,
+            srcStrides,
+            dstStrides,
+            [&](std::size_t srcOffset, std::size_t dstOffset, std::size_t count) {
+                if(result == hipSuccess)
+                {
+                    result = hipMemcpyAsync((char*)dst + dstOffset * elementBytes,
+                                            (char const*)src + srcOffset * elementBytes,
+                                            count * elementBytes,
+                                            kind,
+                                            stream);
+                }
+            });
+        return result == hipSuccess ? HIPTENSOR_STATUS_SUCCESS : HIPTENSOR_STATUS_HIP_ERROR;
+    }
+
+    hiptensor::ContractionSolution* mSolution;
+    std::vector<hipStream_t>        mStreams;
+};
+
+// Runs the plan's kernel on the operands of every output of a contraction. B, C and D
+// hold one pointer per output; C may be nullptr for scale contractions.
+hiptensorStatus_t runContraction(char const*                             api,
+                                 hiptensor::ContractionSignature const* signature,
+                                 hiptensor::ContractionSolution*        cSolution,
+                                 const void*                            alpha,
+                                 const void*                            A,
+                                 const void* const                      B[],
+                                 const void*                            beta,
+                                 const void* const                      C[],
+                                 void* const                            D[],
+                                 void*                                  workspace,
+                                 uint64_t                               workspaceSize,
+                                 hipStream_t                            stream,
+                                 bool                                   timing = true);
+
+// Workspace that holds the unscaled product of a contraction whose scalars live on the
+// device. It has the layout of D and comes ahead of the kernel's own workspace.
+uint64_t scalarProductBytes(hiptensor::ContractionSignature const* signature);
+
+// Workspace the plan's kernel needs for the largest partition, after the staged operands
+// and, for device scalars, the unscaled product. Degenerate shapes only need room for
+// the partial sums of their reductions.
+uint64_t planWorkspaceSize(hiptensor::ContractionSignature const* signature,
+                           hiptensor::ContractionSolution*        cSolution,
+                           hiptensorPointerMode_t                 pointerMode);
+
+// Alpha = 1 and beta = 0 in the type of the contraction's scalars
+template <typename ScalarT>
+inline void writeUnitScalars(std::array<std::array<char, 16>, 2>& scalars)
+{
+    auto one  = ScalarT(1);
+    auto zero = ScalarT(0);
+    std::memcpy(scalars[0].data(), &one, sizeof(ScalarT));
+    std::memcpy(scalars[1].data(), &zero, sizeof(ScalarT));
+}
+
+// Runs a single-output contraction with scalars in the given pointer mode. Host scalars go
+// to the kernel directly. Device scalars cannot be kernel arguments, so the kernel forms
+// the unscaled product in the front of the workspace and an epilogue on the stream reads
+// the scalars and writes D = alpha * product + beta * C.
+hiptensorStatus_t runScaledContraction(char const*                             api,
+                                       hiptensorPointerMode_t                  pointerMode,
+                                       hiptensor::ContractionSignature const* signature,
+                                       hiptensor::ContractionSolution*        cSolution,
+                                       const void*                            alpha,
+                                       const void*                            A,
+                                       const void*                            B,
+                                       const void*                            beta,
+                                       const void*                            C,
+                                       void*                                  D,
+                                       void*                                  workspace,
+                                       uint64_t                               workspaceSize,
+                                       hipStream_t                            stream,
+                                       bool                                   timing = true);
+
+// Runs a contraction that was given no workspace out of the handle's workspace pool.
+// The block goes back to the pool once the contraction is issued to the stream.
+hiptensorStatus_t runPooledContraction(char const*                             api,
+                                       hiptensor::WorkspacePool&               pool,
+                                       hiptensorPointerMode_t                  pointerMode,
+                                       hiptensor::ContractionSignature const* signature,
+                                       hiptensor::ContractionSolution*        cSolution,
+                                       const void*                            alpha,
+                                       const void*                            A,
+                                       const void* const                      B[],
+                                       const void*                            beta,
+                                       const void* const                      C[],
+                                       void* const                            D[],
+                                       hipStream_t                            stream,
+                                       bool                                   timing = true);
+
+// Contractions that forward their scalars to the kernel take them from host memory
+hiptensorStatus_t requireHostScalars(char const* api, hiptensor::Handle const* handle);
+
+// Largest alignment up to `alignment` kept by a byte offset
+uint32_t alignmentAtOffset(uint32_t alignment, std::size_t offsetBytes);
+
+#endif // HIPTENSOR_CONTRACTION_LAUNCH_HPP
@@ -0,0 +1,549 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+
+#include "contraction_multi_device.hpp"
+#include "contraction_streaming.hpp"
+#include "data_types.hpp"
+#include "descriptor_cache.hpp"
+#include "util.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        // Blocks are placed at the alignment of device allocations
+        constexpr std::size_t BlockAlignment = 256u;
+
+        constexpr std::size_t NoMode = ~std::size_t{0};
+
+        std::size_t alignBlock(std::size_t bytes)
+        {
+            return ceilDiv(bytes, BlockAlignment) * BlockAlignment;
+        }
+
+        // Outermost M and N mode of operand i, or NoMode if it has none.
+        // Modes are ordered A = [M, K], B = [N, K] and C, D = [M, N].
+        std::array<std::size_t, 2> outerModes(int i, std::size_t rankM, std::size_t rankN)
+        {
+            auto modeM = rankM > 0 ? std::size_t{0} : NoMode;
+            auto modeN = rankN > 0 ? (i == 1 ? std::size_t{0} : rankM) : NoMode;
+            return {i == 1 ? NoMode : modeM, i == 0 ? NoMode : modeN};
+        }
+
+        // Element offset of a multi-index, given as a flat index over lengths with the
+        // last mode fastest
+        std::size_t flatOffset(std::size_t                 index,
+                               hiptensorDimVector_t const& lengths,
+                               hiptensorDimVector_t const& strides,
+                               std::size_t                 first,
+                               std::size_t                 last)
+        {
+            auto offset = std::size_t{0};
+            for(auto mode = last; mode-- > first;)
+            {
+                offset += (index % lengths[mode]) * strides[mode];
+                index /= lengths[mode];
+            }
+            return offset;
+        }
+
+        // D = alpha * A * B + beta * C on strided A = [M, K], B = [N, K] and C, D = [M, N]
+        template <typename T>
+        void contractStrided(void const*                                alpha,
+                             T const*                                   A,
+                             T const*                                   B,
+                             void const*                                beta,
+                             T const*                                   C,
+                             T*                                         D,
+                             std::array<hiptensorDimVector_t, 4> const& lengths,
+                             std::array<hiptensorDimVector_t, 4> const& strides)
+        {
+            auto const& lengthsA = lengths[0];
+            auto const& lengthsD = lengths[3];
+
+            auto rankK = (lengthsA.size() + lengths[1].size() - lengthsD.size()) / 2;
+            auto rankM = lengthsA.size() - std::min(rankK, lengthsA.size());
+            auto rankN = lengths[1].size() - std::min(rankK, lengths[1].size());
+
+            std::size_t m = 1, n = 1, k = 1;
+            for(std::size_t i = 0; i < lengthsA.size(); i++)
+            {
+                (i < rankM ? m : k) *= lengthsA[i];
+            }
+            for(std::size_t i = 0; i < rankN; i++)
+            {
+                n *= lengths[1][i];
+            }
+
+            auto alphaT = alpha != nullptr ? *static_cast<T const*>(alpha) : T{0};
+            auto betaT  = beta != nullptr ? *static_cast<T const*>(beta) : T{0};
+            for(std::size_t i = 0; i < m; i++)
+            {
+                auto rowA = flatOffset(i, lengthsA, strides[0], 0, rankM);
+                auto rowD = flatOffset(i, lengthsD, strides[3], 0, rankM);
+                auto rowC = C != nullptr ? flatOffset(i, lengths[2], strides[2], 0, rankM) : 0u;
+                for(std::size_t j = 0; j < n; j++)
+                {
+                    auto rowB = flatOffset(j, lengths[1], strides[1], 0, rankN);
+
+                    T accum = 0;
+                    for(std::size_t l = 0; l < k; l++)
+                    {
+                        auto offsetA = flatOffset(l, lengthsA, strides[0], rankM, rankM + rankK);
+                        auto offsetB = flatOffset(l, lengths[1], strides[1], rankN, rankN + rankK);
+                        accum += A[rowA + offsetA] * B[rowB + offsetB];
+                    }
+
+                    auto value = alphaT * accum;
+                    if(C != nullptr)
+                    {
+                        value += betaT
+                                 * C[rowC
+                                     + flatOffset(j, lengths[2], strides[2], rankM, rankM + rankN)];
+                    }
+                    D[rowD + flatOffset(j, lengthsD, strides[3], rankM, rankM + rankN)] = value;
+                }
+            }
+        }
+    }
+
+    std::array<hiptensorDimVector_t, 4>
+        MultiDevicePlan::shareLengths(DeviceShare const& share) const
+    {
+        auto lengths = mLengths;
+        for(int i = 0; i < lengths.size(); i++)
+        {
+            auto mode = outerModes(i, mRankM, mRankN)[mSplitN ? 1 : 0];
+            if(mode < lengths[i].size())
+            {
+                lengths[i][mode] = share.mExtent;
+            }
+        }
+        return lengths;
+    }
+
+    std::array<std::size_t, 4> MultiDevicePlan::shareOffsets(DeviceShare const& share) const
+    {
+        std::array<std::size_t, 4> offsets = {};
+        for(int i = 0; i < offsets.size(); i++)
+        {
+            auto mode = outerModes(i, mRankM, mRankN)[mSplitN ? 1 : 0];
+            if(mode < mStrides[i].size())
+            {
+                offsets[i] = share.mStart * mStrides[i][mode];
+            }
+        }
+        return offsets;
+    }
+
+    std::size_t MultiDevicePlan::shareBytes(DeviceShare const& share) const
+    {
+        auto lengths = shareLengths(share);
+        auto bytes   = std::size_t{0};
+        for(int i : {0, 1, 3})
+        {
+            bytes += alignBlock(elementsFromLengths(lengths[i]) * hipDataTypeSize(mTypes[i]));
+        }
+        return bytes;
+    }
+
+    hiptensorStatus_t planMultiDevice(MultiDevicePlan*            plan,
+                                      ContractionSignature const& signature,
+                                      std::vector<double> const&  weights)
+    {
+        if(plan == nullptr || weights.empty()
+           || std::any_of(weights.begin(), weights.end(), [](double w) { return !(w > 0.0); }))
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        // Multi-output contractions are split by their own outputs instead
+        if(signature.mOutputs > 1)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        for(int i = 0; i < signature.mTensors.size(); i++)
+        {
+            plan->mTypes[i]   = signature.mTensors[i]->mType;
+            plan->mLengths[i] = signature.mTensors[i]->mLengths;
+            plan->mStrides[i] = signature.mTensors[i]->mStrides;
+        }
+        plan->mRankM  = signature.mRankM;
+        plan->mRankN  = signature.mRankN;
+        plan->mOuterM = signature.mOuterM;
+        plan->mOuterN = signature.mOuterN;
+        plan->mShares.clear();
+
+        // Splitting M replicates B on every device and splitting N replicates A, so the
+        // mode is taken that replicates the smaller input, when both can be split
+        auto canSplitM = plan->mRankM > 0 && plan->mOuterM > 1;
+        auto canSplitN = plan->mRankN > 0 && plan->mOuterN > 1;
+        if(canSplitM && canSplitN)
+        {
+            plan->mSplitN = signature.mTensors[0]->mBytes < signature.mTensors[1]->mBytes;
+        }
+        else
+        {
+            plan->mSplitN = canSplitN;
+        }
+
+        auto outer = canSplitM || canSplitN ? (plan->mSplitN ? plan->mOuterN : plan->mOuterM)
+                                            : std::size_t{1};
+
+        // Extents in proportion to the weights, with the remainder going to the largest
+        // fractions
+        auto total   = std::accumulate(weights.begin(), weights.end(), 0.0);
+        auto extents = std::vector<std::size_t>(weights.size());
+        auto order   = std::vector<uint32_t>(weights.size());
+        auto placed  = std::size_t{0};
+        for(uint32_t d = 0; d < weights.size(); d++)
+        {
+            extents[d] = std::size_t(std::floor(double(outer) * weights[d] / total));
+            extents[d] = std::min(extents[d], outer - placed);
+            placed += extents[d];
+            order[d] = d;
+        }
+        auto fraction = [&](uint32_t d) {
+            auto exact = double(outer) * weights[d] / total;
+            return exact - std::floor(exact);
+        };
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+            return fraction(lhs) > fraction(rhs);
+        });
+        for(std::size_t r = 0; placed < outer; r = (r + 1) % order.size())
+        {
+            extents[order[r]]++;
+            placed++;
+        }
+
+        auto start = std::size_t{0};
+        for(uint32_t d = 0; d < extents.size(); d++)
+        {
+            if(extents[d] > 0)
+            {
+                plan->mShares.push_back({d, start, extents[d]});
+                start += extents[d];
+            }
+        }
+
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    HostMultiDeviceBackend::HostMultiDeviceBackend(uint32_t devices, hipDataType type)
+        : mType(type)
+        , mDevices(devices)
+    {
+    }
+
+    HostMultiDeviceBackend::~HostMultiDeviceBackend()
+    {
+        for(auto& allocation : mAllocations)
+        {
+            std::free(allocation.first);
+        }
+    }
+
+    hiptensorStatus_t
+        HostMultiDeviceBackend::allocate(uint32_t device, void** ptr, std::size_t bytes)
+    {
+        if(device >= mDevices.size())
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        *ptr = std::malloc(std::max(bytes, std::size_t{1}));
+        if(*ptr == nullptr)
+        {
+            return HIPTENSOR_STATUS_ALLOC_FAILED;
+        }
+
+        auto& simulated = mDevices[device];
+        mAllocations.emplace_back(*ptr, bytes);
+        mOwners.push_back(device);
+        simulated.mAllocatedBytes += bytes;
+        simulated.mPeakBytes = std::max(simulated.mPeakBytes, simulated.mAllocatedBytes);
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t HostMultiDeviceBackend::release(uint32_t device, void* ptr)
+    {
+        auto it = std::find_if(mAllocations.begin(), mAllocations.end(), [ptr](auto& allocation) {
+            return allocation.first == ptr;
+        });
+        auto index = std::size_t(it - mAllocations.begin());
+        if(it == mAllocations.end() || mOwners[index] != device)
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        mDevices[device].mAllocatedBytes -= it->second;
+        std::free(it->first);
+        mAllocations.erase(it);
+        mOwners.erase(mOwners.begin() + index);
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t HostMultiDeviceBackend::copy(uint32_t                    device,
+                                                   void*                       dst,
+                                                   hiptensorDimVector_t const& dstStrides,
+                                                   void const*                 src,
+                                                   hiptensorDimVector_t const& srcStrides,
+                                                   hiptensorDimVector_t const& lengths,
+                                                   std::size_t                 elementBytes)
+    {
+        if(device >= mDevices.size())
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        forEachCopyRun(lengths,
+                       srcStrides,
+                       dstStrides,
+                       [&](std::size_t srcOffset, std::size_t dstOffset, std::size_t count) {
+                           std::memcpy((char*)dst + dstOffset * elementBytes,
+                                       (char const*)src + srcOffset * elementBytes,
+                                       count * elementBytes);
+                       });
+        mDevices[device].mCopiedBytes += elementsFromLengths(lengths) * elementBytes;
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t
+        HostMultiDeviceBackend::contract(uint32_t                                   device,
+                                         void const*                                alpha,
+                                         void const*                                A,
+                                         void const*                                B,
+                                         void const*                                beta,
+                                         void const*                                C,
+                                         void*                                      D,
+                                         std::array<hiptensorDimVector_t, 4> const& lengths,
+                                         std::array<hiptensorDimVector_t, 4> const& strides)
+    {
+        if(device >= mDevices.size())
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        if(mType == HIP_R_32F)
+        {
+            contractStrided<float>(alpha,
+                                   (float const*)A,
+                                   (float const*)B,
+                                   beta,
+                                   (float const*)C,
+                                   (float*)D,
+                                   lengths,
+                                   strides);
+        }
+        else if(mType == HIP_R_64F)
+        {
+            contractStrided<double>(alpha,
+                                    (double const*)A,
+                                    (double const*)B,
+                                    beta,
+                                    (double const*)C,
+                                    (double*)D,
+                                    lengths,
+                                    strides);
+        }
+        else
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        mDevices[device].mContractions++;
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t HostMultiDeviceBackend::join()
+    {
+        mJoins++;
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    std::size_t HostMultiDeviceBackend::peakBytes(uint32_t device) const
+    {
+        return mDevices[device].mPeakBytes;
+    }
+
+    std::size_t HostMultiDeviceBackend::copiedBytes(uint32_t device) const
+    {
+        return mDevices[device].mCopiedBytes;
+    }
+
+    std::size_t HostMultiDeviceBackend::contractions(uint32_t device) const
+    {
+        return mDevices[device].mContractions;
+    }
+
+    std::size_t HostMultiDeviceBackend::joins() const
+    {
+        return mJoins;
+    }
+
+    hiptensorStatus_t multiDeviceContraction(MultiDevicePlan const& plan,
+                                             MultiDeviceBackend&    backend,
+                                             void const*            alpha,
+                                             void const*            A,
+                                             void const*            B,
+                                             void const*            beta,
+                                             void const*            C,
+                                             void*                  D)
+    {
+        auto hasC = plan.mTypes[2] != NONE_TYPE && C != nullptr;
+
+        std::array<std::size_t, 4> elementBytes;
+        for(int i = 0; i < elementBytes.size(); i++)
+        {
+            elementBytes[i] = hipDataTypeSize(plan.mTypes[i]);
+        }
+
+        std::array<char const*, 4> operands
+            = {(char const*)A, (char const*)B, (char const*)C, (char const*)D};
+
+        // Shares of device 0 last, after every transfer has been issued
+        auto shares = plan.mShares;
+        std::stable_partition(shares.begin(), shares.end(), [](DeviceShare const& share) {
+            return share.mDevice != 0;
+        });
+
+        auto status = HIPTENSOR_STATUS_SUCCESS;
+        for(auto const& share : shares)
+        {
+            auto lengths = plan.shareLengths(share);
+            auto offsets = plan.shareOffsets(share);
+
+            std::array<char const*, 4> blocks;
+            for(int i = 0; i < blocks.size(); i++)
+            {
+                blocks[i] = operands[i] != nullptr ? operands[i] + offsets[i] * elementBytes[i]
+                                                   : nullptr;
+            }
+
+            if(share.mDevice == 0)
+            {
+                status = backend.contract(0,
+                                          alpha,
+                                          blocks[0],
+                                          blocks[1],
+                                          beta,
+                                          hasC ? blocks[2] : nullptr,
+                                          (void*)blocks[3],
+                                          lengths,
+                                          plan.mStrides);
+                if(status != HIPTENSOR_STATUS_SUCCESS)
+                {
+                    break;
+                }
+                continue;
+            }
+
+            // Packed A, B and D blocks on the share's device; C is copied into D
+            void* memory = nullptr;
+            status       = backend.allocate(share.mDevice, &memory, plan.shareBytes(share));
+            if(status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                break;
+            }
+
+            std::array<hiptensorDimVector_t, 4> packedStrides;
+            std::array<char*, 4>                packed = {};
+            auto                                offset = std::size_t{0};
+            for(int i : {0, 1, 3})
+            {
+                packedStrides[i] = stridesFromLengths(lengths[i]);
+                packed[i]        = (char*)memory + offset;
+                offset += alignBlock(elementsFromLengths(lengths[i]) * elementBytes[i]);
+            }
+            packedStrides[2] = packedStrides[3];
+
+            for(int i : {0, 1, 2})
+            {
+                if(i == 2 && !hasC)
+                {
+                    continue;
+                }
+                auto* dst = packed[i == 2 ? 3 : i];
+                status    = backend.copy(share.mDevice,
+                                      dst,
+                                      packedStrides[i],
+                                      blocks[i],
+                                      plan.mStrides[i],
+                                      lengths[i],
+                                      elementBytes[i]);
+                if(status != HIPTENSOR_STATUS_SUCCESS)
+                {
+                    break;
+                }
+            }
+
+            if(status == HIPTENSOR_STATUS_SUCCESS)
+            {
+                status = backend.contract(share.mDevice,
+                                          alpha,
+                                          packed[0],
+                                          packed[1],
+                                          beta,
+                                          hasC ? packed[3] : nullptr,
+                                          packed[3],
+                                          lengths,
+                                          packedStrides);
+            }
+
+            // The D block goes back into place on device 0
+            if(status == HIPTENSOR_STATUS_SUCCESS)
+            {
+                status = backend.copy(share.mDevice,
+                                      (void*)blocks[3],
+                                      plan.mStrides[3],
+                                      packed[3],
+                                      packedStrides[3],
+                                      lengths[3],
+                                      elementBytes[3]);
+            }
+
+            auto released = backend.release(share.mDevice, memory);
+            if(status == HIPTENSOR_STATUS_SUCCESS)
+            {
+                status = released;
+            }
+            if(status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                break;
+            }
+        }
+
+        auto joined = backend.join();
+        return status != HIPTENSOR_STATUS_SUCCESS ? status : joined;
+    }
+
+} // namespace hiptensor
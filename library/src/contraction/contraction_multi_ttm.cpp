@@ -0,0 +1,290 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
+#include "contraction_multi_ttm.hpp"
+#include "util.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        // out[p, r, q] = alpha * sum_k U[r, k] * in[p, k, q] + beta * C[p, r, q], with
+        // rows (p, r) shared out between the threads
+        template <typename T>
+        void applyMatrix(T const*    in,
+                         T const*    U,
+                         T*          out,
+                         std::size_t P,
+                         std::size_t K,
+                         std::size_t Q,
+                         std::size_t R,
+                         T           alpha,
+                         T           beta,
+                         T const*    C,
+                         uint32_t    threads)
+        {
+            std::atomic<std::size_t> next{0};
+            auto                     worker = [&]() {
+                for(auto row = next++; row < P * R; row = next++)
+                {
+                    auto p   = row / R;
+                    auto r   = row % R;
+                    auto dst = out + row * Q;
+                    std::fill(dst, dst + Q, T(0));
+                    for(std::size_t k = 0; k < K; k++)
+                    {
+                        auto u   = U[r * K + k];
+                        auto src = in + (p * K + k) * Q;
+                        for(std::size_t q = 0; q < Q; q++)
+                        {
+                            dst[q] += u * src[q];
+                        }
+                    }
+                    for(std::size_t q = 0; q < Q; q++)
+                    {
+                        dst[q] = alpha * dst[q] + (C != nullptr ? beta * C[row * Q + q] : T(0));
+                    }
+                }
+            };
+
+            threads = uint32_t(std::min<std::size_t>(threads, std::max<std::size_t>(P * R, 1)));
+            std::vector<std::thread> pool;
+            for(uint32_t i = 1; i < threads; i++)
+            {
+                pool.emplace_back(worker);
+            }
+            worker();
+            for(auto& thread : pool)
+            {
+                thread.join();
+            }
+        }
+
+        template <typename T>
+        hiptensorStatus_t runHost(MultiTtmPlan const& plan,
+                                  void const*         alpha,
+                                  void const*         X,
+                                  void const* const   U[],
+                                  void const*         beta,
+                                  void const*         C,
+                                  void*               Y,
+                                  uint32_t            threads)
+        {
+            auto alphaT = *static_cast<T const*>(alpha);
+            auto betaT  = beta != nullptr ? *static_cast<T const*>(beta) : T(0);
+
+            // Without matrices, Y is alpha * X + beta * C
+            if(plan.mSteps.empty())
+            {
+                auto elements = elementsFromLengths(plan.mLengths);
+                auto x        = static_cast<T const*>(X);
+                auto c        = plan.mHasC ? static_cast<T const*>(C) : nullptr;
+                for(std::size_t i = 0; i < elements; i++)
+                {
+                    static_cast<T*>(Y)[i] = alphaT * x[i] + (c != nullptr ? betaT * c[i] : T(0));
+                }
+                return HIPTENSOR_STATUS_SUCCESS;
+            }
+
+            // Intermediates alternate between two buffers; the last step writes Y
+            std::vector<T> buffers[2];
+            auto const*    in = static_cast<T const*>(X);
+            for(std::size_t s = 0; s < plan.mSteps.size(); s++)
+            {
+                auto const& step = plan.mSteps[s];
+                auto        last = s + 1 == plan.mSteps.size();
+
+                std::size_t P = 1, Q = 1;
+                for(uint32_t m = 0; m < step.mLengthsIn.size(); m++)
+                {
+                    (m < step.mMode ? P : Q) *= m == step.mMode ? 1 : step.mLengthsIn[m];
+                }
+
+                T* out = static_cast<T*>(Y);
+                if(!last)
+                {
+                    buffers[s % 2].resize(elementsFromLengths(step.mLengthsOut));
+                    out = buffers[s % 2].data();
+                }
+
+                applyMatrix<T>(in,
+                               static_cast<T const*>(U[step.mMatrix]),
+                               out,
+                               P,
+                               step.mLengthsIn[step.mMode],
+                               Q,
+                               step.mLengthsOut[step.mMode],
+                               last ? alphaT : T(1),
+                               last ? betaT : T(0),
+                               last && plan.mHasC ? static_cast<T const*>(C) : nullptr,
+                               threads);
+                in = out;
+            }
+            return HIPTENSOR_STATUS_SUCCESS;
+        }
+    }
+
+    std::size_t multiTtmMultiplyAdds(hiptensorDimVector_t const&     lengths,
+                                     std::vector<uint32_t> const&    modes,
+                                     std::vector<std::size_t> const& ranks,
+                                     std::vector<uint32_t> const&    order)
+    {
+        auto        current = lengths;
+        std::size_t total   = 0;
+        for(auto matrix : order)
+        {
+            total += elementsFromLengths(current) * ranks[matrix];
+            current[modes[matrix]] = ranks[matrix];
+        }
+        return total;
+    }
+
+    hiptensorStatus_t planMultiTtm(MultiTtmPlan*                   plan,
+                                   hipDataType                     type,
+                                   hiptensorDimVector_t const&     lengths,
+                                   std::vector<uint32_t> const&    modes,
+                                   std::vector<std::size_t> const& ranks,
+                                   bool                            hasC)
+    {
+        if(plan == nullptr || modes.size() != ranks.size() || modes.size() > lengths.size())
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+        for(std::size_t j = 0; j < modes.size(); j++)
+        {
+            if(modes[j] >= lengths.size()
+               || std::count(modes.begin(), modes.end(), modes[j]) != 1)
+            {
+                return HIPTENSOR_STATUS_INVALID_VALUE;
+            }
+        }
+
+        plan->mType          = type;
+        plan->mLengths       = lengths;
+        plan->mModes         = modes;
+        plan->mRanks         = ranks;
+        plan->mHasC          = hasC;
+        plan->mWorkspaceSize = 0;
+        plan->mSteps.clear();
+        plan->mDensePlans.clear();
+
+        // The tensor after a set of products only depends on the set, so the best order
+        // of every set extends the best order of one of its subsets by one product
+        auto count      = modes.size();
+        auto sets       = std::size_t{1} << count;
+        auto elementsOf = [&](std::size_t set) {
+            auto current = lengths;
+            for(std::size_t j = 0; j < count; j++)
+            {
+                if(set & (std::size_t{1} << j))
+                {
+                    current[modes[j]] = ranks[j];
+                }
+            }
+            return elementsFromLengths(current);
+        };
+
+        struct Best
+        {
+            std::size_t mMultiplyAdds, mPeak;
+            uint32_t    mLast;
+        };
+        auto              none = std::numeric_limits<std::size_t>::max();
+        std::vector<Best> best(sets, {none, none, 0});
+        best[0] = {0, 0, 0};
+        for(std::size_t set = 1; set < sets; set++)
+        {
+            auto peak = set + 1 == sets ? std::size_t{0} : elementsOf(set);
+            for(uint32_t j = 0; j < count; j++)
+            {
+                auto bit = std::size_t{1} << j;
+                if(!(set & bit))
+                {
+                    continue;
+                }
+
+                auto const& before    = best[set ^ bit];
+                auto        cost      = before.mMultiplyAdds + elementsOf(set ^ bit) * ranks[j];
+                auto        candidate = Best{cost, std::max(before.mPeak, peak), j};
+                if(candidate.mMultiplyAdds < best[set].mMultiplyAdds
+                   || (candidate.mMultiplyAdds == best[set].mMultiplyAdds
+                       && candidate.mPeak < best[set].mPeak))
+                {
+                    best[set] = candidate;
+                }
+            }
+        }
+
+        std::vector<uint32_t> order;
+        for(auto set = sets - 1; set != 0; set ^= std::size_t{1} << best[set].mLast)
+        {
+            order.insert(order.begin(), best[set].mLast);
+        }
+
+        auto current = lengths;
+        for(auto matrix : order)
+        {
+            MultiTtmStep step = {matrix, modes[matrix], current, current};
+            step.mLengthsOut[step.mMode] = ranks[matrix];
+            current                      = step.mLengthsOut;
+            plan->mSteps.push_back(step);
+        }
+        plan->mMultiplyAdds         = best[sets - 1].mMultiplyAdds;
+        plan->mIntermediateElements = best[sets - 1].mPeak;
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t multiTtmHost(MultiTtmPlan const& plan,
+                                   void const*         alpha,
+                                   void const*         X,
+                                   void const* const   U[],
+                                   void const*         beta,
+                                   void const*         C,
+                                   void*               Y,
+                                   uint32_t            threads)
+    {
+        if(threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        if(plan.mType == HIP_R_32F)
+        {
+            return runHost<float>(plan, alpha, X, U, beta, C, Y, threads);
+        }
+        else if(plan.mType == HIP_R_64F)
+        {
+            return runHost<double>(plan, alpha, X, U, beta, C, Y, threads);
+        }
+        return HIPTENSOR_STATUS_NOT_SUPPORTED;
+    }
+
+} // namespace hiptensor
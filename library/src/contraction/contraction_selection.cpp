@@ -40,35 +40,56 @@
 
 namespace hiptensor
 {
+    std::vector<ContractionSolution*>
+        filterByVectorWidth(std::vector<ContractionSolution*> const& candidates,
+                            uint32_t                                 vectorWidth)
+    {
+        std::vector<ContractionSolution*> result;
+        for(auto* solution : candidates)
+        {
+            if(solution->vectorWidth() == vectorWidth)
+            {
+                result.push_back(solution);
+            }
+        }
+        return result;
+    }
+
     hiptensorStatus_t bruteForceModel(ContractionSolution**                    winner,
                                       std::vector<ContractionSolution*> const& candidates,
                                       hipDataType                              typeA,
-                                      std::vector<std::size_t> const&          a_ms_ks_lengths,
-                                      std::vector<std::size_t> const&          a_ms_ks_strides,
+                                      hiptensorDimVector_t const&              a_ms_ks_lengths,
+                                      hiptensorDimVector_t const&              a_ms_ks_strides,
                                       hipDataType                              typeB,
-                                      std::vector<std::size_t> const&          b_ns_ks_lengths,
-                                      std::vector<std::size_t> const&          b_ns_ks_strides,
+                                      hiptensorDimVector_t const&              b_ns_ks_lengths,
+                                      hiptensorDimVector_t const&              b_ns_ks_strides,
                                       hipDataType                              typeD,
-                                      std::vector<std::size_t> const&          d_ms_ns_lengths,
-                                      std::vector<std::size_t> const&          d_ms_ns_strides,
+                                      hiptensorDimVector_t const&              d_ms_ns_lengths,
+                                      hiptensorDimVector_t const&              d_ms_ns_strides,
                                       hipDataType                              typeE,
-                                      std::vector<std::size_t> const&          e_ms_ns_lengths,
-                                      std::vector<std::size_t> const&          e_ms_ns_strides,
-                                      const uint64_t                           workspaceSize)
+                                      hiptensorDimVector_t const&              e_ms_ns_lengths,
+                                      hiptensorDimVector_t const&              e_ms_ns_strides,
+                                      const uint64_t                           workspaceSize,
+                                      SelectionPolicy const&                   policy)
     {
         // Make sure that we calculate full element space incase strides are not packed.
-        auto sizeA = elementSpaceFromLengthsAndStrides(a_ms_ks_lengths, a_ms_ks_strides)
-                     * hipDataTypeSize(typeA);
-        auto sizeB = elementSpaceFromLengthsAndStrides(b_ns_ks_lengths, b_ns_ks_strides)
-                     * hipDataTypeSize(typeB);
-        auto sizeD = 0;
-        if(typeD != NONE_TYPE)
+        // Instances split modes evenly between M and N.
+        auto rank    = e_ms_ns_lengths.size() / 2;
+        auto problem = contractionMetrics(
+            {typeA, typeB, typeD, typeE},
+            {a_ms_ks_lengths, b_ns_ks_lengths, d_ms_ns_lengths, e_ms_ns_lengths},
+            {a_ms_ks_strides, b_ns_ks_strides, d_ms_ns_strides, e_ms_ns_strides},
+            rank,
+            rank);
+        if(problem.mSaturated)
         {
-            sizeD = elementSpaceFromLengthsAndStrides(d_ms_ns_lengths, d_ms_ns_strides)
-                    * hipDataTypeSize(typeD);
+            // Operands larger than the address space cannot be allocated for timing
+            return HIPTENSOR_STATUS_ALLOC_FAILED;
         }
-        auto sizeE = elementSpaceFromLengthsAndStrides(e_ms_ns_lengths, e_ms_ns_strides)
-                     * hipDataTypeSize(typeE);
+        auto sizeA = problem.mOperandBytes[0];
+        auto sizeB = problem.mOperandBytes[1];
+        auto sizeD = problem.mOperandBytes[2];
+        auto sizeE = problem.mOperandBytes[3];
 
         void *A_d, *B_d, *D_d, *E_d, *wspace;
         float alpha = 1.02f;
@@ -78,17 +99,13 @@ namespace hiptensor
         CHECK_HIP_ALLOC(hipMalloc(&B_d, sizeB));
         CHECK_HIP_ALLOC(hipMalloc(&D_d, sizeD));
         CHECK_HIP_ALLOC(hipMalloc(&E_d, sizeE));
-        CHECK_HIP_ALLOC(hipMalloc(&wspace, workspaceSize));
 
-        std::string          best_op_name;
-        ContractionSolution* bestSolution = nullptr;
-        PerfMetrics          bestMetrics  = {
-            0,
-            "",
-            0,
-            0,
-            0,
-        };
+        // Candidates beyond the policy's workspace cap are not worth timing
+        auto availableSize = std::min(workspaceSize, policy.mWorkspaceCap);
+        CHECK_HIP_ALLOC(hipMalloc(&wspace, availableSize));
+
+        std::vector<ContractionSolution*> measured;
+        std::vector<SelectionSample>      samples;
 
         for(auto* solution : candidates)
         {
@@ -107,28 +124,15 @@ namespace hiptensor
                                   e_ms_ns_lengths,
                                   e_ms_ns_strides,
                                   wspace)
-               && solution->workspaceSize() <= workspaceSize)
+               && solution->workspaceSize() <= availableSize)
             {
                 // Make sure to time the kernels
-                auto    time = (*solution)(StreamConfig{nullptr, true});
-                int32_t m, n, k;
-                std::tie(m, n, k) = solution->problemDims();
-                auto flops        = std::size_t(2) * m * n * k;
-                auto bytes        = solution->problemBytes();
+                auto time    = (*solution)(StreamConfig{nullptr, true});
+                auto metrics = perfMetrics(
+                    solution->uid(), solution->kernelName(), time, solution->problemMetrics());
 
-                PerfMetrics metrics = {
-                    solution->uid(), // id
-                    solution->kernelName(), // name
-                    time, // avg time
-                    static_cast<float>(flops) / static_cast<float>(1.E9) / time, // tflops
-                    static_cast<float>(bytes) / static_cast<float>(1.E6) / time // BW
-                };
-
-                if(metrics > bestMetrics)
-                {
-                    bestSolution = solution;
-                    bestMetrics  = metrics;
-                }
+                measured.push_back(solution);
+                samples.push_back({metrics, solution->workspaceSize(), problem.mBytes});
             }
         }
 
@@ -138,9 +142,10 @@ namespace hiptensor
         CHECK_HIP_ALLOC(hipFree(E_d));
         CHECK_HIP_ALLOC(hipFree(wspace));
 
-        *winner = bestSolution;
+        auto best = selectSample(samples, policy);
+        *winner   = best < 0 ? nullptr : measured[best];
 
-        if(bestSolution == nullptr)
+        if(*winner == nullptr)
         {
             return HIPTENSOR_STATUS_EXECUTION_FAILED;
         }
@@ -157,17 +162,17 @@ namespace hiptensor
             selectWinner(ContractionSolution**                                   winner,
                          std::unordered_map<size_t, ContractionSolution*> const& candidates,
                          hipDataType                                             typeA,
-                         std::vector<std::size_t> const&                         a_ms_ks_lengths,
-                         std::vector<std::size_t> const&                         a_ms_ks_strides,
+                         hiptensorDimVector_t const&                             a_ms_ks_lengths,
+                         hiptensorDimVector_t const&                             a_ms_ks_strides,
                          hipDataType                                             typeB,
-                         std::vector<std::size_t> const&                         b_ns_ks_lengths,
-                         std::vector<std::size_t> const&                         b_ns_ks_strides,
+                         hiptensorDimVector_t const&                             b_ns_ks_lengths,
+                         hiptensorDimVector_t const&                             b_ns_ks_strides,
                          hipDataType                                             typeD,
-                         std::vector<std::size_t> const&                         d_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         d_ms_ns_strides,
+                         hiptensorDimVector_t const&                             d_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             d_ms_ns_strides,
                          hipDataType                                             typeE,
-                         std::vector<std::size_t> const&                         e_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         e_ms_ns_strides,
+                         hiptensorDimVector_t const&                             e_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             e_ms_ns_strides,
                          const uint64_t                                          workspaceSize)
         {
             int d1 = a_ms_ks_lengths[0];
@@ -522,17 +527,17 @@ namespace hiptensor
             selectWinner(ContractionSolution**                                   winner,
                          std::unordered_map<size_t, ContractionSolution*> const& candidates,
                          hipDataType                                             typeA,
-                         std::vector<std::size_t> const&                         a_ms_ks_lengths,
-                         std::vector<std::size_t> const&                         a_ms_ks_strides,
+                         hiptensorDimVector_t const&                             a_ms_ks_lengths,
+                         hiptensorDimVector_t const&                             a_ms_ks_strides,
                          hipDataType                                             typeB,
-                         std::vector<std::size_t> const&                         b_ns_ks_lengths,
-                         std::vector<std::size_t> const&                         b_ns_ks_strides,
+                         hiptensorDimVector_t const&                             b_ns_ks_lengths,
+                         hiptensorDimVector_t const&                             b_ns_ks_strides,
                          hipDataType                                             typeD,
-                         std::vector<std::size_t> const&                         d_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         d_ms_ns_strides,
+                         hiptensorDimVector_t const&                             d_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             d_ms_ns_strides,
                          hipDataType                                             typeE,
-                         std::vector<std::size_t> const&                         e_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         e_ms_ns_strides,
+                         hiptensorDimVector_t const&                             e_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             e_ms_ns_strides,
                          const uint64_t                                          workspaceSize)
         {
             int d1 = a_ms_ks_lengths[0];
@@ -880,17 +885,17 @@ namespace hiptensor
             selectWinner(ContractionSolution**                                   winner,
                          std::unordered_map<size_t, ContractionSolution*> const& candidates,
                          hipDataType                                             typeA,
-                         std::vector<std::size_t> const&                         a_ms_ks_lengths,
-                         std::vector<std::size_t> const&                         a_ms_ks_strides,
+                         hiptensorDimVector_t const&                             a_ms_ks_lengths,
+                         hiptensorDimVector_t const&                             a_ms_ks_strides,
                          hipDataType                                             typeB,
-                         std::vector<std::size_t> const&                         b_ns_ks_lengths,
-                         std::vector<std::size_t> const&                         b_ns_ks_strides,
+                         hiptensorDimVector_t const&                             b_ns_ks_lengths,
+                         hiptensorDimVector_t const&                             b_ns_ks_strides,
                          hipDataType                                             typeD,
-                         std::vector<std::size_t> const&                         d_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         d_ms_ns_strides,
+                         hiptensorDimVector_t const&                             d_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             d_ms_ns_strides,
                          hipDataType                                             typeE,
-                         std::vector<std::size_t> const&                         e_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         e_ms_ns_strides,
+                         hiptensorDimVector_t const&                             e_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             e_ms_ns_strides,
                          const uint64_t                                          workspaceSize)
         {
 
@@ -1155,17 +1160,17 @@ namespace hiptensor
             selectWinner(ContractionSolution**                                   winner,
                          std::unordered_map<size_t, ContractionSolution*> const& candidates,
                          hipDataType                                             typeA,
-                         std::vector<std::size_t> const&                         a_ms_ks_lengths,
-                         std::vector<std::size_t> const&                         a_ms_ks_strides,
+                         hiptensorDimVector_t const&                             a_ms_ks_lengths,
+                         hiptensorDimVector_t const&                             a_ms_ks_strides,
                          hipDataType                                             typeB,
-                         std::vector<std::size_t> const&                         b_ns_ks_lengths,
-                         std::vector<std::size_t> const&                         b_ns_ks_strides,
+                         hiptensorDimVector_t const&                             b_ns_ks_lengths,
+                         hiptensorDimVector_t const&                             b_ns_ks_strides,
                          hipDataType                                             typeD,
-                         std::vector<std::size_t> const&                         d_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         d_ms_ns_strides,
+                         hiptensorDimVector_t const&                             d_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             d_ms_ns_strides,
                          hipDataType                                             typeE,
-                         std::vector<std::size_t> const&                         e_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         e_ms_ns_strides,
+                         hiptensorDimVector_t const&                             e_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             e_ms_ns_strides,
                          const uint64_t                                          workspaceSize)
         {
             int d1 = a_ms_ks_lengths[0];
@@ -1405,17 +1410,17 @@ namespace hiptensor
         actorCriticModel(ContractionSolution**                                   winner,
                          std::unordered_map<size_t, ContractionSolution*> const& candidates,
                          hipDataType                                             typeA,
-                         std::vector<std::size_t> const&                         a_ms_ks_lengths,
-                         std::vector<std::size_t> const&                         a_ms_ks_strides,
+                         hiptensorDimVector_t const&                             a_ms_ks_lengths,
+                         hiptensorDimVector_t const&                             a_ms_ks_strides,
                          hipDataType                                             typeB,
-                         std::vector<std::size_t> const&                         b_ns_ks_lengths,
-                         std::vector<std::size_t> const&                         b_ns_ks_strides,
+                         hiptensorDimVector_t const&                             b_ns_ks_lengths,
+                         hiptensorDimVector_t const&                             b_ns_ks_strides,
                          hipDataType                                             typeD,
-                         std::vector<std::size_t> const&                         d_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         d_ms_ns_strides,
+                         hiptensorDimVector_t const&                             d_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             d_ms_ns_strides,
                          hipDataType                                             typeE,
-                         std::vector<std::size_t> const&                         e_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         e_ms_ns_strides,
+                         hiptensorDimVector_t const&                             e_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             e_ms_ns_strides,
                          const uint64_t                                          workspaceSize)
     {
         if(typeA == HIP_R_32F && typeB == HIP_R_32F && typeD == NONE_TYPE && typeE == HIP_R_32F)
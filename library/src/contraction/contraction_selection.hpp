@@ -35,21 +35,27 @@ namespace hiptensor
     class ContractionSolution;
     struct PerfMetrics;
 
+    // Candidates whose global vector access is exactly vectorWidth elements wide
+    std::vector<ContractionSolution*>
+        filterByVectorWidth(std::vector<ContractionSolution*> const& candidates,
+                            uint32_t                                 vectorWidth);
+
     hiptensorStatus_t bruteForceModel(ContractionSolution**                    winner,
                                       std::vector<ContractionSolution*> const& candidates,
                                       hipDataType                              typeA,
-                                      std::vector<std::size_t> const&          a_ms_ks_lengths,
-                                      std::vector<std::size_t> const&          a_ms_ks_strides,
+                                      hiptensorDimVector_t const&              a_ms_ks_lengths,
+                                      hiptensorDimVector_t const&              a_ms_ks_strides,
                                       hipDataType                              typeB,
-                                      std::vector<std::size_t> const&          b_ns_ks_lengths,
-                                      std::vector<std::size_t> const&          b_ns_ks_strides,
+                                      hiptensorDimVector_t const&              b_ns_ks_lengths,
+                                      hiptensorDimVector_t const&              b_ns_ks_strides,
                                       hipDataType                              typeD,
-                                      std::vector<std::size_t> const&          d_ms_ns_lengths,
-                                      std::vector<std::size_t> const&          d_ms_ns_strides,
+                                      hiptensorDimVector_t const&              d_ms_ns_lengths,
+                                      hiptensorDimVector_t const&              d_ms_ns_strides,
                                       hipDataType                              typeE,
-                                      std::vector<std::size_t> const&          e_ms_ns_lengths,
-                                      std::vector<std::size_t> const&          e_ms_ns_strides,
-                                      const uint64_t                           workspaceSize);
+                                      hiptensorDimVector_t const&              e_ms_ns_lengths,
+                                      hiptensorDimVector_t const&              e_ms_ns_strides,
+                                      const uint64_t                           workspaceSize,
+                                      SelectionPolicy const&                   policy = {});
 
     template <typename A, typename B, typename C, typename D, ContractionOpId_t ContractionOp>
     struct ActorCriticSelection
@@ -58,17 +64,17 @@ namespace hiptensor
             selectWinner(ContractionSolution**                                   winner,
                          std::unordered_map<size_t, ContractionSolution*> const& candidates,
                          hipDataType                                             typeA,
-                         std::vector<std::size_t> const&                         a_ms_ks_lengths,
-                         std::vector<std::size_t> const&                         a_ms_ks_strides,
+                         hiptensorDimVector_t const&                             a_ms_ks_lengths,
+                         hiptensorDimVector_t const&                             a_ms_ks_strides,
                          hipDataType                                             typeB,
-                         std::vector<std::size_t> const&                         b_ns_ks_lengths,
-                         std::vector<std::size_t> const&                         b_ns_ks_strides,
+                         hiptensorDimVector_t const&                             b_ns_ks_lengths,
+                         hiptensorDimVector_t const&                             b_ns_ks_strides,
                          hipDataType                                             typeD,
-                         std::vector<std::size_t> const&                         d_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         d_ms_ns_strides,
+                         hiptensorDimVector_t const&                             d_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             d_ms_ns_strides,
                          hipDataType                                             typeE,
-                         std::vector<std::size_t> const&                         e_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         e_ms_ns_strides,
+                         hiptensorDimVector_t const&                             e_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             e_ms_ns_strides,
                          const uint64_t                                          workspaceSize);
     };
 
@@ -76,17 +82,17 @@ namespace hiptensor
         actorCriticModel(ContractionSolution**                                   winner,
                          std::unordered_map<size_t, ContractionSolution*> const& candidates,
                          hipDataType                                             typeA,
-                         std::vector<std::size_t> const&                         a_ms_ks_lengths,
-                         std::vector<std::size_t> const&                         a_ms_ks_strides,
+                         hiptensorDimVector_t const&                             a_ms_ks_lengths,
+                         hiptensorDimVector_t const&                             a_ms_ks_strides,
                          hipDataType                                             typeB,
-                         std::vector<std::size_t> const&                         b_ns_ks_lengths,
-                         std::vector<std::size_t> const&                         b_ns_ks_strides,
+                         hiptensorDimVector_t const&                             b_ns_ks_lengths,
+                         hiptensorDimVector_t const&                             b_ns_ks_strides,
                          hipDataType                                             typeD,
-                         std::vector<std::size_t> const&                         d_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         d_ms_ns_strides,
+                         hiptensorDimVector_t const&                             d_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             d_ms_ns_strides,
                          hipDataType                                             typeE,
-                         std::vector<std::size_t> const&                         e_ms_ns_lengths,
-                         std::vector<std::size_t> const&                         e_ms_ns_strides,
+                         hiptensorDimVector_t const&                             e_ms_ns_lengths,
+                         hiptensorDimVector_t const&                             e_ms_ns_strides,
                          const uint64_t                                          workspaceSize);
 
 } // namespace hiptensor
@@ -31,23 +31,20 @@ namespace hiptensor
 
     ContractionSolution::ContractionSolution(
         std::unique_ptr<ck::tensor_operation::device::BaseOperator>&& deviceOp,
-        std::unique_ptr<ContractionSolutionParams>&&                  params)
-        : mM(0)
-        , mN(0)
-        , mK(0)
-        , mBytes(0)
+        std::unique_ptr<ContractionSolutionParams>&&                  params,
+        uint32_t                                                      vectorWidth)
+        : mMetrics{}
         , mValid(false)
+        , mVectorWidth(vectorWidth)
         , mDeviceOp(std::move(deviceOp))
         , mParams(std::move(params))
     {
     }
 
     ContractionSolution::ContractionSolution(ContractionSolution&& other)
-        : mM(other.mM)
-        , mN(other.mN)
-        , mK(other.mK)
-        , mBytes(other.mBytes)
+        : mMetrics(other.mMetrics)
         , mValid(other.mValid)
+        , mVectorWidth(other.mVectorWidth)
         , mDeviceOp(std::move(other.mDeviceOp))
         , mParams(std::move(other.mParams))
         , mArgPtr(std::move(other.mArgPtr))
@@ -59,12 +56,9 @@ namespace hiptensor
     {
         if(this != &other)
         {
-            mM = other.mM;
-            mN = other.mN;
-            mK = other.mK;
-
-            mBytes = other.mBytes;
-            mValid = other.mValid;
+            mMetrics     = other.mMetrics;
+            mValid       = other.mValid;
+            mVectorWidth = other.mVectorWidth;
 
             mParams     = std::move(other.mParams);
             mDeviceOp   = std::move(other.mDeviceOp);
@@ -95,21 +89,21 @@ namespace hiptensor
         return mInvokerPtr->Run(mArgPtr.get(), streamConfig);
     }
 
-    float ContractionSolution::operator()(void const*                     alpha,
-                                          void const*                     A,
-                                          void const*                     B,
-                                          void const*                     beta,
-                                          void const*                     D,
-                                          void*                           E,
-                                          std::vector<std::size_t> const& a_ms_ns_lengths,
-                                          std::vector<std::size_t> const& a_ms_ks_strides,
-                                          std::vector<std::size_t> const& b_ns_ks_lengths,
-                                          std::vector<std::size_t> const& b_ns_ks_strides,
-                                          std::vector<std::size_t> const& ds_ms_ns_lengths,
-                                          std::vector<std::size_t> const& ds_ms_ns_strides,
-                                          std::vector<std::size_t> const& e_ms_ns_lengths,
-                                          std::vector<std::size_t> const& e_ms_ns_strides,
-                                          void*                           workspacePtr,
+    float ContractionSolution::operator()(void const*                 alpha,
+                                          void const*                 A,
+                                          void const*                 B,
+                                          void const*                 beta,
+                                          void const*                 D,
+                                          void*                       E,
+                                          hiptensorDimVector_t const& a_ms_ns_lengths,
+                                          hiptensorDimVector_t const& a_ms_ks_strides,
+                                          hiptensorDimVector_t const& b_ns_ks_lengths,
+                                          hiptensorDimVector_t const& b_ns_ks_strides,
+                                          hiptensorDimVector_t const& ds_ms_ns_lengths,
+                                          hiptensorDimVector_t const& ds_ms_ns_strides,
+                                          hiptensorDimVector_t const& e_ms_ns_lengths,
+                                          hiptensorDimVector_t const& e_ms_ns_strides,
+                                          void*                       workspacePtr,
                                           StreamConfig const& streamConfig /*= StreamConfig{}*/)
     {
         if(!initArgs(alpha,
@@ -156,14 +150,14 @@ namespace hiptensor
         return value;
     }
 
-    std::tuple<ck::index_t, ck::index_t, ck::index_t> ContractionSolution::problemDims() const
+    uint32_t ContractionSolution::vectorWidth() const
     {
-        return std::make_tuple(mM, mN, mK);
+        return mVectorWidth;
     }
 
-    ck::index_t ContractionSolution::problemBytes() const
+    ProblemMetrics const& ContractionSolution::problemMetrics() const
     {
-        return mBytes;
+        return mMetrics;
     }
 
     std::string ContractionSolution::kernelName() const
@@ -185,10 +179,7 @@ namespace hiptensor
 
     void ContractionSolution::resetArgs()
     {
-        mM     = 0;
-        mN     = 0;
-        mK     = 0;
-        mBytes = 0;
+        mMetrics = {};
 
         mArgPtr.reset(nullptr);
         mInvokerPtr.reset(nullptr);
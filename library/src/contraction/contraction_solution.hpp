@@ -58,46 +58,47 @@ namespace hiptensor
         // This class is intended to receive DeviceOp kernel pointers from
         // the CK generator and take ownership.
         ContractionSolution(std::unique_ptr<ck::tensor_operation::device::BaseOperator>&& deviceOp,
-                            std::unique_ptr<ContractionSolutionParams>&&                  params);
+                            std::unique_ptr<ContractionSolutionParams>&&                  params,
+                            uint32_t vectorWidth);
         ContractionSolution(ContractionSolution&& other);
         ContractionSolution& operator=(ContractionSolution&& other);
 
         // Must specialize incoming arg handling
-        virtual bool initArgs(void const*                     alpha,
-                              void const*                     A,
-                              void const*                     B,
-                              void const*                     beta,
-                              void const*                     D,
-                              void*                           E,
-                              std::vector<std::size_t> const& a_ms_ns_lengths,
-                              std::vector<std::size_t> const& a_ms_ks_strides,
-                              std::vector<std::size_t> const& b_ns_ks_lengths,
-                              std::vector<std::size_t> const& b_ns_ks_strides,
-                              std::vector<std::size_t> const& ds_ms_ns_lengths,
-                              std::vector<std::size_t> const& ds_ms_ns_strides,
-                              std::vector<std::size_t> const& e_ms_ns_lengths,
-                              std::vector<std::size_t> const& e_ms_ns_strides,
-                              void*                           workspacePtr)
+        virtual bool initArgs(void const*                 alpha,
+                              void const*                 A,
+                              void const*                 B,
+                              void const*                 beta,
+                              void const*                 D,
+                              void*                       E,
+                              hiptensorDimVector_t const& a_ms_ns_lengths,
+                              hiptensorDimVector_t const& a_ms_ks_strides,
+                              hiptensorDimVector_t const& b_ns_ks_lengths,
+                              hiptensorDimVector_t const& b_ns_ks_strides,
+                              hiptensorDimVector_t const& ds_ms_ns_lengths,
+                              hiptensorDimVector_t const& ds_ms_ns_strides,
+                              hiptensorDimVector_t const& e_ms_ns_lengths,
+                              hiptensorDimVector_t const& e_ms_ns_strides,
+                              void*                       workspacePtr)
             = 0;
 
         float operator()(StreamConfig const& streamConfig = StreamConfig{});
 
-        float operator()(void const*                     alpha,
-                         void const*                     A,
-                         void const*                     B,
-                         void const*                     beta,
-                         void const*                     D,
-                         void*                           E,
-                         std::vector<std::size_t> const& a_ms_ns_lengths,
-                         std::vector<std::size_t> const& a_ms_ks_strides,
-                         std::vector<std::size_t> const& b_ns_ks_lengths,
-                         std::vector<std::size_t> const& b_ns_ks_strides,
-                         std::vector<std::size_t> const& ds_ms_ns_lengths,
-                         std::vector<std::size_t> const& ds_ms_ns_strides,
-                         std::vector<std::size_t> const& e_ms_ns_lengths,
-                         std::vector<std::size_t> const& e_ms_ns_strides,
-                         void*                           workspacePtr,
-                         StreamConfig const&             streamConfig = StreamConfig{});
+        float operator()(void const*                 alpha,
+                         void const*                 A,
+                         void const*                 B,
+                         void const*                 beta,
+                         void const*                 D,
+                         void*                       E,
+                         hiptensorDimVector_t const& a_ms_ns_lengths,
+                         hiptensorDimVector_t const& a_ms_ks_strides,
+                         hiptensorDimVector_t const& b_ns_ks_lengths,
+                         hiptensorDimVector_t const& b_ns_ks_strides,
+                         hiptensorDimVector_t const& ds_ms_ns_lengths,
+                         hiptensorDimVector_t const& ds_ms_ns_strides,
+                         hiptensorDimVector_t const& e_ms_ns_lengths,
+                         hiptensorDimVector_t const& e_ms_ns_strides,
+                         void*                       workspacePtr,
+                         StreamConfig const&         streamConfig = StreamConfig{});
 
         /// Accessors
 
@@ -110,11 +111,11 @@ namespace hiptensor
         // Unique ID for the kernel
         size_t uid() const;
 
-        // Problem dimensions
-        std::tuple<ck::index_t, ck::index_t, ck::index_t> problemDims() const;
+        // Elements per global vector access of the A, B and D/E operands
+        uint32_t vectorWidth() const;
 
-        // Byte count
-        ck::index_t problemBytes() const;
+        // Problem dimensions, flop and byte counts of the initialized arguments
+        ProblemMetrics const& problemMetrics() const;
 
         // Kernel's name encoding
         std::string kernelName() const;
@@ -126,10 +127,11 @@ namespace hiptensor
         void resetArgs();
 
     protected:
-        // Derived runtime arguments
-        ck::index_t mM, mN, mK;
-        ck::index_t mBytes;
-        bool        mValid;
+        // Derived runtime arguments.
+        // Problem sizes are kept in 64 bits even though kernels index in 32 bits.
+        ProblemMetrics mMetrics;
+        bool           mValid;
+        uint32_t       mVectorWidth;
 
         // Kernel Params
         std::unique_ptr<ContractionSolutionParams>                  mParams;
@@ -148,7 +150,14 @@ namespace hiptensor
               typename AElementwiseOperation,
               typename BElementwiseOperation,
               typename CDEElementwiseOperation>
-    std::vector<std::unique_ptr<hiptensor::ContractionSolution>> enumerateContractionSolutions();
+    std::vector<std::unique_ptr<hiptensor::ContractionSolution>>
+        enumerateContractionSolutions(uint32_t vectorWidth);
+
+    // Wraps a family of device ops that share the same vector width
+    template <typename DeviceOp>
+    std::vector<std::unique_ptr<hiptensor::ContractionSolution>>
+        wrapContractionSolutions(std::vector<std::unique_ptr<DeviceOp>>&& deviceOps,
+                                 uint32_t                                 vectorWidth);
 
 } // namespace hiptensor
 
@@ -31,6 +31,7 @@
 
 #include "contraction_solution.hpp"
 #include "hash.hpp"
+#include "util.hpp"
 
 namespace std
 {
@@ -57,27 +58,28 @@ namespace hiptensor
         : public ContractionSolution
     {
     public:
-        ContractionSolutionImpl(std::unique_ptr<DeviceOp>&& deviceOp)
+        ContractionSolutionImpl(std::unique_ptr<DeviceOp>&& deviceOp, uint32_t vectorWidth)
             : ContractionSolution(std::move(deviceOp),
-                                  std::make_unique<ContractionSolutionParamsImpl<DeviceOp>>())
+                                  std::make_unique<ContractionSolutionParamsImpl<DeviceOp>>(),
+                                  vectorWidth)
         {
         }
 
-        bool initArgs(void const*                     alpha,
-                      void const*                     A,
-                      void const*                     B,
-                      void const*                     beta,
-                      void const*                     D,
-                      void*                           E,
-                      std::vector<std::size_t> const& a_ms_ks_lengths,
-                      std::vector<std::size_t> const& a_ms_ks_strides,
-                      std::vector<std::size_t> const& b_ns_ks_lengths,
-                      std::vector<std::size_t> const& b_ns_ks_strides,
-                      std::vector<std::size_t> const& ds_ms_ns_lengths,
-                      std::vector<std::size_t> const& ds_ms_ns_strides,
-                      std::vector<std::size_t> const& e_ms_ns_lengths,
-                      std::vector<std::size_t> const& e_ms_ns_strides,
-                      void*                           workspacePtr) override
+        bool initArgs(void const*                 alpha,
+                      void const*                 A,
+                      void const*                 B,
+                      void const*                 beta,
+                      void const*                 D,
+                      void*                       E,
+                      hiptensorDimVector_t const& a_ms_ks_lengths,
+                      hiptensorDimVector_t const& a_ms_ks_strides,
+                      hiptensorDimVector_t const& b_ns_ks_lengths,
+                      hiptensorDimVector_t const& b_ns_ks_strides,
+                      hiptensorDimVector_t const& ds_ms_ns_lengths,
+                      hiptensorDimVector_t const& ds_ms_ns_strides,
+                      hiptensorDimVector_t const& e_ms_ns_lengths,
+                      hiptensorDimVector_t const& e_ms_ns_strides,
+                      void*                       workspacePtr) override
         {
             using Base   = ContractionSolution;
             using Traits = MetaTraits<DeviceOp>;
@@ -102,8 +104,21 @@ namespace hiptensor
                 betaF = hiptensor::readVal<float>(beta, HipDataType_v<typename Traits::EDataT>);
             }
 
+            // Kernels index with 32-bit offsets; larger operands must be partitioned first
+            using ADataT = typename Traits::ADataT;
+            using BDataT = typename Traits::BDataT;
+            using DDataT = typename Traits::DDataT;
+            using EDataT = typename Traits::EDataT;
+            if(!fitsKernelIndexing(a_ms_ks_lengths, a_ms_ks_strides, sizeof(ADataT))
+               || !fitsKernelIndexing(b_ns_ks_lengths, b_ns_ks_strides, sizeof(BDataT))
+               || !fitsKernelIndexing(ds_ms_ns_lengths, ds_ms_ns_strides, sizeof(DDataT))
+               || !fitsKernelIndexing(e_ms_ns_lengths, e_ms_ns_strides, sizeof(EDataT)))
+            {
+                return false;
+            }
+
             // CK has its own format for indices...
-            auto toCKVec = [](std::vector<std::size_t> const& v) {
+            auto toCKVec = [](hiptensorDimVector_t const& v) {
                 return std::vector<ck::index_t>(v.begin(), v.end());
             };
 
@@ -132,26 +147,20 @@ namespace hiptensor
             Base::mInvokerPtr = std::move(deviceOp->MakeInvokerPointer());
 
             // Fill problem metrics
-            Base::mM = std::accumulate(e_ms_ns_lengths.begin(),
-                                       e_ms_ns_lengths.begin() + Traits::DimsM,
-                                       ck::index_t{1},
-                                       std::multiplies<ck::index_t>{});
-
-            Base::mN = std::accumulate(e_ms_ns_lengths.begin() + Traits::DimsM,
-                                       e_ms_ns_lengths.begin() + Traits::DimsM + Traits::DimsN,
-                                       ck::index_t{1},
-                                       std::multiplies<ck::index_t>{});
-
-            Base::mK = std::accumulate(a_ms_ks_lengths.begin() + Traits::DimsM,
-                                       a_ms_ks_lengths.begin() + Traits::DimsM + Traits::DimsK,
-                                       ck::index_t{1},
-                                       std::multiplies<ck::index_t>{});
-
-            // Byte count
-            Base::mBytes = sizeof(typename Traits::ADataT) * Base::mM * Base::mK
-                           + sizeof(typename Traits::BDataT) * Base::mK * Base::mN
-                           + sizeof(typename Traits::DDataT) * Base::mM * Base::mN
-                           + sizeof(typename Traits::EDataT) * Base::mM * Base::mN;
+            Base::mMetrics = contractionMetrics({HipDataType_v<ADataT>,
+                                                 HipDataType_v<BDataT>,
+                                                 HipDataType_v<DDataT>,
+                                                 HipDataType_v<EDataT>},
+                                                {a_ms_ks_lengths,
+                                                 b_ns_ks_lengths,
+                                                 ds_ms_ns_lengths,
+                                                 e_ms_ns_lengths},
+                                                {a_ms_ks_strides,
+                                                 b_ns_ks_strides,
+                                                 ds_ms_ns_strides,
+                                                 e_ms_ns_strides},
+                                                Traits::DimsM,
+                                                Traits::DimsN);
 
             // Arg test
             Base::mValid = deviceOp->IsSupportedArgument(Base::mArgPtr.get());
@@ -168,27 +177,28 @@ namespace hiptensor
         : public ContractionSolution
     {
     public:
-        ContractionSolutionImpl(std::unique_ptr<DeviceOp>&& deviceOp)
+        ContractionSolutionImpl(std::unique_ptr<DeviceOp>&& deviceOp, uint32_t vectorWidth)
             : ContractionSolution(std::move(deviceOp),
-                                  std::make_unique<ContractionSolutionParamsImpl<DeviceOp>>())
+                                  std::make_unique<ContractionSolutionParamsImpl<DeviceOp>>(),
+                                  vectorWidth)
         {
         }
 
-        bool initArgs(void const*                     alpha,
-                      void const*                     A,
-                      void const*                     B,
-                      void const*                     beta,
-                      void const*                     D,
-                      void*                           E,
-                      std::vector<std::size_t> const& a_ms_ks_lengths,
-                      std::vector<std::size_t> const& a_ms_ks_strides,
-                      std::vector<std::size_t> const& b_ns_ks_lengths,
-                      std::vector<std::size_t> const& b_ns_ks_strides,
-                      std::vector<std::size_t> const& ds_ms_ns_lengths,
-                      std::vector<std::size_t> const& ds_ms_ns_strides,
-                      std::vector<std::size_t> const& e_ms_ns_lengths,
-                      std::vector<std::size_t> const& e_ms_ns_strides,
-                      void*                           workspacePtr) override
+        bool initArgs(void const*                 alpha,
+                      void const*                 A,
+                      void const*                 B,
+                      void const*                 beta,
+                      void const*                 D,
+                      void*                       E,
+                      hiptensorDimVector_t const& a_ms_ks_lengths,
+                      hiptensorDimVector_t const& a_ms_ks_strides,
+                      hiptensorDimVector_t const& b_ns_ks_lengths,
+                      hiptensorDimVector_t const& b_ns_ks_strides,
+                      hiptensorDimVector_t const& ds_ms_ns_lengths,
+                      hiptensorDimVector_t const& ds_ms_ns_strides,
+                      hiptensorDimVector_t const& e_ms_ns_lengths,
+                      hiptensorDimVector_t const& e_ms_ns_strides,
+                      void*                       workspacePtr) override
         {
             using Base   = ContractionSolution;
             using Traits = MetaTraits<DeviceOp>;
@@ -208,8 +218,19 @@ namespace hiptensor
                 alphaF = hiptensor::readVal<float>(alpha, HipDataType_v<typename Traits::EDataT>);
             }
 
+            // Kernels index with 32-bit offsets; larger operands must be partitioned first
+            using ADataT = typename Traits::ADataT;
+            using BDataT = typename Traits::BDataT;
+            using EDataT = typename Traits::EDataT;
+            if(!fitsKernelIndexing(a_ms_ks_lengths, a_ms_ks_strides, sizeof(ADataT))
+               || !fitsKernelIndexing(b_ns_ks_lengths, b_ns_ks_strides, sizeof(BDataT))
+               || !fitsKernelIndexing(e_ms_ns_lengths, e_ms_ns_strides, sizeof(EDataT)))
+            {
+                return false;
+            }
+
             // CK has its own format for indices...
-            auto toCKVec = [](std::vector<std::size_t> const& v) {
+            auto toCKVec = [](hiptensorDimVector_t const& v) {
                 return std::vector<ck::index_t>(v.begin(), v.end());
             };
 
@@ -238,25 +259,12 @@ namespace hiptensor
             Base::mInvokerPtr = std::move(deviceOp->MakeInvokerPointer());
 
             // Fill problem metrics
-            Base::mM = std::accumulate(e_ms_ns_lengths.begin(),
-                                       e_ms_ns_lengths.begin() + Traits::DimsM,
-                                       ck::index_t{1},
-                                       std::multiplies<ck::index_t>{});
-
-            Base::mN = std::accumulate(e_ms_ns_lengths.begin() + Traits::DimsM,
-                                       e_ms_ns_lengths.begin() + Traits::DimsM + Traits::DimsN,
-                                       ck::index_t{1},
-                                       std::multiplies<ck::index_t>{});
-
-            Base::mK = std::accumulate(a_ms_ks_lengths.begin() + Traits::DimsM,
-                                       a_ms_ks_lengths.begin() + Traits::DimsM + Traits::DimsK,
-                                       ck::index_t{1},
-                                       std::multiplies<ck::index_t>{});
-
-            // Byte count
-            Base::mBytes = sizeof(typename Traits::ADataT) * Base::mM * Base::mK
-                           + sizeof(typename Traits::BDataT) * Base::mK * Base::mN
-                           + sizeof(typename Traits::EDataT) * Base::mM * Base::mN;
+            Base::mMetrics = contractionMetrics(
+                {HipDataType_v<ADataT>, HipDataType_v<BDataT>, NONE_TYPE, HipDataType_v<EDataT>},
+                {a_ms_ks_lengths, b_ns_ks_lengths, {}, e_ms_ns_lengths},
+                {a_ms_ks_strides, b_ns_ks_strides, {}, e_ms_ns_strides},
+                Traits::DimsM,
+                Traits::DimsN);
 
             // Arg test
             Base::mValid = deviceOp->IsSupportedArgument(Base::mArgPtr.get());
@@ -275,7 +283,8 @@ namespace hiptensor
               typename AElementwiseOperation,
               typename BElementwiseOperation,
               typename CDEElementwiseOperation>
-    std::vector<std::unique_ptr<hiptensor::ContractionSolution>> enumerateContractionSolutions()
+    std::vector<std::unique_ptr<hiptensor::ContractionSolution>>
+        enumerateContractionSolutions(uint32_t vectorWidth)
     {
         using ContractionOp
             = ck::tensor_operation::device::DeviceContractionMultipleD<NumDimM,
@@ -292,11 +301,19 @@ namespace hiptensor
         using Factory
             = ck::tensor_operation::device::instance::DeviceOperationInstanceFactory<ContractionOp>;
 
+        return wrapContractionSolutions(Factory::GetInstances(), vectorWidth);
+    }
+
+    template <typename DeviceOp>
+    std::vector<std::unique_ptr<hiptensor::ContractionSolution>>
+        wrapContractionSolutions(std::vector<std::unique_ptr<DeviceOp>>&& deviceOps,
+                                 uint32_t                                 vectorWidth)
+    {
         std::vector<std::unique_ptr<ContractionSolution>> result;
-        for(auto& opPtr : Factory::GetInstances())
+        for(auto& opPtr : deviceOps)
         {
-            result.push_back(
-                std::make_unique<ContractionSolutionImpl<ContractionOp>>(std::move(opPtr)));
+            result.push_back(std::make_unique<ContractionSolutionImpl<DeviceOp>>(std::move(opPtr),
+                                                                                 vectorWidth));
         }
         return result;
     }
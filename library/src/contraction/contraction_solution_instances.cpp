@@ -26,11 +26,38 @@
 
 #include "contraction_solution_instances.hpp"
 #include "contraction_solution.hpp"
+#include "device/contraction_vector_instances.hpp"
 
 namespace hiptensor
 {
     ContractionSolutionInstances::ContractionSolutionInstances()
     {
+        using namespace ck::tensor_operation::device::instance;
+
+        using BilinearF32Op = ck::tensor_operation::device::DeviceContractionMultipleD<
+            2,
+            2,
+            2,
+            float,
+            float,
+            ck::Tuple<float>,
+            float,
+            ck::tensor_operation::element_wise::PassThrough,
+            ck::tensor_operation::element_wise::PassThrough,
+            ck::tensor_operation::element_wise::Bilinear>;
+
+        using ScaleF32Op = ck::tensor_operation::device::DeviceContractionMultipleD<
+            2,
+            2,
+            2,
+            float,
+            float,
+            ck::Tuple<>,
+            float,
+            ck::tensor_operation::element_wise::PassThrough,
+            ck::tensor_operation::element_wise::PassThrough,
+            ck::tensor_operation::element_wise::Scale>;
+
         // Register all the solutions exactly once
         // Bilinear f32
         registerSolutions(
@@ -43,7 +70,30 @@ namespace hiptensor
                                           float,
                                           ck::tensor_operation::element_wise::PassThrough,
                                           ck::tensor_operation::element_wise::PassThrough,
-                                          ck::tensor_operation::element_wise::Bilinear>());
+                                          ck::tensor_operation::element_wise::Bilinear>(4));
+
+        // Bilinear f32, narrow vector widths
+        {
+            std::vector<std::unique_ptr<BilinearF32Op>> vec2, vec1;
+            add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_kknn_vec2_instance(
+                vec2);
+            add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_knnn_vec2_instance(
+                vec2);
+            add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_mknn_vec2_instance(
+                vec2);
+            add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_mnnn_vec2_instance(
+                vec2);
+            add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_kknn_vec1_instance(
+                vec1);
+            add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_knnn_vec1_instance(
+                vec1);
+            add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_mknn_vec1_instance(
+                vec1);
+            add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_mnnn_vec1_instance(
+                vec1);
+            registerSolutions(wrapContractionSolutions(std::move(vec2), 2));
+            registerSolutions(wrapContractionSolutions(std::move(vec1), 1));
+        }
 
         // Bilinear f64
         registerSolutions(
@@ -56,7 +106,7 @@ namespace hiptensor
                                           double,
                                           ck::tensor_operation::element_wise::PassThrough,
                                           ck::tensor_operation::element_wise::PassThrough,
-                                          ck::tensor_operation::element_wise::Bilinear>());
+                                          ck::tensor_operation::element_wise::Bilinear>(1));
 
         // Scale f32
         registerSolutions(
@@ -69,7 +119,22 @@ namespace hiptensor
                                           float,
                                           ck::tensor_operation::element_wise::PassThrough,
                                           ck::tensor_operation::element_wise::PassThrough,
-                                          ck::tensor_operation::element_wise::Scale>());
+                                          ck::tensor_operation::element_wise::Scale>(4));
+
+        // Scale f32, narrow vector widths
+        {
+            std::vector<std::unique_ptr<ScaleF32Op>> vec2, vec1;
+            add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_kkn_vec2_instance(vec2);
+            add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_knn_vec2_instance(vec2);
+            add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_mkn_vec2_instance(vec2);
+            add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_mnn_vec2_instance(vec2);
+            add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_kkn_vec1_instance(vec1);
+            add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_knn_vec1_instance(vec1);
+            add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_mkn_vec1_instance(vec1);
+            add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_mnn_vec1_instance(vec1);
+            registerSolutions(wrapContractionSolutions(std::move(vec2), 2));
+            registerSolutions(wrapContractionSolutions(std::move(vec1), 1));
+        }
 
         // Scale f64
         registerSolutions(
@@ -82,6 +147,6 @@ namespace hiptensor
                                           double,
                                           ck::tensor_operation::element_wise::PassThrough,
                                           ck::tensor_operation::element_wise::PassThrough,
-                                          ck::tensor_operation::element_wise::Scale>());
+                                          ck::tensor_operation::element_wise::Scale>(1));
     }
 } // namespace hiptensor
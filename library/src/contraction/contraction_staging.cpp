@@ -0,0 +1,219 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+
+#include <hip/hip_runtime.h>
+
+#include "config.hpp"
+#include "contraction_staging.hpp"
+#include "data_types.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        // Lengths and strides passed to the kernel by value
+        struct CopyShape
+        {
+            uint32_t    mRank;
+            std::size_t mLengths[StagingMaxRank];
+            std::size_t mSrcStrides[StagingMaxRank];
+            std::size_t mDstStrides[StagingMaxRank];
+        };
+
+        // Copies are type-agnostic, so elements are moved as unsigned words of their size
+        template <typename WordT>
+        HIPTENSOR_KERNEL void
+            stridedCopyKernel(WordT const* src, WordT* dst, CopyShape shape, std::size_t count)
+        {
+            auto stride = std::size_t(gridDim.x) * blockDim.x;
+            for(auto i = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x; i < count;
+                i += stride)
+            {
+                auto rest      = i;
+                auto srcOffset = std::size_t{0};
+                auto dstOffset = std::size_t{0};
+                for(auto mode = shape.mRank; mode-- > 0;)
+                {
+                    auto index = rest % shape.mLengths[mode];
+                    rest /= shape.mLengths[mode];
+                    srcOffset += index * shape.mSrcStrides[mode];
+                    dstOffset += index * shape.mDstStrides[mode];
+                }
+                dst[dstOffset] = src[srcOffset];
+            }
+        }
+
+        template <typename WordT>
+        hiptensorStatus_t launchCopy(void const*      src,
+                                     void*            dst,
+                                     CopyShape const& shape,
+                                     std::size_t      count,
+                                     hipStream_t      stream)
+        {
+            constexpr uint32_t BlockSize = 256u;
+            constexpr uint32_t MaxBlocks = 1u << 16;
+
+            auto blocks = uint32_t(std::min<std::size_t>((count + BlockSize - 1) / BlockSize,
+                                                         MaxBlocks));
+            hipLaunchKernelGGL((stridedCopyKernel<WordT>),
+                               dim3(blocks),
+                               dim3(BlockSize),
+                               0,
+                               stream,
+                               static_cast<WordT const*>(src),
+                               static_cast<WordT*>(dst),
+                               shape,
+                               count);
+
+            return hipGetLastError() == hipSuccess ? HIPTENSOR_STATUS_SUCCESS
+                                                   : HIPTENSOR_STATUS_HIP_ERROR;
+        }
+
+        hiptensorStatus_t launchCopy(void const*      src,
+                                     void*            dst,
+                                     CopyShape const& shape,
+                                     std::size_t      count,
+                                     uint32_t         elementBytes,
+                                     hipStream_t      stream)
+        {
+            switch(elementBytes)
+            {
+            case 1:
+                return launchCopy<uint8_t>(src, dst, shape, count, stream);
+            case 2:
+                return launchCopy<uint16_t>(src, dst, shape, count, stream);
+            case 4:
+                return launchCopy<uint32_t>(src, dst, shape, count, stream);
+            case 8:
+                return launchCopy<uint64_t>(src, dst, shape, count, stream);
+            default:
+                return HIPTENSOR_STATUS_NOT_SUPPORTED;
+            }
+        }
+    }
+
+    std::size_t collapseCopyModes(hiptensorDimVector_t& srcStrides,
+                                  hiptensorDimVector_t& dstStrides,
+                                  hiptensorDimVector_t& lengths)
+    {
+        hiptensorDimVector_t mergedLengths, mergedSrc, mergedDst;
+        for(std::size_t i = 0; i < lengths.size(); i++)
+        {
+            if(lengths[i] == 1)
+            {
+                continue;
+            }
+
+            // A mode is merged into the previous one when both views step over it
+            // contiguously
+            if(!mergedLengths.empty() && mergedSrc.back() == srcStrides[i] * lengths[i]
+               && mergedDst.back() == dstStrides[i] * lengths[i])
+            {
+                mergedLengths.back() *= lengths[i];
+                mergedSrc.back() = srcStrides[i];
+                mergedDst.back() = dstStrides[i];
+                continue;
+            }
+
+            mergedLengths.push_back(lengths[i]);
+            mergedSrc.push_back(srcStrides[i]);
+            mergedDst.push_back(dstStrides[i]);
+        }
+
+        lengths    = std::move(mergedLengths);
+        srcStrides = std::move(mergedSrc);
+        dstStrides = std::move(mergedDst);
+        return lengths.size();
+    }
+
+    hiptensorStatus_t stridedCopy(void const*                 src,
+                                  hiptensorDimVector_t const& srcStrides,
+                                  void*                       dst,
+                                  hiptensorDimVector_t const& dstStrides,
+                                  hiptensorDimVector_t const& lengths,
+                                  hipDataType                 type,
+                                  hipStream_t                 stream)
+    {
+        if(srcStrides.size() != lengths.size() || dstStrides.size() != lengths.size())
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        auto elementBytes = hipDataTypeSize(type);
+        auto count        = std::size_t{1};
+        for(auto length : lengths)
+        {
+            count *= length;
+        }
+        if(count == 0)
+        {
+            return HIPTENSOR_STATUS_SUCCESS;
+        }
+
+        auto copyLengths = lengths;
+        auto copySrc     = srcStrides;
+        auto copyDst     = dstStrides;
+        auto rank        = collapseCopyModes(copySrc, copyDst, copyLengths);
+
+        // Modes beyond the kernel's rank are iterated here, one launch per outer index
+        if(rank > StagingMaxRank)
+        {
+            auto inner = hiptensorDimVector_t(copyLengths.begin() + 1, copyLengths.end());
+            auto src1  = hiptensorDimVector_t(copySrc.begin() + 1, copySrc.end());
+            auto dst1  = hiptensorDimVector_t(copyDst.begin() + 1, copyDst.end());
+            for(std::size_t i = 0; i < copyLengths[0]; i++)
+            {
+                auto status = stridedCopy(static_cast<char const*>(src)
+                                              + i * copySrc[0] * elementBytes,
+                                          src1,
+                                          static_cast<char*>(dst) + i * copyDst[0] * elementBytes,
+                                          dst1,
+                                          inner,
+                                          type,
+                                          stream);
+                if(status != HIPTENSOR_STATUS_SUCCESS)
+                {
+                    return status;
+                }
+            }
+            return HIPTENSOR_STATUS_SUCCESS;
+        }
+
+        CopyShape shape = {};
+        shape.mRank     = uint32_t(rank);
+        for(std::size_t i = 0; i < rank; i++)
+        {
+            shape.mLengths[i]    = copyLengths[i];
+            shape.mSrcStrides[i] = copySrc[i];
+            shape.mDstStrides[i] = copyDst[i];
+        }
+
+        return launchCopy(src, dst, shape, count, elementBytes, stream);
+    }
+
+} // namespace hiptensor
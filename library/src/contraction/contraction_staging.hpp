@@ -0,0 +1,57 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_CONTRACTION_STAGING_HPP
+#define HIPTENSOR_CONTRACTION_STAGING_HPP
+
+#include <hiptensor/hiptensor.hpp>
+
+namespace hiptensor
+{
+    // Copies launch with up to this many modes after collapsing; outer modes beyond it
+    // are iterated on the host
+    constexpr uint32_t StagingMaxRank = HIPTENSOR_MAX_INLINE_RANK;
+
+    // Drops unit modes and merges modes that both views traverse contiguously, returning
+    // the remaining rank
+    std::size_t collapseCopyModes(hiptensorDimVector_t& srcStrides,
+                                  hiptensorDimVector_t& dstStrides,
+                                  hiptensorDimVector_t& lengths);
+
+    // Copies every element of a strided view into another layout of the same lengths
+    // on the device, for any rank and element type. Used to pack operands that kernels
+    // cannot load directly, and to scatter packed results back into strided outputs.
+    hiptensorStatus_t stridedCopy(void const*                 src,
+                                  hiptensorDimVector_t const& srcStrides,
+                                  void*                       dst,
+                                  hiptensorDimVector_t const& dstStrides,
+                                  hiptensorDimVector_t const& lengths,
+                                  hipDataType                 type,
+                                  hipStream_t                 stream);
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_CONTRACTION_STAGING_HPP
@@ -0,0 +1,1001 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "contraction_streaming.hpp"
+#include "data_types.hpp"
+#include "degenerate_contraction.hpp"
+#include "descriptor_cache.hpp"
+#include "util.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        // Tiles are placed at the alignment of device allocations
+        constexpr std::size_t TileAlignment = 256u;
+
+        constexpr std::size_t NoMode = ~std::size_t{0};
+
+        std::size_t alignTile(std::size_t bytes)
+        {
+            return ceilDiv(bytes, TileAlignment) * TileAlignment;
+        }
+
+        // Outermost M, N and K mode of operand i, or NoMode if it has none.
+        // Modes are ordered A = [M, K], B = [N, K] and C, D = [M, N].
+        std::array<std::size_t, 3>
+            outerModes(int i, std::size_t rankM, std::size_t rankN, std::size_t rankK)
+        {
+            auto modeM = rankM > 0 ? std::size_t{0} : NoMode;
+            switch(i)
+            {
+            case 0:
+                return {modeM, NoMode, rankK > 0 ? rankM : NoMode};
+            case 1:
+                return {NoMode, rankN > 0 ? std::size_t{0} : NoMode, rankK > 0 ? rankN : NoMode};
+            default:
+                return {modeM, rankN > 0 ? rankM : NoMode, NoMode};
+            }
+        }
+
+        // D = alpha * A * B + beta * C on packed row-major A = [M, K], B = [N, K], C, D = [M, N]
+        template <typename T>
+        void contractPacked(void const* alpha,
+                            T const*    A,
+                            T const*    B,
+                            void const* beta,
+                            T const*    C,
+                            T*          D,
+                            std::size_t m,
+                            std::size_t n,
+                            std::size_t k)
+        {
+            auto alphaT = alpha != nullptr ? *static_cast<T const*>(alpha) : T{0};
+            auto betaT  = beta != nullptr ? *static_cast<T const*>(beta) : T{0};
+            for(std::size_t i = 0; i < m; i++)
+            {
+                for(std::size_t j = 0; j < n; j++)
+                {
+                    T accum = 0;
+                    for(std::size_t l = 0; l < k; l++)
+                    {
+                        accum += A[i * k + l] * B[j * k + l];
+                    }
+                    D[i * n + j] = alphaT * accum + (C != nullptr ? betaT * C[i * n + j] : T{0});
+                }
+            }
+        }
+
+        // D = alpha * A * B + beta * C on packed row-major A = [M, K] and C, D = [M, N],
+        // with B read from the panels of a pre-packed operand starting at row startN
+        // and column startK
+        template <typename T>
+        void contractWithPanels(void const*              alpha,
+                                T const*                 A,
+                                HostPackedOperand const& B,
+                                std::size_t              startN,
+                                std::size_t              startK,
+                                void const*              beta,
+                                T const*                 C,
+                                T*                       D,
+                                std::size_t              m,
+                                std::size_t              n,
+                                std::size_t              k)
+        {
+            constexpr auto W = HostPanelWidth;
+
+            auto  alphaT = alpha != nullptr ? *static_cast<T const*>(alpha) : T{0};
+            auto  betaT  = beta != nullptr ? *static_cast<T const*>(beta) : T{0};
+            auto* panels = reinterpret_cast<T const*>(B.mPanels.data());
+            for(std::size_t i = 0; i < m; i++)
+            {
+                for(std::size_t j = 0; j < n;)
+                {
+                    auto row   = startN + j;
+                    auto lane  = row % W;
+                    auto count = std::min(W - lane, n - j);
+                    auto panel = panels + (row / W) * B.mK * W + startK * W;
+
+                    T accum[W] = {};
+                    for(std::size_t l = 0; l < k; l++)
+                    {
+                        auto a = A[i * k + l];
+                        for(std::size_t w = 0; w < W; w++)
+                        {
+                            accum[w] += a * panel[l * W + w];
+                        }
+                    }
+
+                    for(std::size_t w = 0; w < count; w++)
+                    {
+                        auto index = i * n + j + w;
+                        auto bias  = C != nullptr ? betaT * C[index] : T{0};
+                        D[index]   = alphaT * accum[lane + w] + bias;
+                    }
+                    j += count;
+                }
+            }
+        }
+    }
+
+    hiptensorStatus_t
+        packHostOperand(HostPackedOperand* packed, StreamingPlan const& plan, void const* B)
+    {
+        if(packed == nullptr || B == nullptr)
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        auto const& lengths      = plan.mLengths[1];
+        auto        elementBytes = hipDataTypeSize(plan.mTypes[1]);
+        if(elementBytes == 0)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        packed->mType   = plan.mTypes[1];
+        packed->mN      = 1;
+        packed->mK      = 1;
+        packed->mInnerN = 1;
+        packed->mInnerK = 1;
+        for(int i = 0; i < lengths.size(); i++)
+        {
+            auto isN = i < plan.mRankN;
+            (isN ? packed->mN : packed->mK) *= lengths[i];
+            if(i != 0 && i != plan.mRankN)
+            {
+                (isN ? packed->mInnerN : packed->mInnerK) *= lengths[i];
+            }
+        }
+
+        // Gather B row-major, then deal the rows out to their panels
+        std::vector<char> rows(packed->mN * packed->mK * elementBytes);
+        forEachCopyRun(lengths,
+                       plan.mStrides[1],
+                       stridesFromLengths(lengths),
+                       [&](std::size_t srcOffset, std::size_t dstOffset, std::size_t count) {
+                           std::memcpy(rows.data() + dstOffset * elementBytes,
+                                       (char const*)B + srcOffset * elementBytes,
+                                       count * elementBytes);
+                       });
+
+        auto rowBytes = packed->mK * elementBytes;
+        packed->mPanels.assign(ceilDiv(packed->mN, HostPanelWidth) * HostPanelWidth * rowBytes, 0);
+        for(std::size_t j = 0; j < packed->mN; j++)
+        {
+            auto* panel = packed->mPanels.data() + (j / HostPanelWidth) * HostPanelWidth * rowBytes
+                          + (j % HostPanelWidth) * elementBytes;
+            for(std::size_t l = 0; l < packed->mK; l++)
+            {
+                std::memcpy(panel + l * HostPanelWidth * elementBytes,
+                            rows.data() + j * rowBytes + l * elementBytes,
+                            elementBytes);
+            }
+        }
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    std::vector<StreamingTile> StreamingPlan::tiles() const
+    {
+        std::vector<StreamingTile> result;
+        for(std::size_t m = 0; m < mOuterM; m += mTileM)
+        {
+            for(std::size_t n = 0; n < mOuterN; n += mTileN)
+            {
+                for(std::size_t k = 0; k < mOuterK; k += mTileK)
+                {
+                    result.push_back({m,
+                                      std::min(mTileM, mOuterM - m),
+                                      n,
+                                      std::min(mTileN, mOuterN - n),
+                                      k,
+                                      std::min(mTileK, mOuterK - k)});
+                }
+            }
+        }
+        return result;
+    }
+
+    std::array<hiptensorDimVector_t, 4>
+        StreamingPlan::tileLengths(StreamingTile const& tile) const
+    {
+        std::array<hiptensorDimVector_t, 4> lengths;
+        std::array<std::size_t, 3>          extents = {tile.mExtentM, tile.mExtentN, tile.mExtentK};
+        for(int i = 0; i < lengths.size(); i++)
+        {
+            lengths[i] = mLengths[i];
+            if(mTypes[i] == NONE_TYPE)
+            {
+                continue;
+            }
+
+            auto modes = outerModes(i, mRankM, mRankN, mRankK);
+            for(int d = 0; d < modes.size(); d++)
+            {
+                if(modes[d] < lengths[i].size())
+                {
+                    lengths[i][modes[d]] = extents[d];
+                }
+            }
+        }
+        return lengths;
+    }
+
+    std::array<std::size_t, 4> StreamingPlan::tileOffsets(StreamingTile const& tile) const
+    {
+        std::array<std::size_t, 4> offsets = {0, 0, 0, 0};
+        std::array<std::size_t, 3> starts  = {tile.mStartM, tile.mStartN, tile.mStartK};
+        for(int i = 0; i < offsets.size(); i++)
+        {
+            if(mTypes[i] == NONE_TYPE)
+            {
+                continue;
+            }
+
+            auto modes = outerModes(i, mRankM, mRankN, mRankK);
+            for(int d = 0; d < modes.size(); d++)
+            {
+                if(modes[d] < mStrides[i].size())
+                {
+                    offsets[i] += starts[d] * mStrides[i][modes[d]];
+                }
+            }
+        }
+        return offsets;
+    }
+
+    std::size_t StreamingPlan::outputTiles() const
+    {
+        if(mTileM == 0 || mTileN == 0)
+        {
+            return 0;
+        }
+        return ceilDiv(mOuterM, mTileM) * ceilDiv(mOuterN, mTileN);
+    }
+
+    std::pair<std::size_t, std::size_t> StreamingPlan::tileSpan(StreamingTile const& tile,
+                                                                int                  i) const
+    {
+        auto lengths = tileLengths(tile)[i];
+        if(mTypes[i] == NONE_TYPE || lengths.empty() || elementsFromLengths(lengths) == 0)
+        {
+            return {0, 0};
+        }
+
+        auto elementBytes = hipDataTypeSize(mTypes[i]);
+        return {tileOffsets(tile)[i] * elementBytes,
+                elementSpaceFromLengthsAndStrides(lengths, mStrides[i]) * elementBytes};
+    }
+
+    std::vector<std::pair<uint32_t, StreamingTile>>
+        StreamingPlan::outputSegments(StreamingTile const& tile) const
+    {
+        if(mOutputs <= 1 || mOutputN == 0)
+        {
+            return {{0u, tile}};
+        }
+
+        std::vector<std::pair<uint32_t, StreamingTile>> segments;
+        for(auto n = tile.mStartN; n < tile.mStartN + tile.mExtentN;)
+        {
+            auto output  = n / mOutputN;
+            auto end     = std::min(tile.mStartN + tile.mExtentN, (output + 1) * mOutputN);
+            auto segment = tile;
+
+            segment.mStartN  = n - output * mOutputN;
+            segment.mExtentN = end - n;
+            segments.emplace_back(uint32_t(output), segment);
+            n = end;
+        }
+        return segments;
+    }
+
+    hiptensorStatus_t planStreaming(StreamingPlan*              plan,
+                                    ContractionSignature const& signature,
+                                    std::size_t                 capacityBytes,
+                                    std::size_t                 workspaceBytes,
+                                    uint32_t                    slots)
+    {
+        if(plan == nullptr || slots == 0)
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        // Tiles span the concatenated outputs, but are copied from each output's host layout
+        for(int i = 0; i < signature.mTensors.size(); i++)
+        {
+            plan->mTypes[i]   = signature.mTensors[i]->mType;
+            plan->mLengths[i] = signature.mTensors[i]->mLengths;
+            plan->mStrides[i] = signature.mOutputTensors[i]->mStrides;
+        }
+        if(signature.mOutputs > 1 && signature.mRankN == 0)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        auto const& lengthsA = plan->mLengths[0];
+        plan->mRankM         = signature.mRankM;
+        plan->mRankN         = signature.mRankN;
+        plan->mRankK         = lengthsA.size() - std::min(signature.mRankM, lengthsA.size());
+        plan->mOuterM        = signature.mOuterM;
+        plan->mOuterN        = signature.mOuterN;
+        plan->mOuterK        = plan->mRankK > 0 ? lengthsA[plan->mRankM] : 1;
+        plan->mOutputs       = signature.mOutputs;
+        plan->mOutputN       = signature.mOuterN / signature.mOutputs;
+        plan->mSlots         = slots;
+
+        // Lays out one slot for the current tile extents. Every packed tile must also
+        // fit 32-bit kernel indexing.
+        std::array<int, 3> operands = {0, 1, 3};
+
+        auto layout = [&]() {
+            auto lengths   = plan->tileLengths({0, plan->mTileM, 0, plan->mTileN, 0, plan->mTileK});
+            auto indexable = true;
+            auto offset    = std::size_t{0};
+            for(int r = 0; r < operands.size(); r++)
+            {
+                auto i            = operands[r];
+                auto elementBytes = hipDataTypeSize(plan->mTypes[i]);
+                indexable &= fitsKernelIndexing(
+                    lengths[i], stridesFromLengths(lengths[i]), elementBytes);
+
+                plan->mSlotOffsets[r] = offset;
+                offset += alignTile(elementsFromLengths(lengths[i]) * elementBytes);
+            }
+            plan->mWorkspaceOffset = offset;
+            plan->mSlotBytes       = offset + alignTile(workspaceBytes);
+            return indexable && plan->mSlotBytes <= capacityBytes / slots;
+        };
+
+        // Partial products over K tiles are accumulated through the C input
+        auto splitK = plan->mTypes[2] != NONE_TYPE;
+
+        plan->mTileM = plan->mOuterM;
+        plan->mTileN = plan->mOuterN;
+        plan->mTileK = plan->mOuterK;
+        while(!layout())
+        {
+            // Halve the tile extent that frees the most device memory
+            std::array<std::size_t*, 3> extents = {&plan->mTileM, &plan->mTileN, &plan->mTileK};
+            std::size_t*                best      = nullptr;
+            auto                        bestBytes = std::numeric_limits<std::size_t>::max();
+            for(int d = 0; d < extents.size(); d++)
+            {
+                if(*extents[d] <= 1 || (d == 2 && !splitK))
+                {
+                    continue;
+                }
+
+                auto extent = *extents[d];
+                *extents[d] = ceilDiv(extent, 2u);
+                layout();
+                if(plan->mSlotBytes < bestBytes)
+                {
+                    best      = extents[d];
+                    bestBytes = plan->mSlotBytes;
+                }
+                *extents[d] = extent;
+            }
+
+            // Only the outermost modes are tiled
+            if(best == nullptr)
+            {
+                return HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+            }
+            *best = ceilDiv(*best, 2u);
+        }
+
+        // K tiles of one output run in sequence, so give every slot an output tile to overlap
+        while(plan->outputTiles() < slots && (plan->mTileM > 1 || plan->mTileN > 1))
+        {
+            auto& extent = plan->mTileM >= plan->mTileN ? plan->mTileM : plan->mTileN;
+            extent       = ceilDiv(extent, 2u);
+        }
+        layout();
+
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    void forEachCopyRun(
+        hiptensorDimVector_t const&                                          lengths,
+        hiptensorDimVector_t const&                                          srcStrides,
+        hiptensorDimVector_t const&                                          dstStrides,
+        std::function<void(std::size_t, std::size_t, std::size_t)> const& visit)
+    {
+        // Length-1 modes do not move the copy
+        hiptensorDimVector_t modes;
+        for(int i = 0; i < lengths.size(); i++)
+        {
+            if(lengths[i] == 0)
+            {
+                return;
+            }
+            if(lengths[i] > 1)
+            {
+                modes.push_back(i);
+            }
+        }
+
+        // Innermost modes that continue a run in both layouts are merged into it
+        std::size_t run = 1;
+        while(!modes.empty())
+        {
+            auto mode = modes.back();
+            if(srcStrides[mode] != run || dstStrides[mode] != run)
+            {
+                break;
+            }
+            run *= lengths[mode];
+            modes.pop_back();
+        }
+
+        hiptensorDimVector_t index(modes.size(), 0);
+        while(true)
+        {
+            std::size_t src = 0, dst = 0;
+            for(int i = 0; i < modes.size(); i++)
+            {
+                src += index[i] * srcStrides[modes[i]];
+                dst += index[i] * dstStrides[modes[i]];
+            }
+            visit(src, dst, run);
+
+            // Advance the remaining modes, innermost fastest
+            int i = int(modes.size()) - 1;
+            for(; i >= 0; i--)
+            {
+                if(++index[i] < lengths[modes[i]])
+                {
+                    break;
+                }
+                index[i] = 0;
+            }
+            if(i < 0)
+            {
+                return;
+            }
+        }
+    }
+
+    HostStreamingBackend::HostStreamingBackend(std::size_t capacityBytes, hipDataType type)
+        : mCapacityBytes(capacityBytes)
+        , mType(type)
+    {
+    }
+
+    HostStreamingBackend::~HostStreamingBackend()
+    {
+        for(auto& allocation : mAllocations)
+        {
+            std::free(allocation.first);
+        }
+    }
+
+    hiptensorStatus_t HostStreamingBackend::allocate(void** ptr, std::size_t bytes)
+    {
+        if(mAllocatedBytes + bytes > mCapacityBytes)
+        {
+            return HIPTENSOR_STATUS_ALLOC_FAILED;
+        }
+
+        *ptr = std::malloc(std::max(bytes, std::size_t{1}));
+        if(*ptr == nullptr)
+        {
+            return HIPTENSOR_STATUS_ALLOC_FAILED;
+        }
+
+        mAllocations.emplace_back(*ptr, bytes);
+        mAllocatedBytes += bytes;
+        mPeakBytes = std::max(mPeakBytes, mAllocatedBytes);
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t HostStreamingBackend::release(void* ptr)
+    {
+        auto it = std::find_if(mAllocations.begin(), mAllocations.end(), [ptr](auto& allocation) {
+            return allocation.first == ptr;
+        });
+        if(it == mAllocations.end())
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        mAllocatedBytes -= it->second;
+        std::free(it->first);
+        mAllocations.erase(it);
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t HostStreamingBackend::upload(void*                       dst,
+                                                   hiptensorDimVector_t const& dstStrides,
+                                                   void const*                 src,
+                                                   hiptensorDimVector_t const& srcStrides,
+                                                   hiptensorDimVector_t const& lengths,
+                                                   std::size_t                 elementBytes,
+                                                   uint32_t                    slot)
+    {
+        forEachCopyRun(lengths,
+                       srcStrides,
+                       dstStrides,
+                       [&](std::size_t srcOffset, std::size_t dstOffset, std::size_t count) {
+                           std::memcpy((char*)dst + dstOffset * elementBytes,
+                                       (char const*)src + srcOffset * elementBytes,
+                                       count * elementBytes);
+                       });
+        mUploads++;
+        mSlotsUsed = std::max(mSlotsUsed, slot + 1u);
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t HostStreamingBackend::download(void*                       dst,
+                                                     hiptensorDimVector_t const& dstStrides,
+                                                     void const*                 src,
+                                                     hiptensorDimVector_t const& srcStrides,
+                                                     hiptensorDimVector_t const& lengths,
+                                                     std::size_t                 elementBytes,
+                                                     uint32_t                    slot)
+    {
+        forEachCopyRun(lengths,
+                       srcStrides,
+                       dstStrides,
+                       [&](std::size_t srcOffset, std::size_t dstOffset, std::size_t count) {
+                           std::memcpy((char*)dst + dstOffset * elementBytes,
+                                       (char const*)src + srcOffset * elementBytes,
+                                       count * elementBytes);
+                       });
+        mSlotsUsed = std::max(mSlotsUsed, slot + 1u);
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t
+        HostStreamingBackend::contract(void const*                                alpha,
+                                       void const*                                A,
+                                       void const*                                B,
+                                       void const*                                beta,
+                                       void const*                                C,
+                                       void*                                      D,
+                                       std::array<hiptensorDimVector_t, 4> const& lengths,
+                                       void*                                      workspace,
+                                       uint32_t                                   slot)
+    {
+        auto const& lengthsA = lengths[0];
+        auto        rankK = (lengthsA.size() + lengths[1].size() - lengths[3].size()) / 2;
+        auto        rankM = lengthsA.size() - std::min(rankK, lengthsA.size());
+
+        std::size_t m = 1, k = 1;
+        for(int i = 0; i < lengthsA.size(); i++)
+        {
+            (i < rankM ? m : k) *= lengthsA[i];
+        }
+        auto n = m > 0 ? elementsFromLengths(lengths[3]) / m : 0;
+
+        // Tiles left without M, N or K modes take the same fast paths as on the device
+        auto types    = std::array<hipDataType, 4>{mType, mType, C ? mType : NONE_TYPE, mType};
+        auto squeezed = squeezeContraction(types,
+                                           {lengthsA, lengths[1], lengths[3], lengths[3]},
+                                           {stridesFromLengths(lengthsA),
+                                            stridesFromLengths(lengths[1]),
+                                            C ? stridesFromLengths(lengths[3])
+                                              : hiptensorDimVector_t(lengths[3].size(), 0),
+                                            stridesFromLengths(lengths[3])},
+                                           rankM,
+                                           lengths[1].size() - rankK);
+
+        auto degenerate = squeezed.mShape != ContractionShape::GENERAL;
+        if(mType == HIP_R_32F && degenerate)
+        {
+            degenerateContractionByCpu<float>(squeezed,
+                                              alpha,
+                                              (float const*)A,
+                                              (float const*)B,
+                                              beta,
+                                              (float const*)C,
+                                              (float*)D);
+        }
+        else if(mType == HIP_R_64F && degenerate)
+        {
+            degenerateContractionByCpu<double>(squeezed,
+                                               alpha,
+                                               (double const*)A,
+                                               (double const*)B,
+                                               beta,
+                                               (double const*)C,
+                                               (double*)D);
+        }
+        else if(mType == HIP_R_32F)
+        {
+            contractPacked<float>(
+                alpha, (float const*)A, (float const*)B, beta, (float const*)C, (float*)D, m, n, k);
+        }
+        else if(mType == HIP_R_64F)
+        {
+            contractPacked<double>(alpha,
+                                   (double const*)A,
+                                   (double const*)B,
+                                   beta,
+                                   (double const*)C,
+                                   (double*)D,
+                                   m,
+                                   n,
+                                   k);
+        }
+        else
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        mContractions++;
+        mSlotsUsed = std::max(mSlotsUsed, slot + 1u);
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t
+        HostStreamingBackend::contractPanels(void const*                                alpha,
+                                             void const*                                A,
+                                             HostPackedOperand const&                   B,
+                                             std::size_t                                startN,
+                                             std::size_t                                startK,
+                                             void const*                                beta,
+                                             void const*                                C,
+                                             void*                                      D,
+                                             std::array<hiptensorDimVector_t, 4> const& lengths,
+                                             void*                                      workspace,
+                                             uint32_t                                   slot)
+    {
+        auto const& lengthsA = lengths[0];
+        auto        rankK = (lengthsA.size() + lengths[1].size() - lengths[3].size()) / 2;
+        auto        rankM = lengthsA.size() - std::min(rankK, lengthsA.size());
+
+        std::size_t m = 1, k = 1;
+        for(int i = 0; i < lengthsA.size(); i++)
+        {
+            (i < rankM ? m : k) *= lengthsA[i];
+        }
+        auto n = m > 0 ? elementsFromLengths(lengths[3]) / m : 0;
+
+        if(B.mType != mType || startN + n > B.mN || startK + k > B.mK)
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        if(mType == HIP_R_32F)
+        {
+            contractWithPanels<float>(alpha,
+                                      (float const*)A,
+                                      B,
+                                      startN,
+                                      startK,
+                                      beta,
+                                      (float const*)C,
+                                      (float*)D,
+                                      m,
+                                      n,
+                                      k);
+        }
+        else if(mType == HIP_R_64F)
+        {
+            contractWithPanels<double>(alpha,
+                                       (double const*)A,
+                                       B,
+                                       startN,
+                                       startK,
+                                       beta,
+                                       (double const*)C,
+                                       (double*)D,
+                                       m,
+                                       n,
+                                       k);
+        }
+        else
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        mContractions++;
+        mSlotsUsed = std::max(mSlotsUsed, slot + 1u);
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t HostStreamingBackend::synchronize()
+    {
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    std::size_t HostStreamingBackend::peakBytes() const
+    {
+        return mPeakBytes;
+    }
+
+    std::size_t HostStreamingBackend::uploads() const
+    {
+        return mUploads;
+    }
+
+    std::size_t HostStreamingBackend::contractions() const
+    {
+        return mContractions;
+    }
+
+    uint32_t HostStreamingBackend::slotsUsed() const
+    {
+        return mSlotsUsed;
+    }
+
+    MappedTensorHints::MappedTensorHints(std::array<MappedTensorFile const*, 4> const& files)
+        : mFiles(files)
+    {
+    }
+
+    void MappedTensorHints::willNeed(int i, std::size_t offset, std::size_t bytes)
+    {
+        if(mFiles[i] != nullptr)
+        {
+            mFiles[i]->willNeed(offset, bytes);
+        }
+    }
+
+    void MappedTensorHints::dontNeed(int i, std::size_t offset, std::size_t bytes)
+    {
+        if(mFiles[i] != nullptr)
+        {
+            mFiles[i]->dontNeed(offset, bytes);
+        }
+    }
+
+    hiptensorStatus_t streamContraction(StreamingPlan const&     plan,
+                                        StreamingBackend&        backend,
+                                        void const*              alpha,
+                                        void const*              A,
+                                        void const*              B,
+                                        void const*              beta,
+                                        void const*              C,
+                                        void*                    D,
+                                        StreamingHints*          hints,
+                                        HostPackedOperand const* packedB)
+    {
+        return streamContraction(plan, backend, alpha, A, &B, beta, &C, &D, hints, packedB);
+    }
+
+    hiptensorStatus_t streamContraction(StreamingPlan const&     plan,
+                                        StreamingBackend&        backend,
+                                        void const*              alpha,
+                                        void const*              A,
+                                        void const* const        B[],
+                                        void const*              beta,
+                                        void const* const        C[],
+                                        void* const              D[],
+                                        StreamingHints*          hints,
+                                        HostPackedOperand const* packedB)
+    {
+        auto tiles = plan.tiles();
+        if(tiles.empty())
+        {
+            return HIPTENSOR_STATUS_SUCCESS;
+        }
+
+        // The panels of a pre-packed B are laid out for a single output
+        if(packedB != nullptr && plan.mOutputs > 1)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        if(packedB != nullptr
+           && (packedB->mType != plan.mTypes[1]
+               || packedB->mN * packedB->mK != elementsFromLengths(plan.mLengths[1])))
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        // Problems with few output tiles do not need every slot
+        auto slots = uint32_t(std::min<std::size_t>(plan.mSlots, plan.outputTiles()));
+
+        void* device = nullptr;
+        auto  status = backend.allocate(&device, slots * plan.mSlotBytes);
+        if(status != HIPTENSOR_STATUS_SUCCESS)
+        {
+            return status;
+        }
+
+        // Later K tiles add onto the partial result held in the D tile
+        auto        oneF32 = 1.0f;
+        auto        oneF64 = 1.0;
+        void const* one    = plan.mTypes[3] == HIP_R_64F ? (void const*)&oneF64 : &oneF32;
+        auto        hasC   = plan.mTypes[2] != NONE_TYPE && C != nullptr && C[0] != nullptr;
+        auto        single = plan.mOutputs <= 1;
+
+        std::array<std::size_t, 4> elementBytes;
+        for(int i = 0; i < elementBytes.size(); i++)
+        {
+            elementBytes[i] = hipDataTypeSize(plan.mTypes[i]);
+        }
+
+        // Inputs hinted for tile t. C is only read with the first K tile of an output.
+        // Hints address a single host operand, so fused outputs only hint A.
+        auto inputs = [&](std::size_t t) {
+            return std::array<bool, 3>{true,
+                                       single && packedB == nullptr,
+                                       single && hasC && tiles[t].mStartK == 0};
+        };
+
+        // Copies the parts of operand i of a tile between each output's host layout and
+        // the packed tile, whose N range may span several outputs. A is shared by all.
+        auto transfer = [&](int i, StreamingTile const& tile, void* packed, uint32_t slot) {
+            auto lengths  = plan.tileLengths(tile)[i];
+            auto strides  = stridesFromLengths(lengths);
+            auto modeN    = outerModes(i, plan.mRankM, plan.mRankN, plan.mRankK)[1];
+            auto stride   = modeN < strides.size() ? strides[modeN] : 0;
+            auto segments = i == 0 ? std::vector<std::pair<uint32_t, StreamingTile>>{{0u, tile}}
+                                   : plan.outputSegments(tile);
+            for(auto const& part : segments)
+            {
+                auto const& segment = part.second;
+
+                auto  host  = plan.tileOffsets(segment)[i] * elementBytes[i];
+                auto  start = part.first * plan.mOutputN + segment.mStartN - tile.mStartN;
+                auto* block = (char*)packed + start * stride * elementBytes[i];
+
+                auto result = HIPTENSOR_STATUS_SUCCESS;
+                if(i == 3)
+                {
+                    result = backend.download((char*)D[part.first] + host,
+                                              plan.mStrides[i],
+                                              block,
+                                              strides,
+                                              plan.tileLengths(segment)[i],
+                                              elementBytes[i],
+                                              slot);
+                }
+                else
+                {
+                    auto const* src = i == 0 ? A : (i == 1 ? B : C)[part.first];
+                    result          = backend.upload(block,
+                                            strides,
+                                            (char const*)src + host,
+                                            plan.mStrides[i],
+                                            plan.tileLengths(segment)[i],
+                                            elementBytes[i],
+                                            slot);
+                }
+                if(result != HIPTENSOR_STATUS_SUCCESS)
+                {
+                    return result;
+                }
+            }
+            return HIPTENSOR_STATUS_SUCCESS;
+        };
+
+        if(hints != nullptr)
+        {
+            for(int i = 0; i < 3; i++)
+            {
+                auto span = plan.tileSpan(tiles[0], i);
+                if(inputs(0)[i])
+                {
+                    hints->willNeed(i, span.first, span.second);
+                }
+            }
+        }
+
+        // Output tiles take the slots round-robin; K tiles stay in their output's slot
+        std::size_t output = 0;
+        for(std::size_t t = 0; t < tiles.size() && status == HIPTENSOR_STATUS_SUCCESS; t++)
+        {
+            // Read ahead the next tile while this one is transferred and contracted
+            if(hints != nullptr && t + 1 < tiles.size())
+            {
+                for(int i = 0; i < 3; i++)
+                {
+                    auto span = plan.tileSpan(tiles[t + 1], i);
+                    if(inputs(t + 1)[i])
+                    {
+                        hints->willNeed(i, span.first, span.second);
+                    }
+                }
+            }
+
+            auto const& tile    = tiles[t];
+            auto        first   = tile.mStartK == 0;
+            auto        last    = tile.mStartK + tile.mExtentK >= plan.mOuterK;
+            auto        slot    = uint32_t(output % slots);
+            auto        lengths = plan.tileLengths(tile);
+
+            auto* base      = (char*)device + slot * plan.mSlotBytes;
+            auto* tileA     = base + plan.mSlotOffsets[0];
+            auto* tileB     = base + plan.mSlotOffsets[1];
+            auto* tileD     = base + plan.mSlotOffsets[2];
+            auto* workspace = base + plan.mWorkspaceOffset;
+
+            status = transfer(0, tile, tileA, slot);
+            if(status == HIPTENSOR_STATUS_SUCCESS && packedB == nullptr)
+            {
+                status = transfer(1, tile, tileB, slot);
+            }
+            if(status == HIPTENSOR_STATUS_SUCCESS && first && hasC)
+            {
+                status = transfer(2, tile, tileD, slot);
+            }
+            if(status == HIPTENSOR_STATUS_SUCCESS && packedB != nullptr)
+            {
+                auto accumulate = hasC || !first;
+                status          = backend.contractPanels(alpha,
+                                                tileA,
+                                                *packedB,
+                                                tile.mStartN * packedB->mInnerN,
+                                                tile.mStartK * packedB->mInnerK,
+                                                first ? beta : one,
+                                                accumulate ? tileD : nullptr,
+                                                tileD,
+                                                lengths,
+                                                workspace,
+                                                slot);
+            }
+            else if(status == HIPTENSOR_STATUS_SUCCESS)
+            {
+                auto accumulate = hasC || !first;
+                status          = backend.contract(alpha,
+                                          tileA,
+                                          tileB,
+                                          first ? beta : one,
+                                          accumulate ? tileD : nullptr,
+                                          tileD,
+                                          lengths,
+                                          workspace,
+                                          slot);
+            }
+            if(status == HIPTENSOR_STATUS_SUCCESS && last)
+            {
+                status = transfer(3, tile, tileD, slot);
+                output++;
+            }
+
+            // Release inputs that the next tile does not read again
+            if(hints != nullptr)
+            {
+                auto last = t + 1 == tiles.size();
+                for(int i = 0; i < 3; i++)
+                {
+                    auto span  = plan.tileSpan(tile, i);
+                    auto reuse = !last && inputs(t + 1)[i]
+                                 && plan.tileSpan(tiles[t + 1], i) == span;
+                    if(inputs(t)[i] && !reuse)
+                    {
+                        hints->dontNeed(i, span.first, span.second);
+                    }
+                }
+            }
+        }
+
+        auto syncStatus = backend.synchronize();
+        backend.release(device);
+        return status != HIPTENSOR_STATUS_SUCCESS ? status : syncStatus;
+    }
+
+} // namespace hiptensor
@@ -0,0 +1,441 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "contraction_symmetric.hpp"
+#include "util.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        int modeIndex(std::vector<int32_t> const& modes, int32_t mode)
+        {
+            auto it = std::find(modes.begin(), modes.end(), mode);
+            return it == modes.end() ? -1 : int(it - modes.begin());
+        }
+
+        hiptensorStatus_t makeShape(hiptensorDimVector_t const&                  lengths,
+                                    std::vector<hiptensorSymmetryGroup_t> const& groups,
+                                    SymmetricShape*                              shape)
+        {
+            if(lengths.size() > SymmetricMaxRank || groups.size() > SymmetricMaxRank)
+            {
+                return HIPTENSOR_STATUS_NOT_SUPPORTED;
+            }
+
+            *shape       = {};
+            shape->mRank = uint32_t(lengths.size());
+            for(uint32_t mode = 0; mode < shape->mRank; mode++)
+            {
+                shape->mLengths[mode] = lengths[mode];
+                shape->mGroup[mode]   = -1;
+                shape->mLeads[mode]   = true;
+            }
+
+            for(int32_t g = 0; g < groups.size(); g++)
+            {
+                auto const& modes = groups[g].mModes;
+                if(modes.size() < 2)
+                {
+                    return HIPTENSOR_STATUS_INVALID_VALUE;
+                }
+                for(auto mode : modes)
+                {
+                    if(mode >= shape->mRank || shape->mGroup[mode] >= 0
+                       || lengths[mode] != lengths[modes[0]])
+                    {
+                        return HIPTENSOR_STATUS_INVALID_VALUE;
+                    }
+                    shape->mGroup[mode] = g;
+                }
+                shape->mAntisymmetric[g] = groups[g].mSymmetry == HIPTENSOR_SYMMETRY_ANTISYMMETRIC;
+            }
+
+            // Groups lead from their first mode; packed indices are laid out last fastest
+            std::vector<std::size_t> members(groups.size(), 0);
+            for(uint32_t mode = 0; mode < shape->mRank; mode++)
+            {
+                auto group = shape->mGroup[mode];
+                if(group >= 0)
+                {
+                    shape->mLeads[mode] = members[group]++ == 0;
+                }
+            }
+
+            shape->mElements = 1;
+            for(auto mode = shape->mRank; mode-- > 0;)
+            {
+                if(!shape->mLeads[mode])
+                {
+                    continue;
+                }
+
+                auto group  = shape->mGroup[mode];
+                auto length = shape->mLengths[mode];
+                if(group >= 0)
+                {
+                    auto k = members[group];
+                    length = shape->mAntisymmetric[group] ? choose(length, k)
+                                                          : choose(length + k - 1, k);
+                }
+                shape->mStrides[mode] = shape->mElements;
+                shape->mElements *= length;
+            }
+            return HIPTENSOR_STATUS_SUCCESS;
+        }
+
+        // Visits the sorted indices of a shape from a mode on, keeping the indices before
+        // it, together with the number of full indices that sort to each of them
+        template <typename Visit>
+        void forEachSorted(SymmetricShape const& shape,
+                           uint32_t              mode,
+                           std::size_t*          index,
+                           Visit&&               visit)
+        {
+            if(mode == shape.mRank)
+            {
+                // Permutations of each group that give distinct indices
+                std::size_t weight = 1;
+                for(uint32_t m = 0; m < shape.mRank; m++)
+                {
+                    auto group = shape.mGroup[m];
+                    if(group < 0 || !shape.mLeads[m])
+                    {
+                        continue;
+                    }
+
+                    std::size_t k = 0, run = 0, last = 0;
+                    for(uint32_t n = m; n < shape.mRank; n++)
+                    {
+                        if(shape.mGroup[n] != group)
+                        {
+                            continue;
+                        }
+                        run = k > 0 && index[n] == last ? run + 1 : 1;
+                        last = index[n];
+                        weight = weight * ++k / run;
+                    }
+                }
+                visit(index, weight);
+                return;
+            }
+
+            // Within a group, each index is bounded by the one of the group's previous mode
+            auto upper = shape.mLengths[mode];
+            auto group = shape.mGroup[mode];
+            for(auto m = mode; group >= 0 && m-- > 0;)
+            {
+                if(shape.mGroup[m] == group)
+                {
+                    upper = shape.mAntisymmetric[group] ? index[m] : index[m] + 1;
+                    break;
+                }
+            }
+
+            for(std::size_t i = 0; i < upper; i++)
+            {
+                index[mode] = i;
+                forEachSorted(shape, mode + 1, index, visit);
+            }
+        }
+
+        template <typename T>
+        T readPacked(SymmetricShape const& shape, T const* data, std::size_t const* index)
+        {
+            std::size_t offset;
+            bool        canonical;
+            auto        sign = symmetricOffset(shape, index, &offset, &canonical);
+            return sign == 0 ? T(0) : sign < 0 ? -data[offset] : data[offset];
+        }
+
+        template <typename T>
+        hiptensorStatus_t contractHost(SymmetricContractionPlan const& plan,
+                                       void const*                     alpha,
+                                       void const*                     A,
+                                       void const*                     B,
+                                       void const*                     beta,
+                                       void const*                     C,
+                                       void*                           D,
+                                       uint32_t                        threads)
+        {
+            auto const& shapeD = plan.mShapes[2];
+            auto        alphaT = *static_cast<T const*>(alpha);
+            auto        betaT  = beta != nullptr ? *static_cast<T const*>(beta) : T(0);
+            auto        hasC   = plan.mHasC && C != nullptr;
+
+            // Where each mode of A and B takes its index from: D's index when it is a
+            // mode of D, the contracted index otherwise
+            std::array<std::vector<std::pair<bool, int>>, 2> sources;
+            for(int i = 0; i < 2; i++)
+            {
+                for(auto mode : plan.mModes[i])
+                {
+                    auto d = modeIndex(plan.mModes[2], mode);
+                    sources[i].emplace_back(d >= 0,
+                                            d >= 0 ? d : modeIndex(plan.mContractedModes, mode));
+                }
+            }
+
+            // D's stored elements are shared out by the index of its first mode
+            auto outer = shapeD.mRank > 0 ? shapeD.mLengths[0] : std::size_t{1};
+            std::atomic<std::size_t> next{0};
+            auto                     worker = [&]() {
+                std::size_t indexD[SymmetricMaxRank], indexK[SymmetricMaxRank];
+                std::array<std::array<std::size_t, SymmetricMaxRank>, 2> index;
+
+                auto element = [&](std::size_t const* d, std::size_t) {
+                    T accum = 0;
+                    forEachSorted(plan.mContracted,
+                                  0,
+                                  indexK,
+                                  [&](std::size_t const* k, std::size_t weight) {
+                                      for(int i = 0; i < 2; i++)
+                                      {
+                                          for(int m = 0; m < sources[i].size(); m++)
+                                          {
+                                              auto source = sources[i][m];
+                                              index[i][m] = source.first ? d[source.second]
+                                                                         : k[source.second];
+                                          }
+                                      }
+                                      accum += T(weight)
+                                               * readPacked(plan.mShapes[0],
+                                                            static_cast<T const*>(A),
+                                                            index[0].data())
+                                               * readPacked(plan.mShapes[1],
+                                                            static_cast<T const*>(B),
+                                                            index[1].data());
+                                  });
+
+                    std::size_t offset;
+                    bool        canonical;
+                    symmetricOffset(shapeD, d, &offset, &canonical);
+                    auto bias = hasC ? betaT * static_cast<T const*>(C)[offset] : T(0);
+                    static_cast<T*>(D)[offset] = alphaT * accum + bias;
+                };
+
+                for(auto i = next++; i < outer; i = next++)
+                {
+                    if(shapeD.mRank == 0)
+                    {
+                        forEachSorted(shapeD, 0, indexD, element);
+                        continue;
+                    }
+                    indexD[0] = i;
+                    forEachSorted(shapeD, 1, indexD, element);
+                }
+            };
+
+            if(threads == 0)
+            {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            threads = uint32_t(std::min<std::size_t>(threads, outer));
+
+            std::vector<std::thread> pool;
+            for(uint32_t i = 1; i < threads; i++)
+            {
+                pool.emplace_back(worker);
+            }
+            worker();
+            for(auto& thread : pool)
+            {
+                thread.join();
+            }
+            return HIPTENSOR_STATUS_SUCCESS;
+        }
+    }
+
+    hiptensorStatus_t symmetricShape(hiptensorSymmetricTensorDescriptor_t const& desc,
+                                     SymmetricShape*                             shape)
+    {
+        return makeShape(desc.mLengths, desc.mGroups, shape);
+    }
+
+    std::size_t fullElements(SymmetricShape const& shape)
+    {
+        std::size_t elements = 1;
+        for(uint32_t mode = 0; mode < shape.mRank; mode++)
+        {
+            elements *= shape.mLengths[mode];
+        }
+        return elements;
+    }
+
+    hiptensorStatus_t planSymmetric(SymmetricContractionPlan*                   plan,
+                                    hiptensorSymmetricTensorDescriptor_t const& descA,
+                                    int32_t const                               modeA[],
+                                    hiptensorSymmetricTensorDescriptor_t const& descB,
+                                    int32_t const                               modeB[],
+                                    hiptensorSymmetricTensorDescriptor_t const& descD,
+                                    int32_t const                               modeD[],
+                                    hiptensorComputeType_t                      typeCompute,
+                                    bool                                        hasC)
+    {
+        if(plan == nullptr)
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        plan->mDescs         = {descA, descB, descD};
+        plan->mComputeType   = typeCompute;
+        plan->mHasC          = hasC;
+        plan->mDensePlan     = {};
+        plan->mWorkspaceSize = 0;
+
+        std::array<int32_t const*, 3> modes = {modeA, modeB, modeD};
+        for(int i = 0; i < 3; i++)
+        {
+            auto rank = plan->mDescs[i].mLengths.size();
+            if(rank > 0 && modes[i] == nullptr)
+            {
+                return HIPTENSOR_STATUS_INVALID_VALUE;
+            }
+            if(auto status = symmetricShape(plan->mDescs[i], &plan->mShapes[i]);
+               status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                return status;
+            }
+            plan->mModes[i].assign(modes[i], modes[i] + rank);
+        }
+
+        // Every mode appears in exactly two operands, with one length
+        for(int i = 0; i < 3; i++)
+        {
+            for(int m = 0; m < plan->mModes[i].size(); m++)
+            {
+                auto count = 0;
+                for(int j = 0; j < 3; j++)
+                {
+                    auto at = modeIndex(plan->mModes[j], plan->mModes[i][m]);
+                    if(at < 0)
+                    {
+                        continue;
+                    }
+                    count++;
+                    if(plan->mDescs[j].mLengths[at] != plan->mDescs[i].mLengths[m])
+                    {
+                        return HIPTENSOR_STATUS_INVALID_VALUE;
+                    }
+                }
+                if(count != 2)
+                {
+                    return HIPTENSOR_STATUS_INVALID_VALUE;
+                }
+            }
+        }
+
+        // Contracted modes, in A's order
+        hiptensorDimVector_t lengths;
+        plan->mContractedModes.clear();
+        for(int m = 0; m < plan->mModes[0].size(); m++)
+        {
+            if(modeIndex(plan->mModes[2], plan->mModes[0][m]) < 0)
+            {
+                plan->mContractedModes.push_back(plan->mModes[0][m]);
+                lengths.push_back(descA.mLengths[m]);
+            }
+        }
+
+        // A group of A over contracted modes only, which B has as well, makes the
+        // product symmetric in those modes; odd permutations negate both factors of
+        // antisymmetric groups alike
+        std::vector<hiptensorSymmetryGroup_t> shared;
+        for(auto const& groupA : descA.mGroups)
+        {
+            std::vector<int32_t> labels;
+            for(auto mode : groupA.mModes)
+            {
+                labels.push_back(plan->mModes[0][mode]);
+            }
+
+            for(auto const& groupB : descB.mGroups)
+            {
+                std::vector<int32_t> labelsB;
+                for(auto mode : groupB.mModes)
+                {
+                    labelsB.push_back(plan->mModes[1][mode]);
+                }
+
+                if(groupB.mSymmetry != groupA.mSymmetry
+                   || !std::is_permutation(
+                       labels.begin(), labels.end(), labelsB.begin(), labelsB.end()))
+                {
+                    continue;
+                }
+
+                hiptensorSymmetryGroup_t group = {groupA.mSymmetry, {}};
+                for(auto label : labels)
+                {
+                    auto k = modeIndex(plan->mContractedModes, label);
+                    if(k < 0)
+                    {
+                        break;
+                    }
+                    group.mModes.push_back(uint32_t(k));
+                }
+                if(group.mModes.size() == labels.size())
+                {
+                    std::sort(group.mModes.begin(), group.mModes.end());
+                    shared.push_back(group);
+                }
+                break;
+            }
+        }
+        return makeShape(lengths, shared, &plan->mContracted);
+    }
+
+    hiptensorStatus_t symmetricContractionHost(SymmetricContractionPlan const& plan,
+                                               void const*                     alpha,
+                                               void const*                     A,
+                                               void const*                     B,
+                                               void const*                     beta,
+                                               void const*                     C,
+                                               void*                           D,
+                                               uint32_t                        threads)
+    {
+        auto type = plan.mDescs[2].mType;
+        if(plan.mDescs[0].mType != type || plan.mDescs[1].mType != type)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        if(type == HIP_R_32F)
+        {
+            return contractHost<float>(plan, alpha, A, B, beta, C, D, threads);
+        }
+        else if(type == HIP_R_64F)
+        {
+            return contractHost<double>(plan, alpha, A, B, beta, C, D, threads);
+        }
+        return HIPTENSOR_STATUS_NOT_SUPPORTED;
+    }
+
+} // namespace hiptensor
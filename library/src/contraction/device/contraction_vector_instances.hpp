@@ -0,0 +1,269 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef CONTRACTION_VECTOR_INSTANCES_HPP
+#define CONTRACTION_VECTOR_INSTANCES_HPP
+
+#include "common.hpp"
+
+// Narrow vector width families of the f32 contraction instances.
+// They mirror the default families with SrcScalarPerVector and
+// CDEScalarPerVector capped at 2 or 1, so that operands with odd
+// fastest-mode lengths or partial alignment can still be vectorized.
+namespace ck
+{
+    namespace tensor_operation
+    {
+        namespace device
+        {
+            namespace instance
+            {
+                using F32         = float;
+                using F32_Tuple   = ck::Tuple<F32>;
+                using Empty_Tuple = ck::Tuple<>;
+
+                using PassThrough = ck::tensor_operation::element_wise::PassThrough;
+                using Bilinear    = ck::tensor_operation::element_wise::Bilinear;
+                using Scale       = ck::tensor_operation::element_wise::Scale;
+
+                // Bilinear f32, 2-wide vector access
+                void
+                    add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_kknn_vec2_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               F32_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Bilinear>>>& instances);
+
+                void
+                    add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_knnn_vec2_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               F32_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Bilinear>>>& instances);
+
+                void
+                    add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_mknn_vec2_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               F32_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Bilinear>>>& instances);
+
+                void
+                    add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_mnnn_vec2_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               F32_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Bilinear>>>& instances);
+
+                // Bilinear f32, 1-wide vector access
+                void
+                    add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_kknn_vec1_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               F32_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Bilinear>>>& instances);
+
+                void
+                    add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_knnn_vec1_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               F32_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Bilinear>>>& instances);
+
+                void
+                    add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_mknn_vec1_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               F32_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Bilinear>>>& instances);
+
+                void
+                    add_device_contraction_bilinear_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_f32_mnnn_vec1_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               F32_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Bilinear>>>& instances);
+
+                // Scale f32, 2-wide vector access
+                void
+                    add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_kkn_vec2_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               Empty_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Scale>>>& instances);
+
+                void
+                    add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_knn_vec2_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               Empty_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Scale>>>& instances);
+
+                void
+                    add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_mkn_vec2_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               Empty_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Scale>>>& instances);
+
+                void
+                    add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_mnn_vec2_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               Empty_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Scale>>>& instances);
+
+                // Scale f32, 1-wide vector access
+                void
+                    add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_kkn_vec1_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               Empty_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Scale>>>& instances);
+
+                void
+                    add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_knn_vec1_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               Empty_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Scale>>>& instances);
+
+                void
+                    add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_mkn_vec1_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               Empty_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Scale>>>& instances);
+
+                void
+                    add_device_contraction_scale_m2_n2_k2_xdl_c_shuffle_f32_f32_f32_mnn_vec1_instance(
+                        std::vector<std::unique_ptr<DeviceContractionMultipleD<2,
+                                                                               2,
+                                                                               2,
+                                                                               F32,
+                                                                               F32,
+                                                                               Empty_Tuple,
+                                                                               F32,
+                                                                               PassThrough,
+                                                                               PassThrough,
+                                                                               Scale>>>& instances);
+
+            } // namespace instance
+        } // namespace device
+    } // namespace tensor_operation
+} // namespace ck
+
+#endif // CONTRACTION_VECTOR_INSTANCES_HPP
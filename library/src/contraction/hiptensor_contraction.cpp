@@ -23,47 +23,41 @@
  * THE SOFTWARE.
  *
  *******************************************************************************/
+#include <cstring>
+#include <limits>
+
 #include <hiptensor/hiptensor.hpp>
 
+#include "contraction_launch.hpp"
 #include "contraction_selection.hpp"
 #include "contraction_solution.hpp"
 #include "contraction_solution_instances.hpp"
 #include "contraction_solution_registry.hpp"
+#include "contraction_staging.hpp"
+#include "degenerate_contraction.hpp"
 #include "handle.hpp"
 #include "hip_device.hpp"
 #include "logger.hpp"
+#include "util.hpp"
 
-// Convert between vectors of void ptrs stored in opaque API objects
-// to vectors of ContractionSolution ptrs with simple cast.
-inline auto toContractionSolutionVec(std::vector<void*> const& v)
+// Pre-packed B operands are packed with K innermost and rows padded to whole vectors
+inline auto packedOperandStrides(hiptensor::TensorSignature const* tensor)
 {
-    auto result = std::vector<hiptensor::ContractionSolution*>(v.size());
-    std::transform(v.begin(), v.end(), result.begin(), [](auto* p) {
-        return (hiptensor::ContractionSolution*)p;
-    });
-    return result;
+    auto elementBytes = hiptensor::hipDataTypeSize(tensor->mType);
+    auto multiple     = std::max<std::size_t>(hiptensor::MaxVectorBytes / elementBytes, 1u);
+    return hiptensor::paddedStridesFromLengths(tensor->mLengths, multiple);
 }
 
-inline auto toContractionSolutionVec(
-    std::unordered_map<std::size_t, hiptensor::ContractionSolution*> const& map)
+inline uint64_t packedOperandBytes(hiptensor::TensorSignature const* tensor)
 {
-    auto result = std::vector<hiptensor::ContractionSolution*>(map.size());
-    transform(map.begin(), map.end(), result.begin(), [](auto p) { return p.second; });
-    return result;
-}
+    auto elementBytes = hiptensor::hipDataTypeSize(tensor->mType);
+    if(tensor->mLengths.empty())
+    {
+        return elementBytes;
+    }
 
-inline auto toVoidVec(std::vector<hiptensor::ContractionSolution*> const& v)
-{
-    auto result = std::vector<void*>(v.size());
-    transform(v.begin(), v.end(), result.begin(), [](auto* p) { return (void*)p; });
-    return result;
-}
-
-inline auto toVoidVec(std::unordered_map<std::size_t, hiptensor::ContractionSolution*> const& map)
-{
-    auto result = std::vector<void*>(map.size());
-    transform(map.begin(), map.end(), result.begin(), [](auto p) { return (void*)p.second; });
-    return result;
+    auto strides = packedOperandStrides(tensor);
+    return tensor->mLengths[0] * strides[0] * elementBytes;
 }
 
 hiptensorStatus_t hiptensorInitContractionDescriptor(const hiptensorHandle_t*           handle,
@@ -142,6 +136,22 @@ hiptensorStatus_t hiptensorInitContractionDescriptor(const hiptensorHandle_t*
         return errorCode;
     }
 
+    // Zero strides broadcast inputs, but would make an output element shared by many threads
+    for(int i = 0; i < descD->mLengths.size(); i++)
+    {
+        if(descD->mLengths[i] > 1 && descD->mStrides[i] == 0)
+        {
+            auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+            snprintf(msg,
+                     sizeof(msg),
+                     "Input Parameter Error : D mode %d has zero stride (%s)",
+                     i,
+                     hiptensorGetErrorString(errorCode));
+            logger->logError("hiptensorInitContractionDescriptor", msg);
+            return errorCode;
+        }
+    }
+
     if(descC == nullptr || modeC == nullptr)
     {
         // Use a scale contraction due to
@@ -149,13 +159,13 @@ hiptensorStatus_t hiptensorInitContractionDescriptor(const hiptensorHandle_t*
 
         *desc = {(int32_t)hiptensor::ContractionOpId_t::SCALE,
                  typeCompute,
-                 {*descA,
-                  *descB,
-                  {hiptensor::NONE_TYPE,
-                   std::vector<std::size_t>(descD->mLengths.size(), 0),
-                   std::vector<std::size_t>(descD->mStrides.size(), 0)},
-                  *descD},
-                 {alignmentRequirementA, alignmentRequirementB, 0, alignmentRequirementD}};
+                 {{*descA,
+                   *descB,
+                   {hiptensor::NONE_TYPE,
+                    hiptensorDimVector_t(descD->mLengths.size(), 0),
+                    hiptensorDimVector_t(descD->mStrides.size(), 0)},
+                   *descD}},
+                 {{alignmentRequirementA, alignmentRequirementB, 0, alignmentRequirementD}}};
     }
     else
     {
@@ -163,13 +173,101 @@ hiptensorStatus_t hiptensorInitContractionDescriptor(const hiptensorHandle_t*
         // tensor C-descriptor is not empty
         *desc = {(int32_t)hiptensor::ContractionOpId_t::BILINEAR,
                  typeCompute,
-                 {*descA, *descB, *descC, *descD},
-                 {alignmentRequirementA,
-                  alignmentRequirementB,
-                  alignmentRequirementC,
-                  alignmentRequirementD}};
+                 {{*descA, *descB, *descC, *descD}},
+                 {{alignmentRequirementA,
+                   alignmentRequirementB,
+                   alignmentRequirementC,
+                   alignmentRequirementD}}};
+    }
+
+    // Share one analyzed record between all equal descriptors on this handle
+    auto realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    desc->mOutputs  = 1;
+    realHandle->getDescriptorCache().bind(*desc);
+
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t
+    hiptensorInitMultiOutputContractionDescriptor(const hiptensorHandle_t*           handle,
+                                                  hiptensorContractionDescriptor_t*  desc,
+                                                  const hiptensorTensorDescriptor_t* descA,
+                                                  const int32_t                      modeA[],
+                                                  const uint32_t alignmentRequirementA,
+                                                  const hiptensorTensorDescriptor_t* descB,
+                                                  const int32_t                      modeB[],
+                                                  const uint32_t alignmentRequirementB,
+                                                  const hiptensorTensorDescriptor_t* descC,
+                                                  const int32_t                      modeC[],
+                                                  const uint32_t alignmentRequirementC,
+                                                  const hiptensorTensorDescriptor_t* descD,
+                                                  const int32_t                      modeD[],
+                                                  const uint32_t         alignmentRequirementD,
+                                                  hiptensorComputeType_t typeCompute,
+                                                  uint32_t               numOutputs)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[256];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, desc=0x%llX, numOutputs=%u",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)desc,
+             numOutputs);
+    logger->logAPITrace("hiptensorInitMultiOutputContractionDescriptor", msg);
+
+    if(numOutputs == 0)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : numOutputs = 0 (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitMultiOutputContractionDescriptor", msg);
+        return errorCode;
+    }
+
+    auto status = hiptensorInitContractionDescriptor(handle,
+                                                     desc,
+                                                     descA,
+                                                     modeA,
+                                                     alignmentRequirementA,
+                                                     descB,
+                                                     modeB,
+                                                     alignmentRequirementB,
+                                                     descC,
+                                                     modeC,
+                                                     alignmentRequirementC,
+                                                     descD,
+                                                     modeD,
+                                                     alignmentRequirementD,
+                                                     typeCompute);
+    if(status != HIPTENSOR_STATUS_SUCCESS || numOutputs == 1)
+    {
+        return status;
+    }
+
+    // Outputs are concatenated along the outermost N mode, so B must have one
+    auto* signature = static_cast<hiptensor::ContractionSignature const*>(desc->mSignature);
+    if(signature->mRankN == 0)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Multiple outputs need B to have a free mode (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitMultiOutputContractionDescriptor", msg);
+        return errorCode;
     }
 
+    auto realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    desc->mOutputs  = numOutputs;
+    realHandle->getDescriptorCache().bind(*desc);
+
     return HIPTENSOR_STATUS_SUCCESS;
 }
 
@@ -234,8 +332,11 @@ hiptensorStatus_t hiptensorInitContractionFind(const hiptensorHandle_t*    handl
     if(algo == HIPTENSOR_ALGO_DEFAULT || algo == HIPTENSOR_ALGO_DEFAULT_PATIENT
        || algo == HIPTENSOR_ALGO_ACTOR_CRITIC)
     {
-        // Update the stored selection algorithm
+        // Update the stored selection algorithm, ranking the fastest candidates first
         find->mSelectionAlgorithm = algo;
+        find->mSelectionPolicy    = HIPTENSOR_SELECTION_FASTEST;
+        find->mWorkspaceCap       = std::numeric_limits<uint64_t>::max();
+        find->mTolerance          = 0.0f;
 
         // For now, enumerate all known contraction kernels.
         // Using the hipDevice, determine if the device supports F64
@@ -281,27 +382,71 @@ hiptensorStatus_t hiptensorInitContractionFind(const hiptensorHandle_t*    handl
     }
 }
 
-hiptensorStatus_t hiptensorContractionGetWorkspaceSize(const hiptensorHandle_t* handle,
-                                                       const hiptensorContractionDescriptor_t* desc,
-                                                       const hiptensorContractionFind_t*       find,
-                                                       const hiptensorWorksizePreference_t     pref,
-                                                       uint64_t* workspaceSize)
+hiptensorStatus_t hiptensorContractionFindSetPolicy(const hiptensorHandle_t*    handle,
+                                                    hiptensorContractionFind_t* find,
+                                                    hiptensorSelectionPolicy_t  policy,
+                                                    uint64_t                    workspaceCap,
+                                                    float                       tolerance)
 {
     using hiptensor::Logger;
     auto& logger = Logger::instance();
 
     // Log API access
-    char msg[512];
+    char msg[256];
     snprintf(msg,
              sizeof(msg),
-             "handle=0x%0*llX, desc=0x%llX, find=0x%llX, pref=0x%02X, workspaceSize=0x%04lX",
+             "handle=0x%0*llX, find=0x%llX, policy=0x%02X, workspaceCap=0x%04lX, tolerance=%f",
              2 * (int)sizeof(void*),
              (unsigned long long)handle,
-             (unsigned long long)desc,
              (unsigned long long)find,
-             (unsigned int)pref,
-             (unsigned long)*workspaceSize);
-    logger->logAPITrace("hiptensorContractionGetWorkspaceSize", msg);
+             (unsigned int)policy,
+             (unsigned long)workspaceCap,
+             tolerance);
+    logger->logAPITrace("hiptensorContractionFindSetPolicy", msg);
+
+    if(handle == nullptr || find == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle/find = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionFindSetPolicy", msg);
+        return errorCode;
+    }
+
+    if((policy != HIPTENSOR_SELECTION_FASTEST && policy != HIPTENSOR_SELECTION_SMALLEST_WORKSPACE
+        && policy != HIPTENSOR_SELECTION_BANDWIDTH_EFFICIENT)
+       || !(tolerance >= 0.0f))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Invalid selection policy %d or tolerance %f (%s)",
+                 (int)policy,
+                 tolerance,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionFindSetPolicy", msg);
+        return errorCode;
+    }
+
+    find->mSelectionPolicy = policy;
+    find->mWorkspaceCap    = workspaceCap;
+    find->mTolerance       = tolerance;
+
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorContractionGetWorkspaceSize(const hiptensorHandle_t* handle,
+                                                       const hiptensorContractionDescriptor_t* desc,
+                                                       const hiptensorContractionFind_t*       find,
+                                                       const hiptensorWorksizePreference_t     pref,
+                                                       uint64_t* workspaceSize)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    char msg[512];
 
     if(handle == nullptr || desc == nullptr || find == nullptr || workspaceSize == nullptr)
     {
@@ -338,8 +483,26 @@ hiptensorStatus_t hiptensorContractionGetWorkspaceSize(const hiptensorHandle_t*
         return errorCode;
     }
 
+    // Log API access once workspaceSize is known to be readable
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, desc=0x%llX, find=0x%llX, pref=0x%02X, workspaceSize=0x%04lX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)desc,
+             (unsigned long long)find,
+             (unsigned int)pref,
+             (unsigned long)*workspaceSize);
+    logger->logAPITrace("hiptensorContractionGetWorkspaceSize", msg);
+
     *workspaceSize = 0u;
 
+    auto  realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto* signature  = realHandle->getDescriptorCache().signature(*desc);
+
+    // Every partition reuses the workspace, so the largest one decides its size
+    auto lengths = signature->partitionLengths(signature->mPartitionM, signature->mPartitionN);
+
     for(auto* candidate : find->mCandidates)
     {
         auto* solution = (hiptensor::ContractionSolution*)candidate;
@@ -349,15 +512,16 @@ hiptensorStatus_t hiptensorContractionGetWorkspaceSize(const hiptensorHandle_t*
                               nullptr,
                               nullptr,
                               nullptr,
-                              desc->mTensorDesc[0].mLengths,
-                              desc->mTensorDesc[0].mStrides,
-                              desc->mTensorDesc[1].mLengths,
-                              desc->mTensorDesc[1].mStrides,
-                              desc->mTensorDesc[2].mLengths,
-                              desc->mTensorDesc[2].mStrides,
-                              desc->mTensorDesc[3].mLengths,
-                              desc->mTensorDesc[3].mStrides,
-                              nullptr))
+                              lengths[0],
+                              signature->mKernelStrides[0],
+                              lengths[1],
+                              signature->mKernelStrides[1],
+                              lengths[2],
+                              signature->mKernelStrides[2],
+                              lengths[3],
+                              signature->mKernelStrides[3],
+                              nullptr)
+           && solution->workspaceSize() <= find->mWorkspaceCap)
         {
             if(*workspaceSize == 0)
             {
@@ -377,9 +541,106 @@ hiptensorStatus_t hiptensorContractionGetWorkspaceSize(const hiptensorHandle_t*
         }
     }
 
+    // Packed copies of operands that kernels cannot load directly
+    *workspaceSize += signature->mStagingBytes;
+
+    // Reductions of degenerate shapes split K over more blocks with room for partial sums
+    if(pref != HIPTENSOR_WORKSPACE_MIN)
+    {
+        *workspaceSize = std::max<uint64_t>(
+            *workspaceSize, hiptensor::degenerateWorkspaceSize(signature->mSqueezed));
+    }
+
+    // The unscaled product, when the scalars are read from device memory
+    if(realHandle->getPointerMode() == HIPTENSOR_POINTER_MODE_DEVICE)
+    {
+        *workspaceSize += scalarProductBytes(signature);
+    }
+
     return HIPTENSOR_STATUS_SUCCESS;
 }
 
+hiptensorStatus_t hiptensorContractionGetMetrics(const hiptensorHandle_t*                handle,
+                                                 const hiptensorContractionDescriptor_t* desc,
+                                                 hiptensorContractionMetrics_t*          metrics)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[256];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, desc=0x%llX, metrics=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)desc,
+             (unsigned long long)metrics);
+    logger->logAPITrace("hiptensorContractionGetMetrics", msg);
+
+    if(handle == nullptr || desc == nullptr || metrics == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle/desc/metrics = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionGetMetrics", msg);
+        return errorCode;
+    }
+
+    auto  realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto& problem    = realHandle->getDescriptorCache().signature(*desc)->mMetrics;
+
+    metrics->mM     = problem.mM;
+    metrics->mN     = problem.mN;
+    metrics->mK     = problem.mK;
+    metrics->mFlops = problem.mFlops;
+    for(int i = 0; i < 4; i++)
+    {
+        metrics->mBytes[i] = problem.mOperandBytes[i];
+    }
+    metrics->mTotalBytes = problem.mBytes;
+    metrics->mSaturated  = problem.mSaturated;
+
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+// Times plan selection on the null stream. The events are released on every exit.
+class SelectionTimer
+{
+public:
+    SelectionTimer()
+    {
+        CHECK_HIP_ERROR(hipEventCreate(&mStart));
+        CHECK_HIP_ERROR(hipEventCreate(&mStop));
+        CHECK_HIP_ERROR(hipEventRecord(mStart));
+    }
+
+    ~SelectionTimer()
+    {
+        CHECK_HIP_ERROR(hipEventDestroy(mStart));
+        CHECK_HIP_ERROR(hipEventDestroy(mStop));
+    }
+
+    SelectionTimer(SelectionTimer const&)            = delete;
+    SelectionTimer& operator=(SelectionTimer const&) = delete;
+
+    float elapsedMs()
+    {
+        CHECK_HIP_ERROR(hipEventRecord(mStop));
+        CHECK_HIP_ERROR(hipEventSynchronize(mStop));
+
+        auto elapsedTimeMs = 0.0f;
+        CHECK_HIP_ERROR(hipEventElapsedTime(&elapsedTimeMs, mStart, mStop));
+        return elapsedTimeMs;
+    }
+
+private:
+    hipEvent_t mStart = nullptr;
+    hipEvent_t mStop  = nullptr;
+};
+
 hiptensorStatus_t hiptensorInitContractionPlan(const hiptensorHandle_t*                handle,
                                                hiptensorContractionPlan_t*             plan,
                                                const hiptensorContractionDescriptor_t* desc,
@@ -440,21 +701,54 @@ hiptensorStatus_t hiptensorInitContractionPlan(const hiptensorHandle_t*
 
     auto realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
 
-    // Ensure current HIP device is same as the handle.
-    hiptensor::HipDevice currentDevice;
-    if((int)currentDevice.getDeviceId() != realHandle->getDevice().getDeviceId())
+    // Ensure current HIP device is same as the handle. Only the id is queried, so that
+    // plans served from the cache neither query device properties nor allocate.
+    int currentDeviceId = -1;
+    CHECK_HIP_ERROR(hipGetDevice(&currentDeviceId));
+    if(currentDeviceId != realHandle->getDevice().getDeviceId())
     {
         auto errorCode = HIPTENSOR_STATUS_ARCH_MISMATCH;
         snprintf(msg,
                  sizeof(msg),
                  "Device mismatch error: current device id: %d, handle device id: %d (%s)",
-                 (int)currentDevice.getDeviceId(),
+                 currentDeviceId,
                  (int)realHandle->getDevice().getDeviceId(),
                  hiptensorGetErrorString(errorCode));
         logger->logError("hiptensorInitContractionPlan", msg);
         return HIPTENSOR_STATUS_ARCH_MISMATCH;
     }
 
+    // Equal contractions share one interned signature, so a previous selection for the same
+    // problem, algorithm, workspace, policy and candidates can be reused directly. The
+    // signature is retained so that eviction cannot release it during selection.
+    auto& descCache = realHandle->getDescriptorCache();
+    auto* signature = descCache.signature(*desc);
+    auto  keep      = descCache.retain(signature);
+    auto  policy    = hiptensor::SelectionPolicy::of(*find);
+    if(auto* cached = descCache.findPlan(
+           signature, find->mSelectionAlgorithm, workspaceSize, policy, find->mCandidates))
+    {
+        // Kernel names are only built when they are logged
+        auto* winner = (hiptensor::ContractionSolution*)cached;
+        if(logger->getLogMask() & HIPTENSOR_LOG_LEVEL_HEURISTICS_TRACE)
+        {
+            snprintf(msg,
+                     sizeof(msg),
+                     "Algo: %d, KernelId: %lu, KernelName: %s, cached selection",
+                     find->mSelectionAlgorithm,
+                     winner->uid(),
+                     winner->kernelName().c_str());
+            logger->logHeuristics("hiptensorInitContractionPlan", msg);
+        }
+
+        plan->mContractionDesc             = *desc;
+        plan->mContractionDesc.mSignature  = signature;
+        plan->mContractionDesc.mGeneration = signature->mGeneration;
+        plan->mSolution                    = winner;
+
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
     // At this point, we need to format inputs for kernels as they will be tested via selection model.
     // Brute force method currently uses CK kernel format, so we will adjust inputs to that style.
 
@@ -473,59 +767,161 @@ hiptensorStatus_t hiptensorInitContractionPlan(const hiptensorHandle_t*
 
     candidates = toContractionSolutionVec(solutionQ.solutions());
 
+    // Staged operand copies take the front of the workspace
+    if(workspaceSize < signature->mStagingBytes)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Insufficient workspace for staged operands: req: %lu alloc: %lu (%s)",
+                 signature->mStagingBytes,
+                 workspaceSize,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitContractionPlan", msg);
+        return errorCode;
+    }
+    auto kernelWorkspaceSize = workspaceSize - signature->mStagingBytes;
+
+    // Operands beyond 32-bit kernel indexing are contracted in partitions.
+    // Selection is made for the largest partition and reused by the others.
+    if(signature->mPartitions == 0)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Operands exceed 32-bit kernel indexing and cannot be partitioned (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitContractionPlan", msg);
+        return errorCode;
+    }
+    else if(signature->mPartitions > 1)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Algo: %d, splitting into %lu partitions of outer extents M: %lu, N: %lu",
+                 find->mSelectionAlgorithm,
+                 signature->mPartitions,
+                 signature->mPartitionM,
+                 signature->mPartitionN);
+        logger->logHeuristics("hiptensorInitContractionPlan", msg);
+    }
+    auto lengths = signature->partitionLengths(signature->mPartitionM, signature->mPartitionN);
+
     // Measure timing for solution selection
-    hipEvent_t startEvent, stopEvent;
-    CHECK_HIP_ERROR(hipEventCreate(&startEvent));
-    CHECK_HIP_ERROR(hipEventCreate(&stopEvent));
+    SelectionTimer timer;
 
-    CHECK_HIP_ERROR(hipEventRecord(startEvent));
+    // Launch selection algorithm.
+    // Candidates of every vector width from the widest that every operand allows down to
+    // scalar access compete together, so that odd extents and partial alignments still get
+    // vectorized kernels and the policy weighs narrower kernels against wider ones.
+    auto maxVectorWidth = signature->mVectorWidth;
 
-    // Launch selection algorithm
     hiptensor::ContractionSolution* winner = nullptr;
     auto                            result = HIPTENSOR_STATUS_INTERNAL_ERROR;
-    if(find->mSelectionAlgorithm == HIPTENSOR_ALGO_DEFAULT
-       || find->mSelectionAlgorithm == HIPTENSOR_ALGO_DEFAULT_PATIENT)
-    {
-        result = hiptensor::bruteForceModel(&winner,
-                                            candidates,
-                                            ADataType,
-                                            desc->mTensorDesc[0].mLengths,
-                                            desc->mTensorDesc[0].mStrides,
-                                            BDataType,
-                                            desc->mTensorDesc[1].mLengths,
-                                            desc->mTensorDesc[1].mStrides,
-                                            DDataType,
-                                            desc->mTensorDesc[2].mLengths,
-                                            desc->mTensorDesc[2].mStrides,
-                                            EDataType,
-                                            desc->mTensorDesc[3].mLengths,
-                                            desc->mTensorDesc[3].mStrides,
-                                            workspaceSize);
+
+    auto bruteForceByVectorWidth = [&]() {
+        std::vector<hiptensor::ContractionSolution*> allowed;
+        for(auto width = maxVectorWidth; width > 0u; width /= 2u)
+        {
+            auto tier = hiptensor::filterByVectorWidth(candidates, width);
+            allowed.insert(allowed.end(), tier.begin(), tier.end());
+        }
+        if(allowed.empty())
+        {
+            return HIPTENSOR_STATUS_EXECUTION_FAILED;
+        }
+
+        return hiptensor::bruteForceModel(&winner,
+                                          allowed,
+                                          ADataType,
+                                          lengths[0],
+                                          signature->mKernelStrides[0],
+                                          BDataType,
+                                          lengths[1],
+                                          signature->mKernelStrides[1],
+                                          DDataType,
+                                          lengths[2],
+                                          signature->mKernelStrides[2],
+                                          EDataType,
+                                          lengths[3],
+                                          signature->mKernelStrides[3],
+                                          kernelWorkspaceSize,
+                                          policy);
+    };
+
+    // Degenerate shapes do not run the selected kernel, which only serves paths that
+    // tile the problem, so no candidate is timed and any of the right types will do
+    auto shape = signature->mSqueezed.mShape;
+    if(shape != hiptensor::ContractionShape::GENERAL)
+    {
+        if(!candidates.empty())
+        {
+            winner = candidates.front();
+            result = HIPTENSOR_STATUS_SUCCESS;
+        }
+
+        snprintf(msg,
+                 sizeof(msg),
+                 "Algo: %d, %s of M: %lu, N: %lu, K: %lu routed to a bandwidth-bound kernel",
+                 find->mSelectionAlgorithm,
+                 hiptensor::contractionShapeName(shape),
+                 signature->mSqueezed.mM,
+                 signature->mSqueezed.mN,
+                 signature->mSqueezed.mK);
+        logger->logHeuristics("hiptensorInitContractionPlan", msg);
+    }
+    else if(find->mSelectionAlgorithm == HIPTENSOR_ALGO_DEFAULT
+            || find->mSelectionAlgorithm == HIPTENSOR_ALGO_DEFAULT_PATIENT)
+    {
+        result = bruteForceByVectorWidth();
+    }
+    else if(find->mSelectionAlgorithm == HIPTENSOR_ALGO_ACTOR_CRITIC && !policy.isDefault())
+    {
+        // The trained model predicts the fastest kernel regardless of its workspace
+        snprintf(msg,
+                 sizeof(msg),
+                 "Algo: %d, selection policy %d with workspace cap %lu, using brute force",
+                 find->mSelectionAlgorithm,
+                 (int)policy.mPolicy,
+                 policy.mWorkspaceCap);
+        logger->logHeuristics("hiptensorInitContractionPlan", msg);
+
+        result = bruteForceByVectorWidth();
     }
     else if(find->mSelectionAlgorithm == HIPTENSOR_ALGO_ACTOR_CRITIC)
     {
         result = hiptensor::actorCriticModel(&winner,
                                              solutionQ.solutions(),
                                              ADataType,
-                                             desc->mTensorDesc[0].mLengths,
-                                             desc->mTensorDesc[0].mStrides,
+                                             lengths[0],
+                                             signature->mKernelStrides[0],
                                              BDataType,
-                                             desc->mTensorDesc[1].mLengths,
-                                             desc->mTensorDesc[1].mStrides,
+                                             lengths[1],
+                                             signature->mKernelStrides[1],
                                              DDataType,
-                                             desc->mTensorDesc[2].mLengths,
-                                             desc->mTensorDesc[2].mStrides,
+                                             lengths[2],
+                                             signature->mKernelStrides[2],
                                              EDataType,
-                                             desc->mTensorDesc[3].mLengths,
-                                             desc->mTensorDesc[3].mStrides,
-                                             workspaceSize);
-    }
+                                             lengths[3],
+                                             signature->mKernelStrides[3],
+                                             kernelWorkspaceSize);
+
+        // The trained model only knows the default families
+        if(result != HIPTENSOR_STATUS_SUCCESS || winner->vectorWidth() > maxVectorWidth)
+        {
+            snprintf(msg,
+                     sizeof(msg),
+                     "Algo: %d, no model winner for vector width %u, using brute force",
+                     find->mSelectionAlgorithm,
+                     maxVectorWidth);
+            logger->logHeuristics("hiptensorInitContractionPlan", msg);
 
-    CHECK_HIP_ERROR(hipEventRecord(stopEvent));
-    CHECK_HIP_ERROR(hipEventSynchronize(stopEvent));
+            winner = nullptr;
+            result = bruteForceByVectorWidth();
+        }
+    }
 
-    auto elapsedTimeMs = 0.0f;
-    CHECK_HIP_ERROR(hipEventElapsedTime(&elapsedTimeMs, startEvent, stopEvent));
+    auto elapsedTimeMs = timer.elapsedMs();
 
     if(result != HIPTENSOR_STATUS_SUCCESS)
     {
@@ -547,9 +943,14 @@ hiptensorStatus_t hiptensorInitContractionPlan(const hiptensorHandle_t*
              elapsedTimeMs);
     logger->logPerformanceTrace("hiptensorInitContractionPlan", msg);
 
+    descCache.cachePlan(
+        signature, find->mSelectionAlgorithm, workspaceSize, winner, policy, find->mCandidates);
+
     // Assign the contraction descriptor
-    plan->mContractionDesc = *desc;
-    plan->mSolution        = winner;
+    plan->mContractionDesc             = *desc;
+    plan->mContractionDesc.mSignature  = signature;
+    plan->mContractionDesc.mGeneration = signature->mGeneration;
+    plan->mSolution                    = winner;
 
     return HIPTENSOR_STATUS_SUCCESS;
 }
@@ -574,12 +975,22 @@ hiptensorStatus_t hiptensorContraction(const hiptensorHandle_t*          handle,
     char alphaMsg[32];
     char betaMsg[32];
 
+    // Device scalars cannot be read on the host, so only their addresses are logged
+    auto devicePointers
+        = handle != nullptr
+          && hiptensor::Handle::toHandle((int64_t*)handle->fields)->getPointerMode()
+                 == HIPTENSOR_POINTER_MODE_DEVICE;
+
     if(plan != nullptr)
     {
         if(alpha == nullptr)
         {
             snprintf(alphaMsg, sizeof(alphaMsg), "alpha=NULL");
         }
+        else if(devicePointers)
+        {
+            snprintf(alphaMsg, sizeof(alphaMsg), "alpha=%p", alpha);
+        }
         else
         {
             if(plan->mContractionDesc.mComputeType == HIPTENSOR_COMPUTE_32F)
@@ -600,6 +1011,10 @@ hiptensorStatus_t hiptensorContraction(const hiptensorHandle_t*          handle,
         {
             snprintf(betaMsg, sizeof(betaMsg), "beta=NULL");
         }
+        else if(devicePointers)
+        {
+            snprintf(betaMsg, sizeof(betaMsg), "beta=%p", beta);
+        }
         else
         {
             if(plan->mContractionDesc.mComputeType == HIPTENSOR_COMPUTE_32F)
@@ -708,95 +1123,473 @@ hiptensorStatus_t hiptensorContraction(const hiptensorHandle_t*          handle,
         return errorCode;
     }
 
-    if(plan->mContractionDesc.mComputeType != plan->mContractionDesc.mTensorDesc[3].mType)
+    // Plans from this handle carry an interned signature; anything else is re-analyzed
+    auto* signature = realHandle->getDescriptorCache().signature(plan->mContractionDesc);
+
+    if(signature->mOutputs > 1)
     {
         auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
         snprintf(msg,
                  sizeof(msg),
-                 "Internal Error : compute type != D type (%s)",
+                 "Input Parameter Error : plan has %u outputs, use "
+                 "hiptensorContractionMultiOutput (%s)",
+                 signature->mOutputs,
                  hiptensorGetErrorString(errorCode));
         logger->logError("hiptensorContraction", msg);
         return errorCode;
     }
 
-    auto* cSolution = (hiptensor::ContractionSolution*)(plan->mSolution);
-
-    auto canRun = cSolution->initArgs(alpha,
-                                      A,
-                                      B,
-                                      beta,
-                                      C,
-                                      D,
-                                      plan->mContractionDesc.mTensorDesc[0].mLengths,
-                                      plan->mContractionDesc.mTensorDesc[0].mStrides,
-                                      plan->mContractionDesc.mTensorDesc[1].mLengths,
-                                      plan->mContractionDesc.mTensorDesc[1].mStrides,
-                                      plan->mContractionDesc.mTensorDesc[2].mLengths,
-                                      plan->mContractionDesc.mTensorDesc[2].mStrides,
-                                      plan->mContractionDesc.mTensorDesc[3].mLengths,
-                                      plan->mContractionDesc.mTensorDesc[3].mStrides,
-                                      workspace);
+    auto pointerMode = realHandle->getPointerMode();
 
-    if(canRun)
+    // A capturing handle records the contraction for replay instead of running it.
+    // Host scalars are copied since the caller's may not outlive the graph, while device
+    // scalars are kept by address so that replays read their current values. Timing is
+    // off because timed runs synchronize, which a HIP graph capture cannot contain.
+    if(auto* capture = realHandle->getCapture())
     {
-        if(cSolution->workspaceSize() > workspaceSize)
+        auto* cSolution = (hiptensor::ContractionSolution*)(plan->mSolution);
+        auto  scalars   = std::array<std::array<char, 16>, 2>{};
+        auto  bytes     = hiptensor::hipDataTypeSize(signature->mTensors[3]->mType);
+        if(pointerMode == HIPTENSOR_POINTER_MODE_HOST)
+        {
+            std::memcpy(scalars[0].data(), alpha, bytes);
+            if(beta != nullptr)
+            {
+                std::memcpy(scalars[1].data(), beta, bytes);
+            }
+        }
+        auto hasBeta        = beta != nullptr;
+        auto devicePointers = pointerMode == HIPTENSOR_POINTER_MODE_DEVICE;
+
+        // Without a workspace the graph holds a block of its own until it is destroyed.
+        // Replays, and HIP graphs captured from them, reuse its address, so it never
+        // returns to the pool where a trim could free it, and nothing is allocated
+        // while a stream is being captured.
+        auto heldBytes = workspace == nullptr
+                             ? planWorkspaceSize(signature, cSolution, pointerMode)
+                             : uint64_t(0);
+        auto held      = heldBytes > 0 ? realHandle->getWorkspacePool().hold(heldBytes, stream)
+                                       : std::shared_ptr<void>();
+        if(heldBytes > 0 && held == nullptr)
         {
-            auto errorCode = HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+            auto errorCode = HIPTENSOR_STATUS_ALLOC_FAILED;
             snprintf(msg,
                      sizeof(msg),
-                     "Insufficient workspace: req: %lu alloc: %lu (%s)",
-                     cSolution->workspaceSize(),
-                     workspaceSize,
+                     "Unable to allocate %lu bytes of workspace for the graph (%s)",
+                     (unsigned long)heldBytes,
                      hiptensorGetErrorString(errorCode));
             logger->logError("hiptensorContraction", msg);
             return errorCode;
         }
 
-        // Perform contraction with timing if LOG_LEVEL_PERF_TRACE
-        if(logger->getLogMask() & HIPTENSOR_LOG_LEVEL_PERF_TRACE)
-        {
-            auto time = (*cSolution)(StreamConfig{stream, true});
-
-            int32_t m, n, k;
-            std::tie(m, n, k) = cSolution->problemDims();
-            auto flops        = std::size_t(2) * m * n * k;
-            auto bytes        = cSolution->problemBytes();
+        // The graph keeps the signature alive past its eviction from the cache
+        auto keep = realHandle->getDescriptorCache().retain(signature);
+        capture->record({A, B, C, D, workspace},
+                        [=](std::vector<void*> const& buffers, hipStream_t replayStream) {
+                            (void)keep;
+                            auto* scalarAlpha
+                                = devicePointers ? alpha : (void const*)scalars[0].data();
+                            auto* scalarBeta = !hasBeta         ? nullptr
+                                               : devicePointers ? beta
+                                                                : (void const*)scalars[1].data();
+                            auto  bound      = buffers[4] != nullptr;
+                            return runScaledContraction("hiptensorGraphReplay",
+                                                        pointerMode,
+                                                        signature,
+                                                        cSolution,
+                                                        scalarAlpha,
+                                                        buffers[0],
+                                                        buffers[1],
+                                                        scalarBeta,
+                                                        buffers[2],
+                                                        buffers[3],
+                                                        bound ? buffers[4] : held.get(),
+                                                        bound ? workspaceSize : heldBytes,
+                                                        replayStream,
+                                                        false);
+                        });
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
 
-            hiptensor::PerfMetrics metrics = {
-                cSolution->uid(), // id
-                cSolution->kernelName(), // name
-                time, // avg time
-                static_cast<float>(flops) / static_cast<float>(1.E9) / time, // tflops
-                static_cast<float>(bytes) / static_cast<float>(1.E6) / time // BW
-            };
+    // A deferring handle queues the contraction until the next flush
+    if(auto* queue = realHandle->getDeferred())
+    {
+        hiptensor::DeferredOperation op;
+        op.mKind    = hiptensor::DeferredOperation::Kind::Contraction;
+        op.mKernel  = plan->mSolution;
+        op.mStream  = stream;
+        op.mFlops   = signature->mFlops;
+        op.mScalars = {};
+        op.mReads   = {{A, signature->mTensors[0]->mBytes}, {B, signature->mTensors[1]->mBytes}};
+        op.mWrites  = {{D, signature->mTensors[3]->mBytes}};
+        if(C != nullptr)
+        {
+            op.mReads.push_back({C, signature->mTensors[2]->mBytes});
+        }
 
-            // log perf metrics (not name/id)
-            snprintf(msg,
-                     sizeof(msg),
-                     "KernelId: %lu KernelName: %s, %0.3f ms, %0.3f TFlops, %0.3f GB/s",
-                     metrics.mKernelUid,
-                     metrics.mKernelName.c_str(),
-                     metrics.mAvgTimeMs,
-                     metrics.mTflops,
-                     metrics.mBandwidth);
-            logger->logPerformanceTrace("hiptensorContraction", msg);
-        }
-        // Perform contraction without timing
-        else
+        // Device scalars are compared and launched by address, as their values are only
+        // known once the stream reaches the contraction
+        auto devicePointers = pointerMode == HIPTENSOR_POINTER_MODE_DEVICE;
+        auto bytes          = devicePointers
+                                  ? sizeof(void const*)
+                                  : hiptensor::hipDataTypeSize(signature->mTensors[3]->mType);
+        std::memcpy(op.mScalars.data(), devicePointers ? (void const*)&alpha : alpha, bytes);
+        if(beta != nullptr)
         {
-            (*cSolution)(StreamConfig{stream, false});
+            std::memcpy(op.mScalars.data() + 16, devicePointers ? (void const*)&beta : beta, bytes);
         }
 
+        auto* cSolution = (hiptensor::ContractionSolution*)(plan->mSolution);
+        auto  scalars   = op.mScalars;
+        auto  hasBeta   = beta != nullptr;
+        auto& pool      = realHandle->getWorkspacePool();
+        auto  keep      = realHandle->getDescriptorCache().retain(signature);
+        op.mLaunch      = [=, &pool]() {
+            (void)keep;
+            auto* scalarAlpha = devicePointers ? alpha : (void const*)scalars.data();
+            auto* scalarBeta  = !hasBeta         ? nullptr
+                                : devicePointers ? beta
+                                                 : (void const*)(scalars.data() + 16);
+            if(workspace == nullptr)
+            {
+                return runPooledContraction("hiptensorFlush",
+                                            pool,
+                                            pointerMode,
+                                            signature,
+                                            cSolution,
+                                            scalarAlpha,
+                                            A,
+                                            &B,
+                                            scalarBeta,
+                                            &C,
+                                            &D,
+                                            stream);
+            }
+            return runScaledContraction("hiptensorFlush",
+                                        pointerMode,
+                                        signature,
+                                        cSolution,
+                                        scalarAlpha,
+                                        A,
+                                        B,
+                                        scalarBeta,
+                                        C,
+                                        D,
+                                        workspace,
+                                        workspaceSize,
+                                        stream);
+        };
+        queue->enqueue(std::move(op));
         return HIPTENSOR_STATUS_SUCCESS;
     }
-    else
+
+    if(workspace == nullptr)
     {
-        auto errorCode = HIPTENSOR_STATUS_INTERNAL_ERROR;
+        return runPooledContraction("hiptensorContraction",
+                                    realHandle->getWorkspacePool(),
+                                    pointerMode,
+                                    signature,
+                                    (hiptensor::ContractionSolution*)(plan->mSolution),
+                                    alpha,
+                                    A,
+                                    &B,
+                                    beta,
+                                    &C,
+                                    &D,
+                                    stream);
+    }
+
+    return runScaledContraction("hiptensorContraction",
+                                pointerMode,
+                                signature,
+                                (hiptensor::ContractionSolution*)(plan->mSolution),
+                                alpha,
+                                A,
+                                B,
+                                beta,
+                                C,
+                                D,
+                                workspace,
+                                workspaceSize,
+                                stream);
+}
+
+hiptensorStatus_t hiptensorContractionMultiOutput(const hiptensorHandle_t*          handle,
+                                                  const hiptensorContractionPlan_t* plan,
+                                                  const void*                       alpha,
+                                                  const void*                       A,
+                                                  const void* const                 B[],
+                                                  const void*                       beta,
+                                                  const void* const                 C[],
+                                                  void* const                       D[],
+                                                  void*                             workspace,
+                                                  uint64_t                          workspaceSize,
+                                                  hipStream_t                       stream)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, A=0x%llX, B=0x%llX, C=0x%llX, D=0x%llX, "
+             "workspace=0x%llX, workspaceSize=0x%04lX, stream=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)A,
+             (unsigned long long)B,
+             (unsigned long long)C,
+             (unsigned long long)D,
+             (unsigned long long)workspace,
+             (unsigned long)workspaceSize,
+             (unsigned long long)stream);
+
+    logger->logAPITrace("hiptensorContractionMultiOutput", msg);
+
+    if(handle == nullptr || plan == nullptr || plan->mSolution == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
         snprintf(msg,
                  sizeof(msg),
-                 "Selected kernel is unable to solve the problem (%s)",
+                 "Initialization Error : handle/plan = nullptr (%s)",
                  hiptensorGetErrorString(errorCode));
-        logger->logError("hiptensorContraction", msg);
+        logger->logError("hiptensorContractionMultiOutput", msg);
+        return errorCode;
+    }
+
+    auto  realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto* signature  = realHandle->getDescriptorCache().signature(plan->mContractionDesc);
+
+    if(auto status = requireHostScalars("hiptensorContractionMultiOutput", realHandle);
+       status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    auto missing = alpha == nullptr || A == nullptr || B == nullptr || D == nullptr;
+    for(uint32_t g = 0; !missing && g < signature->mOutputs; g++)
+    {
+        missing = B[g] == nullptr || D[g] == nullptr
+                  || (C != nullptr && C[g] == nullptr
+                      && signature->mTensors[2]->mType != hiptensor::NONE_TYPE);
+    }
+    if(missing)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/A/B/C/D = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionMultiOutput", msg);
+        return errorCode;
+    }
+
+    // Ensure current HIP device is same as the handle.
+    hiptensor::HipDevice currentDevice;
+    if((int)currentDevice.getDeviceId() != realHandle->getDevice().getDeviceId())
+    {
+        auto errorCode = HIPTENSOR_STATUS_ARCH_MISMATCH;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Device mismatch error: current device id: %d, handle device id: %d (%s)",
+                 (int)currentDevice.getDeviceId(),
+                 (int)realHandle->getDevice().getDeviceId(),
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionMultiOutput", msg);
+        return errorCode;
+    }
+
+    if(workspace == nullptr)
+    {
+        return runPooledContraction("hiptensorContractionMultiOutput",
+                                    realHandle->getWorkspacePool(),
+                                    HIPTENSOR_POINTER_MODE_HOST,
+                                    signature,
+                                    (hiptensor::ContractionSolution*)(plan->mSolution),
+                                    alpha,
+                                    A,
+                                    B,
+                                    beta,
+                                    C,
+                                    D,
+                                    stream);
+    }
+
+    return runContraction("hiptensorContractionMultiOutput",
+                          signature,
+                          (hiptensor::ContractionSolution*)(plan->mSolution),
+                          alpha,
+                          A,
+                          B,
+                          beta,
+                          C,
+                          D,
+                          workspace,
+                          workspaceSize,
+                          stream);
+}
+
+hiptensorStatus_t hiptensorContractionGetPackedOperandSize(const hiptensorHandle_t*          handle,
+                                                           const hiptensorContractionPlan_t* plan,
+                                                           uint64_t*                         size)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[256];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, size=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)size);
+    logger->logAPITrace("hiptensorContractionGetPackedOperandSize", msg);
+
+    if(handle == nullptr || plan == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionGetPackedOperandSize", msg);
+        return errorCode;
+    }
+
+    if(size == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : size = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionGetPackedOperandSize", msg);
+        return errorCode;
+    }
+
+    auto  realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto* signature  = realHandle->getDescriptorCache().signature(plan->mContractionDesc);
+
+    *size = packedOperandBytes(signature->mTensors[1]);
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorContractionPackOperand(const hiptensorHandle_t*          handle,
+                                                  hiptensorPackedOperand_t*         packed,
+                                                  const hiptensorContractionPlan_t* plan,
+                                                  const hiptensorContractionFind_t* find,
+                                                  uint64_t                          workspaceSize,
+                                                  const void*                       B,
+                                                  void*                             buffer,
+                                                  uint64_t                          bufferSize,
+                                                  hipStream_t                       stream)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, packed=0x%llX, plan=0x%llX, find=0x%llX, workspaceSize=0x%04lX, "
+             "B=0x%llX, buffer=0x%llX, bufferSize=0x%04lX, stream=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)packed,
+             (unsigned long long)plan,
+             (unsigned long long)find,
+             (unsigned long)workspaceSize,
+             (unsigned long long)B,
+             (unsigned long long)buffer,
+             (unsigned long)bufferSize,
+             (unsigned long long)stream);
+    logger->logAPITrace("hiptensorContractionPackOperand", msg);
+
+    if(handle == nullptr || packed == nullptr || plan == nullptr || find == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle, packed, plan or find = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionPackOperand", msg);
         return errorCode;
     }
+
+    auto  realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto& descCache  = realHandle->getDescriptorCache();
+    auto* signature  = descCache.signature(plan->mContractionDesc);
+    auto* tensor     = signature->mTensors[1];
+    auto  bytes      = packedOperandBytes(tensor);
+
+    if(signature->mOutputs > 1)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Multi-output plans stage their B operands and cannot be pre-packed (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionPackOperand", msg);
+        return errorCode;
+    }
+
+    if(B == nullptr || buffer == nullptr || (std::size_t)buffer % hiptensor::MaxVectorBytes != 0
+       || bufferSize < bytes)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : B/buffer = nullptr, buffer unaligned or smaller "
+                 "than %lu bytes (%s)",
+                 (unsigned long)bytes,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionPackOperand", msg);
+        return errorCode;
+    }
+
+    // The packed layout is a plain descriptor of B, so the packed problem is interned,
+    // selected and cached like any other contraction.
+    auto packedDesc    = plan->mContractionDesc;
+    auto packedStrides = packedOperandStrides(tensor);
+
+    packedDesc.mTensorDesc[1].mStrides   = packedStrides;
+    packedDesc.mTensorDesc[1].mSignature = nullptr;
+    packedDesc.mAlignmentReq[1]          = hiptensor::MaxVectorBytes;
+    descCache.bind(packedDesc);
+
+    auto status = hiptensor::stridedCopy(
+        B, tensor->mStrides, buffer, packedStrides, tensor->mLengths, tensor->mType, stream);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to pack B into the buffer (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorContractionPackOperand", msg);
+        return status;
+    }
+
+    status = hiptensorInitContractionPlan(handle, &packed->mPlan, &packedDesc, find, workspaceSize);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    auto* packedSignature
+        = static_cast<hiptensor::ContractionSignature const*>(packedDesc.mSignature);
+    snprintf(msg,
+             sizeof(msg),
+             "Packed B of %lu bytes, vector width %u (unpacked %u)",
+             (unsigned long)bytes,
+             packedSignature->mVectorWidth,
+             signature->mVectorWidth);
+    logger->logHeuristics("hiptensorContractionPackOperand", msg);
+
+    packed->mData  = buffer;
+    packed->mBytes = bytes;
+    return HIPTENSOR_STATUS_SUCCESS;
 }
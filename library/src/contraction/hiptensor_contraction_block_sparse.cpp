@@ -0,0 +1,528 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <algorithm>
+
+#include <hiptensor/hiptensor.hpp>
+
+#include "contraction_block_sparse.hpp"
+#include "contraction_launch.hpp"
+#include "handle.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+
+hiptensorStatus_t
+    hiptensorInitBlockSparseTensorDescriptor(const hiptensorHandle_t*                handle,
+                                             hiptensorBlockSparseTensorDescriptor_t* desc,
+                                             const uint32_t                          numModes,
+                                             const uint32_t                          blockCounts[],
+                                             const int64_t                           blockLengths[],
+                                             const uint32_t                          numBlocks,
+                                             const uint32_t blockCoordinates[],
+                                             const int64_t  blockOffsets[],
+                                             hipDataType    dataType)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[256];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, desc=0x%llX, numModes=%u, numBlocks=%u, dataType=0x%02X",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)desc,
+             numModes,
+             numBlocks,
+             (unsigned int)dataType);
+    logger->logAPITrace("hiptensorInitBlockSparseTensorDescriptor", msg);
+
+    if(handle == nullptr || desc == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or desc = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitBlockSparseTensorDescriptor", msg);
+        return errorCode;
+    }
+
+    if((numModes > 0 && (blockCounts == nullptr || blockLengths == nullptr))
+       || (numBlocks > 0 && ((numModes > 0 && blockCoordinates == nullptr)
+                             || blockOffsets == nullptr)))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : block counts, lengths, coordinates or offsets = "
+                 "nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitBlockSparseTensorDescriptor", msg);
+        return errorCode;
+    }
+
+    hiptensorBlockSparseTensorDescriptor_t result = {dataType, {}, {}, {}};
+    auto const*                            lengths = blockLengths;
+    for(uint32_t i = 0; i < numModes; i++)
+    {
+        result.mBlockLengths.emplace_back(lengths, lengths + blockCounts[i]);
+        lengths += blockCounts[i];
+    }
+    for(uint32_t block = 0; block < numBlocks; block++)
+    {
+        auto const* coords = blockCoordinates + block * numModes;
+        result.mBlocks.emplace_back(coords, coords + numModes);
+        result.mOffsets.push_back(blockOffsets[block]);
+    }
+
+    bool negative = std::any_of(blockLengths,
+                                lengths,
+                                [](int64_t length) { return length <= 0; })
+                    || std::any_of(blockOffsets, blockOffsets + numBlocks, [](int64_t offset) {
+                           return offset < 0;
+                       });
+    if(negative || hiptensor::validateBlockSparse(result) != HIPTENSOR_STATUS_SUCCESS)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : block lengths, coordinates or offsets are invalid (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitBlockSparseTensorDescriptor", msg);
+        return errorCode;
+    }
+
+    *desc = std::move(result);
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t
+    hiptensorInitBlockSparseContractionPlan(const hiptensorHandle_t*                      handle,
+                                            hiptensorBlockSparsePlan_t*                   plan,
+                                            const hiptensorBlockSparseTensorDescriptor_t* descA,
+                                            const int32_t                                 modeA[],
+                                            const hiptensorBlockSparseTensorDescriptor_t* descB,
+                                            const int32_t                                 modeB[],
+                                            const hiptensorBlockSparseTensorDescriptor_t* descC,
+                                            const int32_t                                 modeC[],
+                                            const hiptensorBlockSparseTensorDescriptor_t* descD,
+                                            const int32_t                                 modeD[],
+                                            hiptensorComputeType_t typeCompute)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, descA=0x%llX, descB=0x%llX, descC=0x%llX, "
+             "descD=0x%llX, typeCompute=0x%02X",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)descA,
+             (unsigned long long)descB,
+             (unsigned long long)descC,
+             (unsigned long long)descD,
+             (unsigned int)typeCompute);
+    logger->logAPITrace("hiptensorInitBlockSparseContractionPlan", msg);
+
+    if(handle == nullptr || plan == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitBlockSparseContractionPlan", msg);
+        return errorCode;
+    }
+
+    // C is read block by block at D's offsets, so it must be stored like D
+    auto hasC = descC != nullptr;
+    if(descA == nullptr || descB == nullptr || descD == nullptr
+       || (hasC
+           && (descC->mType != descD->mType || descC->mBlockLengths != descD->mBlockLengths
+               || descC->mBlocks != descD->mBlocks || descC->mOffsets != descD->mOffsets
+               || (descD->mBlockLengths.size() > 0
+                   && (modeC == nullptr || modeD == nullptr
+                       || !std::equal(modeD, modeD + descD->mBlockLengths.size(), modeC))))))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : descA/descB/descD = nullptr or C is not stored "
+                 "like D (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitBlockSparseContractionPlan", msg);
+        return errorCode;
+    }
+
+    auto* blockPlan = new hiptensor::BlockSparsePlan;
+    auto  status    = hiptensor::planBlockSparse(
+        blockPlan, *descA, modeA, *descB, modeB, *descD, modeD, typeCompute, hasC);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Block-sparse operands do not pair into stored D blocks (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorInitBlockSparseContractionPlan", msg);
+        delete blockPlan;
+        return status;
+    }
+
+    // Every group is contracted with one dense plan over packed blocks, always
+    // bilinear so that later products can accumulate into D
+    hiptensorContractionFind_t find;
+    status = hiptensorInitContractionFind(handle, &find, HIPTENSOR_ALGO_DEFAULT);
+    for(auto const& group : blockPlan->mGroups)
+    {
+        if(status != HIPTENSOR_STATUS_SUCCESS)
+        {
+            break;
+        }
+
+        std::array<hiptensorTensorDescriptor_t, 3> dense;
+        std::array<uint32_t, 3>                    alignment;
+        for(int i = 0; i < 3; i++)
+        {
+            auto const& desc  = blockPlan->mDescs[i];
+            auto        bytes = hiptensor::hipDataTypeSize(desc.mType);
+            dense[i]          = {desc.mType,
+                        group.mLengths[i],
+                        hiptensor::stridesFromLengths(group.mLengths[i]),
+                        nullptr};
+            alignment[i]      = hiptensor::MaxVectorBytes;
+            for(auto const& task : group.mTasks)
+            {
+                auto block   = i == 0 ? task.mBlockA : i == 1 ? task.mBlockB : task.mBlockD;
+                alignment[i] = alignmentAtOffset(alignment[i], desc.mOffsets[block] * bytes);
+            }
+        }
+
+        auto const&                      modes = blockPlan->mModes;
+        hiptensorContractionDescriptor_t desc;
+        status = hiptensorInitContractionDescriptor(handle,
+                                                    &desc,
+                                                    &dense[0],
+                                                    modes[0].data(),
+                                                    alignment[0],
+                                                    &dense[1],
+                                                    modes[1].data(),
+                                                    alignment[1],
+                                                    &dense[2],
+                                                    modes[2].data(),
+                                                    alignment[2],
+                                                    &dense[2],
+                                                    modes[2].data(),
+                                                    alignment[2],
+                                                    typeCompute);
+
+        uint64_t workspaceSize = 0;
+        if(status == HIPTENSOR_STATUS_SUCCESS)
+        {
+            status = hiptensorContractionGetWorkspaceSize(
+                handle, &desc, &find, HIPTENSOR_WORKSPACE_RECOMMENDED, &workspaceSize);
+        }
+
+        hiptensorContractionPlan_t densePlan;
+        if(status == HIPTENSOR_STATUS_SUCCESS)
+        {
+            status = hiptensorInitContractionPlan(handle, &densePlan, &desc, &find, workspaceSize);
+        }
+        blockPlan->mDensePlans.push_back(densePlan);
+    }
+
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to plan the dense block contractions (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorInitBlockSparseContractionPlan", msg);
+        delete blockPlan;
+        return status;
+    }
+
+    snprintf(msg,
+             sizeof(msg),
+             "%lu block products in %lu groups, %lu D blocks untouched",
+             (unsigned long)blockPlan->taskCount(),
+             (unsigned long)blockPlan->mGroups.size(),
+             (unsigned long)blockPlan->mUntouched.size());
+    logger->logHeuristics("hiptensorInitBlockSparseContractionPlan", msg);
+
+    plan->mPlan = blockPlan;
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorBlockSparseContraction(const hiptensorHandle_t*          handle,
+                                                  const hiptensorBlockSparsePlan_t* plan,
+                                                  const void*                       alpha,
+                                                  const void*                       A,
+                                                  const void*                       B,
+                                                  const void*                       beta,
+                                                  const void*                       C,
+                                                  void*                             D,
+                                                  hipStream_t                       stream)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, A=0x%llX, B=0x%llX, C=0x%llX, D=0x%llX, "
+             "stream=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)A,
+             (unsigned long long)B,
+             (unsigned long long)C,
+             (unsigned long long)D,
+             (unsigned long long)stream);
+    logger->logAPITrace("hiptensorBlockSparseContraction", msg);
+
+    if(handle == nullptr || plan == nullptr || plan->mPlan == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorBlockSparseContraction", msg);
+        return errorCode;
+    }
+
+    auto const& blockPlan = *static_cast<hiptensor::BlockSparsePlan const*>(plan->mPlan);
+    if(alpha == nullptr || A == nullptr || B == nullptr || D == nullptr
+       || (blockPlan.mHasC && (beta == nullptr || C == nullptr)))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/beta/A/B/C/D = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorBlockSparseContraction", msg);
+        return errorCode;
+    }
+
+    auto realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    if(auto status = requireHostScalars("hiptensorBlockSparseContraction", realHandle);
+       status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    // Later products into a D block accumulate with alpha and beta = 1 in D's type
+    auto const& descD = blockPlan.mDescs[2];
+    auto        unit  = std::array<std::array<char, 16>, 2>{};
+    if(descD.mType == HIP_R_16F)
+    {
+        writeUnitScalars<_Float16>(unit);
+    }
+    else if(descD.mType == HIP_R_32F)
+    {
+        writeUnitScalars<float>(unit);
+    }
+    else if(descD.mType == HIP_R_64F)
+    {
+        writeUnitScalars<double>(unit);
+    }
+    else
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Block-sparse contractions support f16, f32 and f64 outputs (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorBlockSparseContraction", msg);
+        return errorCode;
+    }
+
+    auto bytesA = hiptensor::hipDataTypeSize(blockPlan.mDescs[0].mType);
+    auto bytesB = hiptensor::hipDataTypeSize(blockPlan.mDescs[1].mType);
+    auto bytesD = hiptensor::hipDataTypeSize(descD.mType);
+    auto blockD = [&](std::size_t block) { return (char*)D + descD.mOffsets[block] * bytesD; };
+    auto blockC = [&](std::size_t block) {
+        return (char const*)C + descD.mOffsets[block] * bytesD;
+    };
+
+    // Without C, D starts from zero and every product accumulates into it
+    if(!blockPlan.mHasC)
+    {
+        for(std::size_t block = 0; block < descD.mBlocks.size(); block++)
+        {
+            auto bytes = hiptensor::elementsFromLengths(hiptensor::blockLengths(descD, block))
+                         * bytesD;
+            CHECK_HIP_ERROR(hipMemsetAsync(blockD(block), 0, bytes, stream));
+        }
+    }
+
+    // D blocks that no product reaches are beta * C
+    auto status = HIPTENSOR_STATUS_SUCCESS;
+    for(std::size_t n = 0; blockPlan.mHasC && n < blockPlan.mUntouched.size(); n++)
+    {
+        auto                        block   = blockPlan.mUntouched[n];
+        auto                        lengths = hiptensor::blockLengths(descD, block);
+        hiptensorTensorDescriptor_t dense
+            = {descD.mType, lengths, hiptensor::stridesFromLengths(lengths), nullptr};
+        status = hiptensorPermutation(handle,
+                                      beta,
+                                      blockC(block),
+                                      &dense,
+                                      blockPlan.mModes[2].data(),
+                                      blockD(block),
+                                      &dense,
+                                      blockPlan.mModes[2].data(),
+                                      descD.mType,
+                                      stream);
+        if(status != HIPTENSOR_STATUS_SUCCESS)
+        {
+            return status;
+        }
+    }
+
+    // Groups run in order on the stream, so products into one D block never overlap
+    for(std::size_t g = 0; g < blockPlan.mGroups.size(); g++)
+    {
+        for(auto const& task : blockPlan.mGroups[g].mTasks)
+        {
+            auto        first = task.mFirst && blockPlan.mHasC;
+            void const* bias  = first ? (void const*)blockC(task.mBlockD) : blockD(task.mBlockD);
+            status            = hiptensorContraction(
+                handle,
+                &blockPlan.mDensePlans[g],
+                alpha,
+                (char const*)A + blockPlan.mDescs[0].mOffsets[task.mBlockA] * bytesA,
+                (char const*)B + blockPlan.mDescs[1].mOffsets[task.mBlockB] * bytesB,
+                first ? beta : unit[0].data(),
+                bias,
+                blockD(task.mBlockD),
+                nullptr,
+                0,
+                stream);
+            if(status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                snprintf(msg,
+                         sizeof(msg),
+                         "Contraction of A block %lu with B block %lu failed (%s)",
+                         (unsigned long)task.mBlockA,
+                         (unsigned long)task.mBlockB,
+                         hiptensorGetErrorString(status));
+                logger->logError("hiptensorBlockSparseContraction", msg);
+                return status;
+            }
+        }
+    }
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorBlockSparseContractionHost(const hiptensorBlockSparsePlan_t* plan,
+                                                      const void*                       alpha,
+                                                      const void*                       A,
+                                                      const void*                       B,
+                                                      const void*                       beta,
+                                                      const void*                       C,
+                                                      void*                             D,
+                                                      uint32_t numThreads)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "plan=0x%0*llX, A=0x%llX, B=0x%llX, C=0x%llX, D=0x%llX, numThreads=%u",
+             2 * (int)sizeof(void*),
+             (unsigned long long)plan,
+             (unsigned long long)A,
+             (unsigned long long)B,
+             (unsigned long long)C,
+             (unsigned long long)D,
+             numThreads);
+    logger->logAPITrace("hiptensorBlockSparseContractionHost", msg);
+
+    if(plan == nullptr || plan->mPlan == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorBlockSparseContractionHost", msg);
+        return errorCode;
+    }
+
+    auto const& blockPlan = *static_cast<hiptensor::BlockSparsePlan const*>(plan->mPlan);
+    if(alpha == nullptr || A == nullptr || B == nullptr || D == nullptr
+       || (blockPlan.mHasC && (beta == nullptr || C == nullptr)))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/beta/A/B/C/D = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorBlockSparseContractionHost", msg);
+        return errorCode;
+    }
+
+    auto status
+        = hiptensor::blockSparseContractionHost(blockPlan, alpha, A, B, beta, C, D, numThreads);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Host block-sparse contractions support f32 and f64 operands of one type (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorBlockSparseContractionHost", msg);
+    }
+    return status;
+}
+
+hiptensorStatus_t hiptensorDestroyBlockSparsePlan(hiptensorBlockSparsePlan_t* plan)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg, sizeof(msg), "plan=0x%0*llX", 2 * (int)sizeof(void*), (unsigned long long)plan);
+    logger->logAPITrace("hiptensorDestroyBlockSparsePlan", msg);
+
+    if(plan)
+    {
+        delete static_cast<hiptensor::BlockSparsePlan*>(plan->mPlan);
+        plan->mPlan = nullptr;
+    }
+    return HIPTENSOR_STATUS_SUCCESS;
+}
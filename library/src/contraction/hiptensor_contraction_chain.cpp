@@ -0,0 +1,448 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <algorithm>
+
+#include <hiptensor/hiptensor.hpp>
+
+#include "contraction_chain.hpp"
+#include "contraction_launch.hpp"
+#include "handle.hpp"
+#include "hip_device.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+
+hiptensorStatus_t
+    hiptensorInitContractionChainDescriptor(const hiptensorHandle_t*               handle,
+                                            hiptensorContractionChainDescriptor_t* desc,
+                                            const hiptensorTensorDescriptor_t*     descA,
+                                            const int32_t                          modeA[],
+                                            const uint32_t alignmentRequirementA,
+                                            const hiptensorTensorDescriptor_t*     descB,
+                                            const int32_t                          modeB[],
+                                            const uint32_t alignmentRequirementB,
+                                            const hiptensorTensorDescriptor_t*     descC,
+                                            const int32_t                          modeC[],
+                                            const uint32_t alignmentRequirementC,
+                                            const hiptensorTensorDescriptor_t*     descD,
+                                            const int32_t                          modeD[],
+                                            const uint32_t alignmentRequirementD,
+                                            hiptensorComputeType_t                 typeCompute)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, desc=0x%llX, descA=0x%llX, descB=0x%llX, descC=0x%llX, "
+             "descD=0x%llX, typeCompute=0x%02X",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)desc,
+             (unsigned long long)descA,
+             (unsigned long long)descB,
+             (unsigned long long)descC,
+             (unsigned long long)descD,
+             (unsigned int)typeCompute);
+    logger->logAPITrace("hiptensorInitContractionChainDescriptor", msg);
+
+    if(!handle || !desc || !descA || !descB || !descC || !descD)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle, descriptor or tensor descriptors = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitContractionChainDescriptor", msg);
+        return errorCode;
+    }
+
+    hiptensor::ContractionChain chain;
+
+    auto status = hiptensor::analyzeChain(
+        &chain, {{*descA, *descB, *descC, *descD}}, {{modeA, modeB, modeC, modeD}});
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Operands do not form a chain A = [M, K], B = [N, K], C = [O, N], D = [M, O] (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorInitContractionChainDescriptor", msg);
+        return status;
+    }
+
+    // Modes of the intermediate X = [M, N]
+    std::vector<int32_t> modeX(modeA, modeA + chain.mRankM);
+    modeX.insert(modeX.end(), modeB, modeB + chain.mRankN);
+
+    // Both stages are planned for one block; later blocks start at fixed offsets
+    auto offsets      = chain.blockOffsets(1);
+    auto elementBytes = hiptensor::hipDataTypeSize(descA->mType);
+    auto alignmentA   = alignmentAtOffset(alignmentRequirementA, offsets[0] * elementBytes);
+    auto alignmentD   = alignmentAtOffset(alignmentRequirementD, offsets[1] * elementBytes);
+
+    auto initStages = [&](std::array<hiptensorContractionDescriptor_t, 2>& stages, bool last) {
+        auto blocks       = chain.blockTensors(last);
+        auto intermediate = chain.blockIntermediate(last);
+
+        auto status = hiptensorInitContractionDescriptor(handle,
+                                                         &stages[0],
+                                                         &blocks[0],
+                                                         modeA,
+                                                         alignmentA,
+                                                         descB,
+                                                         modeB,
+                                                         alignmentRequirementB,
+                                                         nullptr,
+                                                         nullptr,
+                                                         0,
+                                                         &intermediate,
+                                                         modeX.data(),
+                                                         hiptensor::MaxVectorBytes,
+                                                         typeCompute);
+        if(status == HIPTENSOR_STATUS_SUCCESS)
+        {
+            status = hiptensorInitContractionDescriptor(handle,
+                                                        &stages[1],
+                                                        &intermediate,
+                                                        modeX.data(),
+                                                        hiptensor::MaxVectorBytes,
+                                                        descC,
+                                                        modeC,
+                                                        alignmentRequirementC,
+                                                        nullptr,
+                                                        nullptr,
+                                                        0,
+                                                        &blocks[1],
+                                                        modeD,
+                                                        alignmentD,
+                                                        typeCompute);
+        }
+        return status;
+    };
+
+    // A shorter last block starts at a block offset too, so the same alignments hold
+    desc->mRaggedLast = chain.raggedLast();
+    status            = initStages(desc->mStages, false);
+    if(status == HIPTENSOR_STATUS_SUCCESS && desc->mRaggedLast)
+    {
+        status = initStages(desc->mLastStages, true);
+    }
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    // Stage workspaces follow the intermediate at the alignment of device allocations
+    auto intermediateBytes = hiptensor::elementsFromLengths(chain.mBlock.mLengths) * elementBytes;
+
+    desc->mBlockOffsets      = {offsets[0], offsets[1]};
+    desc->mBlocks            = chain.mBlocks;
+    desc->mIntermediateBytes = hiptensor::ceilDiv(intermediateBytes, 256u) * 256u;
+
+    snprintf(msg,
+             sizeof(msg),
+             "Chain runs in %lu blocks of %lu outer M indices (last: %lu), intermediate: %lu "
+             "bytes",
+             (unsigned long)chain.mBlocks,
+             (unsigned long)chain.mBlockM,
+             (unsigned long)chain.mLastBlockM,
+             (unsigned long)desc->mIntermediateBytes);
+    logger->logHeuristics("hiptensorInitContractionChainDescriptor", msg);
+
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t
+    hiptensorContractionChainGetWorkspaceSize(const hiptensorHandle_t*                     handle,
+                                              const hiptensorContractionChainDescriptor_t* desc,
+                                              const hiptensorContractionFind_t*            find,
+                                              const hiptensorWorksizePreference_t          pref,
+                                              uint64_t* workspaceSize)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    if(desc == nullptr || workspaceSize == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        char msg[128];
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : desc or workspaceSize = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionChainGetWorkspaceSize", msg);
+        return errorCode;
+    }
+
+    *workspaceSize = 0;
+    for(int s = 0; s < 2 * desc->mStages.size(); s++)
+    {
+        if(s >= desc->mStages.size() && !desc->mRaggedLast)
+        {
+            break;
+        }
+
+        auto const& stage = s < desc->mStages.size() ? desc->mStages[s]
+                                                     : desc->mLastStages[s - desc->mStages.size()];
+        uint64_t    stageSize = 0;
+
+        auto status = hiptensorContractionGetWorkspaceSize(handle, &stage, find, pref, &stageSize);
+        if(status != HIPTENSOR_STATUS_SUCCESS)
+        {
+            return status;
+        }
+        *workspaceSize = std::max(*workspaceSize, stageSize);
+    }
+    *workspaceSize += desc->mIntermediateBytes;
+
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t
+    hiptensorInitContractionChainPlan(const hiptensorHandle_t*                     handle,
+                                      hiptensorContractionChainPlan_t*             plan,
+                                      const hiptensorContractionChainDescriptor_t* desc,
+                                      const hiptensorContractionFind_t*            find,
+                                      const uint64_t                               workspaceSize)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    char msg[256];
+    if(plan == nullptr || desc == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : plan or desc = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitContractionChainPlan", msg);
+        return errorCode;
+    }
+
+    if(workspaceSize < desc->mIntermediateBytes)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Insufficient workspace for the intermediate: req: %lu alloc: %lu (%s)",
+                 (unsigned long)desc->mIntermediateBytes,
+                 (unsigned long)workspaceSize,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitContractionChainPlan", msg);
+        return errorCode;
+    }
+
+    for(int s = 0; s < desc->mStages.size(); s++)
+    {
+        auto status = hiptensorInitContractionPlan(handle,
+                                                   &plan->mStages[s],
+                                                   &desc->mStages[s],
+                                                   find,
+                                                   workspaceSize - desc->mIntermediateBytes);
+        if(status == HIPTENSOR_STATUS_SUCCESS && desc->mRaggedLast)
+        {
+            status = hiptensorInitContractionPlan(handle,
+                                                  &plan->mLastStages[s],
+                                                  &desc->mLastStages[s],
+                                                  find,
+                                                  workspaceSize - desc->mIntermediateBytes);
+        }
+        if(status != HIPTENSOR_STATUS_SUCCESS)
+        {
+            return status;
+        }
+    }
+    plan->mChainDesc = *desc;
+
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorContractionChain(const hiptensorHandle_t*               handle,
+                                            const hiptensorContractionChainPlan_t* plan,
+                                            const void*                            alpha,
+                                            const void*                            A,
+                                            const void*                            B,
+                                            const void*                            C,
+                                            void*                                  D,
+                                            void*                                  workspace,
+                                            uint64_t                               workspaceSize,
+                                            hipStream_t                            stream)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, A=0x%llX, B=0x%llX, C=0x%llX, D=0x%llX, "
+             "workspace=0x%llX, workspaceSize=0x%04lX, stream=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)A,
+             (unsigned long long)B,
+             (unsigned long long)C,
+             (unsigned long long)D,
+             (unsigned long long)workspace,
+             (unsigned long)workspaceSize,
+             (unsigned long long)stream);
+    logger->logAPITrace("hiptensorContractionChain", msg);
+
+    if(handle == nullptr || plan == nullptr || plan->mStages[0].mSolution == nullptr
+       || plan->mStages[1].mSolution == nullptr
+       || (plan->mChainDesc.mRaggedLast
+           && (plan->mLastStages[0].mSolution == nullptr
+               || plan->mLastStages[1].mSolution == nullptr)))
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionChain", msg);
+        return errorCode;
+    }
+
+    if(alpha == nullptr || A == nullptr || B == nullptr || C == nullptr || D == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/A/B/C/D = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionChain", msg);
+        return errorCode;
+    }
+
+    auto const& chainDesc = plan->mChainDesc;
+    if(workspace == nullptr || workspaceSize < chainDesc.mIntermediateBytes)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Insufficient workspace for the intermediate: req: %lu alloc: %lu (%s)",
+                 (unsigned long)chainDesc.mIntermediateBytes,
+                 (unsigned long)workspaceSize,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionChain", msg);
+        return errorCode;
+    }
+
+    auto realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+
+    // Ensure current HIP device is same as the handle.
+    hiptensor::HipDevice currentDevice;
+    if((int)currentDevice.getDeviceId() != realHandle->getDevice().getDeviceId())
+    {
+        auto errorCode = HIPTENSOR_STATUS_ARCH_MISMATCH;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Device mismatch error: current device id: %d, handle device id: %d (%s)",
+                 (int)currentDevice.getDeviceId(),
+                 (int)realHandle->getDevice().getDeviceId(),
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionChain", msg);
+        return errorCode;
+    }
+
+    if(auto status = requireHostScalars("hiptensorContractionChain", realHandle);
+       status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    auto& descCache = realHandle->getDescriptorCache();
+    auto* head      = descCache.signature(plan->mStages[0].mContractionDesc);
+
+    // The first stage forms X unscaled; alpha is applied by the second
+    auto        oneF32  = 1.0f;
+    auto        oneF64  = 1.0;
+    auto        zeroF32 = 0.0f;
+    auto        zeroF64 = 0.0;
+    auto        is64    = head->mComputeType == HIPTENSOR_COMPUTE_64F;
+    void const* one     = is64 ? (void const*)&oneF64 : &oneF32;
+    void const* zero    = is64 ? (void const*)&zeroF64 : &zeroF32;
+
+    // X of one block sits at the front of the workspace; the stages run in stream
+    // order, so every block reuses it while it is still cached
+    void*       X                  = workspace;
+    void const* noC                = nullptr;
+    auto*       stageWorkspace     = (char*)workspace + chainDesc.mIntermediateBytes;
+    auto        stageWorkspaceSize = workspaceSize - chainDesc.mIntermediateBytes;
+    auto        bytesA             = hiptensor::hipDataTypeSize(head->mTensors[0]->mType);
+    auto        bytesD             = bytesA;
+
+    for(uint64_t block = 0; block < chainDesc.mBlocks; block++)
+    {
+        void const* blockA = (char const*)A + block * chainDesc.mBlockOffsets[0] * bytesA;
+        void*       blockD = (char*)D + block * chainDesc.mBlockOffsets[1] * bytesD;
+
+        // The shorter last block runs the plans made for its own shape
+        auto const& stages
+            = chainDesc.mRaggedLast && block + 1 == chainDesc.mBlocks ? plan->mLastStages
+                                                                      : plan->mStages;
+        auto* first  = descCache.signature(stages[0].mContractionDesc);
+        auto* second = descCache.signature(stages[1].mContractionDesc);
+
+        auto status = runContraction("hiptensorContractionChain",
+                                     first,
+                                     (hiptensor::ContractionSolution*)(stages[0].mSolution),
+                                     one,
+                                     blockA,
+                                     &B,
+                                     zero,
+                                     &noC,
+                                     &X,
+                                     stageWorkspace,
+                                     stageWorkspaceSize,
+                                     stream);
+        if(status == HIPTENSOR_STATUS_SUCCESS)
+        {
+            status = runContraction("hiptensorContractionChain",
+                                    second,
+                                    (hiptensor::ContractionSolution*)(stages[1].mSolution),
+                                    alpha,
+                                    X,
+                                    &C,
+                                    zero,
+                                    &noC,
+                                    &blockD,
+                                    stageWorkspace,
+                                    stageWorkspaceSize,
+                                    stream);
+        }
+        if(status != HIPTENSOR_STATUS_SUCCESS)
+        {
+            return status;
+        }
+    }
+
+    return HIPTENSOR_STATUS_SUCCESS;
+}
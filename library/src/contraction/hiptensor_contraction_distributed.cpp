@@ -0,0 +1,255 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <hiptensor/hiptensor.hpp>
+
+#include "contraction_distributed.hpp"
+#include "contraction_launch.hpp"
+#include "handle.hpp"
+#include "logger.hpp"
+#include "transport.hpp"
+#include "util.hpp"
+
+hiptensorStatus_t hiptensorDistributedGetLocalBlock(const hiptensorHandle_t*          handle,
+                                                    const hiptensorContractionPlan_t* plan,
+                                                    const hiptensorTransport_t*       transport,
+                                                    uint32_t                          operand,
+                                                    uint32_t                          block,
+                                                    uint32_t*                         numBlocks,
+                                                    uint64_t                          start[],
+                                                    uint64_t                          extent[],
+                                                    uint64_t*                         offset)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[256];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, transport=0x%llX, operand=%u, block=%u",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)transport,
+             operand,
+             block);
+    logger->logAPITrace("hiptensorDistributedGetLocalBlock", msg);
+
+    if(handle == nullptr || plan == nullptr || transport == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle, plan or transport = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorDistributedGetLocalBlock", msg);
+        return errorCode;
+    }
+
+    if(operand > 3 || numBlocks == nullptr || start == nullptr || extent == nullptr
+       || offset == nullptr || transport->mRank >= transport->mSize)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : invalid operand, rank or output = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorDistributedGetLocalBlock", msg);
+        return errorCode;
+    }
+
+    auto  realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto* signature  = realHandle->getDescriptorCache().signature(plan->mContractionDesc);
+
+    hiptensor::DistributedPlan distributedPlan;
+    auto status = hiptensor::planDistributed(&distributedPlan, *signature, transport->mSize);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to distribute the contraction over %u ranks (%s)",
+                 transport->mSize,
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorDistributedGetLocalBlock", msg);
+        return status;
+    }
+
+    auto blocks = distributedPlan.localBlocks(transport->mRank, operand);
+    *numBlocks  = uint32_t(blocks.size());
+    if(block >= blocks.size())
+    {
+        return HIPTENSOR_STATUS_INVALID_VALUE;
+    }
+
+    *offset = 0;
+    for(uint32_t b = 0; b < block; b++)
+    {
+        *offset += distributedPlan.blockElements(blocks[b], operand);
+    }
+
+    auto const& local = blocks[block];
+    start[0]          = local.mStartM;
+    start[1]          = local.mStartN;
+    start[2]          = local.mStartK;
+    extent[0]         = local.mExtentM;
+    extent[1]         = local.mExtentN;
+    extent[2]         = local.mExtentK;
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorContractionDistributed(const hiptensorHandle_t*          handle,
+                                                  const hiptensorContractionPlan_t* plan,
+                                                  const hiptensorTransport_t*       transport,
+                                                  const void*                       alpha,
+                                                  const void*                       A,
+                                                  const void*                       B,
+                                                  const void*                       beta,
+                                                  const void*                       C,
+                                                  void*                             D,
+                                                  hipStream_t                       stream)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, transport=0x%llX, A=0x%llX, B=0x%llX, C=0x%llX, "
+             "D=0x%llX, stream=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)transport,
+             (unsigned long long)A,
+             (unsigned long long)B,
+             (unsigned long long)C,
+             (unsigned long long)D,
+             (unsigned long long)stream);
+    logger->logAPITrace("hiptensorContractionDistributed", msg);
+
+    if(handle == nullptr || plan == nullptr || plan->mSolution == nullptr
+       || transport == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle, plan or transport = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionDistributed", msg);
+        return errorCode;
+    }
+
+    auto  realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto* signature  = realHandle->getDescriptorCache().signature(plan->mContractionDesc);
+    auto  hasC       = signature->mTensors[2]->mType != hiptensor::NONE_TYPE;
+
+    if(auto status = requireHostScalars("hiptensorContractionDistributed", realHandle);
+       status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    // Ranks without blocks of an operand may pass nullptr for it
+    if(alpha == nullptr || (hasC && beta == nullptr) || transport->send == nullptr
+       || transport->receive == nullptr || transport->wait == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/beta or transport callbacks = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionDistributed", msg);
+        return errorCode;
+    }
+
+    hiptensor::DistributedPlan distributedPlan;
+    auto status = hiptensor::planDistributed(&distributedPlan, *signature, transport->mSize);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to distribute the contraction over %u ranks (%s)",
+                 transport->mSize,
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorContractionDistributed", msg);
+        return status;
+    }
+
+    snprintf(msg,
+             sizeof(msg),
+             "Rank %u of a %u x %u grid, stepping through %u K panels",
+             transport->mRank,
+             distributedPlan.mGrid.mRows,
+             distributedPlan.mGrid.mCols,
+             distributedPlan.mPanels);
+    logger->logHeuristics("hiptensorContractionDistributed", msg);
+
+    // Local blocks are contracted packed with the plan's kernel, its workspace sized
+    // for the last block, which is the largest
+    auto  grid           = distributedPlan.mGrid;
+    auto  largest        = distributedPlan.block(
+        grid.mRows - 1, grid.mCols - 1, distributedPlan.mPanels - 1);
+    auto* cSolution      = (hiptensor::ContractionSolution*)(plan->mSolution);
+    auto  workspaceBytes = std::size_t{0};
+    auto  lengths        = distributedPlan.mGeometry.tileLengths(largest);
+    if(cSolution->initArgs(alpha,
+                           nullptr,
+                           nullptr,
+                           beta,
+                           nullptr,
+                           nullptr,
+                           lengths[0],
+                           hiptensor::stridesFromLengths(lengths[0]),
+                           lengths[1],
+                           hiptensor::stridesFromLengths(lengths[1]),
+                           lengths[2],
+                           hiptensor::stridesFromLengths(lengths[2]),
+                           lengths[3],
+                           hiptensor::stridesFromLengths(lengths[3]),
+                           nullptr))
+    {
+        workspaceBytes = cSolution->workspaceSize();
+    }
+
+    // Local operands may still be written by work on the caller's stream
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+    hiptensor::CallbackTransport callbacks(*transport);
+    HipStreamingBackend          backend(cSolution, 1);
+    status = hiptensor::distributedContraction(
+        distributedPlan, callbacks, backend, alpha, A, B, beta, C, D, workspaceBytes);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Distributed contraction failed on rank %u (%s)",
+                 transport->mRank,
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorContractionDistributed", msg);
+    }
+    return status;
+}
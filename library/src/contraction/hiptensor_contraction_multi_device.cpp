@@ -0,0 +1,467 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <hiptensor/hiptensor.hpp>
+
+#include "contraction_launch.hpp"
+#include "contraction_multi_device.hpp"
+#include "contraction_selection.hpp"
+#include "contraction_solution.hpp"
+#include "contraction_solution_instances.hpp"
+#include "contraction_solution_registry.hpp"
+#include "handle.hpp"
+#include "hip_device.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+
+// Runs the shares of a multi-device contraction on the handle's devices. Device 0 works
+// on the caller's stream and every other device on its own, each with the kernel selected
+// for its share on that device and workspace from its pool.
+class HipMultiDeviceBackend : public hiptensor::MultiDeviceBackend
+{
+public:
+    HipMultiDeviceBackend(hiptensor::Handle*                           handle,
+                          std::vector<hiptensor::ContractionSolution*> solutions,
+                          hipStream_t                                  stream)
+        : mHandle(handle)
+        , mSolutions(std::move(solutions))
+        , mStream(stream)
+    {
+        CHECK_HIP_ERROR(hipGetDevice(&mCurrent));
+
+        // Every device starts after the work already issued to the caller's stream
+        CHECK_HIP_ERROR(hipEventCreateWithFlags(&mFork, hipEventDisableTiming));
+        CHECK_HIP_ERROR(hipEventRecord(mFork, mStream));
+        for(uint32_t device = 1; device < mHandle->getDeviceCount(); device++)
+        {
+            select(device);
+            CHECK_HIP_ERROR(hipStreamWaitEvent(deviceStream(device), mFork, 0));
+        }
+        CHECK_HIP_ERROR(hipSetDevice(mCurrent));
+    }
+
+    ~HipMultiDeviceBackend() override
+    {
+        CHECK_HIP_ERROR(hipSetDevice(mCurrent));
+        CHECK_HIP_ERROR(hipEventDestroy(mFork));
+    }
+
+    hiptensorStatus_t allocate(uint32_t device, void** ptr, std::size_t bytes) override
+    {
+        select(device);
+        *ptr = context(device).getWorkspacePool().acquire(bytes, deviceStream(device));
+        return *ptr != nullptr ? HIPTENSOR_STATUS_SUCCESS : HIPTENSOR_STATUS_ALLOC_FAILED;
+    }
+
+    hiptensorStatus_t release(uint32_t device, void* ptr) override
+    {
+        context(device).getWorkspacePool().release(ptr, deviceStream(device));
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t copy(uint32_t                    device,
+                           void*                       dst,
+                           hiptensorDimVector_t const& dstStrides,
+                           void const*                 src,
+                           hiptensorDimVector_t const& srcStrides,
+                           hiptensorDimVector_t const& lengths,
+                           std::size_t                 elementBytes) override
+    {
+        // Unified addressing resolves the devices on either side of the copy
+        select(device);
+        auto result = hipSuccess;
+        hiptensor::forEachCopyRun(
+            lengths,
+            srcStrides,
+            dstStrides,
+            [&](std::size_t srcOffset, std::size_t dstOffset, std::size_t count) {
+                if(result == hipSuccess)
+                {
+                    result = hipMemcpyAsync((char*)dst + dstOffset * elementBytes,
+                                            (char const*)src + srcOffset * elementBytes,
+                                            count * elementBytes,
+                                            hipMemcpyDefault,
+                                            deviceStream(device));
+                }
+            });
+        return result == hipSuccess ? HIPTENSOR_STATUS_SUCCESS : HIPTENSOR_STATUS_HIP_ERROR;
+    }
+
+    hiptensorStatus_t contract(uint32_t                                   device,
+                               void const*                                alpha,
+                               void const*                                A,
+                               void const*                                B,
+                               void const*                                beta,
+                               void const*                                C,
+                               void*                                      D,
+                               std::array<hiptensorDimVector_t, 4> const& lengths,
+                               std::array<hiptensorDimVector_t, 4> const& strides) override
+    {
+        select(device);
+        auto* solution = mSolutions[device];
+        auto  init     = [&](void* workspace) {
+            return solution->initArgs(alpha,
+                                      A,
+                                      B,
+                                      beta,
+                                      C,
+                                      D,
+                                      lengths[0],
+                                      strides[0],
+                                      lengths[1],
+                                      strides[1],
+                                      lengths[2],
+                                      strides[2],
+                                      lengths[3],
+                                      strides[3],
+                                      workspace);
+        };
+        if(solution == nullptr || !init(nullptr))
+        {
+            return HIPTENSOR_STATUS_INTERNAL_ERROR;
+        }
+
+        void* workspace = nullptr;
+        if(auto bytes = solution->workspaceSize(); bytes > 0)
+        {
+            if(allocate(device, &workspace, bytes) != HIPTENSOR_STATUS_SUCCESS || !init(workspace))
+            {
+                return HIPTENSOR_STATUS_ALLOC_FAILED;
+            }
+        }
+
+        // Kernel arguments are copied at launch, so the workspace may go back to the
+        // pool in stream order right after
+        (*solution)(StreamConfig{deviceStream(device), false});
+        if(workspace != nullptr)
+        {
+            release(device, workspace);
+        }
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t join() override
+    {
+        auto status = HIPTENSOR_STATUS_SUCCESS;
+        for(uint32_t device = 1; device < mHandle->getDeviceCount(); device++)
+        {
+            select(device);
+            hipEvent_t done;
+            if(hipEventCreateWithFlags(&done, hipEventDisableTiming) != hipSuccess
+               || hipEventRecord(done, deviceStream(device)) != hipSuccess
+               || hipStreamWaitEvent(mStream, done, 0) != hipSuccess
+               || hipEventDestroy(done) != hipSuccess)
+            {
+                status = HIPTENSOR_STATUS_HIP_ERROR;
+            }
+        }
+        CHECK_HIP_ERROR(hipSetDevice(mCurrent));
+        return status;
+    }
+
+private:
+    hiptensor::DeviceContext& context(uint32_t device)
+    {
+        return mHandle->getDeviceContext(device);
+    }
+
+    hipStream_t deviceStream(uint32_t device)
+    {
+        return device == 0 ? mStream : context(device).getStream();
+    }
+
+    void select(uint32_t device)
+    {
+        CHECK_HIP_ERROR(hipSetDevice(context(device).getDevice().getDeviceId()));
+    }
+
+    hiptensor::Handle*                           mHandle;
+    std::vector<hiptensor::ContractionSolution*> mSolutions;
+    hipStream_t                                  mStream;
+    hipDevice_t                                  mCurrent = -1;
+    hipEvent_t                                   mFork    = nullptr;
+};
+
+// Kernel for one device's share of a multi-device contraction. The plan's own kernel is
+// kept on devices of the same architecture that accept the share; otherwise the device's
+// candidates are timed on it and the winner cached in that device's plan cache.
+static hiptensor::ContractionSolution*
+    selectShareSolution(hiptensor::Handle*                         handle,
+                        hiptensorContractionPlan_t const*          plan,
+                        hiptensor::MultiDevicePlan const&          multiPlan,
+                        uint32_t                                   device,
+                        std::array<hiptensorDimVector_t, 4> const& lengths,
+                        std::array<hiptensorDimVector_t, 4> const& strides,
+                        uint64_t                                   workspaceSize)
+{
+    auto* cSolution = (hiptensor::ContractionSolution*)(plan->mSolution);
+    auto& context   = handle->getDeviceContext(device);
+    auto  accepts   = [&](hiptensor::ContractionSolution* solution) {
+        return solution->initArgs(nullptr,
+                                  nullptr,
+                                  nullptr,
+                                  nullptr,
+                                  nullptr,
+                                  nullptr,
+                                  lengths[0],
+                                  strides[0],
+                                  lengths[1],
+                                  strides[1],
+                                  lengths[2],
+                                  strides[2],
+                                  lengths[3],
+                                  strides[3],
+                                  nullptr)
+               && solution->workspaceSize() <= workspaceSize;
+    };
+
+    if(context.getDevice().getGcnArch() == handle->getDevice().getGcnArch() && accepts(cSolution))
+    {
+        return cSolution;
+    }
+
+    auto& candidates = context.getCandidates();
+    if(candidates.empty())
+    {
+        auto& instances = hiptensor::ContractionSolutionInstances::instance();
+        auto  solnQ     = instances->allSolutions();
+        if(!context.getDevice().supportsF64())
+        {
+            solnQ = solnQ.query(HIP_R_32F, HIP_R_32F, HIP_R_32F, HIP_R_32F)
+                    || solnQ.query(
+                        HIP_R_32F, HIP_R_32F, hipDataType(hiptensor::NONE_TYPE), HIP_R_32F);
+        }
+        candidates = toVoidVec(solnQ.solutions());
+    }
+
+    auto& cache     = context.getDescriptorCache();
+    auto* signature = cache.intern(plan->mContractionDesc);
+    auto  keep      = cache.retain(signature);
+    if(auto* cached = (hiptensor::ContractionSolution*)cache.findPlan(
+           signature, HIPTENSOR_ALGO_DEFAULT, workspaceSize, {}, candidates);
+       cached != nullptr && accepts(cached))
+    {
+        return cached;
+    }
+
+    auto solutionQ
+        = hiptensor::ContractionSolutionRegistry::Query{toContractionSolutionVec(candidates)}
+              .query((hiptensor::ContractionOpId_t)plan->mContractionDesc.mContractionOpId)
+              .query(multiPlan.mTypes[0],
+                     multiPlan.mTypes[1],
+                     multiPlan.mTypes[2],
+                     multiPlan.mTypes[3]);
+
+    hiptensor::ContractionSolution* winner = nullptr;
+    if(hiptensor::bruteForceModel(&winner,
+                                  toContractionSolutionVec(solutionQ.solutions()),
+                                  multiPlan.mTypes[0],
+                                  lengths[0],
+                                  strides[0],
+                                  multiPlan.mTypes[1],
+                                  lengths[1],
+                                  strides[1],
+                                  multiPlan.mTypes[2],
+                                  lengths[2],
+                                  strides[2],
+                                  multiPlan.mTypes[3],
+                                  lengths[3],
+                                  strides[3],
+                                  workspaceSize)
+       != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return nullptr;
+    }
+
+    cache.cachePlan(signature, HIPTENSOR_ALGO_DEFAULT, workspaceSize, winner, {}, candidates);
+    return winner;
+}
+
+hiptensorStatus_t hiptensorContractionMultiDevice(const hiptensorHandle_t*          handle,
+                                                  const hiptensorContractionPlan_t* plan,
+                                                  const void*                       alpha,
+                                                  const void*                       A,
+                                                  const void*                       B,
+                                                  const void*                       beta,
+                                                  const void*                       C,
+                                                  void*                             D,
+                                                  hipStream_t                       stream)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, A=0x%llX, B=0x%llX, C=0x%llX, D=0x%llX, "
+             "stream=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)A,
+             (unsigned long long)B,
+             (unsigned long long)C,
+             (unsigned long long)D,
+             (unsigned long long)stream);
+    logger->logAPITrace("hiptensorContractionMultiDevice", msg);
+
+    if(handle == nullptr || plan == nullptr || plan->mSolution == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionMultiDevice", msg);
+        return errorCode;
+    }
+
+    auto  realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto* signature  = realHandle->getDescriptorCache().signature(plan->mContractionDesc);
+    auto  hasC       = signature->mTensors[2]->mType != hiptensor::NONE_TYPE;
+
+    if(auto status = requireHostScalars("hiptensorContractionMultiDevice", realHandle);
+       status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    if(alpha == nullptr || A == nullptr || B == nullptr || D == nullptr || (hasC && C == nullptr))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/A/B/C/D = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionMultiDevice", msg);
+        return errorCode;
+    }
+
+    // Operands live on the handle's first device, which must be current
+    hiptensor::HipDevice currentDevice;
+    if((int)currentDevice.getDeviceId() != realHandle->getDevice().getDeviceId())
+    {
+        auto errorCode = HIPTENSOR_STATUS_ARCH_MISMATCH;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Device mismatch error: current device id: %d, handle device id: %d (%s)",
+                 (int)currentDevice.getDeviceId(),
+                 (int)realHandle->getDevice().getDeviceId(),
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionMultiDevice", msg);
+        return errorCode;
+    }
+
+    if(signature->mStagingBytes > 0 || signature->mPartitions != 1)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Multi-device contractions take neither staged nor partitioned operands (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionMultiDevice", msg);
+        return errorCode;
+    }
+
+    // Devices are weighted by their peak throughput
+    std::vector<double> weights;
+    for(uint32_t device = 0; device < realHandle->getDeviceCount(); device++)
+    {
+        auto const& hipDevice = realHandle->getDeviceContext(device).getDevice();
+        weights.push_back(std::max(1.0, (double)hipDevice.cuCount() * hipDevice.maxFreqMhz()));
+    }
+
+    hiptensor::MultiDevicePlan multiPlan;
+    auto status = hiptensor::planMultiDevice(&multiPlan, *signature, weights);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to split the contraction across %u devices (%s)",
+                 realHandle->getDeviceCount(),
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorContractionMultiDevice", msg);
+        return status;
+    }
+
+    // Shares may use as much kernel workspace as the plan's kernel needs for the whole
+    auto* cSolution     = (hiptensor::ContractionSolution*)(plan->mSolution);
+    auto  workspaceSize = planWorkspaceSize(signature, cSolution, HIPTENSOR_POINTER_MODE_HOST);
+
+    std::vector<hiptensor::ContractionSolution*> solutions(realHandle->getDeviceCount(), nullptr);
+    for(auto const& share : multiPlan.mShares)
+    {
+        auto lengths = multiPlan.shareLengths(share);
+        auto strides = multiPlan.mStrides;
+        if(share.mDevice != 0)
+        {
+            for(int i = 0; i < 4; i++)
+            {
+                strides[i] = hiptensor::stridesFromLengths(lengths[i]);
+            }
+        }
+
+        CHECK_HIP_ERROR(hipSetDevice(
+            realHandle->getDeviceContext(share.mDevice).getDevice().getDeviceId()));
+        solutions[share.mDevice] = selectShareSolution(
+            realHandle, plan, multiPlan, share.mDevice, lengths, strides, workspaceSize);
+        CHECK_HIP_ERROR(hipSetDevice(currentDevice.getDeviceId()));
+
+        if(solutions[share.mDevice] == nullptr)
+        {
+            auto errorCode = HIPTENSOR_STATUS_EXECUTION_FAILED;
+            snprintf(msg,
+                     sizeof(msg),
+                     "No kernel accepts the share of device %u (%s)",
+                     share.mDevice,
+                     hiptensorGetErrorString(errorCode));
+            logger->logError("hiptensorContractionMultiDevice", msg);
+            return errorCode;
+        }
+
+        snprintf(msg,
+                 sizeof(msg),
+                 "Device %u contracts %s [%lu, %lu) with %s",
+                 share.mDevice,
+                 multiPlan.mSplitN ? "N" : "M",
+                 share.mStart,
+                 share.mStart + share.mExtent,
+                 solutions[share.mDevice]->kernelName().c_str());
+        logger->logHeuristics("hiptensorContractionMultiDevice", msg);
+    }
+
+    HipMultiDeviceBackend backend(realHandle, std::move(solutions), stream);
+    status = hiptensor::multiDeviceContraction(multiPlan, backend, alpha, A, B, beta, C, D);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Multi-device contraction failed (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorContractionMultiDevice", msg);
+    }
+    return status;
+}
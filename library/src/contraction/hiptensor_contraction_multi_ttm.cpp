@@ -0,0 +1,489 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <algorithm>
+
+#include <hiptensor/hiptensor.hpp>
+
+#include "contraction_launch.hpp"
+#include "contraction_multi_ttm.hpp"
+#include "handle.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+
+hiptensorStatus_t hiptensorInitMultiTtmPlan(const hiptensorHandle_t*           handle,
+                                            hiptensorMultiTtmPlan_t*           plan,
+                                            const hiptensorTensorDescriptor_t* descX,
+                                            const int32_t                      modeX[],
+                                            const uint32_t                     numMatrices,
+                                            const hiptensorTensorDescriptor_t  descU[],
+                                            const int32_t                      modeU[],
+                                            const hiptensorTensorDescriptor_t* descC,
+                                            const int32_t                      modeC[],
+                                            const hiptensorTensorDescriptor_t* descY,
+                                            const int32_t                      modeY[],
+                                            hiptensorComputeType_t             typeCompute)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, descX=0x%llX, numMatrices=%u, descU=0x%llX, "
+             "descC=0x%llX, descY=0x%llX, typeCompute=0x%02X",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)descX,
+             numMatrices,
+             (unsigned long long)descU,
+             (unsigned long long)descC,
+             (unsigned long long)descY,
+             (unsigned int)typeCompute);
+    logger->logAPITrace("hiptensorInitMultiTtmPlan", msg);
+
+    if(handle == nullptr || plan == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitMultiTtmPlan", msg);
+        return errorCode;
+    }
+
+    auto invalid = [&](char const* reason) {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : %s (%s)",
+                 reason,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitMultiTtmPlan", msg);
+        return errorCode;
+    };
+
+    if(descX == nullptr || descY == nullptr || numMatrices == 0 || descU == nullptr
+       || modeU == nullptr || modeX == nullptr || modeY == nullptr)
+    {
+        return invalid("descX/descU/descY or modes = nullptr, or no matrices");
+    }
+
+    // Operands are packed with the last mode fastest and of one data type
+    auto packed = [&](hiptensorTensorDescriptor_t const& desc) {
+        return desc.mType == descX->mType
+               && desc.mStrides == hiptensor::stridesFromLengths(desc.mLengths);
+    };
+
+    // Each matrix U = [R, K] replaces the mode of X that its second mode names by its
+    // first mode, in place
+    auto                     rank = descX->mLengths.size();
+    std::vector<uint32_t>    modes;
+    std::vector<std::size_t> ranks;
+    std::vector<int32_t>     expectedModes(modeX, modeX + rank);
+    auto                     expectedLengths = descX->mLengths;
+    for(uint32_t j = 0; j < numMatrices; j++)
+    {
+        auto mode = std::find(modeX, modeX + rank, modeU[2 * j + 1]) - modeX;
+        if(!packed(descU[j]) || descU[j].mLengths.size() != 2 || mode == rank
+           || descU[j].mLengths[1] != descX->mLengths[mode])
+        {
+            return invalid("each matrix must be packed [R, K] along a mode of X");
+        }
+        modes.push_back(uint32_t(mode));
+        ranks.push_back(descU[j].mLengths[0]);
+        expectedModes[mode]   = modeU[2 * j];
+        expectedLengths[mode] = descU[j].mLengths[0];
+    }
+
+    auto hasC  = descC != nullptr;
+    auto likeY = [&](hiptensorTensorDescriptor_t const* desc, int32_t const* mode) {
+        return packed(*desc) && desc->mLengths == expectedLengths && mode != nullptr
+               && std::equal(mode, mode + rank, expectedModes.begin());
+    };
+    if(!packed(*descX) || !likeY(descY, modeY) || (hasC && !likeY(descC, modeC)))
+    {
+        return invalid("X, C and Y must be packed, with the matrices' modes in place in Y");
+    }
+
+    auto* ttmPlan = new hiptensor::MultiTtmPlan;
+    auto  status  = hiptensor::planMultiTtm(
+        ttmPlan, descX->mType, descX->mLengths, modes, ranks, hasC);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        delete ttmPlan;
+        return invalid("each mode of X takes at most one matrix");
+    }
+
+    // Every product is a contraction with its own plan; the intermediates alternate
+    // between two buffers ahead of the kernels' workspace
+    hiptensorContractionFind_t find;
+    status = hiptensorInitContractionFind(handle, &find, HIPTENSOR_ALGO_DEFAULT);
+
+    std::vector<int32_t> labels(modeX, modeX + rank);
+    uint64_t             kernelBytes = 0;
+    for(std::size_t s = 0; s < ttmPlan->mSteps.size() && status == HIPTENSOR_STATUS_SUCCESS; s++)
+    {
+        auto const& step = ttmPlan->mSteps[s];
+        auto        last = s + 1 == ttmPlan->mSteps.size();
+
+        hiptensorTensorDescriptor_t in  = {descX->mType,
+                                          step.mLengthsIn,
+                                          hiptensor::stridesFromLengths(step.mLengthsIn),
+                                          nullptr};
+        hiptensorTensorDescriptor_t out = {descX->mType,
+                                           step.mLengthsOut,
+                                           hiptensor::stridesFromLengths(step.mLengthsOut),
+                                           nullptr};
+        auto                        labelsOut = labels;
+        labelsOut[step.mMode]                 = modeU[2 * step.mMatrix];
+
+        hiptensorContractionDescriptor_t desc;
+        status = hiptensorInitContractionDescriptor(handle,
+                                                    &desc,
+                                                    &in,
+                                                    labels.data(),
+                                                    hiptensor::MaxVectorBytes,
+                                                    &descU[step.mMatrix],
+                                                    &modeU[2 * step.mMatrix],
+                                                    hiptensor::MaxVectorBytes,
+                                                    last && hasC ? &out : nullptr,
+                                                    last && hasC ? labelsOut.data() : nullptr,
+                                                    hiptensor::MaxVectorBytes,
+                                                    &out,
+                                                    labelsOut.data(),
+                                                    hiptensor::MaxVectorBytes,
+                                                    typeCompute);
+
+        uint64_t stepBytes = 0;
+        if(status == HIPTENSOR_STATUS_SUCCESS)
+        {
+            status = hiptensorContractionGetWorkspaceSize(
+                handle, &desc, &find, HIPTENSOR_WORKSPACE_RECOMMENDED, &stepBytes);
+        }
+
+        hiptensorContractionPlan_t stepPlan;
+        if(status == HIPTENSOR_STATUS_SUCCESS)
+        {
+            status = hiptensorInitContractionPlan(handle, &stepPlan, &desc, &find, stepBytes);
+        }
+        ttmPlan->mDensePlans.push_back(stepPlan);
+        kernelBytes = std::max(kernelBytes, stepBytes);
+        labels      = labelsOut;
+    }
+
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to plan the matrix products (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorInitMultiTtmPlan", msg);
+        delete ttmPlan;
+        return status;
+    }
+
+    auto intermediateBytes
+        = hiptensor::ceilDiv(ttmPlan->mIntermediateElements
+                                 * hiptensor::hipDataTypeSize(descX->mType),
+                             uint64_t(hiptensor::WorkspaceGranularity))
+          * hiptensor::WorkspaceGranularity;
+    ttmPlan->mWorkspaceSize = 2 * intermediateBytes + kernelBytes;
+
+    snprintf(msg,
+             sizeof(msg),
+             "%lu products, %lu multiply-adds, largest intermediate: %lu elements",
+             (unsigned long)ttmPlan->mSteps.size(),
+             (unsigned long)ttmPlan->mMultiplyAdds,
+             (unsigned long)ttmPlan->mIntermediateElements);
+    logger->logHeuristics("hiptensorInitMultiTtmPlan", msg);
+
+    plan->mPlan = ttmPlan;
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorMultiTtmGetWorkspaceSize(const hiptensorHandle_t*       handle,
+                                                    const hiptensorMultiTtmPlan_t* plan,
+                                                    uint64_t*                      workspaceSize)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    if(handle == nullptr || plan == nullptr || plan->mPlan == nullptr || workspaceSize == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        char msg[128];
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : handle/plan/workspaceSize = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorMultiTtmGetWorkspaceSize", msg);
+        return errorCode;
+    }
+
+    *workspaceSize = static_cast<hiptensor::MultiTtmPlan const*>(plan->mPlan)->mWorkspaceSize;
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorMultiTtm(const hiptensorHandle_t*       handle,
+                                    const hiptensorMultiTtmPlan_t* plan,
+                                    const void*                    alpha,
+                                    const void*                    X,
+                                    const void* const              U[],
+                                    const void*                    beta,
+                                    const void*                    C,
+                                    void*                          Y,
+                                    void*                          workspace,
+                                    uint64_t                       workspaceSize,
+                                    hipStream_t                    stream)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, X=0x%llX, U=0x%llX, C=0x%llX, Y=0x%llX, "
+             "workspace=0x%llX, workspaceSize=0x%04lX, stream=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)X,
+             (unsigned long long)U,
+             (unsigned long long)C,
+             (unsigned long long)Y,
+             (unsigned long long)workspace,
+             (unsigned long)workspaceSize,
+             (unsigned long long)stream);
+    logger->logAPITrace("hiptensorMultiTtm", msg);
+
+    if(handle == nullptr || plan == nullptr || plan->mPlan == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorMultiTtm", msg);
+        return errorCode;
+    }
+
+    auto const& ttmPlan = *static_cast<hiptensor::MultiTtmPlan const*>(plan->mPlan);
+    if(alpha == nullptr || X == nullptr || U == nullptr || Y == nullptr
+       || (ttmPlan.mHasC && (beta == nullptr || C == nullptr)))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/beta/X/U/C/Y = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorMultiTtm", msg);
+        return errorCode;
+    }
+
+    auto realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    if(auto status = requireHostScalars("hiptensorMultiTtm", realHandle);
+       status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    if(workspace != nullptr && workspaceSize < ttmPlan.mWorkspaceSize)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Insufficient workspace for the intermediates: req: %lu alloc: %lu (%s)",
+                 (unsigned long)ttmPlan.mWorkspaceSize,
+                 (unsigned long)workspaceSize,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorMultiTtm", msg);
+        return errorCode;
+    }
+
+    // Intermediate products are unscaled; alpha and beta apply to the last one
+    auto unit = std::array<std::array<char, 16>, 2>{};
+    if(ttmPlan.mType == HIP_R_16F)
+    {
+        writeUnitScalars<_Float16>(unit);
+    }
+    else if(ttmPlan.mType == HIP_R_32F)
+    {
+        writeUnitScalars<float>(unit);
+    }
+    else if(ttmPlan.mType == HIP_R_64F)
+    {
+        writeUnitScalars<double>(unit);
+    }
+    else
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Multi-TTM supports f16, f32 and f64 operands (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorMultiTtm", msg);
+        return errorCode;
+    }
+
+    // Without a workspace, the intermediates live in a block of the handle's pool
+    auto& pool   = realHandle->getWorkspacePool();
+    auto* pooled = workspace == nullptr ? pool.acquire(ttmPlan.mWorkspaceSize, stream) : nullptr;
+    if(workspace == nullptr && pooled == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_ALLOC_FAILED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to allocate %lu bytes of pooled workspace (%s)",
+                 (unsigned long)ttmPlan.mWorkspaceSize,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorMultiTtm", msg);
+        return errorCode;
+    }
+
+    auto* base              = (char*)(workspace != nullptr ? workspace : pooled);
+    auto  intermediateBytes = hiptensor::ceilDiv(ttmPlan.mIntermediateElements
+                                                    * hiptensor::hipDataTypeSize(ttmPlan.mType),
+                                                uint64_t(hiptensor::WorkspaceGranularity))
+                             * hiptensor::WorkspaceGranularity;
+    std::array<void*, 2> buffers     = {base, base + intermediateBytes};
+    auto*                kernelSpace = base + 2 * intermediateBytes;
+    auto                 kernelBytes = ttmPlan.mWorkspaceSize - 2 * intermediateBytes;
+
+    auto        status = HIPTENSOR_STATUS_SUCCESS;
+    void const* in     = X;
+    for(std::size_t s = 0; s < ttmPlan.mSteps.size() && status == HIPTENSOR_STATUS_SUCCESS; s++)
+    {
+        auto  last = s + 1 == ttmPlan.mSteps.size();
+        void* out  = last ? Y : buffers[s % 2];
+        status     = hiptensorContraction(handle,
+                                      &ttmPlan.mDensePlans[s],
+                                      last ? alpha : unit[0].data(),
+                                      in,
+                                      U[ttmPlan.mSteps[s].mMatrix],
+                                      last ? beta : unit[1].data(),
+                                      last ? C : nullptr,
+                                      out,
+                                      kernelSpace,
+                                      kernelBytes,
+                                      stream);
+        in         = out;
+    }
+
+    if(pooled != nullptr)
+    {
+        pool.release(pooled, stream);
+    }
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg, sizeof(msg), "Multi-TTM failed (%s)", hiptensorGetErrorString(status));
+        logger->logError("hiptensorMultiTtm", msg);
+    }
+    return status;
+}
+
+hiptensorStatus_t hiptensorMultiTtmHost(const hiptensorMultiTtmPlan_t* plan,
+                                        const void*                    alpha,
+                                        const void*                    X,
+                                        const void* const              U[],
+                                        const void*                    beta,
+                                        const void*                    C,
+                                        void*                          Y,
+                                        uint32_t                       numThreads)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "plan=0x%0*llX, X=0x%llX, U=0x%llX, C=0x%llX, Y=0x%llX, numThreads=%u",
+             2 * (int)sizeof(void*),
+             (unsigned long long)plan,
+             (unsigned long long)X,
+             (unsigned long long)U,
+             (unsigned long long)C,
+             (unsigned long long)Y,
+             numThreads);
+    logger->logAPITrace("hiptensorMultiTtmHost", msg);
+
+    if(plan == nullptr || plan->mPlan == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorMultiTtmHost", msg);
+        return errorCode;
+    }
+
+    auto const& ttmPlan = *static_cast<hiptensor::MultiTtmPlan const*>(plan->mPlan);
+    if(alpha == nullptr || X == nullptr || U == nullptr || Y == nullptr
+       || (ttmPlan.mHasC && (beta == nullptr || C == nullptr)))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/beta/X/U/C/Y = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorMultiTtmHost", msg);
+        return errorCode;
+    }
+
+    auto status = hiptensor::multiTtmHost(ttmPlan, alpha, X, U, beta, C, Y, numThreads);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Host multi-TTM supports f32 and f64 operands (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorMultiTtmHost", msg);
+    }
+    return status;
+}
+
+hiptensorStatus_t hiptensorDestroyMultiTtmPlan(hiptensorMultiTtmPlan_t* plan)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg, sizeof(msg), "plan=0x%0*llX", 2 * (int)sizeof(void*), (unsigned long long)plan);
+    logger->logAPITrace("hiptensorDestroyMultiTtmPlan", msg);
+
+    if(plan)
+    {
+        delete static_cast<hiptensor::MultiTtmPlan*>(plan->mPlan);
+        plan->mPlan = nullptr;
+    }
+    return HIPTENSOR_STATUS_SUCCESS;
+}
@@ -0,0 +1,343 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <hiptensor/hiptensor.hpp>
+
+#include "contraction_launch.hpp"
+#include "contraction_streaming.hpp"
+#include "handle.hpp"
+#include "logger.hpp"
+#include "tensor_file.hpp"
+#include "util.hpp"
+
+// Tiles a single-output contraction of host operands into numBuffers device buffers and
+// runs it, forwarding the tile order to hints when given
+static hiptensorStatus_t runStreamedContraction(char const*                            api,
+                                                hiptensor::ContractionSignature const* signature,
+                                                hiptensor::ContractionSolution*        cSolution,
+                                                const void*                            alpha,
+                                                const void*                            A,
+                                                const void*                            B,
+                                                const void*                            beta,
+                                                const void*                            C,
+                                                void*                                  D,
+                                                uint64_t                               deviceBytes,
+                                                uint32_t                               numBuffers,
+                                                hiptensor::StreamingHints*             hints)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    char msg[512];
+
+    // By default, tiles may take all free device memory
+    if(deviceBytes == 0)
+    {
+        std::size_t freeBytes = 0, totalBytes = 0;
+        CHECK_HIP_ERROR(hipMemGetInfo(&freeBytes, &totalBytes));
+        deviceBytes = freeBytes;
+    }
+
+    // Tiles are first planned without kernel workspace, which is then sized for the
+    // largest tile and the plan redone if the kernel needs any.
+    hiptensor::StreamingPlan streamingPlan;
+    auto                     workspaceBytes = std::size_t{0};
+
+    auto status = hiptensor::planStreaming(&streamingPlan, *signature, deviceBytes, 0, numBuffers);
+    if(status == HIPTENSOR_STATUS_SUCCESS)
+    {
+        auto lengths = streamingPlan.tileLengths(
+            {0, streamingPlan.mTileM, 0, streamingPlan.mTileN, 0, streamingPlan.mTileK});
+        if(cSolution->initArgs(alpha,
+                               nullptr,
+                               nullptr,
+                               beta,
+                               nullptr,
+                               nullptr,
+                               lengths[0],
+                               hiptensor::stridesFromLengths(lengths[0]),
+                               lengths[1],
+                               hiptensor::stridesFromLengths(lengths[1]),
+                               lengths[2],
+                               hiptensor::stridesFromLengths(lengths[2]),
+                               lengths[3],
+                               hiptensor::stridesFromLengths(lengths[3]),
+                               nullptr))
+        {
+            workspaceBytes = cSolution->workspaceSize();
+        }
+    }
+    if(status == HIPTENSOR_STATUS_SUCCESS && workspaceBytes > 0)
+    {
+        status = hiptensor::planStreaming(
+            &streamingPlan, *signature, deviceBytes, workspaceBytes, numBuffers);
+    }
+
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to tile the contraction into %u buffers of %lu device bytes (%s)",
+                 numBuffers,
+                 (unsigned long)deviceBytes,
+                 hiptensorGetErrorString(status));
+        logger->logError(api, msg);
+        return status;
+    }
+
+    snprintf(msg,
+             sizeof(msg),
+             "Streaming %lu tiles of outer extents M: %lu, N: %lu, K: %lu through %u buffers",
+             streamingPlan.tiles().size(),
+             streamingPlan.mTileM,
+             streamingPlan.mTileN,
+             streamingPlan.mTileK,
+             numBuffers);
+    logger->logHeuristics(api, msg);
+
+    HipStreamingBackend backend(cSolution, numBuffers);
+    status
+        = hiptensor::streamContraction(streamingPlan, backend, alpha, A, B, beta, C, D, hints);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Streamed contraction failed (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError(api, msg);
+    }
+    return status;
+}
+
+hiptensorStatus_t hiptensorContractionStreamed(const hiptensorHandle_t*          handle,
+                                               const hiptensorContractionPlan_t* plan,
+                                               const void*                       alpha,
+                                               const void*                       A,
+                                               const void*                       B,
+                                               const void*                       beta,
+                                               const void*                       C,
+                                               void*                             D,
+                                               uint64_t                          deviceBytes,
+                                               uint32_t                          numBuffers)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, A=0x%llX, B=0x%llX, C=0x%llX, D=0x%llX, "
+             "deviceBytes=0x%04lX, numBuffers=%u",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)A,
+             (unsigned long long)B,
+             (unsigned long long)C,
+             (unsigned long long)D,
+             (unsigned long)deviceBytes,
+             numBuffers);
+    logger->logAPITrace("hiptensorContractionStreamed", msg);
+
+    if(handle == nullptr || plan == nullptr || plan->mSolution == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionStreamed", msg);
+        return errorCode;
+    }
+
+    auto  realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto* signature  = realHandle->getDescriptorCache().signature(plan->mContractionDesc);
+    auto  hasC       = signature->mTensors[2]->mType != hiptensor::NONE_TYPE;
+
+    if(auto status = requireHostScalars("hiptensorContractionStreamed", realHandle);
+       status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    if(alpha == nullptr || A == nullptr || B == nullptr || D == nullptr || numBuffers == 0
+       || (hasC && C == nullptr))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/A/B/C/D = nullptr or numBuffers = 0 (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionStreamed", msg);
+        return errorCode;
+    }
+
+    if(signature->mOutputs > 1)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Streamed contractions take a single output, plan has %u (%s)",
+                 signature->mOutputs,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionStreamed", msg);
+        return errorCode;
+    }
+
+    return runStreamedContraction("hiptensorContractionStreamed",
+                                  signature,
+                                  (hiptensor::ContractionSolution*)(plan->mSolution),
+                                  alpha,
+                                  A,
+                                  B,
+                                  beta,
+                                  C,
+                                  D,
+                                  deviceBytes,
+                                  numBuffers,
+                                  nullptr);
+}
+
+hiptensorStatus_t hiptensorContractionStreamedFromFiles(const hiptensorHandle_t*          handle,
+                                                        const hiptensorContractionPlan_t* plan,
+                                                        const void*                       alpha,
+                                                        const char*                       pathA,
+                                                        const char*                       pathB,
+                                                        const void*                       beta,
+                                                        const char*                       pathC,
+                                                        const char*                       pathD,
+                                                        uint64_t deviceBytes,
+                                                        uint32_t numBuffers)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[1024];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, pathA=%s, pathB=%s, pathC=%s, pathD=%s, "
+             "deviceBytes=0x%04lX, numBuffers=%u",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             pathA != nullptr ? pathA : "nullptr",
+             pathB != nullptr ? pathB : "nullptr",
+             pathC != nullptr ? pathC : "nullptr",
+             pathD != nullptr ? pathD : "nullptr",
+             (unsigned long)deviceBytes,
+             numBuffers);
+    logger->logAPITrace("hiptensorContractionStreamedFromFiles", msg);
+
+    if(handle == nullptr || plan == nullptr || plan->mSolution == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionStreamedFromFiles", msg);
+        return errorCode;
+    }
+
+    auto  realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto* signature  = realHandle->getDescriptorCache().signature(plan->mContractionDesc);
+    auto  hasC       = signature->mTensors[2]->mType != hiptensor::NONE_TYPE;
+
+    if(auto status = requireHostScalars("hiptensorContractionStreamedFromFiles", realHandle);
+       status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    std::array<char const*, 4> paths = {pathA, pathB, hasC ? pathC : nullptr, pathD};
+    if(alpha == nullptr || pathA == nullptr || pathB == nullptr || pathD == nullptr
+       || numBuffers == 0 || (hasC && pathC == nullptr))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/pathA/pathB/pathC/pathD = nullptr or "
+                 "numBuffers = 0 (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionStreamedFromFiles", msg);
+        return errorCode;
+    }
+
+    if(signature->mOutputs > 1)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_SUPPORTED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Streamed contractions take a single output, plan has %u (%s)",
+                 signature->mOutputs,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorContractionStreamedFromFiles", msg);
+        return errorCode;
+    }
+
+    // Operands are mapped in place, D for writing, and must hold the plan's tensors
+    std::array<hiptensor::MappedTensorFile, 4> files;
+    for(int i = 0; i < files.size(); i++)
+    {
+        if(paths[i] == nullptr)
+        {
+            continue;
+        }
+
+        auto status = files[i].open(paths[i], i == 3);
+        if(status == HIPTENSOR_STATUS_SUCCESS
+           && !signature->mOutputTensors[i]->matches(files[i].descriptor()))
+        {
+            status = HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+        if(status != HIPTENSOR_STATUS_SUCCESS)
+        {
+            snprintf(msg,
+                     sizeof(msg),
+                     "Unable to map %c from %s as the plan's tensor (%s)",
+                     "ABCD"[i],
+                     paths[i],
+                     hiptensorGetErrorString(status));
+            logger->logError("hiptensorContractionStreamedFromFiles", msg);
+            return status;
+        }
+    }
+
+    hiptensor::MappedTensorHints hints({&files[0], &files[1], &files[2], &files[3]});
+    return runStreamedContraction("hiptensorContractionStreamedFromFiles",
+                                  signature,
+                                  (hiptensor::ContractionSolution*)(plan->mSolution),
+                                  alpha,
+                                  files[0].data(),
+                                  files[1].data(),
+                                  beta,
+                                  files[2].data(),
+                                  files[3].data(),
+                                  deviceBytes,
+                                  numBuffers,
+                                  &hints);
+}
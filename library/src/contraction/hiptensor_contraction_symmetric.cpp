@@ -0,0 +1,570 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <algorithm>
+
+#include <hiptensor/hiptensor.hpp>
+
+#include "contraction_launch.hpp"
+#include "contraction_symmetric.hpp"
+#include "handle.hpp"
+#include "logger.hpp"
+#include "symmetric_packing.hpp"
+#include "util.hpp"
+
+hiptensorStatus_t
+    hiptensorInitSymmetricTensorDescriptor(const hiptensorHandle_t*              handle,
+                                           hiptensorSymmetricTensorDescriptor_t* desc,
+                                           const uint32_t                        numModes,
+                                           const int64_t                         lens[],
+                                           const uint32_t                        numGroups,
+                                           const uint32_t                        groupSizes[],
+                                           const uint32_t                        groupModes[],
+                                           const hiptensorSymmetry_t             groupSymmetry[],
+                                           hipDataType                           dataType)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[256];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, desc=0x%llX, numModes=%u, numGroups=%u, dataType=0x%02X",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)desc,
+             numModes,
+             numGroups,
+             (unsigned int)dataType);
+    logger->logAPITrace("hiptensorInitSymmetricTensorDescriptor", msg);
+
+    if(handle == nullptr || desc == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or desc = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitSymmetricTensorDescriptor", msg);
+        return errorCode;
+    }
+
+    if((numModes > 0 && lens == nullptr)
+       || (numGroups > 0
+           && (groupSizes == nullptr || groupModes == nullptr || groupSymmetry == nullptr)))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : lens or symmetry groups = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitSymmetricTensorDescriptor", msg);
+        return errorCode;
+    }
+
+    hiptensorSymmetricTensorDescriptor_t result
+        = {dataType, hiptensorDimVector_t(lens, lens + numModes), {}};
+    auto const* modes = groupModes;
+    for(uint32_t g = 0; g < numGroups; g++)
+    {
+        result.mGroups.push_back(
+            {groupSymmetry[g], std::vector<uint32_t>(modes, modes + groupSizes[g])});
+        modes += groupSizes[g];
+    }
+
+    hiptensor::SymmetricShape shape;
+    auto                      status = hiptensor::symmetricShape(result, &shape);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Symmetry groups must be disjoint, with two or more modes of one length (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorInitSymmetricTensorDescriptor", msg);
+        return status;
+    }
+
+    *desc = std::move(result);
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t
+    hiptensorSymmetricTensorGetPackedSize(const hiptensorHandle_t*                    handle,
+                                          const hiptensorSymmetricTensorDescriptor_t* desc,
+                                          uint64_t*                                   size)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    char                      msg[256];
+    hiptensor::SymmetricShape shape;
+    if(handle == nullptr || desc == nullptr || size == nullptr
+       || hiptensor::symmetricShape(*desc, &shape) != HIPTENSOR_STATUS_SUCCESS)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : handle/desc/size = nullptr or invalid desc (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSymmetricTensorGetPackedSize", msg);
+        return errorCode;
+    }
+
+    *size = shape.mElements * hiptensor::hipDataTypeSize(desc->mType);
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t
+    hiptensorInitSymmetricContractionPlan(const hiptensorHandle_t*                    handle,
+                                          hiptensorSymmetricPlan_t*                   plan,
+                                          const hiptensorSymmetricTensorDescriptor_t* descA,
+                                          const int32_t                               modeA[],
+                                          const hiptensorSymmetricTensorDescriptor_t* descB,
+                                          const int32_t                               modeB[],
+                                          const hiptensorSymmetricTensorDescriptor_t* descC,
+                                          const int32_t                               modeC[],
+                                          const hiptensorSymmetricTensorDescriptor_t* descD,
+                                          const int32_t                               modeD[],
+                                          hiptensorComputeType_t typeCompute)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, descA=0x%llX, descB=0x%llX, descC=0x%llX, "
+             "descD=0x%llX, typeCompute=0x%02X",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)descA,
+             (unsigned long long)descB,
+             (unsigned long long)descC,
+             (unsigned long long)descD,
+             (unsigned int)typeCompute);
+    logger->logAPITrace("hiptensorInitSymmetricContractionPlan", msg);
+
+    if(handle == nullptr || plan == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitSymmetricContractionPlan", msg);
+        return errorCode;
+    }
+
+    // C is read at D's stored elements, so it must be packed like D
+    auto samePacking = [&]() {
+        auto rank = descD->mLengths.size();
+        if(descC->mType != descD->mType || descC->mLengths != descD->mLengths
+           || descC->mGroups.size() != descD->mGroups.size()
+           || (rank > 0 && (modeC == nullptr || modeD == nullptr))
+           || (rank > 0 && !std::equal(modeD, modeD + rank, modeC)))
+        {
+            return false;
+        }
+        for(int g = 0; g < descD->mGroups.size(); g++)
+        {
+            if(descC->mGroups[g].mSymmetry != descD->mGroups[g].mSymmetry
+               || descC->mGroups[g].mModes != descD->mGroups[g].mModes)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto hasC = descC != nullptr;
+    if(descA == nullptr || descB == nullptr || descD == nullptr || (hasC && !samePacking()))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : descA/descB/descD = nullptr or C is not packed "
+                 "like D (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorInitSymmetricContractionPlan", msg);
+        return errorCode;
+    }
+
+    auto* symmetricPlan = new hiptensor::SymmetricContractionPlan;
+    auto  status        = hiptensor::planSymmetric(
+        symmetricPlan, *descA, modeA, *descB, modeB, *descD, modeD, typeCompute, hasC);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Symmetric operands do not form a contraction (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorInitSymmetricContractionPlan", msg);
+        delete symmetricPlan;
+        return status;
+    }
+
+    // On a device the operands are expanded into the workspace and contracted in full
+    // by a dense plan, of which D's stored elements are kept
+    std::array<hiptensorTensorDescriptor_t, 3> dense;
+    std::array<uint64_t, 3>                    denseBytes;
+    for(int i = 0; i < 3; i++)
+    {
+        auto const& desc = symmetricPlan->mDescs[i];
+        dense[i]         = {desc.mType,
+                    desc.mLengths,
+                    hiptensor::stridesFromLengths(desc.mLengths),
+                    nullptr};
+        denseBytes[i]
+            = hiptensor::ceilDiv(hiptensor::fullElements(symmetricPlan->mShapes[i])
+                                     * hiptensor::hipDataTypeSize(desc.mType),
+                                 uint64_t(hiptensor::WorkspaceGranularity))
+              * hiptensor::WorkspaceGranularity;
+    }
+
+    auto const&                      modes = symmetricPlan->mModes;
+    hiptensorContractionDescriptor_t desc;
+    status = hiptensorInitContractionDescriptor(handle,
+                                                &desc,
+                                                &dense[0],
+                                                modes[0].data(),
+                                                hiptensor::MaxVectorBytes,
+                                                &dense[1],
+                                                modes[1].data(),
+                                                hiptensor::MaxVectorBytes,
+                                                hasC ? &dense[2] : nullptr,
+                                                hasC ? modes[2].data() : nullptr,
+                                                hiptensor::MaxVectorBytes,
+                                                &dense[2],
+                                                modes[2].data(),
+                                                hiptensor::MaxVectorBytes,
+                                                typeCompute);
+
+    hiptensorContractionFind_t find;
+    uint64_t                   kernelBytes = 0;
+    if(status == HIPTENSOR_STATUS_SUCCESS)
+    {
+        status = hiptensorInitContractionFind(handle, &find, HIPTENSOR_ALGO_DEFAULT);
+    }
+    if(status == HIPTENSOR_STATUS_SUCCESS)
+    {
+        status = hiptensorContractionGetWorkspaceSize(
+            handle, &desc, &find, HIPTENSOR_WORKSPACE_RECOMMENDED, &kernelBytes);
+    }
+    if(status == HIPTENSOR_STATUS_SUCCESS)
+    {
+        status = hiptensorInitContractionPlan(
+            handle, &symmetricPlan->mDensePlan, &desc, &find, kernelBytes);
+    }
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to plan the dense contraction (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorInitSymmetricContractionPlan", msg);
+        delete symmetricPlan;
+        return status;
+    }
+    symmetricPlan->mWorkspaceSize = denseBytes[0] + denseBytes[1] + denseBytes[2] + kernelBytes;
+
+    snprintf(msg,
+             sizeof(msg),
+             "Packed elements A: %lu/%lu, B: %lu/%lu, D: %lu/%lu, workspace: %lu bytes",
+             (unsigned long)symmetricPlan->mShapes[0].mElements,
+             (unsigned long)hiptensor::fullElements(symmetricPlan->mShapes[0]),
+             (unsigned long)symmetricPlan->mShapes[1].mElements,
+             (unsigned long)hiptensor::fullElements(symmetricPlan->mShapes[1]),
+             (unsigned long)symmetricPlan->mShapes[2].mElements,
+             (unsigned long)hiptensor::fullElements(symmetricPlan->mShapes[2]),
+             (unsigned long)symmetricPlan->mWorkspaceSize);
+    logger->logHeuristics("hiptensorInitSymmetricContractionPlan", msg);
+
+    plan->mPlan = symmetricPlan;
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t
+    hiptensorSymmetricContractionGetWorkspaceSize(const hiptensorHandle_t*        handle,
+                                                  const hiptensorSymmetricPlan_t* plan,
+                                                  uint64_t*                       workspaceSize)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    if(handle == nullptr || plan == nullptr || plan->mPlan == nullptr || workspaceSize == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        char msg[128];
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : handle/plan/workspaceSize = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSymmetricContractionGetWorkspaceSize", msg);
+        return errorCode;
+    }
+
+    *workspaceSize
+        = static_cast<hiptensor::SymmetricContractionPlan const*>(plan->mPlan)->mWorkspaceSize;
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorSymmetricContraction(const hiptensorHandle_t*        handle,
+                                                const hiptensorSymmetricPlan_t* plan,
+                                                const void*                     alpha,
+                                                const void*                     A,
+                                                const void*                     B,
+                                                const void*                     beta,
+                                                const void*                     C,
+                                                void*                           D,
+                                                void*                           workspace,
+                                                uint64_t                        workspaceSize,
+                                                hipStream_t                     stream)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, plan=0x%llX, A=0x%llX, B=0x%llX, C=0x%llX, D=0x%llX, "
+             "workspace=0x%llX, workspaceSize=0x%04lX, stream=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)plan,
+             (unsigned long long)A,
+             (unsigned long long)B,
+             (unsigned long long)C,
+             (unsigned long long)D,
+             (unsigned long long)workspace,
+             (unsigned long)workspaceSize,
+             (unsigned long long)stream);
+    logger->logAPITrace("hiptensorSymmetricContraction", msg);
+
+    if(handle == nullptr || plan == nullptr || plan->mPlan == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSymmetricContraction", msg);
+        return errorCode;
+    }
+
+    auto const& symmetricPlan
+        = *static_cast<hiptensor::SymmetricContractionPlan const*>(plan->mPlan);
+    if(alpha == nullptr || A == nullptr || B == nullptr || D == nullptr
+       || (symmetricPlan.mHasC && (beta == nullptr || C == nullptr)))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/beta/A/B/C/D = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSymmetricContraction", msg);
+        return errorCode;
+    }
+
+    auto realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    if(auto status = requireHostScalars("hiptensorSymmetricContraction", realHandle);
+       status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    if(workspace != nullptr && workspaceSize < symmetricPlan.mWorkspaceSize)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Insufficient workspace for the full operands: req: %lu alloc: %lu (%s)",
+                 (unsigned long)symmetricPlan.mWorkspaceSize,
+                 (unsigned long)workspaceSize,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSymmetricContraction", msg);
+        return errorCode;
+    }
+
+    // Without a workspace, the full operands live in a block of the handle's pool
+    auto& pool   = realHandle->getWorkspacePool();
+    auto* pooled = workspace == nullptr ? pool.acquire(symmetricPlan.mWorkspaceSize, stream)
+                                        : nullptr;
+    if(workspace == nullptr && pooled == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_ALLOC_FAILED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to allocate %lu bytes of pooled workspace (%s)",
+                 (unsigned long)symmetricPlan.mWorkspaceSize,
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSymmetricContraction", msg);
+        return errorCode;
+    }
+
+    // Full A, B and D come first, then the dense kernel's workspace
+    std::array<char*, 4> buffers;
+    buffers[0] = (char*)(workspace != nullptr ? workspace : pooled);
+    for(int i = 0; i < 3; i++)
+    {
+        auto const& desc = symmetricPlan.mDescs[i];
+        buffers[i + 1]   = buffers[i]
+                         + hiptensor::ceilDiv(hiptensor::fullElements(symmetricPlan.mShapes[i])
+                                                  * hiptensor::hipDataTypeSize(desc.mType),
+                                              uint64_t(hiptensor::WorkspaceGranularity))
+                               * hiptensor::WorkspaceGranularity;
+    }
+    auto kernelBytes = symmetricPlan.mWorkspaceSize - uint64_t(buffers[3] - buffers[0]);
+
+    auto const& shapes = symmetricPlan.mShapes;
+    auto const& descs  = symmetricPlan.mDescs;
+    auto        status
+        = hiptensor::expandSymmetric(shapes[0], A, buffers[0], descs[0].mType, stream);
+    if(status == HIPTENSOR_STATUS_SUCCESS)
+    {
+        status = hiptensor::expandSymmetric(shapes[1], B, buffers[1], descs[1].mType, stream);
+    }
+    if(status == HIPTENSOR_STATUS_SUCCESS && symmetricPlan.mHasC)
+    {
+        status = hiptensor::expandSymmetric(shapes[2], C, buffers[2], descs[2].mType, stream);
+    }
+    if(status == HIPTENSOR_STATUS_SUCCESS)
+    {
+        status = hiptensorContraction(handle,
+                                      &symmetricPlan.mDensePlan,
+                                      alpha,
+                                      buffers[0],
+                                      buffers[1],
+                                      beta,
+                                      symmetricPlan.mHasC ? buffers[2] : nullptr,
+                                      buffers[2],
+                                      buffers[3],
+                                      kernelBytes,
+                                      stream);
+    }
+    if(status == HIPTENSOR_STATUS_SUCCESS)
+    {
+        status = hiptensor::compressSymmetric(shapes[2], buffers[2], D, descs[2].mType, stream);
+    }
+
+    if(pooled != nullptr)
+    {
+        pool.release(pooled, stream);
+    }
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Symmetric contraction failed (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorSymmetricContraction", msg);
+    }
+    return status;
+}
+
+hiptensorStatus_t hiptensorSymmetricContractionHost(const hiptensorSymmetricPlan_t* plan,
+                                                    const void*                     alpha,
+                                                    const void*                     A,
+                                                    const void*                     B,
+                                                    const void*                     beta,
+                                                    const void*                     C,
+                                                    void*                           D,
+                                                    uint32_t                        numThreads)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "plan=0x%0*llX, A=0x%llX, B=0x%llX, C=0x%llX, D=0x%llX, numThreads=%u",
+             2 * (int)sizeof(void*),
+             (unsigned long long)plan,
+             (unsigned long long)A,
+             (unsigned long long)B,
+             (unsigned long long)C,
+             (unsigned long long)D,
+             numThreads);
+    logger->logAPITrace("hiptensorSymmetricContractionHost", msg);
+
+    if(plan == nullptr || plan->mPlan == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : plan = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSymmetricContractionHost", msg);
+        return errorCode;
+    }
+
+    auto const& symmetricPlan
+        = *static_cast<hiptensor::SymmetricContractionPlan const*>(plan->mPlan);
+    if(alpha == nullptr || A == nullptr || B == nullptr || D == nullptr
+       || (symmetricPlan.mHasC && (beta == nullptr || C == nullptr)))
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Input Parameter Error : alpha/beta/A/B/C/D = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSymmetricContractionHost", msg);
+        return errorCode;
+    }
+
+    auto status
+        = hiptensor::symmetricContractionHost(symmetricPlan, alpha, A, B, beta, C, D, numThreads);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Host symmetric contractions support f32 and f64 operands of one type (%s)",
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorSymmetricContractionHost", msg);
+    }
+    return status;
+}
+
+hiptensorStatus_t hiptensorDestroySymmetricPlan(hiptensorSymmetricPlan_t* plan)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg, sizeof(msg), "plan=0x%0*llX", 2 * (int)sizeof(void*), (unsigned long long)plan);
+    logger->logAPITrace("hiptensorDestroySymmetricPlan", msg);
+
+    if(plan)
+    {
+        delete static_cast<hiptensor::SymmetricContractionPlan*>(plan->mPlan);
+        plan->mPlan = nullptr;
+    }
+    return HIPTENSOR_STATUS_SUCCESS;
+}
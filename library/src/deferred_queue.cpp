@@ -0,0 +1,251 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "data_layout.hpp"
+#include "data_types.hpp"
+#include "deferred_queue.hpp"
+#include "logger.hpp"
+#include "performance.hpp"
+
+namespace hiptensor
+{
+    bool DeferredRange::operator==(DeferredRange const& other) const
+    {
+        return mData == other.mData && mBytes == other.mBytes;
+    }
+
+    bool DeferredRange::operator!=(DeferredRange const& other) const
+    {
+        return !(*this == other);
+    }
+
+    DeferredRange deferredRange(void const* data, hiptensorTensorDescriptor_t const& desc)
+    {
+        auto space = elementSpace(desc.mLengths, desc.mStrides);
+        return {data, std::size_t(saturatingMultiply(space, hipDataTypeSize(desc.mType)))};
+    }
+
+    // Empty ranges touch no memory and overlap nothing
+    static bool overlaps(DeferredRange const& lhs, DeferredRange const& rhs)
+    {
+        auto lhsBegin = reinterpret_cast<std::uintptr_t>(lhs.mData);
+        auto rhsBegin = reinterpret_cast<std::uintptr_t>(rhs.mData);
+        return lhs.mBytes > 0 && rhs.mBytes > 0 && lhsBegin < rhsBegin + rhs.mBytes
+               && rhsBegin < lhsBegin + lhs.mBytes;
+    }
+
+    static bool overlaps(std::vector<DeferredRange> const& lhs,
+                         std::vector<DeferredRange> const& rhs)
+    {
+        return std::any_of(lhs.begin(), lhs.end(), [&rhs](DeferredRange const& range) {
+            return std::any_of(rhs.begin(), rhs.end(), [&range](DeferredRange const& other) {
+                return overlaps(range, other);
+            });
+        });
+    }
+
+    static bool sameLayout(hiptensorTensorDescriptor_t const& lhs,
+                           hiptensorTensorDescriptor_t const& rhs)
+    {
+        return lhs.mType == rhs.mType && lhs.mLengths == rhs.mLengths
+               && lhs.mStrides == rhs.mStrides && layoutOf(lhs) == layoutOf(rhs);
+    }
+
+    // Position of mode in modes, or modes.size() if absent
+    static std::size_t position(std::vector<int32_t> const& modes, int32_t mode)
+    {
+        return std::find(modes.begin(), modes.end(), mode) - modes.begin();
+    }
+
+    bool deferredConflict(DeferredOperation const& lhs, DeferredOperation const& rhs)
+    {
+        return overlaps(lhs.mWrites, rhs.mReads) || overlaps(lhs.mWrites, rhs.mWrites)
+               || overlaps(rhs.mWrites, lhs.mReads);
+    }
+
+    bool deferredCompatible(DeferredOperation const& lhs, DeferredOperation const& rhs)
+    {
+        using Kind = DeferredOperation::Kind;
+        return lhs.mKind == Kind::Contraction && rhs.mKind == Kind::Contraction
+               && lhs.mKernel == rhs.mKernel && lhs.mStream == rhs.mStream
+               && lhs.mFlops < DeferredSmallFlops && rhs.mFlops < DeferredSmallFlops
+               && std::memcmp(lhs.mScalars.data(), rhs.mScalars.data(), lhs.mScalars.size())
+                      == 0;
+    }
+
+    bool deferredNoOp(DeferredOperation const& op)
+    {
+        return op.mKind == DeferredOperation::Kind::Permutation && op.mReads == op.mWrites
+               && sameLayout(op.mTensors[0], op.mTensors[1]) && op.mModes[0] == op.mModes[1]
+               && op.mAlpha == 1.0;
+    }
+
+    bool deferredInverse(DeferredOperation const& first, DeferredOperation const& second)
+    {
+        using Kind = DeferredOperation::Kind;
+        if(first.mKind != Kind::Permutation || second.mKind != Kind::Permutation
+           || first.mReads != second.mWrites || first.mWrites != second.mReads
+           || !sameLayout(first.mTensors[0], second.mTensors[1])
+           || !sameLayout(first.mTensors[1], second.mTensors[0])
+           || first.mAlpha * second.mAlpha != 1.0)
+        {
+            return false;
+        }
+
+        // Element i of the source must return to position i: follow its mode through
+        // the first permutation's destination and back through the second
+        auto const& modes = first.mModes[0];
+        for(std::size_t i = 0; i < modes.size(); i++)
+        {
+            auto inner = position(first.mModes[1], modes[i]);
+            if(inner >= second.mModes[0].size() || inner >= second.mModes[1].size()
+               || position(second.mModes[1], second.mModes[0][inner]) != i)
+            {
+                return false;
+            }
+        }
+        return modes.size() == second.mModes[1].size();
+    }
+
+    DeferredPlan planDeferred(std::vector<DeferredOperation> const& operations)
+    {
+        auto const count = operations.size();
+
+        DeferredPlan plan;
+        plan.mElided.assign(count, false);
+
+        for(std::size_t i = 0; i < count; i++)
+        {
+            auto const& op = operations[i];
+            if(plan.mElided[i] || op.mKind != DeferredOperation::Kind::Permutation)
+            {
+                continue;
+            }
+
+            if(deferredNoOp(op))
+            {
+                plan.mElided[i] = true;
+                continue;
+            }
+
+            // The next write to the source or destination decides: an inverse is
+            // redundant, since the source still holds what it would write back
+            for(std::size_t j = i + 1; j < count; j++)
+            {
+                auto const& next = operations[j];
+                if(plan.mElided[j]
+                   || !(overlaps(next.mWrites, op.mReads) || overlaps(next.mWrites, op.mWrites)))
+                {
+                    continue;
+                }
+
+                plan.mElided[j] = deferredInverse(op, next);
+                break;
+            }
+        }
+
+        // Consecutive compatible contractions that touch disjoint bytes form a group;
+        // elided operations neither join nor break one
+        std::vector<std::size_t> group;
+        for(std::size_t i = 0; i < count; i++)
+        {
+            if(plan.mElided[i])
+            {
+                continue;
+            }
+
+            auto joins = !group.empty() && group.size() < DeferredGroupSize
+                         && deferredCompatible(operations[group.front()], operations[i]);
+            for(auto member : group)
+            {
+                joins = joins && !deferredConflict(operations[member], operations[i]);
+            }
+
+            if(!joins && !group.empty())
+            {
+                plan.mGroups.push_back(std::move(group));
+                group.clear();
+            }
+            group.push_back(i);
+        }
+        if(!group.empty())
+        {
+            plan.mGroups.push_back(std::move(group));
+        }
+
+        return plan;
+    }
+
+    void DeferredQueue::enqueue(DeferredOperation operation)
+    {
+        mOperations.push_back(std::move(operation));
+    }
+
+    std::size_t DeferredQueue::size() const
+    {
+        return mOperations.size();
+    }
+
+    hiptensorStatus_t DeferredQueue::flush()
+    {
+        auto operations = std::move(mOperations);
+        mOperations.clear();
+
+        auto plan   = planDeferred(operations);
+        auto elided = (std::size_t)std::count(plan.mElided.begin(), plan.mElided.end(), true);
+
+        // Every operation that is not elided is its own launch
+        auto& logger = Logger::instance();
+        char  msg[128];
+        snprintf(msg,
+                 sizeof(msg),
+                 "Flushing %zu operation(s): %zu launched in order, %zu elided",
+                 operations.size(),
+                 operations.size() - elided,
+                 elided);
+        logger->logHeuristics("hiptensorFlush", msg);
+
+        for(auto const& group : plan.mGroups)
+        {
+            for(auto index : group)
+            {
+                auto status = operations[index].mLaunch();
+                if(status != HIPTENSOR_STATUS_SUCCESS)
+                {
+                    return status;
+                }
+            }
+        }
+
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+} // namespace hiptensor
@@ -0,0 +1,579 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+
+#include <hip/hip_runtime.h>
+
+#include "config.hpp"
+#include "data_types.hpp"
+#include "degenerate_contraction.hpp"
+#include "util.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        constexpr uint32_t BlockSize = 256u;
+        constexpr uint32_t MaxBlocks = 1u << 16;
+
+        // Reductions split K into slices of at least this many elements, until there
+        // are enough blocks to occupy the device
+        constexpr std::size_t MinSlice     = 4096u;
+        constexpr std::size_t TargetBlocks = 1024u;
+
+        template <typename DataT>
+        using DegenerateComputeT
+            = std::conditional_t<std::is_same_v<DataT, double>, double, float>;
+
+        // Squeezed modes passed to the kernels by value. Output modes are those of D,
+        // M then N; A and B hold the strides of their M or N modes, then their K modes.
+        struct DegenerateShape
+        {
+            uint32_t    mRankM, mRankN, mRankK;
+            std::size_t mLengths[DegenerateMaxRank];
+            std::size_t mLengthsK[DegenerateMaxRank];
+            std::size_t mStridesA[DegenerateMaxRank];
+            std::size_t mStridesB[DegenerateMaxRank];
+            std::size_t mStridesC[DegenerateMaxRank];
+            std::size_t mStridesD[DegenerateMaxRank];
+        };
+
+        struct OutputOffsets
+        {
+            std::size_t mA, mB, mC, mD;
+        };
+
+        // Offsets of the operands at flattened output index x, last mode fastest
+        HIPTENSOR_DEVICE inline OutputOffsets outputOffsets(DegenerateShape const& shape,
+                                                            std::size_t            x)
+        {
+            OutputOffsets offsets = {0, 0, 0, 0};
+            for(auto mode = shape.mRankM + shape.mRankN; mode-- > 0;)
+            {
+                auto index = x % shape.mLengths[mode];
+                x /= shape.mLengths[mode];
+                if(mode < shape.mRankM)
+                {
+                    offsets.mA += index * shape.mStridesA[mode];
+                }
+                else
+                {
+                    offsets.mB += index * shape.mStridesB[mode - shape.mRankM];
+                }
+                offsets.mC += index * shape.mStridesC[mode];
+                offsets.mD += index * shape.mStridesD[mode];
+            }
+            return offsets;
+        }
+
+        // Adds the offsets of flattened K index k to those of an output
+        HIPTENSOR_DEVICE inline void
+            addOffsetsK(DegenerateShape const& shape, std::size_t k, std::size_t& a, std::size_t& b)
+        {
+            for(auto mode = shape.mRankK; mode-- > 0;)
+            {
+                auto index = k % shape.mLengthsK[mode];
+                k /= shape.mLengthsK[mode];
+                a += index * shape.mStridesA[shape.mRankM + mode];
+                b += index * shape.mStridesB[shape.mRankN + mode];
+            }
+        }
+
+        // SCALE and OUTER: one thread per element of D
+        template <typename DataT>
+        HIPTENSOR_KERNEL void outerKernel(DegenerateComputeT<DataT> alpha,
+                                          DegenerateComputeT<DataT> beta,
+                                          DataT const*              A,
+                                          DataT const*              B,
+                                          DataT const*              C,
+                                          DataT*                    D,
+                                          DegenerateShape           shape,
+                                          std::size_t               count)
+        {
+            using ComputeT = DegenerateComputeT<DataT>;
+
+            auto stride = std::size_t(gridDim.x) * blockDim.x;
+            for(auto i = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x; i < count;
+                i += stride)
+            {
+                auto offsets = outputOffsets(shape, i);
+                auto value   = alpha * ComputeT(A[offsets.mA]) * ComputeT(B[offsets.mB]);
+                if(C != nullptr)
+                {
+                    value += beta * ComputeT(C[offsets.mC]);
+                }
+                D[offsets.mD] = DataT(value);
+            }
+        }
+
+        // DOT and GEMV: one block per output and K slice, reducing the slice across the
+        // block. A single slice writes D; several leave partial sums for finishKernel.
+        template <typename DataT>
+        HIPTENSOR_KERNEL void reduceKernel(DegenerateComputeT<DataT>  alpha,
+                                           DegenerateComputeT<DataT>  beta,
+                                           DataT const*               A,
+                                           DataT const*               B,
+                                           DataT const*               C,
+                                           DataT*                     D,
+                                           DegenerateComputeT<DataT>* partials,
+                                           DegenerateShape            shape,
+                                           std::size_t                outputs,
+                                           std::size_t                k,
+                                           std::size_t                slices)
+        {
+            using ComputeT = DegenerateComputeT<DataT>;
+
+            __shared__ ComputeT sums[BlockSize];
+
+            auto sliceLength = (k + slices - 1) / slices;
+            for(auto block = std::size_t(blockIdx.x); block < outputs * slices; block += gridDim.x)
+            {
+                auto offsets = outputOffsets(shape, block / slices);
+                auto first   = (block % slices) * sliceLength;
+                auto last    = std::min(k, first + sliceLength);
+
+                auto sum = ComputeT(0);
+                for(auto l = first + threadIdx.x; l < last; l += BlockSize)
+                {
+                    auto a = offsets.mA;
+                    auto b = offsets.mB;
+                    addOffsetsK(shape, l, a, b);
+                    sum += ComputeT(A[a]) * ComputeT(B[b]);
+                }
+
+                sums[threadIdx.x] = sum;
+                __syncthreads();
+                for(auto width = BlockSize / 2u; width > 0u; width /= 2u)
+                {
+                    if(threadIdx.x < width)
+                    {
+                        sums[threadIdx.x] += sums[threadIdx.x + width];
+                    }
+                    __syncthreads();
+                }
+
+                if(threadIdx.x == 0 && slices > 1)
+                {
+                    partials[block] = sums[0];
+                }
+                else if(threadIdx.x == 0)
+                {
+                    auto value = alpha * sums[0];
+                    if(C != nullptr)
+                    {
+                        value += beta * ComputeT(C[offsets.mC]);
+                    }
+                    D[offsets.mD] = DataT(value);
+                }
+                __syncthreads();
+            }
+        }
+
+        // GEMV whose matrix is contiguous along the outputs: one thread per output walks
+        // all of K, so that neighbouring threads read neighbouring elements
+        template <typename DataT>
+        HIPTENSOR_KERNEL void columnKernel(DegenerateComputeT<DataT> alpha,
+                                           DegenerateComputeT<DataT> beta,
+                                           DataT const*              A,
+                                           DataT const*              B,
+                                           DataT const*              C,
+                                           DataT*                    D,
+                                           DegenerateShape           shape,
+                                           std::size_t               outputs,
+                                           std::size_t               k)
+        {
+            using ComputeT = DegenerateComputeT<DataT>;
+
+            auto stride = std::size_t(gridDim.x) * blockDim.x;
+            for(auto x = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x; x < outputs;
+                x += stride)
+            {
+                auto offsets = outputOffsets(shape, x);
+                auto sum     = ComputeT(0);
+                for(std::size_t l = 0; l < k; l++)
+                {
+                    auto a = offsets.mA;
+                    auto b = offsets.mB;
+                    addOffsetsK(shape, l, a, b);
+                    sum += ComputeT(A[a]) * ComputeT(B[b]);
+                }
+
+                auto value = alpha * sum;
+                if(C != nullptr)
+                {
+                    value += beta * ComputeT(C[offsets.mC]);
+                }
+                D[offsets.mD] = DataT(value);
+            }
+        }
+
+        // Sums the partial sums of the K slices of each output into D
+        template <typename DataT>
+        HIPTENSOR_KERNEL void finishKernel(DegenerateComputeT<DataT>        alpha,
+                                           DegenerateComputeT<DataT>        beta,
+                                           DataT const*                     C,
+                                           DataT*                           D,
+                                           DegenerateComputeT<DataT> const* partials,
+                                           DegenerateShape                  shape,
+                                           std::size_t                      outputs,
+                                           std::size_t                      slices)
+        {
+            using ComputeT = DegenerateComputeT<DataT>;
+
+            auto stride = std::size_t(gridDim.x) * blockDim.x;
+            for(auto x = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x; x < outputs;
+                x += stride)
+            {
+                auto sum = ComputeT(0);
+                for(std::size_t s = 0; s < slices; s++)
+                {
+                    sum += partials[x * slices + s];
+                }
+
+                auto offsets = outputOffsets(shape, x);
+                auto value   = alpha * sum;
+                if(C != nullptr)
+                {
+                    value += beta * ComputeT(C[offsets.mC]);
+                }
+                D[offsets.mD] = DataT(value);
+            }
+        }
+
+        // Outputs of a contraction and the number of K slices worth reducing them in
+        std::pair<std::size_t, std::size_t> reductionSlices(SqueezedContraction const& contraction)
+        {
+            auto outputs = contraction.mM * contraction.mN;
+            auto slices  = std::min(ceilDiv(contraction.mK, MinSlice),
+                                   ceilDiv(TargetBlocks, std::max<std::size_t>(outputs, 1u)));
+            return {outputs, std::max<std::size_t>(slices, 1u)};
+        }
+
+        uint32_t gridFor(std::size_t count, uint32_t blockSize)
+        {
+            auto blocks = ceilDiv(count, std::size_t(blockSize));
+            return uint32_t(std::min<std::size_t>(blocks, MaxBlocks));
+        }
+
+        template <typename DataT>
+        hiptensorStatus_t launchDegenerate(SqueezedContraction const& contraction,
+                                           DegenerateShape const&     shape,
+                                           void const*                alpha,
+                                           void const*                A,
+                                           void const*                B,
+                                           void const*                beta,
+                                           void const*                C,
+                                           void*                      D,
+                                           void*                      workspace,
+                                           std::size_t                workspaceSize,
+                                           hipStream_t                stream)
+        {
+            using ComputeT = DegenerateComputeT<DataT>;
+
+            auto a = ComputeT(*static_cast<DataT const*>(alpha));
+            auto b = beta != nullptr ? ComputeT(*static_cast<DataT const*>(beta)) : ComputeT(0);
+
+            // A zero beta does not read C
+            auto* c = b != ComputeT(0) ? static_cast<DataT const*>(C) : nullptr;
+            auto* x = static_cast<DataT const*>(A);
+            auto* y = static_cast<DataT const*>(B);
+            auto* d = static_cast<DataT*>(D);
+
+            if(contraction.mShape == ContractionShape::SCALE
+               || contraction.mShape == ContractionShape::OUTER)
+            {
+                auto count = contraction.mM * contraction.mN;
+                hipLaunchKernelGGL((outerKernel<DataT>),
+                                   dim3(gridFor(count, BlockSize)),
+                                   dim3(BlockSize),
+                                   0,
+                                   stream,
+                                   a,
+                                   b,
+                                   x,
+                                   y,
+                                   c,
+                                   d,
+                                   shape,
+                                   count);
+                return hipGetLastError() == hipSuccess ? HIPTENSOR_STATUS_SUCCESS
+                                                       : HIPTENSOR_STATUS_HIP_ERROR;
+            }
+
+            auto [outputs, slices] = reductionSlices(contraction);
+
+            // The matrix of a GEMV is A without N modes and B without M modes
+            auto rankOut = shape.mRankM + shape.mRankN;
+            auto innerStride
+                = rankOut == 0 ? std::size_t{0}
+                  : shape.mRankM > 0 ? shape.mStridesA[shape.mRankM - 1]
+                                     : shape.mStridesB[shape.mRankN - 1];
+            if(innerStride == 1 && outputs >= TargetBlocks * BlockSize)
+            {
+                hipLaunchKernelGGL((columnKernel<DataT>),
+                                   dim3(gridFor(outputs, BlockSize)),
+                                   dim3(BlockSize),
+                                   0,
+                                   stream,
+                                   a,
+                                   b,
+                                   x,
+                                   y,
+                                   c,
+                                   d,
+                                   shape,
+                                   outputs,
+                                   contraction.mK);
+                return hipGetLastError() == hipSuccess ? HIPTENSOR_STATUS_SUCCESS
+                                                       : HIPTENSOR_STATUS_HIP_ERROR;
+            }
+
+            // Partial sums of the slices take the workspace; with too little, fewer slices
+            auto available = workspace != nullptr ? workspaceSize / (outputs * sizeof(ComputeT))
+                                                  : std::size_t{0};
+            slices         = std::max<std::size_t>(std::min(slices, available), 1u);
+
+            auto* partials = static_cast<ComputeT*>(workspace);
+            hipLaunchKernelGGL((reduceKernel<DataT>),
+                               dim3(uint32_t(std::min<std::size_t>(outputs * slices, MaxBlocks))),
+                               dim3(BlockSize),
+                               0,
+                               stream,
+                               a,
+                               b,
+                               x,
+                               y,
+                               c,
+                               d,
+                               partials,
+                               shape,
+                               outputs,
+                               contraction.mK,
+                               slices);
+            if(slices > 1)
+            {
+                hipLaunchKernelGGL((finishKernel<DataT>),
+                                   dim3(gridFor(outputs, BlockSize)),
+                                   dim3(BlockSize),
+                                   0,
+                                   stream,
+                                   a,
+                                   b,
+                                   c,
+                                   d,
+                                   partials,
+                                   shape,
+                                   outputs,
+                                   slices);
+            }
+            return hipGetLastError() == hipSuccess ? HIPTENSOR_STATUS_SUCCESS
+                                                   : HIPTENSOR_STATUS_HIP_ERROR;
+        }
+    }
+
+    SqueezedContraction squeezeContraction(std::array<hipDataType, 4> const&          types,
+                                           std::array<hiptensorDimVector_t, 4> const& lengths,
+                                           std::array<hiptensorDimVector_t, 4> const& strides,
+                                           std::size_t                                rankM,
+                                           std::size_t                                rankN)
+    {
+        SqueezedContraction result = {};
+        result.mShape              = ContractionShape::GENERAL;
+        result.mType               = types[3];
+        result.mHasC               = types[2] != NONE_TYPE;
+        result.mM = result.mN = result.mK = 1;
+
+        // Only f32 and f64 have contraction instances to fall back on
+        auto supported = types[3] == HIP_R_32F || types[3] == HIP_R_64F;
+        if(!supported || types[0] != types[3] || types[1] != types[3]
+           || (result.mHasC && types[2] != types[3]))
+        {
+            return result;
+        }
+
+        auto rankA = lengths[0].size();
+        auto rankB = lengths[1].size();
+        auto rankD = lengths[3].size();
+        if(rankA > DegenerateMaxRank || rankB > DegenerateMaxRank || rankD > DegenerateMaxRank
+           || rankM > rankA || rankN > rankB || rankM + rankN != rankD
+           || rankA - rankM != rankB - rankN)
+        {
+            return result;
+        }
+
+        // Length-1 modes are dropped from every operand that has them. C shares the
+        // lengths of D, and its strides are zero when it is not an operand.
+        auto keep = [&](int i, std::size_t mode, std::size_t length) {
+            result.mLengths[i].push_back(length);
+            result.mStrides[i].push_back(strides[i][mode]);
+        };
+
+        auto empty = false;
+        for(std::size_t m = 0; m < rankM; m++)
+        {
+            auto length = lengths[0][m];
+            if(length != 1)
+            {
+                keep(0, m, length);
+                keep(2, m, length);
+                keep(3, m, length);
+                result.mRankM++;
+            }
+            empty |= length == 0;
+            result.mM *= length;
+        }
+        for(std::size_t n = 0; n < rankN; n++)
+        {
+            auto length = lengths[1][n];
+            if(length != 1)
+            {
+                keep(1, n, length);
+                keep(2, rankM + n, length);
+                keep(3, rankM + n, length);
+                result.mRankN++;
+            }
+            empty |= length == 0;
+            result.mN *= length;
+        }
+        for(std::size_t k = 0; k < rankA - rankM; k++)
+        {
+            auto length = lengths[0][rankM + k];
+            if(length != 1)
+            {
+                keep(0, rankM + k, length);
+                keep(1, rankN + k, length);
+                result.mRankK++;
+            }
+            empty |= length == 0;
+            result.mK *= length;
+        }
+
+        if(empty)
+        {
+            return result;
+        }
+
+        if(result.mRankK == 0)
+        {
+            result.mShape = result.mRankM == 0 || result.mRankN == 0 ? ContractionShape::SCALE
+                                                                     : ContractionShape::OUTER;
+        }
+        else if(result.mRankM == 0 && result.mRankN == 0)
+        {
+            result.mShape = ContractionShape::DOT;
+        }
+        else if(result.mRankM == 0 || result.mRankN == 0)
+        {
+            result.mShape = ContractionShape::GEMV;
+        }
+        return result;
+    }
+
+    char const* contractionShapeName(ContractionShape shape)
+    {
+        switch(shape)
+        {
+        case ContractionShape::SCALE:
+            return "scale";
+        case ContractionShape::OUTER:
+            return "outer product";
+        case ContractionShape::DOT:
+            return "dot product";
+        case ContractionShape::GEMV:
+            return "matrix-vector product";
+        default:
+            return "general";
+        }
+    }
+
+    std::size_t degenerateWorkspaceSize(SqueezedContraction const& contraction)
+    {
+        if(contraction.mShape != ContractionShape::DOT
+           && contraction.mShape != ContractionShape::GEMV)
+        {
+            return 0u;
+        }
+
+        auto [outputs, slices] = reductionSlices(contraction);
+        auto computeBytes      = contraction.mType == HIP_R_64F ? sizeof(double) : sizeof(float);
+        return slices > 1 ? outputs * slices * computeBytes : 0u;
+    }
+
+    hiptensorStatus_t degenerateContraction(SqueezedContraction const& contraction,
+                                            void const*                alpha,
+                                            void const*                A,
+                                            void const*                B,
+                                            void const*                beta,
+                                            void const*                C,
+                                            void*                      D,
+                                            void*                      workspace,
+                                            std::size_t                workspaceSize,
+                                            hipStream_t                stream)
+    {
+        if(contraction.mShape == ContractionShape::GENERAL)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        DegenerateShape shape = {};
+        shape.mRankM          = uint32_t(contraction.mRankM);
+        shape.mRankN          = uint32_t(contraction.mRankN);
+        shape.mRankK          = uint32_t(contraction.mRankK);
+        for(std::size_t i = 0; i < contraction.mLengths[3].size(); i++)
+        {
+            shape.mLengths[i]  = contraction.mLengths[3][i];
+            shape.mStridesC[i] = contraction.mStrides[2][i];
+            shape.mStridesD[i] = contraction.mStrides[3][i];
+        }
+        for(std::size_t i = 0; i < contraction.mLengths[0].size(); i++)
+        {
+            shape.mStridesA[i] = contraction.mStrides[0][i];
+        }
+        for(std::size_t i = 0; i < contraction.mLengths[1].size(); i++)
+        {
+            shape.mStridesB[i] = contraction.mStrides[1][i];
+        }
+        for(std::size_t i = 0; i < contraction.mRankK; i++)
+        {
+            shape.mLengthsK[i] = contraction.mLengths[0][contraction.mRankM + i];
+        }
+
+        auto* c = contraction.mHasC ? C : nullptr;
+        if(contraction.mType == HIP_R_32F)
+        {
+            return launchDegenerate<float>(
+                contraction, shape, alpha, A, B, beta, c, D, workspace, workspaceSize, stream);
+        }
+        else if(contraction.mType == HIP_R_64F)
+        {
+            return launchDegenerate<double>(
+                contraction, shape, alpha, A, B, beta, c, D, workspace, workspaceSize, stream);
+        }
+        return HIPTENSOR_STATUS_NOT_SUPPORTED;
+    }
+
+} // namespace hiptensor
@@ -0,0 +1,792 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#include "data_types.hpp"
+#include "descriptor_cache.hpp"
+#include "util.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        // Staged copies keep the alignment of the workspace allocation
+        constexpr std::size_t StagingAlignment = 256u;
+
+        // Records of every cache draw from one sequence, so that a descriptor bound to an
+        // evicted record never validates against a new one at the same address
+        std::atomic<uint64_t> nextGeneration{1};
+
+        template <typename T>
+        inline void hashCombine(std::size_t& seed, T const& value)
+        {
+            seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed * 64) + (seed / 4);
+        }
+
+        std::size_t hashTensor(hipDataType                 type,
+                               hiptensorDimVector_t const& lengths,
+                               hiptensorDimVector_t const& strides)
+        {
+            std::size_t seed = 0;
+            hashCombine(seed, static_cast<int32_t>(type));
+            hashCombine(seed, lengths.size());
+            for(auto length : lengths)
+            {
+                hashCombine(seed, length);
+            }
+            for(auto stride : strides)
+            {
+                hashCombine(seed, stride);
+            }
+            return seed;
+        }
+
+        std::size_t hashContraction(std::array<TensorSignature const*, 4> const& tensors,
+                                    int32_t                                      contractionOpId,
+                                    hiptensorComputeType_t                       computeType,
+                                    std::array<uint32_t, 4> const&               alignmentReq,
+                                    uint32_t                                     outputs)
+        {
+            std::size_t seed = 0;
+            for(auto* tensor : tensors)
+            {
+                hashCombine(seed, tensor->mHash);
+            }
+            hashCombine(seed, contractionOpId);
+            hashCombine(seed, static_cast<int32_t>(computeType));
+            for(auto alignment : alignmentReq)
+            {
+                hashCombine(seed, alignment);
+            }
+            hashCombine(seed, outputs);
+            return seed;
+        }
+
+        // Outermost M and N mode of operand i, or NoMode if it has none.
+        // Modes are ordered A = [M, K], B = [N, K] and C, D = [M, N].
+        constexpr std::size_t NoMode = ~std::size_t{0};
+
+        std::array<std::size_t, 2> outerModes(int i, std::size_t rankM, std::size_t rankN)
+        {
+            auto modeM = rankM > 0 ? std::size_t{0} : NoMode;
+            auto modeN = rankN > 0 ? (i == 1 ? std::size_t{0} : rankM) : NoMode;
+            return {i == 1 ? NoMode : modeM, i == 0 ? NoMode : modeN};
+        }
+
+        // Largest extent in [1, limit] accepted by a monotone predicate, 0 if there is none
+        template <typename Pred>
+        std::size_t largestExtent(std::size_t limit, Pred&& accepts)
+        {
+            std::size_t lo = 0, hi = limit;
+            while(lo < hi)
+            {
+                auto mid = lo + (hi - lo + 1) / 2;
+                if(accepts(mid))
+                {
+                    lo = mid;
+                }
+                else
+                {
+                    hi = mid - 1;
+                }
+            }
+            return lo;
+        }
+    }
+
+    std::array<std::size_t, 4> ContractionSignature::partitionBounds(std::size_t index) const
+    {
+        if(mPartitions <= 1)
+        {
+            return {0, mOuterM, 0, mOuterN};
+        }
+
+        auto gridN  = ceilDiv(mOuterN, mPartitionN);
+        auto startM = (index / gridN) * mPartitionM;
+        auto startN = (index % gridN) * mPartitionN;
+        return {startM,
+                std::min(mPartitionM, mOuterM - startM),
+                startN,
+                std::min(mPartitionN, mOuterN - startN)};
+    }
+
+    std::array<hiptensorDimVector_t, 4>
+        ContractionSignature::partitionLengths(std::size_t extentM, std::size_t extentN) const
+    {
+        std::array<hiptensorDimVector_t, 4> lengths;
+        for(int i = 0; i < lengths.size(); i++)
+        {
+            lengths[i] = mTensors[i]->mLengths;
+
+            auto modes = outerModes(i, mRankM, mRankN);
+            if(modes[0] < lengths[i].size())
+            {
+                lengths[i][modes[0]] = extentM;
+            }
+            if(modes[1] < lengths[i].size())
+            {
+                lengths[i][modes[1]] = extentN;
+            }
+        }
+        return lengths;
+    }
+
+    std::array<std::size_t, 4> ContractionSignature::partitionOffsets(std::size_t startM,
+                                                                      std::size_t startN) const
+    {
+        std::array<std::size_t, 4> offsets;
+        for(int i = 0; i < offsets.size(); i++)
+        {
+            auto const& strides = mKernelStrides[i];
+            auto        modes   = outerModes(i, mRankM, mRankN);
+
+            offsets[i] = 0;
+            if(modes[0] < strides.size())
+            {
+                offsets[i] += startM * strides[modes[0]];
+            }
+            if(modes[1] < strides.size())
+            {
+                offsets[i] += startN * strides[modes[1]];
+            }
+        }
+        return offsets;
+    }
+
+    bool ContractionSignature::concatenatedInPlace(int i, void const* const operands[]) const
+    {
+        auto* tensor = mOutputTensors[i];
+        if(mOutputs <= 1 || i == 0 || mOutputOffsets[i] == 0 || operands == nullptr
+           || operands[0] == nullptr || tensor->mStrides != mKernelStrides[i])
+        {
+            return false;
+        }
+
+        auto stride = mOutputOffsets[i] * hipDataTypeSize(tensor->mType);
+        for(uint32_t g = 1; g < mOutputs; g++)
+        {
+            if((char const*)operands[g] != (char const*)operands[0] + g * stride)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool TensorSignature::matches(hiptensorTensorDescriptor_t const& desc) const
+    {
+        return mType == desc.mType && mLengths == desc.mLengths && mStrides == desc.mStrides;
+    }
+
+    bool ContractionSignature::matches(hiptensorContractionDescriptor_t const& desc) const
+    {
+        if(mContractionOpId != desc.mContractionOpId || mComputeType != desc.mComputeType
+           || mAlignmentReq != desc.mAlignmentReq || mOutputs != std::max(desc.mOutputs, 1u))
+        {
+            return false;
+        }
+        for(int i = 0; i < mOutputTensors.size(); i++)
+        {
+            if(!mOutputTensors[i]->matches(desc.mTensorDesc[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    DescriptorCache::DescriptorCache(std::size_t capacity)
+        : mCapacity(std::max(capacity, std::size_t{1}))
+    {
+    }
+
+    void DescriptorCache::unlink(LruLink* link)
+    {
+        link->mPrev->mNext = link->mNext;
+        link->mNext->mPrev = link->mPrev;
+        link->mPrev        = link;
+        link->mNext        = link;
+    }
+
+    void DescriptorCache::pushFront(LruLink& list, LruLink* link)
+    {
+        unlink(link);
+        link->mPrev       = &list;
+        link->mNext       = list.mNext;
+        list.mNext->mPrev = link;
+        list.mNext        = link;
+    }
+
+    void DescriptorCache::touch(void const* record)
+    {
+        // Tensors used by cached contractions are off the list until released
+        auto& entry = mOwned.at(record);
+        if(entry.mContraction)
+        {
+            pushFront(mContractionLru, &entry);
+        }
+        else if(entry.mPins == 0)
+        {
+            pushFront(mTensorLru, &entry);
+        }
+    }
+
+    DescriptorCache::Record const* DescriptorCache::bound(void const* signature,
+                                                          uint64_t    generation) const
+    {
+        // Only a pointer still cached is dereferenced
+        auto it = mOwned.find(signature);
+        if(it == mOwned.end())
+        {
+            return nullptr;
+        }
+
+        auto current = it->second.mContraction
+                           ? static_cast<ContractionSignature const*>(signature)->mGeneration
+                           : static_cast<TensorSignature const*>(signature)->mGeneration;
+        return current == generation ? &it->second : nullptr;
+    }
+
+    void DescriptorCache::erasePlan(Plan* plan)
+    {
+        auto& siblings                 = plan->mOwner->mPlans;
+        siblings[plan->mIndex]         = siblings.back();
+        siblings[plan->mIndex]->mIndex = plan->mIndex;
+        siblings.pop_back();
+
+        unlink(plan);
+        mPlans.erase(mPlans.find(*plan->mKey));
+    }
+
+    void DescriptorCache::eraseRecord(Record* record)
+    {
+        auto* key   = record->mRecord.get();
+        auto  erase = [&](auto& table) {
+            auto range = table.equal_range(record->mHash);
+            for(auto it = range.first; it != range.second; it++)
+            {
+                if(it->second == key)
+                {
+                    table.erase(it);
+                    return;
+                }
+            }
+        };
+        if(record->mContraction)
+        {
+            erase(mContractions);
+        }
+        else
+        {
+            erase(mTensors);
+        }
+
+        // Evicted contractions drop their plans, whose keys would otherwise match a new
+        // record at a reused address, and release their operands
+        if(record->mContraction)
+        {
+            for(auto* plan : record->mPlans)
+            {
+                unlink(plan);
+                mPlans.erase(mPlans.find(*plan->mKey));
+            }
+            for(auto const& tensor : static_cast<ContractionSignature const*>(key)->mTensorRefs)
+            {
+                auto& entry = mOwned.at(tensor.get());
+                if(--entry.mPins == 0)
+                {
+                    pushFront(mTensorLru, &entry);
+                }
+            }
+        }
+
+        unlink(record);
+        mOwned.erase(key);
+    }
+
+    void DescriptorCache::evict()
+    {
+        // Each pass removes the tail of a list. Contractions go first, as they hold
+        // tensors in place.
+        while(mContractions.size() > mCapacity)
+        {
+            eraseRecord(static_cast<Record*>(mContractionLru.mPrev));
+        }
+        while(mTensors.size() > mCapacity && mTensorLru.mPrev != &mTensorLru)
+        {
+            eraseRecord(static_cast<Record*>(mTensorLru.mPrev));
+        }
+        while(mPlans.size() > mCapacity)
+        {
+            erasePlan(static_cast<Plan*>(mPlanLru.mPrev));
+        }
+    }
+
+    TensorSignature const* DescriptorCache::cachedTensor(hiptensorTensorDescriptor_t const& desc)
+    {
+        if(bound(desc.mSignature, desc.mGeneration) != nullptr)
+        {
+            touch(desc.mSignature);
+            return static_cast<TensorSignature const*>(desc.mSignature);
+        }
+        return internTensor(desc);
+    }
+
+    TensorSignature const* DescriptorCache::internTensor(hiptensorTensorDescriptor_t const& desc)
+    {
+        auto hash  = hashTensor(desc.mType, desc.mLengths, desc.mStrides);
+        auto range = mTensors.equal_range(hash);
+        for(auto it = range.first; it != range.second; it++)
+        {
+            if(it->second->matches(desc))
+            {
+                touch(it->second);
+                return it->second;
+            }
+        }
+
+        auto record           = std::make_shared<TensorSignature>();
+        record->mType         = desc.mType;
+        record->mLengths      = desc.mLengths;
+        record->mStrides      = desc.mStrides;
+        record->mHash         = hash;
+        record->mElements     = desc.mLengths.empty() ? 0 : elementCount(desc.mLengths);
+        record->mElementSpace = 0;
+        if(!desc.mLengths.empty())
+        {
+            record->mElementSpace = elementSpace(desc.mLengths, desc.mStrides);
+        }
+        record->mBytes = saturatingMultiply(record->mElementSpace, hipDataTypeSize(desc.mType));
+
+        record->mBroadcast = false;
+        for(int i = 0; i < desc.mLengths.size(); i++)
+        {
+            record->mBroadcast |= desc.mLengths[i] > 1 && desc.mStrides[i] == 0;
+        }
+        record->mGeneration = nextGeneration++;
+
+        auto* result  = record.get();
+        auto& entry   = mOwned[result];
+        entry.mRecord = std::move(record);
+        entry.mHash   = hash;
+        pushFront(mTensorLru, &entry);
+        mTensors.emplace(hash, result);
+        return result;
+    }
+
+    TensorSignature const* DescriptorCache::intern(hiptensorTensorDescriptor_t const& desc)
+    {
+        std::scoped_lock lock(mMutex);
+        auto*            result = internTensor(desc);
+        evict();
+        return result;
+    }
+
+    ContractionSignature const*
+        DescriptorCache::intern(hiptensorContractionDescriptor_t const& desc)
+    {
+        std::scoped_lock lock(mMutex);
+
+        std::array<TensorSignature const*, 4> tensors;
+        for(int i = 0; i < tensors.size(); i++)
+        {
+            tensors[i] = cachedTensor(desc.mTensorDesc[i]);
+        }
+
+        auto outputs = std::max(desc.mOutputs, 1u);
+        auto hash    = hashContraction(
+            tensors, desc.mContractionOpId, desc.mComputeType, desc.mAlignmentReq, outputs);
+        auto range   = mContractions.equal_range(hash);
+        for(auto it = range.first; it != range.second; it++)
+        {
+            auto& record = *it->second;
+            if(record.mOutputTensors == tensors && record.mContractionOpId == desc.mContractionOpId
+               && record.mComputeType == desc.mComputeType
+               && record.mAlignmentReq == desc.mAlignmentReq && record.mOutputs == outputs)
+            {
+                touch(&record);
+                return &record;
+            }
+        }
+
+        auto record              = std::make_shared<ContractionSignature>();
+        record->mOutputTensors   = tensors;
+        record->mContractionOpId = desc.mContractionOpId;
+        record->mComputeType     = desc.mComputeType;
+        record->mAlignmentReq    = desc.mAlignmentReq;
+        record->mHash            = hash;
+        record->mOutputs         = outputs;
+        record->mOutputOffsets   = {0, 0, 0, 0};
+        record->mGeneration      = nextGeneration++;
+
+        // Modes are ordered A = [M, K], B = [N, K] and D = [M, N]
+        auto rankA = tensors[0]->mLengths.size();
+        auto rankB = tensors[1]->mLengths.size();
+        auto rankK = (rankA + rankB - tensors[3]->mLengths.size()) / 2;
+        auto rankM = rankA - std::min(rankK, rankA);
+        auto rankN = rankB - std::min(rankK, rankB);
+
+        // Outputs are concatenated along the outermost N mode into packed kernel views
+        if(outputs > 1 && rankN > 0)
+        {
+            for(int i = 1; i < tensors.size(); i++)
+            {
+                if(tensors[i]->mType == NONE_TYPE)
+                {
+                    continue;
+                }
+
+                auto mode           = i == 1 ? std::size_t{0} : rankM;
+                auto view           = hiptensorTensorDescriptor_t{};
+                view.mType          = tensors[i]->mType;
+                view.mLengths       = tensors[i]->mLengths;
+                view.mLengths[mode] = view.mLengths[mode] * outputs;
+                view.mStrides       = stridesFromLengths(view.mLengths);
+
+                record->mOutputOffsets[i] = tensors[i]->mLengths[mode] * view.mStrides[mode];
+                tensors[i]                = internTensor(view);
+            }
+        }
+        record->mTensors = tensors;
+
+        auto const& lengthsA = tensors[0]->mLengths;
+        auto const& lengthsB = tensors[1]->mLengths;
+        auto const& lengthsD = tensors[3]->mLengths;
+
+        std::array<hipDataType, 4>          types;
+        std::array<hiptensorDimVector_t, 4> lengths, strides;
+        for(int i = 0; i < tensors.size(); i++)
+        {
+            types[i]   = tensors[i]->mType;
+            lengths[i] = tensors[i]->mLengths;
+            strides[i] = tensors[i]->mStrides;
+        }
+        record->mMetrics = contractionMetrics(types, lengths, strides, rankM, rankN);
+        record->mM       = record->mMetrics.mM;
+        record->mN       = record->mMetrics.mN;
+        record->mK       = record->mMetrics.mK;
+        record->mFlops   = record->mMetrics.mFlops;
+        record->mBytes   = record->mMetrics.mBytes;
+
+        // Innermost modes that kernels may vectorize: M or K for A, N or K for B,
+        // and N for C and D.
+        std::array<std::array<std::size_t, 2>, 4> innerModes
+            = {{{rankM - 1, lengthsA.size() - 1},
+                {rankN - 1, lengthsB.size() - 1},
+                {lengthsD.size() - 1, lengthsD.size() - 1},
+                {lengthsD.size() - 1, lengthsD.size() - 1}}};
+
+        record->mStagingBytes = 0;
+        for(int i = 0; i < tensors.size(); i++)
+        {
+            auto* tensor               = tensors[i];
+            record->mStaged[i]         = false;
+            record->mKernelStrides[i]  = tensor->mStrides;
+            record->mStagingOffsets[i] = 0;
+
+            if(tensor->mType == NONE_TYPE || tensor->mElements <= 1)
+            {
+                continue;
+            }
+
+            auto const& strides = tensor->mStrides;
+            auto        direct  = false;
+            for(auto mode : innerModes[i])
+            {
+                direct |= mode < strides.size() && strides[mode] == 1;
+            }
+
+            // Concatenated outputs only exist as staged copies
+            if(!direct || (record->mOutputs > 1 && i > 0))
+            {
+                record->mStaged[i]         = true;
+                record->mKernelStrides[i]  = stridesFromLengths(tensor->mLengths);
+                record->mStagingOffsets[i] = record->mStagingBytes;
+                record->mStagingBytes
+                    += ceilDiv(tensor->mElements * hipDataTypeSize(tensor->mType), StagingAlignment)
+                       * StagingAlignment;
+            }
+        }
+
+        // Widths are in elements, starting from the widest access to the smallest type
+        auto minElementBytes = MaxVectorBytes;
+        for(auto* tensor : tensors)
+        {
+            if(tensor->mType != NONE_TYPE)
+            {
+                minElementBytes = std::min(minElementBytes, hipDataTypeSize(tensor->mType));
+            }
+        }
+        record->mVectorWidth = std::max(MaxVectorBytes / std::max(minElementBytes, 1u), 1u);
+        for(int i = 0; i < tensors.size(); i++)
+        {
+            auto* tensor = tensors[i];
+            if(tensor->mType == NONE_TYPE)
+            {
+                continue;
+            }
+
+            // Staged copies are aligned for any vector width. An alignment of 0 defers to
+            // the pointer's own, which is checked against the kernel's access at launch.
+            auto alignment    = record->mStaged[i] || desc.mAlignmentReq[i] == 0
+                                    ? MaxVectorBytes
+                                    : desc.mAlignmentReq[i];
+            auto elementBytes = hipDataTypeSize(tensor->mType);
+            auto width        = maxVectorWidth(tensor->mLengths,
+                                               record->mKernelStrides[i],
+                                               alignment,
+                                               elementBytes,
+                                               std::max(MaxVectorBytes / elementBytes, 1u));
+            record->mVectorWidth = std::min(record->mVectorWidth, width);
+        }
+
+        record->mSqueezed = {};
+        if(outputs == 1)
+        {
+            std::array<hipDataType, 4>          types;
+            std::array<hiptensorDimVector_t, 4> lengths, strides;
+            for(int i = 0; i < tensors.size(); i++)
+            {
+                types[i]   = tensors[i]->mType;
+                lengths[i] = tensors[i]->mLengths;
+                strides[i] = tensors[i]->mStrides;
+            }
+            record->mSqueezed = squeezeContraction(types, lengths, strides, rankM, rankN);
+        }
+
+        record->mRankM  = rankM;
+        record->mRankN  = rankN;
+        record->mOuterM = rankM > 0 && !lengthsD.empty() ? lengthsD[0] : 1;
+        record->mOuterN = rankN > 0 && rankM < lengthsD.size() ? lengthsD[rankM] : 1;
+
+        auto fits = [&](std::size_t extentM, std::size_t extentN) {
+            auto lengths = record->partitionLengths(extentM, extentN);
+            for(int i = 0; i < tensors.size(); i++)
+            {
+                auto type = tensors[i]->mType;
+                if(type != NONE_TYPE && !lengths[i].empty()
+                   && !fitsKernelIndexing(
+                       lengths[i], record->mKernelStrides[i], hipDataTypeSize(type)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        if(record->mOuterM == 0 || record->mOuterN == 0 || fits(record->mOuterM, record->mOuterN))
+        {
+            record->mPartitionM = record->mOuterM;
+            record->mPartitionN = record->mOuterN;
+            record->mPartitions = 1;
+        }
+        else
+        {
+            // Keep N partitions as wide as possible, then fill them with M
+            record->mPartitionN = largestExtent(
+                record->mOuterN, [&](std::size_t extent) { return fits(1, extent); });
+            record->mPartitionM = largestExtent(record->mOuterM, [&](std::size_t extent) {
+                return record->mPartitionN > 0 && fits(extent, record->mPartitionN);
+            });
+
+            record->mPartitions = 0;
+            if(record->mPartitionM > 0 && record->mPartitionN > 0)
+            {
+                record->mPartitions = ceilDiv(record->mOuterM, record->mPartitionM)
+                                      * ceilDiv(record->mOuterN, record->mPartitionN);
+            }
+        }
+
+        // Operands of the record, and the concatenated views of multi-output ones, live
+        // as long as it does and stay cached while it is
+        for(auto const& operands : {record->mOutputTensors, record->mTensors})
+        {
+            for(auto* tensor : operands)
+            {
+                auto& operand = mOwned.at(tensor);
+                record->mTensorRefs.push_back(
+                    std::static_pointer_cast<TensorSignature const>(operand.mRecord));
+                if(operand.mPins++ == 0)
+                {
+                    unlink(&operand);
+                }
+            }
+        }
+
+        auto* result       = record.get();
+        auto& entry        = mOwned[result];
+        entry.mRecord      = std::move(record);
+        entry.mHash        = hash;
+        entry.mContraction = true;
+        pushFront(mContractionLru, &entry);
+        mContractions.emplace(hash, result);
+        evict();
+        return result;
+    }
+
+    TensorSignature const* DescriptorCache::signature(hiptensorTensorDescriptor_t const& desc)
+    {
+        {
+            std::scoped_lock lock(mMutex);
+            if(bound(desc.mSignature, desc.mGeneration) != nullptr)
+            {
+                touch(desc.mSignature);
+                return static_cast<TensorSignature const*>(desc.mSignature);
+            }
+        }
+        return intern(desc);
+    }
+
+    ContractionSignature const*
+        DescriptorCache::signature(hiptensorContractionDescriptor_t const& desc)
+    {
+        {
+            // An evicted record's address may be reused by another, which then has a
+            // different generation
+            std::scoped_lock lock(mMutex);
+            if(bound(desc.mSignature, desc.mGeneration) != nullptr)
+            {
+                touch(desc.mSignature);
+                return static_cast<ContractionSignature const*>(desc.mSignature);
+            }
+        }
+        return intern(desc);
+    }
+
+    void DescriptorCache::bind(hiptensorTensorDescriptor_t& desc)
+    {
+        auto* signature  = intern(desc);
+        desc.mSignature  = signature;
+        desc.mGeneration = signature->mGeneration;
+    }
+
+    void DescriptorCache::bind(hiptensorContractionDescriptor_t& desc)
+    {
+        auto* signature  = intern(desc);
+        desc.mSignature  = signature;
+        desc.mGeneration = signature->mGeneration;
+    }
+
+    std::shared_ptr<ContractionSignature const>
+        DescriptorCache::retain(ContractionSignature const* signature) const
+    {
+        std::scoped_lock lock(mMutex);
+        auto             it = mOwned.find(signature);
+        if(it == mOwned.end())
+        {
+            return nullptr;
+        }
+        return std::static_pointer_cast<ContractionSignature const>(it->second.mRecord);
+    }
+
+    bool DescriptorCache::owns(TensorSignature const* signature) const
+    {
+        std::scoped_lock lock(mMutex);
+        return signature != nullptr && mOwned.count(signature) != 0;
+    }
+
+    bool DescriptorCache::owns(ContractionSignature const* signature) const
+    {
+        std::scoped_lock lock(mMutex);
+        return signature != nullptr && mOwned.count(signature) != 0;
+    }
+
+    void* DescriptorCache::findPlan(ContractionSignature const* signature,
+                                    hiptensorAlgo_t             algo,
+                                    uint64_t                    workspaceSize,
+                                    SelectionPolicy const&      policy,
+                                    std::vector<void*> const&   candidates)
+    {
+        std::scoped_lock lock(mMutex);
+        auto             it = mPlans.find(PlanKeyRef{
+            signature, static_cast<int32_t>(algo), workspaceSize, policy.key(), candidates});
+        if(it == mPlans.end())
+        {
+            return nullptr;
+        }
+
+        mPlanHits++;
+        pushFront(mPlanLru, &it->second);
+        return it->second.mSolution;
+    }
+
+    void DescriptorCache::cachePlan(ContractionSignature const* signature,
+                                    hiptensorAlgo_t             algo,
+                                    uint64_t                    workspaceSize,
+                                    void*                       solution,
+                                    SelectionPolicy const&      policy,
+                                    std::vector<void*> const&   candidates)
+    {
+        std::scoped_lock lock(mMutex);
+        auto             owner = mOwned.find(signature);
+        if(owner == mOwned.end())
+        {
+            return;
+        }
+
+        auto [it, inserted] = mPlans.try_emplace(PlanKey{
+            signature, static_cast<int32_t>(algo), workspaceSize, policy.key(), candidates});
+        auto& plan          = it->second;
+        if(inserted)
+        {
+            plan.mKey   = &it->first;
+            plan.mOwner = &owner->second;
+            plan.mIndex = owner->second.mPlans.size();
+            owner->second.mPlans.push_back(&plan);
+        }
+        plan.mSolution = solution;
+        pushFront(mPlanLru, &plan);
+        evict();
+    }
+
+    std::size_t DescriptorCache::tensorCount() const
+    {
+        std::scoped_lock lock(mMutex);
+        return mTensors.size();
+    }
+
+    std::size_t DescriptorCache::contractionCount() const
+    {
+        std::scoped_lock lock(mMutex);
+        return mContractions.size();
+    }
+
+    std::size_t DescriptorCache::planCount() const
+    {
+        std::scoped_lock lock(mMutex);
+        return mPlans.size();
+    }
+
+    std::size_t DescriptorCache::planHits() const
+    {
+        std::scoped_lock lock(mMutex);
+        return mPlanHits;
+    }
+
+} // namespace hiptensor
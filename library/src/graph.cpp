@@ -0,0 +1,164 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+
+#include "graph.hpp"
+
+namespace hiptensor
+{
+    Graph::~Graph()
+    {
+        if(mExec != nullptr)
+        {
+            hipGraphExecDestroy(mExec);
+        }
+    }
+
+    void Graph::record(std::vector<void const*> const& buffers, Launch launch)
+    {
+        Operation operation;
+        for(auto* buffer : buffers)
+        {
+            if(buffer == nullptr)
+            {
+                operation.mBindings.push_back(-1);
+                continue;
+            }
+
+            auto it = std::find(mBindings.begin(), mBindings.end(), buffer);
+            if(it == mBindings.end())
+            {
+                it = mBindings.insert(mBindings.end(), const_cast<void*>(buffer));
+            }
+            operation.mBindings.push_back(int32_t(it - mBindings.begin()));
+        }
+        operation.mLaunch = std::move(launch);
+        mOperations.push_back(std::move(operation));
+    }
+
+    std::size_t Graph::bindings() const
+    {
+        return mBindings.size();
+    }
+
+    std::size_t Graph::operations() const
+    {
+        return mOperations.size();
+    }
+
+    std::vector<void*> Graph::resolve(void const* const* bindings, std::size_t count) const
+    {
+        auto resolved = mBindings;
+        for(std::size_t i = 0; bindings != nullptr && i < std::min(count, resolved.size()); i++)
+        {
+            if(bindings[i] != nullptr)
+            {
+                resolved[i] = const_cast<void*>(bindings[i]);
+            }
+        }
+        return resolved;
+    }
+
+    hiptensorStatus_t Graph::run(std::vector<void*> const& resolved, hipStream_t stream) const
+    {
+        std::vector<void*> buffers;
+        for(auto const& operation : mOperations)
+        {
+            buffers.clear();
+            for(auto binding : operation.mBindings)
+            {
+                buffers.push_back(binding >= 0 ? resolved[binding] : nullptr);
+            }
+
+            auto status = operation.mLaunch(buffers, stream);
+            if(status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                return status;
+            }
+        }
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t
+        Graph::replay(void const* const* bindings, std::size_t count, hipStream_t stream)
+    {
+        return run(resolve(bindings, count), stream);
+    }
+
+    hiptensorStatus_t
+        Graph::launch(void const* const* bindings, std::size_t count, hipStream_t stream)
+    {
+        // The legacy null stream cannot be captured
+        auto resolved = resolve(bindings, count);
+        if(stream == nullptr)
+        {
+            return run(resolved, stream);
+        }
+
+        if(mExec == nullptr || resolved != mExecBindings)
+        {
+            if(mExec != nullptr)
+            {
+                hipGraphExecDestroy(mExec);
+                mExec = nullptr;
+            }
+
+            if(hipStreamBeginCapture(stream, hipStreamCaptureModeGlobal) != hipSuccess)
+            {
+                return HIPTENSOR_STATUS_HIP_ERROR;
+            }
+
+            // Recorded operations run untimed, so they never synchronize the stream
+            hipGraph_t graph  = nullptr;
+            auto       status = run(resolved, stream);
+            if(hipStreamEndCapture(stream, &graph) != hipSuccess
+               && status == HIPTENSOR_STATUS_SUCCESS)
+            {
+                status = HIPTENSOR_STATUS_HIP_ERROR;
+            }
+            if(status == HIPTENSOR_STATUS_SUCCESS
+               && hipGraphInstantiate(&mExec, graph, nullptr, nullptr, 0) != hipSuccess)
+            {
+                mExec  = nullptr;
+                status = HIPTENSOR_STATUS_HIP_ERROR;
+            }
+            if(graph != nullptr)
+            {
+                hipGraphDestroy(graph);
+            }
+            if(status != HIPTENSOR_STATUS_SUCCESS)
+            {
+                return status;
+            }
+            mExecBindings = resolved;
+        }
+
+        return hipGraphLaunch(mExec, stream) == hipSuccess ? HIPTENSOR_STATUS_SUCCESS
+                                                           : HIPTENSOR_STATUS_HIP_ERROR;
+    }
+
+} // namespace hiptensor
@@ -24,16 +24,102 @@
  *
  *******************************************************************************/
 
+#include <atomic>
+
+#include <hiptensor/hiptensor_types.hpp>
+#include <hiptensor/internal/hiptensor_utility.hpp>
+
 #include "handle.hpp"
 
 namespace hiptensor
 {
-    Handle Handle::createHandle(int64_t* buff)
+    // The handle is constructed in place inside the opaque hiptensorHandle_t
+    static_assert(sizeof(Handle) <= sizeof(hiptensorHandle_t::fields),
+                  "hiptensor::Handle does not fit in hiptensorHandle_t");
+
+    namespace
+    {
+        std::atomic<uint64_t> nextHandleId{1};
+    }
+
+    DeviceContext::DeviceContext(hipDevice_t deviceId)
+        : mDevice(deviceId)
+    {
+    }
+
+    DeviceContext::~DeviceContext()
+    {
+        if(mStream != nullptr)
+        {
+            hipStreamDestroy(mStream);
+        }
+    }
+
+    HipDevice const& DeviceContext::getDevice() const
+    {
+        return mDevice;
+    }
+
+    DescriptorCache& DeviceContext::getDescriptorCache()
+    {
+        return mDescriptorCache;
+    }
+
+    WorkspacePool& DeviceContext::getWorkspacePool()
+    {
+        return mWorkspacePool;
+    }
+
+    std::vector<void*>& DeviceContext::getCandidates()
+    {
+        return mCandidates;
+    }
+
+    hipStream_t DeviceContext::getStream()
+    {
+        if(mStream == nullptr)
+        {
+            hipDevice_t current = -1;
+            CHECK_HIP_ERROR(hipGetDevice(&current));
+            CHECK_HIP_ERROR(hipSetDevice(mDevice.getDeviceId()));
+            CHECK_HIP_ERROR(hipStreamCreateWithFlags(&mStream, hipStreamNonBlocking));
+            CHECK_HIP_ERROR(hipSetDevice(current));
+        }
+        return mStream;
+    }
+
+    Handle::Handle()
+        : mId(nextHandleId++)
+    {
+        // The device current at creation
+        hipDevice_t deviceId = -1;
+        CHECK_HIP_ERROR(hipGetDevice(&deviceId));
+        mDevices.push_back(std::make_unique<DeviceContext>(deviceId));
+    }
+
+    Handle::Handle(std::vector<hipDevice_t> const& deviceIds)
+        : mId(nextHandleId++)
+    {
+        for(auto deviceId : deviceIds)
+        {
+            mDevices.push_back(std::make_unique<DeviceContext>(deviceId));
+        }
+    }
+
+    Handle* Handle::createHandle(int64_t* buff)
     {
         auto handle = toHandle(buff);
         new(handle) Handle();
 
-        return *handle;
+        return handle;
+    }
+
+    Handle* Handle::createHandle(int64_t* buff, std::vector<hipDevice_t> const& deviceIds)
+    {
+        auto handle = toHandle(buff);
+        new(handle) Handle(deviceIds);
+
+        return handle;
     }
 
     void Handle::destroyHandle(int64_t* buff)
@@ -49,7 +135,75 @@ namespace hiptensor
 
     HipDevice Handle::getDevice()
     {
-        return mDevice;
+        return mDevices.front()->getDevice();
+    }
+
+    DescriptorCache& Handle::getDescriptorCache()
+    {
+        return mDevices.front()->getDescriptorCache();
+    }
+
+    WorkspacePool& Handle::getWorkspacePool()
+    {
+        return mDevices.front()->getWorkspacePool();
+    }
+
+    uint64_t Handle::getId() const
+    {
+        return mId;
+    }
+
+    uint32_t Handle::getDeviceCount() const
+    {
+        return uint32_t(mDevices.size());
+    }
+
+    DeviceContext& Handle::getDeviceContext(uint32_t index)
+    {
+        return *mDevices[index];
+    }
+
+    hiptensorPointerMode_t Handle::getPointerMode() const
+    {
+        return mPointerMode;
+    }
+
+    void Handle::setPointerMode(hiptensorPointerMode_t mode)
+    {
+        mPointerMode = mode;
+    }
+
+    void Handle::beginCapture()
+    {
+        mCapture = std::make_unique<Graph>();
+    }
+
+    Graph* Handle::getCapture()
+    {
+        return mCapture.get();
+    }
+
+    std::unique_ptr<Graph> Handle::endCapture()
+    {
+        return std::move(mCapture);
+    }
+
+    void Handle::beginDeferred()
+    {
+        if(mDeferred == nullptr)
+        {
+            mDeferred = std::make_unique<DeferredQueue>();
+        }
+    }
+
+    DeferredQueue* Handle::getDeferred()
+    {
+        return mDeferred.get();
+    }
+
+    std::unique_ptr<DeferredQueue> Handle::endDeferred()
+    {
+        return std::move(mDeferred);
     }
 
 } // namespace hiptensor
@@ -30,14 +30,22 @@
 namespace hiptensor
 {
     HipDevice::HipDevice()
-        : mDeviceId(-1)
+        : HipDevice([]() {
+            hipDevice_t deviceId = -1;
+            CHECK_HIP_ERROR(hipGetDevice(&deviceId));
+            return deviceId;
+        }())
+    {
+    }
+
+    HipDevice::HipDevice(hipDevice_t deviceId)
+        : mDeviceId(deviceId)
         , mGcnArch(hipGcnArch_t::UNSUPPORTED_ARCH)
         , mWarpSize(hipWarpSize_t::UNSUPPORTED_WARP_SIZE)
         , mSharedMemSize(0)
         , mCuCount(0)
         , mMaxFreqMhz(0)
     {
-        CHECK_HIP_ERROR(hipGetDevice(&mDeviceId));
         CHECK_HIP_ERROR(hipGetDeviceProperties(&mProps, mDeviceId));
 
         mArch = mProps.arch;
@@ -23,13 +23,19 @@
  * THE SOFTWARE.
  *
  *******************************************************************************/
+#include <algorithm>
+#include <memory>
+
 #include <hip/hip_runtime_api.h>
 
 #include <hiptensor/hiptensor.hpp>
 
+#include "data_layout.hpp"
 #include "data_types.hpp"
 #include "handle.hpp"
 #include "logger.hpp"
+#include "tensor_file.hpp"
+#include "transport.hpp"
 #include "util.hpp"
 
 hiptensorStatus_t hiptensorCreate(hiptensorHandle_t** handle)
@@ -103,6 +109,318 @@ hiptensorStatus_t hiptensorDestroy(hiptensorHandle_t* handle)
     return HIPTENSOR_STATUS_SUCCESS;
 }
 
+hiptensorStatus_t hiptensorCreateMultiDevice(hiptensorHandle_t** handle,
+                                             uint32_t            numDevices,
+                                             const int32_t       deviceIds[])
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, numDevices=%u, deviceIds=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             numDevices,
+             (unsigned long long)deviceIds);
+    logger->logAPITrace("hiptensorCreateMultiDevice", msg);
+
+    if(handle == nullptr || numDevices == 0 || deviceIds == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : handle or deviceIds = nullptr or numDevices = 0 (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorCreateMultiDevice", msg);
+        return errorCode;
+    }
+
+    if(hipInit(0) != hipSuccess)
+    {
+        auto errorCode = HIPTENSOR_STATUS_HIP_ERROR;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization error: hipInit failed (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorCreateMultiDevice", msg);
+        return errorCode;
+    }
+
+    int deviceCount = 0;
+    CHECK_HIP_ERROR(hipGetDeviceCount(&deviceCount));
+
+    std::vector<hipDevice_t> devices(deviceIds, deviceIds + numDevices);
+    for(auto i = 0u; i < numDevices; i++)
+    {
+        if(devices[i] < 0 || devices[i] >= deviceCount
+           || std::find(devices.begin(), devices.begin() + i, devices[i])
+                  != devices.begin() + i)
+        {
+            auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+            snprintf(msg,
+                     sizeof(msg),
+                     "Initialization error: invalid or repeated device id %d (%s)",
+                     (int)devices[i],
+                     hiptensorGetErrorString(errorCode));
+            logger->logError("hiptensorCreateMultiDevice", msg);
+            return errorCode;
+        }
+    }
+
+    (*handle) = new hiptensorHandle_t;
+    hiptensor::Handle::createHandle((*handle)->fields, devices);
+
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorGetDeviceCount(const hiptensorHandle_t* handle, uint32_t* numDevices)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, numDevices=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)numDevices);
+    logger->logAPITrace("hiptensorGetDeviceCount", msg);
+
+    if(!handle || !numDevices)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : %s = nullptr (%s)",
+                 !handle ? "handle" : "numDevices",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorGetDeviceCount", msg);
+        return errorCode;
+    }
+
+    *numDevices = hiptensor::Handle::toHandle((int64_t*)handle->fields)->getDeviceCount();
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorGetHandleId(const hiptensorHandle_t* handle, uint64_t* id)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, id=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)id);
+    logger->logAPITrace("hiptensorGetHandleId", msg);
+
+    if(!handle || !id)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : %s = nullptr (%s)",
+                 !handle ? "handle" : "id",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorGetHandleId", msg);
+        return errorCode;
+    }
+
+    *id = hiptensor::Handle::toHandle((int64_t*)handle->fields)->getId();
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+namespace
+{
+    // Rank of an in-process fabric behind a transport's callbacks. The fabric is freed
+    // with its last rank.
+    struct InProcessRank
+    {
+        std::shared_ptr<hiptensor::InProcessFabric> mFabric;
+        hiptensor::Transport*                       mTransport;
+    };
+
+    hiptensorStatus_t inProcessSend(void*       context,
+                                    uint32_t    peer,
+                                    uint32_t    tag,
+                                    const void* buffer,
+                                    uint64_t    bytes,
+                                    void**      request)
+    {
+        return static_cast<InProcessRank*>(context)->mTransport->send(
+            peer, tag, buffer, bytes, request);
+    }
+
+    hiptensorStatus_t inProcessReceive(
+        void* context, uint32_t peer, uint32_t tag, void* buffer, uint64_t bytes, void** request)
+    {
+        return static_cast<InProcessRank*>(context)->mTransport->receive(
+            peer, tag, buffer, bytes, request);
+    }
+
+    hiptensorStatus_t inProcessWait(void* context, void* request)
+    {
+        return static_cast<InProcessRank*>(context)->mTransport->wait(request);
+    }
+}
+
+hiptensorStatus_t hiptensorCreateInProcessTransports(uint32_t             numRanks,
+                                                     hiptensorTransport_t transports[])
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "numRanks=%u, transports=0x%llX",
+             numRanks,
+             (unsigned long long)transports);
+    logger->logAPITrace("hiptensorCreateInProcessTransports", msg);
+
+    if(numRanks == 0 || transports == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : numRanks = 0 or transports = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorCreateInProcessTransports", msg);
+        return errorCode;
+    }
+
+    // Payloads may live in host or device memory
+    auto fabric = std::make_shared<hiptensor::InProcessFabric>(
+        numRanks, [](void* dst, void const* src, std::size_t bytes) {
+            CHECK_HIP_ERROR(hipMemcpy(dst, src, bytes, hipMemcpyDefault));
+        });
+    for(uint32_t rank = 0; rank < numRanks; rank++)
+    {
+        transports[rank] = {rank,
+                            numRanks,
+                            new InProcessRank{fabric, &fabric->transport(rank)},
+                            inProcessSend,
+                            inProcessReceive,
+                            inProcessWait};
+    }
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorDestroyInProcessTransports(uint32_t             numRanks,
+                                                      hiptensorTransport_t transports[])
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "numRanks=%u, transports=0x%llX",
+             numRanks,
+             (unsigned long long)transports);
+    logger->logAPITrace("hiptensorDestroyInProcessTransports", msg);
+
+    if(numRanks > 0 && transports == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : transports = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorDestroyInProcessTransports", msg);
+        return errorCode;
+    }
+
+    for(uint32_t rank = 0; rank < numRanks; rank++)
+    {
+        delete static_cast<InProcessRank*>(transports[rank].mContext);
+        transports[rank].mContext = nullptr;
+    }
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorSetPointerMode(const hiptensorHandle_t* handle,
+                                          hiptensorPointerMode_t   mode)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, mode=0x%02X",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned int)mode);
+    logger->logAPITrace("hiptensorSetPointerMode", msg);
+
+    if(!handle)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(
+            msg, sizeof(msg), "Error : handle = nullptr (%s)", hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSetPointerMode", msg);
+        return errorCode;
+    }
+
+    if(mode != HIPTENSOR_POINTER_MODE_HOST && mode != HIPTENSOR_POINTER_MODE_DEVICE)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : unknown pointer mode (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSetPointerMode", msg);
+        return errorCode;
+    }
+
+    hiptensor::Handle::toHandle((int64_t*)handle->fields)->setPointerMode(mode);
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorGetPointerMode(const hiptensorHandle_t* handle,
+                                          hiptensorPointerMode_t*  mode)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, mode=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)mode);
+    logger->logAPITrace("hiptensorGetPointerMode", msg);
+
+    if(!handle || !mode)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : %s = nullptr (%s)",
+                 !handle ? "handle" : "mode",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorGetPointerMode", msg);
+        return errorCode;
+    }
+
+    *mode = hiptensor::Handle::toHandle((int64_t*)handle->fields)->getPointerMode();
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
 hiptensorStatus_t hiptensorInitTensorDescriptor(const hiptensorHandle_t*     handle,
                                                 hiptensorTensorDescriptor_t* desc,
                                                 const uint32_t               numModes,
@@ -191,17 +509,85 @@ hiptensorStatus_t hiptensorInitTensorDescriptor(const hiptensorHandle_t*     han
     {
         // Construct with both given lengths and strides
         *desc = {dataType,
-                 std::vector<std::size_t>(lens, lens + numModes),
-                 std::vector<std::size_t>(strides, strides + numModes)};
+                 hiptensorDimVector_t(lens, lens + numModes),
+                 hiptensorDimVector_t(strides, strides + numModes)};
+
+        // Packed strides name their own layout
+        desc->mLayout = hiptensor::layoutFromStrides(desc->mLengths, desc->mStrides);
     }
     else
     {
-        // Re-construct strides from lengths, assuming packed.
-        std::vector<std::size_t> l(lens, lens + numModes);
-        std::vector<std::size_t> s = hiptensor::stridesFromLengths(l);
+        // Re-construct strides from lengths, assuming packed. Contractions read them with
+        // the last mode fastest; permutations keep the default layout of the build until
+        // one is set with hiptensorSetTensorLayout.
+        hiptensorDimVector_t l(lens, lens + numModes);
+        hiptensorDimVector_t s = hiptensor::stridesFromLengths(l);
+
+        *desc         = {dataType, l, s};
+        desc->mLayout = HIPTENSOR_LAYOUT_DEFAULT;
+    }
+
+    // Share one analyzed record between all equal descriptors on this handle
+    realHandle->getDescriptorCache().bind(*desc);
+
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorSetTensorLayout(const hiptensorHandle_t*     handle,
+                                           hiptensorTensorDescriptor_t* desc,
+                                           hiptensorDataLayout_t        layout)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, desc=0x%llX, layout=0x%02X",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)desc,
+             (unsigned int)layout);
+    logger->logAPITrace("hiptensorSetTensorLayout", msg);
+
+    if(handle == nullptr || desc == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : %s = nullptr (%s)",
+                 handle == nullptr ? "handle" : "desc",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSetTensorLayout", msg);
+        return errorCode;
+    }
+
+    if(layout != HIPTENSOR_LAYOUT_DEFAULT && layout != HIPTENSOR_LAYOUT_ROW_MAJOR
+       && layout != HIPTENSOR_LAYOUT_COL_MAJOR)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Tensor Layout Error : unknown layout (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorSetTensorLayout", msg);
+        return errorCode;
+    }
 
-        *desc = {dataType, l, s};
+    // Packed strides follow the new layout, so that contractions read the elements where
+    // permutations write them. Strided views keep their strides.
+    auto const& lengths = desc->mLengths;
+    auto        packed
+        = desc->mStrides == hiptensor::stridesFromLengths(lengths, HIPTENSOR_LAYOUT_ROW_MAJOR)
+          || desc->mStrides == hiptensor::stridesFromLengths(lengths, HIPTENSOR_LAYOUT_COL_MAJOR);
+    if(packed && layout != HIPTENSOR_LAYOUT_DEFAULT)
+    {
+        auto realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+        desc->mStrides  = hiptensor::stridesFromLengths(lengths, layout);
+        realHandle->getDescriptorCache().bind(*desc);
     }
+    desc->mLayout = layout;
 
     return HIPTENSOR_STATUS_SUCCESS;
 }
@@ -313,6 +699,341 @@ hiptensorStatus_t hiptensorGetAlignmentRequirement(const hiptensorHandle_t*
     }
 }
 
+hiptensorStatus_t hiptensorWriteTensorFile(const char*                        path,
+                                           const hiptensorTensorDescriptor_t* desc,
+                                           const void*                        data)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[512];
+    snprintf(msg,
+             sizeof(msg),
+             "path=%s, desc=0x%llX, data=0x%llX",
+             path != nullptr ? path : "nullptr",
+             (unsigned long long)desc,
+             (unsigned long long)data);
+    logger->logAPITrace("hiptensorWriteTensorFile", msg);
+
+    if(path == nullptr || desc == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Initialization Error : path or tensor descriptor = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorWriteTensorFile", msg);
+        return errorCode;
+    }
+
+    auto status = hiptensor::MappedTensorFile::write(path, *desc, data);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        snprintf(msg,
+                 sizeof(msg),
+                 "Unable to write tensor file %s (%s)",
+                 path,
+                 hiptensorGetErrorString(status));
+        logger->logError("hiptensorWriteTensorFile", msg);
+    }
+    return status;
+}
+
+hiptensorStatus_t hiptensorGetWorkspacePoolUsage(const hiptensorHandle_t* handle,
+                                                 uint64_t*                reservedBytes,
+                                                 uint64_t*                highWaterMark)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, reservedBytes=0x%llX, highWaterMark=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)reservedBytes,
+             (unsigned long long)highWaterMark);
+    logger->logAPITrace("hiptensorGetWorkspacePoolUsage", msg);
+
+    if(!handle || !reservedBytes || !highWaterMark)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : %s = nullptr (%s)",
+                 !handle ? "handle" : (!reservedBytes ? "reservedBytes" : "highWaterMark"),
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorGetWorkspacePoolUsage", msg);
+        return errorCode;
+    }
+
+    auto& pool     = hiptensor::Handle::toHandle((int64_t*)handle->fields)->getWorkspacePool();
+    *reservedBytes = pool.reservedBytes();
+    *highWaterMark = pool.highWaterMark();
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorTrimWorkspacePool(const hiptensorHandle_t* handle)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(
+        msg, sizeof(msg), "handle=0x%0*llX", 2 * (int)sizeof(void*), (unsigned long long)handle);
+    logger->logAPITrace("hiptensorTrimWorkspacePool", msg);
+
+    if(!handle)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(
+            msg, sizeof(msg), "Error : handle = nullptr (%s)", hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorTrimWorkspacePool", msg);
+        return errorCode;
+    }
+
+    hiptensor::Handle::toHandle((int64_t*)handle->fields)->getWorkspacePool().trim();
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorBeginCapture(const hiptensorHandle_t* handle)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(
+        msg, sizeof(msg), "handle=0x%0*llX", 2 * (int)sizeof(void*), (unsigned long long)handle);
+    logger->logAPITrace("hiptensorBeginCapture", msg);
+
+    if(!handle)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(
+            msg, sizeof(msg), "Error : handle = nullptr (%s)", hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorBeginCapture", msg);
+        return errorCode;
+    }
+
+    hiptensor::Handle::toHandle((int64_t*)handle->fields)->beginCapture();
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorEndCapture(const hiptensorHandle_t* handle, hiptensorGraph_t* graph)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "handle=0x%0*llX, graph=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)handle,
+             (unsigned long long)graph);
+    logger->logAPITrace("hiptensorEndCapture", msg);
+
+    if(!handle)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(
+            msg, sizeof(msg), "Error : handle = nullptr (%s)", hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorEndCapture", msg);
+        return errorCode;
+    }
+
+    auto realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    if(!graph || realHandle->getCapture() == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : %s (%s)",
+                 graph ? "handle is not capturing" : "graph = nullptr",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorEndCapture", msg);
+        return errorCode;
+    }
+
+    auto recorded = realHandle->endCapture();
+    snprintf(msg,
+             sizeof(msg),
+             "Recorded %zu operation(s) on %zu binding(s)",
+             recorded->operations(),
+             recorded->bindings());
+    logger->logHeuristics("hiptensorEndCapture", msg);
+
+    graph->mGraph = recorded.release();
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorGraphGetBindingCount(const hiptensorGraph_t* graph,
+                                                uint32_t*               numBindings)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(msg,
+             sizeof(msg),
+             "graph=0x%0*llX, numBindings=0x%llX",
+             2 * (int)sizeof(void*),
+             (unsigned long long)graph,
+             (unsigned long long)numBindings);
+    logger->logAPITrace("hiptensorGraphGetBindingCount", msg);
+
+    if(!graph || !graph->mGraph)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(
+            msg, sizeof(msg), "Error : graph = nullptr (%s)", hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorGraphGetBindingCount", msg);
+        return errorCode;
+    }
+
+    if(!numBindings)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : numBindings = nullptr (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorGraphGetBindingCount", msg);
+        return errorCode;
+    }
+
+    *numBindings = uint32_t(static_cast<hiptensor::Graph const*>(graph->mGraph)->bindings());
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorGraphReplay(const hiptensorHandle_t* handle,
+                                       hiptensorGraph_t*        graph,
+                                       const void* const        bindings[],
+                                       uint32_t                 numBindings,
+                                       hipStream_t              stream)
+{
+    // Replay is the hot path: only null checks, no logging unless they fail
+    if(!handle || !graph || !graph->mGraph)
+    {
+        using hiptensor::Logger;
+        auto& logger = Logger::instance();
+
+        char msg[128];
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : %s = nullptr (%s)",
+                 handle ? "graph" : "handle",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorGraphReplay", msg);
+        return errorCode;
+    }
+
+    return static_cast<hiptensor::Graph*>(graph->mGraph)->launch(bindings, numBindings, stream);
+}
+
+hiptensorStatus_t hiptensorDestroyGraph(hiptensorGraph_t* graph)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(
+        msg, sizeof(msg), "graph=0x%0*llX", 2 * (int)sizeof(void*), (unsigned long long)graph);
+    logger->logAPITrace("hiptensorDestroyGraph", msg);
+
+    if(graph)
+    {
+        delete static_cast<hiptensor::Graph*>(graph->mGraph);
+        graph->mGraph = nullptr;
+    }
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+hiptensorStatus_t hiptensorBeginDeferred(const hiptensorHandle_t* handle)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(
+        msg, sizeof(msg), "handle=0x%0*llX", 2 * (int)sizeof(void*), (unsigned long long)handle);
+    logger->logAPITrace("hiptensorBeginDeferred", msg);
+
+    if(!handle)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(
+            msg, sizeof(msg), "Error : handle = nullptr (%s)", hiptensorGetErrorString(errorCode));
+        logger->logError("hiptensorBeginDeferred", msg);
+        return errorCode;
+    }
+
+    hiptensor::Handle::toHandle((int64_t*)handle->fields)->beginDeferred();
+    return HIPTENSOR_STATUS_SUCCESS;
+}
+
+// Flushes the deferred queue of a handle, optionally leaving deferred mode
+static hiptensorStatus_t flushDeferred(char const* api, const hiptensorHandle_t* handle, bool end)
+{
+    using hiptensor::Logger;
+    auto& logger = Logger::instance();
+
+    // Log API access
+    char msg[128];
+    snprintf(
+        msg, sizeof(msg), "handle=0x%0*llX", 2 * (int)sizeof(void*), (unsigned long long)handle);
+    logger->logAPITrace(api, msg);
+
+    if(!handle)
+    {
+        auto errorCode = HIPTENSOR_STATUS_NOT_INITIALIZED;
+        snprintf(
+            msg, sizeof(msg), "Error : handle = nullptr (%s)", hiptensorGetErrorString(errorCode));
+        logger->logError(api, msg);
+        return errorCode;
+    }
+
+    auto realHandle = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto queue      = realHandle->getDeferred();
+    if(queue == nullptr)
+    {
+        auto errorCode = HIPTENSOR_STATUS_INVALID_VALUE;
+        snprintf(msg,
+                 sizeof(msg),
+                 "Error : handle is not in deferred mode (%s)",
+                 hiptensorGetErrorString(errorCode));
+        logger->logError(api, msg);
+        return errorCode;
+    }
+
+    auto status = queue->flush();
+    if(end)
+    {
+        realHandle->endDeferred();
+    }
+    return status;
+}
+
+hiptensorStatus_t hiptensorFlush(const hiptensorHandle_t* handle)
+{
+    return flushDeferred("hiptensorFlush", handle, false);
+}
+
+hiptensorStatus_t hiptensorEndDeferred(const hiptensorHandle_t* handle)
+{
+    return flushDeferred("hiptensorEndDeferred", handle, true);
+}
+
 hiptensorStatus_t hiptensorLoggerSetCallback(hiptensorLoggerCallback_t callback)
 {
     using hiptensor::Logger;
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef HIPTENSOR_CONTRACTION_BLOCK_SPARSE_HPP
+#define HIPTENSOR_CONTRACTION_BLOCK_SPARSE_HPP
+
+#include <array>
+#include <vector>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    /// Dense contraction of one stored A block with one stored B block into a D block
+    struct BlockSparseTask
+    {
+        std::size_t mBlockA, mBlockB, mBlockD;
+        bool        mFirst; /*!< First product into its D block, which takes beta * C */
+    };
+
+    /// Block pairs whose A, B and D blocks have the same lengths, so that all of them
+    /// are contracted with one dense plan
+    struct BlockSparseGroup
+    {
+        std::array<hiptensorDimVector_t, 3> mLengths; /*!< Lengths of the A, B and D blocks */
+        std::vector<BlockSparseTask>        mTasks;
+    };
+
+    /// Contraction of block-sparse tensors as the dense contractions of the pairs of
+    /// stored A and B blocks that agree on their contracted block coordinates. C, when
+    /// present, is stored like D. Tasks are issued group by group, in order.
+    struct BlockSparsePlan
+    {
+        std::array<hiptensorBlockSparseTensorDescriptor_t, 3> mDescs; /*!< A, B and D */
+        std::array<std::vector<int32_t>, 3>                   mModes;
+        hiptensorComputeType_t                                mComputeType;
+        bool                                                  mHasC;
+
+        std::vector<BlockSparseGroup> mGroups;
+        std::vector<std::size_t>      mUntouched; /*!< D blocks that no pair reaches */
+
+        // Dense plans of the groups, when the plan runs on a device
+        std::vector<hiptensorContractionPlan_t> mDensePlans;
+
+        std::size_t taskCount() const;
+    };
+
+    // Lengths of a stored block
+    hiptensorDimVector_t blockLengths(hiptensorBlockSparseTensorDescriptor_t const& desc,
+                                      std::size_t                                   block);
+
+    // Checks that every block coordinate is in range, that no block is listed twice
+    // and that every block has an offset
+    hiptensorStatus_t validateBlockSparse(hiptensorBlockSparseTensorDescriptor_t const& desc);
+
+    // Pairs the stored blocks of A and B and groups the pairs by shape. Modes shared by
+    // operands must be split into the same blocks, and every product must land in a
+    // stored D block.
+    hiptensorStatus_t planBlockSparse(BlockSparsePlan*                              plan,
+                                      hiptensorBlockSparseTensorDescriptor_t const& descA,
+                                      int32_t const                                 modeA[],
+                                      hiptensorBlockSparseTensorDescriptor_t const& descB,
+                                      int32_t const                                 modeB[],
+                                      hiptensorBlockSparseTensorDescriptor_t const& descD,
+                                      int32_t const                                 modeD[],
+                                      hiptensorComputeType_t                        typeCompute,
+                                      bool                                          hasC);
+
+    // Runs a block-sparse contraction of host operands on up to `threads` host threads
+    // (0 for one per hardware thread). D blocks are shared out between the threads, and
+    // each thread contracts all pairs of its blocks in plan order. f32 and f64 only.
+    hiptensorStatus_t blockSparseContractionHost(BlockSparsePlan const& plan,
+                                                 void const*            alpha,
+                                                 void const*            A,
+                                                 void const*            B,
+                                                 void const*            beta,
+                                                 void const*            C,
+                                                 void*                  D,
+                                                 uint32_t               threads);
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_CONTRACTION_BLOCK_SPARSE_HPP
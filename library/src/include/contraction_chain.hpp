@@ -0,0 +1,85 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_CONTRACTION_CHAIN_HPP
+#define HIPTENSOR_CONTRACTION_CHAIN_HPP
+
+#include <array>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    // Bytes of the intermediate kept per block of a chain, sized to stay resident in L2
+    constexpr std::size_t ChainBlockBytes = 1u << 20;
+
+    /// Back-to-back contraction chain D = alpha * (A * B) * C. The intermediate
+    /// X = A * B is only ever formed one block of outermost M indices at a time, so
+    /// that it stays in cache between the two contractions and is never written out
+    /// whole. Modes are ordered A = [M, K], B = [N, K], C = [O, N] and D = [M, O].
+    struct ContractionChain
+    {
+        std::array<hiptensorTensorDescriptor_t, 4> mTensors; /*!< A, B, C and D */
+        hiptensorTensorDescriptor_t                mBlock; /*!< Packed X of one block */
+
+        std::size_t mRankM, mRankN, mRankK, mRankO;
+        std::size_t mOuterM; /*!< Outermost M mode length, 1 if none */
+        std::size_t mBlockM; /*!< Outermost M indices per block */
+        std::size_t mLastBlockM; /*!< Outermost M indices of the last block */
+        std::size_t mBlocks;
+
+        // Whether the last block is shorter than the others
+        bool raggedLast() const;
+
+        // Element offsets of a block into A and D
+        std::array<std::size_t, 2> blockOffsets(std::size_t block) const;
+
+        // A and D of a full block, or of the last one
+        std::array<hiptensorTensorDescriptor_t, 2> blockTensors(bool last = false) const;
+
+        // Packed X of a full block, or of the last one
+        hiptensorTensorDescriptor_t blockIntermediate(bool last = false) const;
+    };
+
+    // Checks the modes of a chain and splits it into blocks whose intermediate takes at
+    // most blockBytes. Blocks are as even as the outermost M mode allows; only the last
+    // one may be shorter.
+    hiptensorStatus_t analyzeChain(ContractionChain*                                 chain,
+                                   std::array<hiptensorTensorDescriptor_t, 4> const& tensors,
+                                   std::array<int32_t const*, 4> const&              modes,
+                                   std::size_t blockBytes = ChainBlockBytes);
+
+    // Runs a chain on host operands, one block of the intermediate at a time
+    hiptensorStatus_t contractChainHost(ContractionChain const& chain,
+                                        void const*             alpha,
+                                        void const*             A,
+                                        void const*             B,
+                                        void const*             C,
+                                        void*                   D);
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_CONTRACTION_CHAIN_HPP
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef HIPTENSOR_CONTRACTION_DISTRIBUTED_HPP
+#define HIPTENSOR_CONTRACTION_DISTRIBUTED_HPP
+
+#include <array>
+#include <vector>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+#include "contraction_streaming.hpp"
+#include "transport.hpp"
+
+namespace hiptensor
+{
+    struct ContractionSignature;
+
+    /// Ranks of a distributed contraction arranged in a grid. Rank r sits at row
+    /// r / mCols and column r % mCols.
+    struct ProcessGrid
+    {
+        uint32_t mRows, mCols;
+    };
+
+    /// SUMMA-style block distribution of a contraction over a process grid. The
+    /// outermost M mode is split over grid rows, the outermost N mode over grid columns
+    /// and the outermost K mode into panels. Rank (i, j) holds D and C block (i, j),
+    /// the A blocks (i, p) of panels p with p % mCols == j and the B blocks (p, j) of
+    /// panels p with p % mRows == i. At each step the owners of a panel send their A
+    /// block along their grid row and their B block along their grid column, and
+    /// every rank accumulates the product of the panel into its D block.
+    struct DistributedPlan
+    {
+        StreamingPlan mGeometry; /*!< Types, lengths and outer extents of the whole problem */
+        ProcessGrid   mGrid;
+        uint32_t      mPanels;
+
+        std::vector<std::size_t> mSplitM, mSplitN, mSplitK; /*!< Block boundaries */
+
+        // Ranks owning the A block of (row, panel) and the B block of (panel, column)
+        uint32_t ownerA(uint32_t row, uint32_t panel) const;
+        uint32_t ownerB(uint32_t panel, uint32_t col) const;
+
+        // Block of grid row, column and K panel. Blocks of C and D span all of K.
+        StreamingTile block(uint32_t row, uint32_t col, uint32_t panel) const;
+
+        // Blocks of operand i held by a rank, packed one after another in its local
+        // buffer in this order
+        std::vector<StreamingTile> localBlocks(uint32_t rank, int i) const;
+
+        // Elements of a packed block of operand i
+        std::size_t blockElements(StreamingTile const& block, int i) const;
+
+        // Bytes of the largest A and B panel blocks a rank receives
+        std::array<std::size_t, 2> panelBytes() const;
+    };
+
+    // Distributes a contraction over `ranks` ranks. The grid is made as square as the
+    // rank count allows, with more rows than columns when M is the longer mode. K is
+    // only split when the contraction has a C operand, since partial products are
+    // accumulated through it.
+    hiptensorStatus_t planDistributed(DistributedPlan*            plan,
+                                      ContractionSignature const& signature,
+                                      uint32_t                    ranks);
+
+    // Runs this rank's part of a distributed contraction. A, B, C and D are the
+    // rank's local blocks, packed in the order of DistributedPlan::localBlocks. Local
+    // contractions run through the backend's slot 0, and the transfers of the next
+    // panel are started before the current panel is contracted.
+    hiptensorStatus_t distributedContraction(DistributedPlan const& plan,
+                                             Transport&             transport,
+                                             StreamingBackend&      backend,
+                                             void const*            alpha,
+                                             void const*            A,
+                                             void const*            B,
+                                             void const*            beta,
+                                             void const*            C,
+                                             void*                  D,
+                                             std::size_t            workspaceBytes = 0);
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_CONTRACTION_DISTRIBUTED_HPP
@@ -0,0 +1,182 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_CONTRACTION_MULTI_DEVICE_HPP
+#define HIPTENSOR_CONTRACTION_MULTI_DEVICE_HPP
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    struct ContractionSignature;
+
+    /// Range of the split outermost M or N mode contracted by one device
+    struct DeviceShare
+    {
+        uint32_t    mDevice;
+        std::size_t mStart, mExtent;
+    };
+
+    /// Split of a contraction across devices along its outermost M or N mode. The
+    /// operands live on device 0, which contracts its share in place. Every other
+    /// device receives packed copies of its block of the split operand, the whole
+    /// other input and its block of C, and its D block is copied back into place.
+    /// The mode is chosen so that the smaller of A and B is the one replicated.
+    struct MultiDevicePlan
+    {
+        std::array<hipDataType, 4>          mTypes;
+        std::array<hiptensorDimVector_t, 4> mLengths;
+        std::array<hiptensorDimVector_t, 4> mStrides; /*!< Strides of A, B, C and D on device 0 */
+
+        std::size_t mRankM, mRankN;
+        std::size_t mOuterM, mOuterN; /*!< Outermost mode lengths, 1 if none */
+
+        bool                     mSplitN; /*!< Split along N, replicating A, rather than M */
+        std::vector<DeviceShare> mShares; /*!< Shares of non-zero extent, in device order */
+
+        // Lengths of the A, B, C and D blocks of a share
+        std::array<hiptensorDimVector_t, 4> shareLengths(DeviceShare const& share) const;
+
+        // Element offsets of a share's blocks into A, B, C and D on device 0
+        std::array<std::size_t, 4> shareOffsets(DeviceShare const& share) const;
+
+        // Bytes of the packed A, B and D blocks a device other than 0 holds for a share.
+        // C is copied into the D block.
+        std::size_t shareBytes(DeviceShare const& share) const;
+    };
+
+    // Splits a contraction across as many devices as there are weights, giving each a
+    // share of the split mode in proportion to its weight. Devices whose share rounds
+    // to nothing are left out.
+    hiptensorStatus_t planMultiDevice(MultiDevicePlan*            plan,
+                                      ContractionSignature const& signature,
+                                      std::vector<double> const&  weights);
+
+    /// Device operations of a multi-device contraction. Work issued to one device runs
+    /// in issue order; work issued to different devices may overlap.
+    class MultiDeviceBackend
+    {
+    public:
+        virtual ~MultiDeviceBackend() = default;
+
+        virtual hiptensorStatus_t allocate(uint32_t device, void** ptr, std::size_t bytes) = 0;
+        virtual hiptensorStatus_t release(uint32_t device, void* ptr)                      = 0;
+
+        // Copies a strided block between devices, ordered with the work of `device`
+        virtual hiptensorStatus_t copy(uint32_t                    device,
+                                       void*                       dst,
+                                       hiptensorDimVector_t const& dstStrides,
+                                       void const*                 src,
+                                       hiptensorDimVector_t const& srcStrides,
+                                       hiptensorDimVector_t const& lengths,
+                                       std::size_t                 elementBytes)
+            = 0;
+
+        // Contracts D = alpha * A * B + beta * C on a device
+        virtual hiptensorStatus_t contract(uint32_t                                   device,
+                                           void const*                                alpha,
+                                           void const*                                A,
+                                           void const*                                B,
+                                           void const*                                beta,
+                                           void const*                                C,
+                                           void*                                      D,
+                                           std::array<hiptensorDimVector_t, 4> const& lengths,
+                                           std::array<hiptensorDimVector_t, 4> const& strides)
+            = 0;
+
+        // Orders later work on device 0 after the work issued to every device
+        virtual hiptensorStatus_t join() = 0;
+    };
+
+    /// Multi-device backend that simulates its devices on the host, with one memory
+    /// space shared by all of them. Used to exercise splitting and scheduling without
+    /// devices.
+    class HostMultiDeviceBackend : public MultiDeviceBackend
+    {
+    public:
+        HostMultiDeviceBackend(uint32_t devices, hipDataType type);
+        ~HostMultiDeviceBackend() override;
+
+        hiptensorStatus_t allocate(uint32_t device, void** ptr, std::size_t bytes) override;
+        hiptensorStatus_t release(uint32_t device, void* ptr) override;
+        hiptensorStatus_t copy(uint32_t                    device,
+                               void*                       dst,
+                               hiptensorDimVector_t const& dstStrides,
+                               void const*                 src,
+                               hiptensorDimVector_t const& srcStrides,
+                               hiptensorDimVector_t const& lengths,
+                               std::size_t                 elementBytes) override;
+        hiptensorStatus_t contract(uint32_t                                   device,
+                                   void const*                                alpha,
+                                   void const*                                A,
+                                   void const*                                B,
+                                   void const*                                beta,
+                                   void const*                                C,
+                                   void*                                      D,
+                                   std::array<hiptensorDimVector_t, 4> const& lengths,
+                                   std::array<hiptensorDimVector_t, 4> const& strides) override;
+        hiptensorStatus_t join() override;
+
+        std::size_t peakBytes(uint32_t device) const;
+        std::size_t copiedBytes(uint32_t device) const;
+        std::size_t contractions(uint32_t device) const;
+        std::size_t joins() const;
+
+    private:
+        struct SimulatedDevice
+        {
+            std::size_t mAllocatedBytes = 0;
+            std::size_t mPeakBytes      = 0;
+            std::size_t mCopiedBytes    = 0;
+            std::size_t mContractions   = 0;
+        };
+
+        hipDataType                                mType;
+        std::vector<SimulatedDevice>               mDevices;
+        std::vector<std::pair<void*, std::size_t>> mAllocations;
+        std::vector<uint32_t>                      mOwners;
+        std::size_t                                mJoins = 0;
+    };
+
+    // Runs a multi-device contraction of operands on device 0 through a backend.
+    // Shares of other devices are issued first, so that their transfers overlap with
+    // the share that device 0 contracts in place.
+    hiptensorStatus_t multiDeviceContraction(MultiDevicePlan const& plan,
+                                             MultiDeviceBackend&    backend,
+                                             void const*            alpha,
+                                             void const*            A,
+                                             void const*            B,
+                                             void const*            beta,
+                                             void const*            C,
+                                             void*                  D);
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_CONTRACTION_MULTI_DEVICE_HPP
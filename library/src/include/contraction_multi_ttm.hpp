@@ -0,0 +1,94 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_CONTRACTION_MULTI_TTM_HPP
+#define HIPTENSOR_CONTRACTION_MULTI_TTM_HPP
+
+#include <vector>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    /// One tensor-times-matrix product of a multi-TTM: the mode at mMode of the current
+    /// tensor, of length K, is replaced by the R rows of a matrix U = [R, K]
+    struct MultiTtmStep
+    {
+        uint32_t             mMatrix; /*!< Index of the matrix */
+        uint32_t             mMode; /*!< Position of the mode it replaces */
+        hiptensorDimVector_t mLengthsIn, mLengthsOut;
+    };
+
+    /// Product of a packed tensor X with matrices along distinct modes. Each product only
+    /// changes the length of its mode, so they commute; the steps apply them in the order
+    /// of fewest multiply-adds, and of the smallest largest intermediate among those.
+    struct MultiTtmPlan
+    {
+        hipDataType              mType;
+        hiptensorDimVector_t     mLengths; /*!< Lengths of X */
+        std::vector<uint32_t>    mModes; /*!< Mode of X that each matrix multiplies */
+        std::vector<std::size_t> mRanks; /*!< Rows of each matrix */
+        bool                     mHasC;
+
+        std::vector<MultiTtmStep> mSteps;
+        std::size_t               mMultiplyAdds;
+        std::size_t               mIntermediateElements; /*!< Largest tensor between steps */
+
+        // Dense plans of the steps and the workspace they run in, on a device
+        std::vector<hiptensorContractionPlan_t> mDensePlans;
+        uint64_t                                mWorkspaceSize;
+    };
+
+    // Multiply-adds of applying the matrices in the given order
+    std::size_t multiTtmMultiplyAdds(hiptensorDimVector_t const&     lengths,
+                                     std::vector<uint32_t> const&    modes,
+                                     std::vector<std::size_t> const& ranks,
+                                     std::vector<uint32_t> const&    order);
+
+    // Orders the products of X = lengths with matrices of `ranks` rows along `modes`,
+    // searching all orders by the sets of matrices already applied
+    hiptensorStatus_t planMultiTtm(MultiTtmPlan*                   plan,
+                                   hipDataType                     type,
+                                   hiptensorDimVector_t const&     lengths,
+                                   std::vector<uint32_t> const&    modes,
+                                   std::vector<std::size_t> const& ranks,
+                                   bool                            hasC);
+
+    // Runs a multi-TTM of packed host operands on up to `threads` host threads (0 for
+    // one per hardware thread): Y = alpha * X x U[0] x ... + beta * C, with C packed like
+    // Y. Intermediates are allocated on the host. f32 and f64 only.
+    hiptensorStatus_t multiTtmHost(MultiTtmPlan const& plan,
+                                   void const*         alpha,
+                                   void const*         X,
+                                   void const* const   U[],
+                                   void const*         beta,
+                                   void const*         C,
+                                   void*               Y,
+                                   uint32_t            threads);
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_CONTRACTION_MULTI_TTM_HPP
@@ -0,0 +1,315 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_CONTRACTION_STREAMING_HPP
+#define HIPTENSOR_CONTRACTION_STREAMING_HPP
+
+#include <array>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+#include "tensor_file.hpp"
+
+namespace hiptensor
+{
+    struct ContractionSignature;
+
+    /// Block of a streamed contraction, as start and extent of the outermost M, N and K modes
+    struct StreamingTile
+    {
+        std::size_t mStartM, mExtentM;
+        std::size_t mStartN, mExtentN;
+        std::size_t mStartK, mExtentK;
+    };
+
+    /// Tiling of a contraction whose operands live in host memory. Tiles are copied
+    /// packed into device slots that are used round-robin, so that transfers into one
+    /// slot overlap with the contraction running in another. Every slot holds one A,
+    /// B and D tile; C is uploaded into the D tile, which accumulates over K tiles.
+    /// The outputs of a multi-output contraction are tiled as one, concatenated along
+    /// the outermost N mode, so that each A tile is uploaded once for all of them.
+    struct StreamingPlan
+    {
+        std::array<hipDataType, 4>          mTypes;
+        std::array<hiptensorDimVector_t, 4> mLengths; /*!< Lengths with outputs concatenated */
+        std::array<hiptensorDimVector_t, 4> mStrides; /*!< Host strides of A, B, C and D */
+
+        uint32_t    mOutputs; /*!< Number of B, C and D operands sharing A */
+        std::size_t mOutputN; /*!< Outermost N mode length of each output */
+
+        std::size_t mRankM, mRankN, mRankK;
+        std::size_t mOuterM, mOuterN, mOuterK; /*!< Outermost mode lengths, 1 if none */
+        std::size_t mTileM, mTileN, mTileK; /*!< Outermost mode extents of a full tile */
+
+        uint32_t                   mSlots;
+        std::array<std::size_t, 3> mSlotOffsets; /*!< Offsets of the A, B and D tiles */
+        std::size_t                mWorkspaceOffset; /*!< Offset of the kernel workspace */
+        std::size_t                mSlotBytes; /*!< Device bytes taken by each slot */
+
+        // Tiles in execution order. K tiles of one output tile are consecutive.
+        std::vector<StreamingTile> tiles() const;
+
+        // Lengths of the A, B, C and D blocks of a tile
+        std::array<hiptensorDimVector_t, 4> tileLengths(StreamingTile const& tile) const;
+
+        // Element offsets of a tile into the host A, B, C and D
+        std::array<std::size_t, 4> tileOffsets(StreamingTile const& tile) const;
+
+        // Number of output tiles; K tiles accumulate into the same output
+        std::size_t outputTiles() const;
+
+        // Host byte offset and byte extent spanned by operand i of a tile
+        std::pair<std::size_t, std::size_t> tileSpan(StreamingTile const& tile, int i) const;
+
+        // Parts of a tile in each output it overlaps, as the output and the part with
+        // its N range relative to that output
+        std::vector<std::pair<uint32_t, StreamingTile>>
+            outputSegments(StreamingTile const& tile) const;
+    };
+
+    // Flattened N rows per panel of the host engine's pre-packed B operand
+    constexpr std::size_t HostPanelWidth = 8u;
+
+    /// B = [N, K] of a contraction pre-packed into the host engine's panel format.
+    /// Flattened N rows are grouped into panels of HostPanelWidth rows stored K-major,
+    /// so that every K step reads the B values of a whole panel contiguously. The last
+    /// panel is zero padded. Packing once lets a constant B be reused by any number of
+    /// streamed contractions without being uploaded or re-laid out per tile.
+    struct HostPackedOperand
+    {
+        hipDataType       mType;
+        std::size_t       mN, mK; /*!< Flattened N and K extents */
+        std::size_t       mInnerN, mInnerK; /*!< Flattened extents per outermost N and K index */
+        std::vector<char> mPanels;
+    };
+
+    // Packs the host B of a streaming plan into the host engine's panel format
+    hiptensorStatus_t
+        packHostOperand(HostPackedOperand* packed, StreamingPlan const& plan, void const* B);
+
+    // Picks the largest tiles for which `slots` device slots, each with workspaceBytes
+    // of kernel workspace, fit into capacityBytes. K is only tiled when the contraction
+    // has a C operand, since partial products are accumulated through it.
+    hiptensorStatus_t planStreaming(StreamingPlan*              plan,
+                                    ContractionSignature const& signature,
+                                    std::size_t                 capacityBytes,
+                                    std::size_t                 workspaceBytes,
+                                    uint32_t                    slots);
+
+    // Visits the contiguous runs of a strided block copy as (src offset, dst offset, count),
+    // in elements. Modes that are contiguous in both layouts are merged into longer runs.
+    void forEachCopyRun(
+        hiptensorDimVector_t const&                                          lengths,
+        hiptensorDimVector_t const&                                          srcStrides,
+        hiptensorDimVector_t const&                                          dstStrides,
+        std::function<void(std::size_t, std::size_t, std::size_t)> const& visit);
+
+    /// Device operations of a streamed contraction. Work submitted to one slot runs
+    /// in submission order; work submitted to different slots may overlap.
+    class StreamingBackend
+    {
+    public:
+        virtual ~StreamingBackend() = default;
+
+        virtual hiptensorStatus_t allocate(void** ptr, std::size_t bytes) = 0;
+        virtual hiptensorStatus_t release(void* ptr)                      = 0;
+
+        // Copies a strided host block into device memory
+        virtual hiptensorStatus_t upload(void*                       dst,
+                                         hiptensorDimVector_t const& dstStrides,
+                                         void const*                 src,
+                                         hiptensorDimVector_t const& srcStrides,
+                                         hiptensorDimVector_t const& lengths,
+                                         std::size_t                 elementBytes,
+                                         uint32_t                    slot)
+            = 0;
+
+        // Copies device memory into a strided host block
+        virtual hiptensorStatus_t download(void*                       dst,
+                                           hiptensorDimVector_t const& dstStrides,
+                                           void const*                 src,
+                                           hiptensorDimVector_t const& srcStrides,
+                                           hiptensorDimVector_t const& lengths,
+                                           std::size_t                 elementBytes,
+                                           uint32_t                    slot)
+            = 0;
+
+        // Contracts packed tiles, D = alpha * A * B + beta * C
+        virtual hiptensorStatus_t contract(void const*                                alpha,
+                                           void const*                                A,
+                                           void const*                                B,
+                                           void const*                                beta,
+                                           void const*                                C,
+                                           void*                                      D,
+                                           std::array<hiptensorDimVector_t, 4> const& lengths,
+                                           void*                                      workspace,
+                                           uint32_t                                   slot)
+            = 0;
+
+        // Contracts a packed A tile with the block of a pre-packed B that starts at
+        // flattened N row startN and K column startK. Backends without a panel
+        // kernel do not support pre-packed operands.
+        virtual hiptensorStatus_t
+            contractPanels(void const*                                alpha,
+                           void const*                                A,
+                           HostPackedOperand const&                   B,
+                           std::size_t                                startN,
+                           std::size_t                                startK,
+                           void const*                                beta,
+                           void const*                                C,
+                           void*                                      D,
+                           std::array<hiptensorDimVector_t, 4> const& lengths,
+                           void*                                      workspace,
+                           uint32_t                                   slot)
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        // Waits for the work of every slot
+        virtual hiptensorStatus_t synchronize() = 0;
+    };
+
+    /// Streaming backend that runs on the host against a simulated device capacity.
+    /// Used to exercise tiling and scheduling without a device.
+    class HostStreamingBackend : public StreamingBackend
+    {
+    public:
+        HostStreamingBackend(std::size_t capacityBytes, hipDataType type);
+        ~HostStreamingBackend() override;
+
+        hiptensorStatus_t allocate(void** ptr, std::size_t bytes) override;
+        hiptensorStatus_t release(void* ptr) override;
+        hiptensorStatus_t upload(void*                       dst,
+                                 hiptensorDimVector_t const& dstStrides,
+                                 void const*                 src,
+                                 hiptensorDimVector_t const& srcStrides,
+                                 hiptensorDimVector_t const& lengths,
+                                 std::size_t                 elementBytes,
+                                 uint32_t                    slot) override;
+        hiptensorStatus_t download(void*                       dst,
+                                   hiptensorDimVector_t const& dstStrides,
+                                   void const*                 src,
+                                   hiptensorDimVector_t const& srcStrides,
+                                   hiptensorDimVector_t const& lengths,
+                                   std::size_t                 elementBytes,
+                                   uint32_t                    slot) override;
+        hiptensorStatus_t contract(void const*                                alpha,
+                                   void const*                                A,
+                                   void const*                                B,
+                                   void const*                                beta,
+                                   void const*                                C,
+                                   void*                                      D,
+                                   std::array<hiptensorDimVector_t, 4> const& lengths,
+                                   void*                                      workspace,
+                                   uint32_t                                   slot) override;
+        hiptensorStatus_t contractPanels(void const*                                alpha,
+                                         void const*                                A,
+                                         HostPackedOperand const&                   B,
+                                         std::size_t                                startN,
+                                         std::size_t                                startK,
+                                         void const*                                beta,
+                                         void const*                                C,
+                                         void*                                      D,
+                                         std::array<hiptensorDimVector_t, 4> const& lengths,
+                                         void*                                      workspace,
+                                         uint32_t                                   slot) override;
+        hiptensorStatus_t synchronize() override;
+
+        std::size_t peakBytes() const;
+        std::size_t uploads() const;
+        std::size_t contractions() const;
+        uint32_t    slotsUsed() const;
+
+    private:
+        std::size_t                                mCapacityBytes;
+        hipDataType                                mType;
+        std::size_t                                mAllocatedBytes = 0;
+        std::size_t                                mPeakBytes      = 0;
+        std::size_t                                mUploads        = 0;
+        std::size_t                                mContractions   = 0;
+        uint32_t                                   mSlotsUsed      = 0;
+        std::vector<std::pair<void*, std::size_t>> mAllocations;
+    };
+
+    /// Host memory access hints issued in tile order, ahead of and after each tile's uploads
+    class StreamingHints
+    {
+    public:
+        virtual ~StreamingHints() = default;
+
+        // Byte range of operand i (A, B or C) that an upcoming tile reads
+        virtual void willNeed(int i, std::size_t offset, std::size_t bytes) = 0;
+
+        // Byte range of operand i that the next tile does not read again
+        virtual void dontNeed(int i, std::size_t offset, std::size_t bytes) = 0;
+    };
+
+    /// Forwards streaming hints to memory-mapped operand files, so that contractions
+    /// read their tiles from disk just in time and keep resident memory bounded
+    class MappedTensorHints : public StreamingHints
+    {
+    public:
+        explicit MappedTensorHints(std::array<MappedTensorFile const*, 4> const& files);
+
+        void willNeed(int i, std::size_t offset, std::size_t bytes) override;
+        void dontNeed(int i, std::size_t offset, std::size_t bytes) override;
+
+    private:
+        std::array<MappedTensorFile const*, 4> mFiles;
+    };
+
+    // Runs a streamed contraction of host operands through a backend. When packedB is
+    // given, B is read from it in place and is not uploaded.
+    hiptensorStatus_t streamContraction(StreamingPlan const&     plan,
+                                        StreamingBackend&        backend,
+                                        void const*              alpha,
+                                        void const*              A,
+                                        void const*              B,
+                                        void const*              beta,
+                                        void const*              C,
+                                        void*                    D,
+                                        StreamingHints*          hints   = nullptr,
+                                        HostPackedOperand const* packedB = nullptr);
+
+    // Runs a streamed multi-output contraction with one B, C and D per output of the
+    // plan. C may be nullptr. Hints are only given for A, and B cannot be pre-packed.
+    hiptensorStatus_t streamContraction(StreamingPlan const&     plan,
+                                        StreamingBackend&        backend,
+                                        void const*              alpha,
+                                        void const*              A,
+                                        void const* const        B[],
+                                        void const*              beta,
+                                        void const* const        C[],
+                                        void* const              D[],
+                                        StreamingHints*          hints   = nullptr,
+                                        HostPackedOperand const* packedB = nullptr);
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_CONTRACTION_STREAMING_HPP
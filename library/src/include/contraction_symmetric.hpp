@@ -0,0 +1,94 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_CONTRACTION_SYMMETRIC_HPP
+#define HIPTENSOR_CONTRACTION_SYMMETRIC_HPP
+
+#include <array>
+#include <vector>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+#include "symmetric_packing.hpp"
+
+namespace hiptensor
+{
+    /// Contraction of tensors in packed symmetric storage. D is computed at its stored
+    /// elements only. Contracted modes over which A and B have the same symmetry group
+    /// are summed over sorted indices, each weighted by the number of its permutations.
+    struct SymmetricContractionPlan
+    {
+        std::array<hiptensorSymmetricTensorDescriptor_t, 3> mDescs; /*!< A, B and D */
+        std::array<SymmetricShape, 3>                       mShapes;
+        std::array<std::vector<int32_t>, 3>                 mModes;
+        hiptensorComputeType_t                              mComputeType;
+        bool                                                mHasC;
+
+        // Contracted modes in A's order, grouped by the symmetries A and B share
+        std::vector<int32_t> mContractedModes;
+        SymmetricShape       mContracted;
+
+        // Dense plan of the full operands and the workspace that holds them, when the
+        // plan runs on a device
+        hiptensorContractionPlan_t mDensePlan;
+        uint64_t                   mWorkspaceSize;
+    };
+
+    // Packed layout of a symmetric descriptor. Groups must have two or more modes of
+    // one length, and no mode may be in two groups.
+    hiptensorStatus_t symmetricShape(hiptensorSymmetricTensorDescriptor_t const& desc,
+                                     SymmetricShape*                             shape);
+
+    // Number of elements of the full tensor of a shape; mElements counts the stored ones
+    std::size_t fullElements(SymmetricShape const& shape);
+
+    // Plans a contraction of packed tensors. Every mode appears in exactly two operands,
+    // with the same length in both.
+    hiptensorStatus_t planSymmetric(SymmetricContractionPlan*                   plan,
+                                    hiptensorSymmetricTensorDescriptor_t const& descA,
+                                    int32_t const                               modeA[],
+                                    hiptensorSymmetricTensorDescriptor_t const& descB,
+                                    int32_t const                               modeB[],
+                                    hiptensorSymmetricTensorDescriptor_t const& descD,
+                                    int32_t const                               modeD[],
+                                    hiptensorComputeType_t                      typeCompute,
+                                    bool                                        hasC);
+
+    // Runs a contraction of packed host operands on up to `threads` host threads (0 for
+    // one per hardware thread), computing only the stored elements of D. C is packed
+    // like D. f32 and f64 only.
+    hiptensorStatus_t symmetricContractionHost(SymmetricContractionPlan const& plan,
+                                               void const*                     alpha,
+                                               void const*                     A,
+                                               void const*                     B,
+                                               void const*                     beta,
+                                               void const*                     C,
+                                               void*                           D,
+                                               uint32_t                        threads);
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_CONTRACTION_SYMMETRIC_HPP
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef HIPTENSOR_SRC_DATA_LAYOUT_HPP
+#define HIPTENSOR_SRC_DATA_LAYOUT_HPP
+
+#include <cstddef>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    // Layout of descriptors that do not choose one, from HIPTENSOR_DATA_LAYOUT_COL_MAJOR
+#if HIPTENSOR_DATA_LAYOUT_COL_MAJOR
+    static constexpr hiptensorDataLayout_t DefaultDataLayout = HIPTENSOR_LAYOUT_COL_MAJOR;
+#else // HIPTENSOR_DATA_LAYOUT_COL_MAJOR
+    static constexpr hiptensorDataLayout_t DefaultDataLayout = HIPTENSOR_LAYOUT_ROW_MAJOR;
+#endif // HIPTENSOR_DATA_LAYOUT_COL_MAJOR
+
+    // Packed strides of the given lengths in the given layout
+    template <typename VecT>
+    static inline VecT stridesFromLengths(VecT const& lengths, hiptensorDataLayout_t layout)
+    {
+        auto strides = VecT(lengths.size());
+        auto stride  = typename VecT::value_type{1};
+        if(layout == HIPTENSOR_LAYOUT_DEFAULT)
+        {
+            layout = DefaultDataLayout;
+        }
+
+        for(std::size_t i = 0; i < lengths.size(); i++)
+        {
+            auto mode     = layout == HIPTENSOR_LAYOUT_COL_MAJOR ? i : lengths.size() - 1 - i;
+            strides[mode] = stride;
+            stride *= lengths[mode];
+        }
+        return strides;
+    }
+
+    // The layout whose packed strides the given strides are, ignoring length-1 modes.
+    // Strides packed in both layouts or in neither give HIPTENSOR_LAYOUT_DEFAULT.
+    template <typename VecT>
+    static inline hiptensorDataLayout_t layoutFromStrides(VecT const& lengths, VecT const& strides)
+    {
+        auto matches = [&lengths, &strides](hiptensorDataLayout_t layout) {
+            auto packed = stridesFromLengths(lengths, layout);
+            for(std::size_t i = 0; i < lengths.size(); i++)
+            {
+                if(lengths[i] > 1 && strides[i] != packed[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        auto rowMajor = matches(HIPTENSOR_LAYOUT_ROW_MAJOR);
+        auto colMajor = matches(HIPTENSOR_LAYOUT_COL_MAJOR);
+        if(rowMajor == colMajor)
+        {
+            return HIPTENSOR_LAYOUT_DEFAULT;
+        }
+        return rowMajor ? HIPTENSOR_LAYOUT_ROW_MAJOR : HIPTENSOR_LAYOUT_COL_MAJOR;
+    }
+
+    // The layout in which operations assuming packed storage address the descriptor
+    static inline hiptensorDataLayout_t layoutOf(hiptensorTensorDescriptor_t const& desc)
+    {
+        return desc.mLayout == HIPTENSOR_LAYOUT_DEFAULT ? DefaultDataLayout : desc.mLayout;
+    }
+
+    // Strides at which permutations address the elements of a descriptor. Descriptors
+    // initialized without strides and without a chosen layout are packed in the default
+    // layout of the build; all others are addressed through their own strides.
+    static inline hiptensorDimVector_t permutationStrides(hiptensorTensorDescriptor_t const& desc)
+    {
+        if(desc.mLayout == HIPTENSOR_LAYOUT_DEFAULT
+           && desc.mStrides == stridesFromLengths(desc.mLengths, HIPTENSOR_LAYOUT_ROW_MAJOR))
+        {
+            return stridesFromLengths(desc.mLengths, DefaultDataLayout);
+        }
+        return desc.mStrides;
+    }
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_SRC_DATA_LAYOUT_HPP
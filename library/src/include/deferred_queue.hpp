@@ -0,0 +1,129 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_DEFERRED_QUEUE_HPP
+#define HIPTENSOR_DEFERRED_QUEUE_HPP
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include <hip/hip_runtime_api.h>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    // Contractions below this many flops are coalesced with compatible neighbours
+    constexpr std::size_t DeferredSmallFlops = std::size_t(1) << 24;
+
+    // Upper bound on the operations of one grouped dispatch
+    constexpr std::size_t DeferredGroupSize = 64u;
+
+    /// Bytes of a buffer an operation touches, from its base to the end of the element
+    /// space of its tensor
+    struct DeferredRange
+    {
+        void const* mData;
+        std::size_t mBytes;
+
+        bool operator==(DeferredRange const& other) const;
+        bool operator!=(DeferredRange const& other) const;
+    };
+
+    // Range spanned by a tensor at data
+    DeferredRange deferredRange(void const* data, hiptensorTensorDescriptor_t const& desc);
+
+    /// Operation left in a handle's queue by a deferred hipTensor call. Besides the
+    /// launch itself it describes what the flush planner needs: the buffers read and
+    /// written, and what makes two operations compatible or redundant.
+    struct DeferredOperation
+    {
+        enum struct Kind
+        {
+            Contraction,
+            Permutation
+        };
+
+        Kind        mKind;
+        void const* mKernel; /*!< Kernel instance the operation runs */
+        hipStream_t mStream;
+        std::size_t mFlops; /*!< Work of the operation */
+
+        std::array<char, 32>       mScalars; /*!< Raw alpha and beta */
+        std::vector<DeferredRange> mReads;
+        std::vector<DeferredRange> mWrites;
+
+        // Permutations only
+        std::array<hiptensorTensorDescriptor_t, 2> mTensors; /*!< Source and destination */
+        std::array<std::vector<int32_t>, 2>        mModes;
+        double                                     mAlpha;
+
+        std::function<hiptensorStatus_t()> mLaunch;
+    };
+
+    /// Execution order of a flush: runs of consecutive operation indices, in
+    /// submission order, and the operations found redundant
+    struct DeferredPlan
+    {
+        std::vector<std::vector<std::size_t>> mGroups;
+        std::vector<bool>                     mElided;
+    };
+
+    // Whether one operation writes bytes the other reads or writes
+    bool deferredConflict(DeferredOperation const& lhs, DeferredOperation const& rhs);
+
+    // Whether two contractions can share a grouped dispatch: same kernel, stream and
+    // scalars, both small
+    bool deferredCompatible(DeferredOperation const& lhs, DeferredOperation const& rhs);
+
+    // Whether a permutation leaves its only buffer unchanged
+    bool deferredNoOp(DeferredOperation const& op);
+
+    // Whether second writes back exactly what first read, i.e. it inverts first
+    bool deferredInverse(DeferredOperation const& first, DeferredOperation const& second);
+
+    // Drops redundant permutations and gathers runs of consecutive compatible
+    // contractions into groups. Operations are never reordered.
+    DeferredPlan planDeferred(std::vector<DeferredOperation> const& operations);
+
+    /// Operations enqueued by a handle in deferred mode, run on flush
+    class DeferredQueue
+    {
+    public:
+        void        enqueue(DeferredOperation operation);
+        std::size_t size() const;
+
+        // Plans and runs the queued operations, leaving the queue empty
+        hiptensorStatus_t flush();
+
+    private:
+        std::vector<DeferredOperation> mOperations;
+    };
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_DEFERRED_QUEUE_HPP
@@ -0,0 +1,179 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_DEGENERATE_CONTRACTION_HPP
+#define HIPTENSOR_DEGENERATE_CONTRACTION_HPP
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include <hip/hip_runtime_api.h>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    // Degenerate contractions handle operands of up to this rank
+    constexpr uint32_t DegenerateMaxRank = HIPTENSOR_MAX_INLINE_RANK;
+
+    /// Contractions that are left with no M, N or K modes once length-1 modes are
+    /// squeezed out. GEMM tiles would mostly idle on them, so they run on elementwise
+    /// and reduction kernels bound by memory bandwidth instead.
+    enum struct ContractionShape : uint32_t
+    {
+        GENERAL, ///< M, N and K modes all remain, or the operands are not supported
+        SCALE, ///< No K, and A or B is one element: D = alpha * a * B + beta * C
+        OUTER, ///< No K: D[m, n] = alpha * A[m] * B[n] + beta * C[m, n]
+        DOT, ///< Only K: D = alpha * sum_k A[k] * B[k] + beta * C
+        GEMV, ///< No M or no N: D[x] = alpha * sum_k X[x, k] * v[k] + beta * C[x]
+    };
+
+    /// Contraction with its length-1 modes removed. Operands keep the orders
+    /// A = [M, K], B = [N, K] and C, D = [M, N] and the strides of the remaining modes.
+    struct SqueezedContraction
+    {
+        ContractionShape                    mShape;
+        hipDataType                         mType; /*!< Type of every operand */
+        bool                                mHasC; /*!< C is an operand */
+        std::size_t                         mRankM, mRankN, mRankK;
+        std::size_t                         mM, mN, mK; /*!< Products of the mode lengths */
+        std::array<hiptensorDimVector_t, 4> mLengths;
+        std::array<hiptensorDimVector_t, 4> mStrides;
+    };
+
+    // Squeezes the length-1 modes out of a contraction with rankM M modes and rankN N modes
+    // and classifies the remainder. C has NONE_TYPE when it is not an operand. Operands
+    // of mixed types or other than f32 and f64, empty extents and ranks beyond
+    // DegenerateMaxRank are left GENERAL.
+    SqueezedContraction squeezeContraction(std::array<hipDataType, 4> const&          types,
+                                           std::array<hiptensorDimVector_t, 4> const& lengths,
+                                           std::array<hiptensorDimVector_t, 4> const& strides,
+                                           std::size_t                                rankM,
+                                           std::size_t                                rankN);
+
+    char const* contractionShapeName(ContractionShape shape);
+
+    // Workspace in which DOT and GEMV reductions over long K modes keep the partial sums
+    // of K slices. With less workspace, K is split into fewer slices.
+    std::size_t degenerateWorkspaceSize(SqueezedContraction const& contraction);
+
+    /// Runs a contraction of any shape but GENERAL on the stream, directly on the strided
+    /// operands. Alpha and beta are of the operands' type in host memory. Without beta or
+    /// C the second term is dropped, and a zero beta does not read C.
+    hiptensorStatus_t degenerateContraction(SqueezedContraction const& contraction,
+                                            void const*                alpha,
+                                            void const*                A,
+                                            void const*                B,
+                                            void const*                beta,
+                                            void const*                C,
+                                            void*                      D,
+                                            void*                      workspace,
+                                            std::size_t                workspaceSize,
+                                            hipStream_t                stream);
+
+    /// Host implementation of degenerateContraction over host memory, for host backends
+    /// and reference checks. Rows of M are visited once, so an outer product reads A once
+    /// and scales each row of B by alpha * A[m].
+    template <typename DataT>
+    void degenerateContractionByCpu(SqueezedContraction const& contraction,
+                                    void const*                alpha,
+                                    DataT const*               A,
+                                    DataT const*               B,
+                                    void const*                beta,
+                                    DataT const*               C,
+                                    DataT*                     D)
+    {
+        using ComputeT = std::conditional_t<std::is_same_v<DataT, double>, double, float>;
+
+        auto const& lengths = contraction.mLengths;
+        auto const& strides = contraction.mStrides;
+        auto        rankM   = contraction.mRankM;
+        auto        rankN   = contraction.mRankN;
+        auto        rankK   = contraction.mRankK;
+
+        auto a = ComputeT(*static_cast<DataT const*>(alpha));
+        auto b = beta != nullptr && C != nullptr ? ComputeT(*static_cast<DataT const*>(beta))
+                                                 : ComputeT(0);
+
+        // Offset of flattened index i over `rank` modes from `first`, last mode fastest
+        auto offset = [](std::size_t                 i,
+                         hiptensorDimVector_t const& modeLengths,
+                         hiptensorDimVector_t const& modeStrides,
+                         std::size_t                 first,
+                         std::size_t                 rank) {
+            auto result = std::size_t{0};
+            for(auto mode = first + rank; mode-- > first;)
+            {
+                result += (i % modeLengths[mode]) * modeStrides[mode];
+                i /= modeLengths[mode];
+            }
+            return result;
+        };
+
+        for(std::size_t m = 0; m < contraction.mM; m++)
+        {
+            auto rowA = offset(m, lengths[0], strides[0], 0, rankM);
+            auto rowC = b != ComputeT(0) ? offset(m, lengths[3], strides[2], 0, rankM) : 0u;
+            auto rowD = offset(m, lengths[3], strides[3], 0, rankM);
+
+            // Without K, each row of D is a multiple of B
+            auto scaleA = rankK == 0 ? a * ComputeT(A[rowA]) : a;
+
+            for(std::size_t n = 0; n < contraction.mN; n++)
+            {
+                auto rowB = offset(n, lengths[1], strides[1], 0, rankN);
+
+                ComputeT value;
+                if(rankK == 0)
+                {
+                    value = scaleA * ComputeT(B[rowB]);
+                }
+                else
+                {
+                    auto sum = ComputeT(0);
+                    for(std::size_t k = 0; k < contraction.mK; k++)
+                    {
+                        auto offsetA = rowA + offset(k, lengths[0], strides[0], rankM, rankK);
+                        auto offsetB = rowB + offset(k, lengths[1], strides[1], rankN, rankK);
+                        sum += ComputeT(A[offsetA]) * ComputeT(B[offsetB]);
+                    }
+                    value = a * sum;
+                }
+
+                if(b != ComputeT(0))
+                {
+                    auto offsetC = rowC + offset(n, lengths[3], strides[2], rankM, rankN);
+                    value += b * ComputeT(C[offsetC]);
+                }
+                D[rowD + offset(n, lengths[3], strides[3], rankM, rankN)] = DataT(value);
+            }
+        }
+    }
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_DEGENERATE_CONTRACTION_HPP
@@ -0,0 +1,257 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_DESCRIPTOR_CACHE_HPP
+#define HIPTENSOR_DESCRIPTOR_CACHE_HPP
+
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+#include "degenerate_contraction.hpp"
+#include "performance.hpp"
+
+namespace hiptensor
+{
+    /// Immutable analysis of a tensor descriptor, shared by all equal descriptors
+    struct TensorSignature
+    {
+        hipDataType          mType;
+        hiptensorDimVector_t mLengths;
+        hiptensorDimVector_t mStrides;
+
+        std::size_t mHash; /*!< Hash of type, lengths and strides */
+        std::size_t mElements; /*!< Number of logical elements */
+        std::size_t mElementSpace; /*!< Number of elements spanned in memory */
+        std::size_t mBytes; /*!< Bytes spanned in memory */
+        bool        mBroadcast; /*!< A mode of length > 1 has stride 0 */
+        uint64_t    mGeneration; /*!< Unique to this record across all caches */
+
+        bool matches(hiptensorTensorDescriptor_t const& desc) const;
+    };
+
+    /// Immutable analysis of a contraction descriptor, shared by all equal descriptors
+    struct ContractionSignature
+    {
+        // Interned A, B, C and D signatures. Equality of operands is pointer equality.
+        std::array<TensorSignature const*, 4> mTensors;
+
+        int32_t                 mContractionOpId;
+        hiptensorComputeType_t  mComputeType;
+        std::array<uint32_t, 4> mAlignmentReq;
+
+        std::size_t mHash; /*!< Combined hash of the operands and contraction parameters */
+        std::size_t mM; /*!< Product of the M mode lengths */
+        std::size_t mN; /*!< Product of the N mode lengths */
+        std::size_t mK; /*!< Product of the K mode lengths */
+        std::size_t mBytes; /*!< Total bytes spanned by A, B, C and D */
+        std::size_t mFlops; /*!< Multiply-add count of the contraction, 2 * M * N * K */
+        ProblemMetrics mMetrics; /*!< Saturating 64-bit counts behind the sizes above */
+        uint32_t    mVectorWidth; /*!< Widest vector access legal for every operand */
+        uint64_t    mGeneration; /*!< Unique to this record across all caches */
+
+        // Kernels load each operand along its innermost M, N or K mode, which must have
+        // unit stride. Operands without one are staged through a packed workspace copy.
+        std::array<bool, 4>                 mStaged;
+        std::array<hiptensorDimVector_t, 4> mKernelStrides; /*!< Strides seen by the kernels */
+        std::array<std::size_t, 4>          mStagingOffsets; /*!< Workspace offset of each copy */
+        std::size_t                         mStagingBytes; /*!< Workspace taken by staged copies */
+
+        // Multi-output contractions of one A against several B, C and D operands of equal
+        // layouts. The kernels see the outputs concatenated along the outermost N mode in
+        // staged copies; mTensors holds the concatenated views.
+        uint32_t                              mOutputs; /*!< Number of outputs, 1 unless fused */
+        std::array<TensorSignature const*, 4> mOutputTensors; /*!< A and each B, C and D */
+        std::array<std::size_t, 4>            mOutputOffsets; /*!< Offsets between outputs */
+
+        // Kernels index operands with 32-bit offsets. Larger problems are split into a grid
+        // of partitions along the outermost M and N modes, each small enough to index.
+        std::size_t mRankM; /*!< Number of M modes */
+        std::size_t mRankN; /*!< Number of N modes */
+        std::size_t mOuterM; /*!< Length of the outermost M mode, 1 if there is none */
+        std::size_t mOuterN; /*!< Length of the outermost N mode, 1 if there is none */
+        std::size_t mPartitionM; /*!< Outermost M extent of each partition */
+        std::size_t mPartitionN; /*!< Outermost N extent of each partition */
+        std::size_t mPartitions; /*!< Number of partitions, 0 if the problem cannot be split */
+
+        // Operands without their length-1 modes. Single-output contractions left without
+        // M, N or K modes skip the GEMM kernels, as classified by mSqueezed.mShape.
+        SqueezedContraction mSqueezed;
+
+        // Outermost M start, M extent, N start and N extent of partition index.
+        // Partitions are ordered with N fastest.
+        std::array<std::size_t, 4> partitionBounds(std::size_t index) const;
+
+        // Lengths of A, B, C and D for a partition of the given outermost M and N extents
+        std::array<hiptensorDimVector_t, 4> partitionLengths(std::size_t extentM,
+                                                             std::size_t extentN) const;
+
+        // Element offsets into the kernel views of A, B, C and D of the partition
+        // starting at the given outermost M and N indices
+        std::array<std::size_t, 4> partitionOffsets(std::size_t startM, std::size_t startN) const;
+
+        // Whether the outputs' operands i at the given addresses already lie side by side
+        // in the concatenated kernel view, so that kernels read or write them in place
+        bool concatenatedInPlace(int i, void const* const operands[]) const;
+
+        // Descriptor equal to the one this record was interned from
+        bool matches(hiptensorContractionDescriptor_t const& desc) const;
+
+        // Keeps the records in mTensors and mOutputTensors alive while this one is
+        std::vector<std::shared_ptr<TensorSignature const>> mTensorRefs;
+    };
+
+    /// Per-handle table of interned descriptor signatures and selected plans.
+    /// Each kind of entry is capped, evicting the least recently used beyond the cap in
+    /// constant time. Tensors referenced by a cached contraction are not evicted.
+    /// A record returned by intern or signature stays valid until capacity newer records
+    /// of its kind have been created; holders that outlive the call retain it.
+    class DescriptorCache
+    {
+    public:
+        static constexpr std::size_t DefaultCapacity = 4096u;
+
+        explicit DescriptorCache(std::size_t capacity = DefaultCapacity);
+        ~DescriptorCache() = default;
+
+        DescriptorCache(DescriptorCache const&)            = delete;
+        DescriptorCache& operator=(DescriptorCache const&) = delete;
+
+        // Returns the shared record equal to desc, creating it on first use
+        TensorSignature const*      intern(hiptensorTensorDescriptor_t const& desc);
+        ContractionSignature const* intern(hiptensorContractionDescriptor_t const& desc);
+
+        // Interns desc and stores the record and its generation in it
+        void bind(hiptensorTensorDescriptor_t& desc);
+        void bind(hiptensorContractionDescriptor_t& desc);
+
+        // Returns the record bound to desc if it is still cached under the generation
+        // desc was bound with, otherwise interns the descriptor contents. Descriptors
+        // whose contents change after binding must be bound again.
+        TensorSignature const*      signature(hiptensorTensorDescriptor_t const& desc);
+        ContractionSignature const* signature(hiptensorContractionDescriptor_t const& desc);
+
+        // Shared ownership of a record of this cache, which then survives its eviction
+        std::shared_ptr<ContractionSignature const>
+            retain(ContractionSignature const* signature) const;
+
+        bool owns(TensorSignature const* signature) const;
+        bool owns(ContractionSignature const* signature) const;
+
+        // Plan cache keyed by the interned contraction, selection algorithm, workspace size,
+        // selection policy and the candidates the selection was made from
+        void* findPlan(ContractionSignature const* signature,
+                       hiptensorAlgo_t             algo,
+                       uint64_t                    workspaceSize,
+                       SelectionPolicy const&      policy     = {},
+                       std::vector<void*> const&   candidates = {});
+        void  cachePlan(ContractionSignature const* signature,
+                        hiptensorAlgo_t             algo,
+                        uint64_t                    workspaceSize,
+                        void*                       solution,
+                        SelectionPolicy const&      policy     = {},
+                        std::vector<void*> const&   candidates = {});
+
+        std::size_t tensorCount() const;
+        std::size_t contractionCount() const;
+        std::size_t planCount() const;
+        std::size_t planHits() const;
+
+    private:
+        // Links of the least recently used lists, most recent first. An unlinked entry
+        // points to itself.
+        struct LruLink
+        {
+            LruLink* mPrev = this;
+            LruLink* mNext = this;
+        };
+
+        struct Plan;
+
+        struct Record : LruLink
+        {
+            std::shared_ptr<void const> mRecord;
+            std::size_t                 mHash        = 0;
+            bool                        mContraction = false;
+            std::size_t                 mPins        = 0; /*!< Cached contractions using it */
+            std::vector<Plan*>          mPlans; /*!< Plans selected for a contraction */
+        };
+
+        // Callers must hold mMutex
+        TensorSignature const* internTensor(hiptensorTensorDescriptor_t const& desc);
+        TensorSignature const* cachedTensor(hiptensorTensorDescriptor_t const& desc);
+        Record const*          bound(void const* signature, uint64_t generation) const;
+        void                   touch(void const* record);
+        void                   evict();
+        void                   eraseRecord(Record* record);
+        void                   erasePlan(Plan* plan);
+
+        static void unlink(LruLink* link);
+        static void pushFront(LruLink& list, LruLink* link);
+
+        using PlanKey = std::tuple<ContractionSignature const*,
+                                   int32_t,
+                                   uint64_t,
+                                   decltype(SelectionPolicy{}.key()),
+                                   std::vector<void*>>;
+
+        // Plan lookups compare against the caller's candidates without copying them
+        using PlanKeyRef = std::tuple<ContractionSignature const*,
+                                      int32_t,
+                                      uint64_t,
+                                      decltype(SelectionPolicy{}.key()),
+                                      std::vector<void*> const&>;
+
+        struct Plan : LruLink
+        {
+            void*          mSolution = nullptr;
+            PlanKey const* mKey      = nullptr;
+            Record*        mOwner    = nullptr;
+            std::size_t    mIndex    = 0; /*!< Position in mOwner->mPlans */
+        };
+
+        mutable std::mutex mMutex;
+
+        std::size_t                                                       mCapacity;
+        LruLink                                                           mTensorLru;
+        LruLink                                                           mContractionLru;
+        LruLink                                                           mPlanLru;
+        std::unordered_multimap<std::size_t, TensorSignature const*>      mTensors;
+        std::unordered_multimap<std::size_t, ContractionSignature const*> mContractions;
+        std::unordered_map<void const*, Record>                           mOwned;
+        std::map<PlanKey, Plan, std::less<>>                              mPlans;
+        std::size_t                                                       mPlanHits = 0;
+    };
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_DESCRIPTOR_CACHE_HPP
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_GRAPH_HPP
+#define HIPTENSOR_GRAPH_HPP
+
+#include <functional>
+#include <vector>
+
+#include <hip/hip_runtime_api.h>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    /// Sequence of hipTensor operations recorded while a handle is capturing. Every
+    /// distinct buffer the operations touch becomes a binding, numbered in order of
+    /// first use. Replay runs the recorded launches in order against new base pointers
+    /// for any of the bindings, skipping the validation, logging and plan lookup of
+    /// the original calls.
+    class Graph
+    {
+    public:
+        // Launches one recorded operation on its resolved buffers
+        using Launch
+            = std::function<hiptensorStatus_t(std::vector<void*> const& buffers, hipStream_t)>;
+
+        Graph() = default;
+        ~Graph();
+
+        Graph(Graph const&)            = delete;
+        Graph& operator=(Graph const&) = delete;
+
+        // Records an operation on the given buffers; nullptr buffers are not bound
+        void record(std::vector<void const*> const& buffers, Launch launch);
+
+        std::size_t bindings() const;
+        std::size_t operations() const;
+
+        // Buffers of every binding, with nullptr or missing entries keeping the
+        // pointer captured for that binding
+        std::vector<void*> resolve(void const* const* bindings, std::size_t count) const;
+
+        // Runs the operations in order on the host thread
+        hiptensorStatus_t
+            replay(void const* const* bindings, std::size_t count, hipStream_t stream);
+
+        // Replays through a HIP graph captured from the stream. The instantiated graph
+        // is kept and relaunched directly for as long as the bindings stay the same.
+        hiptensorStatus_t
+            launch(void const* const* bindings, std::size_t count, hipStream_t stream);
+
+    private:
+        struct Operation
+        {
+            std::vector<int32_t> mBindings; /*!< Binding of each buffer, -1 for nullptr */
+            Launch               mLaunch;
+        };
+
+        hiptensorStatus_t run(std::vector<void*> const& buffers, hipStream_t stream) const;
+
+        std::vector<void*>     mBindings; /*!< Captured pointer of each binding */
+        std::vector<Operation> mOperations;
+        hipGraphExec_t         mExec = nullptr;
+        std::vector<void*>     mExecBindings; /*!< Bindings mExec was captured with */
+    };
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_GRAPH_HPP
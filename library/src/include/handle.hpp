@@ -27,29 +27,101 @@
 #ifndef HIPTENSOR_HANDLE_HPP
 #define HIPTENSOR_HANDLE_HPP
 
+#include <memory>
 #include <new>
+#include <vector>
 
 #include <hip/hip_runtime_api.h>
 
+#include "deferred_queue.hpp"
+#include "descriptor_cache.hpp"
+#include "graph.hpp"
 #include "hip_device.hpp"
+#include "workspace_pool.hpp"
 
 namespace hiptensor
 {
+    /// State a handle keeps for each of its devices: the device properties, the
+    /// solutions it can run, its interned descriptors and plans, its workspace and
+    /// the stream that multi-device contractions issue its work on
+    class DeviceContext
+    {
+    public:
+        explicit DeviceContext(hipDevice_t deviceId);
+        ~DeviceContext();
+
+        DeviceContext(DeviceContext const&)            = delete;
+        DeviceContext& operator=(DeviceContext const&) = delete;
+
+        HipDevice const& getDevice() const;
+        DescriptorCache& getDescriptorCache();
+        WorkspacePool&   getWorkspacePool();
+
+        // Contraction solutions supported by the device, gathered by its first
+        // multi-device contraction
+        std::vector<void*>& getCandidates();
+
+        // Created on first use, on the device
+        hipStream_t getStream();
+
+    private:
+        HipDevice          mDevice;
+        DescriptorCache    mDescriptorCache;
+        WorkspacePool      mWorkspacePool;
+        std::vector<void*> mCandidates;
+        hipStream_t        mStream = nullptr;
+    };
+
     // hiptensorHandle_t wrapper object
     struct Handle
     {
     public:
-        Handle()  = default;
+        Handle();
+        explicit Handle(std::vector<hipDevice_t> const& deviceIds);
         ~Handle() = default;
 
-        static Handle  createHandle(int64_t* buff); // Calls constructor for all member variables
+        Handle(Handle const&)            = delete;
+        Handle& operator=(Handle const&) = delete;
+
+        static Handle* createHandle(int64_t* buff); // Calls constructor for all member variables
+        static Handle* createHandle(int64_t*                        buff,
+                                    std::vector<hipDevice_t> const& deviceIds);
         static void    destroyHandle(int64_t* buff); // Calls destructor for all member variables
         static Handle* toHandle(int64_t* buff); // Reinterprets input buffer as Handle class
 
-        HipDevice getDevice();
+        // The first device of the handle, on which single-device operations run
+        HipDevice        getDevice();
+        DescriptorCache& getDescriptorCache();
+        WorkspacePool&   getWorkspacePool();
+
+        // Unique among the handles of the process; ids are never reused
+        uint64_t getId() const;
+
+        // Every device of the handle, the first being the one above
+        uint32_t       getDeviceCount() const;
+        DeviceContext& getDeviceContext(uint32_t index);
+
+        // Where operations issued on the handle read alpha and beta
+        hiptensorPointerMode_t getPointerMode() const;
+        void                   setPointerMode(hiptensorPointerMode_t mode);
+
+        // Operations issued between beginCapture and endCapture are recorded into
+        // the capture graph instead of being launched
+        void                   beginCapture();
+        Graph*                 getCapture();
+        std::unique_ptr<Graph> endCapture();
+
+        // Operations issued in deferred mode wait in the queue until flushed
+        void                           beginDeferred();
+        DeferredQueue*                 getDeferred();
+        std::unique_ptr<DeferredQueue> endDeferred();
 
     private:
-        HipDevice mDevice;
+        std::vector<std::unique_ptr<DeviceContext>> mDevices;
+        std::unique_ptr<Graph>                      mCapture;
+        std::unique_ptr<DeferredQueue>              mDeferred;
+        hiptensorPointerMode_t                      mPointerMode = HIPTENSOR_POINTER_MODE_HOST;
+        uint64_t                                    mId;
     };
 } // namespace hiptensor
 
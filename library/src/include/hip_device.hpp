@@ -51,6 +51,7 @@ namespace hiptensor
         };
 
         HipDevice();
+        explicit HipDevice(hipDevice_t deviceId);
         ~HipDevice() = default;
 
         hipDevice_t     getDeviceId() const;
@@ -27,8 +27,14 @@
 #ifndef HIPTENSOR_PERFORMANCE_HPP
 #define HIPTENSOR_PERFORMANCE_HPP
 
+#include <array>
+#include <cstdint>
 #include <ostream>
 #include <string>
+#include <tuple>
+#include <vector>
+
+#include <hiptensor/hiptensor_types.hpp>
 
 namespace hiptensor
 {
@@ -47,6 +53,81 @@ namespace hiptensor
         bool operator==(PerfMetrics const& other) const;
     };
 
+    /// Sizes of a problem in 64-bit counts. Counts that do not fit in 64 bits saturate
+    /// at UINT64_MAX instead of wrapping, and mark the metrics as saturated.
+    struct ProblemMetrics
+    {
+        uint64_t                mM, mN, mK; /*!< Products of the M, N and K mode lengths */
+        uint64_t                mFlops; /*!< Floating-point operations, 2 * M * N * K */
+        std::array<uint64_t, 4> mOperandBytes; /*!< Bytes spanned by A, B, C and D */
+        uint64_t                mBytes; /*!< Bytes spanned by all operands */
+        bool                    mSaturated; /*!< Some count exceeded 64 bits */
+
+        // Throughput of a run of timeMs in Tflop/s and GB/s, 0 for a zero time
+        double tflops(float timeMs) const;
+        double bandwidth(float timeMs) const;
+    };
+
+    // a + b and a * b, saturating at UINT64_MAX and setting *saturated when they do
+    uint64_t saturatingAdd(uint64_t a, uint64_t b, bool* saturated = nullptr);
+    uint64_t saturatingMultiply(uint64_t a, uint64_t b, bool* saturated = nullptr);
+
+    // Elements of a tensor, and elements spanned by its strides with length-0 modes
+    // skipped, as elementsFromLengths and elementSpaceFromLengthsAndStrides but saturated
+    uint64_t elementCount(hiptensorDimVector_t const& lengths, bool* saturated = nullptr);
+    uint64_t elementSpace(hiptensorDimVector_t const& lengths,
+                          hiptensorDimVector_t const& strides,
+                          bool*                       saturated = nullptr);
+
+    // Metrics of a contraction of A = [M, K], B = [N, K] and C, D = [M, N] with rankM M
+    // and rankN N modes. Operand bytes cover the strided element space of each operand;
+    // C has NONE_TYPE when it is not an operand.
+    ProblemMetrics contractionMetrics(std::array<hipDataType, 4> const&          types,
+                                      std::array<hiptensorDimVector_t, 4> const& lengths,
+                                      std::array<hiptensorDimVector_t, 4> const& strides,
+                                      std::size_t                                rankM,
+                                      std::size_t                                rankN);
+
+    // Metrics of a permutation that reads and writes `elements` of elementBytes each,
+    // counted as two operations per element
+    ProblemMetrics permutationMetrics(uint64_t elements, uint64_t elementBytes);
+
+    // Performance of one run of a kernel on a problem
+    PerfMetrics perfMetrics(std::size_t           kernelUid,
+                            std::string const&    kernelName,
+                            float                 timeMs,
+                            ProblemMetrics const& problem);
+
+    /// How plan selection ranks the candidates it measures
+    struct SelectionPolicy
+    {
+        hiptensorSelectionPolicy_t mPolicy = HIPTENSOR_SELECTION_FASTEST;
+        uint64_t mWorkspaceCap = UINT64_MAX; /*!< Largest kernel workspace to consider */
+        float    mTolerance    = 0.0f; /*!< Accepted relative slowdown from the fastest */
+
+        // Policy of the plans initialized from find
+        static SelectionPolicy of(hiptensorContractionFind_t const& find);
+
+        // The fastest candidate wins regardless of its workspace
+        bool isDefault() const;
+
+        auto key() const
+        {
+            return std::make_tuple(static_cast<int32_t>(mPolicy), mWorkspaceCap, mTolerance);
+        }
+    };
+
+    /// A measured candidate
+    struct SelectionSample
+    {
+        PerfMetrics mMetrics;
+        uint64_t    mWorkspaceSize; /*!< Kernel workspace of the candidate */
+        uint64_t    mProblemBytes; /*!< Bytes spanned by the operands */
+    };
+
+    // Index of the sample that policy selects, or -1 if none fits the workspace cap
+    int selectSample(std::vector<SelectionSample> const& samples, SelectionPolicy const& policy);
+
 } // namespace hiptensor
 
 namespace std
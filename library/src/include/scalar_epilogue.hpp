@@ -0,0 +1,111 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_SCALAR_EPILOGUE_HPP
+#define HIPTENSOR_SCALAR_EPILOGUE_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include <hip/hip_runtime_api.h>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    // Epilogues handle tensors of up to this rank
+    constexpr uint32_t ScalarEpilogueMaxRank = HIPTENSOR_MAX_INLINE_RANK;
+
+    // Arithmetic type of an epilogue with scalars of ScalarT
+    template <typename ScalarT>
+    using EpilogueComputeT = std::conditional_t<std::is_same_v<ScalarT, double>, double, float>;
+
+    /// Applies D = alpha * P + beta * C element-wise over tensors of the given lengths,
+    /// on the stream. Alpha and beta of scalarType are read from device memory by the
+    /// kernel, so they may be written by earlier work on the stream. P is laid out like
+    /// D and may be D itself. Without beta or C the second term is dropped, and a zero
+    /// beta does not read C.
+    hiptensorStatus_t applyScalars(void const*                 alpha,
+                                   void const*                 beta,
+                                   hipDataType                 scalarType,
+                                   void const*                 P,
+                                   void const*                 C,
+                                   hiptensorDimVector_t const& cStrides,
+                                   void*                       D,
+                                   hiptensorDimVector_t const& dStrides,
+                                   hiptensorDimVector_t const& lengths,
+                                   hipDataType                 type,
+                                   hipStream_t                 stream);
+
+    /// Host implementation of applyScalars over host memory, for host backends and
+    /// reference checks
+    template <typename DataT, typename ScalarT>
+    void applyScalarsByCpu(ScalarT const*              alpha,
+                           ScalarT const*              beta,
+                           DataT const*                P,
+                           DataT const*                C,
+                           hiptensorDimVector_t const& cStrides,
+                           DataT*                      D,
+                           hiptensorDimVector_t const& dStrides,
+                           hiptensorDimVector_t const& lengths)
+    {
+        using ComputeT = EpilogueComputeT<ScalarT>;
+
+        auto a = ComputeT(*alpha);
+        auto b = beta != nullptr && C != nullptr ? ComputeT(*beta) : ComputeT(0);
+
+        auto count = std::size_t{1};
+        for(auto length : lengths)
+        {
+            count *= length;
+        }
+
+        for(std::size_t i = 0; i < count; i++)
+        {
+            // Last mode fastest, as in the device kernel
+            auto rest    = i;
+            auto cOffset = std::size_t{0};
+            auto dOffset = std::size_t{0};
+            for(auto mode = lengths.size(); mode-- > 0;)
+            {
+                auto index = rest % lengths[mode];
+                rest /= lengths[mode];
+                dOffset += index * dStrides[mode];
+                cOffset += b != ComputeT(0) ? index * cStrides[mode] : 0u;
+            }
+
+            auto value = a * ComputeT(P[dOffset]);
+            if(b != ComputeT(0))
+            {
+                value += b * ComputeT(C[cOffset]);
+            }
+            D[dOffset] = DataT(value);
+        }
+    }
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_SCALAR_EPILOGUE_HPP
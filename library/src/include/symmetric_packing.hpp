@@ -0,0 +1,203 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_SYMMETRIC_PACKING_HPP
+#define HIPTENSOR_SYMMETRIC_PACKING_HPP
+
+#include <cstddef>
+
+#include <hip/hip_runtime.h>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+#include "config.hpp"
+
+namespace hiptensor
+{
+    // Packed tensors have up to this many modes
+    constexpr uint32_t SymmetricMaxRank = HIPTENSOR_MAX_INLINE_RANK;
+
+    /// Packed layout of a tensor with symmetry groups, passed to kernels by value.
+    ///
+    /// The modes of a group share one packed index over the sorted tuples of their
+    /// indices, placed at the group's first mode: tuples that do not increase along
+    /// the group's modes for a symmetric group, and that strictly decrease for an
+    /// antisymmetric one. Packed indices are numbered in colexicographic order, so
+    /// that two modes are stored as a row-major lower triangle. Other modes keep their
+    /// own index, and the packed indices are laid out with the last one fastest.
+    struct SymmetricShape
+    {
+        uint32_t    mRank;
+        std::size_t mLengths[SymmetricMaxRank];
+        std::size_t mStrides[SymmetricMaxRank]; /*!< Packed strides of the leading modes */
+        int32_t     mGroup[SymmetricMaxRank]; /*!< Group of each mode, or -1 */
+        bool        mLeads[SymmetricMaxRank]; /*!< Free modes and first modes of groups */
+        bool        mAntisymmetric[SymmetricMaxRank]; /*!< Kind of each group */
+        std::size_t mElements; /*!< Stored elements */
+    };
+
+    // Number of ways to choose k of n
+    HIPTENSOR_HOST_DEVICE inline std::size_t choose(std::size_t n, std::size_t k)
+    {
+        if(k > n)
+        {
+            return 0;
+        }
+
+        std::size_t result = 1;
+        for(std::size_t i = 1; i <= k; i++)
+        {
+            result = result * (n - k + i) / i;
+        }
+        return result;
+    }
+
+    /// Offset in packed storage of the element at a full index, and the sign it is
+    /// stored with: -1 when an odd permutation sorts an antisymmetric group, 0 when
+    /// the element is zero because an antisymmetric group repeats an index. canonical
+    /// is set when the index is already sorted, i.e. names the stored element itself.
+    HIPTENSOR_HOST_DEVICE inline int symmetricOffset(SymmetricShape const& shape,
+                                                     std::size_t const*    index,
+                                                     std::size_t*          offset,
+                                                     bool*                 canonical)
+    {
+        int sign   = 1;
+        *offset    = 0;
+        *canonical = true;
+        for(uint32_t mode = 0; mode < shape.mRank; mode++)
+        {
+            if(!shape.mLeads[mode])
+            {
+                continue;
+            }
+
+            auto group = shape.mGroup[mode];
+            if(group < 0)
+            {
+                *offset += index[mode] * shape.mStrides[mode];
+                continue;
+            }
+
+            // Sort the group's indices into decreasing order, counting the swaps
+            std::size_t sorted[SymmetricMaxRank];
+            uint32_t    k     = 0;
+            uint32_t    swaps = 0;
+            for(uint32_t m = mode; m < shape.mRank; m++)
+            {
+                if(shape.mGroup[m] != group)
+                {
+                    continue;
+                }
+
+                auto j = k++;
+                for(; j > 0 && sorted[j - 1] < index[m]; j--)
+                {
+                    sorted[j] = sorted[j - 1];
+                    swaps++;
+                }
+                sorted[j] = index[m];
+            }
+
+            auto antisymmetric = shape.mAntisymmetric[group];
+            auto rank          = std::size_t{0};
+            for(uint32_t j = 0; j < k; j++)
+            {
+                if(antisymmetric && j > 0 && sorted[j] == sorted[j - 1])
+                {
+                    return 0;
+                }
+                rank += choose(sorted[j] + (antisymmetric ? 0 : k - 1 - j), k - j);
+            }
+
+            *offset += rank * shape.mStrides[mode];
+            *canonical &= swaps == 0;
+            if(antisymmetric && swaps % 2 == 1)
+            {
+                sign = -sign;
+            }
+        }
+        return sign;
+    }
+
+    /// Writes the full tensor of a packed one, packed with the last mode fastest, on
+    /// the stream
+    hiptensorStatus_t expandSymmetric(SymmetricShape const& shape,
+                                      void const*           packed,
+                                      void*                 dense,
+                                      hipDataType           type,
+                                      hipStream_t           stream);
+
+    /// Writes the stored elements of a full tensor, packed with the last mode fastest,
+    /// into packed storage, on the stream. Only sorted indices are read, so the other
+    /// elements need not respect the symmetry.
+    hiptensorStatus_t compressSymmetric(SymmetricShape const& shape,
+                                        void const*           dense,
+                                        void*                 packed,
+                                        hipDataType           type,
+                                        hipStream_t           stream);
+
+    /// Host implementation of expandSymmetric and, with compress set, of
+    /// compressSymmetric, for host backends and reference checks
+    template <typename DataT>
+    void packSymmetricByCpu(SymmetricShape const& shape,
+                            DataT const*          src,
+                            DataT*                dst,
+                            bool                  compress)
+    {
+        auto count = std::size_t{1};
+        for(uint32_t mode = 0; mode < shape.mRank; mode++)
+        {
+            count *= shape.mLengths[mode];
+        }
+
+        std::size_t index[SymmetricMaxRank];
+        for(std::size_t i = 0; i < count; i++)
+        {
+            // Last mode fastest, as in the device kernels
+            auto rest = i;
+            for(auto mode = shape.mRank; mode-- > 0;)
+            {
+                index[mode] = rest % shape.mLengths[mode];
+                rest /= shape.mLengths[mode];
+            }
+
+            std::size_t offset;
+            bool        canonical;
+            auto        sign = symmetricOffset(shape, index, &offset, &canonical);
+            if(compress && canonical && sign != 0)
+            {
+                dst[offset] = src[i];
+            }
+            else if(!compress)
+            {
+                dst[i] = sign == 0 ? DataT(0) : sign < 0 ? DataT(-src[offset]) : src[offset];
+            }
+        }
+    }
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_SYMMETRIC_PACKING_HPP
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_TENSOR_FILE_HPP
+#define HIPTENSOR_TENSOR_FILE_HPP
+
+#include <string>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    /// Tensor stored on disk with its descriptor. The file holds a fixed header,
+    /// the lengths and strides, and the element space starting on a page boundary,
+    /// so that the data can be mapped and used in place.
+    class MappedTensorFile
+    {
+    public:
+        MappedTensorFile() = default;
+        ~MappedTensorFile();
+
+        MappedTensorFile(MappedTensorFile const&)            = delete;
+        MappedTensorFile& operator=(MappedTensorFile const&) = delete;
+
+        // Writes desc and its element space to path. A null data writes zeros.
+        static hiptensorStatus_t write(std::string const&                 path,
+                                       hiptensorTensorDescriptor_t const& desc,
+                                       void const*                        data);
+
+        // Maps the file at path, read-only unless writable is set. The kernel's
+        // own read-ahead is turned off in favour of willNeed() hints.
+        hiptensorStatus_t open(std::string const& path, bool writable = false);
+        void              close();
+
+        hiptensorTensorDescriptor_t const& descriptor() const;
+        void*                              data() const;
+        std::size_t                        bytes() const;
+
+        // Read-ahead and release hints for a byte range of the data
+        void willNeed(std::size_t offset, std::size_t bytes) const;
+        void dontNeed(std::size_t offset, std::size_t bytes) const;
+
+    private:
+        hiptensorTensorDescriptor_t mDesc       = {};
+        void*                       mMapping    = nullptr;
+        std::size_t                 mMapBytes   = 0;
+        std::size_t                 mDataOffset = 0;
+        std::size_t                 mDataBytes  = 0;
+    };
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_TENSOR_FILE_HPP
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef HIPTENSOR_TRANSPORT_HPP
+#define HIPTENSOR_TRANSPORT_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include <hiptensor/hiptensor_types.hpp>
+
+namespace hiptensor
+{
+    /// Point-to-point messaging between the ranks of a distributed operation. Transfers
+    /// are started without blocking and complete in wait(), after which their buffer may
+    /// be reused. Messages between two ranks with the same tag arrive in send order.
+    class Transport
+    {
+    public:
+        using Request = void*;
+
+        virtual ~Transport() = default;
+
+        virtual uint32_t rank() const = 0;
+        virtual uint32_t size() const = 0;
+
+        virtual hiptensorStatus_t send(uint32_t    peer,
+                                       uint32_t    tag,
+                                       void const* buffer,
+                                       std::size_t bytes,
+                                       Request*    request)
+            = 0;
+        virtual hiptensorStatus_t
+            receive(uint32_t peer, uint32_t tag, void* buffer, std::size_t bytes, Request* request)
+            = 0;
+        virtual hiptensorStatus_t wait(Request request) = 0;
+    };
+
+    /// Forwards to the callbacks of a user transport
+    class CallbackTransport : public Transport
+    {
+    public:
+        explicit CallbackTransport(hiptensorTransport_t const& transport);
+
+        uint32_t rank() const override;
+        uint32_t size() const override;
+
+        hiptensorStatus_t send(uint32_t    peer,
+                               uint32_t    tag,
+                               void const* buffer,
+                               std::size_t bytes,
+                               Request*    request) override;
+        hiptensorStatus_t receive(uint32_t    peer,
+                                  uint32_t    tag,
+                                  void*       buffer,
+                                  std::size_t bytes,
+                                  Request*    request) override;
+        hiptensorStatus_t wait(Request request) override;
+
+    private:
+        hiptensorTransport_t mTransport;
+    };
+
+    /// Ranks of one process exchanging messages through shared memory, e.g. one rank per
+    /// thread. Sends are buffered, so they complete at once; receives complete in wait()
+    /// once the matching message has been sent. Payloads are moved with `copy`, which may
+    /// be given a device-aware copy for device buffers.
+    class InProcessFabric
+    {
+    public:
+        using Copy = std::function<void(void*, void const*, std::size_t)>;
+
+        explicit InProcessFabric(uint32_t ranks, Copy copy = nullptr);
+        ~InProcessFabric();
+
+        Transport& transport(uint32_t rank);
+
+        // Payload bytes sent by a rank
+        std::size_t sentBytes(uint32_t rank) const;
+
+    private:
+        class Endpoint;
+        struct PendingReceive;
+
+        // Messages are queued by (source, destination, tag)
+        using Key = std::tuple<uint32_t, uint32_t, uint32_t>;
+
+        hiptensorStatus_t post(Key const& key, void const* buffer, std::size_t bytes);
+        hiptensorStatus_t complete(PendingReceive* pending);
+
+        Copy                                         mCopy;
+        std::vector<std::unique_ptr<Endpoint>>       mEndpoints;
+        std::vector<std::size_t>                     mSentBytes;
+        std::map<Key, std::deque<std::vector<char>>> mMailboxes;
+        mutable std::mutex                           mMutex;
+        std::condition_variable                      mArrived;
+    };
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_TRANSPORT_HPP
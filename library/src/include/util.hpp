@@ -27,6 +27,9 @@
 #ifndef HIPTENSOR_SRC_UTIL_HPP
 #define HIPTENSOR_SRC_UTIL_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
 #include <type_traits>
 #include <vector>
 
@@ -41,32 +44,36 @@ namespace hiptensor
         return (numerator + divisor - 1) / divisor;
     }
 
-    template <typename T>
-    static inline std::vector<T> stridesFromLengths(std::vector<T> const& lengths)
+    template <typename VecT>
+    static inline VecT stridesFromLengths(VecT const& lengths)
     {
+        using T = typename VecT::value_type;
+
         if(lengths.empty())
         {
             return lengths;
         }
 
         // Re-construct strides from lengths, assuming packed.
-        std::vector<std::size_t> strides(lengths.size());
+        VecT strides(lengths.size());
         strides.back() = 1;
         std::partial_sum(
             lengths.rbegin(), lengths.rend() - 1, strides.rbegin() + 1, std::multiplies<T>());
         return strides;
     }
 
-    template <typename T>
-    static inline T elementsFromLengths(std::vector<T> const& lengths)
+    template <typename VecT>
+    static inline typename VecT::value_type elementsFromLengths(VecT const& lengths)
     {
+        using T = typename VecT::value_type;
         return std::accumulate(lengths.begin(), lengths.end(), T{1}, std::multiplies<T>());
     }
 
-    template <typename T>
-    static inline T elementSpaceFromLengthsAndStrides(std::vector<T> const& lengths,
-                                                      std::vector<T> const& strides)
+    template <typename VecT>
+    static inline typename VecT::value_type elementSpaceFromLengthsAndStrides(VecT const& lengths,
+                                                                              VecT const& strides)
     {
+        using T    = typename VecT::value_type;
         auto accum = T{1};
         for(int i = 0; i < lengths.size(); i++)
         {
@@ -80,6 +87,94 @@ namespace hiptensor
         return accum;
     }
 
+    // Packed strides of a tensor whose innermost mode is padded to a multiple of
+    // `multiple` elements, so that every row starts on a whole vector
+    template <typename VecT>
+    static inline VecT paddedStridesFromLengths(VecT const&               lengths,
+                                                typename VecT::value_type multiple)
+    {
+        if(lengths.empty())
+        {
+            return lengths;
+        }
+
+        auto padded   = lengths;
+        padded.back() = ceilDiv(padded.back(), multiple) * multiple;
+        return stridesFromLengths(padded);
+    }
+
+    // Kernels load at most 16 bytes per vector access
+    static constexpr uint32_t MaxVectorBytes = 16u;
+
+    // Largest byte offset reachable by the 32-bit index arithmetic of device kernels
+    static constexpr std::size_t MaxKernelIndexBytes = 0x7fffffffu;
+
+    // True when every length, stride and byte offset of a tensor fits 32-bit kernel indexing
+    template <typename VecT>
+    static inline bool
+        fitsKernelIndexing(VecT const& lengths, VecT const& strides, std::size_t elementBytes)
+    {
+        for(int i = 0; i < lengths.size(); i++)
+        {
+            if(lengths[i] > MaxKernelIndexBytes || strides[i] > MaxKernelIndexBytes)
+            {
+                return false;
+            }
+        }
+
+        auto space = lengths.empty() ? 1u : elementSpaceFromLengthsAndStrides(lengths, strides);
+        return space <= MaxKernelIndexBytes / std::max(elementBytes, std::size_t{1});
+    }
+
+    // Widest power-of-two vector access, up to maxWidth elements, that is legal for
+    // a tensor: the base alignment must cover a full vector, the unit-stride mode
+    // must be a multiple of the width and every other stride must keep vectors aligned.
+    // An alignment of 0 is unknown and only allows scalar access.
+    template <typename VecT>
+    static inline uint32_t maxVectorWidth(VecT const& lengths,
+                                          VecT const& strides,
+                                          uint32_t    alignmentBytes,
+                                          uint32_t    elementBytes,
+                                          uint32_t    maxWidth)
+    {
+        if(lengths.empty())
+        {
+            return maxWidth;
+        }
+
+        int fastest = -1;
+        for(int i = 0; i < lengths.size(); i++)
+        {
+            if(strides[i] == 1 && lengths[i] > 1)
+            {
+                fastest = i;
+                break;
+            }
+        }
+
+        if(fastest < 0 || elementBytes == 0)
+        {
+            return 1u;
+        }
+
+        auto width = maxWidth;
+        for(; width > 1u; width /= 2u)
+        {
+            auto legal = alignmentBytes != 0 && alignmentBytes % (width * elementBytes) == 0
+                         && lengths[fastest] % width == 0;
+            for(int i = 0; legal && i < lengths.size(); i++)
+            {
+                legal = i == fastest || lengths[i] == 1 || strides[i] % width == 0;
+            }
+
+            if(legal)
+            {
+                break;
+            }
+        }
+        return width;
+    }
+
 } // namespace hiptensor
 
 #endif // HIPTENSOR_SRC_UTIL_HPP
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef HIPTENSOR_WORKSPACE_POOL_HPP
+#define HIPTENSOR_WORKSPACE_POOL_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <hip/hip_runtime_api.h>
+
+namespace hiptensor
+{
+    // Pool blocks are sized in multiples of this many bytes
+    constexpr std::size_t WorkspaceGranularity = 256u;
+
+    /// Workspace owned by a handle and served to operations that are not given one.
+    ///
+    /// Blocks are stream ordered: a block released on a stream may be acquired again
+    /// by later work on the same stream at once, since the stream runs that work after
+    /// the earlier user. Another stream first waits for the block's last stream. A
+    /// request that no idle block fits allocates a new block; only when that fails are
+    /// the idle blocks freed and the allocation retried.
+    class WorkspacePool
+    {
+    public:
+        /// Device memory behind the pool. order(from, to) makes work issued to `to`
+        /// wait for the work already issued to `from`.
+        struct Allocator
+        {
+            std::function<void*(std::size_t)>             mAllocate;
+            std::function<void(void*)>                    mFree;
+            std::function<void(hipStream_t, hipStream_t)> mOrder;
+        };
+
+        // hipMalloc and hipFree, ordered through events
+        static Allocator deviceAllocator();
+
+        explicit WorkspacePool(Allocator allocator = deviceAllocator());
+        ~WorkspacePool();
+
+        WorkspacePool(WorkspacePool const&)            = delete;
+        WorkspacePool& operator=(WorkspacePool const&) = delete;
+
+        // A block of at least bytes for work on stream, or nullptr if allocation fails
+        void* acquire(std::size_t bytes, hipStream_t stream);
+
+        // Returns a block once the work using it has been issued to stream
+        void release(void* block, hipStream_t stream);
+
+        // A block of at least bytes kept busy for as long as the returned owner lives,
+        // then freed, or nullptr if allocation fails. Captured graphs hold their
+        // workspace this way, since replays reuse its address.
+        std::shared_ptr<void> hold(std::size_t bytes, hipStream_t stream);
+
+        // Frees the idle blocks
+        void trim();
+
+        std::size_t reservedBytes() const;
+        std::size_t highWaterMark() const; /*!< Most bytes ever reserved at once */
+
+    private:
+        struct Block
+        {
+            void*       mData;
+            std::size_t mBytes;
+            hipStream_t mStream; /*!< Stream of the last user */
+            bool        mBusy;
+        };
+
+        // Frees the idle blocks; the caller holds the lock
+        void freeIdle();
+
+        // Frees a busy block for good
+        void dispose(void* block);
+
+        Allocator          mAllocator;
+        std::vector<Block> mBlocks;
+        std::size_t        mReserved;
+        std::size_t        mHighWaterMark;
+        mutable std::mutex mMutex;
+    };
+
+} // namespace hiptensor
+
+#endif // HIPTENSOR_WORKSPACE_POOL_HPP
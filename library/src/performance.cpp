@@ -24,6 +24,10 @@
  *
  *******************************************************************************/
 
+#include <algorithm>
+#include <limits>
+
+#include "include/data_types.hpp"
 #include "include/performance.hpp"
 
 namespace hiptensor
@@ -52,6 +56,216 @@ namespace hiptensor
     {
         return this->mTflops == other.mTflops;
     }
+
+    double ProblemMetrics::tflops(float timeMs) const
+    {
+        // Flops per millisecond scaled to Tflop/s, in double so that large counts keep
+        // their precision
+        return timeMs > 0.0f ? static_cast<double>(mFlops) / 1.E9 / timeMs : 0.0;
+    }
+
+    double ProblemMetrics::bandwidth(float timeMs) const
+    {
+        return timeMs > 0.0f ? static_cast<double>(mBytes) / 1.E6 / timeMs : 0.0;
+    }
+
+    uint64_t saturatingAdd(uint64_t a, uint64_t b, bool* saturated)
+    {
+        uint64_t result;
+        if(__builtin_add_overflow(a, b, &result))
+        {
+            if(saturated != nullptr)
+            {
+                *saturated = true;
+            }
+            return std::numeric_limits<uint64_t>::max();
+        }
+        return result;
+    }
+
+    uint64_t saturatingMultiply(uint64_t a, uint64_t b, bool* saturated)
+    {
+        uint64_t result;
+        if(__builtin_mul_overflow(a, b, &result))
+        {
+            if(saturated != nullptr)
+            {
+                *saturated = true;
+            }
+            return std::numeric_limits<uint64_t>::max();
+        }
+        return result;
+    }
+
+    uint64_t elementCount(hiptensorDimVector_t const& lengths, bool* saturated)
+    {
+        uint64_t result = 1;
+        for(auto length : lengths)
+        {
+            result = saturatingMultiply(result, length, saturated);
+        }
+        return result;
+    }
+
+    uint64_t elementSpace(hiptensorDimVector_t const& lengths,
+                          hiptensorDimVector_t const& strides,
+                          bool*                       saturated)
+    {
+        uint64_t result = 1;
+        for(std::size_t i = 0; i < lengths.size(); i++)
+        {
+            if(lengths[i] == 0)
+            {
+                continue;
+            }
+            result = saturatingAdd(
+                result, saturatingMultiply(lengths[i] - 1, strides[i], saturated), saturated);
+        }
+        return result;
+    }
+
+    ProblemMetrics contractionMetrics(std::array<hipDataType, 4> const&          types,
+                                      std::array<hiptensorDimVector_t, 4> const& lengths,
+                                      std::array<hiptensorDimVector_t, 4> const& strides,
+                                      std::size_t                                rankM,
+                                      std::size_t                                rankN)
+    {
+        ProblemMetrics metrics = {};
+
+        auto* saturated = &metrics.mSaturated;
+        auto  modes     = [saturated](hiptensorDimVector_t const& lengths,
+                                 std::size_t                 first,
+                                 std::size_t                 last) {
+            uint64_t result = 1;
+            for(auto i = first; i < std::min(last, lengths.size()); i++)
+            {
+                result = saturatingMultiply(result, lengths[i], saturated);
+            }
+            return result;
+        };
+
+        // Modes are ordered A = [M, K], B = [N, K] and D = [M, N]
+        metrics.mM = modes(lengths[3], 0, rankM);
+        metrics.mN = modes(lengths[3], rankM, rankM + rankN);
+        metrics.mK = modes(lengths[0], rankM, lengths[0].size());
+
+        metrics.mFlops = saturatingMultiply(
+            2u,
+            saturatingMultiply(saturatingMultiply(metrics.mM, metrics.mN, saturated),
+                               metrics.mK,
+                               saturated),
+            saturated);
+
+        metrics.mBytes = 0;
+        for(int i = 0; i < 4; i++)
+        {
+            metrics.mOperandBytes[i] = 0;
+            if(types[i] == NONE_TYPE || lengths[i].empty())
+            {
+                continue;
+            }
+            metrics.mOperandBytes[i]
+                = saturatingMultiply(elementSpace(lengths[i], strides[i], saturated),
+                                     hipDataTypeSize(types[i]),
+                                     saturated);
+            metrics.mBytes = saturatingAdd(metrics.mBytes, metrics.mOperandBytes[i], saturated);
+        }
+        return metrics;
+    }
+
+    ProblemMetrics permutationMetrics(uint64_t elements, uint64_t elementBytes)
+    {
+        ProblemMetrics metrics = {};
+        metrics.mM             = elements;
+        metrics.mN             = 1;
+        metrics.mK             = 1;
+        metrics.mFlops         = saturatingMultiply(2u, elements, &metrics.mSaturated);
+
+        auto bytes = saturatingMultiply(elements, elementBytes, &metrics.mSaturated);
+        metrics.mOperandBytes = {bytes, 0, 0, bytes};
+        metrics.mBytes        = saturatingMultiply(2u, bytes, &metrics.mSaturated);
+        return metrics;
+    }
+
+    PerfMetrics perfMetrics(std::size_t           kernelUid,
+                            std::string const&    kernelName,
+                            float                 timeMs,
+                            ProblemMetrics const& problem)
+    {
+        return {kernelUid,
+                kernelName,
+                timeMs,
+                static_cast<float>(problem.tflops(timeMs)),
+                static_cast<float>(problem.bandwidth(timeMs))};
+    }
+
+    SelectionPolicy SelectionPolicy::of(hiptensorContractionFind_t const& find)
+    {
+        return {find.mSelectionPolicy, find.mWorkspaceCap, find.mTolerance};
+    }
+
+    bool SelectionPolicy::isDefault() const
+    {
+        return mPolicy == HIPTENSOR_SELECTION_FASTEST
+               && mWorkspaceCap == std::numeric_limits<uint64_t>::max();
+    }
+
+    int selectSample(std::vector<SelectionSample> const& samples, SelectionPolicy const& policy)
+    {
+        // Fastest candidate within the cap sets the bar for the tolerance
+        int fastest = -1;
+        for(int i = 0; i < samples.size(); i++)
+        {
+            if(samples[i].mWorkspaceSize <= policy.mWorkspaceCap
+               && (fastest < 0 || samples[i].mMetrics > samples[fastest].mMetrics))
+            {
+                fastest = i;
+            }
+        }
+        if(fastest < 0 || policy.mPolicy == HIPTENSOR_SELECTION_FASTEST)
+        {
+            return fastest;
+        }
+
+        auto slowest = samples[fastest].mMetrics.mAvgTimeMs * (1.0 + policy.mTolerance);
+        auto score   = [&](SelectionSample const& sample) {
+            // Workspace is written once and read once on top of the operand traffic
+            auto traffic = static_cast<double>(sample.mProblemBytes)
+                           + 2.0 * static_cast<double>(sample.mWorkspaceSize);
+            return traffic > 0.0 ? sample.mMetrics.mBandwidth * sample.mProblemBytes / traffic
+                                 : 0.0;
+        };
+
+        int winner = fastest;
+        for(int i = 0; i < samples.size(); i++)
+        {
+            auto const& sample = samples[i];
+            if(sample.mWorkspaceSize > policy.mWorkspaceCap || i == winner)
+            {
+                continue;
+            }
+
+            auto const& best = samples[winner];
+            if(policy.mPolicy == HIPTENSOR_SELECTION_SMALLEST_WORKSPACE)
+            {
+                if(sample.mMetrics.mAvgTimeMs <= slowest
+                   && (sample.mWorkspaceSize < best.mWorkspaceSize
+                       || (sample.mWorkspaceSize == best.mWorkspaceSize
+                           && sample.mMetrics > best.mMetrics)))
+                {
+                    winner = i;
+                }
+            }
+            else if(policy.mPolicy == HIPTENSOR_SELECTION_BANDWIDTH_EFFICIENT)
+            {
+                if(score(sample) > score(best))
+                {
+                    winner = i;
+                }
+            }
+        }
+        return winner;
+    }
 }
 
 namespace std
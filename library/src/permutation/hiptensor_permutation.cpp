@@ -23,10 +23,110 @@
  * THE SOFTWARE.
  *
  *******************************************************************************/
+#include <array>
+#include <cstring>
+#include <limits>
+#include <vector>
+
 #include <hiptensor/hiptensor.hpp>
 
+#include "data_types.hpp"
+#include "handle.hpp"
 #include "logger.hpp"
 #include "permutation_ck.hpp"
+#include "scalar_epilogue.hpp"
+
+// Dispatches a validated permutation on the element type of A and B
+static hiptensorStatus_t runPermutation(const void*                        alpha,
+                                        const void*                        A,
+                                        const hiptensorTensorDescriptor_t* descA,
+                                        const int32_t                      modeA[],
+                                        void*                              B,
+                                        const hiptensorTensorDescriptor_t* descB,
+                                        const int32_t                      modeB[],
+                                        const hipDataType                  typeScalar,
+                                        const hipStream_t                  stream,
+                                        bool                               timing = true)
+{
+    if(descA->mType == HIP_R_16F)
+    {
+        return hiptensor::detail::permuteByCk(alpha,
+                                              static_cast<const _Float16*>(A),
+                                              descA,
+                                              modeA,
+                                              static_cast<_Float16*>(B),
+                                              descB,
+                                              modeB,
+                                              typeScalar,
+                                              stream,
+                                              timing);
+    }
+    else if(descA->mType == HIP_R_32F)
+    {
+        return hiptensor::detail::permuteByCk(alpha,
+                                              static_cast<const float*>(A),
+                                              descA,
+                                              modeA,
+                                              static_cast<float*>(B),
+                                              descB,
+                                              modeB,
+                                              typeScalar,
+                                              stream,
+                                              timing);
+    }
+    return HIPTENSOR_STATUS_NOT_SUPPORTED;
+}
+
+// Runs a permutation with alpha in the given pointer mode. A device alpha is applied to B
+// in place by an epilogue on the stream, after a permutation with unit scale. Without
+// timing the run never synchronizes, so that a stream capture can hold it.
+static hiptensorStatus_t runScaledPermutation(hiptensorPointerMode_t             pointerMode,
+                                              const void*                        alpha,
+                                              const void*                        A,
+                                              const hiptensorTensorDescriptor_t* descA,
+                                              const int32_t                      modeA[],
+                                              void*                              B,
+                                              const hiptensorTensorDescriptor_t* descB,
+                                              const int32_t                      modeB[],
+                                              const hipDataType                  typeScalar,
+                                              const hipStream_t                  stream,
+                                              bool                               timing = true)
+{
+    if(pointerMode == HIPTENSOR_POINTER_MODE_HOST)
+    {
+        return runPermutation(
+            alpha, A, descA, modeA, B, descB, modeB, typeScalar, stream, timing);
+    }
+
+    auto oneF16 = _Float16(1);
+    auto oneF32 = 1.0f;
+    auto status = runPermutation(typeScalar == HIP_R_16F ? (void const*)&oneF16 : &oneF32,
+                                 A,
+                                 descA,
+                                 modeA,
+                                 B,
+                                 descB,
+                                 modeB,
+                                 typeScalar,
+                                 stream,
+                                 timing);
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    return hiptensor::applyScalars(alpha,
+                                   nullptr,
+                                   typeScalar,
+                                   B,
+                                   nullptr,
+                                   {},
+                                   B,
+                                   descB->mStrides,
+                                   descB->mLengths,
+                                   descB->mType,
+                                   stream);
+}
 
 hiptensorStatus_t hiptensorPermutation(const hiptensorHandle_t*           handle,
                                        const void*                        alpha,
@@ -143,29 +243,90 @@ hiptensorStatus_t hiptensorPermutation(const hiptensorHandle_t*           handle
         return errorCode;
     }
 
-    if(descA->mType == HIP_R_16F)
+    auto realHandle     = hiptensor::Handle::toHandle((int64_t*)handle->fields);
+    auto pointerMode    = realHandle->getPointerMode();
+    auto devicePointers = pointerMode == HIPTENSOR_POINTER_MODE_DEVICE;
+
+    // A capturing handle records the permutation for replay instead of running it,
+    // keeping its own copies of the descriptors, modes and a host alpha. A device alpha
+    // is kept by address, so that replays read its current value.
+    if(auto* capture = realHandle->getCapture())
     {
-        return hiptensor::detail::permuteByCk(alpha,
-                                              static_cast<const _Float16*>(A),
-                                              descA,
-                                              modeA,
-                                              static_cast<_Float16*>(B),
-                                              descB,
-                                              modeB,
-                                              typeScalar,
-                                              stream);
+        auto scalar = std::array<char, 16>{};
+        if(!devicePointers)
+        {
+            std::memcpy(scalar.data(), alpha, hiptensor::hipDataTypeSize(typeScalar));
+        }
+        auto tensorA = *descA;
+        auto tensorB = *descB;
+        auto modesA  = std::vector<int32_t>(modeA, modeA + descA->mLengths.size());
+        auto modesB  = std::vector<int32_t>(modeB, modeB + descB->mLengths.size());
+
+        capture->record({A, B}, [=](std::vector<void*> const& buffers, hipStream_t replayStream) {
+            return runScaledPermutation(pointerMode,
+                                        devicePointers ? alpha : (void const*)scalar.data(),
+                                        buffers[0],
+                                        &tensorA,
+                                        modesA.data(),
+                                        buffers[1],
+                                        &tensorB,
+                                        modesB.data(),
+                                        typeScalar,
+                                        replayStream,
+                                        false);
+        });
+        return HIPTENSOR_STATUS_SUCCESS;
     }
-    else if(descA->mType == HIP_R_32F)
+
+    // A deferring handle queues the permutation until the next flush, which may find
+    // it redundant
+    if(auto* queue = realHandle->getDeferred())
     {
-        return hiptensor::detail::permuteByCk(alpha,
-                                              static_cast<const float*>(A),
-                                              descA,
-                                              modeA,
-                                              static_cast<float*>(B),
-                                              descB,
-                                              modeB,
-                                              typeScalar,
-                                              stream);
+        hiptensor::DeferredOperation op;
+        op.mKind    = hiptensor::DeferredOperation::Kind::Permutation;
+        op.mKernel  = nullptr;
+        op.mStream  = stream;
+        op.mFlops   = 0u;
+        op.mScalars = {};
+        op.mReads   = {hiptensor::deferredRange(A, *descA)};
+        op.mWrites  = {hiptensor::deferredRange(B, *descB)};
+        op.mTensors = {*descA, *descB};
+        op.mModes   = {std::vector<int32_t>(modeA, modeA + descA->mLengths.size()),
+                       std::vector<int32_t>(modeB, modeB + descB->mLengths.size())};
+
+        // A device alpha is unknown until the stream reaches the permutation, so the
+        // flush never drops it as a no-op or as undone by an inverse
+        if(devicePointers)
+        {
+            op.mAlpha = std::numeric_limits<double>::quiet_NaN();
+            std::memcpy(op.mScalars.data(), &alpha, sizeof(alpha));
+        }
+        else
+        {
+            op.mAlpha = typeScalar == HIP_R_16F ? double(*static_cast<const _Float16*>(alpha))
+                                                : double(*static_cast<const float*>(alpha));
+            std::memcpy(op.mScalars.data(), alpha, hiptensor::hipDataTypeSize(typeScalar));
+        }
+
+        auto scalars = op.mScalars;
+        auto tensors = op.mTensors;
+        auto modes   = op.mModes;
+        op.mLaunch   = [=]() {
+            return runScaledPermutation(pointerMode,
+                                        devicePointers ? alpha : (void const*)scalars.data(),
+                                        A,
+                                        &tensors[0],
+                                        modes[0].data(),
+                                        B,
+                                        &tensors[1],
+                                        modes[1].data(),
+                                        typeScalar,
+                                        stream);
+        };
+        queue->enqueue(std::move(op));
+        return HIPTENSOR_STATUS_SUCCESS;
     }
-    return HIPTENSOR_STATUS_NOT_SUPPORTED;
+
+    return runScaledPermutation(
+        pointerMode, alpha, A, descA, modeA, B, descB, modeB, typeScalar, stream);
 }
@@ -39,7 +39,9 @@ namespace hiptensor
                                       DataType*                          B,
                                       const hiptensorTensorDescriptor_t* descB,
                                       const int32_t                      modeB[],
-                                      const hipDataType                  typeScalar);
+                                      const hipDataType                  typeScalar,
+                                      const hipStream_t                  stream,
+                                      bool                               timing = true);
 
     }
 }
@@ -32,6 +32,7 @@
 #include <ck/tensor_operation/gpu/device/impl/device_elementwise_scale_impl.hpp>
 #include <ck/tensor_operation/gpu/element/binary_element_wise_operation.hpp>
 
+#include "data_layout.hpp"
 #include "data_types.hpp"
 #include "performance.hpp"
 
@@ -48,7 +49,8 @@ namespace hiptensor
                                       const hiptensorTensorDescriptor_t* descB,
                                       const int32_t                      modeB[],
                                       const hipDataType                  typeScalar,
-                                      const hipStream_t                  stream)
+                                      const hipStream_t                  stream,
+                                      bool                               timing)
         {
             using PassThrough = ck::tensor_operation::element_wise::PassThrough;
             using UnaryOp     = ck::tensor_operation::element_wise::PassThrough;
@@ -80,34 +82,20 @@ namespace hiptensor
             std::array<const void*, 1>           input      = {A};
             std::array<void*, 1>                 output     = {B};
             std::unordered_map<int32_t, int32_t> bModeToStrides;
-#if HIPTENSOR_DATA_LAYOUT_COL_MAJOR
-            std::array<ck::index_t, 4> aStrides
-                = {1,
-                   modeToLength[modeA[0]],
-                   modeToLength[modeA[0]] * modeToLength[modeA[1]],
-                   modeToLength[modeA[0]] * modeToLength[modeA[1]] * modeToLength[modeA[2]]};
-            int32_t stride           = 1;
-            bModeToStrides[modeB[0]] = stride;
-            for(int32_t index = 1; index < modeSize; index++)
-            {
-                stride *= modeToLength[modeB[index - 1]];
-                bModeToStrides[modeB[index]] = stride;
-            }
-#else // HIPTENSOR_DATA_LAYOUT_COL_MAJOR
-            std::array<ck::index_t, 4> aStrides = {
-                modeToLength[modeA[1]] * modeToLength[modeA[2]] * modeToLength[modeA[3]],
-                modeToLength[modeA[2]] * modeToLength[modeA[3]],
-                modeToLength[modeA[3]],
-                1,
-            };
-            int32_t stride                      = 1;
-            bModeToStrides[modeB[modeSize - 1]] = stride;
-            for(int32_t index = modeSize - 2; index >= 0; index--)
+
+            // A and B are each addressed through the strides of their own descriptor, so
+            // one call converts between row- and column-major and reads or writes views
+            auto aAddressed = permutationStrides(*descA);
+            auto bAddressed = permutationStrides(*descB);
+            for(int32_t index = 0; index < modeSize; index++)
             {
-                stride *= modeToLength[modeB[index + 1]];
-                bModeToStrides[modeB[index]] = stride;
+                bModeToStrides[modeB[index]] = bAddressed[index];
             }
-#endif // HIPTENSOR_DATA_LAYOUT_COL_MAJOR
+
+            std::array<ck::index_t, 4> aStrides         = {ck::index_t(aAddressed[0]),
+                                                           ck::index_t(aAddressed[1]),
+                                                           ck::index_t(aAddressed[2]),
+                                                           ck::index_t(aAddressed[3])};
             std::array<ck::index_t, 4> bStrides         = {bModeToStrides[modeA[0]],
                                                            bModeToStrides[modeA[1]],
                                                            bModeToStrides[modeA[2]],
@@ -136,27 +124,25 @@ namespace hiptensor
             // Perform contraction with timing if LOG_LEVEL_PERF_TRACE
             using hiptensor::Logger;
             auto& logger             = Logger::instance();
-            bool  measurePermuteTime = logger->getLogMask() & HIPTENSOR_LOG_LEVEL_PERF_TRACE;
+            bool  measurePermuteTime
+                = timing && (logger->getLogMask() & HIPTENSOR_LOG_LEVEL_PERF_TRACE) != 0;
 
             auto permuteTime = broadcastPermute_invoker_ptr->Run(
                 argument.get(), StreamConfig{stream, measurePermuteTime});
             if(measurePermuteTime)
             {
-                std::size_t problemSize
-                    = std::accumulate(abLengths.begin(), abLengths.end(), 1, std::multiplies{});
-                std::size_t flops = std::size_t(2) * problemSize;
-
-                std::size_t bytes     = 2 * sizeof(DataType) * problemSize;
-                float       tflops    = static_cast<float>(flops) / 1.E9 / permuteTime;
-                float       bandwidth = bytes / 1.E6 / permuteTime;
+                uint64_t problemSize = 1;
+                for(auto length : abLengths)
+                {
+                    problemSize = hiptensor::saturatingMultiply(problemSize, length);
+                }
 
-                hiptensor::PerfMetrics metrics = {
-                    0, // id, permute has only one solution, set id to 0
-                    "default solution", // name
-                    permuteTime, // avg time
-                    tflops, // tflops
-                    bandwidth // BW
-                };
+                // Permute has only one solution, set id to 0
+                auto metrics = hiptensor::perfMetrics(
+                    0,
+                    "default solution",
+                    permuteTime,
+                    hiptensor::permutationMetrics(problemSize, sizeof(DataType)));
 
                 // log perf metrics (not name/id)
                 char msg[2048];
@@ -29,6 +29,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "data_layout.hpp"
 #include "data_types.hpp"
 #include "permutation_cpu_reference.hpp"
 #include "util.hpp"
@@ -56,43 +57,28 @@ namespace hiptensor
                 bModeToIndex[modeB[index]] = index;
             }
 
-            auto& aLens    = descA->mLengths;
-            auto  bStrides = std::vector<int32_t>(modeSize, 1);
-#if HIPTENSOR_DATA_LAYOUT_COL_MAJOR
-            for(int i = 1; i < modeSize; i++)
-            {
-                bStrides[i] = descB->mLengths[i - 1] * bStrides[i - 1];
-            }
-#else // HIPTENSOR_DATA_LAYOUT_COL_MAJOR
-            for(int i = modeSize - 2; i >= 0; i--)
-            {
-                bStrides[i] = descB->mLengths[i + 1] * bStrides[i + 1];
-            }
-#endif // HIPTENSOR_DATA_LAYOUT_COL_MAJOR
+            // A and B are each addressed through the strides of their own descriptor
+            auto& aLens        = descA->mLengths;
+            auto  aStrides     = permutationStrides(*descA);
+            auto  bStrides     = permutationStrides(*descB);
             auto  bIndices     = std::vector<int32_t>(modeSize, 0);
             auto  elementCount = hiptensor::elementsFromLengths(aLens);
             float alphaValue   = readVal<float>(alpha, typeScalar);
             for(int elementIndex = 0; elementIndex < elementCount; elementIndex++)
             {
-                auto index = elementIndex;
-#if HIPTENSOR_DATA_LAYOUT_COL_MAJOR
-                for(int modeIndex = 0; modeIndex < modeSize; modeIndex++)
-                {
-                    bIndices[bModeToIndex[modeA[modeIndex]]] = index % aLens[modeIndex];
-                    index /= aLens[modeIndex];
-                }
-                auto bOffset
-                    = std::inner_product(bIndices.begin(), bIndices.end(), bStrides.begin(), 0);
-#else // HIPTENSOR_DATA_LAYOUT_COL_MAJOR
-                for(int modeIndex = modeSize - 1; modeIndex >= 0; modeIndex--)
+                // Unravel the element's index in A, last mode fastest
+                auto index   = elementIndex;
+                auto aOffset = std::size_t{0};
+                for(int i = modeSize - 1; i >= 0; i--)
                 {
-                    bIndices[bModeToIndex[modeA[modeIndex]]] = index % aLens[modeIndex];
-                    index /= aLens[modeIndex];
+                    auto modeIndex = index % aLens[i];
+                    bIndices[bModeToIndex[modeA[i]]] = modeIndex;
+                    aOffset += modeIndex * aStrides[i];
+                    index /= aLens[i];
                 }
-                auto bOffset
-                    = std::inner_product(bIndices.rbegin(), bIndices.rend(), bStrides.rbegin(), 0);
-#endif // HIPTENSOR_DATA_LAYOUT_COL_MAJOR
-                B[bOffset] = static_cast<DataType>(A[elementIndex] * alphaValue);
+                auto bOffset = std::inner_product(
+                    bIndices.begin(), bIndices.end(), bStrides.begin(), std::size_t{0});
+                B[bOffset] = static_cast<DataType>(A[aOffset] * alphaValue);
             }
 
             return HIPTENSOR_STATUS_SUCCESS;
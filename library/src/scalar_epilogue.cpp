@@ -0,0 +1,194 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+
+#include <hip/hip_runtime.h>
+
+#include "config.hpp"
+#include "scalar_epilogue.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        // Lengths and strides passed to the kernel by value
+        struct EpilogueShape
+        {
+            uint32_t    mRank;
+            std::size_t mLengths[ScalarEpilogueMaxRank];
+            std::size_t mCStrides[ScalarEpilogueMaxRank];
+            std::size_t mDStrides[ScalarEpilogueMaxRank];
+        };
+
+        template <typename DataT, typename ScalarT>
+        HIPTENSOR_KERNEL void scalarEpilogueKernel(ScalarT const* alpha,
+                                                   ScalarT const* beta,
+                                                   DataT const*   P,
+                                                   DataT const*   C,
+                                                   DataT*         D,
+                                                   EpilogueShape  shape,
+                                                   std::size_t    count)
+        {
+            using ComputeT = EpilogueComputeT<ScalarT>;
+
+            // The scalars are read here, in stream order, rather than on the host
+            auto a = ComputeT(*alpha);
+            auto b = beta != nullptr && C != nullptr ? ComputeT(*beta) : ComputeT(0);
+
+            auto stride = std::size_t(gridDim.x) * blockDim.x;
+            for(auto i = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x; i < count;
+                i += stride)
+            {
+                auto rest    = i;
+                auto cOffset = std::size_t{0};
+                auto dOffset = std::size_t{0};
+                for(auto mode = shape.mRank; mode-- > 0;)
+                {
+                    auto index = rest % shape.mLengths[mode];
+                    rest /= shape.mLengths[mode];
+                    dOffset += index * shape.mDStrides[mode];
+                    cOffset += index * shape.mCStrides[mode];
+                }
+
+                auto value = a * ComputeT(P[dOffset]);
+                if(b != ComputeT(0))
+                {
+                    value += b * ComputeT(C[cOffset]);
+                }
+                D[dOffset] = DataT(value);
+            }
+        }
+
+        template <typename DataT, typename ScalarT>
+        hiptensorStatus_t launchEpilogue(void const*          alpha,
+                                         void const*          beta,
+                                         void const*          P,
+                                         void const*          C,
+                                         void*                D,
+                                         EpilogueShape const& shape,
+                                         std::size_t          count,
+                                         hipStream_t          stream)
+        {
+            constexpr uint32_t BlockSize = 256u;
+            constexpr uint32_t MaxBlocks = 1u << 16;
+
+            auto blocks = uint32_t(std::min<std::size_t>((count + BlockSize - 1) / BlockSize,
+                                                         MaxBlocks));
+            hipLaunchKernelGGL((scalarEpilogueKernel<DataT, ScalarT>),
+                               dim3(blocks),
+                               dim3(BlockSize),
+                               0,
+                               stream,
+                               static_cast<ScalarT const*>(alpha),
+                               static_cast<ScalarT const*>(beta),
+                               static_cast<DataT const*>(P),
+                               static_cast<DataT const*>(C),
+                               static_cast<DataT*>(D),
+                               shape,
+                               count);
+
+            return hipGetLastError() == hipSuccess ? HIPTENSOR_STATUS_SUCCESS
+                                                   : HIPTENSOR_STATUS_HIP_ERROR;
+        }
+
+        template <typename DataT>
+        hiptensorStatus_t launchEpilogue(hipDataType          scalarType,
+                                         void const*          alpha,
+                                         void const*          beta,
+                                         void const*          P,
+                                         void const*          C,
+                                         void*                D,
+                                         EpilogueShape const& shape,
+                                         std::size_t          count,
+                                         hipStream_t          stream)
+        {
+            if(scalarType == HIP_R_16F)
+            {
+                return launchEpilogue<DataT, _Float16>(alpha, beta, P, C, D, shape, count, stream);
+            }
+            else if(scalarType == HIP_R_32F)
+            {
+                return launchEpilogue<DataT, float>(alpha, beta, P, C, D, shape, count, stream);
+            }
+            else if(scalarType == HIP_R_64F)
+            {
+                return launchEpilogue<DataT, double>(alpha, beta, P, C, D, shape, count, stream);
+            }
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+    }
+
+    hiptensorStatus_t applyScalars(void const*                 alpha,
+                                   void const*                 beta,
+                                   hipDataType                 scalarType,
+                                   void const*                 P,
+                                   void const*                 C,
+                                   hiptensorDimVector_t const& cStrides,
+                                   void*                       D,
+                                   hiptensorDimVector_t const& dStrides,
+                                   hiptensorDimVector_t const& lengths,
+                                   hipDataType                 type,
+                                   hipStream_t                 stream)
+    {
+        if(lengths.size() > ScalarEpilogueMaxRank || dStrides.size() != lengths.size()
+           || (C != nullptr && cStrides.size() != lengths.size()))
+        {
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+
+        EpilogueShape shape = {};
+        shape.mRank         = uint32_t(lengths.size());
+        auto count          = std::size_t{1};
+        for(std::size_t i = 0; i < lengths.size(); i++)
+        {
+            shape.mLengths[i]  = lengths[i];
+            shape.mDStrides[i] = dStrides[i];
+            shape.mCStrides[i] = C != nullptr ? cStrides[i] : 0u;
+            count *= lengths[i];
+        }
+
+        if(count == 0)
+        {
+            return HIPTENSOR_STATUS_SUCCESS;
+        }
+
+        if(type == HIP_R_16F)
+        {
+            return launchEpilogue<_Float16>(scalarType, alpha, beta, P, C, D, shape, count, stream);
+        }
+        else if(type == HIP_R_32F)
+        {
+            return launchEpilogue<float>(scalarType, alpha, beta, P, C, D, shape, count, stream);
+        }
+        else if(type == HIP_R_64F)
+        {
+            return launchEpilogue<double>(scalarType, alpha, beta, P, C, D, shape, count, stream);
+        }
+        return HIPTENSOR_STATUS_NOT_SUPPORTED;
+    }
+
+} // namespace hiptensor
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+
+#include <hip/hip_runtime.h>
+
+#include "config.hpp"
+#include "symmetric_packing.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        // Visits the full tensor with the last mode fastest. Expanding writes every full
+        // element; compressing writes the stored elements from their sorted indices.
+        template <typename DataT>
+        HIPTENSOR_KERNEL void packSymmetricKernel(SymmetricShape shape,
+                                                  DataT const*   src,
+                                                  DataT*         dst,
+                                                  std::size_t    count,
+                                                  bool           compress)
+        {
+            auto stride = std::size_t(gridDim.x) * blockDim.x;
+            for(auto i = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x; i < count;
+                i += stride)
+            {
+                std::size_t index[SymmetricMaxRank];
+                auto        rest = i;
+                for(auto mode = shape.mRank; mode-- > 0;)
+                {
+                    index[mode] = rest % shape.mLengths[mode];
+                    rest /= shape.mLengths[mode];
+                }
+
+                std::size_t offset;
+                bool        canonical;
+                auto        sign = symmetricOffset(shape, index, &offset, &canonical);
+                if(compress && canonical && sign != 0)
+                {
+                    dst[offset] = src[i];
+                }
+                else if(!compress)
+                {
+                    dst[i] = sign == 0 ? DataT(0) : sign < 0 ? DataT(-src[offset]) : src[offset];
+                }
+            }
+        }
+
+        template <typename DataT>
+        hiptensorStatus_t launchPack(SymmetricShape const& shape,
+                                     void const*           src,
+                                     void*                 dst,
+                                     bool                  compress,
+                                     hipStream_t           stream)
+        {
+            constexpr uint32_t BlockSize = 256u;
+            constexpr uint32_t MaxBlocks = 1u << 16;
+
+            auto count = std::size_t{1};
+            for(uint32_t mode = 0; mode < shape.mRank; mode++)
+            {
+                count *= shape.mLengths[mode];
+            }
+            if(count == 0)
+            {
+                return HIPTENSOR_STATUS_SUCCESS;
+            }
+
+            auto blocks = uint32_t(std::min<std::size_t>((count + BlockSize - 1) / BlockSize,
+                                                         MaxBlocks));
+            hipLaunchKernelGGL((packSymmetricKernel<DataT>),
+                               dim3(blocks),
+                               dim3(BlockSize),
+                               0,
+                               stream,
+                               shape,
+                               static_cast<DataT const*>(src),
+                               static_cast<DataT*>(dst),
+                               count,
+                               compress);
+
+            return hipGetLastError() == hipSuccess ? HIPTENSOR_STATUS_SUCCESS
+                                                   : HIPTENSOR_STATUS_HIP_ERROR;
+        }
+
+        hiptensorStatus_t launchPack(SymmetricShape const& shape,
+                                     void const*           src,
+                                     void*                 dst,
+                                     hipDataType           type,
+                                     bool                  compress,
+                                     hipStream_t           stream)
+        {
+            if(type == HIP_R_16F)
+            {
+                return launchPack<_Float16>(shape, src, dst, compress, stream);
+            }
+            else if(type == HIP_R_32F)
+            {
+                return launchPack<float>(shape, src, dst, compress, stream);
+            }
+            else if(type == HIP_R_64F)
+            {
+                return launchPack<double>(shape, src, dst, compress, stream);
+            }
+            return HIPTENSOR_STATUS_NOT_SUPPORTED;
+        }
+    }
+
+    hiptensorStatus_t expandSymmetric(SymmetricShape const& shape,
+                                      void const*           packed,
+                                      void*                 dense,
+                                      hipDataType           type,
+                                      hipStream_t           stream)
+    {
+        return launchPack(shape, packed, dense, type, false, stream);
+    }
+
+    hiptensorStatus_t compressSymmetric(SymmetricShape const& shape,
+                                        void const*           dense,
+                                        void*                 packed,
+                                        hipDataType           type,
+                                        hipStream_t           stream)
+    {
+        return launchPack(shape, dense, packed, type, true, stream);
+    }
+
+} // namespace hiptensor
@@ -0,0 +1,279 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "data_types.hpp"
+#include "performance.hpp"
+#include "tensor_file.hpp"
+#include "util.hpp"
+
+namespace hiptensor
+{
+    namespace
+    {
+        constexpr char     FileMagic[8] = {'H', 'I', 'P', 'T', 'N', 'S', 'R', '\0'};
+        constexpr uint32_t FileVersion  = 1u;
+
+        // Sanity bound on the rank read from a header
+        constexpr uint64_t MaxFileRank = 64u;
+
+        // Data starts on a page boundary so that it can be mapped in place
+        constexpr std::size_t DataAlignment = 4096u;
+
+        struct FileHeader
+        {
+            char     mMagic[8];
+            uint32_t mVersion;
+            int32_t  mType;
+            uint64_t mRank;
+            uint64_t mDataOffset;
+            uint64_t mDataBytes;
+            // Followed by mRank lengths and mRank strides as uint64_t
+        };
+
+        // Header fields that do not depend on the lengths and strides: a known element
+        // type, and dimensions and data that lie in the file without wrapping around
+        bool validHeader(FileHeader const& header, off_t fileBytes)
+        {
+            if(std::memcmp(header.mMagic, FileMagic, sizeof(FileMagic)) != 0
+               || header.mVersion != FileVersion || header.mRank > MaxFileRank
+               || hipDataTypeSize(static_cast<hipDataType>(header.mType)) == 0)
+            {
+                return false;
+            }
+
+            auto saturated = false;
+            auto dataEnd   = saturatingAdd(header.mDataOffset, header.mDataBytes, &saturated);
+            return !saturated && fileBytes >= 0 && dataEnd <= uint64_t(fileBytes)
+                   && header.mDataOffset >= sizeof(header) + 2 * header.mRank * sizeof(uint64_t);
+        }
+
+        std::size_t pageSize()
+        {
+            static auto size = std::size_t(sysconf(_SC_PAGESIZE));
+            return size;
+        }
+    }
+
+    MappedTensorFile::~MappedTensorFile()
+    {
+        close();
+    }
+
+    hiptensorStatus_t MappedTensorFile::write(std::string const&                 path,
+                                              hiptensorTensorDescriptor_t const& desc,
+                                              void const*                        data)
+    {
+        auto rank      = desc.mLengths.size();
+        auto dataBytes = std::size_t{0};
+        if(rank > 0)
+        {
+            dataBytes = elementSpaceFromLengthsAndStrides(desc.mLengths, desc.mStrides)
+                        * hipDataTypeSize(desc.mType);
+        }
+
+        FileHeader header;
+        std::memcpy(header.mMagic, FileMagic, sizeof(FileMagic));
+        header.mVersion = FileVersion;
+        header.mType    = static_cast<int32_t>(desc.mType);
+        header.mRank    = rank;
+        header.mDataOffset
+            = ceilDiv(sizeof(FileHeader) + 2 * rank * sizeof(uint64_t), DataAlignment)
+              * DataAlignment;
+        header.mDataBytes = dataBytes;
+
+        std::vector<uint64_t> dims(desc.mLengths.begin(), desc.mLengths.end());
+        dims.insert(dims.end(), desc.mStrides.begin(), desc.mStrides.end());
+
+        auto* file = std::fopen(path.c_str(), "wb");
+        if(file == nullptr)
+        {
+            return HIPTENSOR_STATUS_IO_ERROR;
+        }
+
+        auto ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+                  && std::fwrite(dims.data(), sizeof(uint64_t), dims.size(), file) == dims.size()
+                  && std::fseek(file, header.mDataOffset, SEEK_SET) == 0;
+        if(ok && data != nullptr)
+        {
+            ok = std::fwrite(data, 1, dataBytes, file) == dataBytes;
+        }
+        ok &= std::fclose(file) == 0;
+
+        // Without data, the element space is left as a zero-filled hole
+        ok = ok && truncate(path.c_str(), header.mDataOffset + dataBytes) == 0;
+        return ok ? HIPTENSOR_STATUS_SUCCESS : HIPTENSOR_STATUS_IO_ERROR;
+    }
+
+    hiptensorStatus_t MappedTensorFile::open(std::string const& path, bool writable)
+    {
+        close();
+
+        auto fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        if(fd < 0)
+        {
+            return HIPTENSOR_STATUS_IO_ERROR;
+        }
+
+        struct stat info;
+        FileHeader  header;
+        auto        headerBytes = ssize_t(-1);
+        if(fstat(fd, &info) == 0)
+        {
+            headerBytes = pread(fd, &header, sizeof(header), 0);
+        }
+        if(headerBytes < 0)
+        {
+            ::close(fd);
+            return HIPTENSOR_STATUS_IO_ERROR;
+        }
+
+        // Anything but a complete, consistent header is not a tensor file
+        if(headerBytes != ssize_t(sizeof(header)) || !validHeader(header, info.st_size))
+        {
+            ::close(fd);
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+
+        std::vector<uint64_t> dims(2 * header.mRank);
+        auto                  dimBytes = ssize_t(dims.size() * sizeof(uint64_t));
+        if(pread(fd, dims.data(), dimBytes, sizeof(header)) != dimBytes)
+        {
+            ::close(fd);
+            return HIPTENSOR_STATUS_IO_ERROR;
+        }
+
+        // The data must hold the whole element space of the stored view
+        hiptensorDimVector_t lengths(dims.begin(), dims.begin() + header.mRank);
+        hiptensorDimVector_t strides(dims.begin() + header.mRank, dims.end());
+        if(header.mRank > 0)
+        {
+            auto saturated = false;
+            auto required  = saturatingMultiply(
+                elementSpace(lengths, strides, &saturated),
+                hipDataTypeSize(static_cast<hipDataType>(header.mType)),
+                &saturated);
+            if(saturated || header.mDataBytes < required)
+            {
+                ::close(fd);
+                return HIPTENSOR_STATUS_INVALID_VALUE;
+            }
+        }
+
+        mMapBytes = header.mDataOffset + header.mDataBytes;
+        mMapping  = mmap(nullptr,
+                        std::max(mMapBytes, std::size_t{1}),
+                        writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                        MAP_SHARED,
+                        fd,
+                        0);
+        ::close(fd);
+
+        if(mMapping == MAP_FAILED)
+        {
+            mMapping  = nullptr;
+            mMapBytes = 0;
+            return HIPTENSOR_STATUS_IO_ERROR;
+        }
+
+        // Tile traversal is not sequential in the file; read-ahead follows willNeed()
+        madvise(mMapping, mMapBytes, MADV_RANDOM);
+
+        mDesc.mType      = static_cast<hipDataType>(header.mType);
+        mDesc.mLengths   = std::move(lengths);
+        mDesc.mStrides   = std::move(strides);
+        mDesc.mSignature = nullptr;
+        mDataOffset      = header.mDataOffset;
+        mDataBytes       = header.mDataBytes;
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    void MappedTensorFile::close()
+    {
+        if(mMapping != nullptr)
+        {
+            munmap(mMapping, std::max(mMapBytes, std::size_t{1}));
+        }
+        mDesc       = {};
+        mMapping    = nullptr;
+        mMapBytes   = 0;
+        mDataOffset = 0;
+        mDataBytes  = 0;
+    }
+
+    hiptensorTensorDescriptor_t const& MappedTensorFile::descriptor() const
+    {
+        return mDesc;
+    }
+
+    void* MappedTensorFile::data() const
+    {
+        return mMapping != nullptr ? (char*)mMapping + mDataOffset : nullptr;
+    }
+
+    std::size_t MappedTensorFile::bytes() const
+    {
+        return mDataBytes;
+    }
+
+    void MappedTensorFile::willNeed(std::size_t offset, std::size_t bytes) const
+    {
+        if(mMapping == nullptr || bytes == 0 || offset >= mDataBytes)
+        {
+            return;
+        }
+
+        // madvise works on whole pages
+        auto first = (mDataOffset + offset) / pageSize() * pageSize();
+        auto last  = std::min(mDataOffset + offset + bytes, mMapBytes);
+        madvise((char*)mMapping + first, last - first, MADV_WILLNEED);
+    }
+
+    void MappedTensorFile::dontNeed(std::size_t offset, std::size_t bytes) const
+    {
+        if(mMapping == nullptr || bytes == 0 || offset >= mDataBytes)
+        {
+            return;
+        }
+
+        // Only pages entirely inside the range are released
+        auto first = ceilDiv(mDataOffset + offset, pageSize()) * pageSize();
+        auto last  = std::min(mDataOffset + offset + bytes, mMapBytes) / pageSize() * pageSize();
+        if(first < last)
+        {
+            madvise((char*)mMapping + first, last - first, MADV_DONTNEED);
+        }
+    }
+
+} // namespace hiptensor
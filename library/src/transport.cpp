@@ -0,0 +1,202 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <cstring>
+
+#include "transport.hpp"
+
+namespace hiptensor
+{
+    CallbackTransport::CallbackTransport(hiptensorTransport_t const& transport)
+        : mTransport(transport)
+    {
+    }
+
+    uint32_t CallbackTransport::rank() const
+    {
+        return mTransport.mRank;
+    }
+
+    uint32_t CallbackTransport::size() const
+    {
+        return mTransport.mSize;
+    }
+
+    hiptensorStatus_t CallbackTransport::send(
+        uint32_t peer, uint32_t tag, void const* buffer, std::size_t bytes, Request* request)
+    {
+        return mTransport.send(mTransport.mContext, peer, tag, buffer, bytes, request);
+    }
+
+    hiptensorStatus_t CallbackTransport::receive(
+        uint32_t peer, uint32_t tag, void* buffer, std::size_t bytes, Request* request)
+    {
+        return mTransport.receive(mTransport.mContext, peer, tag, buffer, bytes, request);
+    }
+
+    hiptensorStatus_t CallbackTransport::wait(Request request)
+    {
+        return mTransport.wait(mTransport.mContext, request);
+    }
+
+    struct InProcessFabric::PendingReceive
+    {
+        Key         mKey;
+        void*       mBuffer;
+        std::size_t mBytes;
+    };
+
+    class InProcessFabric::Endpoint : public Transport
+    {
+    public:
+        Endpoint(InProcessFabric& fabric, uint32_t rank)
+            : mFabric(fabric)
+            , mRank(rank)
+        {
+        }
+
+        uint32_t rank() const override
+        {
+            return mRank;
+        }
+
+        uint32_t size() const override
+        {
+            return uint32_t(mFabric.mEndpoints.size());
+        }
+
+        hiptensorStatus_t send(uint32_t    peer,
+                               uint32_t    tag,
+                               void const* buffer,
+                               std::size_t bytes,
+                               Request*    request) override
+        {
+            if(peer >= size() || request == nullptr || (buffer == nullptr && bytes > 0))
+            {
+                return HIPTENSOR_STATUS_INVALID_VALUE;
+            }
+
+            // Buffered sends are complete once posted
+            *request = nullptr;
+            return mFabric.post({mRank, peer, tag}, buffer, bytes);
+        }
+
+        hiptensorStatus_t receive(
+            uint32_t peer, uint32_t tag, void* buffer, std::size_t bytes, Request* request) override
+        {
+            if(peer >= size() || request == nullptr || (buffer == nullptr && bytes > 0))
+            {
+                return HIPTENSOR_STATUS_INVALID_VALUE;
+            }
+
+            *request = new PendingReceive{{peer, mRank, tag}, buffer, bytes};
+            return HIPTENSOR_STATUS_SUCCESS;
+        }
+
+        hiptensorStatus_t wait(Request request) override
+        {
+            if(request == nullptr)
+            {
+                return HIPTENSOR_STATUS_SUCCESS;
+            }
+
+            auto* pending = static_cast<PendingReceive*>(request);
+            auto  status  = mFabric.complete(pending);
+            delete pending;
+            return status;
+        }
+
+    private:
+        InProcessFabric& mFabric;
+        uint32_t         mRank;
+    };
+
+    InProcessFabric::InProcessFabric(uint32_t ranks, Copy copy)
+        : mCopy(copy ? std::move(copy)
+                     : [](void* dst, void const* src, std::size_t bytes) {
+                           std::memcpy(dst, src, bytes);
+                       })
+        , mSentBytes(ranks, 0)
+    {
+        for(uint32_t rank = 0; rank < ranks; rank++)
+        {
+            mEndpoints.push_back(std::make_unique<Endpoint>(*this, rank));
+        }
+    }
+
+    InProcessFabric::~InProcessFabric() = default;
+
+    Transport& InProcessFabric::transport(uint32_t rank)
+    {
+        return *mEndpoints[rank];
+    }
+
+    std::size_t InProcessFabric::sentBytes(uint32_t rank) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSentBytes[rank];
+    }
+
+    hiptensorStatus_t InProcessFabric::post(Key const& key, void const* buffer, std::size_t bytes)
+    {
+        std::vector<char> payload(bytes);
+        if(bytes > 0)
+        {
+            mCopy(payload.data(), buffer, bytes);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mMailboxes[key].push_back(std::move(payload));
+            mSentBytes[std::get<0>(key)] += bytes;
+        }
+        mArrived.notify_all();
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+    hiptensorStatus_t InProcessFabric::complete(PendingReceive* pending)
+    {
+        std::vector<char> payload;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            auto&                        mailbox = mMailboxes[pending->mKey];
+            mArrived.wait(lock, [&]() { return !mailbox.empty(); });
+            payload = std::move(mailbox.front());
+            mailbox.pop_front();
+        }
+
+        if(payload.size() != pending->mBytes)
+        {
+            return HIPTENSOR_STATUS_INVALID_VALUE;
+        }
+        if(payload.size() > 0)
+        {
+            mCopy(pending->mBuffer, payload.data(), payload.size());
+        }
+        return HIPTENSOR_STATUS_SUCCESS;
+    }
+
+} // namespace hiptensor
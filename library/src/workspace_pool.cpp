@@ -0,0 +1,200 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+
+#include "util.hpp"
+#include "workspace_pool.hpp"
+
+namespace hiptensor
+{
+    WorkspacePool::Allocator WorkspacePool::deviceAllocator()
+    {
+        Allocator allocator;
+        allocator.mAllocate = [](std::size_t bytes) -> void* {
+            void* data = nullptr;
+            return hipMalloc(&data, bytes) == hipSuccess ? data : nullptr;
+        };
+        allocator.mFree  = [](void* data) { (void)hipFree(data); };
+        allocator.mOrder = [](hipStream_t from, hipStream_t to) {
+            hipEvent_t event;
+            if(hipEventCreateWithFlags(&event, hipEventDisableTiming) != hipSuccess)
+            {
+                // Without an event, waiting for the device orders everything
+                (void)hipDeviceSynchronize();
+                return;
+            }
+            (void)hipEventRecord(event, from);
+            (void)hipStreamWaitEvent(to, event, 0);
+            (void)hipEventDestroy(event);
+        };
+        return allocator;
+    }
+
+    WorkspacePool::WorkspacePool(Allocator allocator)
+        : mAllocator(std::move(allocator))
+        , mReserved(0u)
+        , mHighWaterMark(0u)
+    {
+    }
+
+    WorkspacePool::~WorkspacePool()
+    {
+        for(auto& block : mBlocks)
+        {
+            mAllocator.mFree(block.mData);
+        }
+    }
+
+    void* WorkspacePool::acquire(std::size_t bytes, hipStream_t stream)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // Best fit among idle blocks, preferring those last used on this stream
+        Block* fit    = nullptr;
+        auto   prefer = [stream](Block const& lhs, Block const& rhs) {
+            return (lhs.mStream == stream) != (rhs.mStream == stream) ? lhs.mStream == stream
+                                                                      : lhs.mBytes < rhs.mBytes;
+        };
+        for(auto& block : mBlocks)
+        {
+            if(!block.mBusy && block.mBytes >= bytes && (fit == nullptr || prefer(block, *fit)))
+            {
+                fit = &block;
+            }
+        }
+
+        if(fit != nullptr)
+        {
+            if(fit->mStream != stream)
+            {
+                mAllocator.mOrder(fit->mStream, stream);
+                fit->mStream = stream;
+            }
+            fit->mBusy = true;
+            return fit->mData;
+        }
+
+        // Idle blocks too small for the request only give way when memory runs out
+        auto  size = ceilDiv(std::max(bytes, std::size_t(1)), WorkspaceGranularity)
+                    * WorkspaceGranularity;
+        auto* data = mAllocator.mAllocate(size);
+        if(data == nullptr)
+        {
+            auto reserved = mReserved;
+            freeIdle();
+            if(mReserved < reserved)
+            {
+                data = mAllocator.mAllocate(size);
+            }
+        }
+        if(data == nullptr)
+        {
+            return nullptr;
+        }
+
+        mBlocks.push_back({data, size, stream, true});
+        mReserved += size;
+        mHighWaterMark = std::max(mHighWaterMark, mReserved);
+        return data;
+    }
+
+    void WorkspacePool::release(void* block, hipStream_t stream)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for(auto& entry : mBlocks)
+        {
+            if(entry.mData == block)
+            {
+                entry.mStream = stream;
+                entry.mBusy   = false;
+                return;
+            }
+        }
+    }
+
+    std::shared_ptr<void> WorkspacePool::hold(std::size_t bytes, hipStream_t stream)
+    {
+        auto* block = acquire(bytes, stream);
+        if(block == nullptr)
+        {
+            return nullptr;
+        }
+        return std::shared_ptr<void>(block, [this](void* data) { dispose(data); });
+    }
+
+    void WorkspacePool::dispose(void* block)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // hipFree waits for the device, so work still using the block finishes first
+        auto held = std::find_if(mBlocks.begin(), mBlocks.end(), [block](Block const& entry) {
+            return entry.mData == block;
+        });
+        if(held != mBlocks.end())
+        {
+            mAllocator.mFree(held->mData);
+            mReserved -= held->mBytes;
+            mBlocks.erase(held);
+        }
+    }
+
+    void WorkspacePool::trim()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        freeIdle();
+    }
+
+    void WorkspacePool::freeIdle()
+    {
+        // hipFree waits for the device, so blocks still in use by a stream survive
+        // until it is done with them
+        auto kept = std::remove_if(mBlocks.begin(), mBlocks.end(), [this](Block const& block) {
+            if(block.mBusy)
+            {
+                return false;
+            }
+            mAllocator.mFree(block.mData);
+            mReserved -= block.mBytes;
+            return true;
+        });
+        mBlocks.erase(kept, mBlocks.end());
+    }
+
+    std::size_t WorkspacePool::reservedBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mReserved;
+    }
+
+    std::size_t WorkspacePool::highWaterMark() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mHighWaterMark;
+    }
+
+} // namespace hiptensor
@@ -0,0 +1,385 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <algorithm>
+#include <hiptensor/hiptensor.hpp>
+#include <hiptensor/hiptensor_types.hpp>
+#include <hiptensor/internal/hiptensor_utility.hpp>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <unordered_map>
+
+#include "common.hpp"
+
+int main(int argc, char* argv[])
+{
+    /***************************************
+   * Check device support                 *
+   **************************************/
+    if(!isF32Supported())
+    {
+        std::cout << "unsupported host device" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    typedef float ADataType;
+    typedef float BDataType;
+    typedef float CDataType;
+    typedef float floatTypeCompute;
+
+    hipDataType            typeA       = HIP_R_32F;
+    hipDataType            typeB       = HIP_R_32F;
+    hipDataType            typeC       = HIP_R_32F;
+    hiptensorComputeType_t typeCompute = HIPTENSOR_COMPUTE_32F;
+
+    floatTypeCompute alpha = (floatTypeCompute)1.1f;
+    floatTypeCompute beta  = (floatTypeCompute)1.0f;
+
+    constexpr uint32_t numOutputs = 3;
+    constexpr int      iterations = 10;
+
+    /**********************
+   * Computing, for every output g:
+   * C^g_{m,n,u,v} = alpha * A_{m,n,h,k} B^g_{u,v,h,k} + beta * C^g_{m,n,u,v}
+   * A is much larger than the B and C operands, so reading it once for all
+   * outputs saves more traffic than staging B, C and D through the workspace costs.
+   **********************/
+
+    std::vector<int> modeC{'m', 'n', 'u', 'v'};
+    std::vector<int> modeA{'m', 'n', 'h', 'k'};
+    std::vector<int> modeB{'u', 'v', 'h', 'k'};
+
+    int nmodeA = modeA.size();
+    int nmodeB = modeB.size();
+    int nmodeC = modeC.size();
+
+    std::unordered_map<int, int64_t> extent;
+
+    extent['m'] = 64;
+    extent['n'] = 32;
+    extent['u'] = 8;
+    extent['v'] = 8;
+    extent['h'] = 32;
+    extent['k'] = 32;
+
+    std::vector<int64_t> c_ms_ns_lengths;
+    for(auto mode : modeC)
+    {
+        c_ms_ns_lengths.push_back(extent[mode]);
+    }
+
+    std::vector<int64_t> a_ms_ks_lengths;
+    for(auto mode : modeA)
+    {
+        a_ms_ks_lengths.push_back(extent[mode]);
+    }
+
+    std::vector<int64_t> b_ns_ks_lengths;
+    for(auto mode : modeB)
+    {
+        b_ns_ks_lengths.push_back(extent[mode]);
+    }
+
+    hiptensorHandle_t* handle;
+    CHECK_HIPTENSOR_ERROR(hiptensorCreate(&handle));
+
+    /********************************************
+   * Initialize tensors with the input lengths *
+   ********************************************/
+    hiptensorTensorDescriptor_t a_ms_ks;
+    CHECK_HIPTENSOR_ERROR(hiptensorInitTensorDescriptor(handle,
+                                                        &a_ms_ks,
+                                                        nmodeA,
+                                                        a_ms_ks_lengths.data(),
+                                                        NULL, /*stride*/
+                                                        typeA,
+                                                        HIPTENSOR_OP_IDENTITY));
+
+    hiptensorTensorDescriptor_t b_ns_ks;
+    CHECK_HIPTENSOR_ERROR(hiptensorInitTensorDescriptor(handle,
+                                                        &b_ns_ks,
+                                                        nmodeB,
+                                                        b_ns_ks_lengths.data(),
+                                                        NULL, /*stride*/
+                                                        typeB,
+                                                        HIPTENSOR_OP_IDENTITY));
+
+    hiptensorTensorDescriptor_t c_ms_ns;
+    CHECK_HIPTENSOR_ERROR(hiptensorInitTensorDescriptor(handle,
+                                                        &c_ms_ns,
+                                                        nmodeC,
+                                                        c_ms_ns_lengths.data(),
+                                                        NULL, /*stride*/
+                                                        typeC,
+                                                        HIPTENSOR_OP_IDENTITY));
+
+    /**********************
+   * Allocating data
+   **********************/
+    std::cout << "Initializing host data..." << std::endl;
+
+    size_t elementsA = std::accumulate(
+        a_ms_ks_lengths.begin(), a_ms_ks_lengths.end(), size_t{1}, std::multiplies<size_t>());
+    size_t elementsB = std::accumulate(
+        b_ns_ks_lengths.begin(), b_ns_ks_lengths.end(), size_t{1}, std::multiplies<size_t>());
+    size_t elementsC = std::accumulate(
+        c_ms_ns_lengths.begin(), c_ms_ns_lengths.end(), size_t{1}, std::multiplies<size_t>());
+
+    size_t sizeA = sizeof(ADataType) * elementsA;
+    size_t sizeB = sizeof(BDataType) * elementsB;
+    size_t sizeC = sizeof(CDataType) * elementsC;
+
+    std::vector<ADataType> A(elementsA);
+    std::vector<BDataType> B(elementsB);
+    std::vector<CDataType> C(elementsC);
+
+    for(auto& value : A)
+    {
+        value = ((float(std::rand())) / float(RAND_MAX) - 0.5) * 100;
+    }
+
+    void*       A_d = nullptr;
+    const void* B_d[numOutputs];
+    const void* C_d[numOutputs];
+    void*       D_d[numOutputs];
+
+    CHECK_HIP_ERROR(hipMalloc(static_cast<void**>(&A_d), sizeA));
+    CHECK_HIP_ERROR(hipMemcpy(A_d, A.data(), sizeA, hipMemcpyHostToDevice));
+
+    for(uint32_t g = 0; g < numOutputs; g++)
+    {
+        for(auto& value : B)
+        {
+            value = ((float(std::rand())) / float(RAND_MAX) - 0.5) * 100;
+        }
+        for(auto& value : C)
+        {
+            value = ((float(std::rand())) / float(RAND_MAX) - 0.5) * 100;
+        }
+
+        void *b, *c;
+        CHECK_HIP_ERROR(hipMalloc(&b, sizeB));
+        CHECK_HIP_ERROR(hipMalloc(&c, sizeC));
+        CHECK_HIP_ERROR(hipMalloc(&D_d[g], sizeC));
+        CHECK_HIP_ERROR(hipMemcpy(b, B.data(), sizeB, hipMemcpyHostToDevice));
+        CHECK_HIP_ERROR(hipMemcpy(c, C.data(), sizeC, hipMemcpyHostToDevice));
+        B_d[g] = b;
+        C_d[g] = c;
+    }
+
+    /************************************************
+   * Retrieve the memory alignment for each tensor
+   ************************************************/
+
+    uint32_t alignmentRequirementA;
+    CHECK_HIPTENSOR_ERROR(
+        hiptensorGetAlignmentRequirement(handle, A_d, &a_ms_ks, &alignmentRequirementA));
+
+    uint32_t alignmentRequirementB;
+    CHECK_HIPTENSOR_ERROR(
+        hiptensorGetAlignmentRequirement(handle, B_d[0], &b_ns_ks, &alignmentRequirementB));
+
+    uint32_t alignmentRequirementC;
+    CHECK_HIPTENSOR_ERROR(
+        hiptensorGetAlignmentRequirement(handle, C_d[0], &c_ms_ns, &alignmentRequirementC));
+
+    /*******************************
+   * Create Contraction Descriptors
+   *******************************/
+
+    std::cout << "a_ms_ks: " << a_ms_ks << std::endl;
+    std::cout << "b_ns_ks: " << b_ns_ks << std::endl;
+    std::cout << "c_ms_ns: " << c_ms_ns << std::endl;
+
+    hiptensorContractionDescriptor_t desc;
+    CHECK_HIPTENSOR_ERROR(hiptensorInitContractionDescriptor(handle,
+                                                             &desc,
+                                                             &a_ms_ks,
+                                                             modeA.data(),
+                                                             alignmentRequirementA,
+                                                             &b_ns_ks,
+                                                             modeB.data(),
+                                                             alignmentRequirementB,
+                                                             &c_ms_ns,
+                                                             modeC.data(),
+                                                             alignmentRequirementC,
+                                                             &c_ms_ns,
+                                                             modeC.data(),
+                                                             alignmentRequirementC,
+                                                             typeCompute));
+
+    hiptensorContractionDescriptor_t fusedDesc;
+    CHECK_HIPTENSOR_ERROR(hiptensorInitMultiOutputContractionDescriptor(handle,
+                                                                        &fusedDesc,
+                                                                        &a_ms_ks,
+                                                                        modeA.data(),
+                                                                        alignmentRequirementA,
+                                                                        &b_ns_ks,
+                                                                        modeB.data(),
+                                                                        alignmentRequirementB,
+                                                                        &c_ms_ns,
+                                                                        modeC.data(),
+                                                                        alignmentRequirementC,
+                                                                        &c_ms_ns,
+                                                                        modeC.data(),
+                                                                        alignmentRequirementC,
+                                                                        typeCompute,
+                                                                        numOutputs));
+
+    /**************************
+   * Set the algorithm to use
+   ***************************/
+
+    hiptensorContractionFind_t find;
+    CHECK_HIPTENSOR_ERROR(hiptensorInitContractionFind(handle, &find, HIPTENSOR_ALGO_DEFAULT));
+
+    /**********************
+   * Query workspace
+   **********************/
+
+    uint64_t worksize = 0;
+    CHECK_HIPTENSOR_ERROR(hiptensorContractionGetWorkspaceSize(
+        handle, &desc, &find, HIPTENSOR_WORKSPACE_RECOMMENDED, &worksize));
+
+    uint64_t fusedWorksize = 0;
+    CHECK_HIPTENSOR_ERROR(hiptensorContractionGetWorkspaceSize(
+        handle, &fusedDesc, &find, HIPTENSOR_WORKSPACE_RECOMMENDED, &fusedWorksize));
+
+    void* workspace = nullptr;
+    if(std::max(worksize, fusedWorksize) > 0)
+    {
+        CHECK_HIP_ERROR(
+            hipMalloc(static_cast<void**>(&workspace), std::max(worksize, fusedWorksize)));
+    }
+
+    /**************************
+   * Create Contraction Plans
+   **************************/
+    std::cout << "Initializing contraction plans..." << std::endl;
+
+    hiptensorContractionPlan_t plan;
+    CHECK_HIPTENSOR_ERROR(hiptensorInitContractionPlan(handle, &plan, &desc, &find, worksize));
+
+    hiptensorContractionPlan_t fusedPlan;
+    CHECK_HIPTENSOR_ERROR(
+        hiptensorInitContractionPlan(handle, &fusedPlan, &fusedDesc, &find, fusedWorksize));
+
+    /**************************
+   * Benchmark
+   **************************/
+    auto separate = [&]() {
+        for(uint32_t g = 0; g < numOutputs; g++)
+        {
+            CHECK_HIPTENSOR_ERROR(hiptensorContraction(handle,
+                                                       &plan,
+                                                       (void*)&alpha,
+                                                       A_d,
+                                                       B_d[g],
+                                                       (void*)&beta,
+                                                       C_d[g],
+                                                       D_d[g],
+                                                       workspace,
+                                                       worksize,
+                                                       0 /* stream */));
+        }
+    };
+
+    auto fused = [&]() {
+        CHECK_HIPTENSOR_ERROR(hiptensorContractionMultiOutput(handle,
+                                                              &fusedPlan,
+                                                              (void*)&alpha,
+                                                              A_d,
+                                                              B_d,
+                                                              (void*)&beta,
+                                                              C_d,
+                                                              D_d,
+                                                              workspace,
+                                                              fusedWorksize,
+                                                              0 /* stream */));
+    };
+
+    hipEvent_t start, stop;
+    CHECK_HIP_ERROR(hipEventCreate(&start));
+    CHECK_HIP_ERROR(hipEventCreate(&stop));
+
+    auto timeMs = [&](auto&& run) {
+        run(); // warm up
+        CHECK_HIP_ERROR(hipEventRecord(start));
+        for(int i = 0; i < iterations; i++)
+        {
+            run();
+        }
+        CHECK_HIP_ERROR(hipEventRecord(stop));
+        CHECK_HIP_ERROR(hipEventSynchronize(stop));
+
+        float ms = 0.0f;
+        CHECK_HIP_ERROR(hipEventElapsedTime(&ms, start, stop));
+        return ms / iterations;
+    };
+
+    std::cout << "Launching " << numOutputs << " separate contractions..." << std::endl;
+    auto separateMs = timeMs(separate);
+
+    std::cout << "Launching one multi-output contraction..." << std::endl;
+    auto fusedMs = timeMs(fused);
+
+    // Memory traffic of each approach. Separate contractions read A once per output.
+    // The fused kernel reads A once, but B and C of every output are first copied into
+    // one concatenated workspace view and its D is scattered back afterwards, so each
+    // of them is also read and written once more.
+    auto separateBytes = numOutputs * (sizeA + sizeB + 2 * sizeC);
+    auto kernelBytes   = sizeA + numOutputs * (sizeB + 2 * sizeC);
+    auto stagingBytes  = numOutputs * (2 * sizeB + 2 * sizeC + 2 * sizeC);
+    auto fusedBytes    = kernelBytes + stagingBytes;
+
+    std::cout << "Separate: " << separateMs << " ms, " << separateBytes / separateMs / 1.E6
+              << " GB/s of memory traffic" << std::endl;
+    std::cout << "Fused:    " << fusedMs << " ms, " << fusedBytes / fusedMs / 1.E6
+              << " GB/s of memory traffic, of which " << stagingBytes << " bytes staging"
+              << std::endl;
+    std::cout << "A bytes saved by the kernel: " << (numOutputs - 1) * sizeA
+              << ", net traffic change: "
+              << 100.0 * ((double)fusedBytes - (double)separateBytes) / separateBytes << "%"
+              << std::endl;
+
+    CHECK_HIP_ERROR(hipEventDestroy(start));
+    CHECK_HIP_ERROR(hipEventDestroy(stop));
+
+    CHECK_HIPTENSOR_ERROR(hiptensorDestroy(handle));
+
+    HIPTENSOR_FREE_DEVICE(A_d);
+    for(uint32_t g = 0; g < numOutputs; g++)
+    {
+        HIPTENSOR_FREE_DEVICE((void*)B_d[g]);
+        HIPTENSOR_FREE_DEVICE((void*)C_d[g]);
+        HIPTENSOR_FREE_DEVICE(D_d[g]);
+    }
+    HIPTENSOR_FREE_DEVICE(workspace);
+
+    std::cout << "Finished!" << std::endl;
+
+    return 0;
+}
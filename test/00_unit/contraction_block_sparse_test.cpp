@@ -0,0 +1,271 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// hiptensor includes
+#include "contraction_block_sparse.hpp"
+#include "util.hpp"
+#include <hiptensor/hiptensor_types.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+// Block-sparse descriptor storing the listed blocks one after another
+hiptensorBlockSparseTensorDescriptor_t
+    makeDesc(std::vector<hiptensorDimVector_t> const& blockLengths,
+             std::vector<hiptensorDimVector_t> const& blocks)
+{
+    hiptensorBlockSparseTensorDescriptor_t desc = {HIP_R_32F, blockLengths, blocks, {}};
+    uint64_t                               offset = 0;
+    for(std::size_t block = 0; block < blocks.size(); block++)
+    {
+        desc.mOffsets.push_back(offset);
+        offset += hiptensor::elementsFromLengths(hiptensor::blockLengths(desc, block));
+    }
+    return desc;
+}
+
+hiptensorDimVector_t denseLengths(hiptensorBlockSparseTensorDescriptor_t const& desc)
+{
+    hiptensorDimVector_t lengths;
+    for(auto const& splits : desc.mBlockLengths)
+    {
+        std::size_t length = 0;
+        for(auto split : splits)
+        {
+            length += split;
+        }
+        lengths.push_back(length);
+    }
+    return lengths;
+}
+
+// Calls visit(dense offset, stored offset) for every element of the stored blocks of
+// a packed dense tensor
+template <typename Visit>
+void forEachStored(hiptensorBlockSparseTensorDescriptor_t const& desc, Visit visit)
+{
+    auto strides = hiptensor::stridesFromLengths(denseLengths(desc));
+    for(std::size_t block = 0; block < desc.mBlocks.size(); block++)
+    {
+        auto        lengths = hiptensor::blockLengths(desc, block);
+        std::size_t base    = 0;
+        for(int i = 0; i < lengths.size(); i++)
+        {
+            for(std::size_t b = 0; b < desc.mBlocks[block][i]; b++)
+            {
+                base += desc.mBlockLengths[i][b] * strides[i];
+            }
+        }
+
+        auto elements = hiptensor::elementsFromLengths(lengths);
+        for(std::size_t e = 0; e < elements; e++)
+        {
+            std::size_t offset = base, rest = e;
+            for(int i = int(lengths.size()) - 1; i >= 0; i--)
+            {
+                offset += (rest % lengths[i]) * strides[i];
+                rest /= lengths[i];
+            }
+            visit(offset, desc.mOffsets[block] + e);
+        }
+    }
+}
+
+// Dense tensor with zeros outside the stored blocks, and its block-sparse storage
+void fill(hiptensorBlockSparseTensorDescriptor_t const& desc,
+          int                                           seed,
+          std::vector<float>&                           dense,
+          std::vector<float>&                           stored)
+{
+    dense.assign(hiptensor::elementsFromLengths(denseLengths(desc)), 0.0f);
+    stored.assign(dense.size(), 0.0f);
+    forEachStored(desc, [&](std::size_t d, std::size_t s) {
+        dense[d]  = float((d * 7 + seed) % 13) / 13.0f - 0.5f;
+        stored[s] = dense[d];
+    });
+}
+
+// D[i, j] = alpha * A[i, k] * B[k, j] + beta * C[i, j] on dense tensors, with D's
+// modes either in (i, j) or (j, i) order
+std::vector<float> reference(hiptensorDimVector_t const& lengthsD,
+                             bool                        transposeD,
+                             std::size_t                 K,
+                             float                       alpha,
+                             std::vector<float> const&   A,
+                             std::vector<float> const&   B,
+                             float                       beta,
+                             std::vector<float> const&   C)
+{
+    auto I = transposeD ? lengthsD[1] : lengthsD[0];
+    auto J = transposeD ? lengthsD[0] : lengthsD[1];
+
+    std::vector<float> D(I * J, 0.0f);
+    for(std::size_t i = 0; i < I; i++)
+        for(std::size_t j = 0; j < J; j++)
+        {
+            float accum = 0.0f;
+            for(std::size_t k = 0; k < K; k++)
+            {
+                accum += A[i * K + k] * B[k * J + j];
+            }
+            auto out = transposeD ? j * I + i : i * J + j;
+            D[out]   = alpha * accum + (C.empty() ? 0.0f : beta * C[out]);
+        }
+    return D;
+}
+
+bool blockSparseTest(bool transposeD, bool hasC, uint32_t threads)
+{
+    // i is split 2 + 3, k is split 2 + 1 + 2 and j is split 3 + 1
+    std::vector<std::size_t> splitI = {2, 3}, splitK = {2, 1, 2}, splitJ = {3, 1};
+
+    auto descA = makeDesc({splitI, splitK}, {{0, 0}, {0, 2}, {1, 1}, {1, 2}});
+    auto descB = makeDesc({splitK, splitJ}, {{0, 0}, {2, 0}, {2, 1}});
+    auto descD = transposeD ? makeDesc({splitJ, splitI}, {{0, 0}, {1, 0}, {0, 1}, {1, 1}})
+                            : makeDesc({splitI, splitJ}, {{0, 0}, {0, 1}, {1, 0}, {1, 1}});
+
+    int32_t modeA[] = {'i', 'k'};
+    int32_t modeB[] = {'k', 'j'};
+    int32_t modeD[] = {'i', 'j'};
+    int32_t modeT[] = {'j', 'i'};
+
+    hiptensor::BlockSparsePlan plan;
+    if(hiptensor::planBlockSparse(&plan,
+                                  descA,
+                                  modeA,
+                                  descB,
+                                  modeB,
+                                  descD,
+                                  transposeD ? modeT : modeD,
+                                  HIPTENSOR_COMPUTE_32F,
+                                  hasC)
+       != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
+    // A(0, 0) meets B(0, 0), A(0, 2) meets B(2, 0) and B(2, 1), A(1, 2) meets the same
+    // two, and A(1, 1) meets nothing
+    bool pass = plan.taskCount() == 5 && plan.mUntouched.empty();
+
+    std::vector<float> denseA, A, denseB, B, denseC, C;
+    fill(descA, 1, denseA, A);
+    fill(descB, 2, denseB, B);
+    if(hasC)
+    {
+        fill(descD, 3, denseC, C);
+    }
+    std::vector<float> D(hiptensor::elementsFromLengths(denseLengths(descD)), 0.0f);
+
+    float alpha = 1.5f;
+    float beta  = -0.75f;
+    pass &= hiptensor::blockSparseContractionHost(plan,
+                                                  &alpha,
+                                                  A.data(),
+                                                  B.data(),
+                                                  &beta,
+                                                  hasC ? C.data() : nullptr,
+                                                  D.data(),
+                                                  threads)
+            == HIPTENSOR_STATUS_SUCCESS;
+
+    auto ref = reference(denseLengths(descD), transposeD, 5, alpha, denseA, denseB, beta, denseC);
+    forEachStored(descD, [&](std::size_t d, std::size_t s) {
+        pass &= std::fabs(D[s] - ref[d]) < 1e-4f;
+    });
+    return pass;
+}
+
+bool blockSparsePlanTest()
+{
+    std::vector<std::size_t> split = {2, 2};
+
+    int32_t modeA[] = {'i', 'k'};
+    int32_t modeB[] = {'k', 'j'};
+    int32_t modeD[] = {'i', 'j'};
+
+    // D blocks that no pair reaches only take beta * C
+    auto descA = makeDesc({split, split}, {{0, 0}});
+    auto descB = makeDesc({split, split}, {{0, 1}, {1, 1}});
+    auto descD = makeDesc({split, split}, {{0, 1}, {1, 0}});
+
+    hiptensor::BlockSparsePlan plan;
+    bool                       pass
+        = hiptensor::planBlockSparse(
+              &plan, descA, modeA, descB, modeB, descD, modeD, HIPTENSOR_COMPUTE_32F, true)
+              == HIPTENSOR_STATUS_SUCCESS
+          && plan.taskCount() == 1 && plan.mUntouched == std::vector<std::size_t>{1};
+
+    std::vector<float> A(4, 1.0f), B(8, 1.0f), C(8, 2.0f), D(8, 0.0f);
+    float              alpha = 1.0f, beta = 0.5f;
+    pass &= hiptensor::blockSparseContractionHost(
+                plan, &alpha, A.data(), B.data(), &beta, C.data(), D.data(), 2)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= D == std::vector<float>{3.0f, 3.0f, 3.0f, 3.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+
+    // Products into a D block that is not stored are rejected
+    auto partial = makeDesc({split, split}, {{1, 0}});
+    pass &= hiptensor::planBlockSparse(
+                &plan, descA, modeA, descB, modeB, partial, modeD, HIPTENSOR_COMPUTE_32F, true)
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+
+    // Shared modes must be split alike
+    auto resplit = makeDesc({{1, 3}, split}, {{0, 0}});
+    pass &= hiptensor::planBlockSparse(
+                &plan, resplit, modeA, descB, modeB, descD, modeD, HIPTENSOR_COMPUTE_32F, true)
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+
+    // Blocks may only be listed once
+    auto twice = makeDesc({split, split}, {{0, 0}, {0, 0}});
+    pass &= hiptensor::validateBlockSparse(twice) == HIPTENSOR_STATUS_INVALID_VALUE;
+
+    return pass;
+}
+
+int main()
+{
+    bool pass = true;
+    for(auto transposeD : {false, true})
+    {
+        for(auto hasC : {false, true})
+        {
+            for(uint32_t threads : {1u, 3u, 0u})
+            {
+                pass &= blockSparseTest(transposeD, hasC, threads);
+            }
+        }
+    }
+    pass &= blockSparsePlanTest();
+
+    printBool(pass);
+    return pass ? 0 : 1;
+}
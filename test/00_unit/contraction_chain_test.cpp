@@ -0,0 +1,253 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// hiptensor includes
+#include "contraction_chain.hpp"
+#include "data_types.hpp"
+#include <hiptensor/hiptensor_types.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+hiptensorTensorDescriptor_t makeDesc(hipDataType type, hiptensorDimVector_t const& lengths)
+{
+    // Packed, last mode fastest
+    hiptensorDimVector_t strides(lengths.size(), 1);
+    for(int i = (int)lengths.size() - 2; i >= 0; i--)
+    {
+        strides[i] = strides[i + 1] * lengths[i + 1];
+    }
+    return {type, lengths, strides, nullptr};
+}
+
+std::vector<float> fill(std::size_t count, int seed)
+{
+    std::vector<float> values(count);
+    for(int i = 0; i < count; i++)
+    {
+        values[i] = float((i * 7 + seed) % 13) / 13.0f - 0.5f;
+    }
+    return values;
+}
+
+// D[m0, m1, o] = alpha * sum(n0, n1) (sum(k0, k1) A[m0, m1, k0, k1] * B[n0, n1, k0, k1])
+//                                    * C[o, n0, n1], with the intermediate formed whole
+std::vector<float> reference(std::array<hiptensorTensorDescriptor_t, 4> const& t,
+                             float                                             alpha,
+                             std::vector<float> const&                         A,
+                             std::vector<float> const&                         B,
+                             std::vector<float> const&                         C)
+{
+    auto const &a = t[0], &b = t[1], &c = t[2], &d = t[3];
+
+    auto M0 = a.mLengths[0], M1 = a.mLengths[1], K0 = a.mLengths[2], K1 = a.mLengths[3];
+    auto N0 = b.mLengths[0], N1 = b.mLengths[1], O = c.mLengths[0];
+
+    std::vector<float> X(M0 * M1 * N0 * N1, 0.0f);
+    for(std::size_t m = 0; m < M0 * M1; m++)
+        for(std::size_t n = 0; n < N0 * N1; n++)
+            for(std::size_t k0 = 0; k0 < K0; k0++)
+                for(std::size_t k1 = 0; k1 < K1; k1++)
+                {
+                    X[m * N0 * N1 + n] += A[(m / M1) * a.mStrides[0] + (m % M1) * a.mStrides[1]
+                                            + k0 * a.mStrides[2] + k1 * a.mStrides[3]]
+                                          * B[(n / N1) * b.mStrides[0] + (n % N1) * b.mStrides[1]
+                                              + k0 * b.mStrides[2] + k1 * b.mStrides[3]];
+                }
+
+    std::vector<float> D(M0 * M1 * O, 0.0f);
+    for(std::size_t m = 0; m < M0 * M1; m++)
+        for(std::size_t o = 0; o < O; o++)
+        {
+            float accum = 0.0f;
+            for(std::size_t n = 0; n < N0 * N1; n++)
+            {
+                auto offsetC
+                    = o * c.mStrides[0] + (n / N1) * c.mStrides[1] + (n % N1) * c.mStrides[2];
+                accum += X[m * N0 * N1 + n] * C[offsetC];
+            }
+            D[(m / M1) * d.mStrides[0] + (m % M1) * d.mStrides[1] + o * d.mStrides[2]]
+                = alpha * accum;
+        }
+    return D;
+}
+
+bool matches(std::vector<float> const& D, std::vector<float> const& ref)
+{
+    for(int i = 0; i < ref.size(); i++)
+    {
+        if(std::fabs(D[i] - ref[i]) > 1e-3f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool chainTest()
+{
+    int32_t modeA[] = {'m', 'n', 'h', 'k'};
+    int32_t modeB[] = {'u', 'v', 'h', 'k'};
+    int32_t modeC[] = {'o', 'u', 'v'};
+    int32_t modeD[] = {'m', 'n', 'o'};
+
+    std::array<hiptensorTensorDescriptor_t, 4> tensors = {makeDesc(HIP_R_32F, {6, 3, 4, 5}),
+                                                          makeDesc(HIP_R_32F, {2, 3, 4, 5}),
+                                                          makeDesc(HIP_R_32F, {4, 2, 3}),
+                                                          makeDesc(HIP_R_32F, {6, 3, 4})};
+
+    // A is a padded view
+    tensors[0].mStrides = {96, 32, 6, 1};
+
+    auto A = fill(6 * 96, 1);
+    auto B = fill(2 * 3 * 4 * 5, 2);
+    auto C = fill(4 * 2 * 3, 3);
+
+    float alpha = 1.5f;
+    auto  ref   = reference(tensors, alpha, A, B, C);
+
+    // Intermediate rows of 3 * 6 floats: a 150 byte budget splits M into 3 blocks of 2
+    hiptensor::ContractionChain chain;
+    bool pass = hiptensor::analyzeChain(&chain, tensors, {{modeA, modeB, modeC, modeD}}, 150)
+                == HIPTENSOR_STATUS_SUCCESS;
+    pass &= chain.mRankM == 2 && chain.mRankN == 2 && chain.mRankK == 2 && chain.mRankO == 1;
+    pass &= chain.mBlockM == 2 && chain.mBlocks == 3;
+    pass &= chain.mBlock.mLengths == hiptensorDimVector_t{2, 3, 2, 3};
+    pass &= chain.blockOffsets(1) == std::array<std::size_t, 2>{192, 24};
+    pass &= chain.blockTensors()[0].mLengths == hiptensorDimVector_t{2, 3, 4, 5};
+
+    std::vector<float> D(ref.size(), 0.0f);
+    pass &= hiptensor::contractChainHost(chain, &alpha, A.data(), B.data(), C.data(), D.data())
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= matches(D, ref);
+
+    // The default budget holds the whole intermediate
+    pass &= hiptensor::analyzeChain(&chain, tensors, {{modeA, modeB, modeC, modeD}})
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= chain.mBlocks == 1 && chain.mBlockM == 6;
+
+    std::fill(D.begin(), D.end(), 0.0f);
+    pass &= hiptensor::contractChainHost(chain, &alpha, A.data(), B.data(), C.data(), D.data())
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= matches(D, ref);
+
+    // C must be ordered [O, N]
+    int32_t swappedC[] = {'u', 'v', 'o'};
+    auto    swapped    = tensors;
+    swapped[2]         = makeDesc(HIP_R_32F, {2, 3, 4});
+    pass &= hiptensor::analyzeChain(&chain, swapped, {{modeA, modeB, swappedC, modeD}})
+            == HIPTENSOR_STATUS_NOT_SUPPORTED;
+
+    // Shared modes must agree in length
+    auto mismatched = tensors;
+    mismatched[2]   = makeDesc(HIP_R_32F, {4, 2, 5});
+    pass &= hiptensor::analyzeChain(&chain, mismatched, {{modeA, modeB, modeC, modeD}})
+            == HIPTENSOR_STATUS_NOT_SUPPORTED;
+
+    // Operands share one type
+    auto mixed = tensors;
+    mixed[1]   = makeDesc(HIP_R_64F, {2, 3, 4, 5});
+    pass &= hiptensor::analyzeChain(&chain, mixed, {{modeA, modeB, modeC, modeD}})
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+
+    return pass;
+}
+
+bool raggedTest()
+{
+    int32_t modeA[] = {'m', 'n', 'h', 'k'};
+    int32_t modeB[] = {'u', 'v', 'h', 'k'};
+    int32_t modeC[] = {'o', 'u', 'v'};
+    int32_t modeD[] = {'m', 'n', 'o'};
+
+    // A prime outermost M mode has no even split
+    std::array<hiptensorTensorDescriptor_t, 4> tensors = {makeDesc(HIP_R_32F, {7, 3, 4, 5}),
+                                                          makeDesc(HIP_R_32F, {2, 3, 4, 5}),
+                                                          makeDesc(HIP_R_32F, {4, 2, 3}),
+                                                          makeDesc(HIP_R_32F, {7, 3, 4})};
+    tensors[0].mStrides = {96, 32, 6, 1};
+
+    auto A = fill(7 * 96, 4);
+    auto B = fill(2 * 3 * 4 * 5, 5);
+    auto C = fill(4 * 2 * 3, 6);
+
+    float alpha = 0.5f;
+    auto  ref   = reference(tensors, alpha, A, B, C);
+
+    // Rows of 72 bytes: a 150 byte budget runs 3 blocks of 2 and a last block of 1
+    hiptensor::ContractionChain chain;
+    bool pass = hiptensor::analyzeChain(&chain, tensors, {{modeA, modeB, modeC, modeD}}, 150)
+                == HIPTENSOR_STATUS_SUCCESS;
+    pass &= chain.mBlockM == 2 && chain.mLastBlockM == 1 && chain.mBlocks == 4;
+    pass &= chain.raggedLast();
+    pass &= chain.blockTensors(true)[0].mLengths == hiptensorDimVector_t{1, 3, 4, 5};
+    pass &= chain.blockTensors(true)[1].mLengths == hiptensorDimVector_t{1, 3, 4};
+    pass &= chain.blockIntermediate(true).mLengths == hiptensorDimVector_t{1, 3, 2, 3};
+    pass &= chain.blockIntermediate(true).mStrides == hiptensorDimVector_t{18, 6, 3, 1};
+
+    std::vector<float> D(ref.size(), 0.0f);
+    pass &= hiptensor::contractChainHost(chain, &alpha, A.data(), B.data(), C.data(), D.data())
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= matches(D, ref);
+
+    // Blocks are balanced: a budget of 5 rows splits 7 into 4 and 3, not 5 and 2
+    pass &= hiptensor::analyzeChain(&chain, tensors, {{modeA, modeB, modeC, modeD}}, 5 * 72)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= chain.mBlockM == 4 && chain.mLastBlockM == 3 && chain.mBlocks == 2;
+
+    std::fill(D.begin(), D.end(), 0.0f);
+    pass &= hiptensor::contractChainHost(chain, &alpha, A.data(), B.data(), C.data(), D.data())
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= matches(D, ref);
+
+    return pass;
+}
+
+int main(int argc, char* argv[])
+{
+    bool totalPass = true;
+    bool testPass  = false;
+
+    testPass = chainTest();
+    totalPass &= testPass;
+    std::cout << "Back-to-back contraction chain on the host: ";
+    printBool(testPass);
+
+    testPass = raggedTest();
+    totalPass &= testPass;
+    std::cout << "Contraction chain with a ragged last block: ";
+    printBool(testPass);
+
+    if(!totalPass)
+        return -1;
+    return 0;
+}
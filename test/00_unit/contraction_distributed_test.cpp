@@ -0,0 +1,292 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// hiptensor includes
+#include "contraction_distributed.hpp"
+#include "data_types.hpp"
+#include "descriptor_cache.hpp"
+#include "util.hpp"
+#include <hiptensor/hiptensor_types.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+hiptensorTensorDescriptor_t makeDesc(hipDataType type, hiptensorDimVector_t const& lengths)
+{
+    // Packed, last mode fastest
+    hiptensorDimVector_t strides(lengths.size(), 1);
+    for(int i = (int)lengths.size() - 2; i >= 0; i--)
+    {
+        strides[i] = strides[i + 1] * lengths[i + 1];
+    }
+    return {type, lengths, strides, nullptr};
+}
+
+std::size_t offsetOf(hiptensorDimVector_t const& strides, std::array<std::size_t, 4> const& index)
+{
+    std::size_t offset = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        offset += index[i] * strides[i];
+    }
+    return offset;
+}
+
+// D[m0, m1, n0, n1] = alpha * A[m0, m1, k0, k1] * B[n0, n1, k0, k1] + beta * C[m0, m1, n0, n1]
+std::vector<float> reference(hiptensorContractionDescriptor_t const& desc,
+                             float                                   alpha,
+                             std::vector<float> const&               A,
+                             std::vector<float> const&               B,
+                             float                                   beta,
+                             std::vector<float> const&               C)
+{
+    auto const& a    = desc.mTensorDesc[0];
+    auto const& b    = desc.mTensorDesc[1];
+    auto const& c    = desc.mTensorDesc[2];
+    auto const& d    = desc.mTensorDesc[3];
+    auto        hasC = c.mType != hiptensor::NONE_TYPE;
+
+    std::vector<float> D(hiptensor::elementsFromLengths(d.mLengths), 0.0f);
+    for(std::size_t m0 = 0; m0 < d.mLengths[0]; m0++)
+        for(std::size_t m1 = 0; m1 < d.mLengths[1]; m1++)
+            for(std::size_t n0 = 0; n0 < d.mLengths[2]; n0++)
+                for(std::size_t n1 = 0; n1 < d.mLengths[3]; n1++)
+                {
+                    float accum = 0.0f;
+                    for(std::size_t k0 = 0; k0 < a.mLengths[2]; k0++)
+                        for(std::size_t k1 = 0; k1 < a.mLengths[3]; k1++)
+                        {
+                            accum += A[offsetOf(a.mStrides, {m0, m1, k0, k1})]
+                                     * B[offsetOf(b.mStrides, {n0, n1, k0, k1})];
+                        }
+
+                    auto out = offsetOf(d.mStrides, {m0, m1, n0, n1});
+                    D[out]   = alpha * accum
+                             + (hasC ? beta * C[offsetOf(c.mStrides, {m0, m1, n0, n1})] : 0.0f);
+                }
+    return D;
+}
+
+bool matches(std::vector<float> const& D, std::vector<float> const& ref)
+{
+    for(int i = 0; i < D.size(); i++)
+    {
+        if(std::fabs(D[i] - ref[i]) > 1e-3f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<float> fill(std::size_t count, int seed)
+{
+    std::vector<float> values(count);
+    for(int i = 0; i < count; i++)
+    {
+        values[i] = float((i * 7 + seed) % 13) / 13.0f - 0.5f;
+    }
+    return values;
+}
+
+// Copies the blocks of operand i held by a rank between the whole tensor and the
+// rank's packed local buffer
+void exchangeBlocks(hiptensor::DistributedPlan const& plan,
+                    uint32_t                          rank,
+                    int                               i,
+                    std::vector<float>&               whole,
+                    std::vector<float>&               local,
+                    bool                              gather)
+{
+    std::size_t offset = 0;
+    for(auto const& block : plan.localBlocks(rank, i))
+    {
+        if(plan.blockElements(block, i) == 0)
+        {
+            continue;
+        }
+
+        auto lengths = plan.mGeometry.tileLengths(block)[i];
+        auto base    = plan.mGeometry.tileOffsets(block)[i];
+        hiptensor::forEachCopyRun(
+            lengths,
+            plan.mGeometry.mStrides[i],
+            hiptensor::stridesFromLengths(lengths),
+            [&](std::size_t src, std::size_t dst, std::size_t count) {
+                for(std::size_t e = 0; e < count; e++)
+                {
+                    auto& global = whole[base + src + e];
+                    auto& packed = local[offset + dst + e];
+                    (gather ? global : packed) = gather ? packed : global;
+                }
+            });
+        offset += plan.blockElements(block, i);
+    }
+}
+
+// Runs every rank of a distributed contraction on its own thread and compares the
+// gathered D with the reference
+bool distributedTest(hiptensorContractionDescriptor_t const& desc,
+                     uint32_t                                ranks,
+                     hiptensor::DistributedPlan*             plan,
+                     hiptensor::InProcessFabric**            fabric)
+{
+    hiptensor::DescriptorCache cache;
+    auto*                      signature = cache.intern(desc);
+
+    if(hiptensor::planDistributed(plan, *signature, ranks) != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
+    auto hasC = desc.mTensorDesc[2].mType != hiptensor::NONE_TYPE;
+    auto A    = fill(signature->mTensors[0]->mElementSpace, 1);
+    auto B    = fill(signature->mTensors[1]->mElementSpace, 2);
+    auto C    = hasC ? fill(signature->mTensors[2]->mElementSpace, 3) : std::vector<float>{};
+    auto D    = std::vector<float>(signature->mTensors[3]->mElementSpace, 0.0f);
+
+    float alpha = 1.5f;
+    float beta  = -0.75f;
+
+    *fabric = new hiptensor::InProcessFabric(ranks);
+    std::vector<hiptensorStatus_t>               status(ranks, HIPTENSOR_STATUS_SUCCESS);
+    std::vector<std::size_t>                     contractions(ranks, 0);
+    std::vector<std::array<std::vector<float>, 4>> locals(ranks);
+    for(uint32_t rank = 0; rank < ranks; rank++)
+    {
+        std::array<std::vector<float>*, 4> wholes = {&A, &B, &C, &D};
+        for(int i = 0; i < 4; i++)
+        {
+            std::size_t elements = 0;
+            for(auto const& block : plan->localBlocks(rank, i))
+            {
+                elements += plan->blockElements(block, i);
+            }
+            locals[rank][i].assign(elements, 0.0f);
+            if(i < 3)
+            {
+                exchangeBlocks(*plan, rank, i, *wholes[i], locals[rank][i], false);
+            }
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for(uint32_t rank = 0; rank < ranks; rank++)
+    {
+        threads.emplace_back([&, rank]() {
+            hiptensor::HostStreamingBackend backend(std::size_t{1} << 30, HIP_R_32F);
+            auto&                           local = locals[rank];
+            status[rank]       = hiptensor::distributedContraction(*plan,
+                                                             (*fabric)->transport(rank),
+                                                             backend,
+                                                             &alpha,
+                                                             local[0].data(),
+                                                             local[1].data(),
+                                                             &beta,
+                                                             hasC ? local[2].data() : nullptr,
+                                                             local[3].data());
+            contractions[rank] = backend.contractions();
+        });
+    }
+
+    bool pass = true;
+    for(uint32_t rank = 0; rank < ranks; rank++)
+    {
+        threads[rank].join();
+        pass &= status[rank] == HIPTENSOR_STATUS_SUCCESS;
+        exchangeBlocks(*plan, rank, 3, D, locals[rank][3], true);
+
+        // Every rank with a D block contracts each panel once
+        auto block = plan->block(rank / plan->mGrid.mCols, rank % plan->mGrid.mCols, 0);
+        auto empty = block.mExtentM == 0 || block.mExtentN == 0;
+        pass &= contractions[rank] == (empty ? 0 : plan->mPanels);
+    }
+    return pass && matches(D, reference(desc, alpha, A, B, beta, C));
+}
+
+bool distributedContractionTest()
+{
+    auto a = makeDesc(HIP_R_32F, {6, 2, 4, 3});
+    auto b = makeDesc(HIP_R_32F, {5, 2, 4, 3});
+    auto c = makeDesc(HIP_R_32F, {6, 2, 5, 2});
+    auto d = c;
+
+    hiptensorContractionDescriptor_t desc
+        = {0, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{16, 16, 16, 16}}, nullptr};
+
+    hiptensor::DistributedPlan  plan;
+    hiptensor::InProcessFabric* fabric = nullptr;
+
+    // A 2 x 2 grid steps through two K panels, each rank owning one A and one B block
+    bool pass = distributedTest(desc, 4, &plan, &fabric);
+    pass &= plan.mGrid.mRows == 2 && plan.mGrid.mCols == 2 && plan.mPanels == 2;
+    pass &= plan.localBlocks(0, 0).size() == 1 && plan.localBlocks(1, 1).size() == 1;
+
+    // Rank 0 sends its A block (m0 = 0-2, k0 = 0-1) to rank 1 and its B block
+    // (n0 = 0-1, k0 = 0-1) to rank 2
+    auto blockA = 3 * 2 * 2 * 3;
+    auto blockB = 2 * 2 * 2 * 3;
+    pass &= fabric->sentBytes(0) == (blockA + blockB) * sizeof(float);
+    delete fabric;
+
+    // Six ranks form a 3 x 2 grid along the longer M mode, with K in four panels
+    pass &= distributedTest(desc, 6, &plan, &fabric);
+    pass &= plan.mGrid.mRows == 3 && plan.mGrid.mCols == 2 && plan.mPanels == 4;
+    delete fabric;
+
+    // Ranks beyond the extent of N hold no D block and only send
+    pass &= distributedTest(desc, 9, &plan, &fabric);
+    pass &= plan.mGrid.mRows == 3 && plan.mGrid.mCols == 3;
+    delete fabric;
+
+    // A single rank contracts alone
+    pass &= distributedTest(desc, 1, &plan, &fabric);
+    pass &= plan.mPanels == 1 && fabric->sentBytes(0) == 0;
+    delete fabric;
+
+    // Without C, K is not split
+    auto scale           = desc;
+    scale.mTensorDesc[2] = {hipDataType(hiptensor::NONE_TYPE), {}, {}, nullptr};
+    pass &= distributedTest(scale, 4, &plan, &fabric);
+    pass &= plan.mPanels == 1;
+    delete fabric;
+
+    return pass;
+}
+
+int main()
+{
+    bool pass = distributedContractionTest();
+
+    printBool(pass);
+    return pass ? 0 : 1;
+}
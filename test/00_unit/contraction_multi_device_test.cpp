@@ -0,0 +1,218 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// hiptensor includes
+#include "contraction_multi_device.hpp"
+#include "data_types.hpp"
+#include "descriptor_cache.hpp"
+#include <hiptensor/hiptensor_types.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+hiptensorTensorDescriptor_t makeDesc(hipDataType type, hiptensorDimVector_t const& lengths)
+{
+    // Packed, last mode fastest
+    hiptensorDimVector_t strides(lengths.size(), 1);
+    for(int i = (int)lengths.size() - 2; i >= 0; i--)
+    {
+        strides[i] = strides[i + 1] * lengths[i + 1];
+    }
+    return {type, lengths, strides, nullptr};
+}
+
+std::size_t offsetOf(hiptensorDimVector_t const& strides, std::array<std::size_t, 4> const& index)
+{
+    std::size_t offset = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        offset += index[i] * strides[i];
+    }
+    return offset;
+}
+
+// D[m0, m1, n0, n1] = alpha * A[m0, m1, k0, k1] * B[n0, n1, k0, k1] + beta * C[m0, m1, n0, n1]
+std::vector<float> reference(hiptensorContractionDescriptor_t const& desc,
+                             float                                   alpha,
+                             std::vector<float> const&               A,
+                             std::vector<float> const&               B,
+                             float                                   beta,
+                             std::vector<float> const&               C)
+{
+    auto const& a = desc.mTensorDesc[0];
+    auto const& b = desc.mTensorDesc[1];
+    auto const& c = desc.mTensorDesc[2];
+    auto const& d = desc.mTensorDesc[3];
+
+    std::vector<float> D(C.size(), 0.0f);
+    for(std::size_t m0 = 0; m0 < d.mLengths[0]; m0++)
+        for(std::size_t m1 = 0; m1 < d.mLengths[1]; m1++)
+            for(std::size_t n0 = 0; n0 < d.mLengths[2]; n0++)
+                for(std::size_t n1 = 0; n1 < d.mLengths[3]; n1++)
+                {
+                    float accum = 0.0f;
+                    for(std::size_t k0 = 0; k0 < a.mLengths[2]; k0++)
+                        for(std::size_t k1 = 0; k1 < a.mLengths[3]; k1++)
+                        {
+                            accum += A[offsetOf(a.mStrides, {m0, m1, k0, k1})]
+                                     * B[offsetOf(b.mStrides, {n0, n1, k0, k1})];
+                        }
+
+                    auto out = offsetOf(d.mStrides, {m0, m1, n0, n1});
+                    D[out]   = alpha * accum + beta * C[offsetOf(c.mStrides, {m0, m1, n0, n1})];
+                }
+    return D;
+}
+
+bool matches(std::vector<float> const& D, std::vector<float> const& ref)
+{
+    for(int i = 0; i < D.size(); i++)
+    {
+        if(std::fabs(D[i] - ref[i]) > 1e-3f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<float> fill(std::size_t count, int seed)
+{
+    std::vector<float> values(count);
+    for(int i = 0; i < count; i++)
+    {
+        values[i] = float((i * 7 + seed) % 13) / 13.0f - 0.5f;
+    }
+    return values;
+}
+
+// Splits the contraction over simulated devices and compares with the reference
+bool splitTest(hiptensorContractionDescriptor_t const& desc,
+               std::vector<double> const&              weights,
+               hiptensor::MultiDevicePlan*             plan,
+               hiptensor::HostMultiDeviceBackend*      backend)
+{
+    hiptensor::DescriptorCache cache;
+    auto*                      signature = cache.intern(desc);
+
+    if(hiptensor::planMultiDevice(plan, *signature, weights) != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
+    auto A = fill(signature->mTensors[0]->mElementSpace, 1);
+    auto B = fill(signature->mTensors[1]->mElementSpace, 2);
+    auto C = fill(signature->mTensors[2]->mElementSpace, 3);
+    auto D = std::vector<float>(C.size(), 0.0f);
+
+    float alpha  = 1.5f;
+    float beta   = -0.75f;
+    auto  status = hiptensor::multiDeviceContraction(
+        *plan, *backend, &alpha, A.data(), B.data(), &beta, C.data(), D.data());
+
+    // Device 0 works in place and every block is released
+    bool pass = status == HIPTENSOR_STATUS_SUCCESS
+                && matches(D, reference(desc, alpha, A, B, beta, C));
+    pass &= backend->peakBytes(0) == 0 && backend->copiedBytes(0) == 0 && backend->joins() == 1;
+    for(auto const& share : plan->mShares)
+    {
+        pass &= backend->contractions(share.mDevice) == 1;
+        if(share.mDevice != 0)
+        {
+            pass &= backend->peakBytes(share.mDevice) == plan->shareBytes(share);
+        }
+    }
+    return pass;
+}
+
+bool multiDeviceTest()
+{
+    // A is a padded view and B is the smaller input
+    auto a = makeDesc(HIP_R_32F, {6, 2, 3, 4});
+    auto b = makeDesc(HIP_R_32F, {5, 2, 3, 4});
+    auto c = makeDesc(HIP_R_32F, {6, 2, 5, 2});
+    auto d     = c;
+    a.mStrides = {128, 64, 16, 1};
+
+    hiptensorContractionDescriptor_t desc
+        = {0, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{16, 16, 16, 16}}, nullptr};
+
+    // M is split in proportion to the weights, the remainder going to the largest fraction
+    hiptensor::MultiDevicePlan        plan;
+    hiptensor::HostMultiDeviceBackend weighted(3, HIP_R_32F);
+    bool pass = splitTest(desc, {2.0, 1.0, 1.0}, &plan, &weighted);
+    pass &= !plan.mSplitN && plan.mShares.size() == 3;
+    pass &= plan.mShares[0].mExtent == 3 && plan.mShares[1].mStart == 3
+            && plan.mShares[1].mExtent == 2 && plan.mShares[2].mExtent == 1;
+
+    // Device 1 receives its A and C blocks and the whole of B, and returns its D block
+    auto blockA = 2 * 2 * 3 * 4;
+    auto blockD = 2 * 2 * 5 * 2;
+    pass &= weighted.copiedBytes(1) == (blockA + 5 * 2 * 3 * 4 + 2 * blockD) * sizeof(float);
+
+    // With the larger B, N is split and A is replicated instead
+    auto wide           = desc;
+    wide.mTensorDesc[0] = makeDesc(HIP_R_32F, {2, 2, 3, 4});
+    wide.mTensorDesc[1] = makeDesc(HIP_R_32F, {8, 2, 3, 4});
+    wide.mTensorDesc[2] = makeDesc(HIP_R_32F, {2, 2, 8, 2});
+    wide.mTensorDesc[3] = wide.mTensorDesc[2];
+    hiptensor::HostMultiDeviceBackend split(2, HIP_R_32F);
+    pass &= splitTest(wide, {1.0, 1.0}, &plan, &split);
+    pass &= plan.mSplitN && plan.mShares.size() == 2 && plan.mShares[1].mStart == 4;
+
+    // Devices beyond the extent of the split mode are left out
+    hiptensor::HostMultiDeviceBackend crowded(8, HIP_R_32F);
+    pass &= splitTest(desc, std::vector<double>(8, 1.0), &plan, &crowded);
+    pass &= plan.mShares.size() == 6 && plan.mShares.back().mDevice == 5;
+    pass &= crowded.contractions(6) == 0 && crowded.contractions(7) == 0;
+
+    // A single device contracts in place
+    hiptensor::HostMultiDeviceBackend single(1, HIP_R_32F);
+    pass &= splitTest(desc, {1.0}, &plan, &single);
+    pass &= plan.mShares.size() == 1 && plan.mShares[0].mExtent == 6;
+
+    // Weights must be positive
+    hiptensor::DescriptorCache cache;
+    pass &= hiptensor::planMultiDevice(&plan, *cache.intern(desc), {1.0, 0.0})
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+    pass &= hiptensor::planMultiDevice(&plan, *cache.intern(desc), {})
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+
+    return pass;
+}
+
+int main()
+{
+    bool pass = multiDeviceTest();
+
+    printBool(pass);
+    return pass ? 0 : 1;
+}
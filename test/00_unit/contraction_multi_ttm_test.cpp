@@ -0,0 +1,195 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// hiptensor includes
+#include "contraction_multi_ttm.hpp"
+#include "util.hpp"
+#include <hiptensor/hiptensor_types.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+std::vector<double> fill(std::size_t count, int seed)
+{
+    std::vector<double> values(count);
+    for(int i = 0; i < count; i++)
+    {
+        values[i] = double((i * 7 + seed) % 13) / 13.0 - 0.5;
+    }
+    return values;
+}
+
+// Y[r0, i1, r2, r3] = alpha * U0[r0, i0] * U2[r2, i2] * U3[r3, i3] * X[i0, i1, i2, i3]
+//                   + beta * C[r0, i1, r2, r3]
+std::vector<double> reference(hiptensorDimVector_t const&       lengths,
+                              std::vector<std::size_t> const&   ranks,
+                              std::vector<double> const&        X,
+                              std::vector<std::vector<double>>& U,
+                              double                            alpha,
+                              double                            beta,
+                              std::vector<double> const&        C)
+{
+    hiptensorDimVector_t out = {ranks[0], lengths[1], ranks[1], ranks[2]};
+    auto                 strides = hiptensor::stridesFromLengths(lengths);
+
+    std::vector<double> Y(hiptensor::elementsFromLengths(out), 0.0);
+    for(std::size_t r0 = 0; r0 < out[0]; r0++)
+        for(std::size_t i1 = 0; i1 < out[1]; i1++)
+            for(std::size_t r2 = 0; r2 < out[2]; r2++)
+                for(std::size_t r3 = 0; r3 < out[3]; r3++)
+                {
+                    double accum = 0.0;
+                    for(std::size_t i0 = 0; i0 < lengths[0]; i0++)
+                        for(std::size_t i2 = 0; i2 < lengths[2]; i2++)
+                            for(std::size_t i3 = 0; i3 < lengths[3]; i3++)
+                            {
+                                accum += U[0][r0 * lengths[0] + i0] * U[1][r2 * lengths[2] + i2]
+                                         * U[2][r3 * lengths[3] + i3]
+                                         * X[i0 * strides[0] + i1 * strides[1] + i2 * strides[2]
+                                             + i3 * strides[3]];
+                            }
+
+                    auto y = ((r0 * out[1] + i1) * out[2] + r2) * out[3] + r3;
+                    Y[y]   = alpha * accum + (C.empty() ? 0.0 : beta * C[y]);
+                }
+    return Y;
+}
+
+bool multiTtmTest(std::vector<std::size_t> const& ranks, bool hasC)
+{
+    hiptensorDimVector_t  lengths = {6, 5, 7, 4};
+    std::vector<uint32_t> modes   = {0, 2, 3};
+
+    hiptensor::MultiTtmPlan plan;
+    if(hiptensor::planMultiTtm(&plan, HIP_R_64F, lengths, modes, ranks, hasC)
+       != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
+    // No order of the products takes fewer multiply-adds
+    std::vector<uint32_t> order = {0, 1, 2};
+    bool                  pass  = plan.mSteps.size() == 3;
+    do
+    {
+        auto cost = hiptensor::multiTtmMultiplyAdds(lengths, modes, ranks, order);
+        pass &= plan.mMultiplyAdds <= cost;
+    } while(std::next_permutation(order.begin(), order.end()));
+
+    std::vector<uint32_t> chosen;
+    for(auto const& step : plan.mSteps)
+    {
+        chosen.push_back(step.mMatrix);
+    }
+    pass &= hiptensor::multiTtmMultiplyAdds(lengths, modes, ranks, chosen) == plan.mMultiplyAdds;
+
+    auto                             X = fill(hiptensor::elementsFromLengths(lengths), 1);
+    std::vector<std::vector<double>> U;
+    std::vector<void const*>         matrices;
+    for(int j = 0; j < 3; j++)
+    {
+        U.push_back(fill(ranks[j] * lengths[modes[j]], j + 2));
+        matrices.push_back(U.back().data());
+    }
+
+    auto   outElements = ranks[0] * lengths[1] * ranks[1] * ranks[2];
+    auto   C           = hasC ? fill(outElements, 7) : std::vector<double>{};
+    double alpha       = 1.5;
+    double beta        = -0.75;
+    auto   ref         = reference(lengths, ranks, X, U, alpha, beta, C);
+
+    for(uint32_t threads : {1u, 3u, 0u})
+    {
+        std::vector<double> Y(outElements, 0.0);
+        pass &= hiptensor::multiTtmHost(plan,
+                                        &alpha,
+                                        X.data(),
+                                        matrices.data(),
+                                        &beta,
+                                        hasC ? C.data() : nullptr,
+                                        Y.data(),
+                                        threads)
+                == HIPTENSOR_STATUS_SUCCESS;
+        for(std::size_t i = 0; i < Y.size(); i++)
+        {
+            pass &= std::fabs(Y[i] - ref[i]) < 1e-9;
+        }
+    }
+    return pass;
+}
+
+bool orderTest()
+{
+    hiptensor::MultiTtmPlan plan;
+
+    // Shrinking modes go first: applying the 2-row matrix first leaves a third of the
+    // tensor for the growing one
+    bool pass = hiptensor::planMultiTtm(&plan, HIP_R_64F, {6, 6}, {0, 1}, {12, 2}, false)
+                == HIPTENSOR_STATUS_SUCCESS;
+    pass &= plan.mSteps.size() == 2 && plan.mSteps[0].mMatrix == 1
+            && plan.mMultiplyAdds == 6 * 6 * 2 + 6 * 2 * 12;
+    pass &= plan.mSteps[0].mLengthsOut == hiptensorDimVector_t{6, 2};
+    pass &= plan.mIntermediateElements == 12;
+
+    // Both orders take 72 multiply-adds; the second matrix first leaves 9 elements
+    // between the steps rather than 12
+    pass &= hiptensor::planMultiTtm(&plan, HIP_R_64F, {3, 6}, {0, 1}, {2, 3}, false)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= plan.mMultiplyAdds == 72 && plan.mSteps[0].mMatrix == 1
+            && plan.mIntermediateElements == 9;
+
+    // Without matrices Y = alpha * X + beta * C
+    pass &= hiptensor::planMultiTtm(&plan, HIP_R_32F, {3, 2}, {}, {}, true)
+            == HIPTENSOR_STATUS_SUCCESS;
+    std::vector<float> X = {1, 2, 3, 4, 5, 6}, C(6, 1.0f), Y(6, 0.0f);
+    float              alpha = 2.0f, beta = -1.0f;
+    pass &= hiptensor::multiTtmHost(plan, &alpha, X.data(), nullptr, &beta, C.data(), Y.data(), 1)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= Y == std::vector<float>{1, 3, 5, 7, 9, 11};
+
+    // Each mode takes at most one matrix
+    pass &= hiptensor::planMultiTtm(&plan, HIP_R_32F, {3, 2}, {1, 1}, {2, 2}, false)
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+    return pass;
+}
+
+int main()
+{
+    bool pass = orderTest();
+    pass &= multiTtmTest({2, 3, 2}, false);
+    pass &= multiTtmTest({9, 2, 5}, true);
+    pass &= multiTtmTest({6, 7, 4}, true);
+
+    printBool(pass);
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,546 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+// hiptensor includes
+#include "contraction_streaming.hpp"
+#include "data_types.hpp"
+#include "descriptor_cache.hpp"
+#include "tensor_file.hpp"
+#include <hiptensor/hiptensor_types.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+hiptensorTensorDescriptor_t makeDesc(hipDataType type, hiptensorDimVector_t const& lengths)
+{
+    // Packed, last mode fastest
+    hiptensorDimVector_t strides(lengths.size(), 1);
+    for(int i = (int)lengths.size() - 2; i >= 0; i--)
+    {
+        strides[i] = strides[i + 1] * lengths[i + 1];
+    }
+    return {type, lengths, strides, nullptr};
+}
+
+std::size_t offsetOf(hiptensorDimVector_t const& strides, std::array<std::size_t, 4> const& index)
+{
+    std::size_t offset = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        offset += index[i] * strides[i];
+    }
+    return offset;
+}
+
+// D[m0, m1, n0, n1] = alpha * A[m0, m1, k0, k1] * B[n0, n1, k0, k1] + beta * C[m0, m1, n0, n1]
+std::vector<float> reference(hiptensorContractionDescriptor_t const& desc,
+                             float                                   alpha,
+                             std::vector<float> const&               A,
+                             std::vector<float> const&               B,
+                             float                                   beta,
+                             std::vector<float> const&               C)
+{
+    auto const& a = desc.mTensorDesc[0];
+    auto const& b = desc.mTensorDesc[1];
+    auto const& c = desc.mTensorDesc[2];
+    auto const& d = desc.mTensorDesc[3];
+
+    std::vector<float> D(A.size() + B.size() + C.size() + 4096, 0.0f);
+    for(std::size_t m0 = 0; m0 < d.mLengths[0]; m0++)
+        for(std::size_t m1 = 0; m1 < d.mLengths[1]; m1++)
+            for(std::size_t n0 = 0; n0 < d.mLengths[2]; n0++)
+                for(std::size_t n1 = 0; n1 < d.mLengths[3]; n1++)
+                {
+                    float accum = 0.0f;
+                    for(std::size_t k0 = 0; k0 < a.mLengths[2]; k0++)
+                        for(std::size_t k1 = 0; k1 < a.mLengths[3]; k1++)
+                        {
+                            accum += A[offsetOf(a.mStrides, {m0, m1, k0, k1})]
+                                     * B[offsetOf(b.mStrides, {n0, n1, k0, k1})];
+                        }
+
+                    auto out = offsetOf(d.mStrides, {m0, m1, n0, n1});
+                    D[out]   = alpha * accum;
+                    if(c.mType != hiptensor::NONE_TYPE)
+                    {
+                        D[out] += beta * C[offsetOf(c.mStrides, {m0, m1, n0, n1})];
+                    }
+                }
+    return D;
+}
+
+bool matches(std::vector<float> const& D, std::vector<float> const& ref)
+{
+    for(int i = 0; i < D.size(); i++)
+    {
+        if(std::fabs(D[i] - ref[i]) > 1e-3f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<float> fill(std::size_t count, int seed)
+{
+    std::vector<float> values(count);
+    for(int i = 0; i < count; i++)
+    {
+        values[i] = float((i * 7 + seed) % 13) / 13.0f - 0.5f;
+    }
+    return values;
+}
+
+// Streams the contraction through the host backend and compares with the reference
+bool streamTest(hiptensorContractionDescriptor_t const& desc,
+                std::size_t                             capacityBytes,
+                uint32_t                                slots,
+                hiptensor::StreamingPlan*               plan,
+                hiptensor::HostStreamingBackend*        backend)
+{
+    hiptensor::DescriptorCache cache;
+    auto*                      signature = cache.intern(desc);
+
+    if(hiptensor::planStreaming(plan, *signature, capacityBytes, 0, slots)
+       != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
+    auto A = fill(signature->mTensors[0]->mElementSpace, 1);
+    auto B = fill(signature->mTensors[1]->mElementSpace, 2);
+    auto C = fill(signature->mTensors[3]->mElementSpace, 3);
+    auto D = std::vector<float>(C.size(), 0.0f);
+
+    float alpha = 1.5f;
+    float beta  = -0.75f;
+    auto  status = hiptensor::streamContraction(
+        *plan, *backend, &alpha, A.data(), B.data(), &beta, C.data(), D.data());
+
+    auto ref = reference(desc, alpha, A, B, beta, C);
+    ref.resize(D.size());
+    return status == HIPTENSOR_STATUS_SUCCESS && matches(D, ref)
+           && backend->peakBytes() <= capacityBytes;
+}
+
+bool streamingTest()
+{
+    auto a = makeDesc(HIP_R_32F, {4, 3, 16, 8});
+    auto b = makeDesc(HIP_R_32F, {5, 2, 16, 8});
+    auto c = makeDesc(HIP_R_32F, {4, 3, 5, 2});
+    auto d = c;
+
+    // A is a padded host view
+    a.mStrides = {512, 160, 9, 1};
+
+    hiptensorContractionDescriptor_t desc
+        = {0, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{16, 16, 16, 16}}, nullptr};
+
+    // Everything fits a single slot: one tile
+    hiptensor::StreamingPlan        plan;
+    hiptensor::HostStreamingBackend whole(1 << 20, HIP_R_32F);
+    bool pass = streamTest(desc, 1 << 20, 1, &plan, &whole);
+    pass &= plan.tiles().size() == 1 && whole.contractions() == 1;
+
+    // More slots than output tiles: outputs are split so that every slot is used
+    hiptensor::HostStreamingBackend spread(1 << 20, HIP_R_32F);
+    pass &= streamTest(desc, 1 << 20, 3, &plan, &spread);
+    pass &= plan.outputTiles() >= 3 && plan.mTileK == plan.mOuterK && spread.slotsUsed() == 3;
+
+    // Double buffering through 1 KB slots splits M, N and K
+    hiptensor::HostStreamingBackend doubled(2048, HIP_R_32F);
+    pass &= streamTest(desc, 2048, 2, &plan, &doubled);
+    pass &= plan.mSlotBytes <= 1024 && plan.outputTiles() >= 2 && plan.mTileK < plan.mOuterK;
+    pass &= doubled.slotsUsed() == 2 && doubled.contractions() == plan.tiles().size();
+
+    // Triple buffering through the same slot size
+    hiptensor::HostStreamingBackend tripled(3072, HIP_R_32F);
+    pass &= streamTest(desc, 3072, 3, &plan, &tripled);
+    pass &= plan.mSlotBytes <= 1024 && tripled.slotsUsed() == 3;
+
+    // Without C, partial products cannot be accumulated, so K stays whole
+    auto scale           = desc;
+    scale.mTensorDesc[2] = hiptensorTensorDescriptor_t{
+        hiptensor::NONE_TYPE, hiptensorDimVector_t(4, 0), hiptensorDimVector_t(4, 0), nullptr};
+    hiptensor::HostStreamingBackend noC(8192, HIP_R_32F);
+    pass &= streamTest(scale, 8192, 2, &plan, &noC);
+    pass &= plan.mTileK == plan.mOuterK && plan.outputTiles() > 1;
+
+    // Three 256 byte tiles per slot is the least a slot can hold
+    hiptensor::DescriptorCache cache;
+    pass &= hiptensor::planStreaming(&plan, *cache.intern(desc), 1024, 0, 2)
+            == HIPTENSOR_STATUS_INSUFFICIENT_WORKSPACE;
+
+    return pass;
+}
+
+bool copyRunTest()
+{
+    // Packed inner modes merge into a single run
+    std::vector<std::array<std::size_t, 3>> runs;
+    auto record = [&](std::size_t src, std::size_t dst, std::size_t count) {
+        runs.push_back({src, dst, count});
+    };
+
+    hiptensor::forEachCopyRun({2, 3, 4}, {12, 4, 1}, {12, 4, 1}, record);
+    bool pass = runs.size() == 1 && runs[0][2] == 24;
+
+    // A padded source keeps one run per padded row
+    runs.clear();
+    hiptensor::forEachCopyRun({2, 3, 4}, {32, 8, 1}, {12, 4, 1}, record);
+    pass &= runs.size() == 6 && runs[5] == std::array<std::size_t, 3>{48, 20, 4};
+
+    // Length-1 modes are skipped and zero lengths copy nothing
+    runs.clear();
+    hiptensor::forEachCopyRun({1, 3, 1}, {100, 2, 7}, {3, 1, 1}, record);
+    pass &= runs.size() == 3 && runs[2] == std::array<std::size_t, 3>{4, 2, 1};
+
+    runs.clear();
+    hiptensor::forEachCopyRun({2, 0, 4}, {12, 4, 1}, {12, 4, 1}, record);
+    pass &= runs.empty();
+
+    return pass;
+}
+
+bool prepackedTest()
+{
+    auto a = makeDesc(HIP_R_32F, {4, 3, 16, 8});
+    auto b = makeDesc(HIP_R_32F, {5, 2, 16, 8});
+    auto c = makeDesc(HIP_R_32F, {4, 3, 5, 2});
+    auto d = c;
+
+    // B is a padded host view; its 10 flattened rows leave a partial second panel
+    b.mStrides = {320, 160, 10, 1};
+
+    hiptensorContractionDescriptor_t desc
+        = {0, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{16, 16, 16, 16}}, nullptr};
+
+    hiptensor::DescriptorCache cache;
+    auto*                      signature = cache.intern(desc);
+
+    // Four 1 KB slots split N across a panel boundary and K into several tiles
+    hiptensor::StreamingPlan plan;
+    bool pass = hiptensor::planStreaming(&plan, *signature, 4096, 0, 4) == HIPTENSOR_STATUS_SUCCESS;
+    pass &= plan.mTileN == 3 && plan.mTileK < plan.mOuterK;
+
+    auto B = fill(signature->mTensors[1]->mElementSpace, 2);
+    auto C = fill(signature->mTensors[2]->mElementSpace, 3);
+
+    // B is packed into panels once and reused by every contraction
+    hiptensor::HostPackedOperand packed;
+    pass &= hiptensor::packHostOperand(&packed, plan, B.data()) == HIPTENSOR_STATUS_SUCCESS;
+    pass &= packed.mN == 10 && packed.mK == 128 && packed.mInnerN == 2 && packed.mInnerK == 8;
+    pass &= packed.mPanels.size() == 2 * hiptensor::HostPanelWidth * 128 * sizeof(float);
+
+    float alpha = 1.5f;
+    float beta  = -0.75f;
+    for(int seed = 1; seed <= 2; seed++)
+    {
+        auto A = fill(signature->mTensors[0]->mElementSpace, seed);
+        auto D = std::vector<float>(C.size(), 0.0f);
+
+        hiptensor::HostStreamingBackend backend(4096, HIP_R_32F);
+        pass &= hiptensor::streamContraction(plan,
+                                             backend,
+                                             &alpha,
+                                             A.data(),
+                                             nullptr,
+                                             &beta,
+                                             C.data(),
+                                             D.data(),
+                                             nullptr,
+                                             &packed)
+                == HIPTENSOR_STATUS_SUCCESS;
+
+        // Only A and C tiles are uploaded
+        pass &= backend.uploads() == plan.tiles().size() + plan.outputTiles();
+
+        auto ref = reference(desc, alpha, A, B, beta, C);
+        ref.resize(D.size());
+        pass &= matches(D, ref);
+    }
+
+    // A packing of another type is rejected
+    auto doubles  = packed;
+    doubles.mType = HIP_R_64F;
+
+    hiptensor::HostStreamingBackend backend(4096, HIP_R_32F);
+    std::vector<float>              A(signature->mTensors[0]->mElementSpace);
+    std::vector<float>              D(C.size());
+
+    auto status = hiptensor::streamContraction(
+        plan, backend, &alpha, A.data(), nullptr, &beta, C.data(), D.data(), nullptr, &doubles);
+    pass &= status == HIPTENSOR_STATUS_INVALID_VALUE;
+
+    return pass;
+}
+
+// Counts the hints forwarded to the mapped files
+struct CountingHints : public hiptensor::MappedTensorHints
+{
+    using hiptensor::MappedTensorHints::MappedTensorHints;
+
+    void willNeed(int i, std::size_t offset, std::size_t bytes) override
+    {
+        mWillNeed++;
+        hiptensor::MappedTensorHints::willNeed(i, offset, bytes);
+    }
+
+    void dontNeed(int i, std::size_t offset, std::size_t bytes) override
+    {
+        mDontNeed++;
+        hiptensor::MappedTensorHints::dontNeed(i, offset, bytes);
+    }
+
+    std::size_t mWillNeed = 0;
+    std::size_t mDontNeed = 0;
+};
+
+bool mappedFileTest()
+{
+    auto a = makeDesc(HIP_R_32F, {4, 3, 16, 8});
+    auto b = makeDesc(HIP_R_32F, {5, 2, 16, 8});
+    auto c = makeDesc(HIP_R_32F, {4, 3, 5, 2});
+    auto d = c;
+    a.mStrides = {512, 160, 9, 1};
+
+    hiptensorContractionDescriptor_t desc
+        = {0, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{16, 16, 16, 16}}, nullptr};
+
+    hiptensor::DescriptorCache cache;
+    auto*                      signature = cache.intern(desc);
+
+    auto A = fill(signature->mTensors[0]->mElementSpace, 1);
+    auto B = fill(signature->mTensors[1]->mElementSpace, 2);
+    auto C = fill(signature->mTensors[2]->mElementSpace, 3);
+
+    // Operands go to disk with their descriptors; D starts as zeros
+    std::array<std::string, 4> paths = {"contraction_streaming_test_A.bin",
+                                        "contraction_streaming_test_B.bin",
+                                        "contraction_streaming_test_C.bin",
+                                        "contraction_streaming_test_D.bin"};
+    std::array<void const*, 4> data  = {A.data(), B.data(), C.data(), nullptr};
+
+    bool                                       pass = true;
+    std::array<hiptensor::MappedTensorFile, 4> files;
+    for(int i = 0; i < files.size(); i++)
+    {
+        pass &= hiptensor::MappedTensorFile::write(paths[i], desc.mTensorDesc[i], data[i])
+                == HIPTENSOR_STATUS_SUCCESS;
+        pass &= files[i].open(paths[i], i == 3) == HIPTENSOR_STATUS_SUCCESS;
+        pass &= files[i].descriptor().mType == HIP_R_32F
+                && files[i].descriptor().mLengths == desc.mTensorDesc[i].mLengths
+                && files[i].descriptor().mStrides == desc.mTensorDesc[i].mStrides;
+    }
+    pass &= files[0].bytes() == A.size() * sizeof(float);
+
+    // Stream with 1 KB slots straight from the mappings
+    hiptensor::StreamingPlan        plan;
+    hiptensor::HostStreamingBackend backend(2048, HIP_R_32F);
+    CountingHints                   hints({&files[0], &files[1], &files[2], &files[3]});
+    pass &= hiptensor::planStreaming(&plan, *signature, 2048, 0, 2) == HIPTENSOR_STATUS_SUCCESS;
+
+    float alpha = 1.5f;
+    float beta  = -0.75f;
+    pass &= hiptensor::streamContraction(plan,
+                                         backend,
+                                         &alpha,
+                                         files[0].data(),
+                                         files[1].data(),
+                                         &beta,
+                                         files[2].data(),
+                                         files[3].data(),
+                                         &hints)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= hints.mWillNeed > plan.tiles().size() && hints.mDontNeed > 0;
+
+    auto ref  = reference(desc, alpha, A, B, beta, C);
+    auto D    = static_cast<float const*>(files[3].data());
+    auto size = files[3].bytes() / sizeof(float);
+    ref.resize(size);
+    pass &= matches(std::vector<float>(D, D + size), ref);
+
+    // Results persist in the file
+    files[3].close();
+    hiptensor::MappedTensorFile reopened;
+    pass &= reopened.open(paths[3]) == HIPTENSOR_STATUS_SUCCESS
+            && std::fabs(static_cast<float const*>(reopened.data())[7] - ref[7]) < 1e-3f;
+
+    // Anything else is rejected
+    hiptensor::MappedTensorFile missing;
+    pass &= missing.open("contraction_streaming_test_missing.bin") == HIPTENSOR_STATUS_IO_ERROR;
+
+    // Headers whose type, data range or data size do not hold up are invalid
+    files[0].close();
+    auto corrupt = [&](std::size_t offset, uint64_t value, std::size_t bytes) {
+        auto* file = std::fopen(paths[0].c_str(), "r+b");
+        std::fseek(file, offset, SEEK_SET);
+        std::fwrite(&value, bytes, 1, file);
+        std::fclose(file);
+
+        hiptensor::MappedTensorFile invalid;
+        auto                        status = invalid.open(paths[0]);
+        hiptensor::MappedTensorFile::write(paths[0], desc.mTensorDesc[0], A.data());
+        return status == HIPTENSOR_STATUS_INVALID_VALUE;
+    };
+    pass &= corrupt(12, 0x7fff, sizeof(int32_t));
+    pass &= corrupt(24, ~uint64_t(0) - 1, sizeof(uint64_t));
+    pass &= corrupt(32, (A.size() - 1) * sizeof(float), sizeof(uint64_t));
+    pass &= corrupt(24, 0, sizeof(uint64_t));
+
+    for(auto& path : paths)
+    {
+        std::remove(path.c_str());
+    }
+    return pass;
+}
+
+bool multiOutputTest()
+{
+    auto a = makeDesc(HIP_R_32F, {4, 3, 16, 8});
+    auto b = makeDesc(HIP_R_32F, {5, 2, 16, 8});
+    auto c = makeDesc(HIP_R_32F, {4, 3, 5, 2});
+    auto d = c;
+
+    // Every B is a padded host view; the outputs are concatenated along n0
+    b.mStrides = {320, 160, 10, 1};
+
+    hiptensorContractionDescriptor_t desc
+        = {0, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{16, 16, 16, 16}}, nullptr, 3};
+
+    hiptensor::DescriptorCache cache;
+    auto*                      signature = cache.intern(desc);
+
+    auto                            A = fill(signature->mTensors[0]->mElementSpace, 1);
+    std::vector<std::vector<float>> B, C, D;
+    for(int g = 0; g < 3; g++)
+    {
+        B.push_back(fill(signature->mOutputTensors[1]->mElementSpace, 2 + g));
+        C.push_back(fill(signature->mOutputTensors[2]->mElementSpace, 5 + g));
+        D.push_back(std::vector<float>(C[g].size(), 0.0f));
+    }
+
+    std::array<void const*, 3> ptrB = {B[0].data(), B[1].data(), B[2].data()};
+    std::array<void const*, 3> ptrC = {C[0].data(), C[1].data(), C[2].data()};
+    std::array<void*, 3>       ptrD = {D[0].data(), D[1].data(), D[2].data()};
+
+    float alpha = 1.5f;
+    float beta  = -0.75f;
+
+    auto single     = desc;
+    single.mOutputs = 1;
+
+    // Each output matches its own single-output contraction
+    auto check = [&]() {
+        bool pass = true;
+        for(int g = 0; g < 3; g++)
+        {
+            auto ref = reference(single, alpha, A, B[g], beta, C[g]);
+            ref.resize(D[g].size());
+            pass &= matches(D[g], ref);
+            std::fill(D[g].begin(), D[g].end(), 0.0f);
+        }
+        return pass;
+    };
+
+    // In a single tile, A is uploaded once for all outputs: 1 A, 3 B and 3 C uploads
+    hiptensor::StreamingPlan        plan;
+    hiptensor::HostStreamingBackend whole(1 << 20, HIP_R_32F);
+    bool pass = hiptensor::planStreaming(&plan, *signature, 1 << 20, 0, 1)
+                == HIPTENSOR_STATUS_SUCCESS;
+    pass &= plan.mOutputs == 3 && plan.mOuterN == 15 && plan.mOutputN == 5;
+    pass &= hiptensor::streamContraction(
+                plan, whole, &alpha, A.data(), ptrB.data(), &beta, ptrC.data(), ptrD.data())
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= check() && whole.uploads() == 7 && whole.contractions() == 1;
+
+    // Small slots split N into tiles that straddle the outputs
+    hiptensor::HostStreamingBackend doubled(4096, HIP_R_32F);
+    pass &= hiptensor::planStreaming(&plan, *signature, 4096, 0, 2) == HIPTENSOR_STATUS_SUCCESS;
+    pass &= plan.mTileN < plan.mOuterN && plan.mOutputN % plan.mTileN != 0;
+    pass &= hiptensor::streamContraction(
+                plan, doubled, &alpha, A.data(), ptrB.data(), &beta, ptrC.data(), ptrD.data())
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= check() && doubled.peakBytes() <= 4096;
+
+    // Pre-packed panels only describe one B
+    hiptensor::HostPackedOperand packed;
+    pass &= hiptensor::streamContraction(plan,
+                                         doubled,
+                                         &alpha,
+                                         A.data(),
+                                         ptrB.data(),
+                                         &beta,
+                                         ptrC.data(),
+                                         ptrD.data(),
+                                         nullptr,
+                                         &packed)
+            == HIPTENSOR_STATUS_NOT_SUPPORTED;
+
+    return pass;
+}
+
+int main(int argc, char* argv[])
+{
+    bool totalPass = true;
+    bool testPass  = false;
+
+    testPass = copyRunTest();
+    totalPass &= testPass;
+    std::cout << "Strided copy runs: ";
+    printBool(testPass);
+
+    testPass = streamingTest();
+    totalPass &= testPass;
+    std::cout << "Streamed contraction on the host backend: ";
+    printBool(testPass);
+
+    testPass = mappedFileTest();
+    totalPass &= testPass;
+    std::cout << "Streamed contraction of memory-mapped files: ";
+    printBool(testPass);
+
+    testPass = prepackedTest();
+    totalPass &= testPass;
+    std::cout << "Streamed contraction with a pre-packed operand: ";
+    printBool(testPass);
+
+    testPass = multiOutputTest();
+    totalPass &= testPass;
+    std::cout << "Streamed multi-output contraction: ";
+    printBool(testPass);
+
+    if(!totalPass)
+        return -1;
+    return 0;
+}
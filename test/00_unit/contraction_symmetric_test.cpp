@@ -0,0 +1,318 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <vector>
+
+// hiptensor includes
+#include "contraction_symmetric.hpp"
+#include "symmetric_packing.hpp"
+#include <hiptensor/hiptensor_types.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+struct Operand
+{
+    hiptensorSymmetricTensorDescriptor_t desc;
+    std::vector<int32_t>                 modes;
+};
+
+hiptensor::SymmetricShape shapeOf(Operand const& operand)
+{
+    hiptensor::SymmetricShape shape;
+    hiptensor::symmetricShape(operand.desc, &shape);
+    return shape;
+}
+
+std::vector<double> fill(std::size_t count, int seed)
+{
+    std::vector<double> values(count);
+    for(int i = 0; i < count; i++)
+    {
+        values[i] = double((i * 7 + seed) % 13) / 13.0 - 0.5;
+    }
+    return values;
+}
+
+std::vector<double> expand(Operand const& operand, std::vector<double> const& packed)
+{
+    auto                shape = shapeOf(operand);
+    std::vector<double> dense(hiptensor::fullElements(shape));
+    hiptensor::packSymmetricByCpu(shape, packed.data(), dense.data(), false);
+    return dense;
+}
+
+// D = alpha * A * B + beta * C over full tensors packed with the last mode fastest
+std::vector<double> reference(Operand const&             a,
+                              std::vector<double> const& A,
+                              Operand const&             b,
+                              std::vector<double> const& B,
+                              Operand const&             d,
+                              std::vector<double> const& C,
+                              double                     alpha,
+                              double                     beta)
+{
+    std::map<int32_t, std::size_t> lengths;
+    for(auto const* operand : {&a, &b})
+    {
+        for(int m = 0; m < operand->modes.size(); m++)
+        {
+            lengths[operand->modes[m]] = operand->desc.mLengths[m];
+        }
+    }
+
+    auto offset = [&](Operand const& operand, std::map<int32_t, std::size_t>& index) {
+        std::size_t result = 0;
+        for(int m = 0; m < operand.modes.size(); m++)
+        {
+            result = result * operand.desc.mLengths[m] + index[operand.modes[m]];
+        }
+        return result;
+    };
+
+    std::vector<double>            D(C.empty() ? 1 : C.size(), 0.0);
+    std::map<int32_t, std::size_t> index;
+    std::function<void(std::map<int32_t, std::size_t>::iterator)> loop = [&](auto it) {
+        if(it == lengths.end())
+        {
+            D[offset(d, index)] += alpha * A[offset(a, index)] * B[offset(b, index)];
+            return;
+        }
+        for(std::size_t i = 0; i < it->second; i++)
+        {
+            index[it->first] = i;
+            loop(std::next(it));
+        }
+    };
+
+    std::size_t elements = 1;
+    for(auto length : d.desc.mLengths)
+    {
+        elements *= length;
+    }
+    D.assign(elements, 0.0);
+    loop(lengths.begin());
+    for(std::size_t i = 0; i < C.size(); i++)
+    {
+        D[i] += beta * C[i];
+    }
+    return D;
+}
+
+bool symmetricTest(Operand const& a, Operand const& b, Operand const& d, bool hasC)
+{
+    hiptensor::SymmetricContractionPlan plan;
+    if(hiptensor::planSymmetric(&plan,
+                                a.desc,
+                                a.modes.data(),
+                                b.desc,
+                                b.modes.data(),
+                                d.desc,
+                                d.modes.data(),
+                                HIPTENSOR_COMPUTE_64F,
+                                hasC)
+       != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
+    auto A = fill(plan.mShapes[0].mElements, 1);
+    auto B = fill(plan.mShapes[1].mElements, 2);
+    auto C = hasC ? fill(plan.mShapes[2].mElements, 3) : std::vector<double>{};
+
+    double alpha = 1.5;
+    double beta  = -0.75;
+    auto   ref   = reference(
+        a, expand(a, A), b, expand(b, B), d, hasC ? expand(d, C) : C, alpha, beta);
+
+    std::vector<double> packedRef(plan.mShapes[2].mElements);
+    hiptensor::packSymmetricByCpu(plan.mShapes[2], ref.data(), packedRef.data(), true);
+
+    bool pass = true;
+    for(uint32_t threads : {1u, 3u, 0u})
+    {
+        std::vector<double> D(plan.mShapes[2].mElements, 0.0);
+        pass &= hiptensor::symmetricContractionHost(plan,
+                                                    &alpha,
+                                                    A.data(),
+                                                    B.data(),
+                                                    &beta,
+                                                    hasC ? C.data() : nullptr,
+                                                    D.data(),
+                                                    threads)
+                == HIPTENSOR_STATUS_SUCCESS;
+        for(std::size_t i = 0; i < D.size(); i++)
+        {
+            pass &= std::fabs(D[i] - packedRef[i]) < 1e-9;
+        }
+    }
+    return pass;
+}
+
+bool packingTest()
+{
+    // A fully symmetric 4 x 4 x 4 tensor stores the 20 sorted triples; an antisymmetric
+    // pair of length 4 stores the 6 entries below the diagonal
+    Operand sym  = {{HIP_R_64F, {4, 4, 4}, {{HIPTENSOR_SYMMETRY_SYMMETRIC, {0, 1, 2}}}}, {}};
+    Operand anti = {{HIP_R_64F, {3, 4, 4}, {{HIPTENSOR_SYMMETRY_ANTISYMMETRIC, {1, 2}}}}, {}};
+
+    bool pass = shapeOf(sym).mElements == 20 && shapeOf(anti).mElements == 3 * 6;
+
+    // Row-major lower triangle: (i, j) with i >= j is at i * (i + 1) / 2 + j
+    Operand pair = {{HIP_R_64F, {5, 5}, {{HIPTENSOR_SYMMETRY_SYMMETRIC, {0, 1}}}}, {}};
+    auto    shape = shapeOf(pair);
+    for(std::size_t i = 0; i < 5; i++)
+    {
+        for(std::size_t j = 0; j <= i; j++)
+        {
+            std::size_t index[] = {j, i}, offset;
+            bool        canonical;
+            pass &= hiptensor::symmetricOffset(shape, index, &offset, &canonical) == 1;
+            pass &= offset == i * (i + 1) / 2 + j && canonical == (i == j);
+        }
+    }
+
+    // Expanding and compressing again restores the packed tensor, and the full tensor
+    // has the declared symmetries
+    for(auto const* operand : {&sym, &anti})
+    {
+        auto packed = fill(shapeOf(*operand).mElements, 5);
+        auto dense  = expand(*operand, packed);
+        auto again  = std::vector<double>(packed.size(), 0.0);
+        hiptensor::packSymmetricByCpu(shapeOf(*operand), dense.data(), again.data(), true);
+        pass &= again == packed;
+    }
+
+    auto dense = expand(anti, fill(18, 5));
+    for(std::size_t i = 0; i < 3; i++)
+    {
+        for(std::size_t j = 0; j < 4; j++)
+        {
+            for(std::size_t k = 0; k < 4; k++)
+            {
+                pass &= dense[i * 16 + j * 4 + k] == -dense[i * 16 + k * 4 + j];
+            }
+        }
+    }
+
+    // Modes of a group must have one length and belong to one group
+    hiptensor::SymmetricShape invalid;
+    pass &= hiptensor::symmetricShape(
+                {HIP_R_64F, {3, 4}, {{HIPTENSOR_SYMMETRY_SYMMETRIC, {0, 1}}}}, &invalid)
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+    pass &= hiptensor::symmetricShape({HIP_R_64F,
+                                       {3, 3, 3},
+                                       {{HIPTENSOR_SYMMETRY_SYMMETRIC, {0, 1}},
+                                        {HIPTENSOR_SYMMETRY_SYMMETRIC, {1, 2}}}},
+                                      &invalid)
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+    return pass;
+}
+
+bool contractionTest()
+{
+    auto general = [](hiptensorDimVector_t lengths, std::vector<int32_t> modes) {
+        return Operand{{HIP_R_64F, lengths, {}}, modes};
+    };
+
+    // D[i, j] = A[i, k] * B[j, k] declared symmetric computes its lower triangle only
+    auto a    = general({5, 4}, {'i', 'k'});
+    auto b    = general({5, 4}, {'j', 'k'});
+    auto syrk = Operand{{HIP_R_64F, {5, 5}, {{HIPTENSOR_SYMMETRY_SYMMETRIC, {0, 1}}}}, {'i', 'j'}};
+    bool pass = symmetricTest(a, b, syrk, false) && symmetricTest(a, b, syrk, true);
+
+    // Contracted modes symmetric in both A and B are summed over their sorted pairs
+    auto symA = Operand{{HIP_R_64F, {3, 4, 4}, {{HIPTENSOR_SYMMETRY_SYMMETRIC, {1, 2}}}},
+                        {'i', 'k', 'l'}};
+    auto symB = Operand{{HIP_R_64F, {4, 2, 4}, {{HIPTENSOR_SYMMETRY_SYMMETRIC, {0, 2}}}},
+                        {'l', 'j', 'k'}};
+    auto d    = general({3, 2}, {'i', 'j'});
+    pass &= symmetricTest(symA, symB, d, true);
+
+    hiptensor::SymmetricContractionPlan plan;
+    hiptensor::planSymmetric(&plan,
+                             symA.desc,
+                             symA.modes.data(),
+                             symB.desc,
+                             symB.modes.data(),
+                             d.desc,
+                             d.modes.data(),
+                             HIPTENSOR_COMPUTE_64F,
+                             true);
+    pass &= plan.mContracted.mElements == 10;
+
+    // Antisymmetric pairs likewise, and so are three antisymmetric modes
+    auto antiA = Operand{{HIP_R_64F, {4, 4, 3}, {{HIPTENSOR_SYMMETRY_ANTISYMMETRIC, {0, 1}}}},
+                         {'k', 'l', 'i'}};
+    auto antiB = Operand{{HIP_R_64F, {4, 2, 4}, {{HIPTENSOR_SYMMETRY_ANTISYMMETRIC, {0, 2}}}},
+                         {'k', 'j', 'l'}};
+    pass &= symmetricTest(antiA, antiB, d, true);
+
+    auto cubeA
+        = Operand{{HIP_R_64F, {3, 5, 5, 5}, {{HIPTENSOR_SYMMETRY_ANTISYMMETRIC, {1, 2, 3}}}},
+                  {'i', 'k', 'l', 'm'}};
+    auto cubeB
+        = Operand{{HIP_R_64F, {5, 5, 5, 2}, {{HIPTENSOR_SYMMETRY_ANTISYMMETRIC, {0, 1, 2}}}},
+                  {'m', 'l', 'k', 'j'}};
+    pass &= symmetricTest(cubeA, cubeB, d, false);
+
+    // A symmetric group of three output modes
+    auto tensor = Operand{{HIP_R_64F, {4, 4, 4, 3}, {{HIPTENSOR_SYMMETRY_SYMMETRIC, {0, 1, 2}}}},
+                          {'i', 'j', 'm', 'k'}};
+    auto vector = general({3}, {'k'});
+    auto cube   = Operand{{HIP_R_64F, {4, 4, 4}, {{HIPTENSOR_SYMMETRY_SYMMETRIC, {0, 1, 2}}}},
+                        {'m', 'i', 'j'}};
+    pass &= symmetricTest(tensor, vector, cube, true);
+
+    // Modes must appear in two operands with one length
+    auto wrong = general({5, 3}, {'j', 'k'});
+    pass &= hiptensor::planSymmetric(&plan,
+                                     a.desc,
+                                     a.modes.data(),
+                                     wrong.desc,
+                                     wrong.modes.data(),
+                                     syrk.desc,
+                                     syrk.modes.data(),
+                                     HIPTENSOR_COMPUTE_64F,
+                                     false)
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+    return pass;
+}
+
+int main()
+{
+    bool pass = packingTest();
+    pass &= contractionTest();
+
+    printBool(pass);
+    return pass ? 0 : 1;
+}
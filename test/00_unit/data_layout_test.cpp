@@ -0,0 +1,172 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <iostream>
+#include <vector>
+
+// hiptensor includes
+#include "data_layout.hpp"
+#include "permutation/permutation_cpu_reference.hpp"
+#include <hiptensor/hiptensor.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+bool stridesTest()
+{
+    bool pass = true;
+
+    auto lengths = hiptensorDimVector_t{2, 3, 4};
+    pass &= hiptensor::stridesFromLengths(lengths, HIPTENSOR_LAYOUT_ROW_MAJOR)
+            == hiptensorDimVector_t{12, 4, 1};
+    pass &= hiptensor::stridesFromLengths(lengths, HIPTENSOR_LAYOUT_COL_MAJOR)
+            == hiptensorDimVector_t{1, 2, 6};
+    pass &= hiptensor::stridesFromLengths(lengths, HIPTENSOR_LAYOUT_DEFAULT)
+            == hiptensor::stridesFromLengths(lengths, hiptensor::DefaultDataLayout);
+
+    // Packed strides name their layout; length-1 modes do not decide it
+    pass &= hiptensor::layoutFromStrides(lengths, hiptensorDimVector_t{12, 4, 1})
+            == HIPTENSOR_LAYOUT_ROW_MAJOR;
+    pass &= hiptensor::layoutFromStrides(lengths, hiptensorDimVector_t{1, 2, 6})
+            == HIPTENSOR_LAYOUT_COL_MAJOR;
+    pass &= hiptensor::layoutFromStrides(hiptensorDimVector_t{2, 1, 4},
+                                         hiptensorDimVector_t{1, 7, 2})
+            == HIPTENSOR_LAYOUT_COL_MAJOR;
+
+    // Padded views and single modes have no layout of their own
+    pass &= hiptensor::layoutFromStrides(lengths, hiptensorDimVector_t{16, 4, 1})
+            == HIPTENSOR_LAYOUT_DEFAULT;
+    pass &= hiptensor::layoutFromStrides(hiptensorDimVector_t{5}, hiptensorDimVector_t{1})
+            == HIPTENSOR_LAYOUT_DEFAULT;
+
+    return pass;
+}
+
+bool descriptorTest()
+{
+    bool pass = true;
+
+    hiptensorHandle_t* handle;
+    if(hiptensorCreate(&handle) != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
+    int64_t lens[]       = {2, 3, 4};
+    int64_t colStrides[] = {1, 2, 6};
+    int64_t padStrides[] = {16, 4, 1};
+
+    // Without strides the descriptor keeps the packed strides contractions have always
+    // read, last mode fastest. Only permutations take the default layout of the build.
+    hiptensorTensorDescriptor_t packed;
+    pass &= hiptensorInitTensorDescriptor(
+                handle, &packed, 3, lens, nullptr, HIP_R_32F, HIPTENSOR_OP_IDENTITY)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= packed.mLayout == HIPTENSOR_LAYOUT_DEFAULT;
+    pass &= packed.mStrides == hiptensorDimVector_t{12, 4, 1};
+    pass &= hiptensor::permutationStrides(packed)
+            == hiptensor::stridesFromLengths(packed.mLengths, hiptensor::DefaultDataLayout);
+
+    hiptensorTensorDescriptor_t col;
+    pass &= hiptensorInitTensorDescriptor(
+                handle, &col, 3, lens, colStrides, HIP_R_32F, HIPTENSOR_OP_IDENTITY)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= col.mLayout == HIPTENSOR_LAYOUT_COL_MAJOR;
+    pass &= hiptensor::permutationStrides(col) == hiptensorDimVector_t{1, 2, 6};
+
+    // Setting a layout re-strides packed descriptors and keeps padded strides
+    pass &= hiptensorSetTensorLayout(handle, &packed, HIPTENSOR_LAYOUT_COL_MAJOR)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= packed.mLayout == HIPTENSOR_LAYOUT_COL_MAJOR;
+    pass &= packed.mStrides == hiptensorDimVector_t{1, 2, 6};
+    pass &= packed.mSignature == col.mSignature;
+
+    pass &= hiptensorSetTensorLayout(handle, &col, HIPTENSOR_LAYOUT_ROW_MAJOR)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= col.mStrides == hiptensorDimVector_t{12, 4, 1};
+
+    hiptensorTensorDescriptor_t padded;
+    pass &= hiptensorInitTensorDescriptor(
+                handle, &padded, 3, lens, padStrides, HIP_R_32F, HIPTENSOR_OP_IDENTITY)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= hiptensorSetTensorLayout(handle, &padded, HIPTENSOR_LAYOUT_COL_MAJOR)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= padded.mLayout == HIPTENSOR_LAYOUT_COL_MAJOR;
+    pass &= padded.mStrides == hiptensorDimVector_t{16, 4, 1};
+    pass &= hiptensor::permutationStrides(padded) == hiptensorDimVector_t{16, 4, 1};
+
+    pass &= hiptensorSetTensorLayout(handle, &padded, hiptensorDataLayout_t(7))
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+    pass &= hiptensorSetTensorLayout(handle, nullptr, HIPTENSOR_LAYOUT_ROW_MAJOR)
+            == HIPTENSOR_STATUS_NOT_INITIALIZED;
+
+    hiptensorDestroy(handle);
+    return pass;
+}
+
+bool permutationViewTest()
+{
+    bool pass = true;
+
+    // A padded row-major A is permuted into a column-major B
+    auto descA = hiptensorTensorDescriptor_t{
+        HIP_R_32F, hiptensorDimVector_t{2, 3}, hiptensorDimVector_t{4, 1}};
+    auto descB = hiptensorTensorDescriptor_t{
+        HIP_R_32F, hiptensorDimVector_t{3, 2}, hiptensorDimVector_t{1, 3}};
+    descA.mLayout = hiptensor::layoutFromStrides(descA.mLengths, descA.mStrides);
+    descB.mLayout = hiptensor::layoutFromStrides(descB.mLengths, descB.mStrides);
+
+    int32_t modeA[] = {'m', 'n'};
+    int32_t modeB[] = {'n', 'm'};
+    float   alpha   = 2.0f;
+    float   A[]     = {0, 1, 2, -1, 3, 4, 5, -1};
+    float   B[6]    = {};
+    pass &= hiptensor::detail::permuteByCpu(&alpha, A, &descA, modeA, B, &descB, modeB, HIP_R_32F)
+            == HIPTENSOR_STATUS_SUCCESS;
+
+    // B(n, m) = 2 * A(m, n) at offset n + 3 * m
+    float expected[] = {0, 2, 4, 6, 8, 10};
+    for(int i = 0; i < 6; i++)
+    {
+        pass &= B[i] == expected[i];
+    }
+
+    return pass;
+}
+
+int main()
+{
+    bool pass = true;
+
+    pass &= stridesTest();
+    pass &= descriptorTest();
+    pass &= permutationViewTest();
+
+    printBool(pass);
+    return pass ? 0 : 1;
+}
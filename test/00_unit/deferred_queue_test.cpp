@@ -0,0 +1,279 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <iostream>
+#include <vector>
+
+// hiptensor includes
+#include "deferred_queue.hpp"
+#include <hiptensor/hiptensor_types.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+using hiptensor::DeferredOperation;
+using hiptensor::DeferredRange;
+
+// Buffers stand in for device memory; the planner only compares their byte ranges
+float X[6], Y[6], Z[6], A[6], B[6], C[6], D[6], E[6];
+
+// Whole six-float buffer at data
+DeferredRange whole(float* data)
+{
+    return {data, sizeof(X)};
+}
+
+DeferredOperation permutation(float*                      src,
+                              hiptensorDimVector_t const& srcLengths,
+                              std::vector<int32_t>        srcModes,
+                              float*                      dst,
+                              hiptensorDimVector_t const& dstLengths,
+                              std::vector<int32_t>        dstModes,
+                              double                      alpha = 1.0)
+{
+    auto packed = [](hiptensorDimVector_t const& lengths) {
+        hiptensorDimVector_t strides(lengths.size(), 1);
+        for(int i = (int)lengths.size() - 2; i >= 0; i--)
+        {
+            strides[i] = strides[i + 1] * lengths[i + 1];
+        }
+        return hiptensorTensorDescriptor_t{HIP_R_32F, lengths, strides, nullptr};
+    };
+
+    DeferredOperation op;
+    op.mKind    = DeferredOperation::Kind::Permutation;
+    op.mKernel  = nullptr;
+    op.mStream  = nullptr;
+    op.mFlops   = 0u;
+    op.mScalars = {};
+    op.mTensors = {packed(srcLengths), packed(dstLengths)};
+    op.mReads   = {hiptensor::deferredRange(src, op.mTensors[0])};
+    op.mWrites  = {hiptensor::deferredRange(dst, op.mTensors[1])};
+    op.mModes   = {srcModes, dstModes};
+    op.mAlpha   = alpha;
+    return op;
+}
+
+DeferredOperation contraction(void const* kernel,
+                              float*      a,
+                              float*      b,
+                              float*      d,
+                              std::size_t flops = 1024u,
+                              char        alpha = 1)
+{
+    DeferredOperation op;
+    op.mKind       = DeferredOperation::Kind::Contraction;
+    op.mKernel     = kernel;
+    op.mStream     = nullptr;
+    op.mFlops      = flops;
+    op.mScalars    = {};
+    op.mScalars[0] = alpha;
+    op.mReads      = {whole(a), whole(b)};
+    op.mWrites     = {whole(d)};
+    return op;
+}
+
+bool elisionTest()
+{
+    bool pass = true;
+
+    // X[a, b] -> Y[b, a] -> X[a, b] restores X
+    auto forward = permutation(X, {2, 3}, {'a', 'b'}, Y, {3, 2}, {'b', 'a'}, 2.0);
+    auto inverse = permutation(Y, {3, 2}, {'b', 'a'}, X, {2, 3}, {'a', 'b'}, 0.5);
+    pass &= hiptensor::deferredInverse(forward, inverse);
+
+    // Scaling that does not cancel, or another target, is not an inverse
+    auto scaled = permutation(Y, {3, 2}, {'b', 'a'}, X, {2, 3}, {'a', 'b'}, 2.0);
+    auto other  = permutation(Y, {3, 2}, {'b', 'a'}, Z, {2, 3}, {'a', 'b'}, 0.5);
+    pass &= !hiptensor::deferredInverse(forward, scaled);
+    pass &= !hiptensor::deferredInverse(forward, other);
+
+    // Mode labels may differ between calls; positions are what must round-trip
+    auto relabeled = permutation(Y, {3, 2}, {'q', 'p'}, X, {2, 3}, {'p', 'q'}, 0.5);
+    pass &= hiptensor::deferredInverse(forward, relabeled);
+    auto repeated = permutation(Y, {3, 2}, {'q', 'p'}, X, {3, 2}, {'q', 'p'}, 0.5);
+    pass &= !hiptensor::deferredInverse(forward, repeated);
+
+    // In-place identity permutations leave the buffer unchanged
+    pass &= hiptensor::deferredNoOp(permutation(X, {2, 3}, {'a', 'b'}, X, {2, 3}, {'a', 'b'}));
+    pass &= !hiptensor::deferredNoOp(permutation(X, {2, 3}, {'a', 'b'}, Y, {2, 3}, {'a', 'b'}));
+
+    // Readers of Y in between do not matter
+    auto kernel = (void const*)&elisionTest;
+    auto plan   = hiptensor::planDeferred({forward, contraction(kernel, Y, B, D), inverse});
+    pass &= plan.mElided == std::vector<bool>{false, false, true};
+    pass &= plan.mGroups.size() == 2;
+
+    // A write to X in between does
+    plan = hiptensor::planDeferred({forward, contraction(kernel, A, B, X), inverse});
+    pass &= plan.mElided == std::vector<bool>{false, false, false};
+    pass &= plan.mGroups.size() == 3;
+
+    return pass;
+}
+
+bool groupingTest()
+{
+    bool pass = true;
+
+    auto kernel = (void const*)&groupingTest;
+    auto wide   = (void const*)&elisionTest;
+
+    // Compatible contractions never move past an unrelated permutation
+    auto plan = hiptensor::planDeferred({contraction(kernel, A, B, C),
+                                         permutation(X, {6}, {'a'}, Y, {6}, {'a'}),
+                                         contraction(kernel, A, B, D)});
+    pass &= plan.mGroups == std::vector<std::vector<std::size_t>>{{0}, {1}, {2}};
+
+    // Consecutive ones group, but not next to one they read from
+    plan = hiptensor::planDeferred({contraction(kernel, A, B, C),
+                                    permutation(X, {6}, {'a'}, D, {6}, {'a'}),
+                                    contraction(kernel, D, B, E),
+                                    contraction(kernel, C, B, Z)});
+    pass &= plan.mGroups == std::vector<std::vector<std::size_t>>{{0}, {1}, {2, 3}};
+
+    // Different kernels, scalars or large problems are dispatched alone
+    plan = hiptensor::planDeferred({contraction(kernel, A, B, C),
+                                    contraction(wide, A, B, D),
+                                    contraction(kernel, A, B, E, 1024u, 2),
+                                    contraction(kernel, A, B, Z, hiptensor::DeferredSmallFlops)});
+    pass &= plan.mGroups.size() == 4;
+
+    return pass;
+}
+
+bool overlapTest()
+{
+    bool pass = true;
+
+    auto kernel = (void const*)&overlapTest;
+
+    // Views into one allocation conflict when their bytes overlap, whatever their bases
+    auto head    = contraction(kernel, A, B, X);
+    auto tail    = contraction(kernel, A, B, X + 3);
+    head.mWrites = {{X, 4 * sizeof(float)}};
+    tail.mWrites = {{X + 3, 3 * sizeof(float)}};
+    pass &= hiptensor::deferredConflict(head, tail);
+
+    tail.mWrites = {{X + 4, 2 * sizeof(float)}};
+    pass &= !hiptensor::deferredConflict(head, tail);
+
+    // Reading a view of what another writes is a conflict too
+    auto reader   = contraction(kernel, X + 2, B, Z);
+    reader.mReads = {{X + 2, sizeof(float)}, whole(B)};
+    pass &= hiptensor::deferredConflict(head, reader);
+    pass &= !hiptensor::deferredConflict(tail, reader);
+
+    // Empty tensors touch nothing
+    head.mWrites = {{X, 0}};
+    pass &= !hiptensor::deferredConflict(head, reader);
+
+    // Permutation ranges follow the strided element space of their tensors
+    auto view                 = permutation(X + 1, {2, 2}, {'a', 'b'}, Y, {2, 2}, {'b', 'a'});
+    view.mTensors[0].mStrides = {3, 1};
+    view.mReads               = {hiptensor::deferredRange(X + 1, view.mTensors[0])};
+    pass &= view.mReads[0].mBytes == 5 * sizeof(float);
+
+    // A write into the source of a permutation through another view blocks its inverse
+    auto forward    = permutation(X, {2, 3}, {'a', 'b'}, Y, {3, 2}, {'b', 'a'});
+    auto inverse    = permutation(Y, {3, 2}, {'b', 'a'}, X, {2, 3}, {'a', 'b'});
+    auto partial    = contraction(kernel, A, B, X + 5);
+    partial.mWrites = {{X + 5, sizeof(float)}};
+    auto plan       = hiptensor::planDeferred({forward, partial, inverse});
+    pass &= plan.mElided == std::vector<bool>{false, false, false};
+
+    return pass;
+}
+
+bool flushTest()
+{
+    bool pass = true;
+
+    hiptensor::DeferredQueue queue;
+    std::vector<int>         order;
+
+    auto kernel = (void const*)&flushTest;
+    auto record = [&order](DeferredOperation op, int id) {
+        op.mLaunch = [&order, id]() {
+            order.push_back(id);
+            return HIPTENSOR_STATUS_SUCCESS;
+        };
+        return op;
+    };
+
+    queue.enqueue(record(contraction(kernel, A, B, C), 0));
+    queue.enqueue(record(permutation(X, {2, 3}, {'a', 'b'}, Y, {3, 2}, {'b', 'a'}), 1));
+    queue.enqueue(record(contraction(kernel, A, B, D), 2));
+    queue.enqueue(record(permutation(Y, {3, 2}, {'b', 'a'}, X, {2, 3}, {'a', 'b'}), 3));
+    pass &= queue.size() == 4;
+
+    pass &= queue.flush() == HIPTENSOR_STATUS_SUCCESS;
+    pass &= order == std::vector<int>{0, 1, 2};
+    pass &= queue.size() == 0;
+
+    // A failing operation stops the flush and empties the queue
+    order.clear();
+    auto failing    = contraction(kernel, A, B, E);
+    failing.mLaunch = []() { return HIPTENSOR_STATUS_INTERNAL_ERROR; };
+    queue.enqueue(failing);
+    queue.enqueue(record(permutation(X, {6}, {'a'}, Z, {6}, {'a'}), 4));
+    pass &= queue.flush() == HIPTENSOR_STATUS_INTERNAL_ERROR;
+    pass &= order.empty() && queue.size() == 0;
+
+    return pass;
+}
+
+int main(int argc, char* argv[])
+{
+    bool totalPass = true;
+    bool testPass  = false;
+
+    testPass = elisionTest();
+    totalPass &= testPass;
+    std::cout << "Deferred permutation elision: ";
+    printBool(testPass);
+
+    testPass = groupingTest();
+    totalPass &= testPass;
+    std::cout << "Deferred contraction grouping: ";
+    printBool(testPass);
+
+    testPass = overlapTest();
+    totalPass &= testPass;
+    std::cout << "Deferred byte range overlap: ";
+    printBool(testPass);
+
+    testPass = flushTest();
+    totalPass &= testPass;
+    std::cout << "Deferred queue flush: ";
+    printBool(testPass);
+
+    if(!totalPass)
+        return -1;
+    return 0;
+}
@@ -0,0 +1,411 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// hiptensor includes
+#include <hiptensor/hiptensor.hpp>
+#include <hiptensor/internal/hiptensor_utility.hpp>
+
+#include "contraction_streaming.hpp"
+#include "data_types.hpp"
+#include "degenerate_contraction.hpp"
+#include "descriptor_cache.hpp"
+#include "util.hpp"
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+struct Problem
+{
+    std::array<hiptensorDimVector_t, 4> mLengths; // A = [M, K], B = [N, K], C, D = [M, N]
+    std::size_t                         mRankM, mRankN;
+};
+
+hiptensor::SqueezedContraction squeeze(Problem const& problem, hipDataType type = HIP_R_32F)
+{
+    std::array<hiptensorDimVector_t, 4> strides;
+    for(int i = 0; i < 4; i++)
+    {
+        strides[i] = hiptensor::stridesFromLengths(problem.mLengths[i]);
+    }
+    return hiptensor::squeezeContraction(
+        {type, type, type, type}, problem.mLengths, strides, problem.mRankM, problem.mRankN);
+}
+
+bool classifyTest()
+{
+    bool pass = true;
+
+    using hiptensor::ContractionShape;
+
+    // Outer product with a length-1 K mode
+    auto outer = squeeze({{{{3, 1}, {4, 1}, {3, 4}, {3, 4}}}, 1, 1});
+    pass &= outer.mShape == ContractionShape::OUTER;
+    pass &= outer.mRankM == 1 && outer.mRankN == 1 && outer.mRankK == 0;
+    pass &= outer.mLengths[0] == hiptensorDimVector_t{3};
+    pass &= outer.mStrides[0] == hiptensorDimVector_t{1};
+
+    // Dot product with length-1 M and N modes
+    auto dot = squeeze({{{{1, 6}, {1, 6}, {1, 1}, {1, 1}}}, 1, 1});
+    pass &= dot.mShape == ContractionShape::DOT && dot.mK == 6;
+    pass &= dot.mLengths[3].empty();
+
+    // Matrix-vector product over two M modes, with the strides of the kept modes
+    auto gemv = squeeze({{{{3, 2, 5}, {1, 5}, {3, 2, 1}, {3, 2, 1}}}, 2, 1});
+    pass &= gemv.mShape == ContractionShape::GEMV;
+    pass &= gemv.mRankM == 2 && gemv.mRankN == 0 && gemv.mRankK == 1;
+    pass &= gemv.mStrides[0] == hiptensorDimVector_t{10, 5, 1};
+    pass &= gemv.mStrides[3] == hiptensorDimVector_t{2, 1};
+
+    // A single element of A scales B
+    auto scale = squeeze({{{{1, 1}, {4, 1}, {1, 4}, {1, 4}}}, 1, 1});
+    pass &= scale.mShape == ContractionShape::SCALE && scale.mN == 4;
+
+    // Everything remains
+    pass &= squeeze({{{{2, 3}, {4, 3}, {2, 4}, {2, 4}}}, 1, 1}).mShape
+            == ContractionShape::GENERAL;
+
+    // Empty extents and unsupported types stay with the GEMM kernels
+    pass &= squeeze({{{{0, 1}, {4, 1}, {0, 4}, {0, 4}}}, 1, 1}).mShape
+            == ContractionShape::GENERAL;
+    pass &= squeeze({{{{3, 1}, {4, 1}, {3, 4}, {3, 4}}}, 1, 1}, HIP_R_16BF).mShape
+            == ContractionShape::GENERAL;
+    pass &= squeeze({{{{3, 1}, {4, 1}, {3, 4}, {3, 4}}}, 1, 1}, HIP_R_16F).mShape
+            == ContractionShape::GENERAL;
+
+    // Partial sums need workspace only when K is split
+    auto longDot = squeeze({{{{1, 1u << 20}, {1, 1u << 20}, {1, 1}, {1, 1}}}, 1, 1});
+    pass &= hiptensor::degenerateWorkspaceSize(longDot) > 0;
+    pass &= hiptensor::degenerateWorkspaceSize(outer) == 0;
+
+    // Descriptors carry the classification
+    hiptensor::DescriptorCache cache;
+
+    hiptensorTensorDescriptor_t descA = {HIP_R_32F, {3, 2, 5}, {10, 5, 1}, nullptr};
+    hiptensorTensorDescriptor_t descB = {HIP_R_32F, {1, 5}, {5, 1}, nullptr};
+    hiptensorTensorDescriptor_t descC
+        = {hiptensor::NONE_TYPE, hiptensorDimVector_t(3, 0), hiptensorDimVector_t(3, 0), nullptr};
+    hiptensorTensorDescriptor_t descD = {HIP_R_32F, {3, 2, 1}, {2, 1, 1}, nullptr};
+
+    hiptensorContractionDescriptor_t desc
+        = {1, HIPTENSOR_COMPUTE_32F, {{descA, descB, descC, descD}}, {{4, 4, 0, 4}}, nullptr, 1};
+    auto* signature = cache.intern(desc);
+    pass &= signature->mSqueezed.mShape == ContractionShape::GEMV;
+    pass &= !signature->mSqueezed.mHasC;
+
+    return pass;
+}
+
+// D = alpha * A * B + beta * C over the unsqueezed, strided operands
+void reference(Problem const&                             problem,
+               std::array<hiptensorDimVector_t, 4> const& strides,
+               float                                      alpha,
+               std::vector<float> const&                  A,
+               std::vector<float> const&                  B,
+               float                                      beta,
+               std::vector<float> const&                  C,
+               std::vector<float>&                        D)
+{
+    auto const& lengths = problem.mLengths;
+    auto        rankM   = problem.mRankM;
+    auto        rankN   = problem.mRankN;
+    auto        rankK   = lengths[0].size() - rankM;
+
+    auto elements = [&](int i, std::size_t first, std::size_t count) {
+        std::size_t result = 1;
+        for(auto mode = first; mode < first + count; mode++)
+        {
+            result *= lengths[i][mode];
+        }
+        return result;
+    };
+    auto offset = [&](int i, std::size_t index, std::size_t first, std::size_t count) {
+        std::size_t result = 0;
+        for(auto mode = first + count; mode-- > first;)
+        {
+            result += (index % lengths[i][mode]) * strides[i][mode];
+            index /= lengths[i][mode];
+        }
+        return result;
+    };
+
+    auto M = elements(0, 0, rankM);
+    auto N = elements(1, 0, rankN);
+    auto K = elements(0, rankM, rankK);
+    for(std::size_t m = 0; m < M; m++)
+    {
+        for(std::size_t n = 0; n < N; n++)
+        {
+            double sum = 0;
+            for(std::size_t k = 0; k < K; k++)
+            {
+                sum += A[offset(0, m, 0, rankM) + offset(0, k, rankM, rankK)]
+                       * B[offset(1, n, 0, rankN) + offset(1, k, rankN, rankK)];
+            }
+            auto out = m * N + n;
+            auto c   = offset(2, out, 0, rankM + rankN);
+            auto d   = offset(3, out, 0, rankM + rankN);
+            D[d]     = float(alpha * sum + beta * C[c]);
+        }
+    }
+}
+
+bool cpuTest()
+{
+    bool pass = true;
+
+    auto problems = std::vector<Problem>{
+        {{{{3, 1, 1}, {1, 4, 1}, {3, 1, 1, 4}, {3, 1, 1, 4}}}, 2, 2}, // Outer
+        {{{{1, 7}, {1, 7}, {1, 1}, {1, 1}}}, 1, 1}, // Dot
+        {{{{3, 2, 5}, {1, 5}, {3, 2, 1}, {3, 2, 1}}}, 2, 1}, // GEMV over M
+        {{{{1, 5, 2}, {4, 5, 2}, {1, 4}, {1, 4}}}, 1, 1}, // GEMV over N with two K modes
+        {{{{1}, {6}, {1, 6}, {1, 6}}}, 1, 1}, // Scale
+    };
+
+    for(auto const& problem : problems)
+    {
+        // Operands padded by one element per mode, and C column-major
+        std::array<hiptensorDimVector_t, 4> strides;
+        std::array<std::size_t, 4>          sizes;
+        for(int i = 0; i < 4; i++)
+        {
+            auto padded = problem.mLengths[i];
+            for(auto& length : padded)
+            {
+                length += 1;
+            }
+            strides[i] = hiptensor::stridesFromLengths(padded);
+            sizes[i]   = hiptensor::elementsFromLengths(padded);
+            if(i == 2)
+            {
+                std::size_t stride = 1;
+                for(std::size_t mode = 0; mode < padded.size(); mode++)
+                {
+                    strides[i][mode] = stride;
+                    stride *= padded[mode];
+                }
+            }
+        }
+
+        std::array<std::vector<float>, 4> data;
+        for(int i = 0; i < 4; i++)
+        {
+            data[i].resize(sizes[i]);
+            for(std::size_t j = 0; j < sizes[i]; j++)
+            {
+                data[i][j] = float((j * (i + 3)) % 11) - 5.0f;
+            }
+        }
+        auto expected = data[3];
+
+        auto alpha = 1.5f;
+        auto beta  = -0.5f;
+        reference(problem, strides, alpha, data[0], data[1], beta, data[2], expected);
+
+        auto types    = std::array<hipDataType, 4>{HIP_R_32F, HIP_R_32F, HIP_R_32F, HIP_R_32F};
+        auto squeezed = hiptensor::squeezeContraction(
+            types, problem.mLengths, strides, problem.mRankM, problem.mRankN);
+        pass &= squeezed.mShape != hiptensor::ContractionShape::GENERAL;
+
+        hiptensor::degenerateContractionByCpu(squeezed,
+                                              &alpha,
+                                              data[0].data(),
+                                              data[1].data(),
+                                              &beta,
+                                              data[2].data(),
+                                              data[3].data());
+        for(std::size_t j = 0; j < sizes[3]; j++)
+        {
+            pass &= std::fabs(data[3][j] - expected[j]) <= 1e-4f * (1.0f + std::fabs(expected[j]));
+        }
+    }
+
+    // The host streaming backend takes the fast path on packed tiles
+    hiptensor::HostStreamingBackend backend(1 << 20, HIP_R_32F);
+
+    auto A     = std::vector<float>{1, 2, 3};
+    auto B     = std::vector<float>{4, 5};
+    auto D     = std::vector<float>(6);
+    auto alpha = 2.0f;
+    pass &= backend.contract(&alpha,
+                             A.data(),
+                             B.data(),
+                             nullptr,
+                             nullptr,
+                             D.data(),
+                             {{{3, 1}, {2, 1}, {3, 2}, {3, 2}}},
+                             nullptr,
+                             0)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= D == std::vector<float>{8, 10, 16, 20, 24, 30};
+
+    return pass;
+}
+
+// A matrix-vector product whose A starts one element past an allocation runs on the
+// bandwidth-bound kernel, which reads A in place whatever its alignment
+bool offsetGemvTest(hiptensorHandle_t* handle)
+{
+    bool pass = true;
+
+    auto problem = Problem{{{{3, 2, 5}, {1, 5}, {3, 2, 1}, {3, 2, 1}}}, 2, 1};
+
+    std::array<hiptensorDimVector_t, 4> strides;
+    std::array<std::vector<float>, 4>   data;
+    for(int i = 0; i < 4; i++)
+    {
+        strides[i] = hiptensor::stridesFromLengths(problem.mLengths[i]);
+        data[i].resize(hiptensor::elementsFromLengths(problem.mLengths[i]));
+        for(std::size_t j = 0; j < data[i].size(); j++)
+        {
+            data[i][j] = float((j * (i + 3)) % 11) - 5.0f;
+        }
+    }
+    auto expected = data[3];
+
+    auto alpha = 1.5f;
+    auto beta  = -0.5f;
+    reference(problem, strides, alpha, data[0], data[1], beta, data[2], expected);
+
+    std::array<hiptensorTensorDescriptor_t, 4> descs;
+    for(int i = 0; i < 4; i++)
+    {
+        auto const& lengths = problem.mLengths[i];
+        auto        lens    = std::vector<int64_t>(lengths.begin(), lengths.end());
+        CHECK_HIPTENSOR_ERROR(hiptensorInitTensorDescriptor(handle,
+                                                            &descs[i],
+                                                            lens.size(),
+                                                            lens.data(),
+                                                            nullptr,
+                                                            HIP_R_32F,
+                                                            HIPTENSOR_OP_IDENTITY));
+    }
+
+    int32_t modeA[] = {'m', 'n', 'k'};
+    int32_t modeB[] = {'o', 'k'};
+    int32_t modeD[] = {'m', 'n', 'o'};
+
+    hiptensorContractionDescriptor_t desc;
+    CHECK_HIPTENSOR_ERROR(hiptensorInitContractionDescriptor(handle,
+                                                             &desc,
+                                                             &descs[0],
+                                                             modeA,
+                                                             0,
+                                                             &descs[1],
+                                                             modeB,
+                                                             0,
+                                                             &descs[2],
+                                                             modeD,
+                                                             0,
+                                                             &descs[3],
+                                                             modeD,
+                                                             0,
+                                                             HIPTENSOR_COMPUTE_32F));
+
+    hiptensorContractionFind_t find;
+    CHECK_HIPTENSOR_ERROR(hiptensorInitContractionFind(handle, &find, HIPTENSOR_ALGO_DEFAULT));
+
+    uint64_t workspaceSize = 0;
+    CHECK_HIPTENSOR_ERROR(hiptensorContractionGetWorkspaceSize(
+        handle, &desc, &find, HIPTENSOR_WORKSPACE_RECOMMENDED, &workspaceSize));
+
+    hiptensorContractionPlan_t plan;
+    CHECK_HIPTENSOR_ERROR(
+        hiptensorInitContractionPlan(handle, &plan, &desc, &find, workspaceSize));
+
+    std::array<float*, 4> device;
+    for(int i = 0; i < 4; i++)
+    {
+        auto bytes = data[i].size() * sizeof(float);
+        CHECK_HIP_ERROR(hipMalloc(&device[i], bytes + sizeof(float)));
+        CHECK_HIP_ERROR(hipMemcpy(
+            device[i] + (i == 0), data[i].data(), bytes, hipMemcpyHostToDevice));
+    }
+
+    void* workspace = nullptr;
+    if(workspaceSize > 0)
+    {
+        CHECK_HIP_ERROR(hipMalloc(&workspace, workspaceSize));
+    }
+
+    pass &= hiptensorContraction(handle,
+                                 &plan,
+                                 &alpha,
+                                 device[0] + 1,
+                                 device[1],
+                                 &beta,
+                                 device[2],
+                                 device[3],
+                                 workspace,
+                                 workspaceSize,
+                                 0)
+            == HIPTENSOR_STATUS_SUCCESS;
+
+    auto result = std::vector<float>(data[3].size());
+    CHECK_HIP_ERROR(hipMemcpy(
+        result.data(), device[3], result.size() * sizeof(float), hipMemcpyDeviceToHost));
+    for(std::size_t j = 0; j < result.size(); j++)
+    {
+        pass &= std::fabs(result[j] - expected[j]) <= 1e-4f * (1.0f + std::fabs(expected[j]));
+    }
+
+    for(auto* ptr : device)
+    {
+        CHECK_HIP_ERROR(hipFree(ptr));
+    }
+    if(workspace != nullptr)
+    {
+        CHECK_HIP_ERROR(hipFree(workspace));
+    }
+
+    return pass;
+}
+
+int main()
+{
+    bool pass = true;
+
+    pass &= classifyTest();
+    pass &= cpuTest();
+
+    hiptensorHandle_t* handle;
+    if(hiptensorCreate(&handle) != HIPTENSOR_STATUS_SUCCESS)
+    {
+        std::cout << "Skipped device tests: unsupported host device" << std::endl;
+        printBool(pass);
+        return pass ? 0 : 1;
+    }
+
+    pass &= offsetGemvTest(handle);
+    CHECK_HIPTENSOR_ERROR(hiptensorDestroy(handle));
+
+    printBool(pass);
+    return pass ? 0 : 1;
+}
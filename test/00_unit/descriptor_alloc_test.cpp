@@ -0,0 +1,248 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+// hiptensor includes
+#include <hiptensor/hiptensor.hpp>
+#include <hiptensor/hiptensor_types.hpp>
+#include <hiptensor/internal/hiptensor_utility.hpp>
+
+// Count every heap allocation made by this process
+static std::atomic<size_t> allocCount{0};
+
+void* operator new(std::size_t size)
+{
+    allocCount++;
+    if(auto* ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+template <typename Func>
+size_t countAllocations(Func&& func)
+{
+    auto before = allocCount.load();
+    func();
+    return allocCount.load() - before;
+}
+
+bool smallVectorInlineTest()
+{
+    bool pass = true;
+
+    hiptensorDimVector_t vec;
+    pass &= (countAllocations([&] {
+                 for(size_t i = 0; i < HIPTENSOR_MAX_INLINE_RANK; i++)
+                 {
+                     vec.push_back(i + 1);
+                 }
+                 hiptensorDimVector_t copy(vec);
+                 hiptensorDimVector_t moved(std::move(copy));
+                 moved.resize(2);
+                 vec = moved;
+             })
+             == 0);
+    pass &= vec.size() == 2 && vec.isInline() && vec[0] == 1 && vec[1] == 2;
+
+    return pass;
+}
+
+bool smallVectorSpillTest()
+{
+    bool pass = true;
+
+    hiptensorDimVector_t vec(HIPTENSOR_MAX_INLINE_RANK, 3);
+    pass &= vec.isInline();
+
+    // Growing past the inline capacity must keep existing contents
+    vec.push_back(7);
+    pass &= !vec.isInline() && vec.size() == HIPTENSOR_MAX_INLINE_RANK + 1;
+    pass &= vec.front() == 3 && vec.back() == 7;
+
+    hiptensorDimVector_t copy = vec;
+    pass &= (copy == vec);
+
+    // Shrinking back returns to inline storage
+    copy.resize(4);
+    pass &= copy.isInline() && copy.size() == 4 && copy[3] == 3;
+
+    std::vector<std::size_t> asVector = vec;
+    pass &= (asVector.size() == vec.size()) && (asVector.back() == 7);
+
+    return pass;
+}
+
+bool descriptorAllocationFreeTest(hiptensorHandle_t* handle, double& usPerIter)
+{
+    constexpr int numIters = 10000;
+
+    std::vector<int64_t> lengthsA = {5, 6, 3, 4};
+    std::vector<int64_t> lengthsB = {3, 4, 3, 4};
+    std::vector<int64_t> lengthsD = {5, 6, 3, 4};
+    std::vector<int32_t> modesA   = {'m', 'n', 'u', 'v'};
+    std::vector<int32_t> modesB   = {'h', 'k', 'u', 'v'};
+    std::vector<int32_t> modesD   = {'m', 'n', 'h', 'k'};
+
+    hiptensorTensorDescriptor_t      a_ms_ks, b_ns_ks, d_ms_ns;
+    hiptensorContractionDescriptor_t desc;
+    hiptensorContractionFind_t       find;
+    hiptensorContractionPlan_t       plan;
+    uint64_t                         workspaceSize = 0;
+    hiptensorStatus_t                status        = HIPTENSOR_STATUS_SUCCESS;
+
+    CHECK_HIPTENSOR_ERROR(hiptensorInitContractionFind(handle, &find, HIPTENSOR_ALGO_DEFAULT));
+
+    auto initDescriptors = [&] {
+        CHECK_HIPTENSOR_ERROR(hiptensorInitTensorDescriptor(handle,
+                                                            &a_ms_ks,
+                                                            lengthsA.size(),
+                                                            lengthsA.data(),
+                                                            nullptr,
+                                                            HIP_R_32F,
+                                                            HIPTENSOR_OP_IDENTITY));
+        CHECK_HIPTENSOR_ERROR(hiptensorInitTensorDescriptor(handle,
+                                                            &b_ns_ks,
+                                                            lengthsB.size(),
+                                                            lengthsB.data(),
+                                                            nullptr,
+                                                            HIP_R_32F,
+                                                            HIPTENSOR_OP_IDENTITY));
+        CHECK_HIPTENSOR_ERROR(hiptensorInitTensorDescriptor(handle,
+                                                            &d_ms_ns,
+                                                            lengthsD.size(),
+                                                            lengthsD.data(),
+                                                            nullptr,
+                                                            HIP_R_32F,
+                                                            HIPTENSOR_OP_IDENTITY));
+        CHECK_HIPTENSOR_ERROR(hiptensorInitContractionDescriptor(handle,
+                                                                 &desc,
+                                                                 &a_ms_ks,
+                                                                 modesA.data(),
+                                                                 0u,
+                                                                 &b_ns_ks,
+                                                                 modesB.data(),
+                                                                 0u,
+                                                                 nullptr,
+                                                                 nullptr,
+                                                                 0u,
+                                                                 &d_ms_ns,
+                                                                 modesD.data(),
+                                                                 0u,
+                                                                 HIPTENSOR_COMPUTE_32F));
+    };
+
+    // Every pass re-initializes the descriptors and the plan, which is selected once and
+    // then served from the handle's plan cache
+    auto body = [&] {
+        initDescriptors();
+        plan.mSolution = nullptr;
+        status         = hiptensorInitContractionPlan(handle, &plan, &desc, &find, workspaceSize);
+    };
+
+    // Warm up: first calls may initialize the logger and device state, and select the plan
+    initDescriptors();
+    CHECK_HIPTENSOR_ERROR(hiptensorContractionGetWorkspaceSize(
+        handle, &desc, &find, HIPTENSOR_WORKSPACE_RECOMMENDED, &workspaceSize));
+    body();
+    if(status != HIPTENSOR_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
+    size_t allocs = 0;
+    bool   cached = true;
+    auto   start  = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < numIters; i++)
+    {
+        allocs += countAllocations(body);
+        cached &= status == HIPTENSOR_STATUS_SUCCESS && plan.mSolution != nullptr;
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+
+    usPerIter = std::chrono::duration<double, std::micro>(stop - start).count() / numIters;
+
+    return allocs == 0 && cached
+           && plan.mContractionDesc.mTensorDesc[3].mLengths == d_ms_ns.mLengths;
+}
+
+int main(int argc, char* argv[])
+{
+    bool totalPass = true;
+    bool testPass  = false;
+
+    testPass = smallVectorInlineTest();
+    totalPass &= testPass;
+    std::cout << "SmallVector inline storage: ";
+    printBool(testPass);
+
+    testPass = smallVectorSpillTest();
+    totalPass &= testPass;
+    std::cout << "SmallVector heap spill: ";
+    printBool(testPass);
+
+    hiptensorHandle_t* handle;
+    if(hiptensorCreate(&handle) != HIPTENSOR_STATUS_SUCCESS)
+    {
+        std::cout << "Skipped descriptor tests: unsupported host device" << std::endl;
+        return totalPass ? 0 : -1;
+    }
+
+    double usPerIter = 0.0;
+    testPass         = descriptorAllocationFreeTest(handle, usPerIter);
+    totalPass &= testPass;
+    std::cout << "Descriptor and plan init allocation-free: ";
+    printBool(testPass);
+    std::cout << "Descriptor and plan init: " << usPerIter << " us/iter" << std::endl;
+
+    CHECK_HIPTENSOR_ERROR(hiptensorDestroy(handle));
+
+    if(!totalPass)
+        return -1;
+    return 0;
+}
@@ -0,0 +1,549 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <iostream>
+#include <vector>
+
+// hiptensor includes
+#include "data_types.hpp"
+#include "descriptor_cache.hpp"
+#include "util.hpp"
+#include <hiptensor/hiptensor.hpp>
+#include <hiptensor/hiptensor_types.hpp>
+#include <hiptensor/internal/hiptensor_utility.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+hiptensorTensorDescriptor_t makeDesc(hipDataType type, hiptensorDimVector_t const& lengths)
+{
+    // Packed, last mode fastest
+    hiptensorDimVector_t strides(lengths.size(), 1);
+    for(int i = (int)lengths.size() - 2; i >= 0; i--)
+    {
+        strides[i] = strides[i + 1] * lengths[i + 1];
+    }
+    return {type, lengths, strides, nullptr};
+}
+
+bool tensorInternTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto a0 = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto a1 = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto b  = makeDesc(HIP_R_64F, {5, 6, 3, 4});
+
+    auto* sigA0 = cache.intern(a0);
+    auto* sigA1 = cache.intern(a1);
+    auto* sigB  = cache.intern(b);
+
+    bool pass = (sigA0 == sigA1) && (sigA0 != sigB) && (cache.tensorCount() == 2);
+
+    // Derived metrics are precomputed once
+    pass &= sigA0->mElements == 360 && sigA0->mElementSpace == 360 && sigA0->mBytes == 1440;
+    pass &= sigB->mBytes == 2880;
+
+    // Padded strides change the element space but not the element count
+    auto padded = a0;
+    padded.mStrides[0] *= 2;
+    auto* sigPadded = cache.intern(padded);
+    pass &= sigPadded != sigA0 && sigPadded->mElements == 360 && sigPadded->mElementSpace == 720 - 72;
+
+    // Cached pointers are only trusted when owned by the cache
+    hiptensor::DescriptorCache other;
+    a1.mSignature  = sigA0;
+    a1.mGeneration = sigA0->mGeneration;
+    pass &= (cache.signature(a1) == sigA0) && other.signature(a1) != sigA0;
+    pass &= cache.owns(sigA0) && !other.owns(sigA0);
+
+    return pass;
+}
+
+bool contractionInternTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto a = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto b = makeDesc(HIP_R_32F, {3, 4, 3, 4});
+    auto d = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto c = hiptensorTensorDescriptor_t{
+        hiptensor::NONE_TYPE, hiptensorDimVector_t(4, 0), hiptensorDimVector_t(4, 0), nullptr};
+
+    hiptensorContractionDescriptor_t desc
+        = {1, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{4, 4, 0, 4}}, nullptr};
+
+    auto* sig0 = cache.intern(desc);
+    auto* sig1 = cache.intern(desc);
+
+    bool pass = (sig0 == sig1) && (cache.contractionCount() == 1);
+    pass &= sig0->mM == 30 && sig0->mN == 12 && sig0->mK == 12;
+    pass &= sig0->mFlops == 2 * 30 * 12 * 12;
+    pass &= sig0->mBytes == (360 + 144 + 0 + 360) * sizeof(float);
+    pass &= sig0->mTensors[0] == cache.intern(a) && sig0->mTensors[3] == sig0->mTensors[0];
+
+    // Alignment requirements are part of the signature
+    auto aligned             = desc;
+    aligned.mAlignmentReq[0] = 16;
+    pass &= cache.intern(aligned) != sig0;
+
+    return pass;
+}
+
+bool planCacheTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto a = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto b = makeDesc(HIP_R_32F, {3, 4, 3, 4});
+    auto d = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+
+    hiptensorContractionDescriptor_t desc
+        = {2, HIPTENSOR_COMPUTE_32F, {{a, b, d, d}}, {{4, 4, 4, 4}}, nullptr};
+    auto* sig = cache.intern(desc);
+
+    int  solution = 0;
+    bool pass     = cache.findPlan(sig, HIPTENSOR_ALGO_DEFAULT, 0) == nullptr;
+
+    cache.cachePlan(sig, HIPTENSOR_ALGO_DEFAULT, 0, &solution);
+    pass &= cache.findPlan(sig, HIPTENSOR_ALGO_DEFAULT, 0) == &solution;
+    pass &= cache.findPlan(sig, HIPTENSOR_ALGO_ACTOR_CRITIC, 0) == nullptr;
+    pass &= cache.findPlan(sig, HIPTENSOR_ALGO_DEFAULT, 1024) == nullptr;
+    pass &= cache.planHits() == 1;
+
+    return pass;
+}
+
+bool vectorWidthTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto a = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto b = makeDesc(HIP_R_32F, {3, 4, 3, 4});
+    auto d = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto c = hiptensorTensorDescriptor_t{
+        hiptensor::NONE_TYPE, hiptensorDimVector_t(4, 0), hiptensorDimVector_t(4, 0), nullptr};
+
+    hiptensorContractionDescriptor_t desc
+        = {1, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{16, 16, 0, 16}}, nullptr};
+
+    // 16-byte aligned float operands with extents divisible by 4
+    bool pass = cache.intern(desc)->mVectorWidth == 4;
+
+    // Partial alignment of a single operand narrows the whole contraction
+    auto partial             = desc;
+    partial.mAlignmentReq[1] = 8;
+    pass &= cache.intern(partial)->mVectorWidth == 2;
+
+    // Odd and even fastest extents, and alignment deferred to the pointers
+    auto odd           = desc;
+    odd.mTensorDesc[0] = makeDesc(HIP_R_32F, {5, 6, 3, 3});
+    pass &= cache.intern(odd)->mVectorWidth == 1;
+
+    auto even           = desc;
+    even.mTensorDesc[0] = makeDesc(HIP_R_32F, {5, 6, 3, 6});
+    pass &= cache.intern(even)->mVectorWidth == 2;
+
+    auto unknown             = desc;
+    unknown.mAlignmentReq[3] = 0;
+    pass &= cache.intern(unknown)->mVectorWidth == 4;
+
+    // Double operands are capped at two elements per 16-byte access
+    auto doubles           = desc;
+    doubles.mComputeType   = HIPTENSOR_COMPUTE_64F;
+    doubles.mTensorDesc[0] = makeDesc(HIP_R_64F, {5, 6, 3, 4});
+    doubles.mTensorDesc[1] = makeDesc(HIP_R_64F, {3, 4, 3, 4});
+    doubles.mTensorDesc[3] = makeDesc(HIP_R_64F, {5, 6, 3, 4});
+    pass &= cache.intern(doubles)->mVectorWidth == 2;
+
+    return pass;
+}
+
+bool stridedViewTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto a = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto b = makeDesc(HIP_R_32F, {3, 4, 3, 4});
+    auto d = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto c = hiptensorTensorDescriptor_t{
+        hiptensor::NONE_TYPE, hiptensorDimVector_t(4, 0), hiptensorDimVector_t(4, 0), nullptr};
+
+    // Padded sub-view of A and B broadcast along its first mode keep unit inner strides
+    a.mStrides = {128, 16, 4, 1};
+    b.mStrides = {0, 12, 4, 1};
+
+    hiptensorContractionDescriptor_t desc
+        = {1, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{16, 16, 0, 16}}, nullptr};
+
+    auto* sig  = cache.intern(desc);
+    bool  pass = !sig->mStaged[0] && !sig->mStaged[1] && !sig->mStaged[3];
+    pass &= sig->mStagingBytes == 0 && sig->mKernelStrides[0] == a.mStrides;
+    pass &= sig->mTensors[1]->mBroadcast && !sig->mTensors[0]->mBroadcast;
+    pass &= sig->mVectorWidth == 4;
+
+    // Every other element of A and D: no unit-stride mode, so both are staged packed
+    auto strided                    = desc;
+    strided.mTensorDesc[0].mStrides = {144, 24, 8, 2};
+    strided.mTensorDesc[3].mStrides = {144, 24, 8, 2};
+
+    sig = cache.intern(strided);
+    pass &= sig->mStaged[0] && !sig->mStaged[1] && !sig->mStaged[2] && sig->mStaged[3];
+    pass &= sig->mKernelStrides[0] == hiptensorDimVector_t{72, 12, 4, 1};
+    pass &= sig->mKernelStrides[3] == hiptensorDimVector_t{72, 12, 4, 1};
+    pass &= sig->mStagingOffsets[0] == 0 && sig->mStagingOffsets[3] == 1536;
+    pass &= sig->mStagingBytes == 2 * 1536;
+
+    // A unit stride on an outer mode cannot be used for vector loads either
+    auto outer                    = desc;
+    outer.mTensorDesc[1].mStrides = {1, 3, 12, 48};
+    pass &= cache.intern(outer)->mStaged[1];
+
+    return pass;
+}
+
+bool packedLayoutTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto a = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto b = makeDesc(HIP_R_32F, {3, 4, 3, 4});
+    auto d = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto c = hiptensorTensorDescriptor_t{
+        hiptensor::NONE_TYPE, hiptensorDimVector_t(4, 0), hiptensorDimVector_t(4, 0), nullptr};
+
+    // B rows with an odd pitch and partial alignment only allow scalar access
+    b.mStrides = {60, 15, 5, 1};
+
+    hiptensorContractionDescriptor_t desc
+        = {1, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{16, 4, 0, 16}}, nullptr};
+    bool pass = cache.intern(desc)->mVectorWidth == 1;
+
+    // Packed with rows padded to whole vectors and aligned, B allows the widest access
+    auto packed                    = desc;
+    packed.mTensorDesc[1].mStrides = hiptensor::paddedStridesFromLengths(b.mLengths, 4);
+    packed.mAlignmentReq[1]        = hiptensor::MaxVectorBytes;
+    pass &= packed.mTensorDesc[1].mStrides == hiptensorDimVector_t{48, 12, 4, 1};
+    pass &= cache.intern(packed)->mVectorWidth == 4 && !cache.intern(packed)->mStaged[1];
+
+    // Odd innermost extents are padded to the next whole vector
+    pass &= hiptensor::paddedStridesFromLengths(hiptensorDimVector_t{3, 4, 3, 3}, 4)
+            == hiptensorDimVector_t{48, 12, 4, 1};
+
+    return pass;
+}
+
+bool partitionTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto a = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto b = makeDesc(HIP_R_32F, {3, 4, 3, 4});
+    auto d = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto c = hiptensorTensorDescriptor_t{
+        hiptensor::NONE_TYPE, hiptensorDimVector_t(4, 0), hiptensorDimVector_t(4, 0), nullptr};
+
+    hiptensorContractionDescriptor_t desc
+        = {1, HIPTENSOR_COMPUTE_32F, {{a, b, c, d}}, {{16, 16, 0, 16}}, nullptr};
+
+    // Small problems run whole
+    auto* sig  = cache.intern(desc);
+    bool  pass = sig->mPartitions == 1 && sig->mPartitionM == 5 && sig->mPartitionN == 3;
+    pass &= sig->partitionLengths(5, 3)[0] == a.mLengths;
+
+    // 2^35 elements of A and D: split along M into slices of 1023 * 2^19 elements
+    auto large           = desc;
+    large.mTensorDesc[0] = makeDesc(HIP_R_32F, {65536, 128, 64, 64});
+    large.mTensorDesc[1] = makeDesc(HIP_R_32F, {64, 64, 64, 64});
+    large.mTensorDesc[3] = makeDesc(HIP_R_32F, {65536, 128, 64, 64});
+
+    sig = cache.intern(large);
+    pass &= sig->mM == std::size_t(1) << 23 && sig->mFlops == std::size_t(1) << 48;
+    pass &= sig->mPartitionM == 1023 && sig->mPartitionN == 64 && sig->mPartitions == 65;
+    pass &= sig->partitionBounds(64) == std::array<std::size_t, 4>{65472, 64, 0, 64};
+    pass &= sig->partitionLengths(64, 64)[3] == hiptensorDimVector_t{64, 128, 64, 64};
+    pass &= sig->partitionOffsets(65472, 0)[0] == std::size_t(65472) << 19;
+    pass &= sig->partitionOffsets(65472, 0)[1] == 0;
+
+    // Staged operands are partitioned through their packed copies
+    auto staged                    = large;
+    staged.mTensorDesc[0].mStrides = {1, 65536, 65536 * 128, std::size_t(65536) * 128 * 64};
+    sig                            = cache.intern(staged);
+    pass &= sig->mStaged[0] && sig->mPartitionM == 1023 && sig->mPartitions == 65;
+
+    // A 2^35 element B is split along N instead
+    auto wide           = desc;
+    wide.mTensorDesc[0] = makeDesc(HIP_R_32F, {4, 4, 64, 64});
+    wide.mTensorDesc[1] = makeDesc(HIP_R_32F, {65536, 128, 64, 64});
+    wide.mTensorDesc[3] = makeDesc(HIP_R_32F, {4, 4, 65536, 128});
+
+    sig = cache.intern(wide);
+    pass &= sig->mPartitionM == 4 && sig->mPartitionN == 1023 && sig->mPartitions == 65;
+    pass &= sig->partitionBounds(1) == std::array<std::size_t, 4>{0, 4, 1023, 1023};
+    pass &= sig->partitionOffsets(0, 1023)[1] == std::size_t(1023) << 19;
+    pass &= sig->partitionOffsets(0, 1023)[3] == 1023 * 128;
+
+    // A single M and N slice that cannot be indexed is not supported
+    auto deep           = desc;
+    deep.mTensorDesc[0] = makeDesc(HIP_R_32F, {2, 4, 1 << 20, 256});
+    deep.mTensorDesc[1] = makeDesc(HIP_R_32F, {2, 2, 1 << 20, 256});
+    deep.mTensorDesc[3] = makeDesc(HIP_R_32F, {2, 4, 2, 2});
+    pass &= cache.intern(deep)->mPartitions == 0;
+
+    return pass;
+}
+
+bool handleInternTest(hiptensorHandle_t* handle)
+{
+    int64_t lengths[] = {5, 6, 3, 4};
+
+    hiptensorTensorDescriptor_t desc0, desc1;
+    CHECK_HIPTENSOR_ERROR(hiptensorInitTensorDescriptor(
+        handle, &desc0, 4, lengths, nullptr, HIP_R_32F, HIPTENSOR_OP_IDENTITY));
+    CHECK_HIPTENSOR_ERROR(hiptensorInitTensorDescriptor(
+        handle, &desc1, 4, lengths, nullptr, HIP_R_32F, HIPTENSOR_OP_IDENTITY));
+
+    return desc0.mSignature != nullptr && desc0.mSignature == desc1.mSignature;
+}
+
+bool multiOutputTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto a = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+    auto b = makeDesc(HIP_R_32F, {3, 4, 3, 4});
+    auto d = makeDesc(HIP_R_32F, {5, 6, 3, 4});
+
+    hiptensorContractionDescriptor_t desc
+        = {0, HIPTENSOR_COMPUTE_32F, {{a, b, d, d}}, {{16, 16, 16, 16}}, nullptr, 1};
+
+    // A single output keeps its operands as they are
+    auto* single = cache.intern(desc);
+    bool  pass   = single->mOutputs == 1 && single->mOutputTensors == single->mTensors;
+    pass &= single->mStagingBytes == 0;
+
+    // Outputs are concatenated along the outermost N mode of B, C and D
+    auto fused     = desc;
+    fused.mOutputs = 3;
+
+    auto* sig = cache.intern(fused);
+    pass &= sig != single && cache.intern(fused) == sig;
+    pass &= sig->mOutputs == 3 && sig->mOutputTensors == single->mTensors;
+    pass &= sig->mTensors[0] == single->mTensors[0];
+    pass &= sig->mTensors[1]->mLengths == hiptensorDimVector_t{9, 4, 3, 4};
+    pass &= sig->mTensors[3]->mLengths == hiptensorDimVector_t{5, 6, 9, 4};
+    pass &= sig->mOutputOffsets == std::array<std::size_t, 4>{0, 144, 12, 12};
+    pass &= sig->mN == 3 * single->mN && sig->mFlops == 3 * single->mFlops;
+
+    // Only A is read in place; every output has a packed slot in the workspace
+    pass &= !sig->mStaged[0] && sig->mStaged[1] && sig->mStaged[2] && sig->mStaged[3];
+    pass &= sig->mStagingBytes >= 3 * (144 + 360 + 360) * sizeof(float);
+
+    // Operands already side by side in the concatenated view are used in place, such as
+    // B packed back to back once for several calls
+    std::vector<float> storage(3 * 360);
+    void const*        packedB[]   = {&storage[0], &storage[144], &storage[288]};
+    void const*        swappedB[]  = {&storage[0], &storage[288], &storage[144]};
+    void const*        adjacentD[] = {&storage[0], &storage[12], &storage[24]};
+    pass &= sig->concatenatedInPlace(1, packedB);
+    pass &= !sig->concatenatedInPlace(1, swappedB);
+    pass &= !single->concatenatedInPlace(1, packedB);
+
+    // D is only written in place as views into one concatenated D
+    pass &= !sig->concatenatedInPlace(3, adjacentD);
+
+    auto view             = d;
+    view.mStrides         = {216, 36, 4, 1};
+    auto viewed           = fused;
+    viewed.mTensorDesc[2] = view;
+    viewed.mTensorDesc[3] = view;
+
+    auto* viewSig = cache.intern(viewed);
+    pass &= viewSig->concatenatedInPlace(3, adjacentD);
+    pass &= viewSig->concatenatedInPlace(2, adjacentD);
+
+    return pass;
+}
+
+bool evictionTest()
+{
+    hiptensor::DescriptorCache cache(2);
+
+    auto makeContraction = [](hiptensorDimVector_t::value_type extent) {
+        auto a = makeDesc(HIP_R_32F, {extent, 4});
+        auto b = makeDesc(HIP_R_32F, {3, 4});
+        auto d = makeDesc(HIP_R_32F, {extent, 3});
+        return hiptensorContractionDescriptor_t{
+            2, HIPTENSOR_COMPUTE_32F, {{a, b, d, d}}, {{4, 4, 4, 4}}, nullptr};
+    };
+
+    int   solution = 0;
+    auto  desc0    = makeContraction(5);
+    auto* sig0     = cache.intern(desc0);
+    auto  keep     = cache.retain(sig0);
+    cache.cachePlan(sig0, HIPTENSOR_ALGO_DEFAULT, 0, &solution);
+
+    // Least recently used records and their plans are evicted beyond the capacity
+    cache.intern(makeContraction(6));
+    cache.intern(makeContraction(7));
+    bool pass = cache.contractionCount() == 2 && !cache.owns(sig0) && cache.planCount() == 0;
+
+    // Retained records stay valid after eviction
+    pass &= keep.get() == sig0 && keep->mM == 5 && keep->mTensors[0]->mLengths[0] == 5;
+    keep.reset();
+
+    // Recently used records survive, and tensors go once no contraction uses them
+    auto* sig7 = cache.intern(makeContraction(7));
+    cache.intern(makeContraction(8));
+    pass &= cache.owns(sig7) && cache.intern(makeContraction(7)) == sig7;
+    pass &= cache.tensorCount() == 5;
+
+    // Plans are evicted least recently used first
+    int other = 0;
+    cache.cachePlan(sig7, HIPTENSOR_ALGO_DEFAULT, 0, &solution);
+    cache.cachePlan(sig7, HIPTENSOR_ALGO_DEFAULT, 1024, &other);
+    pass &= cache.findPlan(sig7, HIPTENSOR_ALGO_DEFAULT, 0) == &solution;
+    cache.cachePlan(sig7, HIPTENSOR_ALGO_ACTOR_CRITIC, 0, &other);
+    pass &= cache.planCount() == 2 && cache.findPlan(sig7, HIPTENSOR_ALGO_DEFAULT, 0) == &solution
+            && cache.findPlan(sig7, HIPTENSOR_ALGO_DEFAULT, 1024) == nullptr;
+
+    return pass;
+}
+
+bool staleSignatureTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto a = makeDesc(HIP_R_32F, {5, 4});
+    auto b = makeDesc(HIP_R_32F, {3, 4});
+    auto d = makeDesc(HIP_R_32F, {5, 3});
+
+    hiptensorContractionDescriptor_t desc
+        = {2, HIPTENSOR_COMPUTE_32F, {{a, b, d, d}}, {{4, 4, 4, 4}}, nullptr};
+    auto* sig = cache.intern(desc);
+
+    // A descriptor reusing a cached pointer for another problem is analyzed again
+    auto other          = desc;
+    other.mTensorDesc[0] = makeDesc(HIP_R_32F, {7, 4});
+    other.mTensorDesc[2] = other.mTensorDesc[3] = makeDesc(HIP_R_32F, {7, 3});
+    other.mSignature                            = sig;
+    auto* otherSig                              = cache.signature(other);
+    bool  pass = otherSig != sig && otherSig->mM == 7 && cache.signature(desc) == sig;
+
+    auto tensor       = makeDesc(HIP_R_32F, {6, 4});
+    tensor.mSignature = sig->mTensors[0];
+    pass &= cache.signature(tensor) != sig->mTensors[0]
+            && cache.signature(tensor)->mLengths[0] == 6;
+
+    // Bound descriptors and their copies are trusted while their record is cached
+    cache.bind(desc);
+    auto copy = desc;
+    pass &= desc.mSignature == sig && cache.signature(copy) == sig;
+
+    // Bindings to an evicted record are not trusted, even at a reused address
+    hiptensor::DescriptorCache small(1);
+    auto                       bound = other;
+    small.bind(bound);
+    auto generation = bound.mGeneration;
+    small.intern(desc);
+    auto* replaced = small.intern(other);
+    pass &= replaced->mGeneration != generation && small.signature(bound) == replaced;
+
+    return pass;
+}
+
+int main(int argc, char* argv[])
+{
+    bool totalPass = true;
+    bool testPass  = false;
+
+    testPass = tensorInternTest();
+    totalPass &= testPass;
+    std::cout << "Tensor descriptor interning: ";
+    printBool(testPass);
+
+    testPass = contractionInternTest();
+    totalPass &= testPass;
+    std::cout << "Contraction descriptor interning: ";
+    printBool(testPass);
+
+    testPass = planCacheTest();
+    totalPass &= testPass;
+    std::cout << "Plan cache: ";
+    printBool(testPass);
+
+    testPass = vectorWidthTest();
+    totalPass &= testPass;
+    std::cout << "Vector width analysis: ";
+    printBool(testPass);
+
+    testPass = stridedViewTest();
+    totalPass &= testPass;
+    std::cout << "Strided view analysis: ";
+    printBool(testPass);
+
+    testPass = packedLayoutTest();
+    totalPass &= testPass;
+    std::cout << "Pre-packed operand layout: ";
+    printBool(testPass);
+
+    testPass = partitionTest();
+    totalPass &= testPass;
+    std::cout << "Index partitioning: ";
+    printBool(testPass);
+
+    testPass = multiOutputTest();
+    totalPass &= testPass;
+    std::cout << "Multi-output analysis: ";
+    printBool(testPass);
+
+    testPass = evictionTest();
+    totalPass &= testPass;
+    std::cout << "Least recently used eviction: ";
+    printBool(testPass);
+
+    testPass = staleSignatureTest();
+    totalPass &= testPass;
+    std::cout << "Stale signature hints: ";
+    printBool(testPass);
+
+    hiptensorHandle_t* handle;
+    if(hiptensorCreate(&handle) == HIPTENSOR_STATUS_SUCCESS)
+    {
+        testPass = handleInternTest(handle);
+        totalPass &= testPass;
+        std::cout << "Handle descriptor interning: ";
+        printBool(testPass);
+
+        CHECK_HIPTENSOR_ERROR(hiptensorDestroy(handle));
+    }
+
+    if(!totalPass)
+        return -1;
+    return 0;
+}
@@ -0,0 +1,212 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <iostream>
+#include <vector>
+
+// hiptensor includes
+#include <hiptensor/hiptensor_expression.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+using hiptensor::expression::Call;
+
+bool sameView(hiptensor::expression::Operand const& operand,
+              hiptensor::Tensor const*              tensor,
+              std::vector<int64_t> const&           lengths,
+              std::vector<int64_t> const&           strides,
+              std::string const&                    modes)
+{
+    return operand.mTensor == tensor && operand.mLengths == lengths && operand.mStrides == strides
+           && operand.mModes == std::vector<int32_t>(modes.begin(), modes.end());
+}
+
+// Lowers without executing, as assignment would
+template <typename Expression>
+Call lowered(hiptensor::TensorRef const& d, Expression const& value)
+{
+    return hiptensor::expression::lower(d, value);
+}
+
+bool contractionTest()
+{
+    bool pass = true;
+
+    // Packed with the last mode fastest
+    hiptensor::Tensor A(nullptr, HIP_R_32F, {2, 3, 4}, nullptr);
+    hiptensor::Tensor B(nullptr, HIP_R_32F, {5, 4}, nullptr);
+    hiptensor::Tensor C(nullptr, HIP_R_32F, {5, 2, 3}, nullptr);
+    hiptensor::Tensor D(nullptr, HIP_R_32F, {2, 3, 5}, nullptr);
+    pass &= A.strides() == std::vector<int64_t>{12, 4, 1};
+
+    // Bilinear contraction, scalars folded through the expression
+    auto call = lowered(D("abn"), 2.0 * (A("abk") * 1.5 * B("nk")) + 0.5 * C("nab"));
+    pass &= call.mKind == Call::Kind::Contraction && call.mStatus == HIPTENSOR_STATUS_SUCCESS;
+    pass &= call.mAlpha == 3.0 && call.mBeta == 0.5;
+
+    // Operands are viewed as A[M, K], B[N, K], C and D [M, N]; C's order is in its strides
+    pass &= sameView(call.mOperands[0], &A, {2, 3, 4}, {12, 4, 1}, "abk");
+    pass &= sameView(call.mOperands[1], &B, {5, 4}, {4, 1}, "nk");
+    pass &= sameView(call.mOperands[2], &C, {2, 3, 5}, {3, 1, 6}, "abn");
+    pass &= sameView(call.mOperands[3], &D, {2, 3, 5}, {15, 5, 1}, "abn");
+
+    // Swapped factors and no C: the first factor supplies the M modes of D
+    call = lowered(D("abn"), B("nk") * A("abk"));
+    pass &= call.mStatus == HIPTENSOR_STATUS_SUCCESS && call.mAlpha == 1.0 && call.mBeta == 0.0;
+    pass &= sameView(call.mOperands[0], &B, {5, 4}, {4, 1}, "nk");
+    pass &= sameView(call.mOperands[1], &A, {2, 3, 4}, {12, 4, 1}, "abk");
+    pass &= call.mOperands[2].mTensor == nullptr;
+    pass &= sameView(call.mOperands[3], &D, {5, 2, 3}, {1, 15, 5}, "nab");
+
+    // Batched modes, modes that vanish and mismatched lengths cannot be lowered
+    hiptensor::Tensor E(nullptr, HIP_R_32F, {2, 3, 5, 4}, nullptr);
+    pass &= lowered(D("abn"), A("abk") * E("abnk")).mStatus == HIPTENSOR_STATUS_NOT_SUPPORTED;
+    pass &= lowered(D("abn"), A("abk") * B("nj")).mStatus == HIPTENSOR_STATUS_NOT_SUPPORTED;
+    pass &= lowered(D("abn"), A("abk") * B("kn")).mStatus == HIPTENSOR_STATUS_INVALID_VALUE;
+    pass &= lowered(D("abn"), A("ab") * B("nk")).mStatus == HIPTENSOR_STATUS_INVALID_VALUE;
+
+    return pass;
+}
+
+bool permutationTest()
+{
+    bool pass = true;
+
+    hiptensor::Tensor A(nullptr, HIP_R_32F, {2, 3, 4}, nullptr);
+    hiptensor::Tensor B(nullptr, HIP_R_32F, {4, 2, 3}, nullptr);
+
+    auto call = lowered(B("kab"), hiptensor::expression::term(A("abk")));
+    pass &= call.mKind == Call::Kind::Permutation && call.mStatus == HIPTENSOR_STATUS_SUCCESS;
+    pass &= call.mAlpha == 1.0;
+    pass &= sameView(call.mOperands[0], &A, {2, 3, 4}, {12, 4, 1}, "abk");
+    pass &= sameView(call.mOperands[3], &B, {4, 2, 3}, {6, 3, 1}, "kab");
+
+    call = lowered(B("kab"), 0.5 * A("abk"));
+    pass &= call.mAlpha == 0.5;
+
+    pass &= lowered(B("kaj"), 0.5 * A("abk")).mStatus == HIPTENSOR_STATUS_NOT_SUPPORTED;
+    pass &= lowered(B("kaa"), 0.5 * A("abk")).mStatus == HIPTENSOR_STATUS_INVALID_VALUE;
+
+    return pass;
+}
+
+bool planKeyTest()
+{
+    bool pass = true;
+
+    hiptensor::Tensor A(nullptr, HIP_R_32F, {2, 3, 4}, nullptr);
+    hiptensor::Tensor B(nullptr, HIP_R_32F, {5, 4}, nullptr);
+    hiptensor::Tensor D(nullptr, HIP_R_32F, {2, 3, 5}, nullptr);
+
+    auto handleId   = uint64_t(1);
+    auto compute    = HIPTENSOR_COMPUTE_32F;
+    auto alignments = std::array<uint32_t, 4>{16, 16, 0, 16};
+    auto key        = [&](Call const& call, std::array<uint32_t, 4> const& aligned) {
+        return hiptensor::expression::planKey(handleId, compute, call.mOperands, aligned);
+    };
+
+    // The same shape keys the same plan, whatever the scalars
+    auto call = lowered(D("abn"), A("abk") * B("nk"));
+    pass &= key(call, alignments) == key(lowered(D("abn"), 2.0 * A("abk") * B("nk")), alignments);
+
+    // Mode order, alignment and an added C do not
+    pass &= key(call, alignments) != key(lowered(D("abn"), B("nk") * A("bak")), alignments);
+    pass &= key(call, alignments) != key(call, {4, 16, 0, 16});
+    auto bilinear = lowered(D("abn"), A("abk") * B("nk") + D("abn"));
+    pass &= key(call, alignments) != key(bilinear, alignments);
+
+    // Nor does another handle
+    auto first = key(call, alignments);
+    handleId   = 2;
+    pass &= key(call, alignments) != first;
+
+    return pass;
+}
+
+bool handleIdTest(bool* skipped)
+{
+    hiptensorHandle_t* first = nullptr;
+    if(hiptensorCreate(&first) != HIPTENSOR_STATUS_SUCCESS)
+    {
+        *skipped = true;
+        return true;
+    }
+
+    // A handle created after another is destroyed, possibly at its address, has a new id
+    uint64_t firstId = 0, secondId = 0;
+    bool     pass    = hiptensorGetHandleId(first, &firstId) == HIPTENSOR_STATUS_SUCCESS;
+    hiptensorDestroy(first);
+
+    hiptensorHandle_t* second = nullptr;
+    pass &= hiptensorCreate(&second) == HIPTENSOR_STATUS_SUCCESS;
+    pass &= hiptensorGetHandleId(second, &secondId) == HIPTENSOR_STATUS_SUCCESS;
+    pass &= firstId != secondId;
+    hiptensorDestroy(second);
+
+    pass &= hiptensorGetHandleId(nullptr, &firstId) == HIPTENSOR_STATUS_NOT_INITIALIZED;
+    return pass;
+}
+
+int main(int argc, char* argv[])
+{
+    bool totalPass = true;
+    bool testPass  = false;
+
+    testPass = contractionTest();
+    totalPass &= testPass;
+    std::cout << "Expression lowering to contractions: ";
+    printBool(testPass);
+
+    testPass = permutationTest();
+    totalPass &= testPass;
+    std::cout << "Expression lowering to permutations: ";
+    printBool(testPass);
+
+    testPass = planKeyTest();
+    totalPass &= testPass;
+    std::cout << "Expression plan cache keys: ";
+    printBool(testPass);
+
+    bool skipped = false;
+    testPass     = handleIdTest(&skipped);
+    totalPass &= testPass;
+    if(skipped)
+    {
+        std::cout << "Skipped device tests: unsupported host device" << std::endl;
+    }
+    else
+    {
+        std::cout << "Handle ids: ";
+        printBool(testPass);
+    }
+
+    if(!totalPass)
+        return -1;
+    return 0;
+}
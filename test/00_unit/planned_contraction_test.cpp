@@ -0,0 +1,126 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <iostream>
+
+// hiptensor includes
+#include <hiptensor/hiptensor_planned_contraction.hpp>
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+using hiptensor::Modes;
+
+// std::array comparison is not constexpr before C++20
+template <typename T, std::size_t N>
+constexpr bool equal(std::array<T, N> const& lhs, std::array<T, N> const& rhs)
+{
+    for(std::size_t i = 0; i < N; i++)
+    {
+        if(lhs[i] != rhs[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// D[m, n, u, v] = A[k, m, l, n] * B[u, l, v, k]
+using Layout = hiptensor::planned::ContractionLayout<Modes<'k', 'm', 'l', 'n'>,
+                                                   Modes<'u', 'l', 'v', 'k'>,
+                                                   Modes<'m', 'n', 'u', 'v'>>;
+
+// The analysis is a constant expression
+static_assert(Layout::Valid);
+static_assert(Layout::RankM == 2 && Layout::RankN == 2 && Layout::RankK == 2);
+static_assert(equal(Layout::OrderA, std::array<std::size_t, 4>{1, 3, 0, 2}));
+static_assert(equal(Layout::OrderB, std::array<std::size_t, 4>{0, 2, 3, 1}));
+static_assert(equal(Layout::OrderD, std::array<std::size_t, 4>{0, 1, 2, 3}));
+
+bool layoutTest()
+{
+    bool pass = true;
+
+    using hiptensor::planned::ContractionLayout;
+
+    // D's M and N modes may interleave; kernels see them grouped
+    using Interleaved
+        = ContractionLayout<Modes<'m', 'n', 'k'>, Modes<'u', 'k'>, Modes<'u', 'm', 'n'>>;
+    pass &= Interleaved::Valid && Interleaved::RankM == 2 && Interleaved::RankN == 1;
+    pass &= Interleaved::OrderD == std::array<std::size_t, 3>{1, 2, 0};
+
+    // Batched modes, modes that vanish and repeated labels are rejected
+    pass &= !ContractionLayout<Modes<'m', 'k'>, Modes<'m', 'k'>, Modes<'m'>>::Valid;
+    pass &= !ContractionLayout<Modes<'m', 'k'>, Modes<'n', 'j'>, Modes<'m', 'n'>>::Valid;
+    pass &= !ContractionLayout<Modes<'m', 'm'>, Modes<'n', 'm'>, Modes<'m', 'n'>>::Valid;
+
+    return pass;
+}
+
+bool operandTest()
+{
+    bool pass = true;
+
+    using Contraction = hiptensor::PlannedContraction<float,
+                                                      Modes<'k', 'm', 'l', 'n'>,
+                                                      Modes<'u', 'l', 'v', 'k'>,
+                                                      Modes<'m', 'n', 'u', 'v'>>;
+
+    // D takes its lengths from A and B
+    constexpr auto lengthsD = Contraction::lengthsD({2, 3, 4, 5}, {6, 4, 7, 2});
+    static_assert(equal(lengthsD, std::array<int64_t, 4>{3, 5, 6, 7}));
+
+    constexpr auto strides = hiptensor::planned::packedStrides(std::array<int64_t, 3>{2, 3, 4});
+    pass &= strides == std::array<int64_t, 3>{12, 4, 1};
+
+    constexpr auto permuted = hiptensor::planned::permute(std::array<int64_t, 4>{2, 3, 4, 5},
+                                                        Layout::OrderA);
+    pass &= permuted == std::array<int64_t, 4>{3, 5, 2, 4};
+
+    return pass;
+}
+
+int main(int argc, char* argv[])
+{
+    bool totalPass = true;
+    bool testPass  = false;
+
+    testPass = layoutTest();
+    totalPass &= testPass;
+    std::cout << "Fixed-rank contraction layout: ";
+    printBool(testPass);
+
+    testPass = operandTest();
+    totalPass &= testPass;
+    std::cout << "Fixed-rank operand views: ";
+    printBool(testPass);
+
+    if(!totalPass)
+        return -1;
+    return 0;
+}
@@ -0,0 +1,233 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+// hiptensor includes
+#include "data_types.hpp"
+#include "descriptor_cache.hpp"
+#include "performance.hpp"
+#include <hiptensor/hiptensor.hpp>
+#include <hiptensor/hiptensor_types.hpp>
+#include <hiptensor/internal/hiptensor_utility.hpp>
+
+namespace
+{
+    constexpr uint64_t Saturated = std::numeric_limits<uint64_t>::max();
+}
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+hiptensorTensorDescriptor_t makeDesc(hipDataType type, hiptensorDimVector_t const& lengths)
+{
+    // Packed, last mode fastest
+    hiptensorDimVector_t strides(lengths.size(), 1);
+    for(int i = (int)lengths.size() - 2; i >= 0; i--)
+    {
+        strides[i] = strides[i + 1] * lengths[i + 1];
+    }
+    return {type, lengths, strides, nullptr};
+}
+
+// Contraction with M, N and K each made of two modes of length `length`
+hiptensorContractionDescriptor_t makeContraction(std::size_t length)
+{
+    auto a = makeDesc(HIP_R_32F, {length, length, length, length});
+    auto c = hiptensorTensorDescriptor_t{
+        hiptensor::NONE_TYPE, hiptensorDimVector_t(4, 0), hiptensorDimVector_t(4, 0), nullptr};
+    return {1, HIPTENSOR_COMPUTE_32F, {{a, a, c, a}}, {{4, 4, 0, 4}}, nullptr};
+}
+
+bool saturatingArithmeticTest()
+{
+    bool saturated = false;
+    bool pass = hiptensor::saturatingMultiply(1ull << 31, 1ull << 32, &saturated) == 1ull << 63;
+    pass &= hiptensor::saturatingAdd(1ull << 63, (1ull << 63) - 1, &saturated) == Saturated;
+    pass &= !saturated;
+
+    // Overflow clamps instead of wrapping to a small count
+    pass &= hiptensor::saturatingMultiply(1ull << 32, 1ull << 32, &saturated) == Saturated;
+    pass &= saturated;
+
+    saturated = false;
+    pass &= hiptensor::saturatingAdd(Saturated, 1, &saturated) == Saturated && saturated;
+
+    saturated = false;
+    pass &= hiptensor::elementCount({1ull << 20, 1ull << 20, 1ull << 20}, &saturated) == 1ull << 60;
+    pass &= hiptensor::elementCount({1ull << 30, 1ull << 30, 1ull << 30}, &saturated) == Saturated;
+    pass &= saturated;
+
+    // Length-0 modes do not extend the element space
+    pass &= hiptensor::elementSpace({4, 0, 8}, {64, 8, 1}) == 1 + 3 * 64 + 7;
+
+    return pass;
+}
+
+bool largeContractionTest()
+{
+    // M = N = K = 2^20 needs 2^61 flops, which a 32-bit count or float product loses
+    auto length = hiptensorDimVector_t(4, 1ull << 10);
+    auto packed = makeDesc(HIP_R_32F, length).mStrides;
+    auto metrics
+        = hiptensor::contractionMetrics({HIP_R_32F, HIP_R_32F, hiptensor::NONE_TYPE, HIP_R_32F},
+                                        {length, length, {}, length},
+                                        {packed, packed, {}, packed},
+                                        2,
+                                        2);
+
+    bool pass = metrics.mM == 1ull << 20 && metrics.mN == 1ull << 20 && metrics.mK == 1ull << 20;
+    pass &= metrics.mFlops == 1ull << 61 && !metrics.mSaturated;
+    pass &= metrics.mOperandBytes[0] == 1ull << 42 && metrics.mOperandBytes[2] == 0;
+    pass &= metrics.mBytes == 3 * (1ull << 42);
+
+    // Throughput keeps its precision: 2^61 flops in one second
+    pass &= std::abs(metrics.tflops(1000.0f) - std::ldexp(1.0, 61) / 1.E12) < 1.E-6;
+
+    // M = N = K = 2^22 needs 2^67 flops
+    length  = hiptensorDimVector_t(4, 1ull << 11);
+    packed  = makeDesc(HIP_R_32F, length).mStrides;
+    metrics = hiptensor::contractionMetrics({HIP_R_32F, HIP_R_32F, HIP_R_32F, HIP_R_32F},
+                                            {length, length, length, length},
+                                            {packed, packed, packed, packed},
+                                            2,
+                                            2);
+    pass &= metrics.mM == 1ull << 22 && metrics.mFlops == Saturated && metrics.mSaturated;
+    pass &= metrics.mOperandBytes[3] == 1ull << 46 && metrics.mBytes == 1ull << 48;
+
+    return pass;
+}
+
+bool stridedBytesTest()
+{
+    // A [M, K] = [64, 32] with rows padded to 48 elements spans more than it holds
+    hiptensorDimVector_t lengthsA = {64, 32}, stridesA = {48, 1};
+    hiptensorDimVector_t lengthsB = {16, 32}, stridesB = {32, 1};
+    hiptensorDimVector_t lengthsD = {64, 16}, stridesD = {1, 64};
+
+    auto metrics
+        = hiptensor::contractionMetrics({HIP_R_64F, HIP_R_64F, HIP_R_64F, HIP_R_64F},
+                                        {lengthsA, lengthsB, lengthsD, lengthsD},
+                                        {stridesA, stridesB, stridesD, stridesD},
+                                        1,
+                                        1);
+
+    bool pass = metrics.mM == 64 && metrics.mN == 16 && metrics.mK == 32;
+    pass &= metrics.mOperandBytes[0] == (63 * 48 + 31 + 1) * sizeof(double);
+    pass &= metrics.mOperandBytes[1] == 16 * 32 * sizeof(double);
+    pass &= metrics.mOperandBytes[2] == 64 * 16 * sizeof(double);
+    pass &= metrics.mBytes
+            == metrics.mOperandBytes[0] + metrics.mOperandBytes[1] + 2 * metrics.mOperandBytes[2];
+
+    // Permutations read and write every element once
+    auto permute = hiptensor::permutationMetrics(1ull << 40, sizeof(float));
+    pass &= permute.mFlops == 1ull << 41 && permute.mBytes == 1ull << 43 && !permute.mSaturated;
+
+    auto perf = hiptensor::perfMetrics(7, "kernel", 2.0f, permute);
+    pass &= perf.mKernelUid == 7 && perf.mAvgTimeMs == 2.0f;
+    pass &= std::abs(perf.mBandwidth - std::ldexp(1.0, 43) / 1.E6 / 2.0) < 1.0;
+
+    return pass;
+}
+
+bool signatureMetricsTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto* sig = cache.intern(makeContraction(1ull << 10));
+
+    bool pass = sig->mMetrics.mFlops == 1ull << 61 && sig->mFlops == sig->mMetrics.mFlops;
+    pass &= sig->mM == 1ull << 20 && sig->mN == 1ull << 20 && sig->mK == 1ull << 20;
+    pass &= sig->mBytes == 3 * (1ull << 42) && sig->mMetrics.mOperandBytes[2] == 0;
+
+    // Descriptors too large to count keep their size clamped rather than wrapped
+    auto* huge = cache.intern(makeContraction(1ull << 17));
+    pass &= huge->mMetrics.mSaturated && huge->mFlops == Saturated;
+    pass &= huge->mTensors[0]->mElements == Saturated;
+
+    return pass;
+}
+
+bool handleMetricsTest(hiptensorHandle_t* handle)
+{
+    auto desc = makeContraction(1ull << 10);
+
+    hiptensorContractionMetrics_t metrics;
+    bool                          pass
+        = hiptensorContractionGetMetrics(handle, &desc, &metrics) == HIPTENSOR_STATUS_SUCCESS;
+    pass &= metrics.mFlops == 1ull << 61 && metrics.mTotalBytes == 3 * (1ull << 42);
+    pass &= metrics.mBytes[0] == 1ull << 42 && metrics.mBytes[2] == 0 && !metrics.mSaturated;
+
+    pass &= hiptensorContractionGetMetrics(handle, &desc, nullptr)
+            == HIPTENSOR_STATUS_NOT_INITIALIZED;
+
+    return pass;
+}
+
+int main(int argc, char** argv)
+{
+    bool totalPass = true;
+    bool testPass;
+
+    testPass = saturatingArithmeticTest();
+    totalPass &= testPass;
+    std::cout << "Saturating arithmetic: ";
+    printBool(testPass);
+
+    testPass = largeContractionTest();
+    totalPass &= testPass;
+    std::cout << "Large contraction metrics: ";
+    printBool(testPass);
+
+    testPass = stridedBytesTest();
+    totalPass &= testPass;
+    std::cout << "Strided operand bytes: ";
+    printBool(testPass);
+
+    testPass = signatureMetricsTest();
+    totalPass &= testPass;
+    std::cout << "Descriptor signature metrics: ";
+    printBool(testPass);
+
+    hiptensorHandle_t* handle;
+    if(hiptensorCreate(&handle) == HIPTENSOR_STATUS_SUCCESS)
+    {
+        testPass = handleMetricsTest(handle);
+        totalPass &= testPass;
+        std::cout << "Contraction metrics query: ";
+        printBool(testPass);
+
+        CHECK_HIPTENSOR_ERROR(hiptensorDestroy(handle));
+    }
+
+    if(!totalPass)
+        return -1;
+    return 0;
+}
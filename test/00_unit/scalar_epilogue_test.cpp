@@ -0,0 +1,138 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// hiptensor includes
+#include <hiptensor/hiptensor.hpp>
+
+#include "scalar_epilogue.hpp"
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+bool epilogueTest()
+{
+    bool pass = true;
+
+    // D and P are row-major 3 x 4, C is the column-major view of the same shape
+    auto lengths  = hiptensorDimVector_t{3, 4};
+    auto dStrides = hiptensorDimVector_t{4, 1};
+    auto cStrides = hiptensorDimVector_t{1, 3};
+
+    auto P = std::vector<float>(12);
+    auto C = std::vector<float>(12);
+    for(int i = 0; i < 12; i++)
+    {
+        P[i] = float(i + 1);
+        C[i] = float(2 * i);
+    }
+
+    auto alpha = 2.0f;
+    auto beta  = -0.5f;
+    auto D     = std::vector<float>(12);
+    hiptensor::applyScalarsByCpu(
+        &alpha, &beta, P.data(), C.data(), cStrides, D.data(), dStrides, lengths);
+    for(int m = 0; m < 3; m++)
+    {
+        for(int n = 0; n < 4; n++)
+        {
+            pass &= D[m * 4 + n] == alpha * P[m * 4 + n] + beta * C[m + n * 3];
+        }
+    }
+
+    // A zero beta does not read C
+    auto zero = 0.0f;
+    auto nan  = std::vector<float>(12, std::numeric_limits<float>::quiet_NaN());
+    hiptensor::applyScalarsByCpu(
+        &alpha, &zero, P.data(), nan.data(), cStrides, D.data(), dStrides, lengths);
+    for(int i = 0; i < 12; i++)
+    {
+        pass &= D[i] == alpha * P[i];
+    }
+
+    // In place without C, as for permutations
+    auto half   = 0.5;
+    auto values = std::vector<double>{2.0, 4.0, 6.0, 8.0};
+    hiptensor::applyScalarsByCpu(&half,
+                                 (double const*)nullptr,
+                                 values.data(),
+                                 (double const*)nullptr,
+                                 {},
+                                 values.data(),
+                                 hiptensorDimVector_t{2, 1},
+                                 hiptensorDimVector_t{2, 2});
+    pass &= values == std::vector<double>{1.0, 2.0, 3.0, 4.0};
+
+    return pass;
+}
+
+bool pointerModeTest()
+{
+    bool pass = true;
+
+    hiptensorHandle_t* handle;
+    pass &= hiptensorCreate(&handle) == HIPTENSOR_STATUS_SUCCESS;
+
+    // Handles start in host mode
+    auto mode = HIPTENSOR_POINTER_MODE_DEVICE;
+    pass &= hiptensorGetPointerMode(handle, &mode) == HIPTENSOR_STATUS_SUCCESS;
+    pass &= mode == HIPTENSOR_POINTER_MODE_HOST;
+
+    pass &= hiptensorSetPointerMode(handle, HIPTENSOR_POINTER_MODE_DEVICE)
+            == HIPTENSOR_STATUS_SUCCESS;
+    pass &= hiptensorGetPointerMode(handle, &mode) == HIPTENSOR_STATUS_SUCCESS;
+    pass &= mode == HIPTENSOR_POINTER_MODE_DEVICE;
+
+    // Unknown modes are rejected and leave the mode unchanged
+    pass &= hiptensorSetPointerMode(handle, (hiptensorPointerMode_t)7)
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+    pass &= hiptensorGetPointerMode(handle, &mode) == HIPTENSOR_STATUS_SUCCESS;
+    pass &= mode == HIPTENSOR_POINTER_MODE_DEVICE;
+
+    pass &= hiptensorGetPointerMode(handle, nullptr) == HIPTENSOR_STATUS_NOT_INITIALIZED;
+    pass &= hiptensorSetPointerMode(nullptr, HIPTENSOR_POINTER_MODE_HOST)
+            == HIPTENSOR_STATUS_NOT_INITIALIZED;
+
+    pass &= hiptensorDestroy(handle) == HIPTENSOR_STATUS_SUCCESS;
+
+    return pass;
+}
+
+int main()
+{
+    bool pass = true;
+
+    pass &= epilogueTest();
+    pass &= pointerModeTest();
+
+    printBool(pass);
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <iostream>
+#include <limits>
+
+// hiptensor includes
+#include "descriptor_cache.hpp"
+#include "performance.hpp"
+#include <hiptensor/hiptensor.hpp>
+#include <hiptensor/hiptensor_types.hpp>
+#include <hiptensor/internal/hiptensor_utility.hpp>
+
+namespace
+{
+    constexpr uint64_t ProblemBytes = 1ull << 30;
+    constexpr uint64_t MiB          = 1ull << 20;
+}
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+hiptensor::SelectionSample makeSample(std::size_t uid, float timeMs, uint64_t workspaceSize)
+{
+    auto metrics = hiptensor::permutationMetrics(ProblemBytes / 8, 4);
+    return {hiptensor::perfMetrics(uid, "kernel", timeMs, metrics), workspaceSize, ProblemBytes};
+}
+
+// Split-K style trade-off: the fastest kernel needs a large workspace for a 1% gain
+std::vector<hiptensor::SelectionSample> makeSamples()
+{
+    return {makeSample(0, 1.00f, 0),
+            makeSample(1, 0.99f, 512 * MiB),
+            makeSample(2, 1.20f, 0),
+            makeSample(3, 1.005f, 8 * MiB)};
+}
+
+bool fastestTest()
+{
+    auto samples = makeSamples();
+
+    hiptensor::SelectionPolicy policy;
+    bool                       pass = policy.isDefault();
+    pass &= hiptensor::selectSample(samples, policy) == 1;
+
+    // A cap rules out the largest workspace, leaving the next fastest
+    policy.mWorkspaceCap = 64 * MiB;
+    pass &= !policy.isDefault() && hiptensor::selectSample(samples, policy) == 0;
+
+    policy.mWorkspaceCap = 0;
+    pass &= hiptensor::selectSample(samples, policy) == 0;
+
+    // Nothing to select from
+    pass &= hiptensor::selectSample({}, hiptensor::SelectionPolicy{}) == -1;
+
+    return pass;
+}
+
+bool smallestWorkspaceTest()
+{
+    auto samples = makeSamples();
+
+    hiptensor::SelectionPolicy policy;
+    policy.mPolicy = HIPTENSOR_SELECTION_SMALLEST_WORKSPACE;
+
+    // Without tolerance only the fastest qualifies
+    bool pass = hiptensor::selectSample(samples, policy) == 1;
+
+    // Within 5% of the fastest, the fastest kernel without workspace wins
+    policy.mTolerance = 0.05f;
+    pass &= hiptensor::selectSample(samples, policy) == 0;
+
+    // A generous tolerance still prefers the faster of equal workspaces
+    policy.mTolerance = 0.5f;
+    pass &= hiptensor::selectSample(samples, policy) == 0;
+
+    // The tolerance is relative to the fastest within the cap
+    samples[0].mWorkspaceSize = 16 * MiB;
+    policy.mWorkspaceCap      = 16 * MiB;
+    policy.mTolerance         = 0.01f;
+    pass &= hiptensor::selectSample(samples, policy) == 3;
+
+    return pass;
+}
+
+bool bandwidthEfficientTest()
+{
+    auto samples = makeSamples();
+
+    hiptensor::SelectionPolicy policy;
+    policy.mPolicy = HIPTENSOR_SELECTION_BANDWIDTH_EFFICIENT;
+
+    // Writing and reading 512 MiB of workspace costs more traffic than 1% of time saves
+    bool pass = hiptensor::selectSample(samples, policy) == 0;
+
+    // A small workspace is worth a small speedup
+    samples[3].mMetrics = makeSample(3, 0.95f, 8 * MiB).mMetrics;
+    pass &= hiptensor::selectSample(samples, policy) == 3;
+
+    return pass;
+}
+
+bool planCacheTest()
+{
+    hiptensor::DescriptorCache cache;
+
+    auto a = hiptensorTensorDescriptor_t{HIP_R_32F, {4, 4, 4, 4}, {64, 16, 4, 1}, nullptr};
+    hiptensorContractionDescriptor_t desc
+        = {2, HIPTENSOR_COMPUTE_32F, {{a, a, a, a}}, {{4, 4, 4, 4}}, nullptr};
+    auto* sig = cache.intern(desc);
+
+    int  fastest = 0, smallest = 1;
+    auto policy  = hiptensor::SelectionPolicy{HIPTENSOR_SELECTION_SMALLEST_WORKSPACE, MiB, 0.1f};
+    cache.cachePlan(sig, HIPTENSOR_ALGO_DEFAULT, 64 * MiB, &fastest);
+    cache.cachePlan(sig, HIPTENSOR_ALGO_DEFAULT, 64 * MiB, &smallest, policy);
+
+    // Selections made under one policy are not reused by another
+    bool pass = cache.findPlan(sig, HIPTENSOR_ALGO_DEFAULT, 64 * MiB) == &fastest;
+    pass &= cache.findPlan(sig, HIPTENSOR_ALGO_DEFAULT, 64 * MiB, policy) == &smallest;
+
+    policy.mTolerance = 0.2f;
+    pass &= cache.findPlan(sig, HIPTENSOR_ALGO_DEFAULT, 64 * MiB, policy) == nullptr;
+
+    return pass;
+}
+
+bool findPolicyTest(hiptensorHandle_t* handle)
+{
+    hiptensorContractionFind_t find = {HIPTENSOR_ALGO_DEFAULT, {}, HIPTENSOR_SELECTION_FASTEST};
+
+    bool pass = hiptensorContractionFindSetPolicy(
+                    handle, &find, HIPTENSOR_SELECTION_SMALLEST_WORKSPACE, 32 * MiB, 0.05f)
+                == HIPTENSOR_STATUS_SUCCESS;
+
+    auto policy = hiptensor::SelectionPolicy::of(find);
+    pass &= policy.mPolicy == HIPTENSOR_SELECTION_SMALLEST_WORKSPACE
+            && policy.mWorkspaceCap == 32 * MiB && policy.mTolerance == 0.05f;
+
+    // Invalid settings leave the find unchanged
+    pass &= hiptensorContractionFindSetPolicy(
+                handle, &find, HIPTENSOR_SELECTION_BANDWIDTH_EFFICIENT, 0, -1.0f)
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+    pass &= hiptensorContractionFindSetPolicy(
+                handle, &find, (hiptensorSelectionPolicy_t)7, 0, 0.0f)
+            == HIPTENSOR_STATUS_INVALID_VALUE;
+    pass &= find.mSelectionPolicy == HIPTENSOR_SELECTION_SMALLEST_WORKSPACE;
+
+    pass &= hiptensorContractionFindSetPolicy(
+                handle, nullptr, HIPTENSOR_SELECTION_FASTEST, 0, 0.0f)
+            == HIPTENSOR_STATUS_NOT_INITIALIZED;
+
+    return pass;
+}
+
+int main(int argc, char** argv)
+{
+    bool totalPass = true;
+    bool testPass;
+
+    testPass = fastestTest();
+    totalPass &= testPass;
+    std::cout << "Fastest within workspace cap: ";
+    printBool(testPass);
+
+    testPass = smallestWorkspaceTest();
+    totalPass &= testPass;
+    std::cout << "Smallest workspace within tolerance: ";
+    printBool(testPass);
+
+    testPass = bandwidthEfficientTest();
+    totalPass &= testPass;
+    std::cout << "Bandwidth efficiency: ";
+    printBool(testPass);
+
+    testPass = planCacheTest();
+    totalPass &= testPass;
+    std::cout << "Plan cache keyed by policy: ";
+    printBool(testPass);
+
+    hiptensorHandle_t* handle;
+    if(hiptensorCreate(&handle) == HIPTENSOR_STATUS_SUCCESS)
+    {
+        testPass = findPolicyTest(handle);
+        totalPass &= testPass;
+        std::cout << "Find selection policy: ";
+        printBool(testPass);
+
+        CHECK_HIPTENSOR_ERROR(hiptensorDestroy(handle));
+    }
+
+    if(!totalPass)
+        return -1;
+    return 0;
+}
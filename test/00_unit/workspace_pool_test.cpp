@@ -0,0 +1,239 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+// hiptensor includes
+#include "workspace_pool.hpp"
+
+void printBool(bool in)
+{
+    std::cout << (in ? "PASSED" : "FAILED") << std::endl;
+}
+
+// Host memory behind the pool, recording what the pool asks of it
+struct HostAllocator
+{
+    std::size_t                                      mAllocations = 0u;
+    std::size_t                                      mFrees       = 0u;
+    std::vector<std::pair<hipStream_t, hipStream_t>> mOrders;
+
+    hiptensor::WorkspacePool::Allocator allocator()
+    {
+        hiptensor::WorkspacePool::Allocator allocator;
+        allocator.mAllocate = [this](std::size_t bytes) {
+            mAllocations++;
+            return std::malloc(bytes);
+        };
+        allocator.mFree = [this](void* data) {
+            mFrees++;
+            std::free(data);
+        };
+        allocator.mOrder
+            = [this](hipStream_t from, hipStream_t to) { mOrders.push_back({from, to}); };
+        return allocator;
+    }
+};
+
+bool reuseTest()
+{
+    bool pass = true;
+
+    HostAllocator host;
+    {
+        hiptensor::WorkspacePool pool(host.allocator());
+        auto                     stream = (hipStream_t)0x1;
+
+        // Sizes are rounded to the pool granularity
+        auto* first = pool.acquire(1000u, stream);
+        pass &= first != nullptr && pool.reservedBytes() == 1024u;
+        pool.release(first, stream);
+
+        // A smaller request on the same stream reuses the block without ordering
+        auto* second = pool.acquire(512u, stream);
+        pass &= second == first && host.mAllocations == 1u && host.mOrders.empty();
+        pool.release(second, stream);
+
+        // A larger request allocates next to the idle block
+        auto* third = pool.acquire(4096u, stream);
+        pass &= third != nullptr && host.mAllocations == 2u && host.mFrees == 0u;
+        pass &= pool.reservedBytes() == 1024u + 4096u && pool.highWaterMark() == 1024u + 4096u;
+        pool.release(third, stream);
+
+        // Blocks in use are never handed out twice
+        auto* busy  = pool.acquire(64u, stream);
+        auto* other = pool.acquire(64u, stream);
+        pass &= busy != other && busy == first && host.mAllocations == 2u;
+        pool.release(busy, stream);
+        pool.release(other, stream);
+
+        // Trimming frees the idle blocks and keeps the high-water mark
+        pool.trim();
+        pass &= pool.reservedBytes() == 0u && pool.highWaterMark() == 1024u + 4096u;
+        pass &= host.mFrees == 2u;
+    }
+    pass &= host.mAllocations == host.mFrees;
+
+    return pass;
+}
+
+bool streamTest()
+{
+    bool pass = true;
+
+    HostAllocator            host;
+    hiptensor::WorkspacePool pool(host.allocator());
+    auto                     first  = (hipStream_t)0x1;
+    auto                     second = (hipStream_t)0x2;
+
+    auto* a = pool.acquire(256u, first);
+    auto* b = pool.acquire(256u, second);
+    pool.release(a, first);
+    pool.release(b, second);
+
+    // Each stream gets back the block it used last
+    pass &= pool.acquire(256u, second) == b && pool.acquire(256u, first) == a;
+    pass &= host.mOrders.empty();
+    pool.release(a, first);
+    pool.release(b, second);
+
+    // Another stream's block is ordered after that stream's work
+    auto* c = pool.acquire(256u, first);
+    auto* d = pool.acquire(256u, first);
+    pass &= c == a && d == b;
+    pass &= host.mOrders.size() == 1u && host.mOrders[0].first == second
+            && host.mOrders[0].second == first;
+    pool.release(c, first);
+    pool.release(d, first);
+
+    // Failed allocations are reported as nullptr
+    hiptensor::WorkspacePool::Allocator failing = host.allocator();
+    failing.mAllocate                           = [](std::size_t) -> void* { return nullptr; };
+    hiptensor::WorkspacePool empty(failing);
+    pass &= empty.acquire(256u, first) == nullptr && empty.reservedBytes() == 0u;
+
+    return pass;
+}
+
+bool exhaustionTest()
+{
+    bool pass = true;
+
+    // Device memory for 5120 bytes at a time
+    HostAllocator                       host;
+    std::map<void*, std::size_t>        live;
+    std::size_t                         liveBytes = 0u;
+    hiptensor::WorkspacePool::Allocator allocator = host.allocator();
+    auto                                allocate  = allocator.mAllocate;
+    auto                                free      = allocator.mFree;
+
+    allocator.mAllocate = [&, allocate](std::size_t bytes) -> void* {
+        if(liveBytes + bytes > 5120u)
+        {
+            return nullptr;
+        }
+        auto* data = allocate(bytes);
+        live[data] = bytes;
+        liveBytes += bytes;
+        return data;
+    };
+    allocator.mFree = [&, free](void* data) {
+        liveBytes -= live[data];
+        live.erase(data);
+        free(data);
+    };
+
+    {
+        hiptensor::WorkspacePool pool(allocator);
+        auto                     stream = (hipStream_t)0x1;
+
+        auto* held  = pool.acquire(1024u, stream);
+        auto* small = pool.acquire(1024u, stream);
+        pool.release(small, stream);
+
+        // Idle blocks that are too small stay while memory lasts
+        auto* big = pool.acquire(2048u, stream);
+        pass &= big != nullptr && host.mFrees == 0u && pool.reservedBytes() == 4096u;
+
+        // Once an allocation fails they are freed and the allocation retried
+        auto* again = pool.acquire(2048u, stream);
+        pass &= again != nullptr && host.mFrees == 1u && pool.reservedBytes() == 5120u;
+
+        // Busy blocks are never freed to make room
+        pass &= pool.acquire(1024u, stream) == nullptr && host.mFrees == 1u;
+
+        pool.release(held, stream);
+        pool.release(big, stream);
+        pool.release(again, stream);
+    }
+    pass &= host.mAllocations == host.mFrees && liveBytes == 0u;
+
+    return pass;
+}
+
+bool holdTest()
+{
+    bool pass = true;
+
+    HostAllocator host;
+    {
+        hiptensor::WorkspacePool pool(host.allocator());
+        auto                     stream = (hipStream_t)0x1;
+
+        // A held block stays busy through trims and is freed with its last owner
+        auto held  = pool.hold(1000u, stream);
+        auto other = held;
+        pass &= held != nullptr && pool.reservedBytes() == 1024u;
+        pool.trim();
+        pass &= pool.reservedBytes() == 1024u && host.mFrees == 0u;
+        pass &= pool.acquire(256u, stream) != held.get();
+
+        held.reset();
+        pass &= host.mFrees == 0u;
+        other.reset();
+        pass &= host.mFrees == 1u && pool.reservedBytes() == 256u;
+    }
+    pass &= host.mAllocations == host.mFrees;
+
+    return pass;
+}
+
+int main()
+{
+    bool pass = true;
+
+    pass &= reuseTest();
+    pass &= streamTest();
+    pass &= exhaustionTest();
+    pass &= holdTest();
+
+    printBool(pass);
+    return pass ? 0 : 1;
+}